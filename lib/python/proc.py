@@ -44,6 +44,18 @@ from roa import *
 # consult http://sirius.chem.vt.edu/psi4manual/master/proc_py.html
 
 
+def check_iwl_file_from_scf_type(scf_type):
+    """Function to write the conventional SO integrals (PSIF_SO_TEI) for
+    the modules that read them, unless the SCF left them on disk. Only
+    OUT_OF_CORE does; PK builds its supermatrix directly, and DF, CD,
+    and DIRECT never store four-index integrals.
+
+    """
+    if scf_type != 'OUT_OF_CORE':
+        mints = psi4.MintsHelper()
+        mints.integrals()
+
+
 def run_lmp2(name, **kwargs):
     """Function encoding sequence of PSI module calls for
     an LMP2 theory calculation.
@@ -78,6 +90,7 @@ def run_dcft(name, **kwargs):
     # Bypass routine scf if user did something special to get it to converge
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.dcft()
 
@@ -713,6 +726,7 @@ def run_conv_omp2(name, **kwargs):
 
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.occ()
 
@@ -752,11 +766,6 @@ def run_mp2(name, **kwargs):
     optstash = p4util.OptionsState(
         ['OCC', 'ORB_OPT'])
 
-    # If the scf type is DF/CD, then the AO integrals were never written to disk
-    if psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or psi4.get_option('SCF', 'SCF_TYPE') == 'CD':
-            mints = psi4.MintsHelper()
-            mints.integrals()
-
     psi4.set_local_option('OCC', 'ORB_OPT', 'FALSE')
     run_conv_omp2(name, **kwargs)
 
@@ -777,10 +786,8 @@ def run_oldmp2(name, **kwargs):
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
 
-        # If the scf type is DF/CD, then the AO integrals were never written to disk
-        if psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or psi4.get_option('SCF', 'SCF_TYPE') == 'CD':
-            mints = psi4.MintsHelper()
-            mints.integrals()
+        # Unless the SCF left them on disk, write the AO integrals
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.set_local_option('TRANSQT2', 'WFN', 'MP2')
     psi4.set_local_option('CCSORT', 'WFN', 'MP2')
@@ -834,6 +841,7 @@ def run_scs_omp2(name, **kwargs):
     # Bypass routine scf if user did something special to get it to converge
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.set_local_option('OCC', 'DO_SCS', 'TRUE')
     psi4.occ()
@@ -861,6 +869,7 @@ def run_sos_omp2(name, **kwargs):
     # Bypass routine scf if user did something special to get it to converge
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.set_local_option('OCC', 'DO_SOS', 'TRUE')
     psi4.occ()
@@ -881,10 +890,8 @@ def run_omp3(name, **kwargs):
         scf_helper(name, **kwargs)
 
     psi4.set_local_option('OCC', 'WFN_TYPE', 'OMP3')
-    # If the scf type is DF/CD, then the AO integrals were never written to disk
-    if (psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or
-        psi4.get_option('SCF', 'SCF_TYPE') == 'CD'):
-        psi4.MintsHelper().integrals()
+    # Unless the SCF left them on disk, write the AO integrals
+    check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.occ()
 
@@ -969,10 +976,8 @@ def run_scs_omp3(name, **kwargs):
 
     psi4.set_local_option('OCC', 'DO_SCS', 'TRUE')
     psi4.set_local_option('OCC', 'WFN_TYPE', 'OMP3')
-    # If the scf type is DF/CD, then the AO integrals were never written to disk
-    if (psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or
-        psi4.get_option('SCF', 'SCF_TYPE') == 'CD'):
-        psi4.MintsHelper().integrals()
+    # Unless the SCF left them on disk, write the AO integrals
+    check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
     psi4.occ()
 
     optstash.restore()
@@ -1002,10 +1007,8 @@ def run_sos_omp3(name, **kwargs):
 
     psi4.set_local_option('OCC', 'DO_SOS', 'TRUE')
     psi4.set_local_option('OCC', 'WFN_TYPE', 'OMP3')
-    # If the scf type is DF/CD, then the AO integrals were never written to disk
-    if (psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or
-        psi4.get_option('SCF', 'SCF_TYPE') == 'CD'):
-        psi4.MintsHelper().integrals()
+    # Unless the SCF left them on disk, write the AO integrals
+    check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
     psi4.occ()
 
     optstash.restore()
@@ -1024,10 +1027,8 @@ def run_ocepa(name, **kwargs):
         scf_helper(name, **kwargs)
 
     psi4.set_local_option('OCC', 'WFN_TYPE', 'OCEPA')
-    # If the scf type is DF/CD, then the AO integrals were never written to disk
-    if (psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or
-        psi4.get_option('SCF', 'SCF_TYPE') == 'CD'):
-        psi4.MintsHelper().integrals()
+    # Unless the SCF left them on disk, write the AO integrals
+    check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
     psi4.occ()
 
     optstash.restore()
@@ -1096,10 +1097,8 @@ def run_omp2_5(name, **kwargs):
         scf_helper(name, **kwargs)
 
     psi4.set_local_option('OCC', 'WFN_TYPE', 'OMP2.5')
-    # If the scf type is DF/CD, then the AO integrals were never written to disk
-    if (psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or
-        psi4.get_option('SCF', 'SCF_TYPE') == 'CD'):
-        psi4.MintsHelper().integrals()
+    # Unless the SCF left them on disk, write the AO integrals
+    check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
     psi4.occ()
 
     optstash.restore()
@@ -1592,14 +1591,12 @@ def run_ccenergy(name, **kwargs):
     if not bypass:
         scf_helper(name, **kwargs)
 
-    # If the scf type is DF/CD/or DIRECT, then the AO integrals were never
-    # written to disk
-    IsDF = psi4.get_option('SCF', 'SCF_TYPE') == 'DF'
-    IsCD = psi4.get_option('SCF', 'SCF_TYPE') == 'CD'
-    IsDirect = psi4.get_option('SCF', 'SCF_TYPE') == 'DIRECT'
-    if bypass or IsDF or IsCD or IsDirect:
+    # Unless the SCF left them on disk, write the AO integrals
+    if bypass:
         mints = psi4.MintsHelper()
         mints.integrals()
+    else:
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.transqt2()
     psi4.ccsort()
@@ -1667,10 +1664,8 @@ def run_bccd(name, **kwargs):
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
 
-        # If the scf type is DF/CD, then the AO integrals were never written to disk
-        if psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or psi4.get_option('SCF', 'SCF_TYPE') == 'CD':
-            mints = psi4.MintsHelper()
-            mints.integrals()
+        # Unless the SCF left them on disk, write the AO integrals
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.set_local_option('TRANSQT2', 'DELETE_TEI', 'false')
 
@@ -2018,9 +2013,8 @@ def run_detci_property(name, **kwargs):
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
 
-        # If the scf type is DF/CD, then the AO integrals were never written to disk
-        if psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or psi4.get_option('SCF', 'SCF_TYPE') == 'CD':
-            psi4.MintsHelper().integrals()
+        # Unless the SCF left them on disk, write the AO integrals
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.transqt2()
     psi4.detci()
@@ -2121,6 +2115,7 @@ def run_adc(name, **kwargs):
     # Bypass routine scf if user did something special to get it to converge
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     return psi4.adc()
 
@@ -2292,9 +2287,8 @@ def run_detci(name, **kwargs):
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
 
-        # If the scf type is DF/CD, then the AO integrals were never written to disk
-        if psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or psi4.get_option('SCF', 'SCF_TYPE') == 'CD':
-            psi4.MintsHelper().integrals()
+        # Unless the SCF left them on disk, write the AO integrals
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.transqt2()
     psi4.detci()
@@ -2346,14 +2340,12 @@ def run_dmrgscf(name, **kwargs):
     if not bypass:
         scf_helper(name, **kwargs)
 
-    # If the scf type is DF/CD/or DIRECT, then the AO integrals were never
-    # written to disk
-    IsDF = psi4.get_option('SCF', 'SCF_TYPE') == 'DF'
-    IsCD = psi4.get_option('SCF', 'SCF_TYPE') == 'CD'
-    IsDirect = psi4.get_option('SCF', 'SCF_TYPE') == 'DIRECT'
-    if bypass or IsDF or IsCD or IsDirect:
+    # Unless the SCF left them on disk, write the AO integrals
+    if bypass:
         mints = psi4.MintsHelper()
         mints.integrals()
+    else:
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     e_dmrg = psi4.dmrg()
     optstash.restore()
@@ -2374,14 +2366,12 @@ def run_dmrgci(name, **kwargs):
     if not bypass:
         scf_helper(name, **kwargs)
 
-    # If the scf type is DF/CD/or DIRECT, then the AO integrals were never
-    # written to disk
-    IsDF = psi4.get_option('SCF', 'SCF_TYPE') == 'DF'
-    IsCD = psi4.get_option('SCF', 'SCF_TYPE') == 'CD'
-    IsDirect = psi4.get_option('SCF', 'SCF_TYPE') == 'DIRECT'
-    if bypass or IsDF or IsCD or IsDirect:
+    # Unless the SCF left them on disk, write the AO integrals
+    if bypass:
         mints = psi4.MintsHelper()
         mints.integrals()
+    else:
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.set_local_option('DMRG', 'DMRG_MAXITER', 1)
 
@@ -2408,6 +2398,7 @@ def run_psimrcc_scf(name, **kwargs):
     # Bypass routine scf if user did something special to get it to converge
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     psi4.psimrcc()
     return psi4.get_variable("CURRENT ENERGY")
@@ -2818,6 +2809,7 @@ def run_mrcc(name, **kwargs):
     # TODO: Check to see if we really need to run the SCF code.
     scf_helper(name, **kwargs)
     vscf = psi4.get_variable('SCF TOTAL ENERGY')
+    check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     # The parse_arbitrary_order method provides us the following information
     # We require that level be provided. level is a dictionary
@@ -3150,12 +3142,10 @@ def run_fnocc(name, **kwargs):
     # scf
     scf_helper(name, **kwargs)
 
-    # if the scf type is df/cd, then the ao integrals were never written to disk.
-    if psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or psi4.get_option('SCF', 'SCF_TYPE') == 'CD':
-        # do we generate 4-index eri's with 3-index ones, or do we want conventional eri's?
-        if psi4.get_option('FNOCC', 'USE_DF_INTS') == False:
-            mints = psi4.MintsHelper()
-            mints.integrals()
+    # unless the scf left them on disk, write the ao integrals.
+    # do we generate 4-index eri's with 3-index ones, or do we want conventional eri's?
+    if psi4.get_option('FNOCC', 'USE_DF_INTS') == False:
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     # if this is not cim or FNO-CC, run transqt2.  otherwise, libtrans will be used
     if psi4.get_option('FNOCC', 'NAT_ORBS') == False and psi4.get_option('FNOCC', 'RUN_MP2') == False:
@@ -3266,11 +3256,9 @@ def run_cepa(name, **kwargs):
     psi4.set_local_option('TRANSQT2', 'WFN', 'CCSD')
     scf_helper(name, **kwargs)
 
-    # If the scf type is DF/CD, then the AO integrals were never written to disk
-    if psi4.get_option('SCF', 'SCF_TYPE') == 'DF' or psi4.get_option('SCF', 'SCF_TYPE') == 'CD':
-        if psi4.get_option('FNOCC', 'USE_DF_INTS') == False:
-            mints = psi4.MintsHelper()
-            mints.integrals()
+    # Unless the SCF left them on disk, write the AO integrals
+    if psi4.get_option('FNOCC', 'USE_DF_INTS') == False:
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
     if psi4.get_option('FNOCC', 'NAT_ORBS') == False:
         if psi4.get_option('FNOCC', 'USE_DF_INTS') == False:
@@ -3325,9 +3313,8 @@ def run_detcas(name, **kwargs):
     if not (('bypass_scf' in kwargs) and yes.match(str(kwargs['bypass_scf']))):
         scf_helper(name, **kwargs)
 
-        # If the scf type is DF/CD, then the AO integrals were never written to disk
-        if (psi4.get_option('SCF', 'SCF_TYPE') == 'DF') or (psi4.get_option('SCF', 'SCF_TYPE') == 'CD'):
-            psi4.MintsHelper().integrals()
+        # Unless the SCF left them on disk, write the AO integrals
+        check_iwl_file_from_scf_type(psi4.get_option('SCF', 'SCF_TYPE'))
 
 
     psi4.transqt2()
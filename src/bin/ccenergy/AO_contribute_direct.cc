@@ -0,0 +1,267 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+
+/*! \file
+    \ingroup CCENERGY
+    \brief Integral-direct AO-basis <ab||cd> contribution to T2
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <libqt/qt.h>
+#include <libdpd/dpd.h>
+#include <libmints/mints.h>
+#include <libmints/sointegral_twobody.h>
+#include <psi4-dec.h>
+#include "Params.h"
+#include "MOInfo.h"
+#define EXTERN
+#include "globals.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi { namespace ccenergy {
+
+/* Number of locks guarding the rows of tau2_AO */
+#define AO_DIRECT_NLOCK 1024
+
+/* SO-basis integral machinery and Schwarz bounds, built on the first
+** call of AO_contribute_direct() and kept until AO_direct_done(). */
+struct AODirect {
+    boost::shared_ptr<SOBasisSet> sobasis;
+    boost::shared_ptr<TwoBodySOInt> eri;
+    int nthread;
+    int nshell;
+    std::vector<int> P, Q, R, S;    /* unique SO shell quartets */
+    std::vector<int> so_shell;      /* SO shell of each absolute SO */
+    std::vector<double> schwarz;    /* sqrt(max |(PQ|PQ)|), nshell x nshell */
+};
+
+static AODirect *aodirect = NULL;
+
+/* Records the largest integral of a shell quartet */
+class AOMaxFunctor {
+    double max_;
+public:
+    AOMaxFunctor() : max_(0.0) {}
+    void operator()(int, int, int, int, int, int, int, int, int, int, int, int, double value)
+    {
+        if(std::fabs(value) > max_) max_ = std::fabs(value);
+    }
+    double max() const { return max_; }
+};
+
+/* Adds each integral to tau2_AO exactly as AO_contribute() does for
+** the integrals read from disk.  Every row update of tau2_AO is taken
+** under one of the striped locks, so any number of threads may call
+** the same functor. */
+class AOLadderFunctor {
+    dpdbuf4 *tau1_;
+    dpdbuf4 *tau2_;
+#ifdef _OPENMP
+    omp_lock_t *locks_;
+#endif
+    long int count_;
+
+    void contribute(int p, int q, int r, int s, double value)
+    {
+        int G = tau1_->params->psym[p] ^ tau1_->params->qsym[r];
+        int ncols = tau1_->params->coltot[G];
+        if(!ncols) return;
+
+        int pr = tau1_->params->rowidx[p][r];
+        int qs = tau1_->params->rowidx[q][s];
+#ifdef _OPENMP
+        omp_lock_t *lock = &locks_[(G * 7919 + pr) % AO_DIRECT_NLOCK];
+        omp_set_lock(lock);
+#endif
+        C_DAXPY(ncols, value, tau1_->matrix[G][qs], 1, tau2_->matrix[G][pr], 1);
+#ifdef _OPENMP
+        omp_unset_lock(lock);
+#endif
+    }
+
+public:
+#ifdef _OPENMP
+    AOLadderFunctor(dpdbuf4 *tau1, dpdbuf4 *tau2, omp_lock_t *locks)
+        : tau1_(tau1), tau2_(tau2), locks_(locks), count_(0) {}
+#else
+    AOLadderFunctor(dpdbuf4 *tau1, dpdbuf4 *tau2)
+        : tau1_(tau1), tau2_(tau2), count_(0) {}
+#endif
+
+    void operator()(int p, int q, int r, int s, int, int, int, int, int, int, int, int, double value)
+    {
+        int perm[8][4] = { {p,q,r,s}, {p,q,s,r}, {q,p,r,s}, {q,p,s,r},
+                           {r,s,p,q}, {s,r,p,q}, {r,s,q,p}, {s,r,q,p} };
+
+        /* each distinct permutation of (pq|rs) contributes once */
+        for(int n=0; n < 8; n++) {
+            int m;
+            for(m=0; m < n; m++)
+                if(perm[m][0] == perm[n][0] && perm[m][1] == perm[n][1] &&
+                   perm[m][2] == perm[n][2] && perm[m][3] == perm[n][3]) break;
+            if(m < n) continue;
+            contribute(perm[n][0], perm[n][1], perm[n][2], perm[n][3], value);
+        }
+        count_++;
+    }
+
+    long int count() const { return count_; }
+};
+
+static void AO_direct_init(void)
+{
+    boost::shared_ptr<Wavefunction> wfn = Process::environment.wavefunction();
+    boost::shared_ptr<IntegralFactory> integral = wfn->integral();
+
+    aodirect = new AODirect;
+    aodirect->sobasis = wfn->sobasisset();
+    aodirect->nthread = params.nthreads;
+#ifndef _OPENMP
+    aodirect->nthread = 1;
+#endif
+
+    std::vector<boost::shared_ptr<TwoBodyAOInt> > tb;
+    for(int t=0; t < aodirect->nthread; t++)
+        tb.push_back(boost::shared_ptr<TwoBodyAOInt>(integral->eri()));
+    aodirect->eri = boost::shared_ptr<TwoBodySOInt>(new TwoBodySOInt(tb, integral));
+
+    boost::shared_ptr<SOBasisSet> sobasis = aodirect->sobasis;
+    int nshell = aodirect->nshell = sobasis->nshell();
+
+    /* absolute (irrep-ordered) SO index -> SO shell */
+    aodirect->so_shell.resize(sobasis->dimension().sum());
+    for(int P=0; P < nshell; P++) {
+        for(int i=0; i < sobasis->nfunction(P); i++) {
+            int func = sobasis->function(P) + i;
+            int h = sobasis->irrep(func);
+            int so = sobasis->function_offset_for_irrep(h) + sobasis->function_within_irrep(func);
+            aodirect->so_shell[so] = P;
+        }
+    }
+
+    SOShellCombinationsIterator shellIter(sobasis, sobasis, sobasis, sobasis);
+    for(shellIter.first(); shellIter.is_done() == false; shellIter.next()) {
+        aodirect->P.push_back(shellIter.p());
+        aodirect->Q.push_back(shellIter.q());
+        aodirect->R.push_back(shellIter.r());
+        aodirect->S.push_back(shellIter.s());
+    }
+
+    /* Schwarz bounds from the (PQ|PQ) quartets */
+    aodirect->schwarz.assign(nshell*nshell, 0.0);
+    for(int P=0; P < nshell; P++) {
+        for(int Q=0; Q <= P; Q++) {
+            AOMaxFunctor max;
+            aodirect->eri->compute_shell(P, Q, P, Q, max);
+            aodirect->schwarz[P*nshell+Q] = aodirect->schwarz[Q*nshell+P] = std::sqrt(max.max());
+        }
+    }
+}
+
+void AO_direct_done(void)
+{
+    delete aodirect;
+    aodirect = NULL;
+}
+
+/* AO_contribute_direct(): Integral-direct counterpart of the
+** PSIF_SO_TEI loop over AO_contribute().  The SO shell quartets are
+** recomputed on params.nthreads threads and contracted with tau1_AO
+** straight into tau2_AO.  A quartet is skipped when its Schwarz bound
+** times the largest element of tau1_AO on its shell pairs falls below
+** params.ints_tolerance.  Returns the number of integrals processed.
+*/
+int AO_contribute_direct(dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO)
+{
+    int h, row, col, p, q;
+    long int n, count=0, nskip=0;
+
+    if(aodirect == NULL) AO_direct_init();
+
+    int nshell = aodirect->nshell;
+    int nthread = aodirect->nthread;
+    const std::vector<int> &so_shell = aodirect->so_shell;
+    const std::vector<double> &schwarz = aodirect->schwarz;
+
+    /* largest |tau1_AO| on each SO shell pair */
+    std::vector<double> tau_max(nshell*nshell, 0.0);
+    for(h=0; h < tau1_AO->params->nirreps; h++) {
+        for(row=0; row < tau1_AO->params->rowtot[h]; row++) {
+            p = so_shell[tau1_AO->params->roworb[h][row][0]];
+            q = so_shell[tau1_AO->params->roworb[h][row][1]];
+            double max = 0.0;
+            for(col=0; col < tau1_AO->params->coltot[h]; col++)
+                if(std::fabs(tau1_AO->matrix[h][row][col]) > max) max = std::fabs(tau1_AO->matrix[h][row][col]);
+            if(max > tau_max[p*nshell+q]) tau_max[p*nshell+q] = tau_max[q*nshell+p] = max;
+        }
+    }
+
+    const std::vector<int> &P = aodirect->P, &Q = aodirect->Q;
+    const std::vector<int> &R = aodirect->R, &S = aodirect->S;
+    long int nquartet = P.size();
+
+#ifdef _OPENMP
+    std::vector<omp_lock_t> locks(AO_DIRECT_NLOCK);
+    for(n=0; n < AO_DIRECT_NLOCK; n++) omp_init_lock(&locks[n]);
+#endif
+
+#pragma omp parallel num_threads(nthread) reduction(+:count,nskip)
+    {
+#ifdef _OPENMP
+        AOLadderFunctor ladder(tau1_AO, tau2_AO, &locks[0]);
+#else
+        AOLadderFunctor ladder(tau1_AO, tau2_AO);
+#endif
+
+#pragma omp for schedule(dynamic)
+        for(n=0; n < nquartet; n++) {
+            int Pn = P[n], Qn = Q[n], Rn = R[n], Sn = S[n];
+            double tmax = std::max(std::max(tau_max[Pn*nshell+Rn], tau_max[Pn*nshell+Sn]),
+                                   std::max(tau_max[Qn*nshell+Rn], tau_max[Qn*nshell+Sn]));
+            if(schwarz[Pn*nshell+Qn] * schwarz[Rn*nshell+Sn] * tmax < params.ints_tolerance) {
+                nskip++;
+                continue;
+            }
+            aodirect->eri->compute_shell(Pn, Qn, Rn, Sn, ladder);
+        }
+
+        count += ladder.count();
+    }
+
+#ifdef _OPENMP
+    for(n=0; n < AO_DIRECT_NLOCK; n++) omp_destroy_lock(&locks[n]);
+#endif
+
+    if(params.print & 2)
+        outfile->Printf( "     *** Skipped %ld of %ld SO shell quartets by Schwarz screening\n", nskip, nquartet);
+
+    return count;
+}
+
+}} // namespace psi::ccenergy
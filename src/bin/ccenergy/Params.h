@@ -40,6 +40,7 @@ struct Params {
   int restart;
   long int memory;
   std::string aobasis;
+  double ints_tolerance;
   int cachelev;
   int cachetype;
   int ref;
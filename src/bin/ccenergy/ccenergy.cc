@@ -121,6 +121,9 @@ void form_df_ints(Options &options, int **cachelist, int *cachefiles, dpd_file4_
 void local_init(void);
 void local_done(void);
 
+/* integral-direct AO-basis <ab||cd> terms */
+void AO_direct_done(void);
+
 PsiReturnType ccenergy(Options &options);
 
 }} //namespace psi::ccenergy
@@ -449,6 +452,7 @@ PsiReturnType ccenergy(Options &options)
         outfile->Printf( "\t ** Wave function not converged to %2.1e ** \n",
                 params.convergence);
         
+        if( params.aobasis == "DIRECT" ) AO_direct_done();
         if( params.aobasis != "NONE" ) dpd_close(1);
         dpd_close(0);
         cleanup();
@@ -618,6 +622,7 @@ PsiReturnType ccenergy(Options &options)
     if(params.brueckner)
         Process::environment.globals["BRUECKNER CONVERGED"] = rotate();
 
+    if( params.aobasis == "DIRECT" ) AO_direct_done();
     if( params.aobasis != "NONE" ) dpd_close(1);
     dpd_close(0);
 
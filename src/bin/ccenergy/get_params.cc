@@ -103,6 +103,7 @@ void get_params(Options &options)
   params.memory = Process::environment.get_memory();
 
   params.aobasis = options.get_str("AO_BASIS");
+  params.ints_tolerance = options.get_double("INTS_TOLERANCE");
   params.cachelev = options.get_int("CACHELEVEL");
 
   params.cachetype = 1;
@@ -26,90 +26,88 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 #include <libciomr/libciomr.h>
 #include <libdpd/dpd.h>
-#include <exception.h>
 #include <libqt/qt.h>
-#include <pthread.h>
 #include <psiconfig.h>
 #include "MOInfo.h"
 #include "Params.h"
+#include "ijk_schedule.h"
 #define EXTERN
 #include "globals.h"
 #include "libparallel/ParallelPrinter.h"
-//MKL Header
-#ifdef HAVE_MKL
-#include <mkl.h>
+#ifdef _OPENMP
+#include <omp.h>
 #endif
 
-
 namespace psi { namespace cctriples {
 
-pthread_mutex_t mut = PTHREAD_MUTEX_INITIALIZER;
-
-struct thread_data {
+/* Quantities shared read-only by all ijk threads */
+struct ET_RHF_data {
  dpdfile2 *fIJ; dpdfile2 *fAB; dpdfile2 *fIA; dpdfile2 *T1;
- dpdbuf4 *T2; dpdbuf4 *Eints; dpdbuf4 *Dints; dpdbuf4 *Fints_local;
- double *ET_local; int Gi; int Gj; int Gk; int first_ijk; int last_ijk;
+ dpdbuf4 *T2; dpdbuf4 *Eints; dpdbuf4 *Dints; dpdbuf4 *Fints;
+ int Fincore;  /* all F <ia|bc> blocks held in Fints->matrix */
+};
+
+/* Per-thread scratch, allocated once and reused for every triplet.
+** W[0] holds W0, W[1] holds W1 and then V, W[2..4] hold X, Y, Z. */
+struct ET_RHF_scratch {
+ IJKBlock W[5];
+ IJKRows F;         /* private F buffer when F is read by blocks */
+ long int nijk;     /* triplets done by this thread */
+ double cost;       /* and their summed cost */
 };
 
-void *ET_RHF_thread(void *thread_data);
+double ET_RHF_ijk(IJKTask *task, struct ET_RHF_data *data, struct ET_RHF_scratch *scratch);
+
+/* ET_RHF_F_block(): Returns the rows F <id|bc> of occupied I for all d
+** in the irrep with Gid = Gi ^ Gd.  They point into the shared
+** in-core integrals, or are read into the thread's own buffer, one
+** thread at a time.  Returns NULL for an empty block.
+*/
+static double **ET_RHF_F_block(struct ET_RHF_data *data, struct ET_RHF_scratch *scratch,
+                               int Gid, int I, int nd)
+{
+  int row;
+  dpdbuf4 *Fints;
+
+  Fints = data->Fints;
+  if(!nd || !Fints->params->coltot[Gid]) return NULL;
+
+  row = Fints->row_offset[Gid][I];
+  if(data->Fincore) return &(Fints->matrix[Gid][row]);
 
+  return ijk_rows_rd(&(scratch->F), Gid, row, nd);
+}
+
+/* ET_RHF(): Computes the RHF-CCSD(T) energy.  The occupied triplets
+** I >= J >= K are computed concurrently from a list sorted by cost and
+** handed out one at a time.  The T2, D, E, and (when they fit) F
+** quantities are held in core once and shared by all threads; each
+** thread owns only the W, V, X, Y, Z intermediates of its current
+** triplet.  Threads left over when there are fewer triplets, or room
+** for fewer sets of intermediates, than threads go to the BLAS.
+*/
 double ET_RHF(void)
 {
-  int i,j,k,I,J,K,Gi,Gj,Gk, h, nirreps, cnt;
-  int nijk, nthreads, thread, *ijk_part, errcod;
-  int *occpi, *virtpi, *occ_off, *vir_off;
-  double ET, *ET_array;
+  int h, nirreps, m, thread;
+  int nthreads, nthreads_ijk, nthreads_blas, old_threads, old_nested;
+  int *occpi, *virtpi, *occ_off;
+  long int n, ntasks, max_abc, max_F, F_size;
+  long int mem_avail, mem_shared, mem_per_thread;
+  double ET;
   dpdfile2 fIJ, fAB, fIA, T1;
-  dpdbuf4 T2, Eints, Dints, *Fints_array;
-  FILE *ijkfile;
-  pthread_t  *p_thread;
-  struct thread_data *thread_data_array;
+  dpdbuf4 T2, Eints, Dints, Fints;
+  std::vector<IJKTask> tasks;
+  struct ET_RHF_data data;
+  struct ET_RHF_scratch *scratch;
 
   timer_on("ET_RHF");
 
   nirreps = moinfo.nirreps;
   occpi = moinfo.occpi; virtpi = moinfo.virtpi;
   occ_off = moinfo.occ_off;
-  vir_off = moinfo.vir_off;
-
-  nthreads = params.nthreads;
-
-  long int mem_avail = dpd_memfree();
-  // Find the size of 4 abc-blocks of the largest irrep
-  long int max_a = 0;
-  for (h=0; h<nirreps; ++h)
-    if (virtpi[h] > max_a)
-      max_a = virtpi[h];
-  long int thread_mem_estimate = 4 * max_a * max_a * max_a;
-
-  outfile->Printf("\tMemory available in words        : %15ld\n", mem_avail);
-  outfile->Printf("\t~Words needed per explicit thread: %15ld\n", thread_mem_estimate);
-
-  // subtract at least 1/2 for non-abc quantities (mainly 2 ijab's + other buffers)
-  double tval = (double) mem_avail / (double) thread_mem_estimate;
-  int possible_nthreads = tval - 0.5;
-  if (possible_nthreads < 1) possible_nthreads = 1;
-
-  // note keyword is not detected in cctriples section if cctriples is called 
-  // by ccenergy directly as in energy(ccsd't') at present.
-  if (possible_nthreads < nthreads) {
-    nthreads = possible_nthreads;
-    outfile->Printf("\tReducing threads due to memory limitations.\n");
-  }
-
-  outfile->Printf("\tNumber of threads for explicit ijk threading: %4d.\n", nthreads);
-
-// Don't parallelize mkl if explicit threads are used; should be added for acml too.
-#ifdef HAVE_MKL
-  int old_threads = mkl_get_max_threads();
-  mkl_set_num_threads(1);
-  outfile->Printf("\tMKL num_threads set to 1 for explicit threading.\n\n");
-#endif
-
-  thread_data_array = (struct thread_data *) malloc(nthreads*sizeof(struct thread_data));
-  p_thread = (pthread_t *) malloc(nthreads*sizeof(pthread_t));
 
   global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
   global_dpd_->file2_init(&fAB, PSIF_CC_OEI, 0, 1, 1, "fAB");
@@ -138,114 +136,109 @@ double ET_RHF(void)
     global_dpd_->buf4_mat_irrep_init(&Dints, h);
     global_dpd_->buf4_mat_irrep_rd(&Dints, h);
   }
-  boost::shared_ptr<OutFile> printer(new OutFile("ijk.dat",TRUNCATE));
-  //ffile(&ijkfile,"ijk.dat", 0);
-
-  /* each thread gets its own F buffer to assign memory and read blocks
-     into and its own energy double - all else shared */
-  Fints_array = (dpdbuf4 *) malloc(nthreads*sizeof(dpdbuf4));
-  for (thread=0; thread<nthreads;++thread)
-    global_dpd_->buf4_init(&(Fints_array[thread]), PSIF_CC_FINTS, 0, 10, 5, 10, 5, 0, "F <ia|bc>");
-  ET_array = (double *) malloc(nthreads*sizeof(double));
-  ijk_part = new int [nthreads];
-
-  for (thread=0;thread<nthreads;++thread) {
-    thread_data_array[thread].fIJ = &fIJ;
-    thread_data_array[thread].fAB = &fAB;
-    thread_data_array[thread].fIA = &fIA;
-    thread_data_array[thread].T1 = &T1;
-    thread_data_array[thread].T2 = &T2;
-    thread_data_array[thread].Eints = &Eints;
-    thread_data_array[thread].Dints = &Dints;
-    thread_data_array[thread].Fints_local = &(Fints_array[thread]);
-    thread_data_array[thread].ET_local = &(ET_array[thread]);
+  global_dpd_->buf4_init(&Fints, PSIF_CC_FINTS, 0, 10, 5, 10, 5, 0, "F <ia|bc>");
+
+  /* Sizes of the largest abc intermediate and of the F integrals */
+  max_abc = ijk_block_words(nirreps, Fints.params->coltot, virtpi);
+  max_F = ijk_rows_words(&Fints, virtpi);
+
+  F_size = 0;
+  for(h=0; h < nirreps; h++)
+    F_size += (long int) Fints.params->rowtot[h] * Fints.params->coltot[h];
+
+  ijk_tasks(tasks, nirreps, -1, -1, -1, occpi, occ_off, occpi, occ_off, occpi, occ_off,
+            virtpi, virtpi, virtpi, IJK_GE, IJK_GE);
+  ntasks = tasks.size();
+
+  /* Share the F integrals if they fit next to one set of intermediates */
+  mem_avail = dpd_memfree();
+  data.Fincore = (F_size + 5 * max_abc <= mem_avail);
+  mem_shared = data.Fincore ? F_size : 0;
+  mem_per_thread = 5 * max_abc + (data.Fincore ? 0 : max_F);
+
+  nthreads = params.nthreads;
+  ijk_threads(ntasks, nthreads, mem_avail, mem_shared, mem_per_thread,
+              &nthreads_ijk, &nthreads_blas);
+#ifndef _OPENMP
+  nthreads_ijk = 1;
+  nthreads_blas = nthreads;
+#endif
+
+  outfile->Printf("\tMemory available in words        : %15ld\n", mem_avail);
+  outfile->Printf("\tWords shared by all threads      : %15ld\n", mem_shared);
+  outfile->Printf("\tWords needed per ijk thread      : %15ld\n", mem_per_thread);
+  outfile->Printf("\tF <ia|bc> integrals held in core : %15s\n", data.Fincore ? "yes" : "no");
+  outfile->Printf("\tNumber of threads for ijk triplets: %4d.\n", nthreads_ijk);
+  outfile->Printf("\tNumber of threads per BLAS call   : %4d.\n\n", nthreads_blas);
+
+  if(data.Fincore) {
+    for(h=0; h < nirreps; h++) {
+      global_dpd_->buf4_mat_irrep_init(&Fints, h);
+      global_dpd_->buf4_mat_irrep_rd(&Fints, h);
+    }
   }
 
-  /* Compute total number of IJK combinations */
-  nijk = 0;
-  for(Gi=0; Gi < nirreps; Gi++)
-    for(Gj=0; Gj < nirreps; Gj++)
-      for(Gk=0; Gk < nirreps; Gk++)
-        for(i=0; i < occpi[Gi]; i++) {
-          I = occ_off[Gi] + i;
-          for(j=0; j < occpi[Gj]; j++) {
-            J = occ_off[Gj] + j;
-            for(k=0; k < occpi[Gk]; k++) {
-              K = occ_off[Gk] + k;
-              if(I >= J && J >= K) nijk++;
-            }
-          }
-        }
-  printer->Printf( "Total number of IJK combinations =: %d\n", nijk);
+  data.fIJ = &fIJ; data.fAB = &fAB; data.fIA = &fIA; data.T1 = &T1;
+  data.T2 = &T2; data.Eints = &Eints; data.Dints = &Dints; data.Fints = &Fints;
+
+  scratch = new ET_RHF_scratch[nthreads_ijk];
+  for(thread=0; thread < nthreads_ijk; thread++) {
+    scratch[thread].nijk = 0;
+    scratch[thread].cost = 0.0;
+    for(m=0; m < 5; m++)
+      ijk_block_init(&(scratch[thread].W[m]), nirreps, Fints.params->coltot, virtpi);
+    if(!data.Fincore)
+      ijk_rows_init(&(scratch[thread].F), &Fints, virtpi);
+  }
+
+  boost::shared_ptr<OutFile> printer(new OutFile("ijk.dat",TRUNCATE));
+  printer->Printf( "Total number of IJK combinations =: %ld\n", ntasks);
+
+  old_threads = ijk_blas_threads(nthreads_blas, nthreads_ijk > 1);
+#ifdef _OPENMP
+  old_nested = omp_get_nested();
+  if(nthreads_ijk > 1 && nthreads_blas > 1) omp_set_nested(1);
+#endif
 
   ET = 0.0;
-  for(Gi=0; Gi < nirreps; Gi++) {
-    for(Gj=0; Gj < nirreps; Gj++) {
-      for(Gk=0; Gk < nirreps; Gk++) {
-
-        nijk = 0; // total number of ijk for these irreps
-        for(i=0; i < occpi[Gi]; i++) {
-          I = occ_off[Gi] + i;
-          for(j=0; j < occpi[Gj]; j++) {
-            J = occ_off[Gj] + j;
-            for(k=0; k < occpi[Gk]; k++) {
-              K = occ_off[Gk] + k;
-              if(I >= J && J >= K) nijk++;
-            }
-          }
-        }
-        printer->Printf( "Num. of IJK with (Gi,Gj,Gk)=(%d,%d,%d) =: %d\n",
-          Gi, Gj, Gk, nijk);
-        if (nijk == 0) continue;
-
-        for (thread=0; thread<nthreads;++thread) {
-          thread_data_array[thread].Gi = Gi;
-          thread_data_array[thread].Gj = Gj;
-          thread_data_array[thread].Gk = Gk;
-          ET_array[thread] = 0.0;
-          ijk_part[thread] = nijk / nthreads; // number of ijk for each thread
-          if (thread < (nijk % nthreads)) ++ijk_part[thread];
-        }
-
-        cnt = 0;
-        for (thread=0; thread<nthreads; ++thread) {
-          if (!ijk_part[thread]) continue;  // there are more threads than nijk
-          thread_data_array[thread].first_ijk = cnt;
-          cnt += ijk_part[thread];
-          thread_data_array[thread].last_ijk = cnt-1;
-        }
-
-        /* execute threads */
-        for (thread=0; thread<nthreads;++thread) {
-          if (!ijk_part[thread]) continue;
-          printer->Printf("\tthread %d: first_ijk=%d,  last_ijk=%d\n", thread,
-            thread_data_array[thread].first_ijk, thread_data_array[thread].last_ijk);
-        }
-
-        for (thread=0;thread<nthreads;++thread) {
-          if (!ijk_part[thread]) continue;
-          errcod = pthread_create(&(p_thread[thread]), NULL, ET_RHF_thread,
-                   (void *) &thread_data_array[thread]);
-          if (errcod) {
-            throw PsiException("pthread_create in ET_RHF()",__FILE__,__LINE__);
-          }
-        }
-
-        for (thread=0; thread<nthreads;++thread) {
-          if (!ijk_part[thread]) continue;
-          errcod = pthread_join(p_thread[thread], NULL);
-          if (errcod) {
-            throw PsiException("pthread_join in ET_RHF() failed",__FILE__,__LINE__);
-          }
-        }
-
-        for (thread=0;thread<nthreads;++thread)
-          ET += ET_array[thread];
-
-      } /* Gk */
-    } /* Gj */
-  } /* Gi */
+#pragma omp parallel private(thread, m) num_threads(nthreads_ijk)
+  {
+    thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+
+#pragma omp for schedule(dynamic,1) reduction(+:ET)
+    for(n=0; n < ntasks; n++) {
+      for(m=0; m < 5; m++)
+        ijk_block_irrep(&(scratch[thread].W[m]), tasks[n].Gi ^ tasks[n].Gj ^ tasks[n].Gk);
+      ET += ET_RHF_ijk(&(tasks[n]), &data, &(scratch[thread]));
+      scratch[thread].nijk++;
+      scratch[thread].cost += tasks[n].cost;
+    }
+  }
+
+#ifdef _OPENMP
+  omp_set_nested(old_nested);
+#endif
+  ijk_blas_threads(old_threads, 0);
+
+  for(thread=0; thread < nthreads_ijk; thread++)
+    printer->Printf("\tthread %d: %ld triplets, cost %.0f\n", thread,
+      scratch[thread].nijk, scratch[thread].cost);
+
+  for(thread=0; thread < nthreads_ijk; thread++) {
+    for(m=0; m < 5; m++)
+      ijk_block_close(&(scratch[thread].W[m]));
+    if(!data.Fincore)
+      ijk_rows_close(&(scratch[thread].F));
+  }
+  delete [] scratch;
 
+  if(data.Fincore)
+    for(h=0; h < nirreps; h++)
+      global_dpd_->buf4_mat_irrep_close(&Fints, h);
+  global_dpd_->buf4_close(&Fints);
 
   for(h=0; h < nirreps; h++) {
     global_dpd_->buf4_mat_irrep_close(&T2, h);
@@ -266,30 +259,17 @@ double ET_RHF(void)
   global_dpd_->file2_close(&fAB);
   global_dpd_->file2_close(&fIA);
 
-  for (thread=0; thread<nthreads; ++thread)
-    global_dpd_->buf4_close(&(Fints_array[thread]));
-
-  free(Fints_array);
-  free(ET_array);
-  delete [] ijk_part;
-
-  free(thread_data_array);
-  free(p_thread);
-
   timer_off("ET_RHF");
 
-#ifdef HAVE_MKL
-  mkl_set_num_threads(old_threads);
-#endif
-
   return ET;
 }
 
-
-void* ET_RHF_thread(void* thread_data_in)
+/* ET_RHF_ijk(): Returns the (T) energy contribution of one occupied
+** triplet I >= J >= K, using the thread's scratch intermediates.
+*/
+double ET_RHF_ijk(IJKTask *task, struct ET_RHF_data *data, struct ET_RHF_scratch *scratch)
 {
-  int h, nirreps, cnt_ijk;
-  int Gp, p, nump;
+  int nirreps;
   int nrows, ncols, nlinks;
   int Gijk, Gid, Gkd, Gjd, Gil, Gkl, Gjl;
   int Gab, Gba, Gbc, Gcb, Gac, Gca;
@@ -298,25 +278,22 @@ void* ET_RHF_thread(void* thread_data_in)
   int il, jl, kl;
   int Gi, Gj, Gk, Ga, Gb, Gc, Gd, Gl;
   int Gij, Gji, Gjk, Gkj, Gik, Gki;
-  int I, J, K, A, B, C, D, L;
-  int i, j, k, a, b, c, d, l;
+  int I, J, K, A, B, C;
+  int i, j, k, a, b, c;
   int ij, ji, ik, ki, jk, kj;
   int *occpi, *virtpi, *occ_off, *vir_off;
   double t_ia, t_jb, t_kc, D_jkbc, D_ikac, D_ijab;
   double f_ia, f_jb, f_kc, t_jkbc, t_ikac, t_ijab;
-  double dijk, value1, value2, value3, value4, value5, value6, denom, *ET_local;
-  double ***W0, ***W1, ***V, ***X, ***Y, ***Z;
+  double dijk, value1, value2, value3, value4, value5, value6, denom, ET;
+  double **F, ***W0, ***W1, ***V, ***X, ***Y, ***Z;
   dpdbuf4 *T2, *Eints, *Dints, *Fints;
   dpdfile2 *fIJ, *fAB, *fIA, *T1;
-  int nijk, nthreads, first_ijk, last_ijk, thr_id;
-  struct thread_data *data;
 
   nirreps = moinfo.nirreps;
   occpi = moinfo.occpi; virtpi = moinfo.virtpi;
   occ_off = moinfo.occ_off;
   vir_off = moinfo.vir_off;
 
-  data = (struct thread_data *) thread_data_in;
   fIJ   = data->fIJ;
   fAB   = data->fAB;
   fIA   = data->fIA;
@@ -324,39 +301,26 @@ void* ET_RHF_thread(void* thread_data_in)
   T2    = data->T2;
   Eints = data->Eints;
   Dints = data->Dints;
-  Fints = data->Fints_local;
-  ET_local  = data->ET_local; // pointer to where thread E goes
-  Gi        =  data->Gi;
-  Gj        =  data->Gj;
-  Gk        =  data->Gk;
-  first_ijk = data->first_ijk;
-  last_ijk  = data->last_ijk;
-
-  W0 = (double ***) malloc(nirreps * sizeof(double **));
-  W1 = (double ***) malloc(nirreps * sizeof(double **));
-  V = (double ***) malloc(nirreps * sizeof(double **));
-  X = (double ***) malloc(nirreps * sizeof(double **));
-  Y = (double ***) malloc(nirreps * sizeof(double **));
-  Z = (double ***) malloc(nirreps * sizeof(double **));
+  Fints = data->Fints;
+
+  W0 = scratch->W[0].W;
+  W1 = V = scratch->W[1].W;
+  X = scratch->W[2].W;
+  Y = scratch->W[3].W;
+  Z = scratch->W[4].W;
+
+  Gi = task->Gi; Gj = task->Gj; Gk = task->Gk;
+  i = task->i; j = task->j; k = task->k;
+  I = occ_off[Gi] + i;
+  J = occ_off[Gj] + j;
+  K = occ_off[Gk] + k;
 
   Gkj = Gjk = Gk ^ Gj;
   Gji = Gij = Gi ^ Gj;
   Gik = Gki = Gi ^ Gk;
   Gijk = Gi ^ Gj ^ Gk;
 
-  cnt_ijk = -1;
-  for(i=0; i < occpi[Gi]; i++) {
-    I = occ_off[Gi] + i;
-    for(j=0; j < occpi[Gj]; j++) {
-      J = occ_off[Gj] + j;
-      for(k=0; k < occpi[Gk]; k++) {
-        K = occ_off[Gk] + k;
-        if(I >= J && J >= K) {
-
-          ++cnt_ijk;
-          /* check to see if this ijk is for this thread */
-          if ( (cnt_ijk < first_ijk) || (cnt_ijk > last_ijk))
-             continue;
+  ET = 0.0;
 
           ij = T2->params->rowidx[I][J];
           ji = T2->params->rowidx[J][I];
@@ -373,16 +337,8 @@ void* ET_RHF_thread(void* thread_data_in)
           if(fIJ->params->rowtot[Gk])
             dijk += fIJ->matrix[Gk][k][k];
 
-                /* Malloc space for the W intermediate */
-
-                // timer_on("malloc");
-                for(Gab=0; Gab < nirreps; Gab++) {
-                  Gc = Gab ^ Gijk;
-
-                  W0[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab],virtpi[Gc]);
-                  W1[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab],virtpi[Gc]);
-                }
-                // timer_off("malloc");
+  /* Clear the W intermediate */
+  ijk_block_zero(&(scratch->W[0]));
 
                 // timer_on("N7 Terms");
 
@@ -393,10 +349,7 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gc = Gkj ^ Gd;
 
                   /* Set up F integrals */
-                  Fints->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gid]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gid, Fints->row_offset[Gid][I], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
+                  F = ET_RHF_F_block(data, scratch, Gid, I, virtpi[Gd]);
 
                   /* Set up T2 amplitudes */
                   cd = T2->col_offset[Gkj][Gc];
@@ -408,11 +361,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gid][0][0]), nrows,
+                            &(F[0][0]), nrows,
                             &(T2->matrix[Gkj][kj][cd]), nlinks, 0.0,
                             &(W0[Gab][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gid], virtpi[Gd], Fints->params->coltot[Gid]);
                 }
 
                 /* -E_jklc * t_ilab */
@@ -450,10 +401,7 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gac = Gid = Gi ^ Gd;
                   Gb = Gjk ^ Gd;
 
-                  Fints->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gid]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gid, Fints->row_offset[Gid][I], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
+                  F = ET_RHF_F_block(data, scratch, Gid, I, virtpi[Gd]);
 
                   bd = T2->col_offset[Gjk][Gb];
 
@@ -463,11 +411,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gid][0][0]), nrows,
+                            &(F[0][0]), nrows,
                             &(T2->matrix[Gjk][jk][bd]), nlinks, 1.0,
                             &(W1[Gac][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gid], virtpi[Gd], Fints->params->coltot[Gid]);
                 }
 
                 /* -E_kjlb * t_ilac */
@@ -502,10 +448,7 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gca = Gkd = Gk ^ Gd;
                   Gb = Gji ^ Gd;
 
-                  Fints->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gkd]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gkd, Fints->row_offset[Gkd][K], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
+                  F = ET_RHF_F_block(data, scratch, Gkd, K, virtpi[Gd]);
 
                   bd = T2->col_offset[Gji][Gb];
 
@@ -515,11 +458,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gkd][0][0]), nrows,
+                            &(F[0][0]), nrows,
                             &(T2->matrix[Gji][ji][bd]), nlinks, 1.0,
                             &(W0[Gca][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gkd], virtpi[Gd], Fints->params->coltot[Gkd]);
                 }
 
                 /* -E_ijlb * t_klca */
@@ -554,10 +495,7 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gcb = Gkd = Gk ^ Gd;
                   Ga = Gij ^ Gd;
 
-                  Fints->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gkd]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gkd, Fints->row_offset[Gkd][K], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
+                  F = ET_RHF_F_block(data, scratch, Gkd, K, virtpi[Gd]);
 
                   ad = T2->col_offset[Gij][Ga];
 
@@ -567,11 +505,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gkd][0][0]), nrows,
+                            &(F[0][0]), nrows,
                             &(T2->matrix[Gij][ij][ad]), nlinks, 1.0,
                             &(W1[Gcb][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gkd], virtpi[Gd], Fints->params->coltot[Gkd]);
                 }
 
                 /* -E_jila * t_klcb */
@@ -606,10 +542,7 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gbc = Gjd = Gj ^ Gd;
                   Ga = Gik ^ Gd;
 
-                  Fints->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gjd]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gjd, Fints->row_offset[Gjd][J], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
+                  F = ET_RHF_F_block(data, scratch, Gjd, J, virtpi[Gd]);
 
                   ad = T2->col_offset[Gik][Ga];
 
@@ -619,11 +552,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gjd][0][0]), nrows,
+                            &(F[0][0]), nrows,
                             &(T2->matrix[Gik][ik][ad]), nlinks, 1.0,
                             &(W0[Gbc][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gjd], virtpi[Gd], Fints->params->coltot[Gjd]);
                 }
 
                 /* -E_kila * t_jlbc */
@@ -658,10 +589,7 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gba = Gjd = Gj ^ Gd;
                   Gc = Gki ^ Gd;
 
-                  Fints->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gjd]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gjd, Fints->row_offset[Gjd][J], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
+                  F = ET_RHF_F_block(data, scratch, Gjd, J, virtpi[Gd]);
 
                   cd = T2->col_offset[Gki][Gc];
 
@@ -671,11 +599,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gjd][0][0]), nrows,
+                            &(F[0][0]), nrows,
                             &(T2->matrix[Gki][ki][cd]), nlinks, 1.0,
                             &(W1[Gba][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gjd], virtpi[Gd], Fints->params->coltot[Gjd]);
                 }
 
                 /* -E_iklc * t_jlba */
@@ -706,16 +632,7 @@ void* ET_RHF_thread(void* thread_data_in)
 
                 // timer_off("N7 Terms");
 
-                // timer_on("malloc");
-                for(Gab=0; Gab < nirreps; Gab++) {
-                  Gc = Gab ^ Gijk;
-                  global_dpd_->free_dpd_block(W1[Gab],Fints->params->coltot[Gab],virtpi[Gc]);
-
-                  V[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab],virtpi[Gc]);
-                }
-                // timer_off("malloc");
-
-                /* Copy W intermediate into V */
+                /* Copy W intermediate into V, which takes over the storage of W1 */
                 for(Gab=0; Gab < nirreps; Gab++) {
                   Gc = Gab ^ Gijk;
 
@@ -812,16 +729,6 @@ void* ET_RHF_thread(void* thread_data_in)
 
                 // timer_off("EST Terms");
 
-                // timer_on("malloc");
-                for(Gab=0; Gab < nirreps; Gab++) {
-                  Gc = Gab ^ Gijk;
-
-                  X[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab],virtpi[Gc]);
-                  Y[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab],virtpi[Gc]);
-                  Z[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab],virtpi[Gc]);
-                }
-                // timer_off("malloc");
-
                 // timer_on("XYZ");
                 /* Build X, Y, and Z intermediates */
 
@@ -867,14 +774,6 @@ void* ET_RHF_thread(void* thread_data_in)
                 }
                 // timer_off("XYZ");
 
-                // timer_on("malloc");
-                for(Gab=0; Gab < nirreps; Gab++) {
-                  Gc = Gab ^ Gijk;
-
-                  global_dpd_->free_dpd_block(V[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-                }
-                // timer_off("malloc");
-
                 // timer_on("Energy");
                 for(Gab=0; Gab < nirreps; Gab++) {
 
@@ -922,7 +821,7 @@ void* ET_RHF_thread(void* thread_data_in)
                           if(fAB->params->rowtot[Gc])
                             denom -= fAB->matrix[Gc][c][c];
 
-                          *ET_local += (value1 * value3 + value2 * value4 + value5) * value6/denom;
+                          ET += (value1 * value3 + value2 * value4 + value5) * value6/denom;
 
                         }
 
@@ -933,25 +832,7 @@ void* ET_RHF_thread(void* thread_data_in)
                 }
                 // timer_off("Energy");
 
-                /* Free the W and V intermediates */
-                // timer_on("malloc");
-                for(Gab=0; Gab < nirreps; Gab++) {
-                  Gc = Gab ^ Gijk;
-
-                  global_dpd_->free_dpd_block(W0[Gab],Fints->params->coltot[Gab],virtpi[Gc]);
-                  global_dpd_->free_dpd_block(X[Gab],Fints->params->coltot[Gab],virtpi[Gc]);
-                  global_dpd_->free_dpd_block(Y[Gab],Fints->params->coltot[Gab],virtpi[Gc]);
-                  global_dpd_->free_dpd_block(Z[Gab],Fints->params->coltot[Gab],virtpi[Gc]);
-                }
-                // timer_off("malloc");
-
-              }
-            } /* k */
-          } /* j */
-        } /* i */
-
-  pthread_exit(NULL);
+  return ET;
 }
 
 }} // namespace psi::CCTRIPLES
-
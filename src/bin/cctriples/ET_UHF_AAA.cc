@@ -27,50 +27,62 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 #include <libdpd/dpd.h>
 #include <libqt/qt.h>
 #include "MOInfo.h"
 #include "Params.h"
+#include "ijk_schedule.h"
 #define EXTERN
 #include "globals.h"
 #include "libparallel/ParallelPrinter.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi { namespace cctriples {
 
+/* Quantities shared read-only by all ijk threads */
+struct ET_UHF_AAA_data {
+ dpdfile2 *fIJ; dpdfile2 *fAB; dpdfile2 *fIA; dpdfile2 *T1;
+ dpdbuf4 *T2; dpdbuf4 *Fints; dpdbuf4 *Eints; dpdbuf4 *Dints;
+};
+
+/* Per-thread scratch, allocated once and reused for every triplet.
+** W[0..3] hold WABC, WBCA, WACB, VABC. */
+struct ET_UHF_AAA_scratch {
+ IJKBlock W[4];
+ IJKRows F;         /* private buffer for the F rows of a triplet */
+ long int nijk;     /* triplets done by this thread */
+ double cost;       /* and their summed cost */
+};
+
+double ET_UHF_AAA_ijk(IJKTask *task, struct ET_UHF_AAA_data *data, struct ET_UHF_AAA_scratch *scratch);
+
+/* ET_UHF_AAA(): Computes the AAA spin component of the UHF-CCSD(T)
+** energy.  The occupied triplets I > J > K are computed
+** concurrently from a list sorted by cost and handed out one at a time,
+** as in ET_RHF().  T2, E, and D are held in core and shared by all
+** threads; each thread owns its abc intermediates and reads the F
+** integral rows of its triplet into a private buffer.
+*/
 double ET_UHF_AAA(void)
 {
-  int cnt;
-  int h, nirreps;
-  int Gi, Gj, Gk, Ga, Gb, Gc, Gd, Gl;
-  int Gji, Gij, Gjk, Gkj, Gik, Gki, Gijk;
-  int Gab, Gbc, Gac;
-  int Gid, Gjd, Gkd;
-  int Gil, Gjl, Gkl;
-  int I, J, K, A, B, C;
-  int i, j, k, a, b, c;
-  int ij, ji, ik, ki, jk, kj;
-  int ab, ba, ac, ca, bc, cb;
-  int cd, ad, bd;
-  int id, jd, kd;
-  int il, jl, kl;
-  int lc, la, lb;
-  int *occpi, *virtpi, *occ_off, *vir_off;
-  double value_c, value_d, dijk, denom, ET;
-  double t_ia, t_ib, t_ic, t_ja, t_jb, t_jc, t_ka, t_kb, t_kc;
-  double f_ia, f_ib, f_ic, f_ja, f_jb, f_jc, f_ka, f_kb, f_kc;
-  double D_jkbc, D_jkac, D_jkba, D_ikbc, D_ikac, D_ikba, D_jibc, D_jiac, D_jiba;
-  double t_jkbc, t_jkac, t_jkba, t_ikbc, t_ikac, t_ikba, t_jibc, t_jiac, t_jiba;
-  int nrows, ncols, nlinks;
+  int h, nirreps, m, thread;
+  int nthreads, nthreads_ijk, nthreads_blas, old_threads, old_nested;
+  int *occpi, *virtpi, *occ_off;
+  long int n, nijk, mem_avail, mem_per_thread;
+  double ET;
   dpdbuf4 T2, Fints, Eints, Dints;
   dpdfile2 fIJ, fAB, fIA, T1;
-  double ***WABC, ***WBCA, ***WACB, ***VABC;
-  int nijk, mijk;
-  FILE *ijkfile;
+  std::vector<IJKTask> tasks;
+  struct ET_UHF_AAA_data data;
+  struct ET_UHF_AAA_scratch *scratch;
 
   nirreps = moinfo.nirreps;
   occpi = moinfo.aoccpi; 
   virtpi = moinfo.avirtpi;
   occ_off = moinfo.aocc_off;
-  vir_off = moinfo.avir_off;
 
   global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
   global_dpd_->file2_init(&fAB, PSIF_CC_OEI, 0, 1, 1, "fAB");
@@ -101,148 +113,247 @@ double ET_UHF_AAA(void)
     global_dpd_->buf4_mat_irrep_rd(&Dints, h);
   }
 
-  /* Compute the number of IJK combinations in this spin case */
-  nijk = 0;
-  for(Gi=0; Gi < nirreps; Gi++)
-    for(Gj=0; Gj < nirreps; Gj++)
-      for(Gk=0; Gk < nirreps; Gk++)
-	for(i=0; i < occpi[Gi]; i++) {
-	  I = occ_off[Gi] + i;
-	  for(j=0; j < occpi[Gj]; j++) {
-	    J = occ_off[Gj] + j;
-	    for(k=0; k < occpi[Gk]; k++) {
-	      K = occ_off[Gk] + k;
-
-	      if(I > J && J > K) nijk++;
-	    }
-	  }
-	}
+  /* List the IJK combinations in this spin case, most expensive first */
+  ijk_tasks(tasks, nirreps, -1, -1, -1, occpi, occ_off, occpi, occ_off, occpi, occ_off,
+	    virtpi, virtpi, virtpi, IJK_GT, IJK_GT);
+  nijk = tasks.size();
+
+  /* Each ijk thread holds its own intermediates and F buffer */
+  mem_avail = dpd_memfree();
+  mem_per_thread = 4 * ijk_block_words(nirreps, Fints.params->coltot, virtpi)
+    + ijk_rows_words(&Fints, virtpi);
+
+  nthreads = params.nthreads;
+  ijk_threads(nijk, nthreads, mem_avail, 0, mem_per_thread,
+	      &nthreads_ijk, &nthreads_blas);
+#ifndef _OPENMP
+  nthreads_ijk = 1;
+  nthreads_blas = nthreads;
+#endif
+
   boost::shared_ptr<OutFile> printer(new OutFile("ijk.dat",TRUNCATE));
-  //ffile(&ijkfile,"ijk.dat", 0);
   printer->Printf("Spin Case: AAA\n");
-  printer->Printf("Number of IJK combintions: %d\n", nijk);
-  printer->Printf("\nCurrent IJK Combination:\n");
-
+  printer->Printf("Number of IJK combintions: %ld\n", nijk);
+  printer->Printf("Threads for ijk triplets: %d, per BLAS call: %d\n", nthreads_ijk, nthreads_blas);
+
+  data.fIJ = &fIJ; data.fAB = &fAB; data.fIA = &fIA; data.T1 = &T1;
+  data.T2 = &T2; data.Fints = &Fints; data.Eints = &Eints; data.Dints = &Dints;
+
+  scratch = new ET_UHF_AAA_scratch[nthreads_ijk];
+  for(thread=0; thread < nthreads_ijk; thread++) {
+    scratch[thread].nijk = 0;
+    scratch[thread].cost = 0.0;
+    for(m=0; m < 4; m++)
+      ijk_block_init(&(scratch[thread].W[m]), nirreps, Fints.params->coltot, virtpi);
+    ijk_rows_init(&(scratch[thread].F), &Fints, virtpi);
+  }
 
-  WABC = (double ***) malloc(nirreps * sizeof(double **));
-  VABC = (double ***) malloc(nirreps * sizeof(double **));
-  WBCA = (double ***) malloc(nirreps * sizeof(double **));
-  WACB = (double ***) malloc(nirreps * sizeof(double **));
+  old_threads = ijk_blas_threads(nthreads_blas, nthreads_ijk > 1);
+#ifdef _OPENMP
+  old_nested = omp_get_nested();
+  if(nthreads_ijk > 1 && nthreads_blas > 1) omp_set_nested(1);
+#endif
 
-  mijk = 0;
   ET = 0.0;
+#pragma omp parallel private(thread) num_threads(nthreads_ijk)
+  {
+    thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+
+#pragma omp for schedule(dynamic,1) reduction(+:ET)
+    for(n=0; n < nijk; n++) {
+      ET += ET_UHF_AAA_ijk(&(tasks[n]), &data, &(scratch[thread]));
+      scratch[thread].nijk++;
+      scratch[thread].cost += tasks[n].cost;
+    }
+  }
 
-  for(Gi=0; Gi < nirreps; Gi++) {
-    for(Gj=0; Gj < nirreps; Gj++) {
-      for(Gk=0; Gk < nirreps; Gk++) {
+#ifdef _OPENMP
+  omp_set_nested(old_nested);
+#endif
+  ijk_blas_threads(old_threads, 0);
 
-	Gij = Gji = Gi ^ Gj;
-	Gjk = Gkj = Gj ^ Gk;
-	Gik = Gki = Gi ^ Gk;
+  for(thread=0; thread < nthreads_ijk; thread++)
+    printer->Printf("\tthread %d: %ld triplets, cost %.0f\n", thread,
+      scratch[thread].nijk, scratch[thread].cost);
 
-	Gijk = Gi ^ Gj ^ Gk;
+  for(thread=0; thread < nthreads_ijk; thread++) {
+    for(m=0; m < 4; m++)
+      ijk_block_close(&(scratch[thread].W[m]));
+    ijk_rows_close(&(scratch[thread].F));
+  }
+  delete [] scratch;
 
-	for(i=0; i < occpi[Gi]; i++) {
-	  I = occ_off[Gi] + i;
-	  for(j=0; j < occpi[Gj]; j++) {
-	    J = occ_off[Gj] + j;
-	    for(k=0; k < occpi[Gk]; k++) {
-	      K = occ_off[Gk] + k;
+  for(h=0; h < nirreps; h++) {
+    global_dpd_->buf4_mat_irrep_close(&T2, h);
+    global_dpd_->buf4_mat_irrep_close(&Eints, h);
+    global_dpd_->buf4_mat_irrep_close(&Dints, h);
+  }
 
-	      if(I > J && J > K) {
+  global_dpd_->buf4_close(&T2);
+  global_dpd_->buf4_close(&Fints);
+  global_dpd_->buf4_close(&Eints);
+  global_dpd_->buf4_close(&Dints);
 
-		mijk++;
-		printer->Printf("%d\n", mijk);
+  global_dpd_->file2_mat_close(&T1);
+  global_dpd_->file2_close(&T1);
 
+  global_dpd_->file2_mat_close(&fIJ);
+  global_dpd_->file2_mat_close(&fAB);
+  global_dpd_->file2_mat_close(&fIA);
+  global_dpd_->file2_close(&fIJ);
+  global_dpd_->file2_close(&fAB);
+  global_dpd_->file2_close(&fIA);
 
-		ij = Eints.params->rowidx[I][J];
-		ji = Eints.params->rowidx[J][I];
-		jk = Eints.params->rowidx[J][K];
-		kj = Eints.params->rowidx[K][J];
-		ik = Eints.params->rowidx[I][K];
-		ki = Eints.params->rowidx[K][I];
+  return ET;
+}
 
-		dijk = 0.0;
-		if(fIJ.params->rowtot[Gi])
-		  dijk += fIJ.matrix[Gi][i][i];
-		if(fIJ.params->rowtot[Gj])
-		  dijk += fIJ.matrix[Gj][j][j];
-		if(fIJ.params->rowtot[Gk])
-		  dijk += fIJ.matrix[Gk][k][k];
+/* ET_UHF_AAA_ijk(): Returns the (T) energy contribution of one AAA
+** occupied triplet, using the thread's scratch intermediates.
+*/
+double ET_UHF_AAA_ijk(IJKTask *task, struct ET_UHF_AAA_data *data, struct ET_UHF_AAA_scratch *scratch)
+{
+  int m;
+  int nirreps;
+  int Gi, Gj, Gk, Ga, Gb, Gc, Gd, Gl;
+  int Gji, Gij, Gjk, Gkj, Gik, Gki, Gijk;
+  int Gab, Gbc, Gac;
+  int Gid, Gjd, Gkd;
+  int Gil, Gjl, Gkl;
+  int I, J, K, A, B, C;
+  int i, j, k, a, b, c;
+  int ij, ji, ik, ki, jk, kj;
+  int ab, ba, ac, ca, bc, cb;
+  int cd, ad, bd;
+  int id, jd, kd;
+  int il, jl, kl;
+  int lc, la, lb;
+  int *occpi, *virtpi, *occ_off, *vir_off;
+  double value_c, value_d, dijk, denom, ET;
+  double t_ia, t_ib, t_ic, t_ja, t_jb, t_jc, t_ka, t_kb, t_kc;
+  double f_ia, f_ib, f_ic, f_ja, f_jb, f_jc, f_ka, f_kb, f_kc;
+  double D_jkbc, D_jkac, D_jkba, D_ikbc, D_ikac, D_ikba, D_jibc, D_jiac, D_jiba;
+  double t_jkbc, t_jkac, t_jkba, t_ikbc, t_ikac, t_ikba, t_jibc, t_jiac, t_jiba;
+  int nrows, ncols, nlinks;
+  dpdbuf4 *T2, *Fints, *Eints, *Dints;
+  dpdfile2 *fIJ, *fAB, *fIA, *T1;
+  double ***WABC, ***WBCA, ***WACB, ***VABC;
+  double **F;
 
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
+  nirreps = moinfo.nirreps;
+  occpi = moinfo.aoccpi;
+  virtpi = moinfo.avirtpi;
+  occ_off = moinfo.aocc_off;
+  vir_off = moinfo.avir_off;
 
-		  WABC[Gab] = global_dpd_->dpd_block_matrix(Fints.params->coltot[Gab], virtpi[Gc]);
+  fIJ = data->fIJ;
+  fAB = data->fAB;
+  fIA = data->fIA;
+  T1 = data->T1;
+  T2 = data->T2;
+  Fints = data->Fints;
+  Eints = data->Eints;
+  Dints = data->Dints;
+
+  WABC = scratch->W[0].W;
+  WBCA = scratch->W[1].W;
+  WACB = scratch->W[2].W;
+  VABC = scratch->W[3].W;
+
+		Gi = task->Gi; Gj = task->Gj; Gk = task->Gk;
+		i = task->i; j = task->j; k = task->k;
+		I = occ_off[Gi] + i;
+		J = occ_off[Gj] + j;
+		K = occ_off[Gk] + k;
+
+		Gij = Gji = Gi ^ Gj;
+		Gjk = Gkj = Gj ^ Gk;
+		Gik = Gki = Gi ^ Gk;
+
+		Gijk = Gi ^ Gj ^ Gk;
+
+		for(m=0; m < 4; m++) {
+		  ijk_block_irrep(&(scratch->W[m]), Gijk);
+		  ijk_block_zero(&(scratch->W[m]));
 		}
 
+		ET = 0.0;
+
+		ij = Eints->params->rowidx[I][J];
+		ji = Eints->params->rowidx[J][I];
+		jk = Eints->params->rowidx[J][K];
+		kj = Eints->params->rowidx[K][J];
+		ik = Eints->params->rowidx[I][K];
+		ki = Eints->params->rowidx[K][I];
+
+		dijk = 0.0;
+		if(fIJ->params->rowtot[Gi])
+		  dijk += fIJ->matrix[Gi][i][i];
+		if(fIJ->params->rowtot[Gj])
+		  dijk += fIJ->matrix[Gj][j][j];
+		if(fIJ->params->rowtot[Gk])
+		  dijk += fIJ->matrix[Gk][k][k];
+
 		for(Gd=0; Gd < nirreps; Gd++) {
 		  /* -t_jkcd * F_idab */
 		  Gab = Gid = Gi ^ Gd;
 		  Gc = Gjk ^ Gd;
 
-		  cd = T2.col_offset[Gjk][Gc];
-		  id = Fints.row_offset[Gid][I];
+		  cd = T2->col_offset[Gjk][Gc];
+		  id = Fints->row_offset[Gid][I];
  
-		  Fints.matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints.params->coltot[Gid]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&Fints, Gid, id, virtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->F), Gid, id, virtpi[Gd]);
 
-		  nrows = Fints.params->coltot[Gid];
+		  nrows = Fints->params->coltot[Gid];
 		  ncols = virtpi[Gc];
 		  nlinks = virtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0,
-			    &(Fints.matrix[Gid][0][0]), nrows,
-			    &(T2.matrix[Gjk][jk][cd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2->matrix[Gjk][jk][cd]), nlinks, 1.0,
 			    &(WABC[Gab][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(Fints.matrix[Gid], virtpi[Gd], Fints.params->coltot[Gid]);
-
 		  /* +t_ikcd * F_jdab */
 		  Gab = Gjd = Gj ^ Gd;
 		  Gc = Gik ^ Gd;
 
-		  cd = T2.col_offset[Gik][Gc];
-		  jd = Fints.row_offset[Gjd][J];
+		  cd = T2->col_offset[Gik][Gc];
+		  jd = Fints->row_offset[Gjd][J];
 
-		  Fints.matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints.params->coltot[Gjd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&Fints, Gjd, jd, virtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->F), Gjd, jd, virtpi[Gd]);
 
-		  nrows = Fints.params->coltot[Gjd];
+		  nrows = Fints->params->coltot[Gjd];
 		  ncols = virtpi[Gc];
 		  nlinks = virtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-			    &(Fints.matrix[Gjd][0][0]), nrows,
-			    &(T2.matrix[Gik][ik][cd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2->matrix[Gik][ik][cd]), nlinks, 1.0,
 			    &(WABC[Gab][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(Fints.matrix[Gjd], virtpi[Gd], Fints.params->coltot[Gjd]);
-
 		  /* +t_jicd * F_kdab */
 		  Gab = Gkd = Gk ^ Gd;
 		  Gc = Gji ^ Gd;
 
-		  cd = T2.col_offset[Gji][Gc];
-		  kd = Fints.row_offset[Gkd][K];
+		  cd = T2->col_offset[Gji][Gc];
+		  kd = Fints->row_offset[Gkd][K];
 
-		  Fints.matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints.params->coltot[Gkd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&Fints, Gkd, kd, virtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->F), Gkd, kd, virtpi[Gd]);
 
-		  nrows = Fints.params->coltot[Gkd];
+		  nrows = Fints->params->coltot[Gkd];
 		  ncols = virtpi[Gc];
 		  nlinks = virtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-			    &(Fints.matrix[Gkd][0][0]), nrows,
-			    &(T2.matrix[Gji][ji][cd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2->matrix[Gji][ji][cd]), nlinks, 1.0,
 			    &(WABC[Gab][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(Fints.matrix[Gkd], virtpi[Gd], Fints.params->coltot[Gkd]);
-
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -250,127 +361,112 @@ double ET_UHF_AAA(void)
 		  Gab = Gil = Gi ^ Gl;
 		  Gc = Gjk ^ Gl;
 
-		  lc = Eints.col_offset[Gjk][Gl];
-		  il = T2.row_offset[Gil][I];
+		  lc = Eints->col_offset[Gjk][Gl];
+		  il = T2->row_offset[Gil][I];
 
-		  nrows = T2.params->coltot[Gil];
+		  nrows = T2->params->coltot[Gil];
 		  ncols = virtpi[Gc];
 		  nlinks = occpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2.matrix[Gil][il][0]), nrows,
-			    &(Eints.matrix[Gjk][jk][lc]), ncols, 1.0,
+			    &(T2->matrix[Gil][il][0]), nrows,
+			    &(Eints->matrix[Gjk][jk][lc]), ncols, 1.0,
 			    &(WABC[Gab][0][0]), ncols);
 
 		  /* +t_jlab E_iklc */
 		  Gab = Gjl = Gj ^ Gl;
 		  Gc = Gik ^ Gl;
 
-		  lc = Eints.col_offset[Gik][Gl];
-		  jl = T2.row_offset[Gjl][J];
+		  lc = Eints->col_offset[Gik][Gl];
+		  jl = T2->row_offset[Gjl][J];
 
-		  nrows = T2.params->coltot[Gjl];
+		  nrows = T2->params->coltot[Gjl];
 		  ncols = virtpi[Gc];
 		  nlinks = occpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2.matrix[Gjl][jl][0]), nrows,
-			    &(Eints.matrix[Gik][ik][lc]), ncols, 1.0,
+			    &(T2->matrix[Gjl][jl][0]), nrows,
+			    &(Eints->matrix[Gik][ik][lc]), ncols, 1.0,
 			    &(WABC[Gab][0][0]), ncols);
 
 		  /* +t_klab E_jilc */
 		  Gab = Gkl = Gk ^ Gl;
 		  Gc = Gji ^ Gl;
 
-		  lc = Eints.col_offset[Gji][Gl];
-		  kl = T2.row_offset[Gkl][K];
+		  lc = Eints->col_offset[Gji][Gl];
+		  kl = T2->row_offset[Gkl][K];
 
-		  nrows = T2.params->coltot[Gkl];
+		  nrows = T2->params->coltot[Gkl];
 		  ncols = virtpi[Gc];
 		  nlinks = occpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2.matrix[Gkl][kl][0]), nrows,
-			    &(Eints.matrix[Gji][ji][lc]), ncols, 1.0,
+			    &(T2->matrix[Gkl][kl][0]), nrows,
+			    &(Eints->matrix[Gji][ji][lc]), ncols, 1.0,
 			    &(WABC[Gab][0][0]), ncols);
 		}
 
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  WBCA[Gab] = global_dpd_->dpd_block_matrix(Fints.params->coltot[Gab], virtpi[Gc]);
-		}
-
 		for(Gd=0; Gd < nirreps; Gd++) {
 		  /* -t_jkad * F_idbc */
 		  Gbc = Gid = Gi ^ Gd;
 		  Ga = Gjk ^ Gd;
 
-		  ad = T2.col_offset[Gjk][Ga];
-		  id = Fints.row_offset[Gid][I];
+		  ad = T2->col_offset[Gjk][Ga];
+		  id = Fints->row_offset[Gid][I];
 
-		  Fints.matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints.params->coltot[Gid]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&Fints, Gid, id, virtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->F), Gid, id, virtpi[Gd]);
 
-		  nrows = Fints.params->coltot[Gid];
+		  nrows = Fints->params->coltot[Gid];
 		  ncols = virtpi[Ga];
 		  nlinks = virtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0,
-			    &(Fints.matrix[Gid][0][0]), nrows,
-			    &(T2.matrix[Gjk][jk][ad]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2->matrix[Gjk][jk][ad]), nlinks, 1.0,
 			    &(WBCA[Gbc][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(Fints.matrix[Gid], virtpi[Gd], Fints.params->coltot[Gid]);
-
 		  /* +t_ikad * F_jdbc */
 		  Gbc = Gjd = Gj ^ Gd;
 		  Ga = Gik ^ Gd;
 
-		  ad = T2.col_offset[Gik][Ga];
-		  jd = Fints.row_offset[Gjd][J];
+		  ad = T2->col_offset[Gik][Ga];
+		  jd = Fints->row_offset[Gjd][J];
 
-		  Fints.matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints.params->coltot[Gjd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&Fints, Gjd, jd, virtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->F), Gjd, jd, virtpi[Gd]);
 
-		  nrows = Fints.params->coltot[Gjd];
+		  nrows = Fints->params->coltot[Gjd];
 		  ncols = virtpi[Ga];
 		  nlinks = virtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-			    &(Fints.matrix[Gjd][0][0]), nrows,
-			    &(T2.matrix[Gik][ik][ad]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2->matrix[Gik][ik][ad]), nlinks, 1.0,
 			    &(WBCA[Gbc][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(Fints.matrix[Gjd], virtpi[Gd], Fints.params->coltot[Gjd]);
-
 		  /* +t_jiad * F_kdbc */
 		  Gbc = Gkd = Gk ^ Gd;
 		  Ga = Gji ^ Gd;
 
-		  ad = T2.col_offset[Gji][Ga];
-		  kd = Fints.row_offset[Gkd][K];
+		  ad = T2->col_offset[Gji][Ga];
+		  kd = Fints->row_offset[Gkd][K];
 
-		  Fints.matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints.params->coltot[Gkd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&Fints, Gkd, kd, virtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->F), Gkd, kd, virtpi[Gd]);
 
-		  nrows = Fints.params->coltot[Gkd];
+		  nrows = Fints->params->coltot[Gkd];
 		  ncols = virtpi[Ga];
 		  nlinks = virtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-			    &(Fints.matrix[Gkd][0][0]), nrows,
-			    &(T2.matrix[Gji][ji][ad]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2->matrix[Gji][ji][ad]), nlinks, 1.0,
 			    &(WBCA[Gbc][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(Fints.matrix[Gkd], virtpi[Gd], Fints.params->coltot[Gkd]);
-
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -378,133 +474,116 @@ double ET_UHF_AAA(void)
 		  Gbc = Gil = Gi ^ Gl;
 		  Ga = Gjk ^ Gl;
 
-		  la = Eints.col_offset[Gjk][Gl];
-		  il = T2.row_offset[Gil][I];
+		  la = Eints->col_offset[Gjk][Gl];
+		  il = T2->row_offset[Gil][I];
 
-		  nrows = T2.params->coltot[Gil];
+		  nrows = T2->params->coltot[Gil];
 		  ncols = virtpi[Ga];
 		  nlinks = occpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2.matrix[Gil][il][0]), nrows,
-			    &(Eints.matrix[Gjk][jk][la]), ncols, 1.0,
+			    &(T2->matrix[Gil][il][0]), nrows,
+			    &(Eints->matrix[Gjk][jk][la]), ncols, 1.0,
 			    &(WBCA[Gbc][0][0]), ncols);
 
 		  /* +t_jlbc E_ikla */
 		  Gbc = Gjl = Gj ^ Gl;
 		  Ga = Gik ^ Gl;
 
-		  la = Eints.col_offset[Gik][Gl];
-		  jl = T2.row_offset[Gjl][J];
+		  la = Eints->col_offset[Gik][Gl];
+		  jl = T2->row_offset[Gjl][J];
 
-		  nrows = T2.params->coltot[Gjl];
+		  nrows = T2->params->coltot[Gjl];
 		  ncols = virtpi[Ga];
 		  nlinks = occpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2.matrix[Gjl][jl][0]), nrows,
-			    &(Eints.matrix[Gik][ik][la]), ncols, 1.0,
+			    &(T2->matrix[Gjl][jl][0]), nrows,
+			    &(Eints->matrix[Gik][ik][la]), ncols, 1.0,
 			    &(WBCA[Gbc][0][0]), ncols);
 
 		  /* +t_klbc E_jila */
 		  Gbc = Gkl = Gk ^ Gl;
 		  Ga = Gji ^ Gl;
 
-		  la = Eints.col_offset[Gji][Gl];
-		  kl = T2.row_offset[Gkl][K];
+		  la = Eints->col_offset[Gji][Gl];
+		  kl = T2->row_offset[Gkl][K];
 
-		  nrows = T2.params->coltot[Gkl];
+		  nrows = T2->params->coltot[Gkl];
 		  ncols = virtpi[Ga];
 		  nlinks = occpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2.matrix[Gkl][kl][0]), nrows,
-			    &(Eints.matrix[Gji][ji][la]), ncols, 1.0,
+			    &(T2->matrix[Gkl][kl][0]), nrows,
+			    &(Eints->matrix[Gji][ji][la]), ncols, 1.0,
 			    &(WBCA[Gbc][0][0]), ncols);
 		}
 
-        global_dpd_->sort_3d(WBCA, WABC, nirreps, Gijk, Fints.params->coltot, Fints.params->colidx,
-		       Fints.params->colorb, Fints.params->rsym, Fints.params->ssym,
-		       vir_off, vir_off, virtpi, vir_off, Fints.params->colidx, cab, 1);
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  global_dpd_->free_dpd_block(WBCA[Gab], Fints.params->coltot[Gab], virtpi[Gc]);
-
-		  WACB[Gab] = global_dpd_->dpd_block_matrix(Fints.params->coltot[Gab], virtpi[Gc]);
-		}
+		global_dpd_->sort_3d(WBCA, WABC, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
+		       Fints->params->colorb, Fints->params->rsym, Fints->params->ssym,
+		       vir_off, vir_off, virtpi, vir_off, Fints->params->colidx, cab, 1);
 
 		for(Gd=0; Gd < nirreps; Gd++) {
 		  /* +t_jkbd * F_idac */
 		  Gac = Gid = Gi ^ Gd;
 		  Gb = Gjk ^ Gd;
 
-		  bd = T2.col_offset[Gjk][Gb];
-		  id = Fints.row_offset[Gid][I];
+		  bd = T2->col_offset[Gjk][Gb];
+		  id = Fints->row_offset[Gid][I];
 
-		  Fints.matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints.params->coltot[Gid]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&Fints, Gid, id, virtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->F), Gid, id, virtpi[Gd]);
 
-		  nrows = Fints.params->coltot[Gid];
+		  nrows = Fints->params->coltot[Gid];
 		  ncols = virtpi[Gb];
 		  nlinks = virtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-			    &(Fints.matrix[Gid][0][0]), nrows,
-			    &(T2.matrix[Gjk][jk][bd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2->matrix[Gjk][jk][bd]), nlinks, 1.0,
 			    &(WACB[Gac][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(Fints.matrix[Gid], virtpi[Gd], Fints.params->coltot[Gid]);
-
 		  /* -t_ikbd * F_jdac */
 		  Gac = Gjd = Gj ^ Gd;
 		  Gb = Gik ^ Gd;
 
-		  bd = T2.col_offset[Gik][Gb];
-		  jd = Fints.row_offset[Gjd][J];
+		  bd = T2->col_offset[Gik][Gb];
+		  jd = Fints->row_offset[Gjd][J];
 
-		  Fints.matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints.params->coltot[Gjd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&Fints, Gjd, jd, virtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->F), Gjd, jd, virtpi[Gd]);
 
-		  nrows = Fints.params->coltot[Gjd];
+		  nrows = Fints->params->coltot[Gjd];
 		  ncols = virtpi[Gb];
 		  nlinks = virtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0,
-			    &(Fints.matrix[Gjd][0][0]), nrows,
-			    &(T2.matrix[Gik][ik][bd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2->matrix[Gik][ik][bd]), nlinks, 1.0,
 			    &(WACB[Gac][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(Fints.matrix[Gjd], virtpi[Gd], Fints.params->coltot[Gjd]);
-
 		  /* -t_jibd * F_kdac */
 		  Gac = Gkd = Gk ^ Gd;
 		  Gb = Gji ^ Gd;
 
-		  bd = T2.col_offset[Gji][Gb];
-		  kd = Fints.row_offset[Gkd][K];
+		  bd = T2->col_offset[Gji][Gb];
+		  kd = Fints->row_offset[Gkd][K];
 
-		  Fints.matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints.params->coltot[Gkd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&Fints, Gkd, kd, virtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->F), Gkd, kd, virtpi[Gd]);
 
-		  nrows = Fints.params->coltot[Gkd];
+		  nrows = Fints->params->coltot[Gkd];
 		  ncols = virtpi[Gb];
 		  nlinks = virtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0,
-			    &(Fints.matrix[Gkd][0][0]), nrows,
-			    &(T2.matrix[Gji][ji][bd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2->matrix[Gji][ji][bd]), nlinks, 1.0,
 			    &(WACB[Gac][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(Fints.matrix[Gkd], virtpi[Gd], Fints.params->coltot[Gkd]);
-
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -512,76 +591,68 @@ double ET_UHF_AAA(void)
 		  Gac = Gil = Gi ^ Gl;
 		  Gb = Gjk ^ Gl;
 
-		  lb = Eints.col_offset[Gjk][Gl];
-		  il = T2.row_offset[Gil][I];
+		  lb = Eints->col_offset[Gjk][Gl];
+		  il = T2->row_offset[Gil][I];
 
-		  nrows = T2.params->coltot[Gil];
+		  nrows = T2->params->coltot[Gil];
 		  ncols = virtpi[Gb];
 		  nlinks = occpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2.matrix[Gil][il][0]), nrows,
-			    &(Eints.matrix[Gjk][jk][lb]), ncols, 1.0,
+			    &(T2->matrix[Gil][il][0]), nrows,
+			    &(Eints->matrix[Gjk][jk][lb]), ncols, 1.0,
 			    &(WACB[Gac][0][0]), ncols);
 
 		  /* -t_jlac * E_iklb */
 		  Gac = Gjl = Gj ^ Gl;
 		  Gb = Gik ^ Gl;
 
-		  lb = Eints.col_offset[Gik][Gl];
-		  jl = T2.row_offset[Gjl][J];
+		  lb = Eints->col_offset[Gik][Gl];
+		  jl = T2->row_offset[Gjl][J];
 
-		  nrows = T2.params->coltot[Gjl];
+		  nrows = T2->params->coltot[Gjl];
 		  ncols = virtpi[Gb];
 		  nlinks = occpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2.matrix[Gjl][jl][0]), nrows,
-			    &(Eints.matrix[Gik][ik][lb]), ncols, 1.0,
+			    &(T2->matrix[Gjl][jl][0]), nrows,
+			    &(Eints->matrix[Gik][ik][lb]), ncols, 1.0,
 			    &(WACB[Gac][0][0]), ncols);
 
 		  /* -t_klac * E_jilb */
 		  Gac = Gkl = Gk ^ Gl;
 		  Gb = Gji ^ Gl;
 
-		  lb = Eints.col_offset[Gji][Gl];
-		  kl = T2.row_offset[Gkl][K];
+		  lb = Eints->col_offset[Gji][Gl];
+		  kl = T2->row_offset[Gkl][K];
 
-		  nrows = T2.params->coltot[Gkl];
+		  nrows = T2->params->coltot[Gkl];
 		  ncols = virtpi[Gb];
 		  nlinks = occpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2.matrix[Gkl][kl][0]), nrows,
-			    &(Eints.matrix[Gji][ji][lb]), ncols, 1.0,
+			    &(T2->matrix[Gkl][kl][0]), nrows,
+			    &(Eints->matrix[Gji][ji][lb]), ncols, 1.0,
 			    &(WACB[Gac][0][0]), ncols);
 		}
 
-        global_dpd_->sort_3d(WACB, WABC, nirreps, Gijk, Fints.params->coltot, Fints.params->colidx,
-		       Fints.params->colorb, Fints.params->rsym, Fints.params->ssym,
-		       vir_off, vir_off, virtpi, vir_off, Fints.params->colidx, acb, 1);
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  global_dpd_->free_dpd_block(WACB[Gab], Fints.params->coltot[Gab], virtpi[Gc]);
-		}
+		global_dpd_->sort_3d(WACB, WABC, nirreps, Gijk, Fints->params->coltot, Fints->params->colidx,
+		       Fints->params->colorb, Fints->params->rsym, Fints->params->ssym,
+		       vir_off, vir_off, virtpi, vir_off, Fints->params->colidx, acb, 1);
 
 		/* Add disconnected triples and finish W and V */
 		for(Gab=0; Gab < nirreps; Gab++) {
 		  Gc = Gab ^ Gijk;
 
-		  VABC[Gab] = global_dpd_->dpd_block_matrix(Fints.params->coltot[Gab], virtpi[Gc]);
-
-		  for(ab=0; ab < Fints.params->coltot[Gab]; ab++) {
-		    A = Fints.params->colorb[Gab][ab][0];
-		    Ga = Fints.params->rsym[A];
+		  for(ab=0; ab < Fints->params->coltot[Gab]; ab++) {
+		    A = Fints->params->colorb[Gab][ab][0];
+		    Ga = Fints->params->rsym[A];
 		    a = A - vir_off[Ga];
-		    B = Fints.params->colorb[Gab][ab][1];
-		    Gb = Fints.params->ssym[B];
+		    B = Fints->params->colorb[Gab][ab][1];
+		    Gb = Fints->params->ssym[B];
 		    b = B - vir_off[Gb];
 
 		    Gbc = Gb ^ Gc;
@@ -590,21 +661,21 @@ double ET_UHF_AAA(void)
 		    for(c=0; c < virtpi[Gc]; c++) {
 		      C = vir_off[Gc] + c;
 
-		      bc = Dints.params->colidx[B][C];
-		      ac = Dints.params->colidx[A][C];
+		      bc = Dints->params->colidx[B][C];
+		      ac = Dints->params->colidx[A][C];
 
 		      /* +t_ia * D_jkbc + f_ia * t_jkbc */
 		      if(Gi == Ga && Gjk == Gbc) {
 			t_ia = D_jkbc = f_ia = t_jkbc = 0.0;
 
-			if(T1.params->rowtot[Gi] && T1.params->coltot[Gi]) {
-			  t_ia = T1.matrix[Gi][i][a];
-			  f_ia = fIA.matrix[Gi][i][a];
+			if(T1->params->rowtot[Gi] && T1->params->coltot[Gi]) {
+			  t_ia = T1->matrix[Gi][i][a];
+			  f_ia = fIA->matrix[Gi][i][a];
 			}
 
-			if(Dints.params->rowtot[Gjk] && Dints.params->coltot[Gjk]) {
-			  D_jkbc = Dints.matrix[Gjk][jk][bc];
-			  t_jkbc = T2.matrix[Gjk][jk][bc];
+			if(Dints->params->rowtot[Gjk] && Dints->params->coltot[Gjk]) {
+			  D_jkbc = Dints->matrix[Gjk][jk][bc];
+			  t_jkbc = T2->matrix[Gjk][jk][bc];
 			}
 
 			VABC[Gab][ab][c] += t_ia * D_jkbc + f_ia * t_jkbc;
@@ -614,14 +685,14 @@ double ET_UHF_AAA(void)
 		      if(Gi == Gb && Gjk == Gac) {
 			t_ib = D_jkac = f_ib = t_jkac = 0.0;
 
-			if(T1.params->rowtot[Gi] && T1.params->coltot[Gi]) {
-			  t_ib = T1.matrix[Gi][i][b];
-			  f_ib = fIA.matrix[Gi][i][b];
+			if(T1->params->rowtot[Gi] && T1->params->coltot[Gi]) {
+			  t_ib = T1->matrix[Gi][i][b];
+			  f_ib = fIA->matrix[Gi][i][b];
 			}
 
-			if(Dints.params->rowtot[Gjk] && Dints.params->coltot[Gjk]) {
-			  D_jkac = Dints.matrix[Gjk][jk][ac];
-			  t_jkac = T2.matrix[Gjk][jk][ac];
+			if(Dints->params->rowtot[Gjk] && Dints->params->coltot[Gjk]) {
+			  D_jkac = Dints->matrix[Gjk][jk][ac];
+			  t_jkac = T2->matrix[Gjk][jk][ac];
 			}
 
 			VABC[Gab][ab][c] -= t_ib * D_jkac + f_ib * t_jkac;
@@ -631,14 +702,14 @@ double ET_UHF_AAA(void)
 		      if(Gi == Gc && Gjk == Gab) {
 			t_ic = D_jkba = f_ic = t_jkba = 0.0;
 
-			if(T1.params->rowtot[Gi] && T1.params->coltot[Gi]) {
-			  t_ic = T1.matrix[Gi][i][c];
-			  f_ic = fIA.matrix[Gi][i][c];
+			if(T1->params->rowtot[Gi] && T1->params->coltot[Gi]) {
+			  t_ic = T1->matrix[Gi][i][c];
+			  f_ic = fIA->matrix[Gi][i][c];
 			}
 
-			if(Dints.params->rowtot[Gjk] && Dints.params->coltot[Gjk]) {
-			  D_jkba = Dints.matrix[Gjk][jk][ab];
-			  t_jkba = T2.matrix[Gjk][jk][ab];
+			if(Dints->params->rowtot[Gjk] && Dints->params->coltot[Gjk]) {
+			  D_jkba = Dints->matrix[Gjk][jk][ab];
+			  t_jkba = T2->matrix[Gjk][jk][ab];
 			}
 
 			VABC[Gab][ab][c] += t_ic * D_jkba + f_ic * t_jkba;
@@ -648,14 +719,14 @@ double ET_UHF_AAA(void)
 		      if(Gj == Ga && Gik == Gbc) {
 			t_ja = D_ikbc = f_ja = t_ikbc = 0.0;
 
-			if(T1.params->rowtot[Gj] && T1.params->coltot[Gj]) {
-			  t_ja = T1.matrix[Gj][j][a];
-			  f_ja = fIA.matrix[Gj][j][a];
+			if(T1->params->rowtot[Gj] && T1->params->coltot[Gj]) {
+			  t_ja = T1->matrix[Gj][j][a];
+			  f_ja = fIA->matrix[Gj][j][a];
 			}
 
-			if(Dints.params->rowtot[Gik] && Dints.params->coltot[Gik]) {
-			  D_ikbc = Dints.matrix[Gik][ik][bc];
-			  t_ikbc = T2.matrix[Gik][ik][bc];
+			if(Dints->params->rowtot[Gik] && Dints->params->coltot[Gik]) {
+			  D_ikbc = Dints->matrix[Gik][ik][bc];
+			  t_ikbc = T2->matrix[Gik][ik][bc];
 			}
 
 			VABC[Gab][ab][c] -= t_ja * D_ikbc + f_ja * t_ikbc;
@@ -665,14 +736,14 @@ double ET_UHF_AAA(void)
 		      if(Gj == Gb && Gik == Gac) {
 			t_jb = D_ikac = f_jb = t_ikac = 0.0;
 
-			if(T1.params->rowtot[Gj] && T1.params->coltot[Gj]) {
-			  t_jb = T1.matrix[Gj][j][b];
-			  f_jb = fIA.matrix[Gj][j][b];
+			if(T1->params->rowtot[Gj] && T1->params->coltot[Gj]) {
+			  t_jb = T1->matrix[Gj][j][b];
+			  f_jb = fIA->matrix[Gj][j][b];
 			}
 
-			if(Dints.params->rowtot[Gik] && Dints.params->coltot[Gik]) {
-			  D_ikac = Dints.matrix[Gik][ik][ac];
-			  t_ikac = T2.matrix[Gik][ik][ac];
+			if(Dints->params->rowtot[Gik] && Dints->params->coltot[Gik]) {
+			  D_ikac = Dints->matrix[Gik][ik][ac];
+			  t_ikac = T2->matrix[Gik][ik][ac];
 			}
 
 			VABC[Gab][ab][c] += t_jb * D_ikac + f_jb * t_ikac;
@@ -682,14 +753,14 @@ double ET_UHF_AAA(void)
 		      if(Gj == Gc && Gik == Gab) {
 			t_jc = D_ikba = f_jc = t_ikba = 0.0;
 
-			if(T1.params->rowtot[Gj] && T1.params->coltot[Gj]) {
-			  t_jc = T1.matrix[Gj][j][c];
-			  f_jc = fIA.matrix[Gj][j][c];
+			if(T1->params->rowtot[Gj] && T1->params->coltot[Gj]) {
+			  t_jc = T1->matrix[Gj][j][c];
+			  f_jc = fIA->matrix[Gj][j][c];
 			}
 
-			if(Dints.params->rowtot[Gik] && Dints.params->coltot[Gik]) {
-			  D_ikba = Dints.matrix[Gik][ik][ab];
-			  t_ikba = T2.matrix[Gik][ik][ab];
+			if(Dints->params->rowtot[Gik] && Dints->params->coltot[Gik]) {
+			  D_ikba = Dints->matrix[Gik][ik][ab];
+			  t_ikba = T2->matrix[Gik][ik][ab];
 			}
 
 			VABC[Gab][ab][c] -= t_jc * D_ikba + f_jc * t_ikba;
@@ -699,14 +770,14 @@ double ET_UHF_AAA(void)
 		      if(Gk == Ga && Gji == Gbc) {
 			t_ka = D_jibc = f_ka = t_jibc = 0.0;
 
-			if(T1.params->rowtot[Gk] && T1.params->coltot[Gk]) {
-			  t_ka = T1.matrix[Gk][k][a];
-			  f_ka = fIA.matrix[Gk][k][a];
+			if(T1->params->rowtot[Gk] && T1->params->coltot[Gk]) {
+			  t_ka = T1->matrix[Gk][k][a];
+			  f_ka = fIA->matrix[Gk][k][a];
 			}
 
-			if(Dints.params->rowtot[Gji] && Dints.params->coltot[Gji]) {
-			  D_jibc = Dints.matrix[Gji][ji][bc];
-			  t_jibc = T2.matrix[Gji][ji][bc];
+			if(Dints->params->rowtot[Gji] && Dints->params->coltot[Gji]) {
+			  D_jibc = Dints->matrix[Gji][ji][bc];
+			  t_jibc = T2->matrix[Gji][ji][bc];
 			}
 
 			VABC[Gab][ab][c] -= t_ka * D_jibc + f_ka * t_jibc;
@@ -716,14 +787,14 @@ double ET_UHF_AAA(void)
 		      if(Gk == Gb && Gji == Gac) {
 			t_kb = D_jiac = f_kb = t_jiac = 0.0;
 
-			if(T1.params->rowtot[Gk] && T1.params->coltot[Gk]) {
-			  t_kb = T1.matrix[Gk][k][b];
-			  f_kb = fIA.matrix[Gk][k][b];
+			if(T1->params->rowtot[Gk] && T1->params->coltot[Gk]) {
+			  t_kb = T1->matrix[Gk][k][b];
+			  f_kb = fIA->matrix[Gk][k][b];
 			}
 
-			if(Dints.params->rowtot[Gji] && Dints.params->coltot[Gji]) {
-			  D_jiac = Dints.matrix[Gji][ji][ac];
-			  t_jiac = T2.matrix[Gji][ji][ac];
+			if(Dints->params->rowtot[Gji] && Dints->params->coltot[Gji]) {
+			  D_jiac = Dints->matrix[Gji][ji][ac];
+			  t_jiac = T2->matrix[Gji][ji][ac];
 			}
 
 			VABC[Gab][ab][c] += t_kb * D_jiac + f_kb * t_jiac;
@@ -733,14 +804,14 @@ double ET_UHF_AAA(void)
 		      if(Gk == Gc && Gji == Gab) {
 			t_kc = D_jiba = f_kc = t_jiba = 0.0;
 
-			if(T1.params->rowtot[Gk] && T1.params->coltot[Gk]) {
-			  t_kc = T1.matrix[Gk][k][c];
-			  f_kc = fIA.matrix[Gk][k][c];
+			if(T1->params->rowtot[Gk] && T1->params->coltot[Gk]) {
+			  t_kc = T1->matrix[Gk][k][c];
+			  f_kc = fIA->matrix[Gk][k][c];
 			}
 
-			if(Dints.params->rowtot[Gji] && Dints.params->coltot[Gji]) {
-			  D_jiba = Dints.matrix[Gji][ji][ab];
-			  t_jiba = T2.matrix[Gji][ji][ab];
+			if(Dints->params->rowtot[Gji] && Dints->params->coltot[Gji]) {
+			  D_jiba = Dints->matrix[Gji][ji][ab];
+			  t_jiba = T2->matrix[Gji][ji][ab];
 			}
 
 			VABC[Gab][ab][c] -= t_kc * D_jiba + f_kc * t_jiba;
@@ -754,12 +825,12 @@ double ET_UHF_AAA(void)
 
 		      /* Build the rest of the denominator and divide it into W */
 		      denom = dijk;
-		      if(fAB.params->rowtot[Ga])
-			denom -= fAB.matrix[Ga][a][a];
-		      if(fAB.params->rowtot[Gb])
-			denom -= fAB.matrix[Gb][b][b];
-		      if(fAB.params->rowtot[Gc])
-			denom -= fAB.matrix[Gc][c][c];
+		      if(fAB->params->rowtot[Ga])
+			denom -= fAB->matrix[Ga][a][a];
+		      if(fAB->params->rowtot[Gb])
+			denom -= fAB->matrix[Gb][b][b];
+		      if(fAB->params->rowtot[Gc])
+			denom -= fAB->matrix[Gc][c][c];
 
 		      WABC[Gab][ab][c] /= denom;
 
@@ -769,48 +840,9 @@ double ET_UHF_AAA(void)
 
 		for(Gab=0; Gab < nirreps; Gab++) {
 		  Gc = Gab ^ Gijk;
-		  ET += dot_block(WABC[Gab], VABC[Gab], Fints.params->coltot[Gab], virtpi[Gc], 1.0/6.0);
-		  global_dpd_->free_dpd_block(WABC[Gab], Fints.params->coltot[Gab], virtpi[Gc]);
-		  global_dpd_->free_dpd_block(VABC[Gab], Fints.params->coltot[Gab], virtpi[Gc]);
+		    ET += dot_block(WABC[Gab], VABC[Gab], Fints->params->coltot[Gab], virtpi[Gc], 1.0/6.0);
 		}
 
-	      } /* I >= J >= K */
-
-	    } /* k */
-	  } /* j */
-	} /* i */
-
-      } /* Gk */
-    } /* Gj */
-  } /* Gi */
-
-  free(WABC);
-  free(VABC);
-  free(WBCA);
-  free(WACB);
-
-
-  for(h=0; h < nirreps; h++) {
-    global_dpd_->buf4_mat_irrep_close(&T2, h);
-    global_dpd_->buf4_mat_irrep_close(&Eints, h);
-    global_dpd_->buf4_mat_irrep_close(&Dints, h);
-  }
-
-  global_dpd_->buf4_close(&T2);
-  global_dpd_->buf4_close(&Fints);
-  global_dpd_->buf4_close(&Eints);
-  global_dpd_->buf4_close(&Dints);
-
-  global_dpd_->file2_mat_close(&T1);
-  global_dpd_->file2_close(&T1);
-
-  global_dpd_->file2_mat_close(&fIJ);
-  global_dpd_->file2_mat_close(&fAB);
-  global_dpd_->file2_mat_close(&fIA);
-  global_dpd_->file2_close(&fIJ);
-  global_dpd_->file2_close(&fAB);
-  global_dpd_->file2_close(&fIA);
-
   return ET;
 }
 
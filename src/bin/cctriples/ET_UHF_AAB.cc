@@ -27,58 +27,73 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 #include <libciomr/libciomr.h>
 #include <libqt/qt.h>
 #include <libdpd/dpd.h>
 #include "MOInfo.h"
 #include "Params.h"
+#include "ijk_schedule.h"
 #define EXTERN
 #include "globals.h"
 #include "libparallel/ParallelPrinter.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi { namespace cctriples {
 
+/* Quantities shared read-only by all ijk threads */
+struct ET_UHF_AAB_data {
+ dpdfile2 *T1A; dpdfile2 *T1B; dpdfile2 *fIJ; dpdfile2 *fij;
+ dpdfile2 *fAB; dpdfile2 *fab; dpdfile2 *fIA; dpdfile2 *fia;
+ dpdbuf4 *T2AB; dpdbuf4 *T2AA; dpdbuf4 *T2BA; dpdbuf4 *FAAints;
+ dpdbuf4 *FABints; dpdbuf4 *FBAints; dpdbuf4 *EAAints; dpdbuf4 *EABints;
+ dpdbuf4 *EBAints; dpdbuf4 *DAAints; dpdbuf4 *DABints;
+};
+
+/* Per-thread scratch, allocated once and reused for every triplet.
+** W[0..5] hold WABc, WBcA, WAcB, WcAB, WcBA, VABc. */
+struct ET_UHF_AAB_scratch {
+ IJKBlock W[6];
+ IJKRows FAA, FAB, FBA; /* private buffers for the F rows of a triplet */
+ long int nijk;     /* triplets done by this thread */
+ double cost;       /* and their summed cost */
+};
+
+double ET_UHF_AAB_ijk(IJKTask *task, struct ET_UHF_AAB_data *data, struct ET_UHF_AAB_scratch *scratch);
+
+/* ET_UHF_AAB(): Computes the AAB spin component of the UHF-CCSD(T)
+** energy.  The occupied triplets I > J (alpha) and K (beta) are computed
+** concurrently from a list sorted by cost and handed out one at a time,
+** as in ET_RHF().  T2, E, and D are held in core and shared by all
+** threads; each thread owns its abc intermediates and reads the F
+** integral rows of its triplet into a private buffer.
+*/
 double ET_UHF_AAB(void)
 {
-  int cnt;
-  int h, nirreps;
-  int Gi, Gj, Gk, Ga, Gb, Gc, Gd, Gl;
-  int Gji, Gij, Gjk, Gkj, Gik, Gki, Gijk;
-  int Gab, Gbc, Gac, Gcb, Gca;
-  int Gid, Gjd, Gkd;
-  int Gil, Gjl, Gkl;
-  int I, J, K, A, B, C;
-  int i, j, k, a, b, c;
-  int ij, ji, ik, ki, jk, kj;
-  int ab, ba, ac, ca, bc, cb;
-  int dc, ad, bd;
-  int lc, la, lb;
-  int id, jd, kd;
-  int il, jl, kl;
-  int *aoccpi, *avirtpi, *aocc_off, *avir_off;
-  int *boccpi, *bvirtpi, *bocc_off, *bvir_off;
-  double value_c, value_d, dijk, denom, ET_AAB;
-  double t_ia, t_ib, t_ja, t_jb, t_kc;
-  double f_ia, f_ib, f_ja, f_jb, f_kc;
-  double D_jkbc, D_jkac, D_ikbc, D_ikac, D_jiab;
-  double t_jkbc, t_jkac, t_ikbc, t_ikac, t_jiab;
-  int nrows, ncols, nlinks;
+  int h, nirreps, m, thread;
+  int nthreads, nthreads_ijk, nthreads_blas, old_threads, old_nested;
+  int *aoccpi, *avirtpi, *aocc_off;
+  int *boccpi, *bvirtpi, *bocc_off;
+  long int n, nijk, mem_avail, mem_per_thread;
+  double ET_AAB;
   dpdbuf4 T2AB, T2AA, T2BA;
   dpdbuf4 FAAints, FABints, FBAints;
   dpdbuf4 EAAints, EABints, EBAints;
   dpdbuf4 DAAints, DABints;
   dpdfile2 T1A, T1B, fIJ, fij, fAB, fab, fIA, fia;
-  double ***WABc, ***WBcA, ***WAcB, ***WcAB, ***WcBA, ***VABc;
-  int nijk, mijk;
+  std::vector<IJKTask> tasks;
+  struct ET_UHF_AAB_data data;
+  struct ET_UHF_AAB_scratch *scratch;
 
   nirreps = moinfo.nirreps;
   aoccpi = moinfo.aoccpi; 
   avirtpi = moinfo.avirtpi;
   aocc_off = moinfo.aocc_off;
-  avir_off = moinfo.avir_off;
   boccpi = moinfo.boccpi; 
   bvirtpi = moinfo.bvirtpi;
   bocc_off = moinfo.bocc_off;
-  bvir_off = moinfo.bvir_off;
 
   global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
   global_dpd_->file2_init(&fij, PSIF_CC_OEI, 0, 2, 2, "fij");
@@ -147,128 +162,285 @@ double ET_UHF_AAB(void)
     global_dpd_->buf4_mat_irrep_rd(&DABints, h);
   }
 
-  /* Compute the number of IJK combinations in this spin case */
-  nijk = 0;
-  for(Gi=0; Gi < nirreps; Gi++)
-    for(Gj=0; Gj < nirreps; Gj++)
-      for(Gk=0; Gk < nirreps; Gk++)
-	for(i=0; i < aoccpi[Gi]; i++) {
-	  I = aocc_off[Gi] + i;
-	  for(j=0; j < aoccpi[Gj]; j++) {
-	    J = aocc_off[Gj] + j;
-	    for(k=0; k < boccpi[Gk]; k++) {
-	      K = bocc_off[Gk] + k;
-
-	      if(I > J) nijk++;
-	    }
-	  }
-	}
+  /* List the IJK combinations in this spin case, most expensive first */
+  ijk_tasks(tasks, nirreps, -1, -1, -1, aoccpi, aocc_off, aoccpi, aocc_off, boccpi, bocc_off,
+	    avirtpi, avirtpi, bvirtpi, IJK_GT, IJK_ANY);
+  nijk = tasks.size();
+
+  /* Each ijk thread holds its own intermediates and F buffers */
+  mem_avail = dpd_memfree();
+  mem_per_thread = 2 * ijk_block_words(nirreps, FAAints.params->coltot, bvirtpi)
+    + 2 * ijk_block_words(nirreps, FABints.params->coltot, avirtpi)
+    + 2 * ijk_block_words(nirreps, FBAints.params->coltot, avirtpi)
+    + ijk_rows_words(&FAAints, avirtpi)
+    + ijk_rows_words(&FABints, bvirtpi)
+    + ijk_rows_words(&FBAints, avirtpi);
+
+  nthreads = params.nthreads;
+  ijk_threads(nijk, nthreads, mem_avail, 0, mem_per_thread,
+	      &nthreads_ijk, &nthreads_blas);
+#ifndef _OPENMP
+  nthreads_ijk = 1;
+  nthreads_blas = nthreads;
+#endif
+
   boost::shared_ptr<OutFile> printer(new OutFile("ijk.dat",TRUNCATE));
-  //ffile(&ijkfile,"ijk.dat",0);
   printer->Printf( "Spin Case: AAB\n");
-  printer->Printf( "Number of IJK combintions: %d\n", nijk);
-  printer->Printf( "\nCurrent IJK Combination:\n");
+  printer->Printf( "Number of IJK combintions: %ld\n", nijk);
+  printer->Printf("Threads for ijk triplets: %d, per BLAS call: %d\n", nthreads_ijk, nthreads_blas);
+
+  data.T1A = &T1A; data.T1B = &T1B; data.fIJ = &fIJ; data.fij = &fij;
+  data.fAB = &fAB; data.fab = &fab; data.fIA = &fIA; data.fia = &fia;
+  data.T2AB = &T2AB; data.T2AA = &T2AA; data.T2BA = &T2BA;
+  data.FAAints = &FAAints; data.FABints = &FABints; data.FBAints = &FBAints;
+  data.EAAints = &EAAints; data.EABints = &EABints; data.EBAints = &EBAints;
+  data.DAAints = &DAAints; data.DABints = &DABints;
+
+  scratch = new ET_UHF_AAB_scratch[nthreads_ijk];
+  for(thread=0; thread < nthreads_ijk; thread++) {
+    scratch[thread].nijk = 0;
+    scratch[thread].cost = 0.0;
+    ijk_block_init(&(scratch[thread].W[0]), nirreps, FAAints.params->coltot, bvirtpi);
+    for(m=1; m < 3; m++)
+      ijk_block_init(&(scratch[thread].W[m]), nirreps, FABints.params->coltot, avirtpi);
+    for(m=3; m < 5; m++)
+      ijk_block_init(&(scratch[thread].W[m]), nirreps, FBAints.params->coltot, avirtpi);
+    ijk_block_init(&(scratch[thread].W[5]), nirreps, FAAints.params->coltot, bvirtpi);
+    ijk_rows_init(&(scratch[thread].FAA), &FAAints, avirtpi);
+    ijk_rows_init(&(scratch[thread].FAB), &FABints, bvirtpi);
+    ijk_rows_init(&(scratch[thread].FBA), &FBAints, avirtpi);
+  }
 
+  old_threads = ijk_blas_threads(nthreads_blas, nthreads_ijk > 1);
+#ifdef _OPENMP
+  old_nested = omp_get_nested();
+  if(nthreads_ijk > 1 && nthreads_blas > 1) omp_set_nested(1);
+#endif
 
-  mijk = 0;
   ET_AAB = 0.0;
+#pragma omp parallel private(thread) num_threads(nthreads_ijk)
+  {
+    thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+
+#pragma omp for schedule(dynamic,1) reduction(+:ET_AAB)
+    for(n=0; n < nijk; n++) {
+      ET_AAB += ET_UHF_AAB_ijk(&(tasks[n]), &data, &(scratch[thread]));
+      scratch[thread].nijk++;
+      scratch[thread].cost += tasks[n].cost;
+    }
+  }
 
-  WABc = (double ***) malloc(nirreps * sizeof(double **));
-  WBcA = (double ***) malloc(nirreps * sizeof(double **));
-  WAcB = (double ***) malloc(nirreps * sizeof(double **));
-  WcAB = (double ***) malloc(nirreps * sizeof(double **));
-  WcBA = (double ***) malloc(nirreps * sizeof(double **));
-  VABc = (double ***) malloc(nirreps * sizeof(double **));
+#ifdef _OPENMP
+  omp_set_nested(old_nested);
+#endif
+  ijk_blas_threads(old_threads, 0);
+
+  for(thread=0; thread < nthreads_ijk; thread++)
+    printer->Printf("\tthread %d: %ld triplets, cost %.0f\n", thread,
+      scratch[thread].nijk, scratch[thread].cost);
+
+  for(thread=0; thread < nthreads_ijk; thread++) {
+    for(m=0; m < 6; m++)
+      ijk_block_close(&(scratch[thread].W[m]));
+    ijk_rows_close(&(scratch[thread].FAA));
+    ijk_rows_close(&(scratch[thread].FAB));
+    ijk_rows_close(&(scratch[thread].FBA));
+  }
+  delete [] scratch;
 
-  for(Gi=0; Gi < nirreps; Gi++) {
-    for(Gj=0; Gj < nirreps; Gj++) {
-      for(Gk=0; Gk < nirreps; Gk++) {
+  for(h=0; h < nirreps; h++) {
+    global_dpd_->buf4_mat_irrep_close(&T2AA, h);
+    global_dpd_->buf4_mat_irrep_close(&T2AB, h);
+    global_dpd_->buf4_mat_irrep_close(&T2BA, h);
+    global_dpd_->buf4_mat_irrep_close(&EAAints, h);
+    global_dpd_->buf4_mat_irrep_close(&EABints, h);
+    global_dpd_->buf4_mat_irrep_close(&EBAints, h);
+    global_dpd_->buf4_mat_irrep_close(&DAAints, h);
+    global_dpd_->buf4_mat_irrep_close(&DABints, h);
+  }
 
-	Gij = Gji = Gi ^ Gj;
-	Gjk = Gkj = Gj ^ Gk;
-	Gik = Gki = Gi ^ Gk;
+  global_dpd_->buf4_close(&T2AA);
+  global_dpd_->buf4_close(&T2AB);
+  global_dpd_->buf4_close(&T2BA);
+  global_dpd_->buf4_close(&FAAints);
+  global_dpd_->buf4_close(&FABints);
+  global_dpd_->buf4_close(&FBAints);
+  global_dpd_->buf4_close(&EAAints);
+  global_dpd_->buf4_close(&EABints);
+  global_dpd_->buf4_close(&EBAints);
+  global_dpd_->buf4_close(&DAAints);
+  global_dpd_->buf4_close(&DABints);
 
-	Gijk = Gi ^ Gj ^ Gk;
+  global_dpd_->file2_mat_close(&T1A);
+  global_dpd_->file2_close(&T1A);
+  global_dpd_->file2_mat_close(&T1B);
+  global_dpd_->file2_close(&T1B);
 
-	for(i=0; i < aoccpi[Gi]; i++) {
-	  I = aocc_off[Gi] + i;
-	  for(j=0; j < aoccpi[Gj]; j++) {
-	    J = aocc_off[Gj] + j;
-	    for(k=0; k < boccpi[Gk]; k++) {
-	      K = bocc_off[Gk] + k;
+  global_dpd_->file2_mat_close(&fIJ);
+  global_dpd_->file2_mat_close(&fij);
+  global_dpd_->file2_mat_close(&fAB);
+  global_dpd_->file2_mat_close(&fab);
+  global_dpd_->file2_mat_close(&fIA);
+  global_dpd_->file2_mat_close(&fia);
+  global_dpd_->file2_close(&fIJ);
+  global_dpd_->file2_close(&fij);
+  global_dpd_->file2_close(&fAB);
+  global_dpd_->file2_close(&fab);
+  global_dpd_->file2_close(&fIA);
+  global_dpd_->file2_close(&fia);
 
-	      if(I > J) {
+  return ET_AAB;
+}
 
-		mijk++;
-		printer->Printf( "%d\n", mijk);
+/* ET_UHF_AAB_ijk(): Returns the (T) energy contribution of one AAB
+** occupied triplet, using the thread's scratch intermediates.
+*/
+double ET_UHF_AAB_ijk(IJKTask *task, struct ET_UHF_AAB_data *data, struct ET_UHF_AAB_scratch *scratch)
+{
+  int m;
+  int nirreps;
+  int Gi, Gj, Gk, Ga, Gb, Gc, Gd, Gl;
+  int Gji, Gij, Gjk, Gkj, Gik, Gki, Gijk;
+  int Gab, Gbc, Gac, Gcb, Gca;
+  int Gid, Gjd, Gkd;
+  int Gil, Gjl, Gkl;
+  int I, J, K, A, B, C;
+  int i, j, k, a, b, c;
+  int ij, ji, ik, ki, jk, kj;
+  int ab, ba, ac, ca, bc, cb;
+  int dc, ad, bd;
+  int lc, la, lb;
+  int id, jd, kd;
+  int il, jl, kl;
+  int *aoccpi, *avirtpi, *aocc_off, *avir_off;
+  int *boccpi, *bvirtpi, *bocc_off, *bvir_off;
+  double value_c, value_d, dijk, denom, ET_AAB;
+  double t_ia, t_ib, t_ja, t_jb, t_kc;
+  double f_ia, f_ib, f_ja, f_jb, f_kc;
+  double D_jkbc, D_jkac, D_ikbc, D_ikac, D_jiab;
+  double t_jkbc, t_jkac, t_ikbc, t_ikac, t_jiab;
+  int nrows, ncols, nlinks;
+  dpdbuf4 *T2AB, *T2AA, *T2BA;
+  dpdbuf4 *FAAints, *FABints, *FBAints;
+  dpdbuf4 *EAAints, *EABints, *EBAints;
+  dpdbuf4 *DAAints, *DABints;
+  dpdfile2 *T1A, *T1B, *fIJ, *fij, *fAB, *fab, *fIA, *fia;
+  double ***WABc, ***WBcA, ***WAcB, ***WcAB, ***WcBA, ***VABc;
+  double **F;
 
+  nirreps = moinfo.nirreps;
+  aoccpi = moinfo.aoccpi;
+  avirtpi = moinfo.avirtpi;
+  aocc_off = moinfo.aocc_off;
+  avir_off = moinfo.avir_off;
+  boccpi = moinfo.boccpi;
+  bvirtpi = moinfo.bvirtpi;
+  bocc_off = moinfo.bocc_off;
+  bvir_off = moinfo.bvir_off;
 
-		ij = EAAints.params->rowidx[I][J];
-		ji = EAAints.params->rowidx[J][I];
-		jk = EABints.params->rowidx[J][K];
-		kj = EBAints.params->rowidx[K][J];
-		ik = EABints.params->rowidx[I][K];
-		ki = EBAints.params->rowidx[K][I];
+  T1A = data->T1A;
+  T1B = data->T1B;
+  fIJ = data->fIJ;
+  fij = data->fij;
+  fAB = data->fAB;
+  fab = data->fab;
+  fIA = data->fIA;
+  fia = data->fia;
+  T2AB = data->T2AB;
+  T2AA = data->T2AA;
+  T2BA = data->T2BA;
+  FAAints = data->FAAints;
+  FABints = data->FABints;
+  FBAints = data->FBAints;
+  EAAints = data->EAAints;
+  EABints = data->EABints;
+  EBAints = data->EBAints;
+  DAAints = data->DAAints;
+  DABints = data->DABints;
+
+  WABc = scratch->W[0].W;
+  WBcA = scratch->W[1].W;
+  WAcB = scratch->W[2].W;
+  WcAB = scratch->W[3].W;
+  WcBA = scratch->W[4].W;
+  VABc = scratch->W[5].W;
+
+		Gi = task->Gi; Gj = task->Gj; Gk = task->Gk;
+		i = task->i; j = task->j; k = task->k;
+		I = aocc_off[Gi] + i;
+		J = aocc_off[Gj] + j;
+		K = bocc_off[Gk] + k;
+
+		Gij = Gji = Gi ^ Gj;
+		Gjk = Gkj = Gj ^ Gk;
+		Gik = Gki = Gi ^ Gk;
+
+		Gijk = Gi ^ Gj ^ Gk;
+
+		for(m=0; m < 6; m++) {
+		  ijk_block_irrep(&(scratch->W[m]), Gijk);
+		  ijk_block_zero(&(scratch->W[m]));
+		}
 
-		dijk = 0.0;
-		if(fIJ.params->rowtot[Gi])
-		  dijk += fIJ.matrix[Gi][i][i];
-		if(fIJ.params->rowtot[Gj])
-		  dijk += fIJ.matrix[Gj][j][j];
-		if(fij.params->rowtot[Gk])
-		  dijk += fij.matrix[Gk][k][k];
+		ET_AAB = 0.0;
 
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
+		ij = EAAints->params->rowidx[I][J];
+		ji = EAAints->params->rowidx[J][I];
+		jk = EABints->params->rowidx[J][K];
+		kj = EBAints->params->rowidx[K][J];
+		ik = EABints->params->rowidx[I][K];
+		ki = EBAints->params->rowidx[K][I];
 
-		  WABc[Gab] = global_dpd_->dpd_block_matrix(FAAints.params->coltot[Gab], bvirtpi[Gc]);
-		}
+		dijk = 0.0;
+		if(fIJ->params->rowtot[Gi])
+		  dijk += fIJ->matrix[Gi][i][i];
+		if(fIJ->params->rowtot[Gj])
+		  dijk += fIJ->matrix[Gj][j][j];
+		if(fij->params->rowtot[Gk])
+		  dijk += fij->matrix[Gk][k][k];
 
 		for(Gd=0; Gd < nirreps; Gd++) {
 		  /* +t_JkDc * F_IDAB */
 		  Gab = Gid = Gi ^ Gd;
 		  Gc = Gjk ^ Gd;
 
-		  dc = T2AB.col_offset[Gjk][Gd];
-		  id = FAAints.row_offset[Gid][I];
+		  dc = T2AB->col_offset[Gjk][Gd];
+		  id = FAAints->row_offset[Gid][I];
 
-		  FAAints.matrix[Gid] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FAAints.params->coltot[Gid]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FAAints, Gid, id, avirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FAA), Gid, id, avirtpi[Gd]);
 
- 		  nrows = FAAints.params->coltot[Gid];
+		  nrows = FAAints->params->coltot[Gid];
 		  ncols = bvirtpi[Gc];
 		  nlinks = avirtpi[Gd];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(FAAints.matrix[Gid][0][0]), nrows,
-			    &(T2AB.matrix[Gjk][jk][dc]), ncols, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gjk][jk][dc]), ncols, 1.0,
 			    &(WABc[Gab][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FAAints.matrix[Gid], avirtpi[Gd], FAAints.params->coltot[Gid]);
-
 		  /* -t_IkDc * F_JDAB */
 		  Gab = Gjd = Gj ^ Gd;
 		  Gc = Gik ^ Gd;
 
-		  dc = T2AB.col_offset[Gik][Gd];
-		  jd = FAAints.row_offset[Gjd][J];
+		  dc = T2AB->col_offset[Gik][Gd];
+		  jd = FAAints->row_offset[Gjd][J];
 
-		  FAAints.matrix[Gjd] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FAAints.params->coltot[Gjd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FAAints, Gjd, jd, avirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FAA), Gjd, jd, avirtpi[Gd]);
 
- 		  nrows = FAAints.params->coltot[Gjd];
+		  nrows = FAAints->params->coltot[Gjd];
 		  ncols = bvirtpi[Gc];
 		  nlinks = avirtpi[Gd];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(FAAints.matrix[Gjd][0][0]), nrows,
-			    &(T2AB.matrix[Gik][ik][dc]), ncols, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gik][ik][dc]), ncols, 1.0,
 			    &(WABc[Gab][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FAAints.matrix[Gjd], avirtpi[Gd], FAAints.params->coltot[Gjd]);
-
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -276,90 +448,76 @@ double ET_UHF_AAB(void)
 		  Gab = Gil = Gi ^ Gl;
 		  Gc = Gjk ^ Gl;
 
-		  lc = EABints.col_offset[Gjk][Gl];
-		  il = T2AA.row_offset[Gil][I];
+		  lc = EABints->col_offset[Gjk][Gl];
+		  il = T2AA->row_offset[Gil][I];
 
-		  nrows = T2AA.params->coltot[Gil];
+		  nrows = T2AA->params->coltot[Gil];
 		  ncols = bvirtpi[Gc];
 		  nlinks = aoccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2AA.matrix[Gil][il][0]), nrows,
-			    &(EABints.matrix[Gjk][jk][lc]), ncols, 1.0,
+			    &(T2AA->matrix[Gil][il][0]), nrows,
+			    &(EABints->matrix[Gjk][jk][lc]), ncols, 1.0,
 			    &(WABc[Gab][0][0]), ncols);
 
-
 		  /* +t_JLAB * E_IkLc */
 		  Gab = Gjl = Gj ^ Gl;
 		  Gc = Gik ^ Gl;
 
-		  lc = EABints.col_offset[Gik][Gl];
-		  jl = T2AA.row_offset[Gjl][J];
+		  lc = EABints->col_offset[Gik][Gl];
+		  jl = T2AA->row_offset[Gjl][J];
 
-		  nrows = T2AA.params->coltot[Gjl];
+		  nrows = T2AA->params->coltot[Gjl];
 		  ncols = bvirtpi[Gc];
 		  nlinks = aoccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2AA.matrix[Gjl][jl][0]), nrows,
-			    &(EABints.matrix[Gik][ik][lc]), ncols, 1.0,
+			    &(T2AA->matrix[Gjl][jl][0]), nrows,
+			    &(EABints->matrix[Gik][ik][lc]), ncols, 1.0,
 			    &(WABc[Gab][0][0]), ncols);
 		}
 
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  WBcA[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], avirtpi[Gc]);
-		}
-
 		for(Gd=0; Gd < nirreps; Gd++) {
 
 		  /* -t_JkAd * F_IdBc */
 		  Gbc = Gid = Gi ^ Gd;
 		  Ga = Gjk ^ Gd;
 
-		  ad = T2AB.col_offset[Gjk][Ga];
-		  id = FABints.row_offset[Gid][I];
+		  ad = T2AB->col_offset[Gjk][Ga];
+		  id = FABints->row_offset[Gid][I];
 
-		  FABints.matrix[Gid] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FABints.params->coltot[Gid]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FABints, Gid, id, bvirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FAB), Gid, id, bvirtpi[Gd]);
 
- 		  nrows = FABints.params->coltot[Gid];
+		  nrows = FABints->params->coltot[Gid];
 		  ncols = avirtpi[Ga];
 		  nlinks = bvirtpi[Gd];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0,
-			    &(FABints.matrix[Gid][0][0]), nrows,
-			    &(T2AB.matrix[Gjk][jk][ad]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gjk][jk][ad]), nlinks, 1.0,
 			    &(WBcA[Gbc][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FABints.matrix[Gid], bvirtpi[Gd], FABints.params->coltot[Gid]);
-
-
 		  /* +t_IkAd * F_JdBc */
 		  Gbc = Gjd = Gj ^ Gd;
 		  Ga = Gik ^ Gd;
 
-		  ad = T2AB.col_offset[Gik][Ga];
-		  jd = FABints.row_offset[Gjd][J];
+		  ad = T2AB->col_offset[Gik][Ga];
+		  jd = FABints->row_offset[Gjd][J];
 
-		  FABints.matrix[Gjd] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FABints.params->coltot[Gjd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FABints, Gjd, jd, bvirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FAB), Gjd, jd, bvirtpi[Gd]);
 
- 		  nrows = FABints.params->coltot[Gjd];
+		  nrows = FABints->params->coltot[Gjd];
 		  ncols = avirtpi[Ga];
 		  nlinks = bvirtpi[Gd];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-			    &(FABints.matrix[Gjd][0][0]), nrows,
-			    &(T2AB.matrix[Gik][ik][ad]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gik][ik][ad]), nlinks, 1.0,
 			    &(WBcA[Gbc][0][0]), ncols);
-
-		  global_dpd_->free_dpd_block(FABints.matrix[Gjd], bvirtpi[Gd], FABints.params->coltot[Gjd]);
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -368,50 +526,41 @@ double ET_UHF_AAB(void)
 		  Gbc = Gil = Gi ^ Gl;
 		  Ga = Gkj ^ Gl;
 
-		  la = EBAints.col_offset[Gkj][Gl];
-		  il = T2AB.row_offset[Gil][I];
+		  la = EBAints->col_offset[Gkj][Gl];
+		  il = T2AB->row_offset[Gil][I];
 
-		  nrows = T2AB.params->coltot[Gil];
+		  nrows = T2AB->params->coltot[Gil];
 		  ncols = avirtpi[Ga];
 		  nlinks = boccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2AB.matrix[Gil][il][0]), nrows,
-			    &(EBAints.matrix[Gkj][kj][la]), ncols, 1.0,
+			    &(T2AB->matrix[Gil][il][0]), nrows,
+			    &(EBAints->matrix[Gkj][kj][la]), ncols, 1.0,
 			    &(WBcA[Gbc][0][0]), ncols);
 
-
 		  /* -t_JlBc * E_kIlA */
 		  Gbc = Gjl = Gj ^ Gl;
 		  Ga = Gki ^ Gl;
 
-		  la = EBAints.col_offset[Gki][Gl];
-		  jl = T2AB.row_offset[Gjl][J];
+		  la = EBAints->col_offset[Gki][Gl];
+		  jl = T2AB->row_offset[Gjl][J];
 
-		  nrows = T2AB.params->coltot[Gjl];
+		  nrows = T2AB->params->coltot[Gjl];
 		  ncols = avirtpi[Ga];
 		  nlinks = boccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2AB.matrix[Gjl][jl][0]), nrows,
-			    &(EBAints.matrix[Gki][ki][la]), ncols, 1.0,
+			    &(T2AB->matrix[Gjl][jl][0]), nrows,
+			    &(EBAints->matrix[Gki][ki][la]), ncols, 1.0,
 			    &(WBcA[Gbc][0][0]), ncols);
 
 		}
 
-        global_dpd_->sort_3d(WBcA, WABc, nirreps, Gijk, FABints.params->coltot, FABints.params->colidx,
-		       FABints.params->colorb, FABints.params->rsym, FABints.params->ssym,
-		       avir_off, bvir_off, avirtpi, avir_off, FAAints.params->colidx, cab, 1);
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  global_dpd_->free_dpd_block(WBcA[Gab], FABints.params->coltot[Gab], avirtpi[Gc]);
-
-		  WAcB[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], avirtpi[Gc]);
-		}
+		global_dpd_->sort_3d(WBcA, WABc, nirreps, Gijk, FABints->params->coltot, FABints->params->colidx,
+		       FABints->params->colorb, FABints->params->rsym, FABints->params->ssym,
+		       avir_off, bvir_off, avirtpi, avir_off, FAAints->params->colidx, cab, 1);
 
 		for(Gd=0; Gd < nirreps; Gd++) {
 
@@ -419,47 +568,40 @@ double ET_UHF_AAB(void)
 		  Gac = Gid = Gi ^ Gd;
 		  Gb = Gjk ^ Gd;
 
-		  bd = T2AB.col_offset[Gjk][Gb];
-		  id = FABints.row_offset[Gid][I];
+		  bd = T2AB->col_offset[Gjk][Gb];
+		  id = FABints->row_offset[Gid][I];
 
-		  FABints.matrix[Gid] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FABints.params->coltot[Gid]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FABints, Gid, id, bvirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FAB), Gid, id, bvirtpi[Gd]);
 
- 		  nrows = FABints.params->coltot[Gid];
+		  nrows = FABints->params->coltot[Gid];
 		  ncols = avirtpi[Gb];
 		  nlinks = bvirtpi[Gd];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-			    &(FABints.matrix[Gid][0][0]), nrows,
-			    &(T2AB.matrix[Gjk][jk][bd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gjk][jk][bd]), nlinks, 1.0,
 			    &(WAcB[Gac][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FABints.matrix[Gid], bvirtpi[Gd], FABints.params->coltot[Gid]);
-
-
 		  /* -t_IkBd * F_JdAc */
 		  Gac = Gjd = Gj ^ Gd;
 		  Gb = Gik ^ Gd;
 
-		  bd = T2AB.col_offset[Gik][Gb];
-		  jd = FABints.row_offset[Gjd][J];
+		  bd = T2AB->col_offset[Gik][Gb];
+		  jd = FABints->row_offset[Gjd][J];
 
-		  FABints.matrix[Gjd] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FABints.params->coltot[Gjd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FABints, Gjd, jd, bvirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FAB), Gjd, jd, bvirtpi[Gd]);
 
- 		  nrows = FABints.params->coltot[Gjd];
+		  nrows = FABints->params->coltot[Gjd];
 		  ncols = avirtpi[Gb];
 		  nlinks = bvirtpi[Gd];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0,
-			    &(FABints.matrix[Gjd][0][0]), nrows,
-			    &(T2AB.matrix[Gik][ik][bd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gik][ik][bd]), nlinks, 1.0,
 			    &(WAcB[Gac][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FABints.matrix[Gjd], bvirtpi[Gd], FABints.params->coltot[Gjd]);
-
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -468,49 +610,40 @@ double ET_UHF_AAB(void)
 		  Gac = Gil = Gi ^ Gl;
 		  Gb = Gkj ^ Gl;
 
-		  lb = EBAints.col_offset[Gkj][Gl];
-		  il = T2AB.row_offset[Gil][I];
+		  lb = EBAints->col_offset[Gkj][Gl];
+		  il = T2AB->row_offset[Gil][I];
 
-		  nrows = T2AB.params->coltot[Gil];
+		  nrows = T2AB->params->coltot[Gil];
 		  ncols = avirtpi[Gb];
 		  nlinks = boccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2AB.matrix[Gil][il][0]), nrows,
-			    &(EBAints.matrix[Gkj][kj][lb]), ncols, 1.0,
+			    &(T2AB->matrix[Gil][il][0]), nrows,
+			    &(EBAints->matrix[Gkj][kj][lb]), ncols, 1.0,
 			    &(WAcB[Gac][0][0]), ncols);
 
-
 		  /* +t_JlAc * E_kIlB */
 		  Gac = Gjl = Gj ^ Gl;
 		  Gb = Gki ^ Gl;
 
-		  lb = EBAints.col_offset[Gki][Gl];
-		  jl = T2AB.row_offset[Gjl][J];
+		  lb = EBAints->col_offset[Gki][Gl];
+		  jl = T2AB->row_offset[Gjl][J];
 
-		  nrows = T2AB.params->coltot[Gjl];
+		  nrows = T2AB->params->coltot[Gjl];
 		  ncols = avirtpi[Gb];
 		  nlinks = boccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2AB.matrix[Gjl][jl][0]), nrows,
-			    &(EBAints.matrix[Gki][ki][lb]), ncols, 1.0,
+			    &(T2AB->matrix[Gjl][jl][0]), nrows,
+			    &(EBAints->matrix[Gki][ki][lb]), ncols, 1.0,
 			    &(WAcB[Gac][0][0]), ncols);
 		}
 
-        global_dpd_->sort_3d(WAcB, WABc, nirreps, Gijk, FABints.params->coltot, FABints.params->colidx,
-		       FABints.params->colorb, FABints.params->rsym, FABints.params->ssym,
-		       avir_off, bvir_off, avirtpi, avir_off, FAAints.params->colidx, acb, 1);
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  global_dpd_->free_dpd_block(WAcB[Gab], FABints.params->coltot[Gab], avirtpi[Gc]);
-
-		  WcBA[Gab] = global_dpd_->dpd_block_matrix(FBAints.params->coltot[Gab], avirtpi[Gc]);
-		}
+		global_dpd_->sort_3d(WAcB, WABc, nirreps, Gijk, FABints->params->coltot, FABints->params->colidx,
+		       FABints->params->colorb, FABints->params->rsym, FABints->params->ssym,
+		       avir_off, bvir_off, avirtpi, avir_off, FAAints->params->colidx, acb, 1);
 
 		for(Gd=0; Gd < nirreps; Gd++) {
 
@@ -518,23 +651,20 @@ double ET_UHF_AAB(void)
 		  Gcb = Gkd = Gk ^ Gd;
 		  Ga = Gji ^ Gd;
 
-		  ad = T2AA.col_offset[Gji][Ga];
-		  kd = FBAints.row_offset[Gkd][K];
+		  ad = T2AA->col_offset[Gji][Ga];
+		  kd = FBAints->row_offset[Gkd][K];
 
-		  FBAints.matrix[Gkd] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gkd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gkd, kd, avirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FBA), Gkd, kd, avirtpi[Gd]);
 
- 		  nrows = FBAints.params->coltot[Gkd];
+		  nrows = FBAints->params->coltot[Gkd];
 		  ncols = avirtpi[Ga];
 		  nlinks = avirtpi[Gd];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0,
-			    &(FBAints.matrix[Gkd][0][0]), nrows,
-			    &(T2AA.matrix[Gji][ji][ad]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AA->matrix[Gji][ji][ad]), nlinks, 1.0,
 			    &(WcBA[Gcb][0][0]), ncols);
-
-		  global_dpd_->free_dpd_block(FBAints.matrix[Gkd], avirtpi[Gd], FBAints.params->coltot[Gkd]);
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -543,31 +673,23 @@ double ET_UHF_AAB(void)
 		  Gcb = Gkl = Gk ^ Gl;
 		  Ga = Gji ^ Gl;
 
-		  la = EAAints.col_offset[Gji][Gl];
-		  kl = T2BA.row_offset[Gkl][K];
+		  la = EAAints->col_offset[Gji][Gl];
+		  kl = T2BA->row_offset[Gkl][K];
 
-		  nrows = T2BA.params->coltot[Gkl];
+		  nrows = T2BA->params->coltot[Gkl];
 		  ncols = avirtpi[Ga];
 		  nlinks = aoccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2BA.matrix[Gkl][kl][0]), nrows,
-			    &(EAAints.matrix[Gji][ji][la]), ncols, 1.0,
+			    &(T2BA->matrix[Gkl][kl][0]), nrows,
+			    &(EAAints->matrix[Gji][ji][la]), ncols, 1.0,
 			    &(WcBA[Gcb][0][0]), ncols);
 		}
 
-        global_dpd_->sort_3d(WcBA, WABc, nirreps, Gijk, FBAints.params->coltot, FBAints.params->colidx,
-		       FBAints.params->colorb, FBAints.params->rsym, FBAints.params->ssym,
-		       bvir_off, avir_off, avirtpi, avir_off, FAAints.params->colidx, cba, 1);
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  global_dpd_->free_dpd_block(WcBA[Gab], FBAints.params->coltot[Gab], avirtpi[Gc]);
-
-		  WcAB[Gab] = global_dpd_->dpd_block_matrix(FBAints.params->coltot[Gab], avirtpi[Gc]);
-		}
+		global_dpd_->sort_3d(WcBA, WABc, nirreps, Gijk, FBAints->params->coltot, FBAints->params->colidx,
+		       FBAints->params->colorb, FBAints->params->rsym, FBAints->params->ssym,
+		       bvir_off, avir_off, avirtpi, avir_off, FAAints->params->colidx, cba, 1);
 
 		for(Gd=0; Gd < nirreps; Gd++) {
 
@@ -575,23 +697,20 @@ double ET_UHF_AAB(void)
 		  Gca = Gkd = Gk ^ Gd;
 		  Gb = Gji ^ Gd;
 
-		  bd = T2AA.col_offset[Gji][Gb];
-		  kd = FBAints.row_offset[Gkd][K];
+		  bd = T2AA->col_offset[Gji][Gb];
+		  kd = FBAints->row_offset[Gkd][K];
 
-		  FBAints.matrix[Gkd] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gkd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gkd, kd, avirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FBA), Gkd, kd, avirtpi[Gd]);
 
- 		  nrows = FBAints.params->coltot[Gkd];
+		  nrows = FBAints->params->coltot[Gkd];
 		  ncols = avirtpi[Gb];
 		  nlinks = avirtpi[Gd];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-			    &(FBAints.matrix[Gkd][0][0]), nrows,
-			    &(T2AA.matrix[Gji][ji][bd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AA->matrix[Gji][ji][bd]), nlinks, 1.0,
 			    &(WcAB[Gca][0][0]), ncols);
-
-		  global_dpd_->free_dpd_block(FBAints.matrix[Gkd], avirtpi[Gd], FBAints.params->coltot[Gkd]);
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -600,43 +719,34 @@ double ET_UHF_AAB(void)
 		  Gca = Gkl = Gk ^ Gl;
 		  Gb = Gji ^ Gl;
 
-		  lb = EAAints.col_offset[Gji][Gl];
-		  kl = T2BA.row_offset[Gkl][K];
+		  lb = EAAints->col_offset[Gji][Gl];
+		  kl = T2BA->row_offset[Gkl][K];
 
-		  nrows = T2BA.params->coltot[Gkl];
+		  nrows = T2BA->params->coltot[Gkl];
 		  ncols = avirtpi[Gb];
 		  nlinks = aoccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2BA.matrix[Gkl][kl][0]), nrows,
-			    &(EAAints.matrix[Gji][ji][lb]), ncols, 1.0,
+			    &(T2BA->matrix[Gkl][kl][0]), nrows,
+			    &(EAAints->matrix[Gji][ji][lb]), ncols, 1.0,
 			    &(WcAB[Gca][0][0]), ncols);
 		}
 
-        global_dpd_->sort_3d(WcAB, WABc, nirreps, Gijk, FBAints.params->coltot, FBAints.params->colidx,
-		       FBAints.params->colorb, FBAints.params->rsym, FBAints.params->ssym,
-		       bvir_off, avir_off, avirtpi, avir_off, FAAints.params->colidx, bca, 1);
-
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  global_dpd_->free_dpd_block(WcAB[Gab], FBAints.params->coltot[Gab], avirtpi[Gc]);
-
-		  VABc[Gab] = global_dpd_->dpd_block_matrix(FAAints.params->coltot[Gab], bvirtpi[Gc]);
-		}
+		global_dpd_->sort_3d(WcAB, WABc, nirreps, Gijk, FBAints->params->coltot, FBAints->params->colidx,
+		       FBAints->params->colorb, FBAints->params->rsym, FBAints->params->ssym,
+		       bvir_off, avir_off, avirtpi, avir_off, FAAints->params->colidx, bca, 1);
 
 		/* Add disconnected triples and finish W and V arrays */
 		for(Gab=0; Gab < nirreps; Gab++) {
 		  Gc = Gab ^ Gijk;
 
-		  for(ab=0; ab < FAAints.params->coltot[Gab]; ab++) {
-		    A = FAAints.params->colorb[Gab][ab][0];
-		    Ga = FAAints.params->rsym[A];
+		  for(ab=0; ab < FAAints->params->coltot[Gab]; ab++) {
+		    A = FAAints->params->colorb[Gab][ab][0];
+		    Ga = FAAints->params->rsym[A];
 		    a = A - avir_off[Ga];
-		    B = FAAints.params->colorb[Gab][ab][1];
-		    Gb = FAAints.params->ssym[B];
+		    B = FAAints->params->colorb[Gab][ab][1];
+		    Gb = FAAints->params->ssym[B];
 		    b = B - avir_off[Gb];
 
 		    Gbc = Gb ^ Gc;
@@ -645,21 +755,21 @@ double ET_UHF_AAB(void)
 		    for(c=0; c < bvirtpi[Gc]; c++) {
 		      C = bvir_off[Gc] + c;
 
-		      bc = DABints.params->colidx[B][C];
-		      ac = DABints.params->colidx[A][C];
+		      bc = DABints->params->colidx[B][C];
+		      ac = DABints->params->colidx[A][C];
 
 		      /* +t_IA * D_JkBc + f_IA * t_JkBc */
 		      if(Gi == Ga && Gjk == Gbc) {
 			t_ia = D_jkbc = f_ia = t_jkbc = 0.0;
 
-			if(T1A.params->rowtot[Gi] && T1A.params->coltot[Gi]) {
-			  t_ia = T1A.matrix[Gi][i][a];
-			  f_ia = fIA.matrix[Gi][i][a];
+			if(T1A->params->rowtot[Gi] && T1A->params->coltot[Gi]) {
+			  t_ia = T1A->matrix[Gi][i][a];
+			  f_ia = fIA->matrix[Gi][i][a];
 			}
 
-			if(DABints.params->rowtot[Gjk] && DABints.params->coltot[Gjk]) {
-			  D_jkbc = DABints.matrix[Gjk][jk][bc];
-			  t_jkbc = T2AB.matrix[Gjk][jk][bc];
+			if(DABints->params->rowtot[Gjk] && DABints->params->coltot[Gjk]) {
+			  D_jkbc = DABints->matrix[Gjk][jk][bc];
+			  t_jkbc = T2AB->matrix[Gjk][jk][bc];
 			}
 
 			VABc[Gab][ab][c] += t_ia * D_jkbc + f_ia * t_jkbc;
@@ -669,14 +779,14 @@ double ET_UHF_AAB(void)
 		      if(Gi == Gb && Gjk == Gac) {
 			t_ib = D_jkac = f_ib = t_jkac = 0.0;
 
-			if(T1A.params->rowtot[Gi] && T1A.params->coltot[Gi]) {
-			  t_ib = T1A.matrix[Gi][i][b];
-			  f_ib = fIA.matrix[Gi][i][b];
+			if(T1A->params->rowtot[Gi] && T1A->params->coltot[Gi]) {
+			  t_ib = T1A->matrix[Gi][i][b];
+			  f_ib = fIA->matrix[Gi][i][b];
 			}
 
-			if(DABints.params->rowtot[Gjk] && DABints.params->coltot[Gjk]) {
-			  D_jkac = DABints.matrix[Gjk][jk][ac];
-			  t_jkac = T2AB.matrix[Gjk][jk][ac];
+			if(DABints->params->rowtot[Gjk] && DABints->params->coltot[Gjk]) {
+			  D_jkac = DABints->matrix[Gjk][jk][ac];
+			  t_jkac = T2AB->matrix[Gjk][jk][ac];
 			}
 
 			VABc[Gab][ab][c] -= t_ib * D_jkac + f_ib * t_jkac;
@@ -686,14 +796,14 @@ double ET_UHF_AAB(void)
 		      if(Gj == Ga && Gik == Gbc) {
 			t_ja = D_ikbc = f_ja = t_ikbc = 0.0;
 
-			if(T1A.params->rowtot[Gj] && T1A.params->coltot[Gj]) {
-			  t_ja = T1A.matrix[Gj][j][a];
-			  f_ja = fIA.matrix[Gj][j][a];
+			if(T1A->params->rowtot[Gj] && T1A->params->coltot[Gj]) {
+			  t_ja = T1A->matrix[Gj][j][a];
+			  f_ja = fIA->matrix[Gj][j][a];
 			}
 
-			if(DABints.params->rowtot[Gik] && DABints.params->coltot[Gik]) {
-			  D_ikbc = DABints.matrix[Gik][ik][bc];
-			  t_ikbc = T2AB.matrix[Gik][ik][bc];
+			if(DABints->params->rowtot[Gik] && DABints->params->coltot[Gik]) {
+			  D_ikbc = DABints->matrix[Gik][ik][bc];
+			  t_ikbc = T2AB->matrix[Gik][ik][bc];
 			}
 
 			VABc[Gab][ab][c] -= t_ja * D_ikbc + f_ja * t_ikbc;
@@ -703,14 +813,14 @@ double ET_UHF_AAB(void)
 		      if(Gj == Gb && Gik == Gac) {
 			t_jb = D_ikac = f_jb = t_ikac = 0.0;
 
-			if(T1A.params->rowtot[Gj] && T1A.params->coltot[Gj]) {
-			  t_jb = T1A.matrix[Gj][j][b];
-			  f_jb = fIA.matrix[Gj][j][b];
+			if(T1A->params->rowtot[Gj] && T1A->params->coltot[Gj]) {
+			  t_jb = T1A->matrix[Gj][j][b];
+			  f_jb = fIA->matrix[Gj][j][b];
 			}
 
-			if(DABints.params->rowtot[Gik] && DABints.params->coltot[Gik]) {
-			  D_ikac = DABints.matrix[Gik][ik][ac];
-			  t_ikac = T2AB.matrix[Gik][ik][ac];
+			if(DABints->params->rowtot[Gik] && DABints->params->coltot[Gik]) {
+			  D_ikac = DABints->matrix[Gik][ik][ac];
+			  t_ikac = T2AB->matrix[Gik][ik][ac];
 			}
 
 			VABc[Gab][ab][c] += t_jb * D_ikac + f_jb * t_ikac;
@@ -720,14 +830,14 @@ double ET_UHF_AAB(void)
 		      if(Gk == Gc && Gji == Gab) {
 			t_kc = D_jiab = f_kc = t_jiab = 0.0;
 
-			if(T1B.params->rowtot[Gk] && T1B.params->coltot[Gk]) {
-			  t_kc = T1B.matrix[Gk][k][c];
-			  f_kc = fia.matrix[Gk][k][c];
+			if(T1B->params->rowtot[Gk] && T1B->params->coltot[Gk]) {
+			  t_kc = T1B->matrix[Gk][k][c];
+			  f_kc = fia->matrix[Gk][k][c];
 			}
 
-			if(DAAints.params->rowtot[Gji] && DAAints.params->coltot[Gji]) {
-			  D_jiab = DAAints.matrix[Gji][ji][ab];
-			  t_jiab = T2AA.matrix[Gji][ji][ab];
+			if(DAAints->params->rowtot[Gji] && DAAints->params->coltot[Gji]) {
+			  D_jiab = DAAints->matrix[Gji][ji][ab];
+			  t_jiab = T2AA->matrix[Gji][ji][ab];
 			}
 
 			VABc[Gab][ab][c] -= t_kc * D_jiab + f_kc * t_jiab;
@@ -738,12 +848,12 @@ double ET_UHF_AAB(void)
 
 		      /* Build the rest of the denominator and divide it into W */
 		      denom = dijk;
-		      if(fAB.params->rowtot[Ga])
-			denom -= fAB.matrix[Ga][a][a];
-		      if(fAB.params->rowtot[Gb])
-			denom -= fAB.matrix[Gb][b][b];
-		      if(fab.params->rowtot[Gc])
-			denom -= fab.matrix[Gc][c][c];
+		      if(fAB->params->rowtot[Ga])
+			denom -= fAB->matrix[Ga][a][a];
+		      if(fAB->params->rowtot[Gb])
+			denom -= fAB->matrix[Gb][b][b];
+		      if(fab->params->rowtot[Gc])
+			denom -= fab->matrix[Gc][c][c];
 
 		      WABc[Gab][ab][c] /= denom;
 
@@ -754,77 +864,9 @@ double ET_UHF_AAB(void)
 		/* 1/2 Dot product of final V and W is the energy for this ijk triple */
 		for(Gab=0; Gab < nirreps; Gab++) {
 		  Gc = Gab ^ Gijk;
-		  ET_AAB += dot_block(WABc[Gab], VABc[Gab], FAAints.params->coltot[Gab], bvirtpi[Gc], 0.5);
-		}
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-		  global_dpd_->free_dpd_block(WABc[Gab], FAAints.params->coltot[Gab], bvirtpi[Gc]);
-		  global_dpd_->free_dpd_block(VABc[Gab], FAAints.params->coltot[Gab], bvirtpi[Gc]);
+		    ET_AAB += dot_block(WABc[Gab], VABc[Gab], FAAints->params->coltot[Gab], bvirtpi[Gc], 0.5);
 		}
 
-	      } /* I >= J */
-
-	    } /* k */
-	  } /* j */
-	} /* i */
-
-      } /* Gk */
-    } /* Gj */
-  } /* Gi */
-
-  /*  outfile->Printf( "cnt = %d\n", cnt); */
-  /*  outfile->Printf( "ET_AAB = %20.14f\n", ET_AAB); */
-
-  free(WABc);
-  free(WBcA);
-  free(WAcB);
-  free(WcAB);
-  free(WcBA);
-  free(VABc);
-
-
-  for(h=0; h < nirreps; h++) {
-    global_dpd_->buf4_mat_irrep_close(&T2AA, h);
-    global_dpd_->buf4_mat_irrep_close(&T2AB, h);
-    global_dpd_->buf4_mat_irrep_close(&T2BA, h);
-    global_dpd_->buf4_mat_irrep_close(&EAAints, h);
-    global_dpd_->buf4_mat_irrep_close(&EABints, h);
-    global_dpd_->buf4_mat_irrep_close(&EBAints, h);
-    global_dpd_->buf4_mat_irrep_close(&DAAints, h);
-    global_dpd_->buf4_mat_irrep_close(&DABints, h);
-  }
-
-  global_dpd_->buf4_close(&T2AA);
-  global_dpd_->buf4_close(&T2AB);
-  global_dpd_->buf4_close(&T2BA);
-  global_dpd_->buf4_close(&FAAints);
-  global_dpd_->buf4_close(&FABints);
-  global_dpd_->buf4_close(&FBAints);
-  global_dpd_->buf4_close(&EAAints);
-  global_dpd_->buf4_close(&EABints);
-  global_dpd_->buf4_close(&EBAints);
-  global_dpd_->buf4_close(&DAAints);
-  global_dpd_->buf4_close(&DABints);
-
-  global_dpd_->file2_mat_close(&T1A);
-  global_dpd_->file2_close(&T1A);
-  global_dpd_->file2_mat_close(&T1B);
-  global_dpd_->file2_close(&T1B);
-
-  global_dpd_->file2_mat_close(&fIJ);
-  global_dpd_->file2_mat_close(&fij);
-  global_dpd_->file2_mat_close(&fAB);
-  global_dpd_->file2_mat_close(&fab);
-  global_dpd_->file2_mat_close(&fIA);
-  global_dpd_->file2_mat_close(&fia);
-  global_dpd_->file2_close(&fIJ);
-  global_dpd_->file2_close(&fij);
-  global_dpd_->file2_close(&fAB);
-  global_dpd_->file2_close(&fab);
-  global_dpd_->file2_close(&fIA);
-  global_dpd_->file2_close(&fia);
-
   return ET_AAB;
 }
 
@@ -27,57 +27,72 @@
  #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 #include <libdpd/dpd.h>
 #include <libqt/qt.h>
 #include "MOInfo.h"
 #include "Params.h"
+#include "ijk_schedule.h"
 #define EXTERN
 #include "globals.h"
 #include "libparallel/ParallelPrinter.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi { namespace cctriples {
 
+/* Quantities shared read-only by all ijk threads */
+struct ET_UHF_ABB_data {
+ dpdfile2 *T1A; dpdfile2 *T1B; dpdfile2 *fIJ; dpdfile2 *fij;
+ dpdfile2 *fAB; dpdfile2 *fab; dpdfile2 *fIA; dpdfile2 *fia;
+ dpdbuf4 *T2AB; dpdbuf4 *T2BB; dpdbuf4 *T2BA; dpdbuf4 *FBBints;
+ dpdbuf4 *FABints; dpdbuf4 *FBAints; dpdbuf4 *EBBints; dpdbuf4 *EABints;
+ dpdbuf4 *EBAints; dpdbuf4 *DBBints; dpdbuf4 *DABints;
+};
+
+/* Per-thread scratch, allocated once and reused for every triplet.
+** W[0..5] hold WAbc, VAbc, WAcb, WbAc, WcAb, WbcA. */
+struct ET_UHF_ABB_scratch {
+ IJKBlock W[6];
+ IJKRows FBB, FAB, FBA; /* private buffers for the F rows of a triplet */
+ long int nijk;     /* triplets done by this thread */
+ double cost;       /* and their summed cost */
+};
+
+double ET_UHF_ABB_ijk(IJKTask *task, struct ET_UHF_ABB_data *data, struct ET_UHF_ABB_scratch *scratch);
+
+/* ET_UHF_ABB(): Computes the ABB spin component of the UHF-CCSD(T)
+** energy.  The occupied triplets I (alpha) and J > K (beta) are computed
+** concurrently from a list sorted by cost and handed out one at a time,
+** as in ET_RHF().  T2, E, and D are held in core and shared by all
+** threads; each thread owns its abc intermediates and reads the F
+** integral rows of its triplet into a private buffer.
+*/
 double ET_UHF_ABB(void)
 {
-  int cnt;
-  int h, nirreps;
-  int Gi, Gj, Gk, Ga, Gb, Gc, Gd, Gl;
-  int Gji, Gij, Gjk, Gkj, Gik, Gki, Gijk;
-  int Gab, Gbc, Gac, Gca, Gba;
-  int Gid, Gjd, Gkd;
-  int Gil, Gjl, Gkl;
-  int I, J, K, A, B, C;
-  int i, j, k, a, b, c;
-  int ij, ji, ik, ki, jk, kj;
-  int ab, ba, ac, ca, bc, cb;
-  int cd, bd, ad, db, dc;
-  int lc, lb, la;
-  int id, jd, kd;
-  int il, jl, kl;
-  int *aoccpi, *avirtpi, *aocc_off, *avir_off;
-  int *boccpi, *bvirtpi, *bocc_off, *bvir_off;
-  double value_c, value_d, dijk, denom, ET_ABB;
-  int nrows, ncols, nlinks;
-  double t_ia, t_jb, t_jc, t_kb, t_kc;
-  double f_ia, f_jb, f_jc, f_kb, f_kc;
-  double D_jkbc, D_ikac, D_ikab, D_ijac, D_ijab;
-  double t_jkbc, t_ikac, t_ikab, t_ijac, t_ijab;
+  int h, nirreps, m, thread;
+  int nthreads, nthreads_ijk, nthreads_blas, old_threads, old_nested;
+  int *aoccpi, *avirtpi, *aocc_off;
+  int *boccpi, *bvirtpi, *bocc_off;
+  long int n, nijk, mem_avail, mem_per_thread;
+  double ET_ABB;
   dpdbuf4 T2AB, T2BB, T2BA;
   dpdbuf4 FBBints, FABints, FBAints;
   dpdbuf4 EBBints, EABints, EBAints;
   dpdbuf4 DBBints, DABints;
   dpdfile2 T1A, T1B, fIJ, fij, fAB, fab, fIA, fia;
-  double ***WAbc, ***VAbc, ***WAcb, ***WbAc, ***WcAb, ***WbcA;
-  int nijk, mijk;
+  std::vector<IJKTask> tasks;
+  struct ET_UHF_ABB_data data;
+  struct ET_UHF_ABB_scratch *scratch;
 
   nirreps = moinfo.nirreps;
   aoccpi = moinfo.aoccpi; 
   avirtpi = moinfo.avirtpi;
   aocc_off = moinfo.aocc_off;
-  avir_off = moinfo.avir_off;
   boccpi = moinfo.boccpi; 
   bvirtpi = moinfo.bvirtpi;
   bocc_off = moinfo.bocc_off;
-  bvir_off = moinfo.bvir_off;
 
   global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
   global_dpd_->file2_init(&fij, PSIF_CC_OEI, 0, 2, 2, "fij");
@@ -146,108 +161,267 @@ double ET_UHF_ABB(void)
     global_dpd_->buf4_mat_irrep_rd(&DABints, h);
   }
 
-  /* Compute the number of IJK combinations in this spin case */
-  nijk = 0;
-  for(Gi=0; Gi < nirreps; Gi++)
-    for(Gj=0; Gj < nirreps; Gj++)
-      for(Gk=0; Gk < nirreps; Gk++)
-	for(i=0; i < aoccpi[Gi]; i++) {
-	  I = aocc_off[Gi] + i;
-	  for(j=0; j < boccpi[Gj]; j++) {
-	    J = bocc_off[Gj] + j;
-	    for(k=0; k < boccpi[Gk]; k++) {
-	      K = bocc_off[Gk] + k;
-
-	      if(J > K) nijk++;
-	    }
-	  }
-	}
+  /* List the IJK combinations in this spin case, most expensive first */
+  ijk_tasks(tasks, nirreps, -1, -1, -1, aoccpi, aocc_off, boccpi, bocc_off, boccpi, bocc_off,
+	    avirtpi, bvirtpi, bvirtpi, IJK_ANY, IJK_GT);
+  nijk = tasks.size();
+
+  /* Each ijk thread holds its own intermediates and F buffers */
+  mem_avail = dpd_memfree();
+  mem_per_thread = 3 * ijk_block_words(nirreps, FABints.params->coltot, bvirtpi)
+    + 2 * ijk_block_words(nirreps, FBAints.params->coltot, bvirtpi)
+    + ijk_block_words(nirreps, FBBints.params->coltot, avirtpi)
+    + ijk_rows_words(&FBBints, bvirtpi)
+    + ijk_rows_words(&FABints, bvirtpi)
+    + ijk_rows_words(&FBAints, avirtpi);
+
+  nthreads = params.nthreads;
+  ijk_threads(nijk, nthreads, mem_avail, 0, mem_per_thread,
+	      &nthreads_ijk, &nthreads_blas);
+#ifndef _OPENMP
+  nthreads_ijk = 1;
+  nthreads_blas = nthreads;
+#endif
+
   boost::shared_ptr<OutFile> printer(new OutFile("ijk.dat",TRUNCATE));
-  //ffile(&ijkfile,"ijk.dat",0);
   printer->Printf("Spin Case: ABB\n");
-  printer->Printf("Number of IJK combintions: %d\n", nijk);
-  printer->Printf("\nCurrent IJK Combination:\n");
+  printer->Printf("Number of IJK combintions: %ld\n", nijk);
+  printer->Printf("Threads for ijk triplets: %d, per BLAS call: %d\n", nthreads_ijk, nthreads_blas);
+
+  data.T1A = &T1A; data.T1B = &T1B; data.fIJ = &fIJ; data.fij = &fij;
+  data.fAB = &fAB; data.fab = &fab; data.fIA = &fIA; data.fia = &fia;
+  data.T2AB = &T2AB; data.T2BB = &T2BB; data.T2BA = &T2BA;
+  data.FBBints = &FBBints; data.FABints = &FABints; data.FBAints = &FBAints;
+  data.EBBints = &EBBints; data.EABints = &EABints; data.EBAints = &EBAints;
+  data.DBBints = &DBBints; data.DABints = &DABints;
+
+  scratch = new ET_UHF_ABB_scratch[nthreads_ijk];
+  for(thread=0; thread < nthreads_ijk; thread++) {
+    scratch[thread].nijk = 0;
+    scratch[thread].cost = 0.0;
+    for(m=0; m < 3; m++)
+      ijk_block_init(&(scratch[thread].W[m]), nirreps, FABints.params->coltot, bvirtpi);
+    for(m=3; m < 5; m++)
+      ijk_block_init(&(scratch[thread].W[m]), nirreps, FBAints.params->coltot, bvirtpi);
+    ijk_block_init(&(scratch[thread].W[5]), nirreps, FBBints.params->coltot, avirtpi);
+    ijk_rows_init(&(scratch[thread].FBB), &FBBints, bvirtpi);
+    ijk_rows_init(&(scratch[thread].FAB), &FABints, bvirtpi);
+    ijk_rows_init(&(scratch[thread].FBA), &FBAints, avirtpi);
+  }
 
+  old_threads = ijk_blas_threads(nthreads_blas, nthreads_ijk > 1);
+#ifdef _OPENMP
+  old_nested = omp_get_nested();
+  if(nthreads_ijk > 1 && nthreads_blas > 1) omp_set_nested(1);
+#endif
 
-  mijk = 0;
   ET_ABB = 0.0;
+#pragma omp parallel private(thread) num_threads(nthreads_ijk)
+  {
+    thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+
+#pragma omp for schedule(dynamic,1) reduction(+:ET_ABB)
+    for(n=0; n < nijk; n++) {
+      ET_ABB += ET_UHF_ABB_ijk(&(tasks[n]), &data, &(scratch[thread]));
+      scratch[thread].nijk++;
+      scratch[thread].cost += tasks[n].cost;
+    }
+  }
 
-  WAbc = (double ***) malloc(nirreps * sizeof(double **));
-  VAbc = (double ***) malloc(nirreps * sizeof(double **));
-  WAcb = (double ***) malloc(nirreps * sizeof(double **));
-  WbcA = (double ***) malloc(nirreps * sizeof(double **));
-  WcAb = (double ***) malloc(nirreps * sizeof(double **));
-  WbAc = (double ***) malloc(nirreps * sizeof(double **));
+#ifdef _OPENMP
+  omp_set_nested(old_nested);
+#endif
+  ijk_blas_threads(old_threads, 0);
+
+  for(thread=0; thread < nthreads_ijk; thread++)
+    printer->Printf("\tthread %d: %ld triplets, cost %.0f\n", thread,
+      scratch[thread].nijk, scratch[thread].cost);
+
+  for(thread=0; thread < nthreads_ijk; thread++) {
+    for(m=0; m < 6; m++)
+      ijk_block_close(&(scratch[thread].W[m]));
+    ijk_rows_close(&(scratch[thread].FBB));
+    ijk_rows_close(&(scratch[thread].FAB));
+    ijk_rows_close(&(scratch[thread].FBA));
+  }
+  delete [] scratch;
 
-  for(Gi=0; Gi < nirreps; Gi++) {
-    for(Gj=0; Gj < nirreps; Gj++) {
-      for(Gk=0; Gk < nirreps; Gk++) {
+  for(h=0; h < nirreps; h++) {
+    global_dpd_->buf4_mat_irrep_close(&T2BB, h);
+    global_dpd_->buf4_mat_irrep_close(&T2AB, h);
+    global_dpd_->buf4_mat_irrep_close(&T2BA, h);
+    global_dpd_->buf4_mat_irrep_close(&EBBints, h);
+    global_dpd_->buf4_mat_irrep_close(&EABints, h);
+    global_dpd_->buf4_mat_irrep_close(&EBAints, h);
+    global_dpd_->buf4_mat_irrep_close(&DBBints, h);
+    global_dpd_->buf4_mat_irrep_close(&DABints, h);
+  }
 
-	Gij = Gji = Gi ^ Gj;
-	Gjk = Gkj = Gj ^ Gk;
-	Gik = Gki = Gi ^ Gk;
+  global_dpd_->buf4_close(&T2BB);
+  global_dpd_->buf4_close(&T2AB);
+  global_dpd_->buf4_close(&T2BA);
+  global_dpd_->buf4_close(&FBBints);
+  global_dpd_->buf4_close(&FABints);
+  global_dpd_->buf4_close(&FBAints);
+  global_dpd_->buf4_close(&EBBints);
+  global_dpd_->buf4_close(&EABints);
+  global_dpd_->buf4_close(&EBAints);
+  global_dpd_->buf4_close(&DBBints);
+  global_dpd_->buf4_close(&DABints);
+
+  global_dpd_->file2_mat_close(&T1A);
+  global_dpd_->file2_close(&T1A);
+  global_dpd_->file2_mat_close(&T1B);
+  global_dpd_->file2_close(&T1B);
+
+  global_dpd_->file2_mat_close(&fIJ);
+  global_dpd_->file2_mat_close(&fij);
+  global_dpd_->file2_mat_close(&fAB);
+  global_dpd_->file2_mat_close(&fab);
+  global_dpd_->file2_mat_close(&fIA);
+  global_dpd_->file2_mat_close(&fia);
+  global_dpd_->file2_close(&fIJ);
+  global_dpd_->file2_close(&fij);
+  global_dpd_->file2_close(&fAB);
+  global_dpd_->file2_close(&fab);
+  global_dpd_->file2_close(&fIA);
+  global_dpd_->file2_close(&fia);
 
-	Gijk = Gi ^ Gj ^ Gk;
+  return ET_ABB;
+}
 
-	for(i=0; i < aoccpi[Gi]; i++) {
-	  I = aocc_off[Gi] + i;
-	  for(j=0; j < boccpi[Gj]; j++) {
-	    J = bocc_off[Gj] + j;
-	    for(k=0; k < boccpi[Gk]; k++) {
-	      K = bocc_off[Gk] + k;
+/* ET_UHF_ABB_ijk(): Returns the (T) energy contribution of one ABB
+** occupied triplet, using the thread's scratch intermediates.
+*/
+double ET_UHF_ABB_ijk(IJKTask *task, struct ET_UHF_ABB_data *data, struct ET_UHF_ABB_scratch *scratch)
+{
+  int m;
+  int nirreps;
+  int Gi, Gj, Gk, Ga, Gb, Gc, Gd, Gl;
+  int Gji, Gij, Gjk, Gkj, Gik, Gki, Gijk;
+  int Gab, Gbc, Gac, Gca, Gba;
+  int Gid, Gjd, Gkd;
+  int Gil, Gjl, Gkl;
+  int I, J, K, A, B, C;
+  int i, j, k, a, b, c;
+  int ij, ji, ik, ki, jk, kj;
+  int ab, ba, ac, ca, bc, cb;
+  int cd, bd, ad, db, dc;
+  int lc, lb, la;
+  int id, jd, kd;
+  int il, jl, kl;
+  int *aoccpi, *avirtpi, *aocc_off, *avir_off;
+  int *boccpi, *bvirtpi, *bocc_off, *bvir_off;
+  double value_c, value_d, dijk, denom, ET_ABB;
+  int nrows, ncols, nlinks;
+  double t_ia, t_jb, t_jc, t_kb, t_kc;
+  double f_ia, f_jb, f_jc, f_kb, f_kc;
+  double D_jkbc, D_ikac, D_ikab, D_ijac, D_ijab;
+  double t_jkbc, t_ikac, t_ikab, t_ijac, t_ijab;
+  dpdbuf4 *T2AB, *T2BB, *T2BA;
+  dpdbuf4 *FBBints, *FABints, *FBAints;
+  dpdbuf4 *EBBints, *EABints, *EBAints;
+  dpdbuf4 *DBBints, *DABints;
+  dpdfile2 *T1A, *T1B, *fIJ, *fij, *fAB, *fab, *fIA, *fia;
+  double ***WAbc, ***VAbc, ***WAcb, ***WbAc, ***WcAb, ***WbcA;
+  double **F;
 
-	      if(J > K) {
+  nirreps = moinfo.nirreps;
+  aoccpi = moinfo.aoccpi;
+  avirtpi = moinfo.avirtpi;
+  aocc_off = moinfo.aocc_off;
+  avir_off = moinfo.avir_off;
+  boccpi = moinfo.boccpi;
+  bvirtpi = moinfo.bvirtpi;
+  bocc_off = moinfo.bocc_off;
+  bvir_off = moinfo.bvir_off;
 
-		mijk++;
-		printer->Printf("%d\n", mijk);
+  T1A = data->T1A;
+  T1B = data->T1B;
+  fIJ = data->fIJ;
+  fij = data->fij;
+  fAB = data->fAB;
+  fab = data->fab;
+  fIA = data->fIA;
+  fia = data->fia;
+  T2AB = data->T2AB;
+  T2BB = data->T2BB;
+  T2BA = data->T2BA;
+  FBBints = data->FBBints;
+  FABints = data->FABints;
+  FBAints = data->FBAints;
+  EBBints = data->EBBints;
+  EABints = data->EABints;
+  EBAints = data->EBAints;
+  DBBints = data->DBBints;
+  DABints = data->DABints;
+
+  WAbc = scratch->W[0].W;
+  VAbc = scratch->W[1].W;
+  WAcb = scratch->W[2].W;
+  WbAc = scratch->W[3].W;
+  WcAb = scratch->W[4].W;
+  WbcA = scratch->W[5].W;
+
+		Gi = task->Gi; Gj = task->Gj; Gk = task->Gk;
+		i = task->i; j = task->j; k = task->k;
+		I = aocc_off[Gi] + i;
+		J = bocc_off[Gj] + j;
+		K = bocc_off[Gk] + k;
+
+		Gij = Gji = Gi ^ Gj;
+		Gjk = Gkj = Gj ^ Gk;
+		Gik = Gki = Gi ^ Gk;
+
+		Gijk = Gi ^ Gj ^ Gk;
+
+		for(m=0; m < 6; m++) {
+		  ijk_block_irrep(&(scratch->W[m]), Gijk);
+		  ijk_block_zero(&(scratch->W[m]));
+		}
 
+		ET_ABB = 0.0;
 
-		ij = EABints.params->rowidx[I][J];
-		ji = EBAints.params->rowidx[J][I];
-		jk = EBBints.params->rowidx[J][K];
-		kj = EBBints.params->rowidx[K][J];
-		ik = EABints.params->rowidx[I][K];
-		ki = EBAints.params->rowidx[K][I];
+		ij = EABints->params->rowidx[I][J];
+		ji = EBAints->params->rowidx[J][I];
+		jk = EBBints->params->rowidx[J][K];
+		kj = EBBints->params->rowidx[K][J];
+		ik = EABints->params->rowidx[I][K];
+		ki = EBAints->params->rowidx[K][I];
 
 		dijk = 0.0;
-		if(fIJ.params->rowtot[Gi])
-		  dijk += fIJ.matrix[Gi][i][i];
-		if(fij.params->rowtot[Gj])
-		  dijk += fij.matrix[Gj][j][j];
-		if(fij.params->rowtot[Gk])
-		  dijk += fij.matrix[Gk][k][k];
+		if(fIJ->params->rowtot[Gi])
+		  dijk += fIJ->matrix[Gi][i][i];
+		if(fij->params->rowtot[Gj])
+		  dijk += fij->matrix[Gj][j][j];
+		if(fij->params->rowtot[Gk])
+		  dijk += fij->matrix[Gk][k][k];
 
 		/* Begin connected triples */
 
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  WAbc[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], bvirtpi[Gc]);
-		}
-
 		for(Gd=0; Gd < nirreps; Gd++) {
 		  /* -t_jkcd * F_IdAb */
 		  Gab = Gid = Gi ^ Gd;
 		  Gc = Gjk ^ Gd;
 
-		  cd = T2BB.col_offset[Gjk][Gc];
-		  id = FABints.row_offset[Gid][I];
+		  cd = T2BB->col_offset[Gjk][Gc];
+		  id = FABints->row_offset[Gid][I];
 
-		  FABints.matrix[Gid] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FABints.params->coltot[Gid]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FABints, Gid, id, bvirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FAB), Gid, id, bvirtpi[Gd]);
 
-		  nrows = FABints.params->coltot[Gid];
+		  nrows = FABints->params->coltot[Gid];
 		  ncols = bvirtpi[Gc];
 		  nlinks = bvirtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0,
-			    &(FABints.matrix[Gid][0][0]), nrows,
-			    &(T2BB.matrix[Gjk][jk][cd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2BB->matrix[Gjk][jk][cd]), nlinks, 1.0,
 			    &(WAbc[Gab][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FABints.matrix[Gid], bvirtpi[Gd], FABints.params->coltot[Gid]);
-
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -255,49 +429,40 @@ double ET_UHF_ABB(void)
 		  Gab = Gil = Gi ^ Gl;
 		  Gc = Gjk ^ Gl;
 
-		  lc = EBBints.col_offset[Gjk][Gl];
-		  il = T2AB.row_offset[Gil][I];
+		  lc = EBBints->col_offset[Gjk][Gl];
+		  il = T2AB->row_offset[Gil][I];
 
-		  nrows = T2AB.params->coltot[Gil];
+		  nrows = T2AB->params->coltot[Gil];
 		  ncols = bvirtpi[Gc];
 		  nlinks = boccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2AB.matrix[Gil][il][0]), nrows,
-			    &(EBBints.matrix[Gjk][jk][lc]), ncols, 1.0,
+			    &(T2AB->matrix[Gil][il][0]), nrows,
+			    &(EBBints->matrix[Gjk][jk][lc]), ncols, 1.0,
 			    &(WAbc[Gab][0][0]), ncols);
 		}
 
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  WAcb[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], bvirtpi[Gc]);
-		}
-
 		for(Gd=0; Gd < nirreps; Gd++) {
 		  /* +t_jkbd * F_IdAc */
 		  Gac = Gid = Gi ^ Gd;
 		  Gb = Gjk ^ Gd;
 
-		  bd = T2BB.col_offset[Gjk][Gb];
-		  id = FABints.row_offset[Gid][I];
+		  bd = T2BB->col_offset[Gjk][Gb];
+		  id = FABints->row_offset[Gid][I];
 
-		  FABints.matrix[Gid] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FABints.params->coltot[Gid]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FABints, Gid, id, bvirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FAB), Gid, id, bvirtpi[Gd]);
 
-		  nrows = FABints.params->coltot[Gid];
+		  nrows = FABints->params->coltot[Gid];
 		  ncols = bvirtpi[Gb];
 		  nlinks = bvirtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-			    &(FABints.matrix[Gid][0][0]), nrows,
-			    &(T2BB.matrix[Gjk][jk][bd]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2BB->matrix[Gjk][jk][bd]), nlinks, 1.0,
 			    &(WAcb[Gac][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FABints.matrix[Gid], bvirtpi[Gd], FABints.params->coltot[Gid]);
-
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -305,77 +470,63 @@ double ET_UHF_ABB(void)
 		  Gac = Gil = Gi ^ Gl;
 		  Gb = Gjk ^ Gl;
 
-		  lb = EBBints.col_offset[Gjk][Gl];
-		  il = T2AB.row_offset[Gil][I];
+		  lb = EBBints->col_offset[Gjk][Gl];
+		  il = T2AB->row_offset[Gil][I];
 
-		  nrows = T2AB.params->coltot[Gil];
+		  nrows = T2AB->params->coltot[Gil];
 		  ncols = bvirtpi[Gb];
 		  nlinks = boccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2AB.matrix[Gil][il][0]), nrows,
-			    &(EBBints.matrix[Gjk][jk][lb]), ncols, 1.0,
+			    &(T2AB->matrix[Gil][il][0]), nrows,
+			    &(EBBints->matrix[Gjk][jk][lb]), ncols, 1.0,
 			    &(WAcb[Gac][0][0]), ncols);
 		}
 
-        global_dpd_->sort_3d(WAcb, WAbc, nirreps, Gijk, FABints.params->coltot, FABints.params->colidx,
-		       FABints.params->colorb, FABints.params->rsym, FABints.params->ssym,
-		       avir_off, bvir_off, bvirtpi, bvir_off, FABints.params->colidx, acb, 1);
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  global_dpd_->free_dpd_block(WAcb[Gab], FABints.params->coltot[Gab], bvirtpi[Gc]);
-
-		  WbcA[Gab] = global_dpd_->dpd_block_matrix(FBBints.params->coltot[Gab], avirtpi[Gc]);
-		}
+		global_dpd_->sort_3d(WAcb, WAbc, nirreps, Gijk, FABints->params->coltot, FABints->params->colidx,
+		       FABints->params->colorb, FABints->params->rsym, FABints->params->ssym,
+		       avir_off, bvir_off, bvirtpi, bvir_off, FABints->params->colidx, acb, 1);
 
 		for(Gd=0; Gd < nirreps; Gd++) {
 		  /* +t_IkAd * F_jdbc */
 		  Gbc = Gjd = Gj ^ Gd;
 		  Ga = Gik ^ Gd;
 
-		  ad = T2AB.col_offset[Gik][Ga];
-		  jd = FBBints.row_offset[Gjd][J];
+		  ad = T2AB->col_offset[Gik][Ga];
+		  jd = FBBints->row_offset[Gjd][J];
 
-		  FBBints.matrix[Gjd] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FBBints.params->coltot[Gjd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FBBints, Gjd, jd, bvirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FBB), Gjd, jd, bvirtpi[Gd]);
 
-		  nrows = FBBints.params->coltot[Gjd];
+		  nrows = FBBints->params->coltot[Gjd];
 		  ncols = avirtpi[Ga];
 		  nlinks = bvirtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-			    &(FBBints.matrix[Gjd][0][0]), nrows,
-			    &(T2AB.matrix[Gik][ik][ad]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gik][ik][ad]), nlinks, 1.0,
 			    &(WbcA[Gbc][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FBBints.matrix[Gjd], bvirtpi[Gd], FBBints.params->coltot[Gjd]);
-
 		  /* -t_IjAd * F_kdbc */
 		  Gbc = Gkd = Gk ^ Gd;
 		  Ga = Gij ^ Gd;
 
-		  ad = T2AB.col_offset[Gij][Ga];
-		  kd = FBBints.row_offset[Gkd][K];
+		  ad = T2AB->col_offset[Gij][Ga];
+		  kd = FBBints->row_offset[Gkd][K];
 
-		  FBBints.matrix[Gkd] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FBBints.params->coltot[Gkd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FBBints, Gkd, kd, bvirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FBB), Gkd, kd, bvirtpi[Gd]);
 
-		  nrows = FBBints.params->coltot[Gkd];
+		  nrows = FBBints->params->coltot[Gkd];
 		  ncols = avirtpi[Ga];
 		  nlinks = bvirtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0,
-			    &(FBBints.matrix[Gkd][0][0]), nrows,
-			    &(T2AB.matrix[Gij][ij][ad]), nlinks, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gij][ij][ad]), nlinks, 1.0,
 			    &(WbcA[Gbc][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FBBints.matrix[Gkd], bvirtpi[Gd], FBBints.params->coltot[Gkd]);
-
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -383,94 +534,80 @@ double ET_UHF_ABB(void)
 		  Gbc = Gjl = Gj ^ Gl;
 		  Ga = Gki ^ Gl;
 
-		  la = EBAints.col_offset[Gki][Gl];
-		  jl = T2BB.row_offset[Gjl][J];
+		  la = EBAints->col_offset[Gki][Gl];
+		  jl = T2BB->row_offset[Gjl][J];
 
-		  nrows = T2BB.params->coltot[Gjl];
+		  nrows = T2BB->params->coltot[Gjl];
 		  ncols = avirtpi[Ga];
 		  nlinks = boccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2BB.matrix[Gjl][jl][0]), nrows,
-			    &(EBAints.matrix[Gki][ki][la]), ncols, 1.0,
+			    &(T2BB->matrix[Gjl][jl][0]), nrows,
+			    &(EBAints->matrix[Gki][ki][la]), ncols, 1.0,
 			    &(WbcA[Gbc][0][0]), ncols);
 
 		  /* +t_klbc E_jIlA */
 		  Gbc = Gkl = Gk ^ Gl;
 		  Ga = Gji ^ Gl;
 
-		  la = EBAints.col_offset[Gji][Gl];
-		  kl = T2BB.row_offset[Gkl][K];
+		  la = EBAints->col_offset[Gji][Gl];
+		  kl = T2BB->row_offset[Gkl][K];
 
-		  nrows = T2BB.params->coltot[Gkl];
+		  nrows = T2BB->params->coltot[Gkl];
 		  ncols = avirtpi[Ga];
 		  nlinks = boccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2BB.matrix[Gkl][kl][0]), nrows,
-			    &(EBAints.matrix[Gji][ji][la]), ncols, 1.0,
+			    &(T2BB->matrix[Gkl][kl][0]), nrows,
+			    &(EBAints->matrix[Gji][ji][la]), ncols, 1.0,
 			    &(WbcA[Gbc][0][0]), ncols);
 		}
 
-        global_dpd_->sort_3d(WbcA, WAbc, nirreps, Gijk, FBBints.params->coltot, FBBints.params->colidx,
-		       FBBints.params->colorb, FBBints.params->rsym, FBBints.params->ssym,
-		       bvir_off, bvir_off, avirtpi, avir_off, FABints.params->colidx, cab, 1);
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  global_dpd_->free_dpd_block(WbcA[Gab], FBBints.params->coltot[Gab], avirtpi[Gc]);
-
-		  WcAb[Gab] = global_dpd_->dpd_block_matrix(FBAints.params->coltot[Gab], bvirtpi[Gc]);
-		}
+		global_dpd_->sort_3d(WbcA, WAbc, nirreps, Gijk, FBBints->params->coltot, FBBints->params->colidx,
+		       FBBints->params->colorb, FBBints->params->rsym, FBBints->params->ssym,
+		       bvir_off, bvir_off, avirtpi, avir_off, FABints->params->colidx, cab, 1);
 
 		for(Gd=0; Gd < nirreps; Gd++) {
 		  /* -t_IkDb * F_jDcA */
 		  Gca = Gjd = Gj ^ Gd;
 		  Gb = Gik ^ Gd;
 
-		  db = T2AB.col_offset[Gik][Gd];
-		  jd = FBAints.row_offset[Gjd][J];
+		  db = T2AB->col_offset[Gik][Gd];
+		  jd = FBAints->row_offset[Gjd][J];
 
-		  FBAints.matrix[Gjd] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gjd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gjd, jd, avirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FBA), Gjd, jd, avirtpi[Gd]);
 
-		  nrows = FBAints.params->coltot[Gjd];
+		  nrows = FBAints->params->coltot[Gjd];
 		  ncols = bvirtpi[Gb];
 		  nlinks = avirtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(FBAints.matrix[Gjd][0][0]), nrows,
-			    &(T2AB.matrix[Gik][ik][db]), ncols, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gik][ik][db]), ncols, 1.0,
 			    &(WcAb[Gca][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FBAints.matrix[Gjd], avirtpi[Gd], FBAints.params->coltot[Gjd]);
-
 		  /* +t_IjDb * F_kDcA */
 		  Gca = Gkd = Gk ^ Gd;
 		  Gb = Gij ^ Gd;
 
-		  db = T2AB.col_offset[Gij][Gd];
-		  kd = FBAints.row_offset[Gkd][K];
+		  db = T2AB->col_offset[Gij][Gd];
+		  kd = FBAints->row_offset[Gkd][K];
 
-		  FBAints.matrix[Gkd] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gkd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gkd, kd, avirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FBA), Gkd, kd, avirtpi[Gd]);
 
-		  nrows = FBAints.params->coltot[Gkd];
+		  nrows = FBAints->params->coltot[Gkd];
 		  ncols = bvirtpi[Gb];
 		  nlinks = avirtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(FBAints.matrix[Gkd][0][0]), nrows,
-			    &(T2AB.matrix[Gij][ij][db]), ncols, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gij][ij][db]), ncols, 1.0,
 			    &(WcAb[Gca][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FBAints.matrix[Gkd], avirtpi[Gd], FBAints.params->coltot[Gkd]);
-
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -478,94 +615,80 @@ double ET_UHF_ABB(void)
 		  Gca = Gjl = Gj ^ Gl;
 		  Gb = Gik ^ Gl;
 
-		  lb = EABints.col_offset[Gik][Gl];
-		  jl = T2BA.row_offset[Gjl][J];
+		  lb = EABints->col_offset[Gik][Gl];
+		  jl = T2BA->row_offset[Gjl][J];
 
-		  nrows = T2BA.params->coltot[Gjl];
+		  nrows = T2BA->params->coltot[Gjl];
 		  ncols = bvirtpi[Gb];
 		  nlinks = aoccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2BA.matrix[Gjl][jl][0]), nrows,
-			    &(EABints.matrix[Gik][ik][lb]), ncols, 1.0,
+			    &(T2BA->matrix[Gjl][jl][0]), nrows,
+			    &(EABints->matrix[Gik][ik][lb]), ncols, 1.0,
 			    &(WcAb[Gca][0][0]), ncols);
 
 		  /* -t_kLcA E_IjLb */
 		  Gca = Gkl = Gk ^ Gl;
 		  Gb = Gij ^ Gl;
 
-		  lb = EABints.col_offset[Gij][Gl];
-		  kl = T2BA.row_offset[Gkl][K];
+		  lb = EABints->col_offset[Gij][Gl];
+		  kl = T2BA->row_offset[Gkl][K];
 
-		  nrows = T2BA.params->coltot[Gkl];
+		  nrows = T2BA->params->coltot[Gkl];
 		  ncols = bvirtpi[Gb];
 		  nlinks = aoccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2BA.matrix[Gkl][kl][0]), nrows,
-			    &(EABints.matrix[Gij][ij][lb]), ncols, 1.0,
+			    &(T2BA->matrix[Gkl][kl][0]), nrows,
+			    &(EABints->matrix[Gij][ij][lb]), ncols, 1.0,
 			    &(WcAb[Gca][0][0]), ncols);
 		}
 
-        global_dpd_->sort_3d(WcAb, WAbc, nirreps, Gijk, FBAints.params->coltot, FBAints.params->colidx,
-		       FBAints.params->colorb, FBAints.params->rsym, FBAints.params->ssym,
-		       bvir_off, avir_off, bvirtpi, bvir_off, FABints.params->colidx, bca, 1);
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  global_dpd_->free_dpd_block(WcAb[Gab], FBAints.params->coltot[Gab], bvirtpi[Gc]);
-
-		  WbAc[Gab] = global_dpd_->dpd_block_matrix(FBAints.params->coltot[Gab], bvirtpi[Gc]);
-		}
+		global_dpd_->sort_3d(WcAb, WAbc, nirreps, Gijk, FBAints->params->coltot, FBAints->params->colidx,
+		       FBAints->params->colorb, FBAints->params->rsym, FBAints->params->ssym,
+		       bvir_off, avir_off, bvirtpi, bvir_off, FABints->params->colidx, bca, 1);
 
 		for(Gd=0; Gd < nirreps; Gd++) {
 		  /* +t_IkDc * F_jDbA */
 		  Gba = Gjd = Gj ^ Gd;
 		  Gc = Gik ^ Gd;
 
-		  dc = T2AB.col_offset[Gik][Gd];
-		  jd = FBAints.row_offset[Gjd][J];
+		  dc = T2AB->col_offset[Gik][Gd];
+		  jd = FBAints->row_offset[Gjd][J];
 
-		  FBAints.matrix[Gjd] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gjd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gjd, jd, avirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FBA), Gjd, jd, avirtpi[Gd]);
 
-		  nrows = FBAints.params->coltot[Gjd];
+		  nrows = FBAints->params->coltot[Gjd];
 		  ncols = bvirtpi[Gc];
 		  nlinks = avirtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(FBAints.matrix[Gjd][0][0]), nrows,
-			    &(T2AB.matrix[Gik][ik][dc]), ncols, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gik][ik][dc]), ncols, 1.0,
 			    &(WbAc[Gba][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FBAints.matrix[Gjd], avirtpi[Gd], FBAints.params->coltot[Gjd]);
-
 		  /* -t_IjDc * F_kDbA */
 		  Gba = Gkd = Gk ^ Gd;
 		  Gc = Gij ^ Gd;
 
-		  dc = T2AB.col_offset[Gij][Gd];
-		  kd = FBAints.row_offset[Gkd][K];
+		  dc = T2AB->col_offset[Gij][Gd];
+		  kd = FBAints->row_offset[Gkd][K];
 
-		  FBAints.matrix[Gkd] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gkd]);
-		  global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gkd, kd, avirtpi[Gd]);
+		  F = ijk_rows_rd(&(scratch->FBA), Gkd, kd, avirtpi[Gd]);
 
-		  nrows = FBAints.params->coltot[Gkd];
+		  nrows = FBAints->params->coltot[Gkd];
 		  ncols = bvirtpi[Gc];
 		  nlinks = avirtpi[Gd];
 
 		  if(nrows && ncols && nlinks) 
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(FBAints.matrix[Gkd][0][0]), nrows,
-			    &(T2AB.matrix[Gij][ij][dc]), ncols, 1.0,
+			    &(F[0][0]), nrows,
+			    &(T2AB->matrix[Gij][ij][dc]), ncols, 1.0,
 			    &(WbAc[Gba][0][0]), ncols);
 
-		  global_dpd_->free_dpd_block(FBAints.matrix[Gkd], avirtpi[Gd], FBAints.params->coltot[Gkd]);
-
 		}
 
 		for(Gl=0; Gl < nirreps; Gl++) {
@@ -573,59 +696,51 @@ double ET_UHF_ABB(void)
 		  Gba = Gjl = Gj ^ Gl;
 		  Gc = Gik ^ Gl;
 
-		  lc = EABints.col_offset[Gik][Gl];
-		  jl = T2BA.row_offset[Gjl][J];
+		  lc = EABints->col_offset[Gik][Gl];
+		  jl = T2BA->row_offset[Gjl][J];
 
-		  nrows = T2BA.params->coltot[Gjl];
+		  nrows = T2BA->params->coltot[Gjl];
 		  ncols = bvirtpi[Gc];
 		  nlinks = aoccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0,
-			    &(T2BA.matrix[Gjl][jl][0]), nrows,
-			    &(EABints.matrix[Gik][ik][lc]), ncols, 1.0,
+			    &(T2BA->matrix[Gjl][jl][0]), nrows,
+			    &(EABints->matrix[Gik][ik][lc]), ncols, 1.0,
 			    &(WbAc[Gba][0][0]), ncols);
 
 		  /* +t_kLbA * E_IjLc */
 		  Gba = Gkl = Gk ^ Gl;
 		  Gc = Gij ^ Gl;
 
-		  lc = EABints.col_offset[Gij][Gl];
-		  kl = T2BA.row_offset[Gkl][K];
+		  lc = EABints->col_offset[Gij][Gl];
+		  kl = T2BA->row_offset[Gkl][K];
 
-		  nrows = T2BA.params->coltot[Gkl];
+		  nrows = T2BA->params->coltot[Gkl];
 		  ncols = bvirtpi[Gc];
 		  nlinks = aoccpi[Gl];
 
 		  if(nrows && ncols && nlinks)
 		    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0,
-			    &(T2BA.matrix[Gkl][kl][0]), nrows,
-			    &(EABints.matrix[Gij][ij][lc]), ncols, 1.0,
+			    &(T2BA->matrix[Gkl][kl][0]), nrows,
+			    &(EABints->matrix[Gij][ij][lc]), ncols, 1.0,
 			    &(WbAc[Gba][0][0]), ncols);
 		}
 
-        global_dpd_->sort_3d(WbAc, WAbc, nirreps, Gijk, FBAints.params->coltot, FBAints.params->colidx,
-		       FBAints.params->colorb, FBAints.params->rsym, FBAints.params->ssym,
-		       bvir_off, avir_off, bvirtpi, bvir_off, FABints.params->colidx, bac, 1);
-
-		for(Gab=0; Gab < nirreps; Gab++) {
-		  Gc = Gab ^ Gijk;
-
-		  global_dpd_->free_dpd_block(WbAc[Gab], FBAints.params->coltot[Gab], bvirtpi[Gc]);
-		}
+		global_dpd_->sort_3d(WbAc, WAbc, nirreps, Gijk, FBAints->params->coltot, FBAints->params->colidx,
+		       FBAints->params->colorb, FBAints->params->rsym, FBAints->params->ssym,
+		       bvir_off, avir_off, bvirtpi, bvir_off, FABints->params->colidx, bac, 1);
 
 		/* Add disconnected triples and finish W and V */
 		for(Gab=0; Gab < nirreps; Gab++) {
 		  Gc = Gab ^ Gijk;
 
-		  VAbc[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], bvirtpi[Gc]);
-
-		  for(ab=0; ab < FABints.params->coltot[Gab]; ab++) {
-		    A = FABints.params->colorb[Gab][ab][0];
-		    Ga = FABints.params->rsym[A];
+		  for(ab=0; ab < FABints->params->coltot[Gab]; ab++) {
+		    A = FABints->params->colorb[Gab][ab][0];
+		    Ga = FABints->params->rsym[A];
 		    a = A - avir_off[Ga];
-		    B = FABints.params->colorb[Gab][ab][1];
-		    Gb = FABints.params->ssym[B];
+		    B = FABints->params->colorb[Gab][ab][1];
+		    Gb = FABints->params->ssym[B];
 		    b = B - bvir_off[Gb];
 
 		    Gbc = Gb ^ Gc;
@@ -634,21 +749,21 @@ double ET_UHF_ABB(void)
 		    for(c=0; c < bvirtpi[Gc]; c++) {
 		      C = bvir_off[Gc] + c;
 
-		      bc = DBBints.params->colidx[B][C];
-		      ac = DABints.params->colidx[A][C];
+		      bc = DBBints->params->colidx[B][C];
+		      ac = DABints->params->colidx[A][C];
 
 		      /* +t_IA * D_jkbc + f_IA * t_jkbc */
 		      if(Gi == Ga && Gjk == Gbc) {
 			t_ia = D_jkbc = f_ia = t_jkbc = 0.0;
 
-			if(T1A.params->rowtot[Gi] && T1A.params->coltot[Gi]) {
-			  t_ia = T1A.matrix[Gi][i][a];
-			  f_ia = fIA.matrix[Gi][i][a];
+			if(T1A->params->rowtot[Gi] && T1A->params->coltot[Gi]) {
+			  t_ia = T1A->matrix[Gi][i][a];
+			  f_ia = fIA->matrix[Gi][i][a];
 			}
 
-			if(DBBints.params->rowtot[Gjk] && DBBints.params->coltot[Gjk]) {
-			  D_jkbc = DBBints.matrix[Gjk][jk][bc];
-			  t_jkbc = T2BB.matrix[Gjk][jk][bc];
+			if(DBBints->params->rowtot[Gjk] && DBBints->params->coltot[Gjk]) {
+			  D_jkbc = DBBints->matrix[Gjk][jk][bc];
+			  t_jkbc = T2BB->matrix[Gjk][jk][bc];
 			}
 
 			VAbc[Gab][ab][c] += t_ia * D_jkbc + f_ia * t_jkbc;
@@ -658,14 +773,14 @@ double ET_UHF_ABB(void)
 		      if(Gj == Gb && Gik == Gac) {
 			t_jb = D_ikac = f_jb = t_ikac = 0.0;
 
-			if(T1B.params->rowtot[Gj] && T1B.params->coltot[Gj]) {
-			  t_jb = T1B.matrix[Gj][j][b];
-			  f_jb = fia.matrix[Gj][j][b];
+			if(T1B->params->rowtot[Gj] && T1B->params->coltot[Gj]) {
+			  t_jb = T1B->matrix[Gj][j][b];
+			  f_jb = fia->matrix[Gj][j][b];
 			}
 
-			if(DABints.params->rowtot[Gik] && DABints.params->coltot[Gik]) {
-			  D_ikac = DABints.matrix[Gik][ik][ac];
-			  t_ikac = T2AB.matrix[Gik][ik][ac];
+			if(DABints->params->rowtot[Gik] && DABints->params->coltot[Gik]) {
+			  D_ikac = DABints->matrix[Gik][ik][ac];
+			  t_ikac = T2AB->matrix[Gik][ik][ac];
 			}
 
 			VAbc[Gab][ab][c] += t_jb * D_ikac + f_jb * t_ikac;
@@ -675,14 +790,14 @@ double ET_UHF_ABB(void)
 		      if(Gj == Gc && Gik == Gab) {
 			t_jc = D_ikab = f_jc = t_ikab = 0.0;
 
-			if(T1B.params->rowtot[Gj] && T1B.params->coltot[Gj]) {
-			  t_jc = T1B.matrix[Gj][j][c];
-			  f_jc = fia.matrix[Gj][j][c];
+			if(T1B->params->rowtot[Gj] && T1B->params->coltot[Gj]) {
+			  t_jc = T1B->matrix[Gj][j][c];
+			  f_jc = fia->matrix[Gj][j][c];
 			}
 
-			if(DABints.params->rowtot[Gik] && DABints.params->coltot[Gik]) {
-			  D_ikab = DABints.matrix[Gik][ik][ab];
-			  t_ikab = T2AB.matrix[Gik][ik][ab];
+			if(DABints->params->rowtot[Gik] && DABints->params->coltot[Gik]) {
+			  D_ikab = DABints->matrix[Gik][ik][ab];
+			  t_ikab = T2AB->matrix[Gik][ik][ab];
 			}
 
 			VAbc[Gab][ab][c] -= t_jc * D_ikab + f_jc * t_ikab;
@@ -692,14 +807,14 @@ double ET_UHF_ABB(void)
 		      if(Gk == Gb && Gji == Gac) {
 			t_kb = D_ijac = f_kb = t_ijac = 0.0;
 
-			if(T1B.params->rowtot[Gk] && T1B.params->coltot[Gk]) {
-			  t_kb = T1B.matrix[Gk][k][b];
-			  f_kb = fia.matrix[Gk][k][b];
+			if(T1B->params->rowtot[Gk] && T1B->params->coltot[Gk]) {
+			  t_kb = T1B->matrix[Gk][k][b];
+			  f_kb = fia->matrix[Gk][k][b];
 			}
 
-			if(DABints.params->rowtot[Gji] && DABints.params->coltot[Gji]) {
-			  D_ijac = DABints.matrix[Gji][ij][ac];
-			  t_ijac = T2AB.matrix[Gji][ij][ac];
+			if(DABints->params->rowtot[Gji] && DABints->params->coltot[Gji]) {
+			  D_ijac = DABints->matrix[Gji][ij][ac];
+			  t_ijac = T2AB->matrix[Gji][ij][ac];
 			}
 
 			VAbc[Gab][ab][c] -= t_kb * D_ijac + f_kb * t_ijac;
@@ -709,14 +824,14 @@ double ET_UHF_ABB(void)
 		      if(Gk == Gc && Gji == Gab) {
 			t_kc = D_ijab = f_kc = t_ijab = 0.0;
 
-			if(T1B.params->rowtot[Gk] && T1B.params->coltot[Gk]) {
-			  t_kc = T1B.matrix[Gk][k][c];
-			  f_kc = fia.matrix[Gk][k][c];
+			if(T1B->params->rowtot[Gk] && T1B->params->coltot[Gk]) {
+			  t_kc = T1B->matrix[Gk][k][c];
+			  f_kc = fia->matrix[Gk][k][c];
 			}
 
-			if(DABints.params->rowtot[Gji] && DABints.params->coltot[Gji]) {
-			  D_ijab = DABints.matrix[Gji][ij][ab];
-			  t_ijab = T2AB.matrix[Gji][ij][ab];
+			if(DABints->params->rowtot[Gji] && DABints->params->coltot[Gji]) {
+			  D_ijab = DABints->matrix[Gji][ij][ab];
+			  t_ijab = T2AB->matrix[Gji][ij][ab];
 			}
 
 			VAbc[Gab][ab][c] += t_kc * D_ijab + f_kc * t_ijab;
@@ -727,12 +842,12 @@ double ET_UHF_ABB(void)
 
 		      /* Build the rest of the denominator and divide it into W */
 		      denom = dijk;
-		      if(fAB.params->rowtot[Ga])
-			denom -= fAB.matrix[Ga][a][a];
-		      if(fab.params->rowtot[Gb])
-			denom -= fab.matrix[Gb][b][b];
-		      if(fab.params->rowtot[Gc])
-			denom -= fab.matrix[Gc][c][c];
+		      if(fAB->params->rowtot[Ga])
+			denom -= fAB->matrix[Ga][a][a];
+		      if(fab->params->rowtot[Gb])
+			denom -= fab->matrix[Gb][b][b];
+		      if(fab->params->rowtot[Gc])
+			denom -= fab->matrix[Gc][c][c];
 
 		      WAbc[Gab][ab][c] /= denom;
 
@@ -743,69 +858,9 @@ double ET_UHF_ABB(void)
 		/* 1/2 Dot product of final V and W is the energy for this ijk triple */
 		for(Gab=0; Gab < nirreps; Gab++) {
 		  Gc = Gab ^ Gijk;
-		  ET_ABB += dot_block(WAbc[Gab], VAbc[Gab], FABints.params->coltot[Gab], bvirtpi[Gc], 0.5);
-		  global_dpd_->free_dpd_block(WAbc[Gab], FABints.params->coltot[Gab], bvirtpi[Gc]);
-		  global_dpd_->free_dpd_block(VAbc[Gab], FABints.params->coltot[Gab], bvirtpi[Gc]);
+		    ET_ABB += dot_block(WAbc[Gab], VAbc[Gab], FABints->params->coltot[Gab], bvirtpi[Gc], 0.5);
 		}
 
-	      } /* J >= K */
-
-	    } /* k */
-	  } /* j */
-	} /* i */
-
-      } /* Gk */
-    } /* Gj */
-  } /* Gi */
-
-  free(WAbc);
-  free(VAbc);
-  free(WAcb);
-  free(WbcA);
-  free(WcAb);
-  free(WbAc);
-
-  for(h=0; h < nirreps; h++) {
-    global_dpd_->buf4_mat_irrep_close(&T2BB, h);
-    global_dpd_->buf4_mat_irrep_close(&T2AB, h);
-    global_dpd_->buf4_mat_irrep_close(&T2BA, h);
-    global_dpd_->buf4_mat_irrep_close(&EBBints, h);
-    global_dpd_->buf4_mat_irrep_close(&EABints, h);
-    global_dpd_->buf4_mat_irrep_close(&EBAints, h);
-    global_dpd_->buf4_mat_irrep_close(&DBBints, h);
-    global_dpd_->buf4_mat_irrep_close(&DABints, h);
-  }
-
-  global_dpd_->buf4_close(&T2BB);
-  global_dpd_->buf4_close(&T2AB);
-  global_dpd_->buf4_close(&T2BA);
-  global_dpd_->buf4_close(&FBBints);
-  global_dpd_->buf4_close(&FABints);
-  global_dpd_->buf4_close(&FBAints);
-  global_dpd_->buf4_close(&EBBints);
-  global_dpd_->buf4_close(&EABints);
-  global_dpd_->buf4_close(&EBAints);
-  global_dpd_->buf4_close(&DBBints);
-  global_dpd_->buf4_close(&DABints);
-
-  global_dpd_->file2_mat_close(&T1A);
-  global_dpd_->file2_close(&T1A);
-  global_dpd_->file2_mat_close(&T1B);
-  global_dpd_->file2_close(&T1B);
-
-  global_dpd_->file2_mat_close(&fIJ);
-  global_dpd_->file2_mat_close(&fij);
-  global_dpd_->file2_mat_close(&fAB);
-  global_dpd_->file2_mat_close(&fab);
-  global_dpd_->file2_mat_close(&fIA);
-  global_dpd_->file2_mat_close(&fia);
-  global_dpd_->file2_close(&fIJ);
-  global_dpd_->file2_close(&fij);
-  global_dpd_->file2_close(&fAB);
-  global_dpd_->file2_close(&fab);
-  global_dpd_->file2_close(&fIA);
-  global_dpd_->file2_close(&fia);
-
   return ET_ABB;
 }
 
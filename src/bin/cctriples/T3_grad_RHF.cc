@@ -28,11 +28,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <vector>
 #include <libciomr/libciomr.h>
 #include <libdpd/dpd.h>
 #include <libqt/qt.h>
 #include "MOInfo.h"
 #include "Params.h"
+#include "ijk_schedule.h"
 #define EXTERN
 #include "globals.h"
 #include "libparallel/ParallelPrinter.h"
@@ -61,6 +63,8 @@ namespace psi { namespace cctriples {
       dpdbuf4 T2, Fints, Eints, Dints, S2, F2ints;
       dpdfile2 fIJ, fAB, fIA, T1, S1;
       int nijk, mijk;
+      int n, old_threads;
+      std::vector<IJKTask> tasks;
       double value, value1, value2, ET=0.0;
       int id;
       double **Z;
@@ -111,21 +115,9 @@ namespace psi { namespace cctriples {
 
       /* Compute the number of IJK combinations */
       /* For now, we need all combinations for gradients */
-      nijk = 0;
-      for(Gi=0; Gi < nirreps; Gi++)
-	for(Gj=0; Gj < nirreps; Gj++)
-	  for(Gk=0; Gk < nirreps; Gk++)
-	    for(i=0; i < occpi[Gi]; i++) {
-	      I = occ_off[Gi] + i;
-	      for(j=0; j < occpi[Gj]; j++) {
-		J = occ_off[Gj] + j;
-		for(k=0; k < occpi[Gk]; k++) {
-		  K = occ_off[Gk] + k;
-
-		  nijk++;
-		}
-	      }
-	    }
+      ijk_tasks(tasks, nirreps, -1, -1, -1, occpi, occ_off, occpi, occ_off, occpi, occ_off,
+		virtpi, virtpi, virtpi, IJK_ANY, IJK_ANY);
+      nijk = tasks.size();
       boost::shared_ptr<OutFile> printer(new OutFile("ijk.dat",TRUNCATE));
       //ffile(&ijkfile,"ijk.dat", 0);
       printer->Printf( "Number of IJK combintions: %d\n", nijk);
@@ -137,9 +129,15 @@ namespace psi { namespace cctriples {
       V = (double ***) malloc(nirreps * sizeof(double **));
 
       mijk = 0;
-      for(Gi=0; Gi < nirreps; Gi++) {
-	for(Gj=0; Gj < nirreps; Gj++) {
-	  for(Gk=0; Gk < nirreps; Gk++) {
+      old_threads = ijk_blas_threads(params.nthreads, 0);
+
+      for(n=0; n < nijk; n++) {
+
+	Gi = tasks[n].Gi; Gj = tasks[n].Gj; Gk = tasks[n].Gk;
+	i = tasks[n].i; j = tasks[n].j; k = tasks[n].k;
+	I = occ_off[Gi] + i;
+	J = occ_off[Gj] + j;
+	K = occ_off[Gk] + k;
 
 	    Gkj = Gjk = Gk ^ Gj;
 	    Gji = Gij = Gi ^ Gj;
@@ -147,13 +145,6 @@ namespace psi { namespace cctriples {
 
 	    Gijk = Gi ^ Gj ^ Gk;
 
-	    for(i=0; i < occpi[Gi]; i++) {
-	      I = occ_off[Gi] + i;
-	      for(j=0; j < occpi[Gj]; j++) {
-		J = occ_off[Gj] + j;
-		for(k=0; k < occpi[Gk]; k++) {
-		  K = occ_off[Gk] + k;
-
 		  mijk++;
 		  printer->Printf( "%d\n", mijk);
 
@@ -745,13 +736,9 @@ namespace psi { namespace cctriples {
 		  }
 		  timer_off("malloc");
 
-		} /* k */
-	      } /* j */
-	    } /* i */
+      } /* ijk */
 
-	  } /* Gk */
-	} /* Gj */
-      } /* Gi */
+      ijk_blas_threads(old_threads, 0);
 
       outfile->Printf( "\tE(T) = %20.14f\n", ET);
 
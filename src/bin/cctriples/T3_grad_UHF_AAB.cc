@@ -27,11 +27,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <vector>
 #include <libciomr/libciomr.h>
 #include <libqt/qt.h>
 #include <libdpd/dpd.h>
 #include "MOInfo.h"
 #include "Params.h"
+#include "ijk_schedule.h"
 #define EXTERN
 #include "globals.h"
 
@@ -74,6 +76,8 @@ extern void T3_UHF_AAB_abc(double ***W, double ***V, int disc, int nirreps,
       int il, jl, kl, li, lk;
       int *aoccpi, *avirtpi, *aocc_off, *avir_off;
       int *boccpi, *bvirtpi, *bocc_off, *bvir_off;
+      int n;
+      std::vector<IJKTask> tasks;
       double value_c, value_d, dijk, denom, ET;
       int nrows, ncols, nlinks;
       dpdbuf4 T2AB, T2AA, T2BA;
@@ -207,11 +211,12 @@ extern void T3_UHF_AAB_abc(double ***W, double ***V, int disc, int nirreps,
 	      Y2[Ga] = global_dpd_->dpd_block_matrix(avirtpi[Ga], FABints.params->coltot[Gbc]); /* alpha-alpha-beta */
 	    }
 
-	    for(i=0; i < aoccpi[Gi]; i++) {
+	    ijk_tasks(tasks, nirreps, Gi, Gj, Gk, aoccpi, aocc_off, aoccpi, aocc_off, boccpi, bocc_off,
+		      avirtpi, avirtpi, bvirtpi, IJK_ANY, IJK_ANY);
+	    for(n=0; n < (int) tasks.size(); n++) {
+	      i = tasks[n].i; j = tasks[n].j; k = tasks[n].k;
 	      I = aocc_off[Gi] + i;
-	      for(j=0; j < aoccpi[Gj]; j++) {
 		J = aocc_off[Gj] + j;
-		for(k=0; k < boccpi[Gk]; k++) {
 		  K = bocc_off[Gk] + k;
 
 		  T3_UHF_AAB(WABc, VABc, 1, nirreps, I, Gi, J, Gj, K, Gk, &T2AA, &T2AB, &T2BA, 
@@ -818,9 +823,7 @@ extern void T3_UHF_AAB_abc(double ***W, double ***V, int disc, int nirreps,
 		  global_dpd_->file2_mat_close(&fIA);
 		  global_dpd_->file2_mat_close(&fia);
 
-		} /* k */
-	      } /* j */
-	    } /* i */
+	    } /* ijk */
 
 	    for(Gab=0; Gab < nirreps; Gab++) {
 	      Gc = Gab ^ Gijk;
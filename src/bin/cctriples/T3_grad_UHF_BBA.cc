@@ -27,10 +27,12 @@
  #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <vector>
 #include <libdpd/dpd.h>
 #include <libqt/qt.h>
 #include "MOInfo.h"
 #include "Params.h"
+#include "ijk_schedule.h"
 #define EXTERN
 #include "globals.h"
 
@@ -73,6 +75,8 @@ extern void T3_UHF_AAB_abc(double ***W, double ***V, int disc, int nirreps,
       int il, jl, kl, li, lk;
       int *aoccpi, *avirtpi, *aocc_off, *avir_off;
       int *boccpi, *bvirtpi, *bocc_off, *bvir_off;
+      int n;
+      std::vector<IJKTask> tasks;
       double value_c, value_d, dijk, denom, ET;
       int nrows, ncols, nlinks;
       dpdbuf4 T2AB, T2BB, T2BA;
@@ -210,11 +214,12 @@ extern void T3_UHF_AAB_abc(double ***W, double ***V, int disc, int nirreps,
 	      Y2[Ga] = global_dpd_->dpd_block_matrix(bvirtpi[Ga], FBAints.params->coltot[Gbc]); /* beta-beta-alpha */
 	    }
 
-	    for(i=0; i < boccpi[Gi]; i++) {
+	    ijk_tasks(tasks, nirreps, Gi, Gj, Gk, boccpi, bocc_off, boccpi, bocc_off, aoccpi, aocc_off,
+		      bvirtpi, bvirtpi, avirtpi, IJK_ANY, IJK_ANY);
+	    for(n=0; n < (int) tasks.size(); n++) {
+	      i = tasks[n].i; j = tasks[n].j; k = tasks[n].k;
 	      I = bocc_off[Gi] + i;
-	      for(j=0; j < boccpi[Gj]; j++) {
 		J = bocc_off[Gj] + j;
-		for(k=0; k < aoccpi[Gk]; k++) {
 		  K = aocc_off[Gk] + k;
 
 		  T3_UHF_AAB(WabC, VabC, 1, nirreps, I, Gi, J, Gj, K, Gk, &T2BB, &T2BA, &T2AB, 
@@ -820,9 +825,7 @@ extern void T3_UHF_AAB_abc(double ***W, double ***V, int disc, int nirreps,
 		  global_dpd_->file2_mat_close(&fIA);
 		  global_dpd_->file2_mat_close(&fia);
 
-		} /* k */
-	      } /* j */
-	    } /* i */
+	    } /* ijk */
 
 	    for(Gab=0; Gab < nirreps; Gab++) {
 	      Gc = Gab ^ Gijk;
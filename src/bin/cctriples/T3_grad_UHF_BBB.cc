@@ -27,10 +27,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <vector>
 #include <libdpd/dpd.h>
 #include <libqt/qt.h>
 #include "MOInfo.h"
 #include "Params.h"
+#include "ijk_schedule.h"
 #define EXTERN
 #include "globals.h"
 
@@ -52,6 +54,8 @@ extern void T3_UHF_AAA_abc(double ***W, double ***V, int disc, int nirreps,
     {
       int h, nirreps;
       int *occpi, *virtpi, *occ_off, *vir_off;
+      int n;
+      std::vector<IJKTask> tasks;
       int i, j, k, a, b, c, d, l;
       int I, J, K, A, B, C, D, L;
       int ij, ji, ik, ki, jk, kj;
@@ -144,11 +148,12 @@ extern void T3_UHF_AAA_abc(double ***W, double ***V, int disc, int nirreps,
 	      Y[Ga] = global_dpd_->dpd_block_matrix(virtpi[Ga],Fints.params->coltot[Gbc]);
 	    }
 
-	    for(i=0; i < occpi[Gi]; i++) {
+	    ijk_tasks(tasks, nirreps, Gi, Gj, Gk, occpi, occ_off, occpi, occ_off, occpi, occ_off,
+		      virtpi, virtpi, virtpi, IJK_ANY, IJK_ANY);
+	    for(n=0; n < (int) tasks.size(); n++) {
+	      i = tasks[n].i; j = tasks[n].j; k = tasks[n].k;
 	      I = occ_off[Gi] + i;
-	      for(j=0; j < occpi[Gj]; j++) {
 		J = occ_off[Gj] + j;
-		for(k=0; k < occpi[Gk]; k++) {
 		  K = occ_off[Gk] + k;
 
 		  T3_UHF_AAA(WABC, VABC, 1, nirreps, I, Gi, J, Gj, K, Gk, &T2, &Fints, &Eints,
@@ -426,9 +431,7 @@ extern void T3_UHF_AAA_abc(double ***W, double ***V, int disc, int nirreps,
 		    global_dpd_->buf4_mat_irrep_close(&Dints, h);
 		  }
 
-		} /* K */
-	      } /* J */
-	    } /* I */
+	    } /* ijk */
 
 	    for(Gab=0; Gab < nirreps; Gab++) {
 	      Gc = Gab ^ Gijk;
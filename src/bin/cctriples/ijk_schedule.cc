@@ -0,0 +1,303 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+
+/*! \file
+    \ingroup CCTRIPLES
+    \brief Occupied-triplet scheduler shared by the (T) drivers
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <psiconfig.h>
+#include <libparallel/parallel.h>
+#include "ijk_schedule.h"
+#ifdef HAVE_MKL
+#include <mkl.h>
+#endif
+
+namespace psi { namespace cctriples {
+
+static bool ijk_more_expensive(const IJKTask &a, const IJKTask &b)
+{
+  return a.cost > b.cost;
+}
+
+static bool ijk_allowed(int P, int Q, int rule)
+{
+  if(rule == IJK_GE) return P >= Q;
+  if(rule == IJK_GT) return P > Q;
+  return true;
+}
+
+/* ijk_tasks(): Lists the occupied triplets (I,J,K) of one spin case,
+** most expensive first.  The cost of a triplet is the size of its
+** W(abc) intermediate, which sets both the F-term flop count and the
+** scratch memory, so a dynamic schedule over this list hands out the
+** large triplets first and fills in with the small ones.  Triplets of
+** equal cost keep their canonical loop order.
+**
+** Arguments:
+**
+**   int Gi, Gj, Gk: Restrict the list to one irrep triple; -1 for all.
+**
+**   int *iocc, *ioff (and j, k): Occupied orbitals per irrep and their
+**   absolute offsets for each index of the triplet.
+**
+**   int *avir, *bvir, *cvir: Virtual orbitals per irrep for the
+**   matching a, b, c indices.
+**
+**   int ij_rule, jk_rule: IJK_ANY, IJK_GE or IJK_GT restriction
+**   between the absolute I and J, and J and K.
+*/
+void ijk_tasks(std::vector<IJKTask> &tasks, int nirreps, int Gi, int Gj, int Gk,
+               int *iocc, int *ioff, int *jocc, int *joff, int *kocc, int *koff,
+               int *avir, int *bvir, int *cvir, int ij_rule, int jk_rule)
+{
+  int h, Ga, Gb, gi, gj, gk, i, j, k;
+  std::vector<double> cost(nirreps, 0.0);
+  IJKTask task;
+
+  for(h=0; h < nirreps; h++)
+    for(Ga=0; Ga < nirreps; Ga++)
+      for(Gb=0; Gb < nirreps; Gb++)
+        cost[h] += (double) avir[Ga] * bvir[Gb] * cvir[Ga^Gb^h];
+
+  tasks.clear();
+  for(gi=0; gi < nirreps; gi++) {
+    if(Gi != -1 && gi != Gi) continue;
+    for(gj=0; gj < nirreps; gj++) {
+      if(Gj != -1 && gj != Gj) continue;
+      for(gk=0; gk < nirreps; gk++) {
+        if(Gk != -1 && gk != Gk) continue;
+        task.Gi = gi; task.Gj = gj; task.Gk = gk;
+        task.cost = cost[gi^gj^gk];
+        for(i=0; i < iocc[gi]; i++)
+          for(j=0; j < jocc[gj]; j++) {
+            if(!ijk_allowed(ioff[gi]+i, joff[gj]+j, ij_rule)) continue;
+            for(k=0; k < kocc[gk]; k++) {
+              if(!ijk_allowed(joff[gj]+j, koff[gk]+k, jk_rule)) continue;
+              task.i = i; task.j = j; task.k = k;
+              tasks.push_back(task);
+            }
+          }
+      }
+    }
+  }
+
+  std::stable_sort(tasks.begin(), tasks.end(), ijk_more_expensive);
+}
+
+/* ijk_threads(): Splits nthreads between triplets computed
+** concurrently and BLAS threads within each triplet.  mem_shared words
+** (e.g. in-core integrals) are held once for all threads, each
+** concurrent triplet needs mem_per_thread words of scratch.  When
+** there are fewer triplets, or room for fewer scratch sets, than
+** threads, the leftover threads go to the BLAS calls.
+*/
+void ijk_threads(long int ntasks, int nthreads, long int mem_avail, long int mem_shared,
+                 long int mem_per_thread, int *nthreads_ijk, int *nthreads_blas)
+{
+  long int nijk = nthreads;
+
+  if(ntasks < nijk) nijk = ntasks;
+  if(mem_per_thread > 0 && (mem_avail - mem_shared) / mem_per_thread < nijk)
+    nijk = (mem_avail - mem_shared) / mem_per_thread;
+  if(nijk < 1) nijk = 1;
+
+  *nthreads_ijk = (int) nijk;
+  *nthreads_blas = nthreads / (int) nijk;
+  if(*nthreads_blas < 1) *nthreads_blas = 1;
+}
+
+/* ijk_blas_threads(): Sets the number of threads used by each BLAS
+** call and returns the previous setting, for BLAS libraries that
+** allow it.  Otherwise does nothing and returns 1.  With nested set,
+** the BLAS keeps its threads even when called from inside a parallel
+** region over triplets.
+*/
+int ijk_blas_threads(int nthreads, int nested)
+{
+#ifdef HAVE_MKL
+  int old_threads = mkl_get_max_threads();
+  mkl_set_dynamic(!nested);
+  mkl_set_num_threads(nthreads);
+  return old_threads;
+#else
+  UNUSED(nthreads);
+  UNUSED(nested);
+  return 1;
+#endif
+}
+
+/* ijk_block_words(): Returns the words needed by an abc intermediate
+** with rowtot[Gab] ab pairs and cvir[Gc] c orbitals per irrep, for the
+** largest irrep Gijk.
+*/
+long int ijk_block_words(int nirreps, int *rowtot, int *cvir)
+{
+  int Gijk, Gab;
+  long int size, words;
+
+  words = 0;
+  for(Gijk=0; Gijk < nirreps; Gijk++) {
+    size = 0;
+    for(Gab=0; Gab < nirreps; Gab++)
+      size += (long int) rowtot[Gab] * cvir[Gab^Gijk];
+    if(size > words) words = size;
+  }
+
+  return words;
+}
+
+/* ijk_block_init(): Allocates an abc intermediate for one thread.
+** Must be called outside the parallel region, since the DPD memory
+** accounting is not thread safe.
+*/
+void ijk_block_init(IJKBlock *W, int nirreps, int *rowtot, int *cvir)
+{
+  int Gab;
+
+  W->nirreps = nirreps;
+  W->rowtot = rowtot;
+  W->cvir = cvir;
+  W->Gijk = -1;
+  W->size = 0;
+  W->words = ijk_block_words(nirreps, rowtot, cvir);
+  W->block = global_dpd_->dpd_block_matrix(1, W->words);
+  W->W = (double ***) malloc(nirreps * sizeof(double **));
+  for(Gab=0; Gab < nirreps; Gab++)
+    W->W[Gab] = (double **) malloc(rowtot[Gab] * sizeof(double *));
+}
+
+/* ijk_block_irrep(): Points the rows of W at the storage for the abc
+** blocks of irrep Gijk.  The contents are left as they are.
+*/
+void ijk_block_irrep(IJKBlock *W, int Gijk)
+{
+  int Gab, ab;
+  long int offset;
+
+  if(W->Gijk == Gijk) return;
+
+  offset = 0;
+  for(Gab=0; Gab < W->nirreps; Gab++) {
+    if(!W->cvir[Gab^Gijk]) continue;
+    for(ab=0; ab < W->rowtot[Gab]; ab++) {
+      W->W[Gab][ab] = &(W->block[0][offset]);
+      offset += W->cvir[Gab^Gijk];
+    }
+  }
+
+  W->size = offset;
+  W->Gijk = Gijk;
+}
+
+/* ijk_block_zero(): Clears the part of W used by the current irrep */
+void ijk_block_zero(IJKBlock *W)
+{
+  if(W->size)
+    ::memset((void *) W->block[0], 0, W->size*sizeof(double));
+}
+
+void ijk_block_close(IJKBlock *W)
+{
+  int Gab;
+
+  global_dpd_->free_dpd_block(W->block, 1, W->words);
+  for(Gab=0; Gab < W->nirreps; Gab++)
+    free(W->W[Gab]);
+  free(W->W);
+}
+
+/* ijk_rows_words(): Returns the words needed to hold drows[Gd] rows of
+** any irrep block of Buf.
+*/
+long int ijk_rows_words(dpdbuf4 *Buf, int *drows)
+{
+  int h, maxrows;
+  long int words;
+
+  maxrows = 0;
+  for(h=0; h < Buf->params->nirreps; h++)
+    if(drows[h] > maxrows) maxrows = drows[h];
+
+  words = 0;
+  for(h=0; h < Buf->params->nirreps; h++)
+    if((long int) maxrows * Buf->params->coltot[h] > words)
+      words = (long int) maxrows * Buf->params->coltot[h];
+
+  return words;
+}
+
+/* ijk_rows_init(): Opens a private copy of Buf for one thread, with a
+** buffer for up to max(drows) of its rows.  Must be called outside the
+** parallel region.
+*/
+void ijk_rows_init(IJKRows *R, dpdbuf4 *Buf, int *drows)
+{
+  int h;
+
+  global_dpd_->buf4_init(&(R->buf), Buf->file.filenum, Buf->file.my_irrep,
+                         Buf->params->pqnum, Buf->params->rsnum,
+                         Buf->file.params->pqnum, Buf->file.params->rsnum,
+                         Buf->anti, Buf->file.label);
+
+  R->maxrows = 0;
+  for(h=0; h < Buf->params->nirreps; h++)
+    if(drows[h] > R->maxrows) R->maxrows = drows[h];
+
+  R->words = ijk_rows_words(Buf, drows);
+  R->block = global_dpd_->dpd_block_matrix(1, R->words);
+  R->rows = (double **) malloc((R->maxrows ? R->maxrows : 1) * sizeof(double *));
+}
+
+/* ijk_rows_rd(): Reads nrows rows of irrep block h, starting at row,
+** into the thread's buffer and returns them.  The reads of all threads
+** go through the DPD/PSIO layer one at a time.  Returns NULL for an
+** empty block.
+*/
+double **ijk_rows_rd(IJKRows *R, int h, int row, int nrows)
+{
+  int r, ncols;
+
+  ncols = R->buf.params->coltot[h];
+  if(!nrows || !ncols) return NULL;
+
+  for(r=0; r < nrows; r++)
+    R->rows[r] = &(R->block[0][(long int) r * ncols]);
+  R->buf.matrix[h] = R->rows;
+#pragma omp critical(ijk_rows_rd)
+  global_dpd_->buf4_mat_irrep_rd_block(&(R->buf), h, row, nrows);
+
+  return R->rows;
+}
+
+void ijk_rows_close(IJKRows *R)
+{
+  global_dpd_->buf4_close(&(R->buf));
+  global_dpd_->free_dpd_block(R->block, 1, R->words);
+  free(R->rows);
+}
+
+}} // namespace psi::cctriples
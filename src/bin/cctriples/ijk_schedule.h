@@ -0,0 +1,93 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+
+/*! \file
+    \ingroup CCTRIPLES
+    \brief Occupied-triplet scheduler shared by the (T) drivers
+*/
+
+#ifndef _psi_src_bin_cctriples_ijk_schedule_h
+#define _psi_src_bin_cctriples_ijk_schedule_h
+
+#include <vector>
+#include <libdpd/dpd.h>
+
+namespace psi { namespace cctriples {
+
+/* Restrictions between consecutive occupied indices of a triplet */
+#define IJK_ANY 0   /* no restriction */
+#define IJK_GE  1   /* I >= J  (or J >= K) */
+#define IJK_GT  2   /* I > J   (or J > K) */
+
+/* One occupied triplet: irreps, relative indices, and its cost
+** estimate, the number of abc elements of its W intermediate */
+struct IJKTask {
+  int Gi, Gj, Gk;
+  int i, j, k;
+  double cost;
+};
+
+/* One abc intermediate W[Gab][ab][c] owned by an ijk thread.  The
+** storage is allocated once, large enough for any triplet, and the row
+** pointers are set up for the irrep of the current triplet. */
+struct IJKBlock {
+  int nirreps;
+  int *rowtot;     /* ab pairs in each irrep Gab */
+  int *cvir;       /* c orbitals in each irrep Gc */
+  int Gijk;        /* irrep the row pointers are set up for */
+  long int size;   /* words used for Gijk */
+  long int words;  /* words allocated */
+  double **block;
+  double ***W;
+};
+
+/* A thread's private handle on integrals that are read a block of
+** rows at a time into its own buffer */
+struct IJKRows {
+  dpdbuf4 buf;
+  long int words;  /* words in the buffer */
+  int maxrows;     /* rows the buffer can hold */
+  double **block;
+  double **rows;
+};
+
+void ijk_tasks(std::vector<IJKTask> &tasks, int nirreps, int Gi, int Gj, int Gk,
+               int *iocc, int *ioff, int *jocc, int *joff, int *kocc, int *koff,
+               int *avir, int *bvir, int *cvir, int ij_rule, int jk_rule);
+void ijk_threads(long int ntasks, int nthreads, long int mem_avail, long int mem_shared,
+                 long int mem_per_thread, int *nthreads_ijk, int *nthreads_blas);
+int ijk_blas_threads(int nthreads, int nested);
+
+long int ijk_block_words(int nirreps, int *rowtot, int *cvir);
+void ijk_block_init(IJKBlock *W, int nirreps, int *rowtot, int *cvir);
+void ijk_block_irrep(IJKBlock *W, int Gijk);
+void ijk_block_zero(IJKBlock *W);
+void ijk_block_close(IJKBlock *W);
+
+long int ijk_rows_words(dpdbuf4 *Buf, int *drows);
+void ijk_rows_init(IJKRows *R, dpdbuf4 *Buf, int *drows);
+double **ijk_rows_rd(IJKRows *R, int h, int row, int nrows);
+void ijk_rows_close(IJKRows *R);
+
+}} // namespace psi::cctriples
+
+#endif // _psi_src_bin_cctriples_ijk_schedule_h
@@ -46,9 +46,13 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <cstring>
+#include <vector>
 #include <libciomr/libciomr.h>
 #include <libqt/qt.h>
 #include <libpsio/psio.h>
+#include <libpsio/psio.hpp>
+#include <libpsio/aiohandler.h>
 #include "structs.h"
 #include "globals.h"
 #include "ci_tol.h"
@@ -157,6 +161,92 @@ extern void H0block_coupling_calc(double E, struct stringwr **alplist,
    struct stringwr **betlist);
 
 
+/*
+** Staging buffers for the asynchronous CI vector I/O.
+**
+** When Parameters.prefetch_bufs > 0, CIvect::read() keeps the next
+** prefetch_bufs buffers of the vector in flight, and CIvect::write()
+** copies the buffer aside and returns while it is written.  The slots
+** are shared by all CIvect objects, since several of them may address
+** the same files (e.g. if nodfile), and are keyed by unit and absolute
+** buffer number.  All requests go through one AIOHandler, which carries
+** out the requests on a unit in the order they were made.
+*/
+struct CIBufSlot {
+   int unit;                  /* file unit of the buffer, -1 if empty */
+   int buf;                   /* absolute buffer number on disk */
+   unsigned long int size;    /* bytes held */
+   unsigned long int cap;     /* doubles allocated for data */
+   double *data;
+   int writing;               /* 1 if the request writes data out */
+   unsigned long int stamp;   /* last use, for replacement */
+   SharedAIORequest req;      /* outstanding request, if any */
+};
+
+static std::vector<CIBufSlot> ci_slots;
+static boost::shared_ptr<AIOHandler> ci_aio;
+static unsigned long int ci_stamp = 0;
+
+/* wait for the request on a slot, charging the time to I/O wait */
+static void ci_slot_wait(CIBufSlot &slot)
+{
+   double before_time;
+
+   if (!slot.req) return;
+   before_time = wall_time_new();
+   slot.req->wait();
+   detci_time.aio_wait_total_time += wall_time_new() - before_time;
+   slot.req.reset();
+}
+
+/* wait for every request before synchronous psio calls */
+static void ci_aio_sync(void)
+{
+   for (unsigned int i=0; i<ci_slots.size(); i++) ci_slot_wait(ci_slots[i]);
+}
+
+static CIBufSlot *ci_slot_find(int unit, int buf)
+{
+   for (unsigned int i=0; i<ci_slots.size(); i++)
+      if (ci_slots[i].unit == unit && ci_slots[i].buf == buf) 
+         return(&ci_slots[i]);
+   return(NULL);
+}
+
+/* least recently used slot, emptied and large enough for size bytes */
+static CIBufSlot *ci_slot_claim(unsigned long int size)
+{
+   unsigned int i, lru = 0;
+   unsigned long int len = size / sizeof(double);
+
+   if (ci_slots.empty()) {
+      ci_slots.resize(Parameters.prefetch_bufs + 2);
+      for (i=0; i<ci_slots.size(); i++) {
+         ci_slots[i].unit = -1;
+         ci_slots[i].buf = -1;
+         ci_slots[i].size = ci_slots[i].cap = 0;
+         ci_slots[i].data = NULL;
+         ci_slots[i].writing = 0;
+         ci_slots[i].stamp = 0;
+         }
+      ci_aio = boost::shared_ptr<AIOHandler>(new AIOHandler(_default_psio_lib_));
+      }
+
+   for (i=1; i<ci_slots.size(); i++) 
+      if (ci_slots[i].stamp < ci_slots[lru].stamp) lru = i;
+
+   CIBufSlot &slot = ci_slots[lru];
+   ci_slot_wait(slot);
+   if (slot.cap < len) {
+      if (slot.data != NULL) free(slot.data);
+      slot.data = init_array(len);
+      slot.cap = len;
+      }
+   slot.unit = -1;
+   slot.stamp = ++ci_stamp;
+   return(&slot);
+}
+
 CIvect::CIvect() // Default constructor
 {
    vectlen = 0;
@@ -199,6 +289,7 @@ CIvect::CIvect() // Default constructor
    cur_unit = 0;
    cur_size = 0;
    first_unit = 0;
+   aio_depth = 0;
 }
 
 
@@ -246,6 +337,7 @@ CIvect::CIvect(BIGINT vl, int nb, int incor, int ms0, int *iac,
    units_used = 0;
    cur_unit = 0;
    cur_size = 0;
+   aio_depth = 0;
 
    set(vl, nb, incor, ms0, iac, ibc, ias, ibs, offs, nac, nbc,
          nirr, cdpirr, mxv, nu, funit, fablk, lablk, dc);
@@ -444,6 +536,11 @@ void CIvect::set(BIGINT vl, int nb, int incor, int ms0, int *iac,
          } /* end loop over buffers */
      }
 
+   /* prefetching only pays when a vector spans several buffers */
+   aio_depth = 0;
+   if (nunits && icore != 1 && buf_per_vect > 1) 
+     aio_depth = Parameters.prefetch_bufs;
+
     // do next step separately now to control OPEN_NEW vs OPEN_OLD
     // init_io_files();
 
@@ -1729,6 +1826,8 @@ void CIvect::init_io_files(bool open_old)
 {
    int i;
 
+   ci_aio_sync();
+
    for (i=0; i<nunits; i++) {
      if (!psio_open_check((ULI) units[i])) {
        if (open_old) psio_open((ULI) units[i], PSIO_OPEN_OLD);
@@ -1750,6 +1849,27 @@ void CIvect::init_io_files(bool open_old)
 void CIvect::close_io_files(int keep)
 {
    int i;
+   unsigned int j;
+
+   /* staged buffers do not outlive the file */
+   ci_aio_sync();
+   for (i=0; i<nunits; i++) {
+     for (j=0; j<ci_slots.size(); j++) {
+       if (ci_slots[j].unit == units[i]) {
+         ci_slots[j].unit = -1;
+         ci_slots[j].stamp = 0;
+       }
+     }
+   }
+
+   /* once no file has staged buffers, give back the slots */
+   for (j=0; j<ci_slots.size() && ci_slots[j].unit == -1; j++) ;
+   if (j == ci_slots.size()) {
+     for (j=0; j<ci_slots.size(); j++) 
+       if (ci_slots[j].data != NULL) free(ci_slots[j].data);
+     ci_slots.clear();
+     ci_aio.reset();
+   }
 
    for (i=0; i<nunits; i++) {
      // rclose(units[i], keep ? 3 : 4); // old way
@@ -1801,11 +1921,32 @@ int CIvect::read(int ivect, int ibuf)
    sprintf(key, "buffer %d", buf);
    unit = file_number[buf];
 
-   psio_read_entry((ULI) unit, key, (char *) buffer, size);
+   if (aio_depth) {
+      CIBufSlot *slot = ci_slot_find(unit, buf);
+      if (slot != NULL) {
+         /* a buffer being written out already holds the data */
+         if (!slot->writing) ci_slot_wait(*slot);
+         memcpy((void *) buffer, (void *) slot->data, size);
+         slot->stamp = ++ci_stamp;
+         detci_time.prefetch_hits++;
+         }
+      else {
+         SharedAIORequest req = ci_aio->read_entry((ULI) unit, key, 
+            (char *) buffer, size);
+         double before_time = wall_time_new();
+         req->wait();
+         detci_time.aio_wait_total_time += wall_time_new() - before_time;
+         detci_time.prefetch_misses++;
+         }
+      }
+   else 
+      psio_read_entry((ULI) unit, key, (char *) buffer, size);
 
    cur_vect = ivect;
    cur_buf = ibuf;
 
+   if (aio_depth) prefetch(ivect, ibuf);
+
    detci_time.read_after_time = wall_time_new();
    detci_time.read_total_time += detci_time.read_after_time -
      detci_time.read_before_time;
@@ -1856,7 +1997,25 @@ int CIvect::write(int ivect, int ibuf)
    sprintf(key, "buffer %d", buf);
    unit = file_number[buf];
 
-   psio_write_entry((ULI) unit, key, (char *) buffer, size);
+   if (aio_depth) {
+      /* write behind from a copy; any staged copy of this buffer goes */
+      CIBufSlot *slot = ci_slot_find(unit, buf);
+      if (slot != NULL) {
+         ci_slot_wait(*slot);
+         slot->unit = -1;
+         slot->stamp = 0;
+         }
+      slot = ci_slot_claim(size);
+      memcpy((void *) slot->data, (void *) buffer, size);
+      slot->unit = unit;
+      slot->buf = buf;
+      slot->size = size;
+      slot->writing = 1;
+      slot->req = ci_aio->write_entry((ULI) unit, key, (char *) slot->data,
+         size);
+      }
+   else
+      psio_write_entry((ULI) unit, key, (char *) buffer, size);
 
    if (ivect >= nvect) nvect = ivect + 1;
    cur_vect = ivect;
@@ -1870,6 +2029,51 @@ int CIvect::write(int ivect, int ibuf)
 }
 
 
+/*
+** CIvect::prefetch(): Start reading the aio_depth buffers that follow
+** buffer ibuf of vector ivect (wrapping around to the first buffer),
+** unless they are staged already.
+**
+** Parameters:
+**    ivect  = vector number
+**    ibuf   = buffer number just read
+**
+** Returns: none
+*/
+void CIvect::prefetch(int ivect, int ibuf)
+{
+   int k, nbuf, buf, unit;
+   unsigned long int size;
+   char key[20];
+   CIBufSlot *slot;
+
+   for (k=1; k<=aio_depth; k++) {
+      nbuf = (ibuf + k) % buf_per_vect;
+      if (nbuf == ibuf) break;
+      size = buf_size[nbuf] * (unsigned long int) sizeof(double);
+      if (!size) continue;
+
+      buf = ivect * buf_per_vect + nbuf + new_first_buf;
+      if (buf >= buf_total) buf -= buf_total;
+      unit = file_number[buf];
+
+      if ((slot = ci_slot_find(unit, buf)) != NULL) {
+         slot->stamp = ++ci_stamp;
+         continue;
+         }
+
+      sprintf(key, "buffer %d", buf);
+      slot = ci_slot_claim(size);
+      slot->unit = unit;
+      slot->buf = buf;
+      slot->size = size;
+      slot->writing = 0;
+      slot->req = ci_aio->read_entry((ULI) unit, key, (char *) slot->data,
+         size);
+      }
+}
+
+
 /*
 ** CIvect::schmidt_add()
 **
@@ -3844,6 +4048,8 @@ void CIvect::write_new_first_buf(void)
 {
   int unit;
 
+  ci_aio_sync();
+
   unit = first_unit;
   psio_write_entry((ULI) unit, "New First Buffer", (char *) &new_first_buf,
     sizeof(int));
@@ -3862,6 +4068,8 @@ int CIvect::read_new_first_buf(void)
   int unit;
   int nfb;
 
+  ci_aio_sync();
+
   unit = first_unit;
   if (psio_tocscan((ULI) unit, "New First Buffer") == NULL) return(-1);
   psio_read_entry((ULI) unit, "New First Buffer", (char *) &nfb,
@@ -3892,6 +4100,8 @@ int CIvect::read_num_vecs(void)
   int unit;
   int nv;
 
+  ci_aio_sync();
+
   unit = first_unit;
   if (psio_tocscan((ULI) unit, "Num Vectors") == NULL) return(-1);
   psio_read_entry((ULI) unit, "Num Vectors", (char *) &nv, sizeof(int));
@@ -3907,6 +4117,8 @@ void CIvect::write_num_vecs(int nv)
 {
   int unit;
 
+  ci_aio_sync();
+
   unit = first_unit;
   psio_write_entry((ULI) unit, "Num Vectors", (char *) &nv, sizeof(int));
   write_toc();
@@ -3924,6 +4136,8 @@ void CIvect::write_toc(void)
 {
   int i,unit;
 
+  ci_aio_sync();
+
   for (i=0; i<nunits; i++) {
     psio_tocwrite(units[i]);
   }
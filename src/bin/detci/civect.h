@@ -27,8 +27,12 @@
 #ifndef _psi_src_bin_detci_civect_h
 #define _psi_src_bin_detci_civect_h
 
+#include <vector>
+
 namespace psi { namespace detci {
 
+struct sigma_task;
+
 //typedef unsigned long long int BIGINT;
 typedef unsigned long int BIGINT;
 
@@ -92,6 +96,10 @@ class CIvect {
       int cur_unit;              /* current unit file */
       int cur_size;              /* current size of buffer */
       int first_unit;            /* first file unit number (if > 1) */ 
+      int aio_depth;             /* buffers to prefetch ahead of read(),
+                                    0 for synchronous I/O */
+
+      void prefetch(int ivect, int ibuf);
       
    public:
       CIvect();
@@ -214,6 +222,13 @@ class CIvect {
          CIvect& C, CIvect& S, double *oei, double *tei, int fci, int iter);
       friend void sigma_c(struct stringwr **alplist, struct stringwr **betlist,
          CIvect& C, CIvect& S, double *oei, double *tei, int fci, int iter);
+      friend void sigma_omp_add(CIvect &C, CIvect &S, 
+         std::vector<struct sigma_task> &tasks, int sblock, int cblock, 
+         int transp);
+      friend void sigma_omp_run(struct stringwr **alplist, 
+         struct stringwr **betlist, CIvect &C, CIvect &S, double *oei, 
+         double *tei, int fci, std::vector<struct sigma_task> &tasks, 
+         int *did_sblock);
       friend void sigma_get_contrib(struct stringwr **alplist, struct
          stringwr **betlist, CIvect &C, CIvect &S, int **s1_contrib, 
          int **s2_contrib, int **s3_contrib);
@@ -739,8 +739,8 @@ void opdm(struct stringwr **alplist, struct stringwr **betlist,
     psio_close(targetfile, 1);
   }
 
-  if (transp_tmp != NULL) free_block(transp_tmp);
-  if (transp_tmp2 != NULL) free_block(transp_tmp2);
+  if (transp_tmp != NULL) { free(transp_tmp[0]); free(transp_tmp); }
+  if (transp_tmp2 != NULL) { free(transp_tmp2[0]); free(transp_tmp2); }
   Ivec.buf_unlock();
   Jvec.buf_unlock();
   free(buffer1);
@@ -602,6 +602,9 @@ void get_parameters(Options &options)
      Parameters.nthreads = options.get_int("CI_NUM_THREADS");
   }
   if (Parameters.nthreads < 1) Parameters.nthreads = 1;
+  Parameters.sigma_omp = options["SIGMA_OMP"].to_integer();
+  Parameters.prefetch_bufs = options.get_int("CI_PREFETCH_BUFFERS");
+  if (Parameters.prefetch_bufs < 0) Parameters.prefetch_bufs = 0;
 
   Parameters.export_ci_vector = options["VECS_WRITE"].to_integer();
 
@@ -1037,8 +1040,9 @@ void print_parameters(void)
            Parameters.zaptn ? "yes":"no", Parameters.wigner ? "yes":"no");
    outfile->Printf( "   PERT Z        =   %1.4f      FOLLOW ROOT  =   %6d\n",
            Parameters.perturbation_parameter, Parameters.root);
-   outfile->Printf( "   NUM THREADS   =   %6d\n",
-           Parameters.nthreads);
+   outfile->Printf( "   NUM THREADS   =   %6d      SIGMA OMP    =   %6s\n",
+           Parameters.nthreads, Parameters.sigma_omp ? "yes":"no");
+   outfile->Printf( "   PREFETCH BUFS =   %6d\n", Parameters.prefetch_bufs);
    outfile->Printf( "   VECS WRITE    =   %6s      NUM VECS WRITE = %6d\n",
            Parameters.export_ci_vector ? "yes":"no", Parameters.num_export);
    outfile->Printf( "   FILTER GUESS  =   %6s      SF RESTRICT  =   %6s\n",
@@ -65,7 +65,7 @@ void s3_block_v_pthread(void *threadarg);
 void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist,
       double **C, double **S, double *tei, int nas, int nbs, int cnas,
       int Ib_list, int Ja_list, int Jb_list, int Ib_sym, int Jb_sym,
-      double **Cprime, double *F, double *V, double *Sgn, int *L, int *R)
+      double **Cprime, double *F, double *V, double *Sgn, int *L, int *R, int nthreads)
 {
   struct stringwr *Ia;
   unsigned int Ia_ex;
@@ -79,16 +79,18 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist,
   int npthreads, rc, status;
   pthread_t *thread;
    
-  npthreads = Parameters.nthreads-1;  /* subtract out the main thread */
+  npthreads = nthreads-1;  /* subtract out the main thread */
 
-  thread = (pthread_t *) malloc(sizeof(pthread_t)*Parameters.nthreads);
+  if (nthreads > 1) {
+      thread = (pthread_t *) malloc(sizeof(pthread_t)*nthreads);
 
-  thread_info = (struct pthreads_s3diag **)
-                malloc(sizeof(struct pthreads_s3diag *) * nas);
+      thread_info = (struct pthreads_s3diag **)
+                    malloc(sizeof(struct pthreads_s3diag *) * nas);
 
-  for (i=0; i<nas; i++) {
-      thread_info[i] = (struct pthreads_s3diag *)
-                       malloc(sizeof(struct pthreads_s3diag));
+      for (i=0; i<nas; i++) {
+          thread_info[i] = (struct pthreads_s3diag *)
+                           malloc(sizeof(struct pthreads_s3diag));
+        }
     }
   
   norbs = CalcInfo.num_ci_orbs;
@@ -118,7 +120,7 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist,
 
 
           /* loop over Ia */
-          if (Parameters.nthreads > 1) {
+          if (nthreads > 1) {
               detci_time.s3_mt_before_time = wall_time_new();
               tpool_queue_open(thread_pool);
               for (Ia=alplist, Ia_idx=0; Ia_idx<nas; Ia_idx++, Ia++) {
@@ -187,8 +189,10 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist,
         } /* end loop over j */
     } /* end loop over i */
 
-  for (i=0; i<nas; i++) free(thread_info[i]);
-  free(thread);
+  if (nthreads > 1) {
+      for (i=0; i<nas; i++) free(thread_info[i]);
+      free(thread);
+    }
   
 }              
 
@@ -288,7 +292,7 @@ void s3_block_vdiag_pthread(void *threadarg)
 void s3_block_v(struct stringwr *alplist, struct stringwr *betlist,
       double **C, double **S, double *tei, int nas, int nbs, int cnas,
       int Ib_list, int Ja_list, int Jb_list, int Ib_sym, int Jb_sym,
-      double **Cprime, double *F, double *V, double *Sgn, int *L, int *R)
+      double **Cprime, double *F, double *V, double *Sgn, int *L, int *R, int nthreads)
 {
    struct stringwr *Ia;
    unsigned int Ia_ex;
@@ -305,12 +309,14 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist,
    norbs = CalcInfo.num_ci_orbs;
    orbsym = CalcInfo.orbsym + CalcInfo.num_drc_orbs;
 
-   thread = (pthread_t *) malloc(sizeof(pthread_t)*Parameters.nthreads);
-   thread_info = (struct pthreads_s3diag **)
-                  malloc(sizeof(struct pthreads_s3diag *) * nas);
-   for (i=0; i<nas; i++) {
-       thread_info[i] = (struct pthreads_s3diag *)
-                        malloc(sizeof(struct pthreads_s3diag));
+   if (nthreads > 1) {
+       thread = (pthread_t *) malloc(sizeof(pthread_t)*nthreads);
+       thread_info = (struct pthreads_s3diag **)
+                      malloc(sizeof(struct pthreads_s3diag *) * nas);
+       for (i=0; i<nas; i++) {
+           thread_info[i] = (struct pthreads_s3diag *)
+                            malloc(sizeof(struct pthreads_s3diag));
+         }
      }
    
    /* loop over i, j */
@@ -336,7 +342,7 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist,
 
 
        /* loop over Ia */
-       if (Parameters.nthreads > 1) {
+       if (nthreads > 1) {
            detci_time.s3_mt_before_time = wall_time_new();
            tpool_queue_open(thread_pool);
            for (Ia=alplist, Ia_idx=0; Ia_idx<nas; Ia_idx++, Ia++) {
@@ -398,8 +404,10 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist,
        
      } /* end loop over j */
    } /* end loop over i */
-  for (i=0; i<nas; i++) free(thread_info[i]);
-  free(thread);
+  if (nthreads > 1) {
+      for (i=0; i<nas; i++) free(thread_info[i]);
+      free(thread);
+    }
    
 }
 
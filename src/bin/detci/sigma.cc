@@ -40,12 +40,17 @@
 #include <cstdlib>
 #include <cmath>
 #include <cstring>
+#include <vector>
+#include <algorithm>
 #include <libciomr/libciomr.h>
 #include <libqt/qt.h>
 #include "structs.h"
 #define EXTERN
 #include "globals.h"
 #include "civect.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi { namespace detci {
 
@@ -153,11 +158,13 @@ extern void s3_block_vdiag(struct stringwr *alplist,
    struct stringwr *betlist,
    double **C, double **S, double *tei, int nas, int nbs, int cnas,
    int Ib_list, int Ja_list, int Jb_list, int Ib_sym, int Jb_sym,
-   double **Cprime, double *F, double *V, double *Sgn, int *L, int *R);
+   double **Cprime, double *F, double *V, double *Sgn, int *L, int *R,
+   int nthreads);
 extern void s3_block_v(struct stringwr *alplist,struct stringwr *betlist,
    double **C, double **S, double *tei, int nas, int nbs, int cnas,
    int Ib_list, int Ja_list, int Jb_list, int Ib_sym, int Jb_sym,
-   double **Cprime, double *F, double *V, double *Sgn, int *L, int *R);
+   double **Cprime, double *F, double *V, double *Sgn, int *L, int *R,
+   int nthreads);
 extern void s3_block_vrotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
    signed char **Sn[2], double **C, double **S, 
    double *tei, int nas, int nbs, int cnas,
@@ -176,6 +183,27 @@ extern struct olsen_graph *BetaG;
 
 extern int cc_reqd_sblocks[CI_BLK_MAX];
 
+/* Scratch used by one sigma_block() call.  The serial sigma routines
+** use a single set bound to the module globals; the OpenMP sigma build
+** gives each thread its own. */
+struct sigma_scratch {
+   double *F, *V, *Sgn;
+   int *L, *R;
+   double **cprime;    /* row pointers into a C block sized buffer */
+   double **sacc;      /* private sigma block accumulator */
+   double **ctransp;   /* private transposed C block */
+   int nthreads;       /* pthread pool threads each kernel may use */
+   int timing;         /* 1 to accumulate the per-kernel detci_time */
+};
+
+/* One (sigma block, C block) pair of the OpenMP sigma build */
+struct sigma_task {
+   int sblock;
+   int cblock;         /* C block held in memory */
+   int transp;         /* 1 if the contribution is from its Ms=0 partner */
+   double cost;        /* estimated work, nas*nbs*(cnas+cnbs) */
+};
+
 /* FUNCTION PROTOS THIS MODULE */
 
 void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
@@ -183,6 +211,16 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
       int cblock, int sblock, int nas, int nbs, int sac, int sbc, 
       int cac, int cbc, int cnas, int cnbs, int cnac, int cnbc, 
       int sbirr, int cbirr, int Ms0);
+void sigma_block_ws(struct stringwr **alplist, struct stringwr **betlist,
+      double **cmat, double **smat, double *oei, double *tei, int fci, 
+      int cblock, int sblock, int nas, int nbs, int sac, int sbc, 
+      int cac, int cbc, int cnas, int cnbs, int cnac, int cnbc, 
+      int sbirr, int cbirr, int Ms0, struct sigma_scratch *ws);
+void sigma_omp_add(CIvect &C, CIvect &S, std::vector<struct sigma_task> &tasks,
+      int sblock, int cblock, int transp);
+void sigma_omp_run(struct stringwr **alplist, struct stringwr **betlist,
+      CIvect &C, CIvect &S, double *oei, double *tei, int fci,
+      std::vector<struct sigma_task> &tasks, int *did_sblock);
 
 
 
@@ -203,6 +241,10 @@ double **cprime = NULL, **sprime = NULL;
    int *L, *R;
 #endif
 
+/* per-thread scratch of the OpenMP sigma build; 0 threads if it is off */
+struct sigma_scratch *sigma_omp_ws = NULL;
+int sigma_omp_nthreads = 0;
+
 
 /*
 ** sigma_init()
@@ -349,6 +391,51 @@ void sigma_init(CIvect& C, CIvect &S, struct stringwr **alplist,
      }
    }
    #endif
+
+   /* The OpenMP sigma build runs independent (sigma block, C block)
+   ** pairs concurrently, each thread with its own scratch and sigma
+   ** accumulator.  The kernels it calls then run single-threaded.  It
+   ** is not used when the whole vector is never in core at once
+   ** (icore=0), nor with the on-the-fly replacement lists or the
+   ** Bendazzoli sigma3, which share global scratch between blocks. */
+   #if defined(_OPENMP) && !defined(OLD_CDS_ALG)
+   if (Parameters.sigma_omp && Parameters.nthreads > 1 && C.icore != 0 &&
+       !Parameters.repl_otf && !Parameters.bendazzoli && 
+       Parameters.print_lvl <= 3) {
+     unsigned long int sbufsz = S.get_max_blk_size();
+     if (sbufsz > bufsz) bufsz = sbufsz;
+     for (i=0; i<S.num_blocks; i++) {
+       if (S.Ia_size[i] > maxrows) maxrows = S.Ia_size[i];
+       if (S.Ib_size[i] > maxrows) maxrows = S.Ib_size[i];
+     }
+     if (maxcols > maxrows) maxrows = maxcols;
+
+     sigma_omp_nthreads = Parameters.nthreads;
+     sigma_omp_ws = (struct sigma_scratch *) 
+       malloc(sigma_omp_nthreads * sizeof(struct sigma_scratch));
+     for (i=0; i<sigma_omp_nthreads; i++) {
+       sigma_omp_ws[i].F = init_array(max_dim);
+       sigma_omp_ws[i].V = init_array(max_dim);
+       sigma_omp_ws[i].Sgn = init_array(max_dim);
+       sigma_omp_ws[i].L = init_int_array(max_dim);
+       sigma_omp_ws[i].R = init_int_array(max_dim);
+       sigma_omp_ws[i].cprime = (double **) malloc(maxrows*sizeof(double *));
+       sigma_omp_ws[i].sacc = (double **) malloc(maxrows*sizeof(double *));
+       sigma_omp_ws[i].ctransp = (double **) malloc(maxrows*sizeof(double *));
+       sigma_omp_ws[i].cprime[0] = init_array(bufsz);
+       sigma_omp_ws[i].sacc[0] = init_array(bufsz);
+       sigma_omp_ws[i].ctransp[0] = init_array(bufsz);
+       sigma_omp_ws[i].nthreads = 1;
+       sigma_omp_ws[i].timing = 0;
+     }
+
+     if (Parameters.print_lvl) {
+       outfile->Printf("\n   OpenMP sigma build on %d threads, %.1lf MB scratch\n",
+         sigma_omp_nthreads, (double) sigma_omp_nthreads * 
+         (3.0 * bufsz + 3.0 * max_dim) * sizeof(double) / 1.0E6);
+     }
+   }
+   #endif
  
    CalcInfo.sigma_initialized = 1;
 }
@@ -538,9 +625,29 @@ void sigma_b(struct stringwr **alplist, struct stringwr **betlist,
    if (!Parameters.Ms0) phase = 1;
    else phase = ((int) Parameters.S % 2) ? -1 : 1;
 
+   std::vector<struct sigma_task> tasks;
+   std::vector<int> did_omp(S.num_blocks, 0);
+
    S.zero(); 
    C.read(C.cur_vect, 0);
 
+   /* hand all contributing block pairs to the OpenMP sigma build */
+   if (sigma_omp_nthreads) {
+      for (sblock=0; sblock<S.num_blocks; sblock++) {
+         if (Parameters.cc && !cc_reqd_sblocks[sblock]) continue;
+         if (S.Ia_size[sblock]==0 || S.Ib_size[sblock]==0) continue;
+         if (S.Ms0 && S.Ib_code[sblock] > S.Ia_code[sblock]) continue;
+         for (cblock=0; cblock<C.num_blocks; cblock++) {
+            if (C.check_zero_block(cblock)) continue;
+            if (s1_contrib[sblock][cblock] || s2_contrib[sblock][cblock] ||
+                s3_contrib[sblock][cblock]) 
+               sigma_omp_add(C, S, tasks, sblock, cblock, 0);
+            }
+         }
+      sigma_omp_run(alplist, betlist, C, S, oei, tei, fci, tasks, 
+         &(did_omp[0]));
+      }
+
    /* loop over unique sigma subblocks */ 
    for (sblock=0; sblock<S.num_blocks; sblock++) {
       if (Parameters.cc && !cc_reqd_sblocks[sblock]) continue;
@@ -554,7 +661,9 @@ void sigma_b(struct stringwr **alplist, struct stringwr **betlist,
       sbirr = sbc / BetaG->subgr_per_irrep;
       if (sprime != NULL) set_row_ptrs(nas, nbs, sprime);
 
-      for (cblock=0; cblock<C.num_blocks; cblock++) {
+      if (sigma_omp_nthreads) did_sblock = did_omp[sblock];
+
+      for (cblock=0; cblock<C.num_blocks && !sigma_omp_nthreads; cblock++) {
          if (C.check_zero_block(cblock)) continue;
          cac = C.Ia_code[cblock];
          cbc = C.Ib_code[cblock];
@@ -622,6 +731,8 @@ void sigma_c(struct stringwr **alplist, struct stringwr **betlist,
    int cac, cbc, cnas, cnbs;
    int did_sblock = 0;
    int phase;
+   std::vector<struct sigma_task> tasks;
+   std::vector<int> did_omp(S.num_blocks, 0);
 
    if (!Parameters.Ms0) phase = 1;
    else phase = ((int) Parameters.S % 2) ? -1 : 1;
@@ -636,6 +747,38 @@ void sigma_c(struct stringwr **alplist, struct stringwr **betlist,
          cairr = C.buf2blk[cbuf];
          cbirr = cairr ^ CalcInfo.ref_sym;
 
+         /* hand the block pairs of this buffer to the OpenMP sigma build */
+         if (sigma_omp_nthreads) {
+            tasks.clear();
+            for (sblock=S.first_ablk[sairr];sblock<=S.last_ablk[sairr];
+                  sblock++) {
+               if (S.Ms0 && (S.Ia_code[sblock] < S.Ib_code[sblock])) continue;
+               for (cblock=C.first_ablk[cairr]; cblock<=C.last_ablk[cairr];
+                     cblock++) {
+                  if ((s1_contrib[sblock][cblock] || 
+                       s2_contrib[sblock][cblock] ||
+                       s3_contrib[sblock][cblock]) && 
+                       !C.check_zero_block(cblock))
+                     sigma_omp_add(C, S, tasks, sblock, cblock, 0);
+                  if (C.buf_offdiag[cbuf]) {
+                     cblock2 = C.decode[C.Ib_code[cblock]][C.Ia_code[cblock]];
+                     if ((s1_contrib[sblock][cblock2] || 
+                          s2_contrib[sblock][cblock2] ||
+                          s3_contrib[sblock][cblock2]) &&
+                         !C.check_zero_block(cblock2))
+                        sigma_omp_add(C, S, tasks, sblock, cblock, 1);
+                     }
+                  }
+               }
+            std::fill(did_omp.begin(), did_omp.end(), 0);
+            sigma_omp_run(alplist, betlist, C, S, oei, tei, fci, tasks,
+               &(did_omp[0]));
+            for (sblock=S.first_ablk[sairr];sblock<=S.last_ablk[sairr];
+                  sblock++) 
+               if (did_omp[sblock]) S.set_zero_block(sblock, 0);
+            continue;
+            }
+
          for (sblock=S.first_ablk[sairr];sblock<=S.last_ablk[sairr];sblock++){
             sac = S.Ia_code[sblock];
             sbc = S.Ib_code[sblock];
@@ -725,15 +868,52 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
       int cac, int cbc, int cnas, int cnbs, int cnac, int cnbc, 
       int sbirr, int cbirr, int Ms0)
 {
+   struct sigma_scratch ws;
+
+   ws.F = F;
+#ifndef OLD_CDS_ALG
+   ws.V = V; ws.Sgn = Sgn; ws.L = L; ws.R = R;
+#else
+   ws.V = NULL; ws.Sgn = NULL; ws.L = NULL; ws.R = NULL;
+#endif
+   ws.cprime = cprime;
+   ws.sacc = NULL;
+   ws.ctransp = NULL;
+   ws.nthreads = Parameters.nthreads;
+   ws.timing = 1;
+
+   sigma_block_ws(alplist, betlist, cmat, smat, oei, tei, fci, cblock,
+      sblock, nas, nbs, sac, sbc, cac, cbc, cnas, cnbs, cnac, cnbc,
+      sbirr, cbirr, Ms0, &ws);
+}
+
+
+/*
+** sigma_block_ws()
+**
+** As sigma_block(), with the scratch arrays and thread count taken
+** from ws instead of the module globals
+**
+*/
+void sigma_block_ws(struct stringwr **alplist, struct stringwr **betlist,
+      double **cmat, double **smat, double *oei, double *tei, int fci, 
+      int cblock, int sblock, int nas, int nbs, int sac, int sbc, 
+      int cac, int cbc, int cnas, int cnbs, int cnac, int cnbc, 
+      int sbirr, int cbirr, int Ms0, struct sigma_scratch *ws)
+{
+   double *F = ws->F, *V = ws->V, *Sgn = ws->Sgn;
+   int *L = ws->L, *R = ws->R;
+   double **cprime = ws->cprime;
+   int nthreads = ws->nthreads;
 
    /* SIGMA2 CONTRIBUTION */
   if (s2_contrib[sblock][cblock]) {
 
-    detci_time.s2_before_time = wall_time_new();
+    if (ws->timing) detci_time.s2_before_time = wall_time_new();
 
 #ifndef OLD_CDS_ALG
       if (fci) {
-          if (Parameters.nthreads > 1)
+          if (nthreads > 1)
               s2_block_vfci_thread(alplist, betlist, cmat, smat, oei, tei, F, 
                  cnac, nas, nbs, sac, cac, cnas);
           else
@@ -746,7 +926,7 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
                                  Toccs, cmat, smat, oei, tei, F, cnac, 
                                  nas, nbs, sac, cac, cnas);
             }
-          else if (Parameters.nthreads > 1) {
+          else if (nthreads > 1) {
             s2_block_vras_thread(alplist, betlist, cmat, smat, 
                             oei, tei, F, cnac, nas, nbs, sac, cac, cnas);  
             }
@@ -772,8 +952,10 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
             }
         }
 #endif
-    detci_time.s2_after_time = wall_time_new();
-    detci_time.s2_total_time += detci_time.s2_after_time - detci_time.s2_before_time;
+    if (ws->timing) {
+      detci_time.s2_after_time = wall_time_new();
+      detci_time.s2_total_time += detci_time.s2_after_time - detci_time.s2_before_time;
+    }
 
     } /* end sigma2 */
 
@@ -786,12 +968,12 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
 
    /* SIGMA1 CONTRIBUTION */
    if (!Ms0 || (sac != sbc)) {
-    detci_time.s1_before_time = wall_time_new();
+    if (ws->timing) detci_time.s1_before_time = wall_time_new();
 
       if (s1_contrib[sblock][cblock]) {
          #ifndef OLD_CDS_ALG
           if (fci) { 
-              if (Parameters.nthreads > 1)
+              if (nthreads > 1)
                   s1_block_vfci_thread(alplist, betlist, cmat, smat, oei, tei, F, cnbc,
                                        nas, nbs, sbc, cbc, cnbs);
               else
@@ -804,7 +986,7 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
                   Toccs, cmat, smat, oei, tei, F, cnbc, nas, nbs,
                   sbc, cbc, cnbs);
                }
-            else if (Parameters.nthreads > 1) {
+            else if (nthreads > 1) {
                s1_block_vras_thread(alplist, betlist, cmat, smat, oei, tei, F, cnbc, 
                   nas, nbs, sbc, cbc, cnbs);
               }
@@ -831,8 +1013,10 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
             } 
          #endif
          }
-          detci_time.s1_after_time = wall_time_new();
-          detci_time.s1_total_time += detci_time.s1_after_time - detci_time.s1_before_time;
+          if (ws->timing) {
+            detci_time.s1_after_time = wall_time_new();
+            detci_time.s1_total_time += detci_time.s1_after_time - detci_time.s1_before_time;
+          }
 
       } /* end sigma1 */
 
@@ -844,7 +1028,7 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
 
    /* SIGMA3 CONTRIBUTION */
    if (s3_contrib[sblock][cblock]) {
-      detci_time.s3_before_time = wall_time_new();
+      if (ws->timing) detci_time.s3_before_time = wall_time_new();
 
       /* zero_mat(smat, nas, nbs); */
 
@@ -865,7 +1049,7 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
          #ifndef OLD_CDS_ALG
             s3_block_v(alplist[sac], betlist[sbc], cmat, smat, tei,
                nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr, 
-               cprime, F, V, Sgn, L, R);
+               cprime, F, V, Sgn, L, R, nthreads);
          #else
             s3_block(alplist[sac], betlist[sbc], cmat, smat, 
                tei, nas, nbs, cac, cbc);
@@ -897,7 +1081,7 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
             #ifndef OLD_CDS_ALG
             s3_block_vdiag(alplist[sac], betlist[sbc], cmat, smat, tei,
                nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr, 
-               cprime, F, V, Sgn, L, R);
+               cprime, F, V, Sgn, L, R, nthreads);
             #else
             s3_block_diag(alplist[sac], betlist[sbc], cmat, smat, tei, 
                nas, nbs, cac, cbc);
@@ -911,13 +1095,123 @@ void sigma_block(struct stringwr **alplist, struct stringwr **betlist,
         print_mat(smat, nas, nbs, "outfile");
       }
       
-      detci_time.s3_after_time = wall_time_new();
-      detci_time.s3_total_time += 
-         detci_time.s3_after_time - detci_time.s3_before_time;
+      if (ws->timing) {
+        detci_time.s3_after_time = wall_time_new();
+        detci_time.s3_total_time += 
+           detci_time.s3_after_time - detci_time.s3_before_time;
+      }
 
       } /* end sigma3 */
 }
  
 
+
+/*
+** sigma_omp_add()
+**
+** Queue the contribution to sigma block sblock from C block cblock for
+** the OpenMP sigma build.  With transp set, the contribution comes
+** from the Ms=0 partner of cblock, obtained by transposing cblock.
+**
+*/
+void sigma_omp_add(CIvect &C, CIvect &S, std::vector<struct sigma_task> &tasks,
+      int sblock, int cblock, int transp)
+{
+   struct sigma_task task;
+
+   task.sblock = sblock;
+   task.cblock = cblock;
+   task.transp = transp;
+   task.cost = (double) S.Ia_size[sblock] * (double) S.Ib_size[sblock] *
+      (double) (C.Ia_size[cblock] + C.Ib_size[cblock]);
+   tasks.push_back(task);
+}
+
+
+static bool sigma_task_more_expensive(const struct sigma_task &a,
+      const struct sigma_task &b)
+{
+   return (a.cost > b.cost);
+}
+
+
+/*
+** sigma_omp_run()
+**
+** Compute the queued (sigma block, C block) contributions on
+** sigma_omp_nthreads OpenMP threads, largest first.  A sigma block fed
+** by a single pair is built in place; otherwise each pair is built in
+** the thread's own accumulator and added to S under a lock on that
+** sigma block.  did_sblock[sblock] is set for every block touched.
+**
+*/
+void sigma_omp_run(struct stringwr **alplist, struct stringwr **betlist,
+      CIvect &C, CIvect &S, double *oei, double *tei, int fci,
+      std::vector<struct sigma_task> &tasks, int *did_sblock)
+{
+#ifdef _OPENMP
+   int t, i, ntasks;
+   std::vector<int> npairs(S.num_blocks, 0);
+   std::vector<omp_lock_t> locks(S.num_blocks);
+   double before_time = wall_time_new();
+
+   ntasks = tasks.size();
+   if (!ntasks) return;
+
+   std::stable_sort(tasks.begin(), tasks.end(), sigma_task_more_expensive);
+   for (t=0; t<ntasks; t++) {
+      npairs[tasks[t].sblock]++;
+      did_sblock[tasks[t].sblock] = 1;
+      }
+   for (i=0; i<S.num_blocks; i++) omp_init_lock(&locks[i]);
+
+   #pragma omp parallel for schedule(dynamic,1) num_threads(sigma_omp_nthreads)
+   for (t=0; t<ntasks; t++) {
+      struct sigma_scratch *ws = &sigma_omp_ws[omp_get_thread_num()];
+      int sblock = tasks[t].sblock, cblock = tasks[t].cblock;
+      int sac = S.Ia_code[sblock], sbc = S.Ib_code[sblock];
+      int nas = S.Ia_size[sblock], nbs = S.Ib_size[sblock];
+      int sbirr = sbc / BetaG->subgr_per_irrep;
+      int cac = C.Ia_code[cblock], cbc = C.Ib_code[cblock];
+      int cnas = C.Ia_size[cblock], cnbs = C.Ib_size[cblock];
+      int cbirr = cbc / BetaG->subgr_per_irrep;
+      double **cmat = C.blocks[cblock], **smat;
+      int r;
+
+      if (tasks[t].transp) {
+         C.transp_block(cblock, ws->ctransp);
+         cmat = ws->ctransp;
+         cblock = C.decode[cbc][cac];
+         cbirr = cac / AlphaG->subgr_per_irrep;
+         std::swap(cac, cbc);
+         std::swap(cnas, cnbs);
+         }
+      set_row_ptrs(cnas, cnbs, ws->cprime);
+
+      if (npairs[sblock] == 1) smat = S.blocks[sblock];
+      else {
+         set_row_ptrs(nas, nbs, ws->sacc);
+         zero_arr(ws->sacc[0], nas * nbs);
+         smat = ws->sacc;
+         }
+
+      sigma_block_ws(alplist, betlist, cmat, smat, oei, tei, fci, cblock,
+         sblock, nas, nbs, sac, sbc, cac, cbc, cnas, cnbs, C.num_alpcodes,
+         C.num_betcodes, sbirr, cbirr, S.Ms0, ws);
+
+      if (npairs[sblock] > 1) {
+         omp_set_lock(&locks[sblock]);
+         for (r=0; r<nas; r++) 
+            C_DAXPY(nbs, 1.0, smat[r], 1, S.blocks[sblock][r], 1);
+         omp_unset_lock(&locks[sblock]);
+         }
+      }
+
+   for (i=0; i<S.num_blocks; i++) omp_destroy_lock(&locks[i]);
+
+   detci_time.sigma_omp_total_time += wall_time_new() - before_time;
+#endif
+}
+
 }} // namespace psi::detci
 
@@ -521,6 +521,10 @@ struct params {
                               command line or the DETCASMAN driver? */
    double special_conv;    /* special convergence value */
    int nthreads;           /* number of threads to use in sigma routines */
+   int sigma_omp;          /* 1 to run independent sigma block pairs
+                              concurrently on OpenMP threads */
+   int prefetch_bufs;      /* number of CI vector buffers kept in flight
+                              ahead of the one being read (0 = none) */
    int export_ci_vector;   /* 1 if export the CI vector with string info,
                               useful for BODC */
    int num_export;         /* number of vectors to export */
@@ -814,12 +818,16 @@ struct detci_timings {
    double s3_mt_before_time;
    double s3_mt_after_time;
    double s3_mt_total_time;
+   double sigma_omp_total_time;
    double read_total_time;
    double read_before_time;
    double read_after_time;
    double write_total_time;
    double write_after_time;
    double write_before_time;
+   double aio_wait_total_time;
+   int prefetch_hits;
+   int prefetch_misses;
    double Hd_total_time;
    double Hd_before_time;
    double Hd_after_time;
@@ -49,8 +49,11 @@ init_time_new(struct detci_timings time)
  time.s1_total_time = time.s1_before_time = time.s1_after_time = 0.0;
  time.s2_total_time = time.s2_before_time = time.s2_after_time = 0.0;
  time.s3_total_time = time.s3_before_time = time.s3_after_time = 0.0;
+ time.sigma_omp_total_time = 0.0;
  time.write_total_time = time.write_after_time = time.write_before_time = 0.0;
  time.read_total_time = time.read_after_time = time.read_before_time = 0.0;
+ time.aio_wait_total_time = 0.0;
+ time.prefetch_hits = time.prefetch_misses = 0;
  time.Hd_total_time = time.Hd_before_time = time.Hd_after_time = 0.0;
  time.total_before_time = time.total_after_time = 0.0;
 }
@@ -63,12 +66,17 @@ print_time_new(struct detci_timings time)
   outfile->Printf(" -----------------------------------------------------\n");
   outfile->Printf(" Read      %lf\n", time.read_total_time);
   outfile->Printf(" Write     %lf\n", time.write_total_time);
+  outfile->Printf(" AIO Wait  %lf\n", time.aio_wait_total_time);
+  if (time.prefetch_hits + time.prefetch_misses)
+    outfile->Printf(" Prefetch  %d of %d buffer reads staged\n",
+      time.prefetch_hits, time.prefetch_hits + time.prefetch_misses);
   outfile->Printf(" Sigma1    %lf\n", time.s1_total_time);
   outfile->Printf(" Sigma2    %lf\n", time.s2_total_time);
   outfile->Printf(" Sigma3    %lf\n", time.s3_total_time);
   outfile->Printf(" S1 Thread %lf\n", time.s1_mt_total_time);
   outfile->Printf(" S2 Thread %lf\n", time.s2_mt_total_time);
   outfile->Printf(" S3 Thread %lf\n", time.s3_mt_total_time);
+  outfile->Printf(" Sigma OMP %lf\n", time.sigma_omp_total_time);
   outfile->Printf("\n");
 }
 
@@ -503,8 +503,8 @@ void tpdm(struct stringwr **alplist, struct stringwr **betlist,
    free(twopdm_aa);
    free(twopdm_bb);
    free(twopdm_ab);
-   if (transp_tmp != NULL) free_block(transp_tmp);
-   if (transp_tmp2 != NULL) free_block(transp_tmp2);
+   if (transp_tmp != NULL) { free(transp_tmp[0]); free(transp_tmp); }
+   if (transp_tmp2 != NULL) { free(transp_tmp2[0]); free(transp_tmp2); }
    free(buffer1);
    free(buffer2);
 }
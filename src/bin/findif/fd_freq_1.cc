@@ -369,7 +369,7 @@ PsiReturnType fd_freq_1(Options &options, const boost::python::list& grad_list,
     }
 
   for (int h=0; h<Nirrep; ++h)
-    if (salcs_pi[h].size()) free_block(H_irr[h]);
+    if (salcs_pi[h].size()) free_matrix(H_irr[h], salcs_pi[h].size());
 
   // Transform Hessian into cartesian coordinates
   if (print_lvl >= 3) {
@@ -22,6 +22,8 @@
 
 #include <boost/python.hpp>
 #include <libmints/benchmark.h>
+#include <libfock/jk.h>
+#include <libfunctional/functional.h>
 
 using namespace boost::python;
 
@@ -31,6 +33,10 @@ void export_benchmarks()
     def("benchmark_blas2",     &psi::benchmark_blas2, "docstring");
     def("benchmark_blas3",     &psi::benchmark_blas3, "docstring");
     def("benchmark_disk",      &psi::benchmark_disk, "docstring");
+    def("benchmark_aio",       &psi::benchmark_aio, "docstring");
     def("benchmark_math",      &psi::benchmark_math, "docstring");
     def("benchmark_integrals", &psi::benchmark_integrals, "docstring");
+    def("benchmark_boys",      &psi::benchmark_boys, "docstring");
+    def("benchmark_directjk",  &psi::benchmark_directjk, "docstring");
+    def("benchmark_functionals", &psi::benchmark_functionals, "docstring");
 }
@@ -38,6 +38,13 @@ void export_psio()
         def( "tocclean", &PSIO::tocclean, "docstring" ).
         def( "tocprint", &PSIO::tocprint, "docstring" ).
         def( "tocwrite", &PSIO::tocwrite, "docstring" ).
+        def( "toc_lookups", &PSIO::toc_lookups, "Number of keyed TOC lookups so far" ).
+        def( "toc_lookup_time", &PSIO::toc_lookup_time, "Wall time spent in keyed TOC lookups so far [s]" ).
+        def( "reset_toc_stats", &PSIO::reset_toc_stats, "Zero the TOC lookup counters" ).
+        def( "print_toc_stats", &PSIO::print_toc_stats, "Print the TOC lookup counters" ).
+        def( "set_memory_budget", &PSIO::set_memory_budget, "Keep a unit (-1 for all) in core with this many bytes of pages before spilling to disk (0 for disk only)" ).
+        def( "get_memory_budget", &PSIO::get_memory_budget, "In-core byte budget a unit will be opened with" ).
+        def( "pagecache_spills", &PSIO::pagecache_spills, "Dirty pages written back to disk to stay within a memory budget so far" ).
         def( "shared_object", &PSIO::shared_object).
         def( "set_pid", &PSIO::set_pid, "docstring" ).
         staticmethod("shared_object").
@@ -46,7 +53,11 @@ void export_psio()
         def( "set_default_namespace", &PSIO::set_default_namespace, "docstring").
         staticmethod("set_default_namespace").
         def( "change_file_namespace", &PSIO::change_file_namespace, "docstring").
-        staticmethod("change_file_namespace");
+        staticmethod("change_file_namespace").
+        def( "set_rw_mode", &PSIO::set_rw_mode, "Set the transfer path: 0 lseek + per-page read/write, 1 pread/pwrite per volume, 2 as 1 with O_DIRECT for large requests").
+        staticmethod("set_rw_mode").
+        def( "get_rw_mode", &PSIO::get_rw_mode, "Get the transfer path").
+        staticmethod("get_rw_mode");
 
     class_<PSIOManager, boost::shared_ptr<PSIOManager> >( "IOManager", "docstring" ).
         def( "shared_object", &PSIOManager::shared_object, "docstring" ).
@@ -131,6 +131,9 @@ int main(int argc, char **argv)
     // There is only one timer:
     timer_done();
 
+    // Peak memory held by tracked matrices over the whole job
+    arena_print_report();
+
     psi_stop(infile, "outfile", psi_file_prefix);
     Script::language->finalize();
 
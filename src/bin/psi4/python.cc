@@ -37,6 +37,7 @@
 #include <map>
 #include <iomanip>
 
+#include <libciomr/libciomr.h>
 #include <libefp_solver/efp_solver.h>
 #include <libmints/mints.h>
 #include <libplugin/plugin.h>
@@ -45,6 +46,7 @@
 #include <liboptions/liboptions.h>
 #include <liboptions/liboptions_python.h>
 #include <libpsi4util/libpsi4util.h>
+#include <libiwl/iwl.hpp>
 #include <psiconfig.h>
 
 #include <psi4-dec.h>
@@ -227,6 +229,22 @@ void py_psi_prepare_options_for_module(std::string const& name)
     }
     // Now we've read in the defaults, make sure that user-specified options are recognized by the current module
     Process::environment.options.validate_options();
+
+    // Encoding for any IWL integral files this module writes
+    std::string iwl_format = Process::environment.options.get_str("IWL_FORMAT");
+    IWL::set_default_format(iwl_format == "QUANTIZED" ? IWL_FORMAT_QUANTIZED :
+                            iwl_format == "PACKED" ? IWL_FORMAT_PACKED : IWL_FORMAT_PLAIN,
+                            Process::environment.options.get_double("IWL_PRECISION"));
+
+    // In-core budget of the scratch files, unless left to psi4.IO calls
+    if (Process::environment.options["PSIO_MEMORY"].has_changed())
+        PSIO::shared_object()->set_memory_budget(-1,
+            (ULI) Process::environment.options.get_int("PSIO_MEMORY") * 1024L * 1024L);
+
+    // Placement policy for tracked matrix blocks
+    arena_set_options(Process::environment.options.get_bool("MEMORY_HUGE_PAGES"),
+                      Process::environment.options.get_bool("MEMORY_FIRST_TOUCH"),
+                      Process::environment.options.get_bool("MEMORY_BLOCK_CACHE"));
 }
 
 int py_psi_stability()
@@ -1236,6 +1254,7 @@ void py_psi_clean_variable_map()
 void py_psi_set_memory(unsigned long int mem)
 {
     Process::environment.set_memory(mem);
+    arena_set_budget(mem);
     outfile->Printf("\n  Memory set to %7.3f %s by Python script.\n", (mem > 1000000000 ? mem / 1.0E9 : mem / 1.0E6), \
         (mem > 1000000000 ? "GiB" : "MiB"));
 }
@@ -1245,6 +1264,21 @@ unsigned long int py_psi_get_memory()
     return Process::environment.get_memory();
 }
 
+unsigned long int py_psi_get_memory_remaining()
+{
+    return arena_remaining();
+}
+
+unsigned long int py_psi_get_memory_high_water()
+{
+    return arena_high_water();
+}
+
+unsigned long int py_psi_get_memory_reused_blocks()
+{
+    return arena_reused();
+}
+
 void py_psi_set_n_threads(int nthread)
 {
     Process::environment.set_n_threads(nthread);
@@ -1499,6 +1533,9 @@ BOOST_PYTHON_MODULE (psi4)
         "Assigns the global normalmodes to the values stored in a Vector argument.");
     def("set_memory", py_psi_set_memory, "Sets the memory available to Psi (in bytes).");
     def("get_memory", py_psi_get_memory, "Returns the amount of memory available to Psi (in bytes).");
+    def("get_memory_remaining", py_psi_get_memory_remaining, "Returns the part of the memory setting not held by tracked matrices (in bytes).");
+    def("get_memory_high_water", py_psi_get_memory_high_water, "Returns the peak memory held by tracked matrices so far in this job (in bytes).");
+    def("get_memory_reused_blocks", py_psi_get_memory_reused_blocks, "Returns how many tracked matrix allocations were served from freed blocks.");
     def("set_nthread", &py_psi_set_n_threads, "Sets the number of threads to use in SMP parallel computations.");
     def("nthread", &py_psi_get_n_threads, "Returns the number of threads to use in SMP parallel computations.");
 //    def("mol_from_file",&LibBabel::ParseFile,"Reads a molecule from another input file");
@@ -136,6 +136,31 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   options.add_bool("DIE_IF_NOT_CONVERGED", true);
   /*- Integral package to use. If compiled with ERD support, ERD is used where possible; LibInt is used otherwise. -*/
   options.add_str("INTEGRAL_PACKAGE", "ERD", "ERD LIBINT");
+  /*- Encoding of the IWL integral files (SO and MO two-electron integrals)
+  written by the conventional-integral codes. ``PACKED`` delta-encodes the
+  labels and compresses the values losslessly; ``QUANTIZED`` stores the
+  values rounded to |globals__iwl_precision|. Files are always read back
+  in the encoding they were written with. -*/
+  options.add_str("IWL_FORMAT", "PLAIN", "PLAIN PACKED QUANTIZED");
+  /*- Absolute precision of the integral values in ``QUANTIZED`` IWL files.
+  Zero uses the cutoff each file is written with. !expert -*/
+  options.add_double("IWL_PRECISION", 0.0);
+  /*- In-core budget [MiB] for each PSIO scratch file. Pages of a file are
+  kept in memory up to this size and the least recently used ones are
+  written out beyond it. Zero keeps every file on disk. Applies to files
+  opened after the next module starts. !expert -*/
+  options.add_int("PSIO_MEMORY", 0);
+  /*- Advise transparent huge pages for matrix blocks of 2 MiB or more.
+  Reduces TLB misses in large contractions at the cost of some memory
+  granularity. !expert -*/
+  options.add_bool("MEMORY_HUGE_PAGES", false);
+  /*- Zero large new matrix blocks from all threads so that each page is
+  placed on the NUMA node of the thread that touches it first. !expert -*/
+  options.add_bool("MEMORY_FIRST_TOUCH", true);
+  /*- Keep freed matrix blocks for reuse by later allocations of the same
+  size, e.g. the Fock and density temporaries of each SCF iteration.
+  At most an eighth of |globals__memory| is held this way. !expert -*/
+  options.add_bool("MEMORY_BLOCK_CACHE", true);
 
   // Note that case-insensitive options are only functional as
   //   globals, not as module-level, and should be defined sparingly
@@ -156,6 +181,11 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   options.add_str("DF_BASIS_CC", "");
   /*- Assume external fields are arranged so that they have symmetry. It is up to the user to know what to do here. The code does NOT help you out in any way! !expert -*/
   options.add_bool("EXTERNAL_POTENTIAL_SYMMETRY", false);
+  /*- Do divide fields of 256 or more point charges or multipoles (nuclei,
+  external charges, EFP fragments, PCM tesserae, ESP grid points) into cells,
+  and use the multipole expansion of distant cells in the potential integrals?
+  Turn off to sum over every site. !expert -*/
+  options.add_bool("POTENTIAL_INTS_SCREENING", true);
   /*- Text to be passed directly into CFOUR input files. May contain
   molecule, options, percent blocks, etc. Access through ``cfour {...}``
   block. -*/
@@ -199,6 +229,11 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   options.add("CUBEPROP_ORBITALS", new ArrayType());
   /*- List of desired basis function indices (1-based). All basis functions computed if empty.-*/
   options.add("CUBEPROP_BASIS_FUNCTIONS", new ArrayType());
+  /*- Format of the grid files written by cubeprop: Gaussian cube text (CUBE, .cube)
+      or raw doubles behind a short binary header (BCUBE, .bcube). -*/
+  options.add_str("CUBEPROP_FORMAT", "CUBE", "CUBE BCUBE");
+  /*- Do gzip the grid files written by cubeprop (adds .gz, needs PSI4 built with zlib)? -*/
+  options.add_bool("CUBEPROP_COMPRESS", false);
 
   /*- CubicScalarGrid basis cutoff. !expert -*/
   options.add_double("CUBIC_BASIS_TOLERANCE", 1.0E-12);
@@ -286,6 +321,16 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     /*- Number of threads for DETCI. -*/
     options.add_int("CI_NUM_THREADS", 1);
 
+    /*- Do compute independent sigma block pairs concurrently on OpenMP
+    threads when |detci__ci_num_threads| > 1 and the CI vector blocks
+    of a whole vector or irrep are in core? -*/
+    options.add_bool("SIGMA_OMP", true);
+
+    /*- Number of CI vector buffers to read ahead asynchronously when
+    |detci__icore| is 0 or 2. Each costs one buffer of memory; 0 reads
+    each buffer when it is needed. -*/
+    options.add_int("CI_PREFETCH_BUFFERS", 0);
+
     /*- Do print the sigma overlap matrix?  Not generally useful.  !expert -*/
     options.add_bool("SIGMA_OVERLAP", false);
 
@@ -1391,6 +1436,30 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("DF_BUMP_R0", 0.0);
     /*- Bump function max radius -*/
     options.add_double("DF_BUMP_R1", 0.0);
+    /*- FastDF exchange skips the atom pairs of an atom whose occupied orbital
+    coefficients all fall below this -*/
+    options.add_double("DF_OCC_CUTOFF", 1.0E-8);
+
+    /*- SUBSECTION Direct SCF Algorithm -*/
+
+    /*- How threads accumulate J/K contributions in |scf__scf_type| DIRECT.
+    PRIVATE keeps a full copy of J/K per thread and reduces them at the end,
+    BLOCKED locks blocks of rows, ATOMIC uses per-element atomics. AUTO
+    chooses PRIVATE if the copies fit in memory and BLOCKED otherwise. !expert -*/
+    options.add_str("DIRECT_JK_ACCUMULATION", "AUTO", "AUTO PRIVATE BLOCKED ATOMIC");
+    /*- How shell quartets are handed out to threads in |scf__scf_type| DIRECT.
+    SORTED groups the shell pairs by angular momentum class, sorts them by
+    Schwarz bound, and screens quartets against the density; it accumulates
+    with ATOMIC in place of BLOCKED. TASK uses atom-blocked pairs of shell
+    pairs. !expert -*/
+    options.add_str("DIRECT_JK_SCHEDULER", "SORTED", "SORTED TASK");
+
+    /*- Do build the Fock matrix incrementally from the change in the density
+    between iterations? Only used by |scf__scf_type| DIRECT. -*/
+    options.add_bool("INCFOCK", false);
+    /*- Frequency with which a full Fock matrix is rebuilt when |scf__incfock|
+    is on, to limit the accumulation of screening errors -*/
+    options.add_int("INCFOCK_FULL_FOCK_EVERY", 10);
 
     /*- SUBSECTION SAD Guess Algorithm -*/
 
@@ -1450,6 +1519,12 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("DFT_BLOCK_MAX_RADIUS",3.0);
     /*- The blocking scheme for DFT. !expert -*/
     options.add_str("DFT_BLOCK_SCHEME","OCTREE","NAIVE OCTREE");
+    /*- Keep the basis function values on each grid block between SCF iterations?
+    MEMORY stores them in core, MMAP in a memory-mapped scratch file. !expert -*/
+    options.add_str("DFT_BASIS_CACHE","NONE","NONE MEMORY MMAP");
+    /*- Budget for DFT_BASIS_CACHE [MiB]. Blocks beyond the budget are recomputed
+    every iteration. Zero uses a quarter of the job memory. !expert -*/
+    options.add_int("DFT_BASIS_CACHE_MEMORY",0);
     /*- Parameters defining the dispersion correction. See Table
     :ref:`-D Functionals <table:dft_disp>` for default values and Table
     :ref:`Dispersion Corrections <table:dashd>` for the order in which
@@ -2323,15 +2398,22 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     /*- The algorithm to use for the $\left<VV||VV\right>$ terms
     If AO_BASIS is ``NONE``, the MO-basis integrals will be used;
     if AO_BASIS is ``DISK``, the AO-basis integrals stored on disk will
-    be used; if AO_BASIS is ``DIRECT``, the AO-basis integrals will be computed
-    on the fly as necessary.  NB: The ``DIRECT`` option is not fully
-    implemented and should only be used by experts.  Default is NONE.
+    be used; if AO_BASIS is ``DIRECT``, the AO-basis integrals will be
+    recomputed on every iteration (threaded over CC_NUM_THREADS and
+    Schwarz-screened against the half-transformed amplitudes), so neither
+    the MO- nor the AO-basis four-virtual-index integrals are stored.
+    Default is NONE.
     Note: The developers recommend use of this keyword only as a last
     resort because it significantly slows the calculation. The current
     algorithms for handling the MO-basis four-virtual-index integrals have
     been significantly improved and are preferable to the AO-based approach.
     !expert -*/
     options.add_str("AO_BASIS", "NONE", "NONE DISK DIRECT");
+    /*- Minimum absolute value below which AO-basis integrals are neglected
+    in the AO_BASIS algorithms. For AO_BASIS = DIRECT, shell quartets whose
+    Schwarz bound times the largest amplitude they touch is below this value
+    are skipped. !expert -*/
+    options.add_double("INTS_TOLERANCE", 1e-14);
     /*- Cacheing level for libdpd governing the storage of amplitudes,
     integrals, and intermediates in the CC procedure. A value of 0 retains
     no quantities in cache, while a level of 6 attempts to store all
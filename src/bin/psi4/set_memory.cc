@@ -31,6 +31,7 @@
 #include <cstring>
 #include <libparallel/parallel.h>
 #include <psi4-dec.h>
+#include <libciomr/libciomr.h>
 
 namespace psi {
 
@@ -50,6 +51,7 @@ void set_memory(std::string OutFileRMR)
     }
 
     Process::environment.set_memory(maxcrr);
+    arena_set_budget(maxcrr);
 
     return;
 }
@@ -4,6 +4,7 @@
 #include <libchkpt/config.h>
 #include <string>
 #include <string.h>
+#include <libciomr/libciomr.h>
 
 namespace boost {
 template <class T>
@@ -362,6 +363,16 @@ namespace psi {
         }
     };
 
+    /// Double matrices are handed to callers that release them with
+    /// free_block(), so they come from block_matrix() like everyone else's
+    template <> inline double** Chkpt::matrix<double>(int nrow, int ncol) {
+        if (nrow == 0 || ncol == 0) return NULL;
+        return block_matrix(nrow, ncol);
+    }
+    template <> inline void Chkpt::free<double>(double** Block) {
+        free_block(Block);
+    }
+
 }
 
 #endif
@@ -0,0 +1,361 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+
+/*!
+\file
+\brief Tracked, aligned allocator for the data blocks of dense matrices
+\ingroup CIOMR
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <boost/thread/mutex.hpp>
+#include <psifiles.h>
+#include "psi4-dec.h"
+#include "libciomr.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+namespace {
+
+/// Alignment of every block handed out (one cache line, one AVX-512 vector)
+const size_t ARENA_ALIGN = 64;
+/// Size of the bookkeeping header in front of each block (keeps ARENA_ALIGN)
+const size_t ARENA_HEADER = 64;
+/// Transparent huge page size assumed for madvise and alignment
+const size_t ARENA_HUGE_PAGE = 2UL * 1024UL * 1024UL;
+/// Blocks smaller than this go straight back to the system on free
+const size_t ARENA_CACHE_MIN = 32UL * 1024UL;
+/// At most this many idle blocks of one size are kept
+const size_t ARENA_CACHE_DEPTH = 8;
+/// Blocks at least this large are zeroed by all threads (first touch)
+const size_t ARENA_FIRST_TOUCH_MIN = 1024UL * 1024UL;
+/// Marks a live arena block, to catch frees of foreign pointers
+const size_t ARENA_MAGIC = 0x5053494172656e61UL;
+
+struct ArenaHeader {
+    size_t bytes;  // usable bytes, rounded up to ARENA_ALIGN
+    size_t magic;
+};
+
+struct ArenaState {
+    boost::mutex lock;
+    size_t budget;
+    size_t in_use;
+    size_t high_water;
+    size_t cached;
+    size_t nalloc;
+    size_t nreuse;
+    bool huge_pages;
+    bool first_touch;
+    bool cache;
+    std::map<size_t, std::vector<char*> > idle;
+
+    ArenaState() : budget(0), in_use(0), high_water(0), cached(0), nalloc(0), nreuse(0),
+        huge_pages(false), first_touch(true), cache(true) {}
+};
+
+ArenaState& state()
+{
+    static ArenaState s;
+    return s;
+}
+
+size_t round_up(size_t n, size_t align)
+{
+    return (n + align - 1) / align * align;
+}
+
+ArenaHeader* header_of(void* p)
+{
+    return reinterpret_cast<ArenaHeader*>(static_cast<char*>(p) - ARENA_HEADER);
+}
+
+/// Idle blocks are allowed to occupy at most an eighth of the budget
+size_t cache_limit(const ArenaState& s)
+{
+    return s.budget / 8;
+}
+
+/// Returns every idle block to the system; caller holds the lock
+void trim_locked(ArenaState& s)
+{
+    for (std::map<size_t, std::vector<char*> >::iterator it = s.idle.begin(); it != s.idle.end(); ++it) {
+        for (size_t i = 0; i < it->second.size(); ++i)
+            ::free(it->second[i]);
+    }
+    s.idle.clear();
+    s.cached = 0;
+}
+
+char* system_block(size_t bytes, bool huge)
+{
+    void* base = NULL;
+    size_t total = ARENA_HEADER + bytes;
+    if (huge) {
+        total = round_up(total, ARENA_HUGE_PAGE);
+        if (posix_memalign(&base, ARENA_HUGE_PAGE, total)) return NULL;
+#ifdef MADV_HUGEPAGE
+        // Advisory only: kernels without THP simply ignore the hint
+        madvise(base, total, MADV_HUGEPAGE);
+#endif
+    } else {
+        if (posix_memalign(&base, ARENA_ALIGN, total)) return NULL;
+    }
+    return static_cast<char*>(base);
+}
+
+}
+
+/*!
+** arena_malloc(): Allocate a tracked block of memory aligned to 64 bytes
+**
+** The block is counted against the job-wide budget set by
+** arena_set_budget().  Freed blocks of the same size are recycled, so
+** matrices that are rebuilt every SCF iteration do not go back to the
+** system allocator each time.  Exceeding the budget is not fatal; it
+** shows up in the high-water mark reported by arena_print_report().
+**
+** \param bytes = number of bytes requested
+** \param zero  = zero the block; large fresh blocks are zeroed by all
+**                OpenMP threads so their pages land on the NUMA node of
+**                the thread that will later use them (static schedule)
+**
+** Returns: pointer to the block, or NULL if bytes is 0
+** \ingroup CIOMR
+*/
+void* arena_malloc(size_t bytes, bool zero)
+{
+    if (!bytes) return NULL;
+
+    ArenaState& s = state();
+    size_t size = round_up(bytes, ARENA_ALIGN);
+    char* base = NULL;
+    bool fresh = true;
+    bool huge = false;
+
+    {
+        boost::mutex::scoped_lock guard(s.lock);
+        std::map<size_t, std::vector<char*> >::iterator it = s.idle.find(size);
+        if (it != s.idle.end() && !it->second.empty()) {
+            base = it->second.back();
+            it->second.pop_back();
+            s.cached -= size;
+            ++s.nreuse;
+            fresh = false;
+        } else if (s.budget && s.in_use + s.cached + size > s.budget) {
+            trim_locked(s);
+        }
+        s.in_use += size;
+        if (s.in_use > s.high_water) s.high_water = s.in_use;
+        ++s.nalloc;
+        huge = s.huge_pages && size >= ARENA_HUGE_PAGE;
+    }
+
+    if (fresh) {
+        base = system_block(size, huge);
+        if (base == NULL) {
+            outfile->Printf("arena_malloc: trouble allocating memory \n");
+            outfile->Printf("bytes = %zu\n", size);
+            exit(PSI_RETURN_FAILURE);
+        }
+        ArenaHeader* h = reinterpret_cast<ArenaHeader*>(base);
+        h->bytes = size;
+        h->magic = ARENA_MAGIC;
+    }
+
+    char* p = base + ARENA_HEADER;
+    if (zero) {
+#ifdef _OPENMP
+        if (fresh && s.first_touch && size >= ARENA_FIRST_TOUCH_MIN && omp_get_max_threads() > 1) {
+            // One contiguous chunk per thread, matching the static
+            // schedules used by the BLAS and by the threaded loops that
+            // sweep these blocks
+            long int nchunk = omp_get_max_threads();
+            size_t chunk = round_up((size + nchunk - 1) / nchunk, ARENA_ALIGN);
+            #pragma omp parallel for schedule(static)
+            for (long int c = 0; c < nchunk; ++c) {
+                size_t start = c * chunk;
+                if (start < size) {
+                    size_t len = (start + chunk > size ? size - start : chunk);
+                    ::memset(p + start, 0, len);
+                }
+            }
+        } else
+#endif
+        ::memset(p, 0, size);
+    }
+    return static_cast<void*>(p);
+}
+
+/*!
+** arena_free(): Release a block obtained from arena_malloc()
+**
+** Mid-sized and large blocks are kept for reuse while the idle pool is
+** below an eighth of the budget; everything else goes back to the system.
+**
+** \param ptr = block to free (NULL is ignored)
+** \ingroup CIOMR
+*/
+void arena_free(void* ptr)
+{
+    if (ptr == NULL) return;
+
+    ArenaHeader* h = header_of(ptr);
+    if (h->magic != ARENA_MAGIC) {
+        outfile->Printf("arena_free: pointer was not allocated by arena_malloc \n");
+        exit(PSI_RETURN_FAILURE);
+    }
+    size_t size = h->bytes;
+    char* base = reinterpret_cast<char*>(h);
+
+    ArenaState& s = state();
+    {
+        boost::mutex::scoped_lock guard(s.lock);
+        s.in_use -= size;
+        if (s.cache && size >= ARENA_CACHE_MIN && s.cached + size <= cache_limit(s)) {
+            std::vector<char*>& pool = s.idle[size];
+            if (pool.size() < ARENA_CACHE_DEPTH) {
+                pool.push_back(base);
+                s.cached += size;
+                return;
+            }
+        }
+    }
+    ::free(base);
+}
+
+/*!
+** arena_set_budget(): Set the job-wide memory budget in bytes
+** \ingroup CIOMR
+*/
+void arena_set_budget(size_t bytes)
+{
+    ArenaState& s = state();
+    boost::mutex::scoped_lock guard(s.lock);
+    s.budget = bytes;
+    if (s.cached > cache_limit(s)) trim_locked(s);
+}
+
+/*!
+** arena_set_options(): Select the placement policy for new blocks
+**
+** \param huge_pages  = advise transparent huge pages for blocks of 2 MiB or more
+** \param first_touch = zero large fresh blocks from all threads
+** \param cache       = keep freed blocks for reuse
+** \ingroup CIOMR
+*/
+void arena_set_options(bool huge_pages, bool first_touch, bool cache)
+{
+    ArenaState& s = state();
+    boost::mutex::scoped_lock guard(s.lock);
+    s.huge_pages = huge_pages;
+    s.first_touch = first_touch;
+    s.cache = cache;
+    if (!cache) trim_locked(s);
+}
+
+/*!
+** arena_trim(): Return every idle cached block to the system
+** \ingroup CIOMR
+*/
+void arena_trim()
+{
+    ArenaState& s = state();
+    boost::mutex::scoped_lock guard(s.lock);
+    trim_locked(s);
+}
+
+/// Job-wide budget in bytes (0 if none was set)
+size_t arena_budget()
+{
+    ArenaState& s = state();
+    boost::mutex::scoped_lock guard(s.lock);
+    return s.budget;
+}
+
+/// Bytes currently held by live arena blocks
+size_t arena_in_use()
+{
+    ArenaState& s = state();
+    boost::mutex::scoped_lock guard(s.lock);
+    return s.in_use;
+}
+
+/// Largest value arena_in_use() has reached in this job
+size_t arena_high_water()
+{
+    ArenaState& s = state();
+    boost::mutex::scoped_lock guard(s.lock);
+    return s.high_water;
+}
+
+/// Number of allocations served from the pool of freed blocks
+size_t arena_reused()
+{
+    ArenaState& s = state();
+    boost::mutex::scoped_lock guard(s.lock);
+    return s.nreuse;
+}
+
+/*!
+** arena_remaining(): Bytes of the budget not held by live blocks
+**
+** Idle cached blocks count as available, since they are released as
+** soon as a new request would not fit.  Returns 0 when over budget.
+** \ingroup CIOMR
+*/
+size_t arena_remaining()
+{
+    ArenaState& s = state();
+    boost::mutex::scoped_lock guard(s.lock);
+    return (s.in_use < s.budget ? s.budget - s.in_use : 0);
+}
+
+/*!
+** arena_print_report(): Print budget, high-water mark and reuse statistics
+** \ingroup CIOMR
+*/
+void arena_print_report()
+{
+    ArenaState& s = state();
+    boost::mutex::scoped_lock guard(s.lock);
+    outfile->Printf("\n  ==> Tracked Memory <==\n\n");
+    outfile->Printf("    Budget           = %11.3f MiB\n", s.budget / 1048576.0);
+    outfile->Printf("    In Use           = %11.3f MiB\n", s.in_use / 1048576.0);
+    outfile->Printf("    High-Water Mark  = %11.3f MiB\n", s.high_water / 1048576.0);
+    outfile->Printf("    Idle (Cached)    = %11.3f MiB\n", s.cached / 1048576.0);
+    outfile->Printf("    Allocations      = %11zu\n", s.nalloc);
+    outfile->Printf("    Reused Blocks    = %11zu\n", s.nreuse);
+    if (s.budget && s.high_water > s.budget)
+        outfile->Printf("    Warning: tracked allocations exceeded the memory setting.\n");
+}
+
+}
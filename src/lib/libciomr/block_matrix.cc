@@ -37,6 +37,7 @@
 #endif
 #include <psiconfig.h>
 #include "psi4-dec.h"
+#include "libciomr.h"
 #ifdef HAVE_MKL
 #ifdef HAVE_MKL_MALLOC
 
@@ -60,7 +61,8 @@ namespace psi {
 ** could be used in conjunction with FORTRAN matrix routines.
 **
 ** Allocates memory for an n x m matrix and returns a pointer to the
-** first row.
+** first row.  The data block comes from arena_malloc(), so it must be
+** released with free_block() rather than delete[] or free().
 **
 ** \param n = number of rows (unsigned long to allow large matrices)
 ** \param m = number of columns (unsigned long to allow large matrices)
@@ -92,13 +94,8 @@ double ** block_matrix(unsigned long int n, unsigned long int m, bool memlock)
         exit(PSI_RETURN_FAILURE);
     }
 
-    B = new double[n*m];
-    if (B == NULL) {
-        outfile->Printf("block_matrix: trouble allocating memory \n");
-        outfile->Printf("m = %ld\n",m);
-        exit(PSI_RETURN_FAILURE);
-    }
-    memset(static_cast<void*>(B), 0, m*n*sizeof(double));
+    // Zeroed, 64-byte aligned and counted against the job's memory budget
+    B = static_cast<double*>(arena_malloc(n*m*sizeof(double)));
 
     for (i = 0; i < n; i++) {
         A[i] = &(B[i*m]);
@@ -155,7 +152,7 @@ double ** block_matrix(unsigned long int n, unsigned long int m, bool memlock)
 void free_block(double **array)
 {
     if(array == NULL) return;
-    delete [] array[0];
+    arena_free(array[0]);
     delete [] array;
 }
 
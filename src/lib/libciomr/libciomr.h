@@ -32,6 +32,7 @@
 #define _psi_src_lib_libciomr_libciomr_h_
 
 #include <cstdio>
+#include <cstddef>
 #include <string>
 namespace psi {
 
@@ -119,6 +120,19 @@ void print_long_int_mat(long int **a, int m, int n, std::string out);
 double ** block_matrix(unsigned long int n, unsigned long int m, bool mlock = false);
 void free_block(double **array);
 
+/* Functions in arena.cc */
+void* arena_malloc(size_t bytes, bool zero = true);
+void arena_free(void* ptr);
+void arena_set_budget(size_t bytes);
+void arena_set_options(bool huge_pages, bool first_touch, bool cache);
+void arena_trim();
+size_t arena_budget();
+size_t arena_in_use();
+size_t arena_high_water();
+size_t arena_reused();
+size_t arena_remaining();
+void arena_print_report();
+
 /* Functions in fndcor */
 void fndcor(long int *maxcrb, std::string OutFileRMR);
 
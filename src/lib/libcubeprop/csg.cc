@@ -21,6 +21,9 @@
  */
 
 #include <boost/filesystem.hpp>
+#include <cstdarg>
+#include <cstdio>
+#include <algorithm>
 
 #include <psi4-dec.h>
 #include <libmints/mints.h>
@@ -36,12 +39,19 @@
 #include <omp.h>
 #endif
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 using namespace psi;
 using namespace boost;
 using namespace std;
 
 namespace psi {
 
+/// Most grid files compute_fields keeps open at once; more fields are written in batches
+static const int CUBE_MAX_OPEN_FILES = 64;
+
 CubicScalarGrid::CubicScalarGrid(
         boost::shared_ptr<BasisSet> primary) :
         primary_(primary),
@@ -57,6 +67,8 @@ CubicScalarGrid::CubicScalarGrid(
     N_ = new int[3];
     D_ = new double[3];
     O_ = new double[3];
+    esp_condition_ = 0.0;
+    points_max_functions_ = -1;
 
     build_grid(); // Defaults from Options
 }
@@ -143,65 +155,245 @@ void CubicScalarGrid::build_grid()
 
     populate_grid();
 }
+
+/// Sequential writer for one grid file, plain or gzip-compressed.
+/// Text values are formatted exactly as the original Gaussian cube writer did.
+class CubeFileWriter {
+
+protected:
+    /// Full path of the file
+    std::string path_;
+    /// Raw doubles (BCUBE) rather than text (CUBE)?
+    bool binary_;
+    /// Plain file handle (NULL if compressed)
+    FILE* fh_;
+#ifdef HAVE_ZLIB
+    /// Compressed file handle (NULL if plain)
+    gzFile gz_;
+#endif
+    /// Number of field values written so far (sets the text line breaks)
+    size_t nvalue_;
+
+public:
+    CubeFileWriter(const std::string& path, bool binary, bool compress);
+    ~CubeFileWriter();
+
+    /// Write size bytes of buffer as they are
+    void write_raw(const void* buffer, size_t size);
+    /// Write formatted header text
+    void print(const char* format, ...);
+    /// Append n field values in cube ordering
+    void write(const double* v, size_t n);
+};
+
+CubeFileWriter::CubeFileWriter(const std::string& path, bool binary, bool compress) :
+    path_(path), binary_(binary), fh_(NULL), nvalue_(0L)
+{
+#ifdef HAVE_ZLIB
+    gz_ = NULL;
+    if (compress) {
+        gz_ = gzopen(path_.c_str(), "wb");
+        if (gz_ == NULL) throw PSIEXCEPTION("CubicScalarGrid: Cannot open " + path_);
+        return;
+    }
+#else
+    if (compress) throw PSIEXCEPTION("CubicScalarGrid: Compressed grid files need PSI4 built with zlib");
+#endif
+    fh_ = fopen(path_.c_str(), (binary_ ? "wb" : "w"));
+    if (fh_ == NULL) throw PSIEXCEPTION("CubicScalarGrid: Cannot open " + path_);
+}
+CubeFileWriter::~CubeFileWriter()
+{
+    if (fh_) fclose(fh_);
+#ifdef HAVE_ZLIB
+    if (gz_) gzclose(gz_);
+#endif
+}
+void CubeFileWriter::write_raw(const void* buffer, size_t size)
+{
+#ifdef HAVE_ZLIB
+    if (gz_) {
+        // gzwrite takes an unsigned length, so go in pieces of at most 1 GB
+        const char* bufferp = (const char*) buffer;
+        while (size) {
+            unsigned piece = (unsigned) std::min(size, (size_t) (1L << 30));
+            if (gzwrite(gz_, bufferp, piece) != (int) piece)
+                throw PSIEXCEPTION("CubicScalarGrid: Write failed on " + path_);
+            bufferp += piece;
+            size -= piece;
+        }
+        return;
+    }
+#endif
+    if (fwrite(buffer, 1, size, fh_) != size)
+        throw PSIEXCEPTION("CubicScalarGrid: Write failed on " + path_);
+}
+void CubeFileWriter::print(const char* format, ...)
+{
+    char line[512];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    write_raw(line, std::min((size_t) len, sizeof(line) - 1));
+}
+void CubeFileWriter::write(const double* v, size_t n)
+{
+    if (binary_) {
+        write_raw(v, n * sizeof(double));
+        nvalue_ += n;
+        return;
+    }
+
+    // Format chunks of whole lines on all threads, then write them in order
+    const long int chunk = 6L * 1024L;
+    long int nchunk = (n + chunk - 1L) / chunk;
+    std::vector<std::string> text(nchunk);
+
+    #pragma omp parallel for schedule(static)
+    for (long int c = 0; c < nchunk; c++) {
+        char value[32];
+        size_t start = c * chunk;
+        size_t stop = std::min(n, (size_t) ((c + 1L) * chunk));
+        text[c].reserve(14L * (stop - start) + (stop - start) / 6L + 1L);
+        for (size_t ind = start; ind < stop; ind++) {
+            int len = snprintf(value, sizeof(value), "%12.5E ", v[ind]);
+            text[c].append(value, len);
+            if ((nvalue_ + ind) % 6 == 5) text[c].append("\n");
+        }
+    }
+
+    for (long int c = 0; c < nchunk; c++) {
+        write_raw(text[c].data(), text[c].size());
+    }
+    nvalue_ += n;
+}
+
 void CubicScalarGrid::populate_grid()
 {
     if (x_) delete[] x_;
     if (y_) delete[] y_;
     if (z_) delete[] z_;
     if (w_) delete[] w_;
+    x_ = NULL;
+    y_ = NULL;
+    z_ = NULL;
+    w_ = NULL;
+    blocks_.clear();
+    block_offsets_.clear();
 
     npoints_ = (N_[0] + 1L) * (N_[1] + 1L) * (N_[2] + 1L);
-    x_ = new double[npoints_];
-    y_ = new double[npoints_];
-    z_ = new double[npoints_];
-    w_ = new double[npoints_];
 
     double epsilon = options_.get_double("CUBIC_BASIS_TOLERANCE");
     extents_ = boost::shared_ptr<BasisExtents> (new BasisExtents(primary_, epsilon));
 
     int max_points = options_.get_int("CUBIC_BLOCK_MAX_POINTS");
-    double xyz = pow((double) max_points, 1.0/3.0);
     nxyz_ = (size_t) pow((double) max_points, 1.0/3.0);
 
+    // The full grid (x_, blocks_) is only built if a full-grid routine asks for it;
+    // the compute_ routines work one x slab at a time
+    points_.clear();
+    points_max_functions_ = -1;
+}
+size_t CubicScalarGrid::slab_npoints(int istart) const
+{
+    int ni = (istart + (int) nxyz_ > N_[0] ? (N_[0] + 1) - istart : (int) nxyz_);
+    return ni * (N_[1] + 1L) * (N_[2] + 1L);
+}
+void CubicScalarGrid::build_slab(int istart, double* x, double* y, double* z, double* w, size_t offset0,
+    std::vector<boost::shared_ptr<BlockOPoints> >& blocks, std::vector<size_t>& offsets) const
+{
+    int ni = (istart + (int) nxyz_ > N_[0] ? (N_[0] + 1) - istart : (int) nxyz_);
+
     size_t offset = 0L;
-    for (int istart = 0L; istart <= N_[0]; istart+=nxyz_) {
-        int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
-        for (int jstart = 0L; jstart <= N_[1]; jstart+=nxyz_) {
-            int nj = (jstart + nxyz_ > N_[1] ? (N_[1] + 1) - jstart : nxyz_);
-            for (int kstart = 0L; kstart <= N_[2]; kstart+=nxyz_) {
-                int nk = (kstart + nxyz_ > N_[2] ? (N_[2] + 1) - kstart : nxyz_);
-
-                double* xp = &x_[offset];
-                double* yp = &y_[offset];
-                double* zp = &z_[offset];
-                double* wp = &w_[offset];
-                
-                size_t block_size = 0L;
-                for (int i = istart; i < istart + ni; i++) {
-                    for (int j = jstart; j < jstart + nj; j++) {
-                        for (int k = kstart; k < kstart + nk; k++) {
-                            x_[offset] = O_[0] + i * D_[0];
-                            y_[offset] = O_[1] + j * D_[1];
-                            z_[offset] = O_[2] + k * D_[2];
-                            w_[offset] = D_[0] * D_[1] * D_[2];
-                            offset++;
-                            block_size++;
-                        }
+    for (int jstart = 0L; jstart <= N_[1]; jstart+=nxyz_) {
+        int nj = (jstart + (int) nxyz_ > N_[1] ? (N_[1] + 1) - jstart : (int) nxyz_);
+        for (int kstart = 0L; kstart <= N_[2]; kstart+=nxyz_) {
+            int nk = (kstart + (int) nxyz_ > N_[2] ? (N_[2] + 1) - kstart : (int) nxyz_);
+
+            double* xp = &x[offset];
+            double* yp = &y[offset];
+            double* zp = &z[offset];
+            double* wp = &w[offset];
+            offsets.push_back(offset0 + offset);
+            
+            size_t block_size = 0L;
+            for (int i = istart; i < istart + ni; i++) {
+                for (int j = jstart; j < jstart + nj; j++) {
+                    for (int k = kstart; k < kstart + nk; k++) {
+                        x[offset] = O_[0] + i * D_[0];
+                        y[offset] = O_[1] + j * D_[1];
+                        z[offset] = O_[2] + k * D_[2];
+                        w[offset] = D_[0] * D_[1] * D_[2];
+                        offset++;
+                        block_size++;
                     }
                 }
-                blocks_.push_back(boost::shared_ptr<BlockOPoints>(new BlockOPoints(block_size,xp,yp,zp,wp,extents_)));
             }
+            blocks.push_back(boost::shared_ptr<BlockOPoints>(new BlockOPoints(block_size,xp,yp,zp,wp,extents_)));
         }
     }
-            
+}
+void CubicScalarGrid::slab_order(int istart, std::vector<size_t>& order) const
+{
+    int ni = (istart + (int) nxyz_ > N_[0] ? (N_[0] + 1) - istart : (int) nxyz_);
+    order.resize(slab_npoints(istart));
+
+    size_t offset = 0L;
+    for (int jstart = 0L; jstart <= N_[1]; jstart+=nxyz_) {
+        int nj = (jstart + (int) nxyz_ > N_[1] ? (N_[1] + 1) - jstart : (int) nxyz_);
+        for (int kstart = 0L; kstart <= N_[2]; kstart+=nxyz_) {
+            int nk = (kstart + (int) nxyz_ > N_[2] ? (N_[2] + 1) - kstart : (int) nxyz_);
+            for (int i = 0; i < ni; i++) {
+                for (int j = jstart; j < jstart + nj; j++) {
+                    for (int k = kstart; k < kstart + nk; k++) {
+                        order[offset++] = i * (N_[1] + 1L) * (N_[2] + 1L) + j * (N_[2] + 1L) + k;
+                    }
+                }
+            }
+        }
+    }
+}
+void CubicScalarGrid::build_blocks() const
+{
+    if (x_) return;
+
+    // Lazily filled cache of the full grid, so the const accessors may build it
+    CubicScalarGrid* grid = const_cast<CubicScalarGrid*>(this);
+    grid->x_ = new double[npoints_];
+    grid->y_ = new double[npoints_];
+    grid->z_ = new double[npoints_];
+    grid->w_ = new double[npoints_];
+
+    size_t offset = 0L;
+    for (int istart = 0L; istart <= N_[0]; istart+=nxyz_) {
+        build_slab(istart, &x_[offset], &y_[offset], &z_[offset], &w_[offset], offset,
+            grid->blocks_, grid->block_offsets_);
+        offset += slab_npoints(istart);
+    }
+}
+void CubicScalarGrid::size_points(const std::vector<boost::shared_ptr<BlockOPoints> >& blocks)
+{
     int max_functions = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        max_functions = (max_functions >= blocks_[ind]->functions_local_to_global().size() ? 
-            max_functions : blocks_[ind]->functions_local_to_global().size());
+    for (int ind = 0; ind < (int) blocks.size(); ind++) {
+        int nlocal = blocks[ind]->functions_local_to_global().size();
+        max_functions = (max_functions >= nlocal ? max_functions : nlocal);
     }
+    if (points_.size() && max_functions <= points_max_functions_) return;
  
-    points_ = boost::shared_ptr<RKSFunctions>(new RKSFunctions(primary_,max_points,max_functions));
-    points_->set_ansatz(0);
+    int max_points = options_.get_int("CUBIC_BLOCK_MAX_POINTS");
+
+    int nthreads = 1;
+    #ifdef _OPENMP
+        nthreads = omp_get_max_threads();
+    #endif
+
+    points_.clear();
+    for (int thread = 0; thread < nthreads; thread++) {
+        points_.push_back(boost::shared_ptr<RKSFunctions>(new RKSFunctions(primary_,max_points,max_functions)));
+        points_[thread]->set_ansatz(0);
+    }
+    points_max_functions_ = max_functions;
 }
 void CubicScalarGrid::print_header()
 {
@@ -226,43 +418,25 @@ void CubicScalarGrid::print_header()
 
     outfile->Flush();
 }
-void CubicScalarGrid::write_gen_file(double* v, const std::string& name, const std::string& type)
+boost::shared_ptr<CubeFileWriter> CubicScalarGrid::open_file(const std::string& name, const std::string& type)
 {
+    bool binary;
+    bool compress;
+    std::string extension;
     if (type == "CUBE") {
-        write_cube_file(v, name);
+        binary = false; compress = false; extension = "cube";
+    } else if (type == "CUBE.GZ") {
+        binary = false; compress = true;  extension = "cube.gz";
+    } else if (type == "BCUBE") {
+        binary = true;  compress = false; extension = "bcube";
+    } else if (type == "BCUBE.GZ") {
+        binary = true;  compress = true;  extension = "bcube.gz";
     } else {
         throw PSIEXCEPTION("CubicScalarGrid: Unrecognized output file type");
     }
-}
-void CubicScalarGrid::write_cube_file(double* v, const std::string& name)
-{
-    // => Reorder the grid <= //
-
-    double* v2 = new double[npoints_];
-    size_t offset = 0L;
-    for (int istart = 0L; istart <= N_[0]; istart+=nxyz_) {
-        int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
-        for (int jstart = 0L; jstart <= N_[1]; jstart+=nxyz_) {
-            int nj = (jstart + nxyz_ > N_[1] ? (N_[1] + 1) - jstart : nxyz_);
-            for (int kstart = 0L; kstart <= N_[2]; kstart+=nxyz_) {
-                int nk = (kstart + nxyz_ > N_[2] ? (N_[2] + 1) - kstart : nxyz_);
-                for (int i = istart; i < istart + ni; i++) {
-                    for (int j = jstart; j < jstart + nj; j++) {
-                        for (int k = kstart; k < kstart + nk; k++) {
-                            size_t index = i * (N_[1] + 1L) * (N_[2] + 1L) + j * (N_[2] + 1L) + k;
-                            v2[index] = v[offset];
-                            offset++;
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    // => Drop the grid out <= //
 
     std::stringstream ss;
-    ss << filepath_ << "/" << name << ".cube";
+    ss << filepath_ << "/" << name << "." << extension;
 
     // Is filepath a valid directory?
     boost::filesystem::path data_dir(filepath_);
@@ -273,137 +447,120 @@ void CubicScalarGrid::write_cube_file(double* v, const std::string& name)
         exit(Failure);
     }
 
-    FILE* fh = fopen(ss.str().c_str(), "w");
+    boost::shared_ptr<CubeFileWriter> fh(new CubeFileWriter(ss.str(), binary, compress));
+
+    if (binary) {
+        int version = 1;
+        int natom = mol_->natom();
+        int npoints[3] = {N_[0] + 1, N_[1] + 1, N_[2] + 1};
+        int length = name.size();
+        fh->write_raw("PSI4CUBE", 8);
+        fh->write_raw(&version, sizeof(int));
+        fh->write_raw(&natom, sizeof(int));
+        fh->write_raw(npoints, 3 * sizeof(int));
+        fh->write_raw(O_, 3 * sizeof(double));
+        fh->write_raw(D_, 3 * sizeof(double));
+        for (int A = 0; A < natom; A++) {
+            double atom[4] = {mol_->Z(A), mol_->x(A), mol_->y(A), mol_->z(A)};
+            fh->write_raw(atom, 4 * sizeof(double));
+        }
+        fh->write_raw(&length, sizeof(int));
+        fh->write_raw(name.c_str(), length);
+        return fh;
+    }
+
     // Two comment lines
-    fprintf(fh, "PSI4 Gaussian Cube File.\n");
-    fprintf(fh, "Property: %s\n", name.c_str());
+    fh->print("PSI4 Gaussian Cube File.\n");
+    fh->print("Property: %s\n", name.c_str());
 
     // Number of atoms plus origin of data
-    fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", mol_->natom(), O_[0], O_[1], O_[2]);
+    fh->print("%6d %10.6f %10.6f %10.6f\n", mol_->natom(), O_[0], O_[1], O_[2]);
 
     // Number of points along axis, displacement along x,y,z
-    fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", N_[0] + 1, D_[0], 0.0, 0.0);
-    fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", N_[1] + 1, 0.0, D_[1], 0.0);
-    fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", N_[2] + 1, 0.0, 0.0, D_[2]);
+    fh->print("%6d %10.6f %10.6f %10.6f\n", N_[0] + 1, D_[0], 0.0, 0.0);
+    fh->print("%6d %10.6f %10.6f %10.6f\n", N_[1] + 1, 0.0, D_[1], 0.0);
+    fh->print("%6d %10.6f %10.6f %10.6f\n", N_[2] + 1, 0.0, 0.0, D_[2]);
 
     // Atoms of molecule (Z, Q?, x, y, z)
     for (int A = 0; A < mol_->natom(); A++) {
-        fprintf(fh, "%3d %10.6f %10.6f %10.6f %10.6f\n", (int) mol_->Z(A), 0.0, mol_->x(A), mol_->y(A), mol_->z(A));
-    }
-
-    // Data, striped (x, y, z)
-    for (size_t ind = 0; ind < npoints_; ind++) {
-        fprintf(fh, "%12.5E ", v2[ind]);
-        if (ind % 6 == 5) fprintf(fh,"\n");
+        fh->print("%3d %10.6f %10.6f %10.6f %10.6f\n", (int) mol_->Z(A), 0.0, mol_->x(A), mol_->y(A), mol_->z(A));
     }
 
-    fclose(fh);
+    return fh;
 }
-void CubicScalarGrid::add_density(double* v, boost::shared_ptr<Matrix> D)
+void CubicScalarGrid::write_gen_file(double* v, const std::string& name, const std::string& type)
 {
-    points_->set_pointers(D);
-    boost::shared_ptr<Vector> rho = points_->point_value("RHO_A");
-    double* rhop = rho->pointer();
+    boost::shared_ptr<CubeFileWriter> fh = open_file(name, type);
 
+    // => Reorder and drop the grid out one x slab at a time <= //
+
+    double* v2 = new double[slab_npoints(0)];
+    std::vector<size_t> order;
     size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_points(blocks_[ind]);
-        size_t npoints = blocks_[ind]->npoints();
-        C_DAXPY(npoints,1.0,rhop,1,&v[offset],1);        
+    for (int istart = 0L; istart <= N_[0]; istart+=nxyz_) {
+        size_t npoints = slab_npoints(istart);
+        slab_order(istart, order);
+        for (size_t P = 0; P < npoints; P++) {
+            v2[order[P]] = v[offset + P];
+        }
+        fh->write(v2, npoints);
         offset += npoints;
     }
+    delete[] v2;
 }
-void CubicScalarGrid::add_esp(double* v, boost::shared_ptr<Matrix> D)
+void CubicScalarGrid::write_cube_file(double* v, const std::string& name)
 {
-    // => Auxiliary Basis Set (TODO: Get appropriate default) <= //
+    write_gen_file(v, name, "CUBE");
+}
+void CubicScalarGrid::add_density(double* v, boost::shared_ptr<Matrix> D)
+{
+    build_blocks();
+    add_density(v, D, blocks_, block_offsets_);
+}
+void CubicScalarGrid::add_density(double* v, boost::shared_ptr<Matrix> D,
+    const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, const std::vector<size_t>& offsets)
+{
+    size_points(blocks);
+    for (size_t thread = 0; thread < points_.size(); thread++) {
+        points_[thread]->set_pointers(D);
+    }
 
-    boost::shared_ptr<BasisSetParser> parser(new Gaussian94BasisSetParser());
-    boost::shared_ptr<BasisSet> auxiliary = BasisSet::construct(parser, primary_->molecule(), "DF_BASIS_SCF");
-    
-    // => DF Options (TODO: Should these be in here?) <= //
+    #pragma omp parallel for schedule(dynamic) num_threads(points_.size())
+    for (int ind = 0; ind < (int) blocks.size(); ind++) {
 
-    double cutoff    = options_.get_double("INTS_TOLERANCE");
+        // Blocks beyond the extents of every basis function add nothing
+        if (!blocks[ind]->functions_local_to_global().size()) continue;
+
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        points_[thread]->compute_points(blocks[ind]);
+        double* rhop = points_[thread]->point_value("RHO_A")->pointer();
+        size_t npoints = blocks[ind]->npoints();
+        C_DAXPY(npoints,1.0,rhop,1,&v[offsets[ind]],1);
+    }
+}
+void CubicScalarGrid::build_esp_metric()
+{
+    // => Auxiliary Basis Set (TODO: Get appropriate default) <= //
+
+    std::string basis_key = options_.get_str("DF_BASIS_SCF");
     double condition = options_.get_double("DF_FITTING_CONDITION");
 
-    // => Sizing <= //
+    if (esp_Jinv_ && basis_key == esp_basis_key_ && condition == esp_condition_) return;
+
+    boost::shared_ptr<BasisSetParser> parser(new Gaussian94BasisSetParser());
+    boost::shared_ptr<BasisSet> auxiliary = BasisSet::construct(parser, primary_->molecule(), "DF_BASIS_SCF");
 
-    int nbf  = primary_->nbf();
     int naux = auxiliary->nbf();
-    int maxP = auxiliary->max_function_per_shell();
 
     int nthreads = 1;
     #ifdef _OPENMP
         nthreads = omp_get_max_threads();
     #endif
 
-    // => Density Fitting (TODO: Could be sped up) <= //
-
-    boost::shared_ptr<IntegralFactory> Ifact(new IntegralFactory(auxiliary,BasisSet::zero_ao_basis_set(), primary_, primary_));
-    std::vector<boost::shared_ptr<TwoBodyAOInt> > ints;
-    for (int thread = 0; thread < nthreads; thread++) {
-        ints.push_back(boost::shared_ptr<TwoBodyAOInt>(Ifact->eri()));
-    }
-
-    boost::shared_ptr<ERISieve> sieve(new ERISieve(primary_, cutoff));
-    const std::vector<std::pair<int,int> >& pairs = sieve->shell_pairs();  
-
-    boost::shared_ptr<Vector> c(new Vector("c", naux));
-    double* cp = c->pointer();
-
-    boost::shared_ptr<Matrix> Amn(new Matrix("Amn", maxP, nbf*nbf));
-    double** Amnp = Amn->pointer();
-
-    double** Dp = D->pointer();
-
-    for (int P = 0; P < auxiliary->nshell(); P++) {
-
-        int nP = auxiliary->shell(P).nfunction();
-        int oP = auxiliary->shell(P).function_index();
-
-        Amn->zero();        
-
-        // Integrals
-        #pragma omp parallel for schedule(dynamic)
-        for (int task = 0; task < pairs.size(); task++) {
-            
-            int thread = 0;
-            #ifdef _OPENMP
-                thread = omp_get_thread_num();
-            #endif
-
-            int M = pairs[task].first;
-            int N = pairs[task].second;
-
-            ints[thread]->compute_shell(P,0,M,N);
-            const double* buffer = ints[thread]->buffer();
-
-            int nM = primary_->shell(M).nfunction();
-            int oM = primary_->shell(M).function_index();
-            int nN = primary_->shell(N).nfunction();
-            int oN = primary_->shell(N).function_index();
-
-            int index = 0;
-            for (int p = 0; p < nP; p++) {
-                for (int m = 0; m < nM; m++) {
-                    for (int n = 0; n < nN; n++) {
-                        Amnp[p][(m + oM) * nbf + (n + oN)] =
-                        Amnp[p][(n + oN) * nbf + (m + oM)] =
-                        buffer[index++];
-                    }
-                }
-            }
-            
-        }
-        
-        // Contraction
-        C_DGEMV('N', nP, nbf*nbf, 1.0, Amnp[0], nbf*nbf, Dp[0], 1, 0.0, cp + oP, 1);
-
-    }
-
-    Amn.reset();
-    Ifact.reset();
-    ints.clear();
-
     boost::shared_ptr<Matrix> J(new Matrix("J", naux, naux));
     double** Jp = J->pointer();
 
@@ -411,10 +568,21 @@ void CubicScalarGrid::add_esp(double* v, boost::shared_ptr<Matrix> D)
         auxiliary,BasisSet::zero_ao_basis_set(), 
         auxiliary,BasisSet::zero_ao_basis_set()));
 
-    boost::shared_ptr<TwoBodyAOInt> Jints(Jfact->eri());
-    const double* Jbuffer = Jints->buffer();
+    std::vector<boost::shared_ptr<TwoBodyAOInt> > Jints;
+    for (int thread = 0; thread < nthreads; thread++) {
+        Jints.push_back(boost::shared_ptr<TwoBodyAOInt>(Jfact->eri()));
+    }
 
+    #pragma omp parallel for schedule(dynamic)
     for (int P = 0; P < auxiliary->nshell(); P++) {
+
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        const double* Jbuffer = Jints[thread]->buffer();
+
         int nP = auxiliary->shell(P).nfunction();
         int oP = auxiliary->shell(P).function_index();
 
@@ -422,7 +590,7 @@ void CubicScalarGrid::add_esp(double* v, boost::shared_ptr<Matrix> D)
             int nQ = auxiliary->shell(Q).nfunction();
             int oQ = auxiliary->shell(Q).function_index();
 
-            Jints->compute_shell(P,0,Q,0);
+            Jints[thread]->compute_shell(P,0,Q,0);
 
             int index = 0;
             for (int p = 0; p < nP; p++) {
@@ -435,20 +603,126 @@ void CubicScalarGrid::add_esp(double* v, boost::shared_ptr<Matrix> D)
         }
     }
 
+    Jints.clear();
     Jfact.reset();
-    Jints.reset(); 
    
     J->power(-1.0, condition); 
 
+    esp_auxiliary_ = auxiliary;
+    esp_Jinv_ = J;
+    esp_basis_key_ = basis_key;
+    esp_condition_ = condition;
+}
+boost::shared_ptr<Vector> CubicScalarGrid::esp_coefficients(boost::shared_ptr<Matrix> D)
+{
+    // => Fitting Metric (cached between calls) <= //
+
+    build_esp_metric();
+    boost::shared_ptr<BasisSet> auxiliary = esp_auxiliary_;
+
+    // => DF Options (TODO: Should these be in here?) <= //
+
+    double cutoff    = options_.get_double("INTS_TOLERANCE");
+
+    // => Sizing <= //
+
+    int naux = auxiliary->nbf();
+
+    int nthreads = 1;
+    #ifdef _OPENMP
+        nthreads = omp_get_max_threads();
+    #endif
+
+    // => Density Fitting <= //
+
+    boost::shared_ptr<IntegralFactory> Ifact(new IntegralFactory(auxiliary,BasisSet::zero_ao_basis_set(), primary_, primary_));
+    std::vector<boost::shared_ptr<TwoBodyAOInt> > ints;
+    std::vector<boost::shared_ptr<Vector> > cT;
+    for (int thread = 0; thread < nthreads; thread++) {
+        ints.push_back(boost::shared_ptr<TwoBodyAOInt>(Ifact->eri()));
+        cT.push_back(boost::shared_ptr<Vector>(new Vector("c", naux)));
+    }
+
+    boost::shared_ptr<ERISieve> sieve(new ERISieve(primary_, cutoff));
+    const std::vector<std::pair<int,int> >& pairs = sieve->shell_pairs();  
+    long int npairs = pairs.size();
+    long int ntasks = npairs * auxiliary->nshell();
+
+    double** Dp = D->pointer();
+
+    // c_P = (P|mn) D_mn, contracted as each (P|MN) shell triple is formed
+    #pragma omp parallel for schedule(dynamic)
+    for (long int task = 0; task < ntasks; task++) {
+
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        int P = task / npairs;
+        int M = pairs[task % npairs].first;
+        int N = pairs[task % npairs].second;
+
+        int nP = auxiliary->shell(P).nfunction();
+        int oP = auxiliary->shell(P).function_index();
+        int nM = primary_->shell(M).nfunction();
+        int oM = primary_->shell(M).function_index();
+        int nN = primary_->shell(N).nfunction();
+        int oN = primary_->shell(N).function_index();
+
+        ints[thread]->compute_shell(P,0,M,N);
+        const double* buffer = ints[thread]->buffer();
+        double* cp = cT[thread]->pointer();
+
+        int index = 0;
+        for (int p = 0; p < nP; p++) {
+            double val = 0.0;
+            for (int m = 0; m < nM; m++) {
+                for (int n = 0; n < nN; n++) {
+                    double Dmn = Dp[m + oM][n + oN];
+                    if (M != N) Dmn += Dp[n + oN][m + oM];
+                    val += Dmn * buffer[index++];
+                }
+            }
+            cp[p + oP] += val;
+        }
+    }
+
+    for (int thread = 1; thread < nthreads; thread++) {
+        cT[0]->add(cT[thread]);
+    }
+    double* cp = cT[0]->pointer();
+
+    Ifact.reset();
+    ints.clear();
+
     boost::shared_ptr<Vector> d(new Vector("d", naux));
     double* dp = d->pointer();
 
+    double** Jp = esp_Jinv_->pointer();
     C_DGEMV('N',naux,naux,1.0,Jp[0],naux,cp,1,0.0,dp,1);
 
     //c->print();
     //d->print();
 
-    J.reset();
+    return d;
+}
+void CubicScalarGrid::add_esp(double* v, boost::shared_ptr<Matrix> D)
+{
+    build_blocks();
+    boost::shared_ptr<Vector> d = esp_coefficients(D);
+    add_esp(v, d, x_, y_, z_, npoints_);
+}
+void CubicScalarGrid::add_esp(double* v, boost::shared_ptr<Vector> d, double* x, double* y, double* z, size_t npoints)
+{
+    boost::shared_ptr<BasisSet> auxiliary = esp_auxiliary_;
+    int naux = auxiliary->nbf();
+    double* dp = d->pointer();
+
+    int nthreads = 1;
+    #ifdef _OPENMP
+        nthreads = omp_get_max_threads();
+    #endif
 
     // => Electronic Part <= //
 
@@ -464,7 +738,7 @@ void CubicScalarGrid::add_esp(double* v, boost::shared_ptr<Matrix> D)
     }
 
     #pragma omp parallel for schedule(dynamic)
-    for (int P = 0; P < npoints_; P++) {
+    for (long int P = 0; P < (long int) npoints; P++) {
 
         // Thread info
         int thread = 0;
@@ -479,9 +753,9 @@ void CubicScalarGrid::add_esp(double* v, boost::shared_ptr<Matrix> D)
         // Integrals
         VtempT[thread]->zero();
         ZxyzTp[0][0] = 1.0;
-        ZxyzTp[0][1] = x_[P];
-        ZxyzTp[0][2] = y_[P];
-        ZxyzTp[0][3] = z_[P]; 
+        ZxyzTp[0][1] = x[P];
+        ZxyzTp[0][2] = y[P];
+        ZxyzTp[0][3] = z[P]; 
         VintT[thread]->compute(VtempT[thread]);
 
         // Contraction 
@@ -490,112 +764,173 @@ void CubicScalarGrid::add_esp(double* v, boost::shared_ptr<Matrix> D)
     
     // => Nuclear Part <= //
 
-    for (int A = 0; A < mol_->natom(); A++) {
-        double Z = mol_->Z(A);
-        double x = mol_->x(A);
-        double y = mol_->y(A);
-        double z = mol_->z(A);
-        for (int P = 0; P < npoints_; P++) {
+    int natom = mol_->natom();
+    std::vector<double> Z(natom), xA(natom), yA(natom), zA(natom);
+    for (int A = 0; A < natom; A++) {
+        Z[A] = mol_->Z(A);
+        xA[A] = mol_->x(A);
+        yA[A] = mol_->y(A);
+        zA[A] = mol_->z(A);
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (long int P = 0; P < (long int) npoints; P++) {
+        for (int A = 0; A < natom; A++) {
             double R = sqrt(
-                (x - x_[P]) * (x - x_[P]) +
-                (y - y_[P]) * (y - y_[P]) +
-                (z - z_[P]) * (z - z_[P]));
-            v[P] += (R >= 1.0E-15 ? Z / R : 0.0);
+                (xA[A] - x[P]) * (xA[A] - x[P]) +
+                (yA[A] - y[P]) * (yA[A] - y[P]) +
+                (zA[A] - z[P]) * (zA[A] - z[P]));
+            v[P] += (R >= 1.0E-15 ? Z[A] / R : 0.0);
         }
     }
 }
 void CubicScalarGrid::add_basis_functions(double** v, const std::vector<int>& indices)
 {
-    boost::shared_ptr<Matrix> phi = points_->basis_value("PHI");
-    double** phip = phi->pointer();
+    build_blocks();
+    add_basis_functions(v, indices, blocks_, block_offsets_);
+}
+void CubicScalarGrid::add_basis_functions(double** v, const std::vector<int>& indices,
+    const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, const std::vector<size_t>& offsets)
+{
+    size_points(blocks);
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_functions(blocks_[ind]);
+    #pragma omp parallel for schedule(dynamic) num_threads(points_.size())
+    for (int ind = 0; ind < (int) blocks.size(); ind++) {
+
+        const std::vector<int>& function_map = blocks[ind]->functions_local_to_global();
+        if (!function_map.size()) continue;
+
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
 
-        size_t npoints = blocks_[ind]->npoints();
-        const std::vector<int>& function_map = blocks_[ind]->functions_local_to_global();
-        int nlocal  = function_map.size();
-        int nglobal = points_->max_functions();
+        points_[thread]->compute_functions(blocks[ind]);
+        double** phip = points_[thread]->basis_value("PHI")->pointer();
 
-        for (int ind1 = 0; ind1 < indices.size(); ind1++) {
-            for (int ind2 = 0; ind2 < function_map.size(); ind2++) {
+        size_t npoints = blocks[ind]->npoints();
+        size_t offset = offsets[ind];
+        int nglobal = points_[thread]->max_functions();
+
+        for (int ind1 = 0; ind1 < (int) indices.size(); ind1++) {
+            for (int ind2 = 0; ind2 < (int) function_map.size(); ind2++) {
                 if (indices[ind1] == function_map[ind2]) {
                     C_DAXPY(npoints,1.0,&phip[0][ind2],nglobal,&v[ind1][offset],1);
                 }                
             }
         }
-
-        offset += npoints;
     }
 }
 void CubicScalarGrid::add_orbitals(double** v, boost::shared_ptr<Matrix> C)
+{
+    build_blocks();
+    add_orbitals(v, C, blocks_, block_offsets_);
+}
+void CubicScalarGrid::add_orbitals(double** v, boost::shared_ptr<Matrix> C,
+    const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, const std::vector<size_t>& offsets)
 {
     int na = C->colspi()[0];    
 
-    points_->set_Cs(C);
-    boost::shared_ptr<Matrix> psi = points_->orbital_value("PSI_A");
-    double** psip = psi->pointer();
+    size_points(blocks);
+    for (size_t thread = 0; thread < points_.size(); thread++) {
+        points_[thread]->set_Cs(C);
+    }
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_orbitals(blocks_[ind]);
+    #pragma omp parallel for schedule(dynamic) num_threads(points_.size())
+    for (int ind = 0; ind < (int) blocks.size(); ind++) {
+
+        if (!blocks[ind]->functions_local_to_global().size()) continue;
 
-        size_t npoints = blocks_[ind]->npoints();
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        points_[thread]->compute_orbitals(blocks[ind]);
+        double** psip = points_[thread]->orbital_value("PSI_A")->pointer();
+
+        size_t npoints = blocks[ind]->npoints();
+        size_t offset = offsets[ind];
         for (int a = 0; a < na; a++) {
             C_DAXPY(npoints,1.0,psip[a],1,&v[a][offset],1);
         }    
-
-        offset += npoints;
     }
 }
 void CubicScalarGrid::add_LOL(double* v, boost::shared_ptr<Matrix> D)
 {
-    points_->set_ansatz(2);
-    points_->set_pointers(D);
-
-    boost::shared_ptr<Vector> rho = points_->point_value("RHO_A");
-    boost::shared_ptr<Vector> tau = points_->point_value("TAU_A");
-    double* rhop = rho->pointer();
-    double* taup = tau->pointer();
+    build_blocks();
+    add_LOL(v, D, blocks_, block_offsets_);
+}
+void CubicScalarGrid::add_LOL(double* v, boost::shared_ptr<Matrix> D,
+    const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, const std::vector<size_t>& offsets)
+{
+    size_points(blocks);
+    for (size_t thread = 0; thread < points_.size(); thread++) {
+        points_[thread]->set_ansatz(2);
+        points_[thread]->set_pointers(D);
+    }
 
     double C = 3.0 / 5.0 * pow(6.0 * M_PI * M_PI, 2.0 / 3.0);
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_points(blocks_[ind]);
-        size_t npoints = blocks_[ind]->npoints();
-        for (int P = 0; P < npoints; P++) {
+    #pragma omp parallel for schedule(dynamic) num_threads(points_.size())
+    for (int ind = 0; ind < (int) blocks.size(); ind++) {
+
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        points_[thread]->compute_points(blocks[ind]);
+        double* rhop = points_[thread]->point_value("RHO_A")->pointer();
+        double* taup = points_[thread]->point_value("TAU_A")->pointer();
+
+        size_t npoints = blocks[ind]->npoints();
+        size_t offset = offsets[ind];
+        for (size_t P = 0; P < npoints; P++) {
             double tau_LSDA = C * pow(rhop[P], 5.0 / 3.0);
             double tau_EX   = taup[P];
             double t = tau_LSDA / tau_EX;
             double v2 = (fabs(tau_EX / tau_LSDA) < 1.0E-15 ? 1.0 : t / (1.0 + t));
             v[P + offset] += v2;
         }
-        offset += npoints;
     }
     
-    points_->set_ansatz(0);
+    for (size_t thread = 0; thread < points_.size(); thread++) {
+        points_[thread]->set_ansatz(0);
+    }
 }
 void CubicScalarGrid::add_ELF(double* v, boost::shared_ptr<Matrix> D)
 {
-    points_->set_ansatz(2);
-    points_->set_pointers(D);
-
-    boost::shared_ptr<Vector> rho = points_->point_value("RHO_A");
-    boost::shared_ptr<Vector> gam = points_->point_value("GAMMA_AA");
-    boost::shared_ptr<Vector> tau = points_->point_value("TAU_A");
-    double* rhop = rho->pointer();
-    double* gamp = gam->pointer();
-    double* taup = tau->pointer();
+    build_blocks();
+    add_ELF(v, D, blocks_, block_offsets_);
+}
+void CubicScalarGrid::add_ELF(double* v, boost::shared_ptr<Matrix> D,
+    const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, const std::vector<size_t>& offsets)
+{
+    size_points(blocks);
+    for (size_t thread = 0; thread < points_.size(); thread++) {
+        points_[thread]->set_ansatz(2);
+        points_[thread]->set_pointers(D);
+    }
 
     double C = 3.0 / 5.0 * pow(6.0 * M_PI * M_PI, 2.0 / 3.0);
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_points(blocks_[ind]);
-        size_t npoints = blocks_[ind]->npoints();
-        for (int P = 0; P < npoints; P++) {
+    #pragma omp parallel for schedule(dynamic) num_threads(points_.size())
+    for (int ind = 0; ind < (int) blocks.size(); ind++) {
+
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        points_[thread]->compute_points(blocks[ind]);
+        double* rhop = points_[thread]->point_value("RHO_A")->pointer();
+        double* gamp = points_[thread]->point_value("GAMMA_AA")->pointer();
+        double* taup = points_[thread]->point_value("TAU_A")->pointer();
+
+        size_t npoints = blocks[ind]->npoints();
+        size_t offset = offsets[ind];
+        for (size_t P = 0; P < npoints; P++) {
             double tau_LSDA = C * pow(rhop[P], 5.0 / 3.0);
             double tau_EX   = taup[P];
             double D_EX   = tau_EX - 0.25 * gamp[P] / rhop[P];
@@ -604,72 +939,141 @@ void CubicScalarGrid::add_ELF(double* v, boost::shared_ptr<Matrix> D)
             double v2 = (fabs(D_LSDA / D_EX) < 1.0E-15 ? 0.0 : 1.0 / (1.0 + B * B));
             v[P + offset] += v2;
         }
-        offset += npoints;
     }
     
-    points_->set_ansatz(0);
+    for (size_t thread = 0; thread < points_.size(); thread++) {
+        points_[thread]->set_ansatz(0);
+    }
+}
+void CubicScalarGrid::compute_fields(FieldType field, boost::shared_ptr<Matrix> M, boost::shared_ptr<Vector> d,
+    const std::vector<int>& indices, const std::vector<std::string>& names, const std::string& type)
+{
+    int nfield = names.size();
+    if (!nfield) return;
+
+    // => Batches of Files (one file per orbital or basis function) <= //
+
+    // Every file of a batch stays open across all slabs, so large basis sets
+    // would hit the descriptor limit. Each batch recomputes the slabs for
+    // its own orbitals or basis functions.
+    if (nfield > CUBE_MAX_OPEN_FILES) {
+        for (int k0 = 0; k0 < nfield; k0 += CUBE_MAX_OPEN_FILES) {
+            int nk = (nfield - k0 < CUBE_MAX_OPEN_FILES ? nfield - k0 : CUBE_MAX_OPEN_FILES);
+            std::vector<std::string> batch_names(names.begin() + k0, names.begin() + k0 + nk);
+            std::vector<int> batch_indices;
+            if ((int) indices.size() == nfield)
+                batch_indices.assign(indices.begin() + k0, indices.begin() + k0 + nk);
+            boost::shared_ptr<Matrix> batch_M = M;
+            if (field == OrbitalField) {
+                batch_M = boost::shared_ptr<Matrix>(new Matrix(M->rowspi()[0], nk));
+                double** Mp = M->pointer();
+                double** Bp = batch_M->pointer();
+                for (int k = 0; k < nk; k++) {
+                    C_DCOPY(M->rowspi()[0], &Mp[0][k0 + k], M->colspi()[0], &Bp[0][k], nk);
+                }
+            }
+            compute_fields(field, batch_M, d, batch_indices, batch_names, type);
+        }
+        return;
+    }
+
+    std::vector<boost::shared_ptr<CubeFileWriter> > files;
+    for (int k = 0; k < nfield; k++) {
+        files.push_back(open_file(names[k], type));
+    }
+
+    // => Slab Storage (the largest slab is the first) <= //
+
+    size_t max_points = slab_npoints(0);
+    double* xs = new double[max_points];
+    double* ys = new double[max_points];
+    double* zs = new double[max_points];
+    double* ws = new double[max_points];
+    double** v = block_matrix(nfield, max_points);
+    double* v2 = new double[max_points];
+
+    std::vector<boost::shared_ptr<BlockOPoints> > blocks;
+    std::vector<size_t> offsets;
+    std::vector<size_t> order;
+
+    // => Compute and drop out each x slab in turn <= //
+
+    for (int istart = 0L; istart <= N_[0]; istart+=nxyz_) {
+        size_t npoints = slab_npoints(istart);
+
+        blocks.clear();
+        offsets.clear();
+        build_slab(istart, xs, ys, zs, ws, 0L, blocks, offsets);
+        slab_order(istart, order);
+
+        memset(v[0],'\0',nfield*max_points*sizeof(double));
+
+        switch (field) {
+            case DensityField:       add_density(v[0], M, blocks, offsets); break;
+            case ESPField:           add_esp(v[0], d, xs, ys, zs, npoints); break;
+            case BasisFunctionField: add_basis_functions(v, indices, blocks, offsets); break;
+            case OrbitalField:       add_orbitals(v, M, blocks, offsets); break;
+            case LOLField:           add_LOL(v[0], M, blocks, offsets); break;
+            case ELFField:           add_ELF(v[0], M, blocks, offsets); break;
+        }
+
+        for (int k = 0; k < nfield; k++) {
+            for (size_t P = 0; P < npoints; P++) {
+                v2[order[P]] = v[k][P];
+            }
+            files[k]->write(v2, npoints);
+        }
+    }
+
+    delete[] xs;
+    delete[] ys;
+    delete[] zs;
+    delete[] ws;
+    delete[] v2;
+    free_block(v);
 }
 void CubicScalarGrid::compute_density(boost::shared_ptr<Matrix> D, const std::string& name, const std::string& type)
 {
-    double* v = new double[npoints_];
-    memset(v,'\0',npoints_*sizeof(double));
-    add_density(v,D);
-    write_gen_file(v,name,type);
-    delete[] v;
+    compute_fields(DensityField, D, boost::shared_ptr<Vector>(), std::vector<int>(), std::vector<std::string>(1, name), type);
 }
 void CubicScalarGrid::compute_esp(boost::shared_ptr<Matrix> D, const std::string& name, const std::string& type)
 {
-    double* v = new double[npoints_];
-    memset(v,'\0',npoints_*sizeof(double));
-    add_esp(v,D);
-    write_gen_file(v,name,type);
-    delete[] v;
+    boost::shared_ptr<Vector> d = esp_coefficients(D);
+    compute_fields(ESPField, boost::shared_ptr<Matrix>(), d, std::vector<int>(), std::vector<std::string>(1, name), type);
 }
 void CubicScalarGrid::compute_basis_functions(const std::vector<int>& indices, const std::string& name, const std::string& type)
 {
-    double** v = block_matrix(indices.size(), npoints_);
-    memset(v[0],'\0',indices.size()*npoints_*sizeof(double));
-    add_basis_functions(v, indices);
-    for (int k = 0; k < indices.size(); k++) {
+    std::vector<std::string> names;
+    for (int k = 0; k < (int) indices.size(); k++) {
         std::stringstream ss; 
         ss << name << "_" << (indices[k] + 1);
-        write_gen_file(v[k],ss.str(),type);
+        names.push_back(ss.str());
     }   
-    free_block(v);
+    compute_fields(BasisFunctionField, boost::shared_ptr<Matrix>(), boost::shared_ptr<Vector>(), indices, names, type);
 }
 void CubicScalarGrid::compute_orbitals(boost::shared_ptr<Matrix> C, const std::vector<int>& indices, const std::string& name, const std::string& type)
 {
     boost::shared_ptr<Matrix> C2(new Matrix(primary_->nbf(), indices.size()));  
     double** Cp  = C->pointer();
     double** C2p = C2->pointer();
-    for (int k = 0; k < indices.size(); k++) {
+    for (int k = 0; k < (int) indices.size(); k++) {
         C_DCOPY(primary_->nbf(), &Cp[0][indices[k]], C->colspi()[0], &C2p[0][k], C2->colspi()[0]); 
     }
-    double** v = block_matrix(indices.size(), npoints_);
-    memset(v[0],'\0',indices.size()*npoints_*sizeof(double));
-    add_orbitals(v, C2);
-    for (int k = 0; k < indices.size(); k++) {
+    std::vector<std::string> names;
+    for (int k = 0; k < (int) indices.size(); k++) {
         std::stringstream ss; 
         ss << name << "_" << (indices[k] + 1);
-        write_gen_file(v[k],ss.str(),type);
+        names.push_back(ss.str());
     }   
-    free_block(v);
+    compute_fields(OrbitalField, C2, boost::shared_ptr<Vector>(), indices, names, type);
 }
 void CubicScalarGrid::compute_LOL(boost::shared_ptr<Matrix> D, const std::string& name, const std::string& type)
 {
-    double* v = new double[npoints_];
-    memset(v,'\0',npoints_*sizeof(double));
-    add_LOL(v,D);
-    write_gen_file(v,name,type);
-    delete[] v;
+    compute_fields(LOLField, D, boost::shared_ptr<Vector>(), std::vector<int>(), std::vector<std::string>(1, name), type);
 }
 void CubicScalarGrid::compute_ELF(boost::shared_ptr<Matrix> D, const std::string& name, const std::string& type)
 {
-    double* v = new double[npoints_];
-    memset(v,'\0',npoints_*sizeof(double));
-    add_ELF(v,D);
-    write_gen_file(v,name,type);
-    delete[] v;
+    compute_fields(ELFField, D, boost::shared_ptr<Vector>(), std::vector<int>(), std::vector<std::string>(1, name), type);
 }
 
 }
@@ -34,6 +34,7 @@ class Options;
 class BasisExtents;
 class RKSFunctions;
 class BlockOPoints;
+class CubeFileWriter;
 
 class CubicScalarGrid {
 
@@ -64,7 +65,7 @@ protected:
     /// Sparsity blocking in all cardinal directions
     size_t nxyz_;
 
-    /// x coordinates of grid
+    /// x coordinates of grid (built on first use by the full-grid routines)
     double* x_;
     /// y coordinates of grid
     double* y_;
@@ -75,17 +76,74 @@ protected:
 
     // => Grid Computers <= //
     
-    /// Vector of blocks 
+    /// Vector of blocks of the full grid (built with x_)
     std::vector<boost::shared_ptr<BlockOPoints> > blocks_;
+    /// Offset of the first point of each block in the fast ordering
+    std::vector<size_t> block_offsets_;
     /// Points to basis extents, built internally
     boost::shared_ptr<BasisExtents> extents_;
-    /// RKS points object
-    boost::shared_ptr<RKSFunctions> points_;
+    /// RKS points objects, one per thread
+    std::vector<boost::shared_ptr<RKSFunctions> > points_;
+    /// Number of local functions points_ are sized for
+    int points_max_functions_;
+
+    // => ESP Fitting Cache <= //
+
+    /// Auxiliary basis of the last ESP fit
+    boost::shared_ptr<BasisSet> esp_auxiliary_;
+    /// Inverse fitting metric J^-1 of the last ESP fit
+    boost::shared_ptr<Matrix> esp_Jinv_;
+    /// DF_BASIS_SCF and DF_FITTING_CONDITION used for esp_Jinv_
+    std::string esp_basis_key_;
+    double esp_condition_;
 
     // => Helper Routines <= //
 
     /// Setup grid from info in N_, D_, O_
     void populate_grid();
+    /// Build x_, y_, z_, w_ and blocks_ for the full-grid routines, if not yet built
+    void build_blocks() const;
+    /// Number of points in the x slab [istart, istart + nxyz_)
+    size_t slab_npoints(int istart) const;
+    /// Points of the x slab starting at istart in fast ordering into x, y, z, w;
+    /// appends its blocks and their offsets (counted from offset0)
+    void build_slab(int istart, double* x, double* y, double* z, double* w, size_t offset0,
+        std::vector<boost::shared_ptr<BlockOPoints> >& blocks, std::vector<size_t>& offsets) const;
+    /// Position in cube (x slowest, z fastest) ordering within the slab of each point
+    /// of the x slab starting at istart in fast ordering
+    void slab_order(int istart, std::vector<size_t>& order) const;
+    /// Make sure the point workers can hold every block in blocks
+    void size_points(const std::vector<boost::shared_ptr<BlockOPoints> >& blocks);
+    /// Auxiliary basis and inverse fitting metric for add_esp, built on first use
+    void build_esp_metric();
+    /// Fitted auxiliary coefficients d of the density D for the ESP
+    boost::shared_ptr<Vector> esp_coefficients(boost::shared_ptr<Matrix> D);
+
+    // => Block-Range Evaluators (v is indexed from the start of the given blocks) <= //
+
+    void add_density(double* v, boost::shared_ptr<Matrix> D,
+        const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, const std::vector<size_t>& offsets);
+    void add_esp(double* v, boost::shared_ptr<Vector> d, double* x, double* y, double* z, size_t npoints);
+    void add_basis_functions(double** v, const std::vector<int>& indices,
+        const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, const std::vector<size_t>& offsets);
+    void add_orbitals(double** v, boost::shared_ptr<Matrix> C,
+        const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, const std::vector<size_t>& offsets);
+    void add_LOL(double* v, boost::shared_ptr<Matrix> D,
+        const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, const std::vector<size_t>& offsets);
+    void add_ELF(double* v, boost::shared_ptr<Matrix> D,
+        const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, const std::vector<size_t>& offsets);
+
+    // => Streaming Output <= //
+
+    /// Kinds of scalar field compute_fields can stream
+    enum FieldType { DensityField, ESPField, BasisFunctionField, OrbitalField, LOLField, ELFField };
+    /// Compute fields one x slab at a time and write each slab to the files in names
+    /// as soon as it is done, so no field is ever held for the whole grid.
+    /// M is the density or orbital matrix, d the ESP fit coefficients.
+    void compute_fields(FieldType field, boost::shared_ptr<Matrix> M, boost::shared_ptr<Vector> d,
+        const std::vector<int>& indices, const std::vector<std::string>& names, const std::string& type);
+    /// Open filepath/name.ext for the given type and write its header
+    boost::shared_ptr<CubeFileWriter> open_file(const std::string& name, const std::string& type);
 
 public:
     // => Constructors <= //
@@ -128,17 +186,24 @@ public:
     size_t nxyz() const { return nxyz_; }
     
     /// x points in fast ordering
-    double* x() const { return x_; } 
+    double* x() const { build_blocks(); return x_; } 
     /// y points in fast ordering
-    double* y() const { return y_; } 
+    double* y() const { build_blocks(); return y_; } 
     /// z points in fast ordering
-    double* z() const { return z_; } 
+    double* z() const { build_blocks(); return z_; } 
     /// w weights (rectangular) in fast ordering
-    double* w() const { return w_; }
+    double* w() const { build_blocks(); return w_; }
 
     // => Low-Level Write Routines (Use only if you know what you are doing) <= //
 
-    /// Write a general file of the scalar field v (in fast ordering) to filepath/name.ext
+    /// Write a general file of the scalar field v (in fast ordering) to filepath/name.ext.
+    /// Types are CUBE (Gaussian cube text, .cube) and BCUBE (binary, .bcube), either
+    /// optionally followed by .GZ for gzip compression (needs zlib).
+    ///
+    /// The BCUBE layout (native byte order) is: the 8 characters "PSI4CUBE", int version (1),
+    /// int natom, int points along x, y, z, double origin[3], double spacing[3],
+    /// natom x double (Z, x, y, z), int length and characters of the property name,
+    /// then the field as doubles in cube (x slowest, z fastest) order.
     void write_gen_file(double* v, const std::string& name, const std::string& type);
     /// Write a Gaussian cube file of the scalar field v (in fast ordering) to filepath/name.cube
     void write_cube_file(double* v, const std::string& name);
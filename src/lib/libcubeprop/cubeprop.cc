@@ -69,6 +69,9 @@ void CubeProperties::common_init()
 {
     grid_ = boost::shared_ptr<CubicScalarGrid>(new CubicScalarGrid(basisset_));
     grid_->set_filepath(options_.get_str("CUBEPROP_FILEPATH"));
+
+    type_ = options_.get_str("CUBEPROP_FORMAT");
+    if (options_.get_bool("CUBEPROP_COMPRESS")) type_ += ".GZ";
 }
 void CubeProperties::print_header()
 {
@@ -161,28 +164,28 @@ void CubeProperties::compute_properties()
 }
 void CubeProperties::compute_density(boost::shared_ptr<Matrix> D, const std::string& key)
 {
-    grid_->compute_density(D, key);
+    grid_->compute_density(D, key, type_);
 }
 void CubeProperties::compute_esp(boost::shared_ptr<Matrix> Dt)
 {
-    grid_->compute_density(Dt, "Dt");
-    grid_->compute_esp(Dt, "ESP"); 
+    grid_->compute_density(Dt, "Dt", type_);
+    grid_->compute_esp(Dt, "ESP", type_); 
 }
 void CubeProperties::compute_orbitals(boost::shared_ptr<Matrix> C, const std::vector<int>& indices, const std::string& key)
 {
-    grid_->compute_orbitals(C, indices, key);
+    grid_->compute_orbitals(C, indices, key, type_);
 }
 void CubeProperties::compute_basis_functions(const std::vector<int>& indices, const std::string& key)
 {
-    grid_->compute_basis_functions(indices, key);
+    grid_->compute_basis_functions(indices, key, type_);
 }
 void CubeProperties::compute_LOL(boost::shared_ptr<Matrix> D, const std::string& key)
 {
-    grid_->compute_LOL(D, key);
+    grid_->compute_LOL(D, key, type_);
 }
 void CubeProperties::compute_ELF(boost::shared_ptr<Matrix> D, const std::string& key)
 {
-    grid_->compute_ELF(D, key);
+    grid_->compute_ELF(D, key, type_);
 }
 
 }
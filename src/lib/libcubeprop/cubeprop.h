@@ -58,6 +58,8 @@ protected:
 
     /// Grid-based property computer
     boost::shared_ptr<CubicScalarGrid> grid_;
+    /// Grid file type passed to grid_ (CUBE, BCUBE, optionally .GZ)
+    std::string type_;
 
     // => Helper Functions <= //
 
@@ -98,25 +98,30 @@ namespace psi {
 ** rqps: IC     ** rqsp: IC
 ** rpqs: IC     ** rpsq: IC
 ** rsqp: IC     ** rspq: IC/OOC
-** sqrp: IC     ** sqpr: none
+** sqrp: IC     ** sqpr: IC
 ** srqp: IC     ** srpq: IC
 ** spqr: IC     ** sprq: IC
-** -RAK, Nov. 2005*/
+** -RAK, Nov. 2005
+**
+** All in-core cases now go through buf4_sort_incore(), a single
+** tiled, OpenMP-threaded kernel driven by a per-pattern index map.
+** The switch below only carries the out-of-core algorithms.
+*/
 
 int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
                     int pqnum, int rsnum, const char *label)
 {
-    int h,nirreps, row, col, my_irrep, r_irrep;
-    int p, q, r, s, P, Q, R, S, pq, rs, sr, pr, qs, qp, rq, qr, ps, sp, rp, sq;
+    int h,nirreps, my_irrep;
+    int p, q, r, s, pq, rs, sr, pr, qs, qp, qr, ps;
     int PQ, RS;
-    int Gp, Gq, Gr, Gs, Gpq, Grs, Gpr, Gqs, Grq, Gqr, Gps, Gsp, Grp, Gsq;
+    int Gp, Gr, Gs, Gpq, Grs, Gpr, Gps;
     dpdbuf4 OutBuf;
     int incore;
     long int rowtot, coltot, core_total, maxrows;
     int Grow, Gcol;
     int out_rows_per_bucket, out_nbuckets, out_rows_left, out_row_start, n;
     int in_rows_per_bucket, in_nbuckets, in_rows_left, in_row_start, m;
-    int rows_per_bucket, nbuckets, rows_left, row_start;
+    int rows_per_bucket, nbuckets, rows_left;
 
     nirreps = InBuf->params->nirreps;
     my_irrep = InBuf->file.my_irrep;
@@ -177,15 +182,32 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
     }
 #endif
 
-    /* Init input and output buffers and read in all blocks of the input */
+    /* In-core: read all blocks of the input and permute with the threaded kernel */
     if(incore) {
         for(h=0; h < nirreps; h++) {
             buf4_mat_irrep_init(&OutBuf, h);
             buf4_mat_irrep_init(InBuf, h);
             buf4_mat_irrep_rd(InBuf, h);
         }
+
+        buf4_sort_incore(InBuf, &OutBuf, index);
+
+        for(h=0; h < nirreps; h++) {
+            buf4_mat_irrep_wrt(&OutBuf, h);
+            buf4_mat_irrep_close(&OutBuf, h);
+            buf4_mat_irrep_close(InBuf, h);
+        }
+
+        buf4_close(&OutBuf);
+
+#ifdef DPD_TIMER
+        timer_off("buf4_sort");
+#endif
+
+        return 0;
     }
 
+    /* Out-of-core algorithms */
     switch(index) {
     case pqrs:
         outfile->Printf( "\nDPD sort error: invalid index ordering.\n");
@@ -199,82 +221,59 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 #endif
 
         /* p->p; q->q; s->r; r->s = pqsr */
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
 
-                for(pq=0; pq < OutBuf.params->rowtot[h]; pq++) {
-                    p = OutBuf.params->roworb[h][pq][0];
-                    q = OutBuf.params->roworb[h][pq][1];
+        for(Gpq=0; Gpq < nirreps; Gpq++) {
+            Grs = Gpq ^ my_irrep;
+            rows_per_bucket = dpd_memfree()/ 2 / InBuf->params->coltot[Grs];
 
-                    row = InBuf->params->rowidx[p][q];
+            if(rows_per_bucket > InBuf->params->rowtot[Gpq])
+                rows_per_bucket = InBuf->params->rowtot[Gpq];
+            if(!rows_per_bucket) dpd_error("buf4_sort_pqsr: Not enough memory for one row!", "outfile");
 
-                    for(rs=0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                        r = OutBuf.params->colorb[r_irrep][rs][0];
-                        s = OutBuf.params->colorb[r_irrep][rs][1];
+            nbuckets = (int) ceil(((double) InBuf->params->rowtot[Gpq])/((double) rows_per_bucket));
+            if(nbuckets == 1) rows_left = rows_per_bucket;
+            else rows_left = InBuf->params->rowtot[Gpq] % rows_per_bucket;
 
-                        sr = InBuf->params->colidx[s][r];
-
-                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][row][sr];
-                    }
-                }
-            }
-        }
-        else { /* out-of-core pqsr -> pqrs */
-
-            for(Gpq=0; Gpq < nirreps; Gpq++) {
-                Grs = Gpq ^ my_irrep;
-                rows_per_bucket = dpd_memfree()/ 2 / InBuf->params->coltot[Grs];
+            buf4_mat_irrep_init_block(InBuf, Gpq, rows_per_bucket);
+            buf4_mat_irrep_init_block(&OutBuf, Gpq, rows_per_bucket);
 
-                if(rows_per_bucket > InBuf->params->rowtot[Gpq])
-                    rows_per_bucket = InBuf->params->rowtot[Gpq];
-                if(!rows_per_bucket) dpd_error("buf4_sort_pqsr: Not enough memory for one row!", "outfile");
+            for(n=0; n < (rows_left ? nbuckets-1 : nbuckets); n++) {
 
-                nbuckets = (int) ceil(((double) InBuf->params->rowtot[Gpq])/((double) rows_per_bucket));
-                if(nbuckets == 1) rows_left = rows_per_bucket;
-                else rows_left = InBuf->params->rowtot[Gpq] % rows_per_bucket;
+                buf4_mat_irrep_rd_block(InBuf, Gpq, n*rows_per_bucket, rows_per_bucket);
 
-                buf4_mat_irrep_init_block(InBuf, Gpq, rows_per_bucket);
-                buf4_mat_irrep_init_block(&OutBuf, Gpq, rows_per_bucket);
+                for(pq=0; pq < rows_per_bucket; pq++) {
+                    for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                        r = OutBuf.params->colorb[Grs][rs][0];
+                        s = OutBuf.params->colorb[Grs][rs][1];
 
-                for(n=0; n < (rows_left ? nbuckets-1 : nbuckets); n++) {
-
-                    buf4_mat_irrep_rd_block(InBuf, Gpq, n*rows_per_bucket, rows_per_bucket);
-
-                    for(pq=0; pq < rows_per_bucket; pq++) {
-                        for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                            r = OutBuf.params->colorb[Grs][rs][0];
-                            s = OutBuf.params->colorb[Grs][rs][1];
-
-                            sr = InBuf->params->colidx[s][r];
+                        sr = InBuf->params->colidx[s][r];
 
-                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][pq][sr];
-                        }
+                        OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][pq][sr];
                     }
-
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, n*rows_per_bucket, rows_per_bucket);
                 }
-                if(rows_left) {
 
-                    buf4_mat_irrep_rd_block(InBuf, Gpq, n*rows_per_bucket, rows_left);
+                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, n*rows_per_bucket, rows_per_bucket);
+            }
+            if(rows_left) {
 
-                    for(pq=0; pq < rows_left; pq++) {
-                        for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                            r = OutBuf.params->colorb[Grs][rs][0];
-                            s = OutBuf.params->colorb[Grs][rs][1];
+                buf4_mat_irrep_rd_block(InBuf, Gpq, n*rows_per_bucket, rows_left);
 
-                            sr = InBuf->params->colidx[s][r];
+                for(pq=0; pq < rows_left; pq++) {
+                    for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                        r = OutBuf.params->colorb[Grs][rs][0];
+                        s = OutBuf.params->colorb[Grs][rs][1];
 
-                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][pq][sr];
-                        }
-                    }
+                        sr = InBuf->params->colidx[s][r];
 
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, n*rows_per_bucket, rows_left);
+                        OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][pq][sr];
+                    }
                 }
 
-                buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
-                buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
+                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, n*rows_per_bucket, rows_left);
             }
+
+            buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
+            buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
         }
 
 #ifdef DPD_TIMER
@@ -289,223 +288,180 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 #endif
 
         /* p->p; r->q; q->r; s->s = prqs */
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
 
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
+        for(Gpq=0; Gpq < nirreps; Gpq++) {
+            Grs = Gpq^my_irrep;
 
-                        /* Irreps on the source */
-                        Gpr = Gp^Gr;  Gqs = Gq^Gs;
+            out_rows_per_bucket = dpd_memfree()/(2 * OutBuf.params->coltot[Grs]);
+            if(out_rows_per_bucket > OutBuf.params->rowtot[Gpq])
+                out_rows_per_bucket = OutBuf.params->rowtot[Gpq];
+            out_nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) out_rows_per_bucket);
+            if(out_nbuckets == 1) out_rows_left = out_rows_per_bucket;
+            else out_rows_left = OutBuf.params->rowtot[Gpq] % out_rows_per_bucket;
 
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
+            /* allocate space for the bucket of rows */
+            buf4_mat_irrep_init_block(&OutBuf, Gpq, out_rows_per_bucket);
 
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    pr = InBuf->params->rowidx[P][R];
+            for(n=0; n < (out_rows_left ? out_nbuckets-1 : out_nbuckets); n++) {
 
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        qs = InBuf->params->colidx[Q][S];
+                out_row_start = n*out_rows_per_bucket;
 
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gpr][pr][qs];
+                for(Grow=0; Grow < nirreps; Grow++) { /*Grow = Gpr*/
+                    Gcol = Grow^my_irrep;               /*Gcol = Gqs*/
 
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else { /* pqrs <- prqs */
-
-            for(Gpq=0; Gpq < nirreps; Gpq++) {
-                Grs = Gpq^my_irrep;
-
-                out_rows_per_bucket = dpd_memfree()/(2 * OutBuf.params->coltot[Grs]);
-                if(out_rows_per_bucket > OutBuf.params->rowtot[Gpq])
-                    out_rows_per_bucket = OutBuf.params->rowtot[Gpq];
-                out_nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) out_rows_per_bucket);
-                if(out_nbuckets == 1) out_rows_left = out_rows_per_bucket;
-                else out_rows_left = OutBuf.params->rowtot[Gpq] % out_rows_per_bucket;
-
-                /* allocate space for the bucket of rows */
-                buf4_mat_irrep_init_block(&OutBuf, Gpq, out_rows_per_bucket);
-
-                for(n=0; n < (out_rows_left ? out_nbuckets-1 : out_nbuckets); n++) {
-
-                    out_row_start = n*out_rows_per_bucket;
+                    /* determine how many rows of InBuf we can store in the other half of the core */
+                    in_rows_per_bucket = dpd_memfree()/(2 * InBuf->params->coltot[Gcol]);
+                    if(in_rows_per_bucket > InBuf->params->rowtot[Grow])
+                        in_rows_per_bucket = InBuf->params->rowtot[Grow];
+                    in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grow]/(double) in_rows_per_bucket);
+                    if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
+                    else in_rows_left = InBuf->params->rowtot[Grow] % in_rows_per_bucket;
 
-                    for(Grow=0; Grow < nirreps; Grow++) { /*Grow = Gpr*/
-                        Gcol = Grow^my_irrep;               /*Gcol = Gqs*/
+                    /* allocate space for the bucket of rows */
+                    buf4_mat_irrep_init_block(InBuf, Grow, in_rows_per_bucket);
 
-                        /* determine how many rows of InBuf we can store in the other half of the core */
-                        in_rows_per_bucket = dpd_memfree()/(2 * InBuf->params->coltot[Gcol]);
-                        if(in_rows_per_bucket > InBuf->params->rowtot[Grow])
-                            in_rows_per_bucket = InBuf->params->rowtot[Grow];
-                        in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grow]/(double) in_rows_per_bucket);
-                        if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
-                        else in_rows_left = InBuf->params->rowtot[Grow] % in_rows_per_bucket;
+                    /* pqrs <- prqs */
+                    for(m=0; m < (in_rows_left ? in_nbuckets-1 : in_nbuckets); m++) {
 
-                        /* allocate space for the bucket of rows */
-                        buf4_mat_irrep_init_block(InBuf, Grow, in_rows_per_bucket);
+                        in_row_start = m*in_rows_per_bucket;
+                        buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_per_bucket);
 
-                        /* pqrs <- prqs */
-                        for(m=0; m < (in_rows_left ? in_nbuckets-1 : in_nbuckets); m++) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_per_bucket);
-
-                            for(pq=0; pq < out_rows_per_bucket; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-                                    Gpr = Gp^Gr;
-
-                                    if(Gpr == Grow) {
-                                        pr = InBuf->params->rowidx[p][r] - in_row_start;
-                                        /* check if the current value is in the current in_bucket or not */
-                                        if(pr >= 0 && pr < in_rows_per_bucket) {
-                                            qs = InBuf->params->colidx[q][s];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
-                                        }
+                        for(pq=0; pq < out_rows_per_bucket; pq++) {
+                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                            Gp = OutBuf.params->psym[p];
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                Gr = OutBuf.params->rsym[r];
+                                Gs = Grs^Gr;
+                                Gpr = Gp^Gr;
+
+                                if(Gpr == Grow) {
+                                    pr = InBuf->params->rowidx[p][r] - in_row_start;
+                                    /* check if the current value is in the current in_bucket or not */
+                                    if(pr >= 0 && pr < in_rows_per_bucket) {
+                                        qs = InBuf->params->colidx[q][s];
+                                        OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
                                     }
                                 }
                             }
                         }
-                        if(in_rows_left) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_left);
-
-                            /* pqrs <- prqs */
-                            for(pq=0; pq < out_rows_per_bucket; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-                                    Gpr = Gp^Gr;
-
-                                    if(Gpr == Grow) {
-                                        pr = InBuf->params->rowidx[p][r] - in_row_start;
-                                        /* check if the current value is in core or not */
-                                        if(pr >= 0 && pr < in_rows_left) {
-                                            qs = InBuf->params->colidx[q][s];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
-                                        }
+                    }
+                    if(in_rows_left) {
+
+                        in_row_start = m*in_rows_per_bucket;
+                        buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_left);
+
+                        /* pqrs <- prqs */
+                        for(pq=0; pq < out_rows_per_bucket; pq++) {
+                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                            Gp = OutBuf.params->psym[p];
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                Gr = OutBuf.params->rsym[r];
+                                Gs = Grs^Gr;
+                                Gpr = Gp^Gr;
+
+                                if(Gpr == Grow) {
+                                    pr = InBuf->params->rowidx[p][r] - in_row_start;
+                                    /* check if the current value is in core or not */
+                                    if(pr >= 0 && pr < in_rows_left) {
+                                        qs = InBuf->params->colidx[q][s];
+                                        OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
                                     }
                                 }
                             }
                         }
-                        buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                     }
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_per_bucket);
+                    buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                 }
-                if(out_rows_left) {
+                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_per_bucket);
+            }
+            if(out_rows_left) {
 
-                    out_row_start = n*out_rows_per_bucket;
+                out_row_start = n*out_rows_per_bucket;
 
-                    for(Grow=0; Grow < nirreps; Grow++) {
-                        Gcol = Grow^my_irrep;
+                for(Grow=0; Grow < nirreps; Grow++) {
+                    Gcol = Grow^my_irrep;
 
-                        /* determine how many rows of InBuf we can store in the other half of the core */
-                        in_rows_per_bucket = dpd_memfree()/(2 * InBuf->params->coltot[Gcol]);
-                        if(in_rows_per_bucket > InBuf->params->rowtot[Grow])
-                            in_rows_per_bucket = InBuf->params->rowtot[Grow];
-                        in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grow]/(double) in_rows_per_bucket);
-                        if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
-                        else in_rows_left = InBuf->params->rowtot[Grow] % in_rows_per_bucket;
+                    /* determine how many rows of InBuf we can store in the other half of the core */
+                    in_rows_per_bucket = dpd_memfree()/(2 * InBuf->params->coltot[Gcol]);
+                    if(in_rows_per_bucket > InBuf->params->rowtot[Grow])
+                        in_rows_per_bucket = InBuf->params->rowtot[Grow];
+                    in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grow]/(double) in_rows_per_bucket);
+                    if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
+                    else in_rows_left = InBuf->params->rowtot[Grow] % in_rows_per_bucket;
 
-                        /* allocate space for the bucket of rows */
-                        buf4_mat_irrep_init_block(InBuf, Grow, in_rows_per_bucket);
+                    /* allocate space for the bucket of rows */
+                    buf4_mat_irrep_init_block(InBuf, Grow, in_rows_per_bucket);
 
-                        /* pqrs <- prqs */
-                        for(m=0; m < (in_rows_left ? in_nbuckets-1 : in_nbuckets); m++) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_per_bucket);
-
-                            for(pq=0; pq < out_rows_left; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-                                    Gpr = Gp^Gr;
-
-                                    if(Gpr == Grow) {
-                                        pr = InBuf->params->rowidx[p][r] - in_row_start;
-                                        /* check if the current value is in the current in_bucket or not */
-                                        if(pr >= 0 && pr < in_rows_per_bucket) {
-                                            qs = InBuf->params->colidx[q][s];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
-                                        }
+                    /* pqrs <- prqs */
+                    for(m=0; m < (in_rows_left ? in_nbuckets-1 : in_nbuckets); m++) {
+
+                        in_row_start = m*in_rows_per_bucket;
+                        buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_per_bucket);
+
+                        for(pq=0; pq < out_rows_left; pq++) {
+                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                            Gp = OutBuf.params->psym[p];
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                Gr = OutBuf.params->rsym[r];
+                                Gs = Grs^Gr;
+                                Gpr = Gp^Gr;
+
+                                if(Gpr == Grow) {
+                                    pr = InBuf->params->rowidx[p][r] - in_row_start;
+                                    /* check if the current value is in the current in_bucket or not */
+                                    if(pr >= 0 && pr < in_rows_per_bucket) {
+                                        qs = InBuf->params->colidx[q][s];
+                                        OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
                                     }
                                 }
                             }
-
                         }
-                        if(in_rows_left) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_left);
-
-                            for(pq=0; pq < out_rows_left; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-                                    Gpr = Gp^Gr;
-
-                                    if(Gpr == Grow) {
-                                        pr = InBuf->params->rowidx[p][r] - in_row_start;
-                                        /* check if the current value is in core or not */
-                                        if(pr >= 0 && pr < in_rows_left) {
-                                            qs = InBuf->params->colidx[q][s];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
-                                        }
+
+                    }
+                    if(in_rows_left) {
+
+                        in_row_start = m*in_rows_per_bucket;
+                        buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_left);
+
+                        for(pq=0; pq < out_rows_left; pq++) {
+                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                            Gp = OutBuf.params->psym[p];
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                Gr = OutBuf.params->rsym[r];
+                                Gs = Grs^Gr;
+                                Gpr = Gp^Gr;
+
+                                if(Gpr == Grow) {
+                                    pr = InBuf->params->rowidx[p][r] - in_row_start;
+                                    /* check if the current value is in core or not */
+                                    if(pr >= 0 && pr < in_rows_left) {
+                                        qs = InBuf->params->colidx[q][s];
+                                        OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
                                     }
                                 }
                             }
                         }
-
-                        buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                     }
 
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_left);
+                    buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                 }
 
-                buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
+                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_left);
             }
+
+            buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
         }
 
 #ifdef DPD_TIMER
@@ -521,222 +477,181 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* p->p; r->q; s->r; q->s = psqr */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
+        for(Gpq=0; Gpq < nirreps; Gpq++) {
+            Grs = Gpq^my_irrep;
+
+            /* determine how many rows of OutBuf we can store in half of the core */
+            out_rows_per_bucket = dpd_memfree()/(2 * OutBuf.params->coltot[Grs]);
+            if(out_rows_per_bucket > OutBuf.params->rowtot[Gpq])
+                out_rows_per_bucket = OutBuf.params->rowtot[Gpq];
+            out_nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) out_rows_per_bucket);
+            if(out_nbuckets == 1) out_rows_left = out_rows_per_bucket;
+            else out_rows_left = OutBuf.params->rowtot[Gpq] % out_rows_per_bucket;
+
+            /* allocate space for the bucket of rows */
+            buf4_mat_irrep_init_block(&OutBuf, Gpq, out_rows_per_bucket);
+
+            for(n=0; n < (out_rows_left ? out_nbuckets-1 : out_nbuckets); n++) {
 
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
+                out_row_start = n*out_rows_per_bucket;
 
-                        Gps = Gp^Gs;  Gqr = Gq^Gr;
+                for(Grow=0; Grow < nirreps; Grow++) {
+                    Gcol = Grow^my_irrep;
 
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
+                    /* determine how many rows of InBuf we can store in the other half of the core */
+                    in_rows_per_bucket = dpd_memfree()/(2 * InBuf->params->coltot[Gcol]);
+                    if(in_rows_per_bucket > InBuf->params->rowtot[Grow])
+                        in_rows_per_bucket = InBuf->params->rowtot[Grow];
+                    in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grow]/(double) in_rows_per_bucket);
+                    if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
+                    else in_rows_left = InBuf->params->rowtot[Grow] % in_rows_per_bucket;
 
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    qr = InBuf->params->colidx[Q][R];
+                    /* allocate space for the bucket of rows */
+                    buf4_mat_irrep_init_block(InBuf, Grow, in_rows_per_bucket);
 
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        ps = InBuf->params->rowidx[P][S];
+                    for(m=0; m < (in_rows_left ? in_nbuckets-1 : in_nbuckets); m++) {
 
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gps][ps][qr];
+                        in_row_start = m*in_rows_per_bucket;
+                        buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_per_bucket);
+
+                        for(pq=0; pq < out_rows_per_bucket; pq++) {
+                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                            Gp = OutBuf.params->psym[p];
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                Gr = OutBuf.params->rsym[r];
+                                Gs = Grs^Gr;
+
+                                Gps = Gp^Gs;
+
+                                if(Gps == Grow) {
+                                    ps = InBuf->params->rowidx[p][s] - in_row_start;
+                                    /* check if the current value is in the current in_bucket or not */
+                                    if(ps >= 0 && ps < in_rows_per_bucket) {
+                                        qr = InBuf->params->colidx[q][r];
+                                        OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][ps][qr];
                                     }
                                 }
                             }
                         }
                     }
-                }
-            }
-        }
-        else {
-            for(Gpq=0; Gpq < nirreps; Gpq++) {
-                Grs = Gpq^my_irrep;
-
-                /* determine how many rows of OutBuf we can store in half of the core */
-                out_rows_per_bucket = dpd_memfree()/(2 * OutBuf.params->coltot[Grs]);
-                if(out_rows_per_bucket > OutBuf.params->rowtot[Gpq])
-                    out_rows_per_bucket = OutBuf.params->rowtot[Gpq];
-                out_nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) out_rows_per_bucket);
-                if(out_nbuckets == 1) out_rows_left = out_rows_per_bucket;
-                else out_rows_left = OutBuf.params->rowtot[Gpq] % out_rows_per_bucket;
-
-                /* allocate space for the bucket of rows */
-                buf4_mat_irrep_init_block(&OutBuf, Gpq, out_rows_per_bucket);
-
-                for(n=0; n < (out_rows_left ? out_nbuckets-1 : out_nbuckets); n++) {
-
-                    out_row_start = n*out_rows_per_bucket;
-
-                    for(Grow=0; Grow < nirreps; Grow++) {
-                        Gcol = Grow^my_irrep;
-
-                        /* determine how many rows of InBuf we can store in the other half of the core */
-                        in_rows_per_bucket = dpd_memfree()/(2 * InBuf->params->coltot[Gcol]);
-                        if(in_rows_per_bucket > InBuf->params->rowtot[Grow])
-                            in_rows_per_bucket = InBuf->params->rowtot[Grow];
-                        in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grow]/(double) in_rows_per_bucket);
-                        if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
-                        else in_rows_left = InBuf->params->rowtot[Grow] % in_rows_per_bucket;
-
-                        /* allocate space for the bucket of rows */
-                        buf4_mat_irrep_init_block(InBuf, Grow, in_rows_per_bucket);
-
-                        for(m=0; m < (in_rows_left ? in_nbuckets-1 : in_nbuckets); m++) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_per_bucket);
-
-                            for(pq=0; pq < out_rows_per_bucket; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-
-                                    Gps = Gp^Gs;
-
-                                    if(Gps == Grow) {
-                                        ps = InBuf->params->rowidx[p][s] - in_row_start;
-                                        /* check if the current value is in the current in_bucket or not */
-                                        if(ps >= 0 && ps < in_rows_per_bucket) {
-                                            qr = InBuf->params->colidx[q][r];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][ps][qr];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        if(in_rows_left) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_left);
-
-                            for(pq=0; pq < out_rows_per_bucket; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-
-                                    Gps = Gp^Gs;
-
-                                    if(Gps == Grow) {
-                                        ps = InBuf->params->rowidx[p][s] - in_row_start;
-                                        /* check if the current value is in core or not */
-                                        if(ps >= 0 && ps < in_rows_left) {
-                                            qr = InBuf->params->colidx[q][r];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][ps][qr];
-                                        }
+                    if(in_rows_left) {
+
+                        in_row_start = m*in_rows_per_bucket;
+                        buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_left);
+
+                        for(pq=0; pq < out_rows_per_bucket; pq++) {
+                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                            Gp = OutBuf.params->psym[p];
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                Gr = OutBuf.params->rsym[r];
+                                Gs = Grs^Gr;
+
+                                Gps = Gp^Gs;
+
+                                if(Gps == Grow) {
+                                    ps = InBuf->params->rowidx[p][s] - in_row_start;
+                                    /* check if the current value is in core or not */
+                                    if(ps >= 0 && ps < in_rows_left) {
+                                        qr = InBuf->params->colidx[q][r];
+                                        OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][ps][qr];
                                     }
                                 }
                             }
                         }
-                        buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                     }
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_per_bucket);
+                    buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                 }
-                if(out_rows_left) {
-
-                    out_row_start = n*out_rows_per_bucket;
-
-                    for(Grow=0; Grow < nirreps; Grow++) {
-                        Gcol = Grow^my_irrep;
-
-                        /* determine how many rows of InBuf we can store in the other half of the core */
-                        in_rows_per_bucket = dpd_memfree()/(2 * InBuf->params->coltot[Gcol]);
-                        if(in_rows_per_bucket > InBuf->params->rowtot[Grow])
-                            in_rows_per_bucket = InBuf->params->rowtot[Grow];
-                        in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grow]/(double) in_rows_per_bucket);
-                        if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
-                        else in_rows_left = InBuf->params->rowtot[Grow] % in_rows_per_bucket;
-
-                        /* allocate space for the bucket of rows */
-                        buf4_mat_irrep_init_block(InBuf, Grow, in_rows_per_bucket);
-
-                        for(m=0; m < (in_rows_left ? in_nbuckets-1 : in_nbuckets); m++) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_per_bucket);
-
-                            for(pq=0; pq < out_rows_left; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-
-                                    Gps = Gp^Gs;
-
-                                    if(Gps == Grow) {
-                                        ps = InBuf->params->rowidx[p][s] - in_row_start;
-                                        /* check if the current value is in the current in_bucket or not */
-                                        if(ps >= 0 && ps < in_rows_per_bucket) {
-                                            qr = InBuf->params->colidx[q][r];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][ps][qr];
-                                        }
+                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_per_bucket);
+            }
+            if(out_rows_left) {
+
+                out_row_start = n*out_rows_per_bucket;
+
+                for(Grow=0; Grow < nirreps; Grow++) {
+                    Gcol = Grow^my_irrep;
+
+                    /* determine how many rows of InBuf we can store in the other half of the core */
+                    in_rows_per_bucket = dpd_memfree()/(2 * InBuf->params->coltot[Gcol]);
+                    if(in_rows_per_bucket > InBuf->params->rowtot[Grow])
+                        in_rows_per_bucket = InBuf->params->rowtot[Grow];
+                    in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grow]/(double) in_rows_per_bucket);
+                    if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
+                    else in_rows_left = InBuf->params->rowtot[Grow] % in_rows_per_bucket;
+
+                    /* allocate space for the bucket of rows */
+                    buf4_mat_irrep_init_block(InBuf, Grow, in_rows_per_bucket);
+
+                    for(m=0; m < (in_rows_left ? in_nbuckets-1 : in_nbuckets); m++) {
+
+                        in_row_start = m*in_rows_per_bucket;
+                        buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_per_bucket);
+
+                        for(pq=0; pq < out_rows_left; pq++) {
+                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                            Gp = OutBuf.params->psym[p];
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                Gr = OutBuf.params->rsym[r];
+                                Gs = Grs^Gr;
+
+                                Gps = Gp^Gs;
+
+                                if(Gps == Grow) {
+                                    ps = InBuf->params->rowidx[p][s] - in_row_start;
+                                    /* check if the current value is in the current in_bucket or not */
+                                    if(ps >= 0 && ps < in_rows_per_bucket) {
+                                        qr = InBuf->params->colidx[q][r];
+                                        OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][ps][qr];
                                     }
                                 }
                             }
-
                         }
-                        if(in_rows_left) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_left);
-
-                            for(pq=0; pq < out_rows_left; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-
-                                    Gps = Gp^Gs;
-
-                                    if(Gps == Grow) {
-                                        ps = InBuf->params->rowidx[p][s] - in_row_start;
-                                        /* check if the current value is in core or not */
-                                        if(ps >= 0 && ps < in_rows_left) {
-                                            qr = InBuf->params->colidx[q][r];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][ps][qr];
-                                        }
+
+                    }
+                    if(in_rows_left) {
+
+                        in_row_start = m*in_rows_per_bucket;
+                        buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_left);
+
+                        for(pq=0; pq < out_rows_left; pq++) {
+                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                            Gp = OutBuf.params->psym[p];
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                Gr = OutBuf.params->rsym[r];
+                                Gs = Grs^Gr;
+
+                                Gps = Gp^Gs;
+
+                                if(Gps == Grow) {
+                                    ps = InBuf->params->rowidx[p][s] - in_row_start;
+                                    /* check if the current value is in core or not */
+                                    if(ps >= 0 && ps < in_rows_left) {
+                                        qr = InBuf->params->colidx[q][r];
+                                        OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][ps][qr];
                                     }
                                 }
                             }
                         }
-
-                        buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                     }
 
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_left);
+                    buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
                 }
 
-                buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
+                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_left);
             }
+
+            buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
         }
 
 #ifdef DPD_TIMER
@@ -752,46 +667,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* p->p; s->q; q->r; r->s = prsq */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Gpr = Gp^Gr;  Gsq = Gs^Gq;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    pr = InBuf->params->rowidx[P][R];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        sq = InBuf->params->colidx[S][Q];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gpr][pr][sq];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for psqr sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for psqr sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("psqr");
@@ -806,46 +683,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* p->p; s->q; r->r; q->s = psrq */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Gps = Gp^Gs;  Grq = Gr^Gq;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    rq = InBuf->params->colidx[R][Q];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        ps = InBuf->params->rowidx[P][S];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gps][ps][rq];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for psrq sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for psrq sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("psrq");
@@ -860,121 +699,98 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* q->p; p->q; r->r; s->s = qprs */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
+        for(Gpq=0; Gpq < nirreps; Gpq++) {
+            Grs = Gpq ^ my_irrep;
 
-                for(pq=0; pq < OutBuf.params->rowtot[h]; pq++) {
-                    p = OutBuf.params->roworb[h][pq][0];
-                    q = OutBuf.params->roworb[h][pq][1];
-                    qp = InBuf->params->rowidx[q][p];
+            /* determine how many rows of OutBuf/InBuf we can store in half the core */
+            rows_per_bucket = dpd_memfree()/(2 * OutBuf.params->coltot[Grs]);
+            if(rows_per_bucket > OutBuf.params->rowtot[Gpq])
+                rows_per_bucket = OutBuf.params->rowtot[Gpq];
+            nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) rows_per_bucket);
+            if(nbuckets == 1) rows_left = rows_per_bucket;
+            else rows_left = OutBuf.params->rowtot[Gpq] % rows_per_bucket;
 
-                    for(rs=0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                        r = OutBuf.params->colorb[r_irrep][rs][0];
-                        s = OutBuf.params->colorb[r_irrep][rs][1];
+            /* allocate space for the bucket of rows */
+            buf4_mat_irrep_init_block(&OutBuf, Gpq, rows_per_bucket);
+            buf4_mat_irrep_init_block(InBuf, Gpq, rows_per_bucket);
 
-                        col = InBuf->params->colidx[r][s];
+            for(n=0; n < (rows_left ? nbuckets-1 : nbuckets); n++) {
 
-                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][qp][col];
-                    }
-                }
+                out_row_start = n * rows_per_bucket;
 
-            }
-        }
-        else {
-            for(Gpq=0; Gpq < nirreps; Gpq++) {
-                Grs = Gpq ^ my_irrep;
-
-                /* determine how many rows of OutBuf/InBuf we can store in half the core */
-                rows_per_bucket = dpd_memfree()/(2 * OutBuf.params->coltot[Grs]);
-                if(rows_per_bucket > OutBuf.params->rowtot[Gpq])
-                    rows_per_bucket = OutBuf.params->rowtot[Gpq];
-                nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) rows_per_bucket);
-                if(nbuckets == 1) rows_left = rows_per_bucket;
-                else rows_left = OutBuf.params->rowtot[Gpq] % rows_per_bucket;
-
-                /* allocate space for the bucket of rows */
-                buf4_mat_irrep_init_block(&OutBuf, Gpq, rows_per_bucket);
-                buf4_mat_irrep_init_block(InBuf, Gpq, rows_per_bucket);
-
-                for(n=0; n < (rows_left ? nbuckets-1 : nbuckets); n++) {
-
-                    out_row_start = n * rows_per_bucket;
-
-                    for(m=0; m < (rows_left ? nbuckets-1 : nbuckets); m++) {
-                        in_row_start = m * rows_per_bucket;
-                        buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_per_bucket);
-                        for(pq=0; pq < rows_per_bucket; pq++) {
-                            /* check to see if this row is contained in the current input-bucket */
-                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                            qp = InBuf->params->rowidx[q][p] - in_row_start;
-                            if(qp >= 0 && qp < rows_per_bucket) {
-                                C_DCOPY(OutBuf.params->coltot[Grs], InBuf->matrix[Gpq][qp], 1,
-                                        OutBuf.matrix[Gpq][pq], 1);
-                            }
+                for(m=0; m < (rows_left ? nbuckets-1 : nbuckets); m++) {
+                    in_row_start = m * rows_per_bucket;
+                    buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_per_bucket);
+                    for(pq=0; pq < rows_per_bucket; pq++) {
+                        /* check to see if this row is contained in the current input-bucket */
+                        p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                        q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                        qp = InBuf->params->rowidx[q][p] - in_row_start;
+                        if(qp >= 0 && qp < rows_per_bucket) {
+                            C_DCOPY(OutBuf.params->coltot[Grs], InBuf->matrix[Gpq][qp], 1,
+                                    OutBuf.matrix[Gpq][pq], 1);
                         }
                     }
+                }
 
-                    if(rows_left) {
-                        in_row_start = m * rows_per_bucket;
-                        buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_left);
-                        for(pq=0; pq < rows_per_bucket; pq++) {
-                            /* check to see if this row is contained in the current input-bucket */
-                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                            qp = InBuf->params->rowidx[q][p] - in_row_start;
-                            if(qp >= 0 && qp < rows_left) {
-                                C_DCOPY(OutBuf.params->coltot[Grs], InBuf->matrix[Gpq][qp], 1,
-                                        OutBuf.matrix[Gpq][pq], 1);
-                            }
+                if(rows_left) {
+                    in_row_start = m * rows_per_bucket;
+                    buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_left);
+                    for(pq=0; pq < rows_per_bucket; pq++) {
+                        /* check to see if this row is contained in the current input-bucket */
+                        p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                        q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                        qp = InBuf->params->rowidx[q][p] - in_row_start;
+                        if(qp >= 0 && qp < rows_left) {
+                            C_DCOPY(OutBuf.params->coltot[Grs], InBuf->matrix[Gpq][qp], 1,
+                                    OutBuf.matrix[Gpq][pq], 1);
                         }
                     }
+                }
 
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_per_bucket);
+                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_per_bucket);
 
-                } /* n */
-                if(rows_left) {
+            } /* n */
+            if(rows_left) {
 
-                    out_row_start = n * rows_per_bucket;
+                out_row_start = n * rows_per_bucket;
 
-                    for(m=0; m < (rows_left ? nbuckets-1 : nbuckets); m++) {
-                        in_row_start = m * rows_per_bucket;
-                        buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_per_bucket);
-                        for(pq=0; pq < rows_left; pq++) {
-                            /* check to see if this row is contained in the current input-bucket */
-                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                            qp = InBuf->params->rowidx[q][p] - in_row_start;
-                            if(qp >= 0 && qp < rows_per_bucket) {
-                                C_DCOPY(OutBuf.params->coltot[Grs], InBuf->matrix[Gpq][qp], 1,
-                                        OutBuf.matrix[Gpq][pq], 1);
-                            }
+                for(m=0; m < (rows_left ? nbuckets-1 : nbuckets); m++) {
+                    in_row_start = m * rows_per_bucket;
+                    buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_per_bucket);
+                    for(pq=0; pq < rows_left; pq++) {
+                        /* check to see if this row is contained in the current input-bucket */
+                        p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                        q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                        qp = InBuf->params->rowidx[q][p] - in_row_start;
+                        if(qp >= 0 && qp < rows_per_bucket) {
+                            C_DCOPY(OutBuf.params->coltot[Grs], InBuf->matrix[Gpq][qp], 1,
+                                    OutBuf.matrix[Gpq][pq], 1);
                         }
                     }
+                }
 
-                    if(rows_left) {
-                        in_row_start = m * rows_per_bucket;
-                        buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_left);
-                        for(pq=0; pq < rows_left; pq++) {
-                            /* check to see if this row is contained in the current input-bucket */
-                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                            qp = InBuf->params->rowidx[q][p] - in_row_start;
-                            if(qp >= 0 && qp < rows_left) {
-                                C_DCOPY(OutBuf.params->coltot[Grs], InBuf->matrix[Gpq][qp], 1,
-                                        OutBuf.matrix[Gpq][pq], 1);
-                            }
+                if(rows_left) {
+                    in_row_start = m * rows_per_bucket;
+                    buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_left);
+                    for(pq=0; pq < rows_left; pq++) {
+                        /* check to see if this row is contained in the current input-bucket */
+                        p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                        q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                        qp = InBuf->params->rowidx[q][p] - in_row_start;
+                        if(qp >= 0 && qp < rows_left) {
+                            C_DCOPY(OutBuf.params->coltot[Grs], InBuf->matrix[Gpq][qp], 1,
+                                    OutBuf.matrix[Gpq][pq], 1);
                         }
                     }
-
                 }
 
-                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_left);
-                buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
-                buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
-            } /* Gpq */
-        }
+            }
+
+            buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_left);
+            buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
+            buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
+        } /* Gpq */
 #ifdef DPD_TIMER
         timer_off("qprs");
 #endif
@@ -988,153 +804,131 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* q->p; p->q; s->r; r->s = qpsr */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(pq=0; pq < OutBuf.params->rowtot[h]; pq++) {
-                    p = OutBuf.params->roworb[h][pq][0];
-                    q = OutBuf.params->roworb[h][pq][1];
-                    qp = InBuf->params->rowidx[q][p];
 
-                    for(rs=0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                        r = OutBuf.params->colorb[r_irrep][rs][0];
-                        s = OutBuf.params->colorb[r_irrep][rs][1];
-                        sr = InBuf->params->colidx[s][r];
-
-                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][qp][sr];
-                    }
-                }
-
-            }
-        }
-        else {
+        for(Gpq=0; Gpq < nirreps; Gpq++) {
+            Grs = Gpq ^ my_irrep;
 
-            for(Gpq=0; Gpq < nirreps; Gpq++) {
-                Grs = Gpq ^ my_irrep;
+            /* determine how many rows of OutBuf/InBuf we can store in half the core */
+            rows_per_bucket = dpd_memfree()/(2 * OutBuf.params->coltot[Grs]);
+            if(rows_per_bucket > OutBuf.params->rowtot[Gpq])
+                rows_per_bucket = OutBuf.params->rowtot[Gpq];
+            nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) rows_per_bucket);
+            if(nbuckets == 1) rows_left = rows_per_bucket;
+            else rows_left = OutBuf.params->rowtot[Gpq] % rows_per_bucket;
 
-                /* determine how many rows of OutBuf/InBuf we can store in half the core */
-                rows_per_bucket = dpd_memfree()/(2 * OutBuf.params->coltot[Grs]);
-                if(rows_per_bucket > OutBuf.params->rowtot[Gpq])
-                    rows_per_bucket = OutBuf.params->rowtot[Gpq];
-                nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) rows_per_bucket);
-                if(nbuckets == 1) rows_left = rows_per_bucket;
-                else rows_left = OutBuf.params->rowtot[Gpq] % rows_per_bucket;
+            /* allocate space for the bucket of rows */
+            buf4_mat_irrep_init_block(&OutBuf, Gpq, rows_per_bucket);
+            buf4_mat_irrep_init_block(InBuf, Gpq, rows_per_bucket);
 
-                /* allocate space for the bucket of rows */
-                buf4_mat_irrep_init_block(&OutBuf, Gpq, rows_per_bucket);
-                buf4_mat_irrep_init_block(InBuf, Gpq, rows_per_bucket);
+            for(n=0; n < (rows_left ? nbuckets-1 : nbuckets); n++) {
 
-                for(n=0; n < (rows_left ? nbuckets-1 : nbuckets); n++) {
+                out_row_start = n * rows_per_bucket;
 
-                    out_row_start = n * rows_per_bucket;
+                for(m=0; m < (rows_left ? nbuckets-1 : nbuckets); m++) {
 
-                    for(m=0; m < (rows_left ? nbuckets-1 : nbuckets); m++) {
+                    in_row_start = m * rows_per_bucket;
+                    buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_per_bucket);
 
-                        in_row_start = m * rows_per_bucket;
-                        buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_per_bucket);
-
-                        for(pq=0; pq < rows_per_bucket; pq++) {
+                    for(pq=0; pq < rows_per_bucket; pq++) {
 
-                            /* check to see if this row is contained in the current input-bucket */
-                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                            qp = InBuf->params->rowidx[q][p] - in_row_start;
-                            if(qp >= 0 && qp < rows_per_bucket) {
-
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    sr = InBuf->params->colidx[s][r];
-                                    OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][qp][sr];
-                                }
+                        /* check to see if this row is contained in the current input-bucket */
+                        p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                        q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                        qp = InBuf->params->rowidx[q][p] - in_row_start;
+                        if(qp >= 0 && qp < rows_per_bucket) {
+
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                sr = InBuf->params->colidx[s][r];
+                                OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][qp][sr];
                             }
                         }
                     }
-                    if(rows_left) {
+                }
+                if(rows_left) {
 
-                        in_row_start = m * rows_per_bucket;
-                        buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_left);
+                    in_row_start = m * rows_per_bucket;
+                    buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_left);
 
-                        for(pq=0; pq < rows_per_bucket; pq++) {
+                    for(pq=0; pq < rows_per_bucket; pq++) {
 
-                            /* check to see if this row is contained in the current input-bucket */
-                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                            qp = InBuf->params->rowidx[q][p] - in_row_start;
-                            if(qp >= 0 && qp < rows_left) {
-
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    sr = InBuf->params->colidx[s][r];
-                                    OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][qp][sr];
-                                }
+                        /* check to see if this row is contained in the current input-bucket */
+                        p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                        q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                        qp = InBuf->params->rowidx[q][p] - in_row_start;
+                        if(qp >= 0 && qp < rows_left) {
+
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                sr = InBuf->params->colidx[s][r];
+                                OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][qp][sr];
                             }
                         }
                     }
+                }
 
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_per_bucket);
+                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_per_bucket);
 
-                } /* n */
-                if(rows_left) {
+            } /* n */
+            if(rows_left) {
 
-                    out_row_start = n * rows_per_bucket;
+                out_row_start = n * rows_per_bucket;
 
-                    for(m=0; m < (rows_left ? nbuckets-1 : nbuckets); m++) {
+                for(m=0; m < (rows_left ? nbuckets-1 : nbuckets); m++) {
 
-                        in_row_start = m * rows_per_bucket;
-                        buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_per_bucket);
+                    in_row_start = m * rows_per_bucket;
+                    buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_per_bucket);
 
-                        for(pq=0; pq < rows_left; pq++) {
+                    for(pq=0; pq < rows_left; pq++) {
 
-                            /* check to see if this row is contained in the current input-bucket */
-                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                            qp = InBuf->params->rowidx[q][p] - in_row_start;
-                            if(qp >= 0 && qp < rows_per_bucket) {
-
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    sr = InBuf->params->colidx[s][r];
-                                    OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][qp][sr];
-                                }
+                        /* check to see if this row is contained in the current input-bucket */
+                        p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                        q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                        qp = InBuf->params->rowidx[q][p] - in_row_start;
+                        if(qp >= 0 && qp < rows_per_bucket) {
+
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                sr = InBuf->params->colidx[s][r];
+                                OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][qp][sr];
                             }
                         }
                     }
-                    if(rows_left) {
+                }
+                if(rows_left) {
 
-                        in_row_start = m * rows_per_bucket;
-                        buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_left);
+                    in_row_start = m * rows_per_bucket;
+                    buf4_mat_irrep_rd_block(InBuf, Gpq, in_row_start, rows_left);
 
-                        for(pq=0; pq < rows_left; pq++) {
+                    for(pq=0; pq < rows_left; pq++) {
 
-                            /* check to see if this row is contained in the current input-bucket */
-                            p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                            q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                            qp = InBuf->params->rowidx[q][p] - in_row_start;
-                            if(qp >= 0 && qp < rows_left) {
-
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    sr = InBuf->params->colidx[s][r];
-                                    OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][qp][sr];
-                                }
+                        /* check to see if this row is contained in the current input-bucket */
+                        p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
+                        q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
+                        qp = InBuf->params->rowidx[q][p] - in_row_start;
+                        if(qp >= 0 && qp < rows_left) {
+
+                            for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
+                                r = OutBuf.params->colorb[Grs][rs][0];
+                                s = OutBuf.params->colorb[Grs][rs][1];
+                                sr = InBuf->params->colidx[s][r];
+                                OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Gpq][qp][sr];
                             }
                         }
                     }
-
                 }
 
-                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_left);
+            }
 
-                buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
-                buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
+            buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, rows_left);
 
-            } /* Gpq */
-        }
+            buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
+            buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
+
+        } /* Gpq */
 
 #ifdef DPD_TIMER
         timer_off("qpsr");
@@ -1148,46 +942,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* q->p; r->q; p->r; s->s = rpqs */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Grp = Gr^Gp; Gqs = Gq^Gs;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    rp = InBuf->params->rowidx[R][P];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        qs = InBuf->params->colidx[Q][S];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Grp][rp][qs];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qrps sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qrps sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("qrps");
@@ -1202,46 +958,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* q->p; r->q; s->r; p->s = spqr */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Gsp = Gs^Gp; Gqr = Gq^Gr;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    qr = InBuf->params->colidx[Q][R];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        sp = InBuf->params->rowidx[S][P];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gsp][sp][qr];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qrsp sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qrsp sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("qrsp");
@@ -1255,46 +973,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* q->p; s->q; p->r; r->s = rpsq */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Grp = Gr^Gp; Gsq = Gs^Gq;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    rp = InBuf->params->rowidx[R][P];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        sq = InBuf->params->colidx[S][Q];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Grp][rp][sq];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qspr sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qspr sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("qspr");
@@ -1308,46 +988,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 #endif
 
         /* q->p; s->q; r->r; p->s = sprq */
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Gsp = Gs^Gp; Grq = Gr^Gq;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    rq = InBuf->params->colidx[R][Q];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        sp = InBuf->params->rowidx[S][P];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gsp][sp][rq];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qsrp sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qsrp sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("qsrp");
@@ -1362,46 +1004,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* r->p; q->q; p->r; s->s = rqps */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Grq = Gr^Gq; Gps = Gp^Gs;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    rq = InBuf->params->rowidx[R][Q];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        ps = InBuf->params->colidx[P][S];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Grq][rq][ps];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rqps sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rqps sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("rqps");
@@ -1416,46 +1020,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* r->p; q->q; s->r; p->s = sqpr */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Gsq = Gs^Gq;  Gpr = Gp^Gr;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    pr = InBuf->params->colidx[P][R];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        sq = InBuf->params->rowidx[S][Q];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gsq][sq][pr];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rqsp sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rqsp sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("rqsp");
@@ -1470,46 +1036,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* r->p; p->q; q->r; s->s = qrps */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Gqr = Gq^Gr;  Gps = Gp^Gs;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    qr = InBuf->params->rowidx[Q][R];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        ps = InBuf->params->colidx[P][S];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gqr][qr][ps];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rpqs sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rpqs sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("rpqs");
@@ -1524,46 +1052,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* r->p; p->q; s->r; q->s = qspr */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Gqs = Gq^Gs;  Gpr = Gp^Gr;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    pr = InBuf->params->colidx[P][R];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        qs = InBuf->params->rowidx[Q][S];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gqs][qs][pr];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rpsq sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rpsq sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("rpsq");
@@ -1578,32 +1068,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* r->p; s->q; q->r; p->s = srpq */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(pq=0; pq < OutBuf.params->rowtot[h]; pq++) {
-                    p = OutBuf.params->roworb[h][pq][0];
-                    q = OutBuf.params->roworb[h][pq][1];
-
-                    col = InBuf->params->colidx[p][q];
-
-                    for(rs=0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                        r = OutBuf.params->colorb[r_irrep][rs][0];
-                        s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                        row = InBuf->params->rowidx[s][r];
-
-                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][row][col];
-
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rsqp sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rsqp sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("rsqp");
@@ -1618,89 +1084,65 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* r->p; s->q; p->r; q->s = rspq */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(pq=0; pq < OutBuf.params->rowtot[h]; pq++) {
-                    p = OutBuf.params->roworb[h][pq][0];
-                    q = OutBuf.params->roworb[h][pq][1];
-
-                    col = InBuf->params->colidx[p][q];
-
-                    for(rs=0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                        r = OutBuf.params->colorb[r_irrep][rs][0];
-                        s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                        row = InBuf->params->rowidx[r][s];
+        for(Gpq=0; Gpq < nirreps; Gpq++) {
+            Grs = Gpq ^ my_irrep;
 
-                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[r_irrep][row][col];
+            out_rows_per_bucket = (dpd_memfree() - OutBuf.params->coltot[Grs])/(2 * OutBuf.params->coltot[Grs]);
+            if(out_rows_per_bucket > OutBuf.params->rowtot[Gpq])
+                out_rows_per_bucket = OutBuf.params->rowtot[Gpq];
+            out_nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) out_rows_per_bucket);
+            if(out_nbuckets == 1) out_rows_left = out_rows_per_bucket;
+            else out_rows_left = OutBuf.params->rowtot[Gpq] % out_rows_per_bucket;
 
-                    }
-                }
-            }
-        }
-        else {
-            for(Gpq=0; Gpq < nirreps; Gpq++) {
-                Grs = Gpq ^ my_irrep;
-
-                out_rows_per_bucket = (dpd_memfree() - OutBuf.params->coltot[Grs])/(2 * OutBuf.params->coltot[Grs]);
-                if(out_rows_per_bucket > OutBuf.params->rowtot[Gpq])
-                    out_rows_per_bucket = OutBuf.params->rowtot[Gpq];
-                out_nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) out_rows_per_bucket);
-                if(out_nbuckets == 1) out_rows_left = out_rows_per_bucket;
-                else out_rows_left = OutBuf.params->rowtot[Gpq] % out_rows_per_bucket;
-
-                in_rows_per_bucket = (dpd_memfree() - InBuf->params->coltot[Gpq])/(2 * InBuf->params->coltot[Gpq]);
-                if(in_rows_per_bucket > InBuf->params->rowtot[Grs])
-                    in_rows_per_bucket = InBuf->params->rowtot[Grs];
-                in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grs]/(double) in_rows_per_bucket);
-                if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
-                else in_rows_left = InBuf->params->rowtot[Grs] % in_rows_per_bucket;
+            in_rows_per_bucket = (dpd_memfree() - InBuf->params->coltot[Gpq])/(2 * InBuf->params->coltot[Gpq]);
+            if(in_rows_per_bucket > InBuf->params->rowtot[Grs])
+                in_rows_per_bucket = InBuf->params->rowtot[Grs];
+            in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grs]/(double) in_rows_per_bucket);
+            if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
+            else in_rows_left = InBuf->params->rowtot[Grs] % in_rows_per_bucket;
 
 #ifdef DPD_DEBUG
-                outfile->Printf(stdout, "Gpq = %d\n", Gpq);
-                outfile->Printf(stdout, "OutBuf.rowtot[Gpq]  = %d\n", OutBuf.params->rowtot[Gpq]);
-                outfile->Printf(stdout, "OutBuf.coltot[Grs]  = %d\n", OutBuf.params->coltot[Grs]);
-                outfile->Printf(stdout, "out_nbuckets        = %d\n", out_nbuckets);
-                outfile->Printf(stdout, "out_rows_per_bucket = %d\n", out_rows_per_bucket);
-                outfile->Printf(stdout, "out_rows_left       = %d\n", out_rows_left);
-                outfile->Printf(stdout, "InBuf.rowtot[Grs]   = %d\n", InBuf->params->rowtot[Grs]);
-                outfile->Printf(stdout, "InBuf.coltot[Gpq]   = %d\n", InBuf->params->coltot[Gpq]);
-                outfile->Printf(stdout, "in_nbuckets         = %d\n", in_nbuckets);
-                outfile->Printf(stdout, "in_rows_per_bucket  = %d\n", in_rows_per_bucket);
-                outfile->Printf(stdout, "in_rows_left        = %d\n", in_rows_left);
-                fflush(stdout);
+            outfile->Printf(stdout, "Gpq = %d\n", Gpq);
+            outfile->Printf(stdout, "OutBuf.rowtot[Gpq]  = %d\n", OutBuf.params->rowtot[Gpq]);
+            outfile->Printf(stdout, "OutBuf.coltot[Grs]  = %d\n", OutBuf.params->coltot[Grs]);
+            outfile->Printf(stdout, "out_nbuckets        = %d\n", out_nbuckets);
+            outfile->Printf(stdout, "out_rows_per_bucket = %d\n", out_rows_per_bucket);
+            outfile->Printf(stdout, "out_rows_left       = %d\n", out_rows_left);
+            outfile->Printf(stdout, "InBuf.rowtot[Grs]   = %d\n", InBuf->params->rowtot[Grs]);
+            outfile->Printf(stdout, "InBuf.coltot[Gpq]   = %d\n", InBuf->params->coltot[Gpq]);
+            outfile->Printf(stdout, "in_nbuckets         = %d\n", in_nbuckets);
+            outfile->Printf(stdout, "in_rows_per_bucket  = %d\n", in_rows_per_bucket);
+            outfile->Printf(stdout, "in_rows_left        = %d\n", in_rows_left);
+            fflush(stdout);
 #endif
 
-                buf4_mat_irrep_init_block(&OutBuf, Gpq, out_rows_per_bucket);
-                buf4_mat_irrep_init_block(InBuf, Grs, in_rows_per_bucket);
+            buf4_mat_irrep_init_block(&OutBuf, Gpq, out_rows_per_bucket);
+            buf4_mat_irrep_init_block(InBuf, Grs, in_rows_per_bucket);
 
-                for(n=0; n < out_nbuckets; n++) {
-                    out_row_start = n*out_rows_per_bucket;
+            for(n=0; n < out_nbuckets; n++) {
+                out_row_start = n*out_rows_per_bucket;
 
-                    for(m=0; m < in_nbuckets; m++) {
-                        in_row_start = m * in_rows_per_bucket;
-                        buf4_mat_irrep_rd_block(InBuf, Grs, in_row_start, (m == in_nbuckets-1 ? in_rows_left : in_rows_per_bucket));
+                for(m=0; m < in_nbuckets; m++) {
+                    in_row_start = m * in_rows_per_bucket;
+                    buf4_mat_irrep_rd_block(InBuf, Grs, in_row_start, (m == in_nbuckets-1 ? in_rows_left : in_rows_per_bucket));
 
-                        for(pq=0; pq < (n == out_nbuckets-1 ? out_rows_left : out_rows_per_bucket); pq++) {
-                            PQ = pq + n*out_rows_per_bucket;
-                            for(RS=0; RS < (m == in_nbuckets-1 ? in_rows_left : in_rows_per_bucket); RS++) {
-                                rs = RS + m*in_rows_per_bucket;
-                                OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grs][RS][PQ];
-                            }
+                    for(pq=0; pq < (n == out_nbuckets-1 ? out_rows_left : out_rows_per_bucket); pq++) {
+                        PQ = pq + n*out_rows_per_bucket;
+                        for(RS=0; RS < (m == in_nbuckets-1 ? in_rows_left : in_rows_per_bucket); RS++) {
+                            rs = RS + m*in_rows_per_bucket;
+                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grs][RS][PQ];
                         }
                     }
+                }
 
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, (n == out_nbuckets-1 ? out_rows_left : out_rows_per_bucket));
+                buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, (n == out_nbuckets-1 ? out_rows_left : out_rows_per_bucket));
 
-                }
+            }
 
-                buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
-                buf4_mat_irrep_close_block(InBuf, Grs, in_rows_per_bucket);
+            buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
+            buf4_mat_irrep_close_block(InBuf, Grs, in_rows_per_bucket);
 
-            } /* Gpq */
-        }
+        } /* Gpq */
 
 #ifdef DPD_TIMER
         timer_off("rspq");
@@ -1715,46 +1157,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* s->p; q->q; r->r; p->s = sqrp */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Gsq = Gs^Gq;  Grp = Gr^Gp;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    rp = InBuf->params->colidx[R][P];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        sq = InBuf->params->rowidx[S][Q];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gsq][sq][rp];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for sqrp sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for sqrp sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("sqrp");
@@ -1762,8 +1166,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
         break;
 
     case sqpr:
-        outfile->Printf("\nDPD sort error: sqpr index ordering not yet coded.\n");
-        dpd_error("buf_sort", "outfile");
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for sqpr sort.\n");
+        dpd_error("buf4_sort", "outfile");
         break;
 
     case srqp:
@@ -1774,32 +1178,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* s->p; r->q; q->r; p->s = srqp */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(pq=0; pq < OutBuf.params->rowtot[h]; pq++) {
-                    p = OutBuf.params->roworb[h][pq][0];
-                    q = OutBuf.params->roworb[h][pq][1];
-
-                    col = InBuf->params->colidx[q][p];
-
-                    for(rs=0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                        r = OutBuf.params->colorb[r_irrep][rs][0];
-                        s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                        row = InBuf->params->rowidx[s][r];
-
-                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[r_irrep][row][col];
-
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for srqp sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for srqp sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("srqp");
@@ -1813,32 +1193,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* s->p; r->q; p->r; q->s = rsqp */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(pq=0; pq < OutBuf.params->rowtot[h]; pq++) {
-                    p = OutBuf.params->roworb[h][pq][0];
-                    q = OutBuf.params->roworb[h][pq][1];
-
-                    col = InBuf->params->colidx[q][p];
-
-                    for(rs=0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                        r = OutBuf.params->colorb[r_irrep][rs][0];
-                        s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                        row = InBuf->params->rowidx[r][s];
-
-                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][row][col];
-
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for srpq sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for srpq sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("srpq");
@@ -1853,46 +1209,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* s->p; p->q; q->r; r->s = qrsp */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Gqr = Gq^Gr;  Gsp = Gs^Gp;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    qr = InBuf->params->rowidx[Q][R];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        sp = InBuf->params->colidx[S][P];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gqr][qr][sp];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for spqr sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for spqr sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("spqr");
@@ -1907,46 +1225,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
 
         /* s->p; p->q; r->r; q->s = qsrp */
 
-        if(incore) {
-            for(h=0; h < nirreps; h++) {
-                r_irrep = h^my_irrep;
-
-                for(Gp=0; Gp < nirreps; Gp++) {
-                    Gq = Gp^h;
-                    for(Gr=0; Gr < nirreps; Gr++) {
-                        Gs = Gr^r_irrep;
-
-                        Gqs = Gq^Gs;  Grp = Gr^Gp;
-
-                        for(p=0; p < OutBuf.params->ppi[Gp]; p++) {
-                            P = OutBuf.params->poff[Gp] + p;
-                            for(q=0; q < OutBuf.params->qpi[Gq]; q++) {
-                                Q = OutBuf.params->qoff[Gq] + q;
-                                pq = OutBuf.params->rowidx[P][Q];
-
-                                for(r=0; r < OutBuf.params->rpi[Gr]; r++) {
-                                    R = OutBuf.params->roff[Gr] + r;
-                                    rp = InBuf->params->colidx[R][P];
-
-                                    for(s=0; s < OutBuf.params->spi[Gs]; s++) {
-                                        S = OutBuf.params->soff[Gs] + s;
-                                        rs = OutBuf.params->colidx[R][S];
-                                        qs = InBuf->params->rowidx[Q][S];
-
-                                        OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gqs][qs][rp];
-
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for sprq sort.\n");
-            dpd_error("buf4_sort", "outfile");
-        }
+        outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for sprq sort.\n");
+        dpd_error("buf4_sort", "outfile");
 
 #ifdef DPD_TIMER
         timer_off("sprq");
@@ -1954,14 +1234,6 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
         break;
     }
 
-    if(incore) {
-        for(h=0; h < nirreps; h++) {
-            buf4_mat_irrep_wrt(&OutBuf, h);
-            buf4_mat_irrep_close(&OutBuf, h);
-            buf4_mat_irrep_close(InBuf, h);
-        }
-    }
-
     buf4_close(&OutBuf);
 
 #ifdef DPD_TIMER
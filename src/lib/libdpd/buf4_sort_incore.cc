@@ -0,0 +1,151 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief In-core, threaded permutation kernel used by buf4_sort()
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <libqt/qt.h>
+#include "dpd.h"
+#include "psi4-dec.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Edge length of the square (pq,rs) tiles handed out to the threads */
+#define DPD_SORT_TILE 64
+
+namespace psi {
+
+/*
+** dpd_buf4_sort_incore(): Carries out the in-core permutation
+** Out[pq][rs] = In[..][..] for every sort pattern known to buf4_sort().
+** All symmetry blocks of both buffers must already be allocated, and
+** those of InBuf must already be read.
+**
+** Rather than one hand-written loop per pattern, each of the 24 index
+** orderings is reduced to a source map: src[k] is the position in the
+** target quartet (P,Q,R,S) that supplies the k-th index of the input
+** quartet.  The target blocks are cut into DPD_SORT_TILE x DPD_SORT_TILE
+** tiles across all irreps, and the tiles are distributed dynamically
+** over the OpenMP threads.  Each tile touches a bounded window of the
+** target row and, for the bra-ket transposing patterns, of the source
+** columns, so the strided side of the transpose stays in cache.
+**
+** Arguments:
+**   dpdbuf4 *InBuf: The input buffer, fully in core.
+**   dpdbuf4 *OutBuf: The target buffer, fully allocated.
+**   enum indices index: The desired ordering (see buf4_sort()).
+**
+** The index notation follows buf4_sort(): the desired ordering, e.g.
+** rqsp, is read as the target Out[rq][sp] = In[pq][rs], which in the
+** Out[pq][rs] notation used here is In[sq][pr], i.e. src = {3,1,0,2}.
+*/
+
+int DPD::buf4_sort_incore(dpdbuf4 *InBuf, dpdbuf4 *OutBuf, enum indices index)
+{
+    static const char *orders[] = {
+        "pqrs", "pqsr", "prqs", "prsq", "psqr", "psrq",
+        "qprs", "qpsr", "qrps", "qrsp", "qspr", "qsrp",
+        "rqps", "rqsp", "rpqs", "rpsq", "rsqp", "rspq",
+        "sqrp", "sqpr", "srqp", "srpq", "spqr", "sprq"};
+    int nirreps, my_irrep, h, k, src[4];
+    const char *order;
+    bool row_from_bra, col_from_bra;
+
+    if(index == pqrs) {
+        outfile->Printf( "\nDPD sort error: invalid index ordering.\n");
+        dpd_error("buf_sort", "outfile");
+    }
+
+    /* src[k]: which target index (P,Q,R,S) = (0,1,2,3) lands in slot k of the source */
+    order = orders[index];
+    for(k=0; k < 4; k++) src[k] = (int)(strchr(order, "pqrs"[k]) - order);
+
+    /* When both source row (column) indices come from the target row,
+       the source row (column) is fixed for a whole target row */
+    row_from_bra = (src[0] < 2) && (src[1] < 2);
+    col_from_bra = (src[2] < 2) && (src[3] < 2);
+
+    nirreps = OutBuf->params->nirreps;
+    my_irrep = OutBuf->file.my_irrep;
+
+    std::vector<int> tile_h, tile_pq, tile_rs;
+    for(h=0; h < nirreps; h++) {
+        int rowtot = OutBuf->params->rowtot[h];
+        int coltot = OutBuf->params->coltot[h^my_irrep];
+        for(int pq=0; pq < rowtot; pq += DPD_SORT_TILE)
+            for(int rs=0; rs < coltot; rs += DPD_SORT_TILE) {
+                tile_h.push_back(h);
+                tile_pq.push_back(pq);
+                tile_rs.push_back(rs);
+            }
+    }
+    int ntiles = tile_h.size();
+
+#pragma omp parallel for schedule(dynamic)
+    for(int t=0; t < ntiles; t++) {
+        int h = tile_h[t];
+        int r_irrep = h^my_irrep;
+        int pq_max = std::min(tile_pq[t] + DPD_SORT_TILE, OutBuf->params->rowtot[h]);
+        int rs_max = std::min(tile_rs[t] + DPD_SORT_TILE, OutBuf->params->coltot[r_irrep]);
+        dpdparams4 *In = InBuf->params;
+        int idx[4], row = 0, col = 0, Grow = 0;
+
+        for(int pq=tile_pq[t]; pq < pq_max; pq++) {
+            idx[0] = OutBuf->params->roworb[h][pq][0];
+            idx[1] = OutBuf->params->roworb[h][pq][1];
+            double *target = OutBuf->matrix[h][pq];
+
+            if(row_from_bra) {
+                row = In->rowidx[idx[src[0]]][idx[src[1]]];
+                Grow = In->psym[idx[src[0]]]^In->qsym[idx[src[1]]];
+            }
+            if(col_from_bra)
+                col = In->colidx[idx[src[2]]][idx[src[3]]];
+
+            for(int rs=tile_rs[t]; rs < rs_max; rs++) {
+                idx[2] = OutBuf->params->colorb[r_irrep][rs][0];
+                idx[3] = OutBuf->params->colorb[r_irrep][rs][1];
+
+                if(!row_from_bra) {
+                    row = In->rowidx[idx[src[0]]][idx[src[1]]];
+                    Grow = In->psym[idx[src[0]]]^In->qsym[idx[src[1]]];
+                }
+                if(!col_from_bra)
+                    col = In->colidx[idx[src[2]]][idx[src[3]]];
+
+                target[rs] = InBuf->matrix[Grow][row][col];
+            }
+        }
+    }
+
+    return 0;
+}
+
+}
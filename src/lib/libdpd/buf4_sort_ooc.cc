@@ -30,6 +30,11 @@
 #include <libqt/qt.h>
 #include "dpd.h"
 #include "psi4-dec.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 
 /*
@@ -142,44 +147,60 @@ int DPD::buf4_sort_ooc(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
             else {  /* out-of-core sort option */
 
+                /* The input is double-buffered: while the threads permute
+                   bucket n, one of them reads bucket n+1 into the spare
+                   block.  Budget a third of the memory for each of the two
+                   input buckets and the output bucket. */
+                rows_per_bucket = dpd_memfree()/3/InBuf->params->coltot[r_irrep];
+                if(!rows_per_bucket) dpd_error("buf4_sort_pqsr: Not enough memory for one row!", "outfile");
+                nbuckets = (int) ceil(((double) InBuf->params->rowtot[h])/((double) rows_per_bucket));
+                rows_left = InBuf->params->rowtot[h] % rows_per_bucket;
+
+                double **in_block[2];
+                buf4_mat_irrep_init_block(InBuf, h, rows_per_bucket);
+                in_block[0] = InBuf->matrix[h];
                 buf4_mat_irrep_init_block(InBuf, h, rows_per_bucket);
+                in_block[1] = InBuf->matrix[h];
                 buf4_mat_irrep_init_block(&OutBuf, h, rows_per_bucket);
 
-                for(n=0; n < (rows_left ? nbuckets-1 : nbuckets); n++) {
-
-                    buf4_mat_irrep_rd_block(InBuf, h, n*rows_per_bucket, rows_per_bucket);
-
-                    for(pq=0; pq < rows_per_bucket; pq++) {
-                        for(rs=0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            sr = InBuf->params->colidx[s][r];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][pq][sr];
+                InBuf->matrix[h] = in_block[0];
+                buf4_mat_irrep_rd_block(InBuf, h, 0,
+                                        (rows_left && nbuckets == 1) ? rows_left : rows_per_bucket);
+
+                for(n=0; n < nbuckets; n++) {
+                    int nrows = (rows_left && n == nbuckets-1) ? rows_left : rows_per_bucket;
+                    double **current = in_block[n%2];
+
+#pragma omp parallel
+                    {
+#pragma omp single nowait
+                        {
+                            if(n+1 < nbuckets) {
+                                InBuf->matrix[h] = in_block[(n+1)%2];
+                                buf4_mat_irrep_rd_block(InBuf, h, (n+1)*rows_per_bucket,
+                                                        (rows_left && n+1 == nbuckets-1) ? rows_left : rows_per_bucket);
+                            }
                         }
-                    }
 
-                    buf4_mat_irrep_wrt_block(&OutBuf, h, n*rows_per_bucket, rows_per_bucket);
-                }
-                if(rows_left) {
+#pragma omp for private(rs, r, s, sr) schedule(dynamic, 16)
+                        for(pq=0; pq < nrows; pq++) {
+                            for(rs=0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
+                                r = OutBuf.params->colorb[r_irrep][rs][0];
+                                s = OutBuf.params->colorb[r_irrep][rs][1];
 
-                    buf4_mat_irrep_rd_block(InBuf, h, n*rows_per_bucket, rows_left);
+                                sr = InBuf->params->colidx[s][r];
 
-                    for(pq=0; pq < rows_left; pq++) {
-                        for(rs=0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            sr = InBuf->params->colidx[s][r];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][pq][sr];
+                                OutBuf.matrix[h][pq][rs] = current[pq][sr];
+                            }
                         }
                     }
 
-                    buf4_mat_irrep_wrt_block(&OutBuf, h, n*rows_per_bucket, rows_left);
+                    buf4_mat_irrep_wrt_block(&OutBuf, h, n*rows_per_bucket, nrows);
                 }
 
+                InBuf->matrix[h] = in_block[0];
+                buf4_mat_irrep_close_block(InBuf, h, rows_per_bucket);
+                InBuf->matrix[h] = in_block[1];
                 buf4_mat_irrep_close_block(InBuf, h, rows_per_bucket);
                 buf4_mat_irrep_close_block(&OutBuf, h, rows_per_bucket);
 
@@ -356,6 +356,7 @@ public:
                   int pqnum, int rsnum, const char *label);
     int buf4_sort_ooc(dpdbuf4 *InBuf, int outfilenum, enum indices index,
                       int pqnum, int rsnum, const char *label);
+    int buf4_sort_incore(dpdbuf4 *InBuf, dpdbuf4 *OutBuf, enum indices index);
     int buf4_sort_axpy(dpdbuf4 *InBuf, int outfilenum, enum indices index,
                        int pqnum, int rsnum, const char *label, double alpha);
     int buf4_axpy(dpdbuf4 *BufX, dpdbuf4 *BufY, double alpha);
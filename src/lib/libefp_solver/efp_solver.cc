@@ -450,20 +450,22 @@ boost::shared_ptr<Matrix> EFP::modify_Fock_permanent()
         throw PsiException("EFP::modify_Fock_permanent():efp_get_multipole_values(): " +
             std::string (efp_result_to_string(res)),__FILE__,__LINE__);
 
-    // Scale multipole integrals by multipole magnitudes.  The result goes into V
+    // The multipoles form one field of sites; the potential integrals over all
+    // of them are computed at once.  The result goes into V
     boost::shared_ptr<Wavefunction> wfn = Process::environment.wavefunction();
-    boost::shared_ptr<OneBodyAOInt> efp_ints(wfn->integral()->ao_efp_multipole_potential());
+    boost::shared_ptr<PotentialInt> pot(static_cast<PotentialInt*>(wfn->integral()->ao_potential()));
 
                                // 0    X    Y    Z      XX       YY       ZZ       XY       XZ       YZ
     const double prefacs[20] = { 1.0, 1.0, 1.0, 1.0, 1.0/3.0, 1.0/3.0, 1.0/3.0, 2.0/3.0, 2.0/3.0, 2.0/3.0,
     //   XXX       YYY       ZZZ       XXY       XXZ       XYY       YYZ       XZZ       YZZ       XYZ
       1.0/15.0, 1.0/15.0, 1.0/15.0, 3.0/15.0, 3.0/15.0, 3.0/15.0, 3.0/15.0, 3.0/15.0, 3.0/15.0, 6.0/15.0};
 
+    // Position of each libefp component in the Cartesian ordering of the field
+    // (1; x y z; xx xy xz yy yz zz; xxx xxy xxz xyy xyz xzz yyy yyz yzz zzz)
+    const int field_index[20] = { 0, 1, 2, 3, 4, 7, 9, 5, 6, 8,
+                                  10, 16, 19, 11, 12, 13, 17, 15, 18, 14};
+
     int nao = wfn->basisset()->nao();
-    std::vector<SharedMatrix> mats;
-    for(int i=0; i<20; ++i) {
-        mats.push_back(SharedMatrix(new Matrix(nao, nao)));
-    }
 
     // Cartesian basis one-electron EFP perturbation
     SharedMatrix V2(new Matrix("EFP permanent moment contribution to the Fock Matrix", nao, nao));
@@ -482,14 +484,10 @@ boost::shared_ptr<Matrix> EFP::modify_Fock_permanent()
     }
     efp_atom * atoms = (efp_atom*)malloc(max_natom*sizeof(efp_atom));
 
-    for (size_t n=0; n<n_multipole; n++) {
-        for (int i=0; i<20; ++i) {
-           mats[i]->zero();
-        }
-        Vector3 coords(xyz_p[n*3],xyz_p[n*3+1],xyz_p[n*3+2]);
-        efp_ints->set_origin(coords);
-        efp_ints->compute(mats);
+    boost::shared_ptr<MultipoleField> field(new MultipoleField(3));
+    double m[20];
 
+    for (size_t n=0; n<n_multipole; n++) {
         // add point charges from atoms to multipoles at atom center
         for (int frag=0; frag<nfrag_; frag++) {
             size_t natom = 0;
@@ -513,13 +511,16 @@ boost::shared_ptr<Matrix> EFP::modify_Fock_permanent()
             }
         }
 
-        for (int i=0; i<20; ++i) {
-            mats[i]->scale( -prefacs[i] * mult_p[20*n+i] );
-            V2->add(mats[i]);
-        }
+        for (int i=0; i<20; ++i)
+            m[field_index[i]] = -prefacs[i] * mult_p[20*n+i];
+        field->add_site(xyz_p[n*3], xyz_p[n*3+1], xyz_p[n*3+2], m);
     }
     free(atoms);
 
+    pot->set_force_cartesian(true);
+    pot->set_multipole_field(field);
+    pot->compute(V2);
+
     boost::shared_ptr<PetiteList> pet(new PetiteList(wfn->basisset(),wfn->integral(),true));
     boost::shared_ptr<Matrix> U = pet->aotoso();
 
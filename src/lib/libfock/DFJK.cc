@@ -25,6 +25,7 @@
 #include <libpsio/psio.h>
 #include <libpsio/aiohandler.h>
 #include <libqt/qt.h>
+#include <libpsi4util/libpsi4util.h>
 #include <psi4-dec.h>
 #include <psifiles.h>
 #include <libmints/sieve.h>
@@ -69,6 +70,8 @@ void DFJK::common_init()
     unit_ = PSIF_DFSCF_BJ;
     is_core_ = true;
     psio_ = PSIO::shared_object();
+    disk_read_time_ = 0.0;
+    disk_compute_time_ = 0.0;
 }
 SharedVector DFJK::iaia(SharedMatrix Ci, SharedMatrix Ca)
 {
@@ -311,8 +314,8 @@ int DFJK::max_rows() const
     unsigned long int row_cost = 0L;
     // Copies of E tensor
     row_cost += (lr_symmetric_ ? 1L : 2L) * max_nocc() * primary_->nbf();
-    // Slices of Qmn tensor, including AIO buffer (NOTE: AIO not implemented yet)
-    row_cost += (is_core_ ? 1L : 1L) * sieve_->function_pairs().size();
+    // Slices of Qmn tensor, two for disk (one contracted while the next is read)
+    row_cost += (is_core_ ? 1L : 2L) * sieve_->function_pairs().size();
 
     unsigned long int max_rows = mem / row_cost;
 
@@ -323,6 +326,26 @@ int DFJK::max_rows() const
 
     return (int) max_rows;
 }
+int DFJK::disk_rows(int max_rows) const
+{
+    int naux = auxiliary_->nbf();
+
+    // Before any timings, eight blocks keep the first (unhidden) read small
+    double rows = std::ceil(naux / 8.0);
+
+    // Streaming hides every read but the first behind the contraction of
+    // the previous block.  Keep that first read to 5% of the time the whole
+    // stream takes, max(read, contract) per row, without going below 1/64
+    // of the tensor per request.
+    if (disk_read_time_ > 0.0 && disk_compute_time_ > 0.0) {
+        rows = 0.05 * naux * std::max(disk_read_time_, disk_compute_time_) / disk_read_time_;
+        rows = std::max(rows, std::ceil(naux / 64.0));
+    }
+
+    if (rows > max_rows) rows = max_rows;
+    if (rows < 1.0) rows = 1.0;
+    return (int) rows;
+}
 int DFJK::max_nocc() const
 {
     int max_nocc = 0;
@@ -1651,30 +1674,71 @@ void DFJK::manage_JK_core()
 }
 void DFJK::manage_JK_disk()
 {
+    int naux_total = auxiliary_->nbf();
     int ntri = sieve_->function_pairs().size();
-    Qmn_ = SharedMatrix(new Matrix("(Q|mn) Block", max_rows_, ntri));
+    int rows = disk_rows(max_rows_);
+
+    // Block n+1 is read into one buffer while block n is contracted from the other
+    SharedMatrix Qmn[2];
+    Qmn[0] = SharedMatrix(new Matrix("(Q|mn) Block", rows, ntri));
+    Qmn[1] = SharedMatrix(new Matrix("(Q|mn) Block", rows, ntri));
+    psio_address end[2];
+
     psio_->open(unit_,PSIO_OPEN_OLD);
-    for (int Q = 0 ; Q < auxiliary_->nbf(); Q += max_rows_) {
-        int naux = (auxiliary_->nbf() - Q <= max_rows_ ? auxiliary_->nbf() - Q : max_rows_);
-        psio_address addr = psio_get_address(PSIO_ZERO, (Q*(ULI) ntri) * sizeof(double));
+    AIOHandler aio(psio_, 1);
+
+    int naux = (naux_total <= rows ? naux_total : rows);
+    SharedAIORequest next = aio.read(unit_,"(Q|mn) Integrals", (char*)(Qmn[0]->pointer()[0]),
+        sizeof(double)*naux*ntri, PSIO_ZERO, &end[0]);
+
+    double read_time = 0.0;
+    double wait_time = 0.0;
+    double compute_time = 0.0;
+    int read_rows = naux;
+
+    for (int Q = 0, block = 0; Q < naux_total; Q += rows, block++) {
+        naux = (naux_total - Q <= rows ? naux_total - Q : rows);
+        double** Qmnp = Qmn[block % 2]->pointer();
 
         timer_on("JK: (Q|mn) Read");
-        psio_->read(unit_,"(Q|mn) Integrals", (char*)(Qmn_->pointer()[0]),sizeof(double)*naux*ntri,addr,&addr);
+        Timer wait_timer;
+        next->wait();
+        double wait = wait_timer.get();
         timer_off("JK: (Q|mn) Read");
+        if (block == 0) read_time = wait;
+        else wait_time += wait;
+
+        if (Q + rows < naux_total) {
+            int naux2 = (naux_total - Q - rows <= rows ? naux_total - Q - rows : rows);
+            psio_address addr = psio_get_address(PSIO_ZERO, ((Q + rows)*(ULI) ntri) * sizeof(double));
+            next = aio.read(unit_,"(Q|mn) Integrals", (char*)(Qmn[(block + 1) % 2]->pointer()[0]),
+                sizeof(double)*naux2*ntri, addr, &end[(block + 1) % 2]);
+        }
 
+        Timer compute_timer;
         if (do_J_) {
             timer_on("JK: J");
-            block_J(&Qmn_->pointer()[0],naux);
+            block_J(Qmnp,naux);
             timer_off("JK: J");
         }
         if (do_K_) {
             timer_on("JK: K");
-            block_K(&Qmn_->pointer()[0],naux);
+            block_K(Qmnp,naux);
             timer_off("JK: K");
         }
+        compute_time += compute_timer.get();
     }
+    aio.synchronize();
     psio_->close(unit_,1);
-    Qmn_.reset();
+
+    // The first read was not overlapped, so it times the disk
+    disk_read_time_ = read_time / read_rows;
+    disk_compute_time_ = compute_time / naux_total;
+
+    if (bench_) {
+        outfile->Printf("  DFJK disk: %d rows per block, first read %8.3f s, stalls %8.3f s, contraction %8.3f s\n",
+            rows, read_time, wait_time, compute_time);
+    }
 }
 void DFJK::manage_wK_core()
 {
@@ -1692,31 +1756,54 @@ void DFJK::manage_wK_disk()
 {
     int max_rows_w = max_rows_ / 2;
     max_rows_w = (max_rows_w < 1 ? 1 : max_rows_w);
+    int naux_total = auxiliary_->nbf();
     int ntri = sieve_->function_pairs().size();
-    Qlmn_ = SharedMatrix(new Matrix("(Q|mn) Block", max_rows_w, ntri));
-    Qrmn_ = SharedMatrix(new Matrix("(Q|mn) Block", max_rows_w, ntri));
+    int rows = disk_rows(max_rows_w);
+
+    // Left and right blocks n+1 are read while block n is contracted
+    SharedMatrix Qlmn[2];
+    SharedMatrix Qrmn[2];
+    for (int b = 0; b < 2; b++) {
+        Qlmn[b] = SharedMatrix(new Matrix("(Q|mn) Block", rows, ntri));
+        Qrmn[b] = SharedMatrix(new Matrix("(Q|mn) Block", rows, ntri));
+    }
+    psio_address end[2];
+
     psio_->open(unit_,PSIO_OPEN_OLD);
-    for (int Q = 0 ; Q < auxiliary_->nbf(); Q += max_rows_w) {
-        int naux = (auxiliary_->nbf() - Q <= max_rows_w ? auxiliary_->nbf() - Q : max_rows_w);
-        psio_address addr = psio_get_address(PSIO_ZERO, (Q*(ULI) ntri) * sizeof(double));
+    AIOHandler aio(psio_, 1);
+
+    int naux = (naux_total <= rows ? naux_total : rows);
+    SharedAIORequest next_left = aio.read(unit_,"Left (Q|w|mn) Integrals", (char*)(Qlmn[0]->pointer()[0]),
+        sizeof(double)*naux*ntri, PSIO_ZERO, &end[0]);
+    SharedAIORequest next_right = aio.read(unit_,"Right (Q|w|mn) Integrals", (char*)(Qrmn[0]->pointer()[0]),
+        sizeof(double)*naux*ntri, PSIO_ZERO, &end[1]);
+
+    for (int Q = 0, block = 0; Q < naux_total; Q += rows, block++) {
+        naux = (naux_total - Q <= rows ? naux_total - Q : rows);
 
         timer_on("JK: (Q|mn)^L Read");
-        psio_->read(unit_,"Left (Q|w|mn) Integrals", (char*)(Qlmn_->pointer()[0]),sizeof(double)*naux*ntri,addr,&addr);
+        next_left->wait();
         timer_off("JK: (Q|mn)^L Read");
 
-        addr = psio_get_address(PSIO_ZERO, (Q*(ULI) ntri) * sizeof(double));
-
         timer_on("JK: (Q|mn)^R Read");
-        psio_->read(unit_,"Right (Q|w|mn) Integrals", (char*)(Qrmn_->pointer()[0]),sizeof(double)*naux*ntri,addr,&addr);
+        next_right->wait();
         timer_off("JK: (Q|mn)^R Read");
 
+        if (Q + rows < naux_total) {
+            int naux2 = (naux_total - Q - rows <= rows ? naux_total - Q - rows : rows);
+            psio_address addr = psio_get_address(PSIO_ZERO, ((Q + rows)*(ULI) ntri) * sizeof(double));
+            next_left = aio.read(unit_,"Left (Q|w|mn) Integrals", (char*)(Qlmn[(block + 1) % 2]->pointer()[0]),
+                sizeof(double)*naux2*ntri, addr, &end[0]);
+            next_right = aio.read(unit_,"Right (Q|w|mn) Integrals", (char*)(Qrmn[(block + 1) % 2]->pointer()[0]),
+                sizeof(double)*naux2*ntri, addr, &end[1]);
+        }
+
         timer_on("JK: wK");
-        block_wK(&Qlmn_->pointer()[0],&Qrmn_->pointer()[0],naux);
+        block_wK(Qlmn[block % 2]->pointer(),Qrmn[block % 2]->pointer(),naux);
         timer_off("JK: wK");
     }
+    aio.synchronize();
     psio_->close(unit_,1);
-    Qlmn_.reset();
-    Qrmn_.reset();
 }
 void DFJK::block_J(double** Qmnp, int naux)
 {
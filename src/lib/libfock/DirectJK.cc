@@ -30,6 +30,7 @@
 #include <psifiles.h>
 #include <libmints/sieve.h>
 #include <libiwl/iwl.hpp>
+#include <libpsi4util/libpsi4util.h>
 #include "jk.h"
 #include "jk_independent.h"
 #include "link.h"
@@ -40,6 +41,8 @@
 #include<lib3index/cholesky.h>
 
 #include <sstream>
+#include <algorithm>
+#include <map>
 #include "libparallel/ParallelPrinter.h"
 #ifdef _OPENMP
 #include <omp.h>
@@ -63,6 +66,11 @@ void DirectJK::common_init()
     #ifdef _OPENMP
         df_ints_num_threads_ = omp_get_max_threads();
     #endif
+    accumulation_ = "AUTO";
+    scheduler_ = "SORTED";
+    incfock_full_fock_every_ = 10;
+    incfock_count_ = 0;
+    computed_shells_ = 0L;
 }
 void DirectJK::print_header() const
 {
@@ -75,6 +83,8 @@ void DirectJK::print_header() const
         if (do_wK_)
             outfile->Printf( "    Omega:             %11.3E\n", omega_);
         outfile->Printf( "    Integrals threads: %11d\n", df_ints_num_threads_);
+        outfile->Printf( "    J/K Accumulation:  %11s\n", accumulation_.c_str());
+        outfile->Printf( "    Quartet Scheduler: %11s\n", scheduler_.c_str());
         //outfile->Printf( "    Memory (MB):       %11ld\n", (memory_ *8L) / (1024L * 1024L));
         outfile->Printf( "    Schwarz Cutoff:    %11.0E\n\n", cutoff_);
     }
@@ -82,11 +92,78 @@ void DirectJK::print_header() const
 void DirectJK::preiterations()
 {
     sieve_ = boost::shared_ptr<ERISieve>(new ERISieve(primary_, cutoff_));
+    sort_shell_pairs();
+    incfock_reset();
+}
+bool DirectJK::incfock_setup()
+{
+    if (!incfock_) return false;
+
+    // The saved state is only usable if it matches the current tasking
+    bool valid = D_prev_.size() && D_prev_.size() == D_ao_.size();
+    valid = valid && J_prev_.size() == (do_J_ ? D_ao_.size() : 0L);
+    valid = valid && K_prev_.size() == (do_K_ ? D_ao_.size() : 0L);
+    valid = valid && wK_prev_.size() == (do_wK_ ? D_ao_.size() : 0L);
+
+    // Periodic full rebuild keeps the screening error from accumulating
+    bool incremental = valid && (incfock_count_ + 1 < incfock_full_fock_every_);
+    if (!incremental) return false;
+
+    if (delta_D_.size() != D_ao_.size()) {
+        delta_D_.clear();
+        for (size_t N = 0; N < D_ao_.size(); N++) {
+            delta_D_.push_back(SharedMatrix(new Matrix("Delta D (AO)", primary_->nbf(), primary_->nbf())));
+        }
+    }
+    for (size_t N = 0; N < D_ao_.size(); N++) {
+        delta_D_[N]->copy(D_ao_[N]);
+        delta_D_[N]->subtract(D_prev_[N]);
+    }
+
+    return true;
+}
+void DirectJK::incfock_postiter(bool incremental)
+{
+    if (!incfock_) return;
+
+    if (incremental) {
+        for (size_t N = 0; N < J_prev_.size(); N++) J_ao_[N]->add(J_prev_[N]);
+        for (size_t N = 0; N < K_prev_.size(); N++) K_ao_[N]->add(K_prev_[N]);
+        for (size_t N = 0; N < wK_prev_.size(); N++) wK_ao_[N]->add(wK_prev_[N]);
+        incfock_count_++;
+    } else {
+        incfock_reset();
+        for (size_t N = 0; N < D_ao_.size(); N++) {
+            D_prev_.push_back(SharedMatrix(new Matrix("D Prev (AO)", primary_->nbf(), primary_->nbf())));
+            if (do_J_) J_prev_.push_back(SharedMatrix(new Matrix("J Prev (AO)", primary_->nbf(), primary_->nbf())));
+            if (do_K_) K_prev_.push_back(SharedMatrix(new Matrix("K Prev (AO)", primary_->nbf(), primary_->nbf())));
+            if (do_wK_) wK_prev_.push_back(SharedMatrix(new Matrix("wK Prev (AO)", primary_->nbf(), primary_->nbf())));
+        }
+    }
+
+    for (size_t N = 0; N < D_prev_.size(); N++) D_prev_[N]->copy(D_ao_[N]);
+    for (size_t N = 0; N < J_prev_.size(); N++) J_prev_[N]->copy(J_ao_[N]);
+    for (size_t N = 0; N < K_prev_.size(); N++) K_prev_[N]->copy(K_ao_[N]);
+    for (size_t N = 0; N < wK_prev_.size(); N++) wK_prev_[N]->copy(wK_ao_[N]);
+}
+void DirectJK::incfock_reset()
+{
+    incfock_count_ = 0;
+    D_prev_.clear();
+    J_prev_.clear();
+    K_prev_.clear();
+    wK_prev_.clear();
+    delta_D_.clear();
 }
 void DirectJK::compute_JK()
 {
     boost::shared_ptr<IntegralFactory> factory(new IntegralFactory(primary_,primary_,primary_,primary_));
 
+    // In incremental mode, J/K are built from D - D_prev and added to the previous J/K
+    bool incremental = incfock_setup();
+    std::vector<SharedMatrix>& D = (incremental ? delta_D_ : D_ao_);
+    computed_shells_ = 0L;
+
     if (do_wK_) {
         std::vector<boost::shared_ptr<TwoBodyAOInt> > ints;
         for (int thread = 0; thread < df_ints_num_threads_; thread++) {
@@ -94,13 +171,13 @@ void DirectJK::compute_JK()
         }
         // TODO: Fast K algorithm
         if (do_J_) {
-            build_JK(ints,D_ao_,J_ao_,wK_ao_);
+            build_JK(ints,D,J_ao_,wK_ao_);
         } else {
             std::vector<boost::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
+            for (size_t i = 0; i < D.size(); i++) {
                 temp.push_back(boost::shared_ptr<Matrix>(new Matrix("temp", primary_->nbf(), primary_->nbf())));
             }
-            build_JK(ints,D_ao_,temp,wK_ao_);
+            build_JK(ints,D,temp,wK_ao_);
         }
     }
 
@@ -110,31 +187,97 @@ void DirectJK::compute_JK()
             ints.push_back(boost::shared_ptr<TwoBodyAOInt>(factory->erd_eri()));
         }
         if (do_J_ && do_K_) {
-            build_JK(ints,D_ao_,J_ao_,K_ao_);
+            build_JK(ints,D,J_ao_,K_ao_);
         } else if (do_J_) {
             std::vector<boost::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
+            for (size_t i = 0; i < D.size(); i++) {
                 temp.push_back(boost::shared_ptr<Matrix>(new Matrix("temp", primary_->nbf(), primary_->nbf())));
             }
-            build_JK(ints,D_ao_,J_ao_,temp);
+            build_JK(ints,D,J_ao_,temp);
         } else {
             std::vector<boost::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
+            for (size_t i = 0; i < D.size(); i++) {
                 temp.push_back(boost::shared_ptr<Matrix>(new Matrix("temp", primary_->nbf(), primary_->nbf())));
             }
-            build_JK(ints,D_ao_,temp,K_ao_);
+            build_JK(ints,D,temp,K_ao_);
         }
     }
 
+    incfock_postiter(incremental);
+
+    if (print_ > 1 && incfock_) {
+        outfile->Printf( "  DirectJK: %s build, %zu shell quartets computed\n",
+            (incremental ? "Incremental" : "Full"), computed_shells_);
+    }
 }
 void DirectJK::postiterations()
 {
     sieve_.reset();
+    sorted_pairs_.clear();
+    class_starts_.clear();
+    incfock_reset();
+}
+void DirectJK::shell_max_density(const std::vector<SharedMatrix>& D, std::vector<double>& Dshell) const
+{
+    // max |D_mn| over each shell pair (both orderings, all densities), so
+    // that |(PQ|RS)| * max |D| bounds every J/K contribution of a quartet.
+    // This is what lets an incremental build on a small D - D_prev skip
+    // most quartets.
+    int nshell = primary_->nshell();
+    Dshell.assign((size_t) nshell * nshell, 0.0);
+    for (size_t ind = 0; ind < D.size(); ind++) {
+        double** Dp = D[ind]->pointer();
+        for (int P = 0; P < nshell; P++) {
+            int Psize = primary_->shell(P).nfunction();
+            int Poff = primary_->shell(P).function_index();
+            for (int Q = 0; Q <= P; Q++) {
+                int Qsize = primary_->shell(Q).nfunction();
+                int Qoff = primary_->shell(Q).function_index();
+                double Dmax = Dshell[P * (size_t) nshell + Q];
+                for (int p = 0; p < Psize; p++) {
+                    for (int q = 0; q < Qsize; q++) {
+                        Dmax = std::max(Dmax, std::fabs(Dp[p + Poff][q + Qoff]));
+                        Dmax = std::max(Dmax, std::fabs(Dp[q + Qoff][p + Poff]));
+                    }
+                }
+                Dshell[P * (size_t) nshell + Q] = Dmax;
+                Dshell[Q * (size_t) nshell + P] = Dmax;
+            }
+        }
+    }
+}
+std::string DirectJK::accumulation_mode(size_t nD) const
+{
+    // Task tiles are added into J/K either into per-thread full copies
+    // of J/K, reduced once after the sweep (PRIVATE), under a lock on the
+    // target task's block of rows (BLOCKED), or element by element with
+    // atomics (ATOMIC). AUTO picks PRIVATE if the copies fit in memory.
+    int nthread = df_ints_num_threads_;
+    int nbf = primary_->nbf();
+    std::string mode = accumulation_;
+    if (mode == "AUTO") {
+        unsigned long int private_mem = 2L * nthread * nD * nbf * (unsigned long int) nbf;
+        unsigned long int overhead = memory_overhead();
+        bool fits = memory_ > overhead && private_mem <= memory_ - overhead;
+        mode = (nthread > 1 && fits ? "PRIVATE" : "BLOCKED");
+    }
+    return mode;
 }
 void DirectJK::build_JK(std::vector<boost::shared_ptr<TwoBodyAOInt> >& ints,
                         std::vector<boost::shared_ptr<Matrix> >& D,
                         std::vector<boost::shared_ptr<Matrix> >& J,
                         std::vector<boost::shared_ptr<Matrix> >& K)
+{
+    if (scheduler_ == "TASK") {
+        build_JK_task(ints,D,J,K);
+    } else {
+        build_JK_sorted(ints,D,J,K);
+    }
+}
+void DirectJK::build_JK_task(std::vector<boost::shared_ptr<TwoBodyAOInt> >& ints,
+                             std::vector<boost::shared_ptr<Matrix> >& D,
+                             std::vector<boost::shared_ptr<Matrix> >& J,
+                             std::vector<boost::shared_ptr<Matrix> >& K)
 {
     // => Zeroing <= //
 
@@ -225,6 +368,12 @@ void DirectJK::build_JK(std::vector<boost::shared_ptr<TwoBodyAOInt> >& ints,
     size_t ntask_pair = task_pairs.size();
     size_t ntask_pair2 = ntask_pair * ntask_pair;
 
+    // => Density Screening <= //
+
+    std::vector<double> Dshell;
+    shell_max_density(D, Dshell);
+    double cutoff2 = cutoff_ * cutoff_;
+
     // => Intermediate Buffers <= //
 
     std::vector<std::vector<boost::shared_ptr<Matrix> > > JKT;
@@ -236,9 +385,42 @@ void DirectJK::build_JK(std::vector<boost::shared_ptr<TwoBodyAOInt> >& ints,
         JKT.push_back(JK2);
     }
 
+    // => Accumulation Mode <= //
+
+    int nbf = primary_->nbf();
+    std::string mode = accumulation_mode(D.size());
+    bool private_acc = (mode == "PRIVATE");
+    bool blocked_acc = (mode == "BLOCKED");
+    bool atomic_acc  = (mode == "ATOMIC");
+
+    std::vector<std::vector<SharedMatrix> > JP(nthread);
+    std::vector<std::vector<SharedMatrix> > KP(nthread);
+    if (private_acc) {
+        // Each thread allocates (and first touches) its own copies
+        #pragma omp parallel for num_threads(nthread) schedule(static,1)
+        for (int t = 0; t < nthread; t++) {
+            for (size_t ind = 0; ind < D.size(); ind++) {
+                JP[t].push_back(SharedMatrix(new Matrix("J Private", nbf, nbf)));
+                KP[t].push_back(SharedMatrix(new Matrix("K Private", nbf, nbf)));
+            }
+        }
+    }
+
+    #ifdef _OPENMP
+    std::vector<omp_lock_t> locks(blocked_acc ? ntask : 0L);
+    for (size_t lock = 0; lock < locks.size(); lock++) {
+        omp_init_lock(&locks[lock]);
+    }
+    #endif
+
+    // Row and column tasks (P, Q, R, S) of the J1, J2, K1, ..., K8 tiles
+    static const int tile_rows[10] = {0, 2, 0, 0, 1, 1, 2, 3, 2, 3};
+    static const int tile_cols[10] = {1, 3, 2, 3, 2, 3, 0, 0, 1, 1};
+
     // => Benchmarks <= //
 
     size_t computed_shells = 0L;
+    Timer build_timer;
 
     // ==> Master Task Loop <== //
 
@@ -300,6 +482,11 @@ void DirectJK::build_JK(std::vector<boost::shared_ptr<TwoBodyAOInt> >& ints,
             if (!sieve_->shell_pair_significant(R,S)) continue;
             if (!sieve_->shell_significant(P,Q,R,S)) continue;
 
+            double Dmax = std::max(Dshell[P * (size_t) nshell + Q], Dshell[R * (size_t) nshell + S]);
+            Dmax = std::max(Dmax, std::max(Dshell[P * (size_t) nshell + R], Dshell[P * (size_t) nshell + S]));
+            Dmax = std::max(Dmax, std::max(Dshell[Q * (size_t) nshell + R], Dshell[Q * (size_t) nshell + S]));
+            if (sieve_->shell_ceiling2(P,Q,R,S) * Dmax * Dmax < cutoff2) continue;
+
             //printf("Quartet: %2d %2d %2d %2d\n", P, Q, R, S);
 
             //if (thread == 0) timer_on("JK: Ints");
@@ -397,163 +584,464 @@ void DirectJK::build_JK(std::vector<boost::shared_ptr<TwoBodyAOInt> >& ints,
 
         // => Stripe out <= //
 
+        // Each of the task tiles lands in the rows of a single task,
+        // which is the unit of locking in BLOCKED mode
+        int tasks[4] = {Ptask, Qtask, Rtask, Stask};
+        int ntile = (lr_symmetric_ ? 6 : 10);
+
         //if (thread == 0) timer_on("JK: Atomic");
         for (size_t ind = 0; ind < D.size(); ind++) {
             double** JKTp = JKT[thread][ind]->pointer();
+            double** Jp = (private_acc ? JP[thread][ind] : J[ind])->pointer();
+            double** Kp = (private_acc ? KP[thread][ind] : K[ind])->pointer();
+
+            for (int tile = 0; tile < ntile; tile++) {
+                double** Mp = (tile < 2 ? Jp : Kp);
+                const double* Tp = JKTp[tile * (size_t) max_task];
+                int Atask = tasks[tile_rows[tile]];
+                int Btask = tasks[tile_cols[tile]];
+                int A2start = task_starts[Atask];
+                int B2start = task_starts[Btask];
+                int ldt = task_offsets[task_starts[Btask + 1]] - task_offsets[B2start];
+
+                #ifdef _OPENMP
+                if (blocked_acc) omp_set_lock(&locks[Atask]);
+                #endif
+
+                for (int A2 = A2start; A2 < task_starts[Atask + 1]; A2++) {
+                for (int B2 = B2start; B2 < task_starts[Btask + 1]; B2++) {
+                    int A = task_shells[A2];
+                    int B = task_shells[B2];
+                    int Asize = primary_->shell(A).nfunction();
+                    int Bsize = primary_->shell(B).nfunction();
+                    int Aoff =  primary_->shell(A).function_index();
+                    int Boff =  primary_->shell(B).function_index();
+                    int Aoff2 = task_offsets[A2] - task_offsets[A2start];
+                    int Boff2 = task_offsets[B2] - task_offsets[B2start];
+                    for (int a = 0; a < Asize; a++) {
+                        const double* Trow = &Tp[(a + Aoff2) * (size_t) ldt + Boff2];
+                        double* Mrow = &Mp[a + Aoff][Boff];
+                        if (atomic_acc) {
+                            for (int b = 0; b < Bsize; b++) {
+                                #pragma omp atomic
+                                Mrow[b] += Trow[b];
+                            }
+                        } else {
+                            for (int b = 0; b < Bsize; b++) {
+                                Mrow[b] += Trow[b];
+                            }
+                        }
+                    }
+                }}
+
+                #ifdef _OPENMP
+                if (blocked_acc) omp_unset_lock(&locks[Atask]);
+                #endif
+            }
+
+        } // End stripe out
+        //if (thread == 0) timer_off("JK: Atomic");
+
+    } // End master task list
+
+    // => Reduction of Thread-Private J/K <= //
+
+    if (private_acc) {
+        for (size_t ind = 0; ind < D.size(); ind++) {
             double** Jp = J[ind]->pointer();
             double** Kp = K[ind]->pointer();
+            #pragma omp parallel for num_threads(nthread)
+            for (int m = 0; m < nbf; m++) {
+                for (int t = 0; t < nthread; t++) {
+                    double* JProw = JP[t][ind]->pointer()[m];
+                    double* KProw = KP[t][ind]->pointer()[m];
+                    for (int n = 0; n < nbf; n++) {
+                        Jp[m][n] += JProw[n];
+                        Kp[m][n] += KProw[n];
+                    }
+                }
+            }
+        }
+    }
+
+    #ifdef _OPENMP
+    for (size_t lock = 0; lock < locks.size(); lock++) {
+        omp_destroy_lock(&locks[lock]);
+    }
+    #endif
+
+    for (size_t ind = 0; ind < D.size(); ind++) {
+        J[ind]->scale(2.0);
+        J[ind]->hermitivitize();
+        if (lr_symmetric_) {
+            K[ind]->scale(2.0);
+            K[ind]->hermitivitize();
+        }
+    }
+
+    computed_shells_ += computed_shells;
+
+    if (bench_) {
+       boost::shared_ptr<OutFile> printer(new OutFile("bench.dat",APPEND));
+        size_t ntri = nshell * (nshell + 1L) / 2L;
+        size_t possible_shells = ntri * (ntri + 1L) / 2L;
+        printer->Printf( "Computed %20zu Shell Quartets out of %20zu, (%11.3E ratio)\n", computed_shells, possible_shells, computed_shells / (double) possible_shells);
+        printer->Printf( "Built J/K with %3d threads, %7s accumulation in %11.3f [s]\n", nthread, mode.c_str(), build_timer.get());
+    }
+}
+
+namespace {
+
+/// A significant shell pair and the keys it is sorted by
+struct DirectPair {
+    int P;
+    int Q;
+    int am_total;
+    int am_class;
+    double ceiling2;
+};
+
+/// Higher total angular momentum first, then by class, then larger bound
+bool direct_pair_before(const DirectPair& a, const DirectPair& b)
+{
+    if (a.am_total != b.am_total) return a.am_total > b.am_total;
+    if (a.am_class != b.am_class) return a.am_class > b.am_class;
+    return a.ceiling2 > b.ceiling2;
+}
+
+/// Bra pairs per task of the sorted scheduler
+const int DIRECT_BRA_BLOCK = 4;
+
+}
+
+void DirectJK::sort_shell_pairs()
+{
+    // The most expensive classes come first, so that a dynamic schedule
+    // hands them out early, and within a class the pairs are sorted by
+    // decreasing Schwarz bound, so that a sweep over the kets of a class
+    // can stop at the first insignificant quartet
+    const std::vector<std::pair<int,int> >& pairs = sieve_->shell_pairs();
+    int nam = primary_->max_am() + 1;
+
+    std::vector<DirectPair> keyed(pairs.size());
+    for (size_t PQ = 0; PQ < pairs.size(); PQ++) {
+        int P = pairs[PQ].first;
+        int Q = pairs[PQ].second;
+        int lP = primary_->shell(P).am();
+        int lQ = primary_->shell(Q).am();
+        keyed[PQ].P = P;
+        keyed[PQ].Q = Q;
+        keyed[PQ].am_total = lP + lQ;
+        keyed[PQ].am_class = std::max(lP, lQ) * nam + std::min(lP, lQ);
+        keyed[PQ].ceiling2 = sieve_->shell_ceiling2(P,Q,P,Q);
+    }
+    std::stable_sort(keyed.begin(), keyed.end(), direct_pair_before);
+
+    sorted_pairs_.clear();
+    class_starts_.clear();
+    for (size_t PQ = 0; PQ < keyed.size(); PQ++) {
+        if (PQ == 0 || keyed[PQ].am_class != keyed[PQ - 1].am_class) {
+            class_starts_.push_back(PQ);
+        }
+        sorted_pairs_.push_back(std::pair<int,int>(keyed[PQ].P, keyed[PQ].Q));
+    }
+    class_starts_.push_back(sorted_pairs_.size());
+
+    if (debug_) {
+        outfile->Printf( "  ==> DirectJK: Sorted Shell Pairs <==\n\n");
+        for (size_t c = 0; c + 1 < class_starts_.size(); c++) {
+            int P = sorted_pairs_[class_starts_[c]].first;
+            int Q = sorted_pairs_[class_starts_[c]].second;
+            outfile->Printf( "  Class (%d%d|: %6d pairs\n",
+                primary_->shell(P).am(), primary_->shell(Q).am(), class_starts_[c + 1] - class_starts_[c]);
+        }
+        outfile->Printf( "\n");
+    }
+}
+void DirectJK::build_JK_sorted(std::vector<boost::shared_ptr<TwoBodyAOInt> >& ints,
+                               std::vector<boost::shared_ptr<Matrix> >& D,
+                               std::vector<boost::shared_ptr<Matrix> >& J,
+                               std::vector<boost::shared_ptr<Matrix> >& K)
+{
+    // => Zeroing <= //
+
+    for (size_t ind = 0; ind < J.size(); ind++) {
+        J[ind]->zero();
+    }
+    for (size_t ind = 0; ind < K.size(); ind++) {
+        K[ind]->zero();
+    }
+
+    // => Sizing <= //
+
+    int nshell  = primary_->nshell();
+    int nthread = df_ints_num_threads_;
+    int nbf     = primary_->nbf();
+    int nclass  = class_starts_.size() - 1;
+    size_t npair = sorted_pairs_.size();
+    int max_size = primary_->max_function_per_shell();
+
+    // => Density Screening <= //
+
+    std::vector<double> Dshell;
+    shell_max_density(D, Dshell);
+    double Dglobal = 0.0;
+    for (size_t PQ = 0; PQ < Dshell.size(); PQ++) {
+        Dglobal = std::max(Dglobal, Dshell[PQ]);
+    }
+    double cutoff2 = cutoff_ * cutoff_;
+
+    // => Task List <= //
+
+    // A task is a block of bra pairs of one class against the ket pairs
+    // of one class, up to the bra itself, so that the quartets a thread
+    // computes in a row all belong to one integral class
+    std::vector<int> task_bra;
+    std::vector<int> task_ket_class;
+    for (int bra_class = 0; bra_class < nclass; bra_class++) {
+        for (int bra = class_starts_[bra_class]; bra < class_starts_[bra_class + 1]; bra += DIRECT_BRA_BLOCK) {
+            for (int ket_class = 0; ket_class <= bra_class; ket_class++) {
+                task_bra.push_back(bra);
+                task_ket_class.push_back(ket_class);
+            }
+        }
+    }
+    long int ntask = task_bra.size();
+
+    // => Accumulation Mode <= //
+
+    // Quartet tiles are too small to lock, so BLOCKED falls back to ATOMIC
+    std::string mode = accumulation_mode(D.size());
+    if (mode == "BLOCKED") mode = "ATOMIC";
+    bool private_acc = (mode == "PRIVATE");
 
-            double* J1p = JKTp[0L * max_task];
-            double* J2p = JKTp[1L * max_task];
-            double* K1p = JKTp[2L * max_task];
-            double* K2p = JKTp[3L * max_task];
-            double* K3p = JKTp[4L * max_task];
-            double* K4p = JKTp[5L * max_task];
-            double* K5p;
-            double* K6p;
-            double* K7p;
-            double* K8p;
-            if (!lr_symmetric_) {
-                K5p = JKTp[6L * max_task];
-                K6p = JKTp[7L * max_task];
-                K7p = JKTp[8L * max_task];
-                K8p = JKTp[9L * max_task];
+    std::vector<std::vector<SharedMatrix> > JP(nthread);
+    std::vector<std::vector<SharedMatrix> > KP(nthread);
+    if (private_acc) {
+        // Each thread allocates (and first touches) its own copies
+        #pragma omp parallel for num_threads(nthread) schedule(static,1)
+        for (int t = 0; t < nthread; t++) {
+            for (size_t ind = 0; ind < D.size(); ind++) {
+                JP[t].push_back(SharedMatrix(new Matrix("J Private", nbf, nbf)));
+                KP[t].push_back(SharedMatrix(new Matrix("K Private", nbf, nbf)));
             }
+        }
+    }
+
+    // Row and column pairs (P, Q, R, S) of the J1, J2, K1, ..., K8 tiles
+    static const int tile_rows[10] = {0, 2, 0, 0, 1, 1, 2, 3, 2, 3};
+    static const int tile_cols[10] = {1, 3, 2, 3, 2, 3, 0, 0, 1, 1};
+    int ntile = (lr_symmetric_ ? 6 : 10);
+    size_t tile_size = max_size * (size_t) max_size;
 
-            // > J_PQ < //
+    // => Benchmarks <= //
+
+    size_t computed_shells = 0L;
+    size_t schwarz_shells = 0L;
+    size_t density_shells = 0L;
+    Timer build_timer;
 
-            for (int P2 = 0; P2 < nPtask; P2++) {
-            for (int Q2 = 0; Q2 < nQtask; Q2++) {
-                int P = task_shells[P2start + P2];
-                int Q = task_shells[Q2start + Q2];
+    // ==> Master Task Loop <== //
+
+    #pragma omp parallel num_threads(nthread) reduction(+: computed_shells, schwarz_shells, density_shells)
+    {
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        // J1 tiles of the current bra pair, and the tiles of one quartet
+        std::vector<double> J1T(D.size() * tile_size);
+        std::vector<double> JKT(D.size() * ntile * tile_size);
+
+        #pragma omp for schedule(dynamic)
+        for (long int task = 0L; task < ntask; task++) {
+
+            int bra_class = 0;
+            while (class_starts_[bra_class + 1] <= task_bra[task]) bra_class++;
+            int bra_start = task_bra[task];
+            int bra_end = std::min(bra_start + DIRECT_BRA_BLOCK, class_starts_[bra_class + 1]);
+            int ket_class = task_ket_class[task];
+
+            for (int bra = bra_start; bra < bra_end; bra++) {
+
+                int P = sorted_pairs_[bra].first;
+                int Q = sorted_pairs_[bra].second;
                 int Psize = primary_->shell(P).nfunction();
                 int Qsize = primary_->shell(Q).nfunction();
-                int Poff =  primary_->shell(P).function_index();
-                int Qoff =  primary_->shell(Q).function_index();
-                int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                for (int p = 0; p < Psize; p++) {
-                for (int q = 0; q < Qsize; q++) {
-                    #pragma omp atomic
-                    Jp[p + Poff][q + Qoff] += J1p[(p + Poff2) * dQsize + q + Qoff2];
-                }}
-            }}
-
-            // > J_RS < //
-
-            for (int R2 = 0; R2 < nRtask; R2++) {
-            for (int S2 = 0; S2 < nStask; S2++) {
-                int R = task_shells[R2start + R2];
-                int S = task_shells[S2start + S2];
-                int Rsize = primary_->shell(R).nfunction();
-                int Ssize = primary_->shell(S).nfunction();
-                int Roff =  primary_->shell(R).function_index();
-                int Soff =  primary_->shell(S).function_index();
-                int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                for (int r = 0; r < Rsize; r++) {
-                for (int s = 0; s < Ssize; s++) {
-                    #pragma omp atomic
-                    Jp[r + Roff][s + Soff] += J2p[(r + Roff2) * dSsize + s + Soff2];
-                }}
-            }}
+                int Poff = primary_->shell(P).function_index();
+                int Qoff = primary_->shell(Q).function_index();
 
-            // > K_PR < //
+                ::memset((void*) &J1T[0], '\0', J1T.size() * sizeof(double));
+                bool touched = false;
 
-            for (int P2 = 0; P2 < nPtask; P2++) {
-            for (int R2 = 0; R2 < nRtask; R2++) {
-                int P = task_shells[P2start + P2];
-                int R = task_shells[R2start + R2];
-                int Psize = primary_->shell(P).nfunction();
-                int Rsize = primary_->shell(R).nfunction();
-                int Poff =  primary_->shell(P).function_index();
-                int Roff =  primary_->shell(R).function_index();
-                int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                for (int p = 0; p < Psize; p++) {
-                for (int r = 0; r < Rsize; r++) {
-                    #pragma omp atomic
-                    Kp[p + Poff][r + Roff] += K1p[(p + Poff2) * dRsize + r + Roff2];
-                    if (!lr_symmetric_) {
-                        #pragma omp atomic
-                        Kp[r + Roff][p + Poff] += K5p[(r + Roff2) * dPsize + p + Poff2];
-                    }
-                }}
-            }}
+                // Kets up to the bra itself, each unique quartet once
+                int ket_start = class_starts_[ket_class];
+                int ket_end = (ket_class == bra_class ? bra + 1 : class_starts_[ket_class + 1]);
 
-            // > K_PS < //
+                for (int ket = ket_start; ket < ket_end; ket++) {
 
-            for (int P2 = 0; P2 < nPtask; P2++) {
-            for (int S2 = 0; S2 < nStask; S2++) {
-                int P = task_shells[P2start + P2];
-                int S = task_shells[S2start + S2];
-                int Psize = primary_->shell(P).nfunction();
-                int Ssize = primary_->shell(S).nfunction();
-                int Poff =  primary_->shell(P).function_index();
-                int Soff =  primary_->shell(S).function_index();
-                int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                for (int p = 0; p < Psize; p++) {
-                for (int s = 0; s < Ssize; s++) {
-                    #pragma omp atomic
-                    Kp[p + Poff][s + Soff] += K2p[(p + Poff2) * dSsize + s + Soff2];
-                    if (!lr_symmetric_) {
-                        #pragma omp atomic
-                        Kp[s + Soff][p + Poff] += K6p[(s + Soff2) * dPsize + p + Poff2];
+                    int R = sorted_pairs_[ket].first;
+                    int S = sorted_pairs_[ket].second;
+
+                    // Kets are sorted by bound, so the rest of the class fails too
+                    double ceiling2 = sieve_->shell_ceiling2(P,Q,R,S);
+                    if (ceiling2 < cutoff2) {
+                        schwarz_shells += ket_end - ket;
+                        break;
+                    }
+                    if (ceiling2 * Dglobal * Dglobal < cutoff2) {
+                        density_shells += ket_end - ket;
+                        break;
+                    }
+                    if (!sieve_->shell_significant(P,Q,R,S)) {
+                        schwarz_shells++;
+                        continue;
                     }
-                }}
-            }}
 
-            // > K_QR < //
+                    double Dmax = std::max(Dshell[P * (size_t) nshell + Q], Dshell[R * (size_t) nshell + S]);
+                    Dmax = std::max(Dmax, std::max(Dshell[P * (size_t) nshell + R], Dshell[P * (size_t) nshell + S]));
+                    Dmax = std::max(Dmax, std::max(Dshell[Q * (size_t) nshell + R], Dshell[Q * (size_t) nshell + S]));
+                    if (ceiling2 * Dmax * Dmax < cutoff2) {
+                        density_shells++;
+                        continue;
+                    }
 
-            for (int Q2 = 0; Q2 < nQtask; Q2++) {
-            for (int R2 = 0; R2 < nRtask; R2++) {
-                int Q = task_shells[Q2start + Q2];
-                int R = task_shells[R2start + R2];
-                int Qsize = primary_->shell(Q).nfunction();
-                int Rsize = primary_->shell(R).nfunction();
-                int Qoff =  primary_->shell(Q).function_index();
-                int Roff =  primary_->shell(R).function_index();
-                int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                for (int q = 0; q < Qsize; q++) {
-                for (int r = 0; r < Rsize; r++) {
-                    #pragma omp atomic
-                    Kp[q + Qoff][r + Roff] += K3p[(q + Qoff2) * dRsize + r + Roff2];
-                    if (!lr_symmetric_) {
-                        #pragma omp atomic
-                        Kp[r + Roff][q + Qoff] += K7p[(r + Roff2) * dQsize + q + Qoff2];
+                    if(ints[thread]->compute_shell(P,Q,R,S) == 0)
+                        continue; // No integrals in this shell quartet
+                    computed_shells++;
+                    touched = true;
+
+                    const double* buffer = ints[thread]->buffer();
+
+                    int Rsize = primary_->shell(R).nfunction();
+                    int Ssize = primary_->shell(S).nfunction();
+                    int Roff = primary_->shell(R).function_index();
+                    int Soff = primary_->shell(S).function_index();
+
+                    double prefactor = 1.0;
+                    if (P == Q)           prefactor *= 0.5;
+                    if (R == S)           prefactor *= 0.5;
+                    if (P == R && Q == S) prefactor *= 0.5;
+
+                    ::memset((void*) &JKT[0], '\0', JKT.size() * sizeof(double));
+
+                    for (size_t ind = 0; ind < D.size(); ind++) {
+                        double** Dp = D[ind]->pointer();
+                        const double* buffer2 = buffer;
+
+                        double* J1p = &J1T[ind * tile_size];
+                        double* Tp = &JKT[ind * ntile * tile_size];
+                        double* J2p = Tp + 1 * tile_size;
+                        double* K1p = Tp + 2 * tile_size;
+                        double* K2p = Tp + 3 * tile_size;
+                        double* K3p = Tp + 4 * tile_size;
+                        double* K4p = Tp + 5 * tile_size;
+                        double* K5p = Tp + 6 * tile_size;
+                        double* K6p = Tp + 7 * tile_size;
+                        double* K7p = Tp + 8 * tile_size;
+                        double* K8p = Tp + 9 * tile_size;
+
+                        for (int p = 0; p < Psize; p++) {
+                        for (int q = 0; q < Qsize; q++) {
+                        for (int r = 0; r < Rsize; r++) {
+                        for (int s = 0; s < Ssize; s++) {
+                            double val = prefactor * (*buffer2);
+                            J1p[p * Qsize + q] += val * (Dp[r + Roff][s + Soff] + Dp[s + Soff][r + Roff]);
+                            J2p[r * Ssize + s] += val * (Dp[p + Poff][q + Qoff] + Dp[q + Qoff][p + Poff]);
+                            K1p[p * Rsize + r] += val * (Dp[q + Qoff][s + Soff]);
+                            K2p[p * Ssize + s] += val * (Dp[q + Qoff][r + Roff]);
+                            K3p[q * Rsize + r] += val * (Dp[p + Poff][s + Soff]);
+                            K4p[q * Ssize + s] += val * (Dp[p + Poff][r + Roff]);
+                            if (!lr_symmetric_) {
+                                K5p[r * Psize + p] += val * (Dp[s + Soff][q + Qoff]);
+                                K6p[s * Psize + p] += val * (Dp[r + Roff][q + Qoff]);
+                                K7p[r * Qsize + q] += val * (Dp[s + Soff][p + Poff]);
+                                K8p[s * Qsize + q] += val * (Dp[r + Roff][p + Poff]);
+                            }
+                            buffer2++;
+                        }}}}
                     }
-                }}
-            }}
 
-            // > K_QS < //
+                    // => Stripe out the quartet's J2 and K tiles <= //
+
+                    int shells[4] = {P, Q, R, S};
+                    for (size_t ind = 0; ind < D.size(); ind++) {
+                        double** Jp = (private_acc ? JP[thread][ind] : J[ind])->pointer();
+                        double** Kp = (private_acc ? KP[thread][ind] : K[ind])->pointer();
+                        for (int tile = 1; tile < ntile; tile++) {
+                            double** Mp = (tile < 2 ? Jp : Kp);
+                            const double* Tp = &JKT[(ind * ntile + tile) * tile_size];
+                            int A = shells[tile_rows[tile]];
+                            int B = shells[tile_cols[tile]];
+                            int Asize = primary_->shell(A).nfunction();
+                            int Bsize = primary_->shell(B).nfunction();
+                            int Aoff = primary_->shell(A).function_index();
+                            int Boff = primary_->shell(B).function_index();
+                            for (int a = 0; a < Asize; a++) {
+                                double* Mrow = &Mp[a + Aoff][Boff];
+                                if (private_acc) {
+                                    for (int b = 0; b < Bsize; b++) {
+                                        Mrow[b] += Tp[a * Bsize + b];
+                                    }
+                                } else {
+                                    for (int b = 0; b < Bsize; b++) {
+                                        #pragma omp atomic
+                                        Mrow[b] += Tp[a * Bsize + b];
+                                    }
+                                }
+                            }
+                        }
+                    }
 
-            for (int Q2 = 0; Q2 < nQtask; Q2++) {
-            for (int S2 = 0; S2 < nStask; S2++) {
-                int Q = task_shells[Q2start + Q2];
-                int S = task_shells[S2start + S2];
-                int Qsize = primary_->shell(Q).nfunction();
-                int Ssize = primary_->shell(S).nfunction();
-                int Qoff =  primary_->shell(Q).function_index();
-                int Soff =  primary_->shell(S).function_index();
-                int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                for (int q = 0; q < Qsize; q++) {
-                for (int s = 0; s < Ssize; s++) {
-                    #pragma omp atomic
-                    Kp[q + Qoff][s + Soff] += K4p[(q + Qoff2) * dSsize + s + Soff2];
-                    if (!lr_symmetric_) {
-                        #pragma omp atomic
-                        Kp[s + Soff][q + Qoff] += K8p[(s + Soff2) * dQsize + q + Qoff2];
+                } // End kets
+
+                if (!touched) continue;
+
+                // => Stripe out the bra's J1 tile <= //
+
+                for (size_t ind = 0; ind < D.size(); ind++) {
+                    double** Jp = (private_acc ? JP[thread][ind] : J[ind])->pointer();
+                    const double* J1p = &J1T[ind * tile_size];
+                    for (int p = 0; p < Psize; p++) {
+                        double* Jrow = &Jp[p + Poff][Qoff];
+                        if (private_acc) {
+                            for (int q = 0; q < Qsize; q++) {
+                                Jrow[q] += J1p[p * Qsize + q];
+                            }
+                        } else {
+                            for (int q = 0; q < Qsize; q++) {
+                                #pragma omp atomic
+                                Jrow[q] += J1p[p * Qsize + q];
+                            }
+                        }
                     }
-                }}
-            }}
+                }
 
-        } // End stripe out
-        //if (thread == 0) timer_off("JK: Atomic");
+            } // End bras
 
-    } // End master task list
+        } // End master task list
+    }
+
+    // => Reduction of Thread-Private J/K <= //
+
+    if (private_acc) {
+        for (size_t ind = 0; ind < D.size(); ind++) {
+            double** Jp = J[ind]->pointer();
+            double** Kp = K[ind]->pointer();
+            #pragma omp parallel for num_threads(nthread)
+            for (int m = 0; m < nbf; m++) {
+                for (int t = 0; t < nthread; t++) {
+                    double* JProw = JP[t][ind]->pointer()[m];
+                    double* KProw = KP[t][ind]->pointer()[m];
+                    for (int n = 0; n < nbf; n++) {
+                        Jp[m][n] += JProw[n];
+                        Kp[m][n] += KProw[n];
+                    }
+                }
+            }
+        }
+    }
 
     for (size_t ind = 0; ind < D.size(); ind++) {
         J[ind]->scale(2.0);
@@ -564,12 +1052,114 @@ void DirectJK::build_JK(std::vector<boost::shared_ptr<TwoBodyAOInt> >& ints,
         }
     }
 
+    computed_shells_ += computed_shells;
+
+    size_t possible_shells = npair * (npair + 1L) / 2L;
+    if (print_ > 1) {
+        outfile->Printf( "  DirectJK: %zu of %zu shell quartets computed, %zu screened by Schwarz, %zu by density (%.3f s)\n",
+            computed_shells, possible_shells, schwarz_shells, density_shells, build_timer.get());
+    }
     if (bench_) {
-       boost::shared_ptr<OutFile> printer(new OutFile("bench.dat",APPEND));
-        size_t ntri = nshell * (nshell + 1L) / 2L;
-        size_t possible_shells = ntri * (ntri + 1L) / 2L;
+        boost::shared_ptr<OutFile> printer(new OutFile("bench.dat",APPEND));
         printer->Printf( "Computed %20zu Shell Quartets out of %20zu, (%11.3E ratio)\n", computed_shells, possible_shells, computed_shells / (double) possible_shells);
+        printer->Printf( "Screened %20zu by Schwarz and %20zu by density, %d classes, %ld tasks\n", schwarz_shells, density_shells, nclass, ntask);
+        printer->Printf( "Built J/K with %3d threads, %7s accumulation in %11.3f [s]\n", nthread, mode.c_str(), build_timer.get());
+    }
+}
+
+void benchmark_directjk(int max_threads, double min_time)
+{
+    outfile->Printf( "\n");
+    outfile->Printf( "                              ---------------------------------- \n");
+    outfile->Printf( "                              ======> DIRECTJK BENCHMARKS <===== \n");
+    outfile->Printf( "                              ---------------------------------- \n");
+    outfile->Printf( "\n");
+
+    Options& options = Process::environment.options;
+    boost::shared_ptr<BasisSet> primary = BasisSet::pyconstruct_orbital(Process::environment.molecule(),
+        "BASIS", options.get_str("BASIS"));
+    boost::shared_ptr<Molecule> molecule = primary->molecule();
+
+    // A dense, deterministic pseudo-occupied C, all in the first irrep
+    boost::shared_ptr<IntegralFactory> factory(new IntegralFactory(primary,primary,primary,primary));
+    boost::shared_ptr<PetiteList> pet(new PetiteList(primary, factory));
+    Dimension nsopi = pet->SO_basisdim();
+    double nelectron = 0.0;
+    for (int A = 0; A < molecule->natom(); A++) {
+        nelectron += molecule->Z(A);
+    }
+    Dimension noccpi(nsopi.n());
+    noccpi[0] = std::max(1, std::min((int) (nelectron / 2.0), nsopi[0]));
+    SharedMatrix C(new Matrix("C", nsopi, noccpi));
+    double** Cp = C->pointer(0);
+    for (int m = 0; m < nsopi[0]; m++) {
+        for (int i = 0; i < noccpi[0]; i++) {
+            Cp[m][i] = sin(1.0 + m + 7.0 * i) / sqrt((double) nsopi[0]);
+        }
+    }
+
+    outfile->Printf( "  Parameters:\n");
+    outfile->Printf( "   -Minimum runtime (per mode, per thread count): %14.10f [s].\n", min_time);
+    outfile->Printf( "   -Max threads: %d.\n", max_threads);
+    outfile->Printf( "   -Basis functions: %d, shells: %d, pseudo-occupied orbitals: %d.\n",
+        primary->nbf(), primary->nshell(), noccpi[0]);
+    outfile->Printf( "\n");
+
+    outfile->Printf( "  Notes:\n");
+    outfile->Printf( "   -Times are for one J/K build, in [s]. Speedups are relative to one thread.\n");
+    outfile->Printf( "\n");
+
+    std::vector<std::string> modes;
+    modes.push_back("ATOMIC");
+    modes.push_back("BLOCKED");
+    modes.push_back("PRIVATE");
+
+    std::vector<int> threads;
+    for (int thread = 1; thread < max_threads; thread *= 2) {
+        threads.push_back(thread);
+    }
+    threads.push_back(max_threads);
+
+    std::map<std::string, std::vector<double> > timings;
+    for (size_t mode = 0; mode < modes.size(); mode++) {
+        for (size_t ind = 0; ind < threads.size(); ind++) {
+            DirectJK jk(primary);
+            jk.set_print(0);
+            jk.set_cutoff(options.get_double("INTS_TOLERANCE") > 0.0 ? options.get_double("INTS_TOLERANCE") : 1.0E-12);
+            jk.set_memory((unsigned long int) (Process::environment.get_memory() / 8L));
+            jk.set_df_ints_num_threads(threads[ind]);
+            jk.set_accumulation(modes[mode]);
+            jk.initialize();
+            jk.C_left().clear();
+            jk.C_left().push_back(C);
+
+            double T = 0.0;
+            unsigned long int rounds = 0L;
+            Timer qq;
+            while (T < min_time || rounds == 0L) {
+                jk.compute();
+                T = qq.get();
+                rounds++;
+            }
+            timings[modes[mode]].push_back(T / (double) rounds);
+            jk.finalize();
+        }
+    }
+
+    outfile->Printf( "  %-8s", "Threads");
+    for (size_t mode = 0; mode < modes.size(); mode++) {
+        outfile->Printf( " %11s %7s", modes[mode].c_str(), "Speedup");
+    }
+    outfile->Printf( "\n");
+    for (size_t ind = 0; ind < threads.size(); ind++) {
+        outfile->Printf( "  %-8d", threads[ind]);
+        for (size_t mode = 0; mode < modes.size(); mode++) {
+            double t = timings[modes[mode]][ind];
+            outfile->Printf( " %11.3E %7.2f", t, timings[modes[mode]][0] / t);
+        }
+        outfile->Printf( "\n");
     }
+    outfile->Printf( "\n");
 }
 
 #if 0
@@ -76,6 +76,7 @@ void FastDFJK::common_init()
     domains_ = "DIATOMIC";
     bump_R0_ = 0.0;
     bump_R1_ = 0.0;
+    occ_cutoff_ = 1.0E-8;
 
 }
 void FastDFJK::print_header() const
@@ -103,6 +104,8 @@ void FastDFJK::print_header() const
             outfile->Printf( "    Bump R0:           %11.3E\n", bump_R0_);
             outfile->Printf( "    Bump R1:           %11.3E\n", bump_R1_);
         }
+        if (do_K_ || do_wK_)
+            outfile->Printf( "    Occupied Cutoff:   %11.0E\n", occ_cutoff_);
 
         outfile->Printf( "\n");
 
@@ -164,10 +167,10 @@ void FastDFJK::compute_JK()
         build_J(Z_,D_ao_,J_ao_);
     }
     if (do_K_) {
-        build_K(Z_,D_ao_,K_ao_);
+        build_K(Z_,C_left_ao_,C_right_ao_,K_ao_);
     }
     if (do_wK_) {
-        build_K(Z_LR_,D_ao_,wK_ao_);
+        build_K(Z_LR_,C_left_ao_,C_right_ao_,wK_ao_);
     }
 }
 void FastDFJK::postiterations()
@@ -767,10 +770,250 @@ void FastDFJK::build_J(boost::shared_ptr<Matrix> Z,
         }
     }
 }
-void FastDFJK::build_K(boost::shared_ptr<Matrix> /*Z*/,
-                       const std::vector<boost::shared_ptr<Matrix> >& /*D*/,
-                       const std::vector<boost::shared_ptr<Matrix> >& /*K*/)
+void FastDFJK::build_K(boost::shared_ptr<Matrix> Z,
+                       const std::vector<boost::shared_ptr<Matrix> >& Cl,
+                       const std::vector<boost::shared_ptr<Matrix> >& Cr,
+                       const std::vector<boost::shared_ptr<Matrix> >& K)
 {
-    throw PSIEXCEPTION("K: Not implemented yet");
+    // With the same local fits as J, (pr|qs) ~ C_pr^A Z_AB C_qs^B, so for each
+    // occupied orbital i
+    //
+    //   E_pA^i = C_pr^A C_ri,   K_pq += E_pA^i(left) Z_AB E_qB^i(right)
+    //
+    // Only the atom pairs with a significant C_ri on one of their atoms enter
+    // E^i, so E^i, Z and the K block are gathered onto the auxiliary atoms of
+    // those pairs' domains and the primary atoms of the pairs.
+
+    // => Sizing <= //
+
+    int natom = primary_->molecule()->natom();
+    int nso  = primary_->nbf();
+
+    std::vector<int> so_start(natom, 0), so_size(natom, 0);
+    std::vector<int> aux_start(natom, 0), aux_size(natom, 0);
+    for (int A = 0; A < natom; A++) {
+        int nP = primary_->nshell_on_center(A);
+        if (nP) so_start[A] = primary_->shell(primary_->shell_on_center(A,0)).function_index();
+        for (int P = 0; P < nP; P++) so_size[A] += primary_->shell(primary_->shell_on_center(A,P)).nfunction();
+        int nQ = auxiliary_->nshell_on_center(A);
+        if (nQ) aux_start[A] = auxiliary_->shell(auxiliary_->shell_on_center(A,0)).function_index();
+        for (int Q = 0; Q < nQ; Q++) aux_size[A] += auxiliary_->shell(auxiliary_->shell_on_center(A,Q)).nfunction();
+    }
+
+    // Atom pair tasks on each atom
+    std::vector<std::vector<int> > atom_tasks(natom);
+    for (size_t pair = 0L; pair < atom_pairs_.size(); pair++) {
+        atom_tasks[atom_pairs_[pair].first].push_back(pair);
+        if (atom_pairs_[pair].second != atom_pairs_[pair].first)
+            atom_tasks[atom_pairs_[pair].second].push_back(pair);
+    }
+
+    int nthread = 1;
+    #ifdef _OPENMP
+        nthread = omp_get_max_threads();
+    #endif
+
+    double** Zp = Z->pointer();
+
+    // => Temporaries <= //
+
+    std::vector<boost::shared_ptr<Matrix> > Kt;
+    for (int thread = 0; thread < nthread; thread++) {
+        Kt.push_back(boost::shared_ptr<Matrix>(new Matrix("K temp", nso, nso)));
+    }
+
+    size_t ntask_total = 0L;
+    size_t nrow_total = 0L;
+    size_t ncol_total = 0L;
+
+    // ==> Master Loop over K Tasks <= //
+
+    for (size_t ind = 0; ind < K.size(); ind++) {
+
+        bool lr_symmetric = (Cl[ind] == Cr[ind]);
+        int nocc = Cl[ind]->colspi()[0];
+        double** Clp = Cl[ind]->pointer();
+        double** Crp = Cr[ind]->pointer();
+
+        for (int thread = 0; thread < nthread; thread++) {
+            Kt[thread]->zero();
+        }
+
+        #pragma omp parallel num_threads(nthread) reduction(+: ntask_total, nrow_total, ncol_total)
+        {
+            int thread = 0;
+            #ifdef _OPENMP
+                thread = omp_get_thread_num();
+            #endif
+            double** Ktp = Kt[thread]->pointer();
+
+            std::vector<char> task_mask(atom_pairs_.size(), 0);
+            std::vector<int> tasks;
+            std::vector<int> row_off(natom, -1), col_off(natom, -1);
+            std::vector<int> row_atoms, col_atoms;
+            std::vector<double> El, Er, G, Zs, Ks;
+
+            #pragma omp for schedule(dynamic)
+            for (int i = 0; i < nocc; i++) {
+
+                // => Occupied screening: pairs with C_ri significant on either atom <= //
+
+                tasks.clear();
+                for (int A = 0; A < natom; A++) {
+                    double Cmax = 0.0;
+                    for (int r = so_start[A]; r < so_start[A] + so_size[A]; r++) {
+                        Cmax = std::max(Cmax, std::fabs(Clp[r][i]));
+                        Cmax = std::max(Cmax, std::fabs(Crp[r][i]));
+                    }
+                    if (Cmax < occ_cutoff_) continue;
+                    const std::vector<int>& atasks = atom_tasks[A];
+                    for (size_t t = 0; t < atasks.size(); t++) {
+                        if (!task_mask[atasks[t]]) {
+                            task_mask[atasks[t]] = 1;
+                            tasks.push_back(atasks[t]);
+                        }
+                    }
+                }
+                if (!tasks.size()) continue;
+
+                // => Local row (auxiliary) and column (primary) spaces <= //
+
+                int nrow = 0;
+                int ncol = 0;
+                row_atoms.clear();
+                col_atoms.clear();
+                for (size_t t = 0; t < tasks.size(); t++) {
+                    int pair = tasks[t];
+                    task_mask[pair] = 0;
+                    const std::vector<int>& auxiliary_atoms = auxiliary_atoms_[pair];
+                    for (size_t C = 0; C < auxiliary_atoms.size(); C++) {
+                        int C2 = auxiliary_atoms[C];
+                        if (row_off[C2] < 0) {
+                            row_off[C2] = nrow;
+                            nrow += aux_size[C2];
+                            row_atoms.push_back(C2);
+                        }
+                    }
+                    int AB[2] = { atom_pairs_[pair].first, atom_pairs_[pair].second };
+                    for (int k = 0; k < 2; k++) {
+                        if (col_off[AB[k]] < 0) {
+                            col_off[AB[k]] = ncol;
+                            ncol += so_size[AB[k]];
+                            col_atoms.push_back(AB[k]);
+                        }
+                    }
+                }
+                ntask_total += tasks.size();
+                nrow_total += nrow;
+                ncol_total += ncol;
+
+                // => E_Ap^i = C_pr^A C_ri <= //
+
+                El.assign((size_t) nrow * ncol, 0.0);
+                if (!lr_symmetric) Er.assign((size_t) nrow * ncol, 0.0);
+                double* Elp = &El[0];
+                double* Erp = (lr_symmetric ? Elp : &Er[0]);
+
+                for (size_t t = 0; t < tasks.size(); t++) {
+                    int pair = tasks[t];
+                    const std::vector<std::pair<int,int> >& shell_pairs = shell_pairs_[pair];
+                    const std::vector<int>& auxiliary_atoms = auxiliary_atoms_[pair];
+                    double** Bp = Bpq_[pair]->pointer();
+
+                    for (size_t C2 = 0, dA = 0; C2 < auxiliary_atoms.size(); C2++) {
+                        int C = auxiliary_atoms[C2];
+                        int nA = aux_size[C];
+                        for (int a = 0; a < nA; a++) {
+                            double* Brow = Bp[a + dA];
+                            double* Elrow = Elp + (size_t) (row_off[C] + a) * ncol;
+                            double* Errow = Erp + (size_t) (row_off[C] + a) * ncol;
+                            for (size_t PQ = 0, dPQ = 0; PQ < shell_pairs.size(); PQ++) {
+                                int P = shell_pairs[PQ].first;
+                                int Q = shell_pairs[PQ].second;
+                                int nP = primary_->shell(P).nfunction();
+                                int nQ = primary_->shell(Q).nfunction();
+                                int oP = primary_->shell(P).function_index();
+                                int oQ = primary_->shell(Q).function_index();
+                                int lP = col_off[primary_->shell(P).ncenter()] + oP - so_start[primary_->shell(P).ncenter()];
+                                int lQ = col_off[primary_->shell(Q).ncenter()] + oQ - so_start[primary_->shell(Q).ncenter()];
+                                for (int p = 0; p < nP; p++) {
+                                    double Clp_pi = Clp[p + oP][i];
+                                    double Crp_pi = Crp[p + oP][i];
+                                    double Elp_p = 0.0;
+                                    double Erp_p = 0.0;
+                                    for (int q = 0; q < nQ; q++) {
+                                        double B = Brow[p * nQ + q + dPQ];
+                                        Elp_p += B * Clp[q + oQ][i];
+                                        Erp_p += B * Crp[q + oQ][i];
+                                        if (P != Q) {
+                                            Elrow[q + lQ] += B * Clp_pi;
+                                            if (!lr_symmetric) Errow[q + lQ] += B * Crp_pi;
+                                        }
+                                    }
+                                    Elrow[p + lP] += Elp_p;
+                                    if (!lr_symmetric) Errow[p + lP] += Erp_p;
+                                }
+                                dPQ += nP * nQ;
+                            }
+                        }
+                        dA += nA;
+                    }
+                }
+
+                // => Gather Z onto the local auxiliary space <= //
+
+                Zs.resize((size_t) nrow * nrow);
+                for (size_t A2 = 0; A2 < row_atoms.size(); A2++) {
+                    int A = row_atoms[A2];
+                    for (int a = 0; a < aux_size[A]; a++) {
+                        double* Zrow = &Zs[(size_t) (row_off[A] + a) * nrow];
+                        for (size_t B2 = 0; B2 < row_atoms.size(); B2++) {
+                            int B = row_atoms[B2];
+                            ::memcpy(Zrow + row_off[B], &Zp[aux_start[A] + a][aux_start[B]], sizeof(double) * aux_size[B]);
+                        }
+                    }
+                }
+
+                // => K_pq = E_Ap Z_AB E_Bq <= //
+
+                G.resize((size_t) nrow * ncol);
+                Ks.resize((size_t) ncol * ncol);
+                C_DGEMM('N','N',nrow,ncol,nrow,1.0,&Zs[0],nrow,Erp,ncol,0.0,&G[0],ncol);
+                C_DGEMM('T','N',ncol,ncol,nrow,1.0,Elp,ncol,&G[0],ncol,0.0,&Ks[0],ncol);
+
+                for (size_t P2 = 0; P2 < col_atoms.size(); P2++) {
+                    int P = col_atoms[P2];
+                    for (int p = 0; p < so_size[P]; p++) {
+                        double* Krow = &Ks[(size_t) (col_off[P] + p) * ncol];
+                        double* Ktrow = Ktp[so_start[P] + p];
+                        for (size_t Q2 = 0; Q2 < col_atoms.size(); Q2++) {
+                            int Q = col_atoms[Q2];
+                            for (int q = 0; q < so_size[Q]; q++) {
+                                Ktrow[so_start[Q] + q] += Krow[col_off[Q] + q];
+                            }
+                        }
+                    }
+                }
+
+                for (size_t A2 = 0; A2 < row_atoms.size(); A2++) row_off[row_atoms[A2]] = -1;
+                for (size_t P2 = 0; P2 < col_atoms.size(); P2++) col_off[col_atoms[P2]] = -1;
+            }
+        }
+
+        K[ind]->copy(Kt[0]);
+        for (int thread = 1; thread < nthread; thread++) {
+            K[ind]->add(Kt[thread]);
+        }
+    }
+
+    if (bench_) {
+        size_t nocc_total = 0L;
+        for (size_t ind = 0; ind < K.size(); ind++) nocc_total += Cl[ind]->colspi()[0];
+        if (nocc_total) {
+            outfile->Printf("  FastDFJK K: %zu orbitals, %.1f of %zu atom pairs, %.1f auxiliary and %.1f primary functions per orbital\n",
+                nocc_total, ntask_total / (double) nocc_total, atom_pairs_.size(),
+                nrow_total / (double) nocc_total, ncol_total / (double) nocc_total);
+        }
+    }
 }
 }
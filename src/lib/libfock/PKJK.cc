@@ -20,15 +20,16 @@
  *@END LICENSE
  */
 #include <libmints/mints.h>
+#include <libmints/sointegral_twobody.h>
 #include <lib3index/3index.h>
 #include <libpsio/psio.hpp>
 #include <libpsio/psio.h>
 #include <libpsio/aiohandler.h>
+#include <libpsi4util/libpsi4util.h>
 #include <libqt/qt.h>
 #include <psi4-dec.h>
 #include <psifiles.h>
 #include <libmints/sieve.h>
-#include <libiwl/iwl.hpp>
 #include "jk.h"
 #include "jk_independent.h"
 #include "link.h"
@@ -39,6 +40,8 @@
 #include<lib3index/cholesky.h>
 
 #include <sstream>
+#include <algorithm>
+#include <limits>
 #include "libparallel/ParallelPrinter.h"
 #ifdef _OPENMP
 #include <omp.h>
@@ -49,6 +52,132 @@ using namespace psi;
 
 namespace psi {
 
+namespace {
+
+/// Records the largest integral of a shell quartet
+class PKMaxFunctor {
+    double max_;
+public:
+    PKMaxFunctor() : max_(0.0) {}
+    void operator()(int, int, int, int, int, int, int, int, int, int, int, int, double value)
+    {
+        if (std::fabs(value) > max_) max_ = std::fabs(value);
+    }
+    double max() const { return max_; }
+};
+
+/**
+ * Scatters the canonical SO integrals (pq|rs) handed out by TwoBodySOInt
+ * into one bucket of the J and K supermatrices, following the same sort
+ * the IWL-based build used.  j_block may be NULL when only exchange is
+ * wanted (wK).  Threads share the bucket, so every update is atomic.
+ */
+class PKBucketFunctor {
+    double* j_block_;
+    double* k_block_;
+    const size_t* pk_symoffset_;
+    size_t min_index_;
+    size_t max_index_;
+
+    void add(double* block, size_t braket, double value)
+    {
+        if ((braket >= min_index_) && (braket < max_index_)) {
+            #pragma omp atomic
+            block[braket - min_index_] += value;
+        }
+    }
+public:
+    PKBucketFunctor(double* j_block, double* k_block, const size_t* pk_symoffset,
+                    size_t min_index, size_t max_index) :
+        j_block_(j_block), k_block_(k_block), pk_symoffset_(pk_symoffset),
+        min_index_(min_index), max_index_(max_index) {}
+
+    void operator()(int, int, int, int, int psym, int prel, int qsym, int qrel,
+                    int rsym, int rrel, int ssym, int srel, double value)
+    {
+        size_t bra, ket;
+        if ((psym == qsym) && (rsym == ssym)) {
+            // J
+            if (j_block_) {
+                bra = INDEX2(prel, qrel);
+                ket = INDEX2(rrel, srel);
+                add(j_block_, INDEX2(bra + pk_symoffset_[psym], ket + pk_symoffset_[rsym]), value);
+            }
+
+            // K (2nd sort)
+            if ((prel != qrel) && (rrel != srel) && (psym == ssym) && (qsym == rsym)) {
+                bra = INDEX2(prel, srel);
+                ket = INDEX2(qrel, rrel);
+                add(k_block_, INDEX2(bra + pk_symoffset_[psym], ket + pk_symoffset_[qsym]),
+                    ((prel == srel) || (qrel == rrel)) ? value : 0.5 * value);
+            }
+        }
+
+        // K (1st sort)
+        if ((psym == rsym) && (qsym == ssym)) {
+            bra = INDEX2(prel, rrel);
+            ket = INDEX2(qrel, srel);
+            add(k_block_, INDEX2(bra + pk_symoffset_[psym], ket + pk_symoffset_[qsym]),
+                ((prel == rrel) || (qrel == srel)) ? value : 0.5 * value);
+        }
+    }
+};
+
+/**
+ * The unique SO shell quartets, their Schwarz bounds, and for each SO
+ * shell pair the range of PK pair indices it spans, so that the quartets
+ * that cannot reach a bucket are skipped when that bucket is built.
+ */
+struct PKQuartets {
+    int nshell;
+    std::vector<int> P, Q, R, S;
+    std::vector<double> schwarz;
+    std::vector<size_t> pair_min;
+    std::vector<size_t> pair_max;
+
+    /// Can the PK pairs of shell pairs AB and CD land in the pq rows [lo, hi)?
+    bool touches(int A, int B, int C, int D, size_t lo, size_t hi) const
+    {
+        size_t ab = A * nshell + B;
+        size_t cd = C * nshell + D;
+        if (pair_min[ab] > pair_max[ab] || pair_min[cd] > pair_max[cd]) return false;
+        // A bucket holds the rows of the larger pair index of each braket
+        size_t top_min = std::max(pair_min[ab], pair_min[cd]);
+        size_t top_max = std::max(pair_max[ab], pair_max[cd]);
+        return (top_min < hi) && (top_max >= lo);
+    }
+};
+
+/**
+ * Computes every quartet that can contribute to the pq rows [min_pq, max_pq)
+ * on nthread threads and sorts it into the bucket.  Returns the number of
+ * quartets computed.
+ */
+size_t build_bucket(const PKQuartets& quartets, boost::shared_ptr<TwoBodySOInt> eri, int nthread,
+                    double cutoff, size_t min_pq, size_t max_pq, PKBucketFunctor& functor)
+{
+    long int nquartet = quartets.P.size();
+    int nshell = quartets.nshell;
+    size_t computed = 0;
+
+    #pragma omp parallel for schedule(dynamic) num_threads(nthread) reduction(+: computed)
+    for (long int n = 0; n < nquartet; ++n) {
+        int P = quartets.P[n], Q = quartets.Q[n], R = quartets.R[n], S = quartets.S[n];
+        if (quartets.schwarz[P * nshell + Q] * quartets.schwarz[R * nshell + S] < cutoff)
+            continue;
+        if (!quartets.touches(P, Q, R, S, min_pq, max_pq) &&
+            !quartets.touches(P, R, Q, S, min_pq, max_pq) &&
+            !quartets.touches(P, S, Q, R, min_pq, max_pq))
+            continue;
+        PKBucketFunctor body(functor);
+        eri->compute_shell(P, Q, R, S, body);
+        computed++;
+    }
+
+    return computed;
+}
+
+}
 
 PKJK::PKJK(boost::shared_ptr<BasisSet> primary) :
     JK(primary)
@@ -63,6 +192,7 @@ PKJK::~PKJK()
 void PKJK::common_init()
 {
     pk_file_ = PSIF_SO_PK;
+    incore_ = false;
 }
 
 void PKJK::print_header() const
@@ -76,8 +206,8 @@ void PKJK::print_header() const
         if (do_wK_)
             outfile->Printf( "    Omega:             %11.3E\n", omega_);
         outfile->Printf( "    Memory (MB):       %11ld\n", (memory_ *8L) / (1024L * 1024L));
-        outfile->Printf( "    Schwarz Cutoff:    %11.0E\n\n", cutoff_);
-        //outfile->Printf( "    OpenMP threads:    %11d\n", omp_nthread_);
+        outfile->Printf( "    Schwarz Cutoff:    %11.0E\n", cutoff_);
+        outfile->Printf( "    OpenMP threads:    %11d\n\n", omp_nthread_);
     }
 }
 
@@ -85,42 +215,11 @@ void PKJK::preiterations()
 {
     psio_ = _default_psio_lib_;
 
-//    bool file_was_open = psio_->open_check(pk_file_);
-//    if(!file_was_open);
-        psio_->open(pk_file_, PSIO_OPEN_NEW);
-
-    // Start by generating conventional integrals on disk
-    boost::shared_ptr<MintsHelper> mints(new MintsHelper());
-    mints->integrals();
-    if(do_wK_)
-        mints->integrals_erf(omega_);
-    mints.reset();
-
-    int nso   = Process::environment.wavefunction()->nso();
     int *sopi = Process::environment.wavefunction()->nsopi();
     int nirreps = Process::environment.wavefunction()->nirrep();
 
-    so2symblk_ = new int[nso];
-    so2index_  = new int[nso];
-    size_t so_count = 0;
-    size_t offset = 0;
-    for (int h = 0; h < nirreps; ++h) {
-        for (int i = 0; i < sopi[h]; ++i) {
-            so2symblk_[so_count] = h;
-            so2index_[so_count] = so_count-offset;
-            ++so_count;
-        }
-        offset += sopi[h];
-    }
-
-    // The first SO in each irrep
-    int* orb_offset = new int[nirreps];
-    orb_offset[0] = 0;
-    for(int h = 1; h < nirreps; ++h)
-        orb_offset[h] = orb_offset[h-1] + sopi[h-1];
-
     // Compute PK symmetry mapping
-    int *pk_symoffset = new int[nirreps];
+    std::vector<size_t> pk_symoffset(nirreps);
     pk_size_ = 0;
     pk_pairs_ = 0;
     for(int h = 0; h < nirreps; ++h){
@@ -131,36 +230,16 @@ void PKJK::preiterations()
     // Compute the number of pairs in PK
     pk_size_ = INDEX2(pk_pairs_-1, pk_pairs_-1) + 1;
 
-    // Count the pairs
-    size_t npairs = 0;
-    size_t *pairpi = new size_t[nirreps];
-    ::memset(pairpi, '\0', nirreps*sizeof(size_t));
-    for(int pq_sym = 0; pq_sym < nirreps; ++pq_sym){
-        for(int p_sym = 0; p_sym < nirreps; ++p_sym){
-            int q_sym = pq_sym ^ p_sym;
-            if(p_sym >= q_sym){
-                for(int p = 0; p < sopi[p_sym]; ++p){
-                    for(int q = 0; q < sopi[q_sym]; ++q){
-                        int p_abs = p + orb_offset[p_sym];
-                        int q_abs = q + orb_offset[q_sym];
-                        if(p_abs >= q_abs){
-                            pairpi[pq_sym]++;
-                            npairs++;
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    // TODO figure out a better scheme.  For now, use half of the memory
-    // 32 comes from 2 (use only half the mem) * 8 (bytes per double)
-    size_t memory = memory_ / 16;
+    // Hold every bucket in core if J, K (and wK) fit in half of the memory,
+    // otherwise batch them to disk, using half of the memory per J/K pair
+    // of buckets: 16 comes from 2 (use only half the mem) * 2 (J and K)
+    int nbuckets = (do_wK_ ? 3 : 2);
+    incore_ = (nbuckets * pk_size_ <= memory_ / 2L);
+    size_t memory = (incore_ ? pk_size_ : memory_ / 16);
 
     int nbatches      = 0;
     size_t pq_incore  = 0;
     size_t pqrs_index = 0;
-    size_t totally_symmetric_pairs = pairpi[0];
     batch_pq_min_.clear();
     batch_pq_max_.clear();
     batch_index_min_.clear();
@@ -181,22 +260,90 @@ void PKJK::preiterations()
         pq_incore  += pq + 1;
         pqrs_index += pq + 1;
     }
-    batch_pq_max_.push_back(totally_symmetric_pairs);
+    batch_pq_max_.push_back(pk_pairs_);
     batch_index_max_.push_back(pk_size_);
     nbatches++;
 
-    for(int batch = 0; batch < nbatches; ++batch){
-        outfile->Printf("\tBatch %3d pq = [%8zu,%8zu] index = [%14zu,%zu]\n",
-                batch + 1,
-                batch_pq_min_[batch],batch_pq_max_[batch],
-                batch_index_min_[batch],batch_index_max_[batch]);
+    if (incore_) {
+        outfile->Printf("\tPK buckets held in core.\n");
+    } else {
+        for(int batch = 0; batch < nbatches; ++batch){
+            outfile->Printf("\tBatch %3d pq = [%8zu,%8zu] index = [%14zu,%zu]\n",
+                    batch + 1,
+                    batch_pq_min_[batch],batch_pq_max_[batch],
+                    batch_index_min_[batch],batch_index_max_[batch]);
+        }
     }
 
+    // The SO integrals are computed straight into the PK buckets,
+    // one threaded pass over the shell quartets per bucket
+    boost::shared_ptr<IntegralFactory> integral(new IntegralFactory(primary_, primary_, primary_, primary_));
+    boost::shared_ptr<SOBasisSet> sobasis(new SOBasisSet(primary_, integral));
+
+    std::vector<boost::shared_ptr<TwoBodyAOInt> > tb;
+    for (int thread = 0; thread < omp_nthread_; ++thread)
+        tb.push_back(boost::shared_ptr<TwoBodyAOInt>(integral->eri()));
+    boost::shared_ptr<TwoBodySOInt> eri(new TwoBodySOInt(tb, integral));
+
+    PKQuartets quartets;
+    int nshell = quartets.nshell = sobasis->nshell();
+    SOShellCombinationsIterator shellIter(sobasis, sobasis, sobasis, sobasis);
+    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) {
+        quartets.P.push_back(shellIter.p());
+        quartets.Q.push_back(shellIter.q());
+        quartets.R.push_back(shellIter.r());
+        quartets.S.push_back(shellIter.s());
+    }
 
-    // We might want to only build p in future...
-    bool build_k = true;
+    // The range of PK pairs spanned by each shell pair
+    quartets.pair_min.assign(nshell * nshell, std::numeric_limits<size_t>::max());
+    quartets.pair_max.assign(nshell * nshell, 0);
+    for (int P = 0; P < nshell; ++P) {
+        for (int Q = 0; Q < nshell; ++Q) {
+            for (int p = 0; p < sobasis->nfunction(P); ++p) {
+                int pfunc = sobasis->function(P) + p;
+                int psym = sobasis->irrep(pfunc);
+                int prel = sobasis->function_within_irrep(pfunc);
+                for (int q = 0; q < sobasis->nfunction(Q); ++q) {
+                    int qfunc = sobasis->function(Q) + q;
+                    if (sobasis->irrep(qfunc) != psym) continue;
+                    int qrel = sobasis->function_within_irrep(qfunc);
+                    size_t pair = pk_symoffset[psym] + INDEX2(prel, qrel);
+                    quartets.pair_min[P * nshell + Q] = std::min(quartets.pair_min[P * nshell + Q], pair);
+                    quartets.pair_max[P * nshell + Q] = std::max(quartets.pair_max[P * nshell + Q], pair);
+                }
+            }
+        }
+    }
+
+    // Schwarz bounds from the (PQ|PQ) quartets.  These also bound the
+    // erf-attenuated integrals, whose kernel is smaller and still positive
+    quartets.schwarz.assign(nshell * nshell, 0.0);
+    #pragma omp parallel for schedule(dynamic) num_threads(omp_nthread_)
+    for (int P = 0; P < nshell; ++P) {
+        for (int Q = 0; Q <= P; ++Q) {
+            PKMaxFunctor max;
+            eri->compute_shell(P, Q, P, Q, max);
+            quartets.schwarz[P * nshell + Q] = quartets.schwarz[Q * nshell + P] = std::sqrt(max.max());
+        }
+    }
+
+    boost::shared_ptr<TwoBodySOInt> erf;
+    if (do_wK_) {
+        std::vector<boost::shared_ptr<TwoBodyAOInt> > tb_erf;
+        for (int thread = 0; thread < omp_nthread_; ++thread)
+            tb_erf.push_back(boost::shared_ptr<TwoBodyAOInt>(integral->erf_eri(omega_)));
+        erf = boost::shared_ptr<TwoBodySOInt>(new TwoBodySOInt(tb_erf, integral));
+    }
+
+    if (!incore_)
+        psio_->open(pk_file_, PSIO_OPEN_NEW);
 
+    Timer build_timer;
+    size_t ncomputed = 0;
     for(int batch = 0; batch < nbatches; ++batch){
+        size_t min_pq      = batch_pq_min_[batch];
+        size_t max_pq      = batch_pq_max_[batch];
         size_t min_index   = batch_index_min_[batch];
         size_t max_index   = batch_index_max_[batch];
         size_t batch_size = max_index - min_index;
@@ -205,81 +352,31 @@ void PKJK::preiterations()
         ::memset(j_block, '\0', batch_size * sizeof(double));
         ::memset(k_block, '\0', batch_size * sizeof(double));
 
-        IWL *iwl = new IWL(psio_.get(), PSIF_SO_TEI, cutoff_, 1, 1);
-        Label *lblptr = iwl->labels();
-        Value *valptr = iwl->values();
-        int labelIndex, pabs, qabs, rabs, sabs, prel, qrel, rrel, srel, psym, qsym, rsym, ssym;
-        size_t bra, ket, braket;
-        double value;
-        bool last_buffer;
-        do{
-            last_buffer = iwl->last_buffer();
-            for(int index = 0; index < iwl->buffer_count(); ++index){
-                labelIndex = 4*index;
-                pabs  = abs((int) lblptr[labelIndex++]);
-                qabs  = (int) lblptr[labelIndex++];
-                rabs  = (int) lblptr[labelIndex++];
-                sabs  = (int) lblptr[labelIndex++];
-                prel  = so2index_[pabs];
-                qrel  = so2index_[qabs];
-                rrel  = so2index_[rabs];
-                srel  = so2index_[sabs];
-                psym  = so2symblk_[pabs];
-                qsym  = so2symblk_[qabs];
-                rsym  = so2symblk_[rabs];
-                ssym  = so2symblk_[sabs];
-                value = (double) valptr[index];
-
-                // J
-                if ((psym == qsym) && (rsym == ssym)) {
-                    bra = INDEX2(prel, qrel);
-                    ket = INDEX2(rrel, srel);
-                    // pk_symoffset_ corrects for the symmetry offset in the pk_ vector
-                    braket = INDEX2(bra + pk_symoffset[psym], ket + pk_symoffset[rsym]);
-                    if((braket >= min_index) && (braket < max_index)){
-                        j_block[braket - min_index] += value;
-                    }
+        PKBucketFunctor jk_functor(j_block, k_block, &pk_symoffset[0], min_index, max_index);
+        ncomputed += build_bucket(quartets, eri, omp_nthread_, cutoff_, min_pq, max_pq, jk_functor);
 
-                    // K (2nd sort)
-                    if (build_k && (prel != qrel) && (rrel != srel)) {
-                        if ((psym == ssym) && (qsym == rsym)) {
-                            bra = INDEX2(prel, srel);
-                            ket = INDEX2(qrel, rrel);
-                            braket = INDEX2(bra + pk_symoffset[psym], ket + pk_symoffset[qsym]);
-                            if((braket >= min_index) && (braket < max_index)){
-                                if ((prel == srel) || (qrel == rrel)) {
-                                    k_block[braket - min_index] += value;
-                                } else {
-                                    k_block[braket - min_index] += 0.5 * value;
-                                }
-                            }
-                        }
-                    }
-                }
-
-                // K (1st sort)
-                if (build_k && (psym == rsym) && (qsym == ssym)) {
-                    bra = INDEX2(prel, rrel);
-                    ket = INDEX2(qrel, srel);
-                    braket = INDEX2(bra + pk_symoffset[psym], ket + pk_symoffset[qsym]);
-                    if((braket >= min_index) && (braket < max_index)){
-                        if ((prel == rrel) || (qrel == srel)) {
-                            k_block[braket - min_index] += value;
-                        } else {
-                            k_block[braket - min_index] += 0.5 * value;
-                        }
-                    }
-                }
-            }
-            if (!last_buffer) iwl->fetch();
-        } while (!last_buffer);
-        delete iwl;
+        double *wk_block = NULL;
+        if (do_wK_) {
+            // For omega, we only need exchange, computed with the same batching
+            wk_block = new double[batch_size];
+            ::memset(wk_block, '\0', batch_size * sizeof(double));
+            PKBucketFunctor wk_functor(NULL, wk_block, &pk_symoffset[0], min_index, max_index);
+            ncomputed += build_bucket(quartets, erf, omp_nthread_, cutoff_, min_pq, max_pq, wk_functor);
+        }
 
         // Halve the diagonal elements held in core
-        for(size_t pq = batch_pq_min_[batch]; pq < batch_pq_max_[batch]; ++pq){
+        for(size_t pq = min_pq; pq < max_pq; ++pq){
             size_t address = INDEX2(pq, pq) - min_index;
             j_block[address] *= 0.5;
             k_block[address] *= 0.5;
+            if (wk_block) wk_block[address] *= 0.5;
+        }
+
+        if (incore_) {
+            J_buckets_.push_back(j_block);
+            K_buckets_.push_back(k_block);
+            if (wk_block) wK_buckets_.push_back(wk_block);
+            continue;
         }
 
         char *label = new char[100];
@@ -287,144 +384,54 @@ void PKJK::preiterations()
         psio_->write_entry(pk_file_, label, (char*) j_block, batch_size * sizeof(double));
         sprintf(label, "K Block (Batch %d)", batch);
         psio_->write_entry(pk_file_, label, (char*) k_block, batch_size * sizeof(double));
+        if (wk_block) {
+            sprintf(label, "wK Block (Batch %d)", batch);
+            psio_->write_entry(pk_file_, label, (char*) wk_block, batch_size * sizeof(double));
+        }
         delete [] label;
 
         delete [] j_block;
         delete [] k_block;
+        delete [] wk_block;
     } // End of loop over batches
 
-    /*
-     * For omega, we only need exchange and it's done separately from conventional terms, so we can
-     * use fewer batches in principle.  For now we just use the batching scheme that's already been
-     * computed for the conventional J/K combo, above
-     */
-    if(do_wK_){
-        for(int batch = 0; batch < nbatches; ++batch){
-            size_t min_index   = batch_index_min_[batch];
-            size_t max_index   = batch_index_max_[batch];
-            size_t batch_size = max_index - min_index;
-            double *wk_block = new double[batch_size];
-            ::memset(wk_block, '\0', batch_size * sizeof(double));
-
-            IWL *iwl = new IWL(psio_.get(), PSIF_SO_ERF_TEI, cutoff_, 1, 1);
-            Label *lblptr = iwl->labels();
-            Value *valptr = iwl->values();
-            int labelIndex, pabs, qabs, rabs, sabs, prel, qrel, rrel, srel, psym, qsym, rsym, ssym;
-            size_t bra, ket, braket;
-            double value;
-            bool last_buffer;
-            do{
-                last_buffer = iwl->last_buffer();
-                for(int index = 0; index < iwl->buffer_count(); ++index){
-                    labelIndex = 4*index;
-                    pabs  = abs((int) lblptr[labelIndex++]);
-                    qabs  = (int) lblptr[labelIndex++];
-                    rabs  = (int) lblptr[labelIndex++];
-                    sabs  = (int) lblptr[labelIndex++];
-                    prel  = so2index_[pabs];
-                    qrel  = so2index_[qabs];
-                    rrel  = so2index_[rabs];
-                    srel  = so2index_[sabs];
-                    psym  = so2symblk_[pabs];
-                    qsym  = so2symblk_[qabs];
-                    rsym  = so2symblk_[rabs];
-                    ssym  = so2symblk_[sabs];
-                    value = (double) valptr[index];
-
-                    if ((psym == qsym) && (rsym == ssym)) {
-                        // K (2nd sort)
-                        if (build_k && (prel != qrel) && (rrel != srel)) {
-                            if ((psym == ssym) && (qsym == rsym)) {
-                                bra = INDEX2(prel, srel);
-                                ket = INDEX2(qrel, rrel);
-                                braket = INDEX2(bra + pk_symoffset[psym], ket + pk_symoffset[qsym]);
-                                if((braket >= min_index) && (braket < max_index)){
-                                    if ((prel == srel) || (qrel == rrel)) {
-                                        wk_block[braket - min_index] += value;
-                                    } else {
-                                        wk_block[braket - min_index] += 0.5 * value;
-                                    }
-                                }
-                            }
-                        }
-                    }
-
-                    // K (1st sort)
-                    if (build_k && (psym == rsym) && (qsym == ssym)) {
-                        bra = INDEX2(prel, rrel);
-                        ket = INDEX2(qrel, srel);
-                        braket = INDEX2(bra + pk_symoffset[psym], ket + pk_symoffset[qsym]);
-                        if((braket >= min_index) && (braket < max_index)){
-                            if ((prel == rrel) || (qrel == srel)) {
-                                wk_block[braket - min_index] += value;
-                            } else {
-                                wk_block[braket - min_index] += 0.5 * value;
-                            }
-                        }
-                    }
-                }
-                if (!last_buffer) iwl->fetch();
-            } while (!last_buffer);
-            delete iwl;
-
-            // Halve the diagonal elements held in core
-            for(size_t pq = batch_pq_min_[batch]; pq < batch_pq_max_[batch]; ++pq){
-                size_t address = INDEX2(pq, pq) - min_index;
-                wk_block[address] *= 0.5;
-            }
-
-            char *label = new char[100];
-            sprintf(label, "wK Block (Batch %d)", batch);
-            psio_->write_entry(pk_file_, label, (char*) wk_block, batch_size * sizeof(double));
-            delete [] label;
-
-            delete [] wk_block;
-        } // End of loop over batches
+    if (bench_) {
+        outfile->Printf("  PKJK: %d bucket(s) %s, %zu of %zu shell quartets computed in %8.3f s\n",
+            nbatches, (incore_ ? "in core" : "on disk"), ncomputed,
+            (size_t) quartets.P.size() * nbatches * (do_wK_ ? 2 : 1), build_timer.get());
     }
 
-    delete [] orb_offset;
-
-//    if(!file_was_open);
+    if (!incore_)
         psio_->close(pk_file_, 1);
-
 }
 
-void PKJK::compute_JK()
+void PKJK::contract_buckets(const std::string& type, const std::vector<double*>& buckets,
+                            std::vector<SharedMatrix>& JK)
 {
     int nirreps = Process::environment.wavefunction()->nirrep();
     int *sopi   = Process::environment.wavefunction()->nsopi();
-
-//    bool file_was_open = psio_->open_check(pk_file_);
-//    if(!file_was_open);
-        psio_->open(pk_file_, PSIO_OPEN_OLD);
-
-
     int nbatches = batch_pq_min_.size();
-    std::vector<double*> J_vectors;
-    std::vector<double*> K_vectors;
-    std::vector<double*> D_vectors;
-
-    /*
-     * The J terms
-     */
-    for(size_t N = 0; N < J_.size(); ++N){
+    int nvectors = JK.size();
+
+    // Each thread scatters the rs contributions into its own copy of the result
+    std::vector<std::vector<double> > JK_vectors(nvectors);
+    std::vector<std::vector<double> > D_vectors(nvectors);
+    std::vector<std::vector<std::vector<double> > > JK_thread(omp_nthread_,
+        std::vector<std::vector<double> >(nvectors, std::vector<double>(pk_pairs_, 0.0)));
+    for(int N = 0; N < nvectors; ++N){
         if(D_[N]->symmetry())
             throw PSIEXCEPTION("PK integrals cannot be used for this type of calculation.");
-        double *J_vector = new double[pk_pairs_];
-        ::memset(J_vector,  0, pk_pairs_ * sizeof(double));
-        J_vectors.push_back(J_vector);
-        double *D_vector = new double[pk_pairs_];
-        ::memset(D_vector,  0, pk_pairs_ * sizeof(double));
-        D_vectors.push_back(D_vector);
+        JK_vectors[N].assign(pk_pairs_, 0.0);
+        D_vectors[N].assign(pk_pairs_, 0.0);
         // The off-diagonal terms need to be doubled here
         size_t pqval = 0;
         for (int h = 0; h < nirreps; ++h) {
             for (int p = 0; p < sopi[h]; ++p) {
                 for (int q = 0; q <= p; ++q) {
                     if (p != q) {
-                        D_vector[pqval] = 2.0 * D_[N]->get(h, p, q);
+                        D_vectors[N][pqval] = 2.0 * D_[N]->get(h, p, q);
                     }else{
-                        D_vector[pqval] = D_[N]->get(h, p, q);
+                        D_vectors[N][pqval] = D_[N]->get(h, p, q);
                     }
                     ++pqval;
                 }
@@ -432,229 +439,98 @@ void PKJK::compute_JK()
         }
     }
 
-    if(J_.size()){
-        for(int batch = 0; batch < nbatches; ++batch){
-            size_t min_pq      = batch_pq_min_[batch];
-            size_t max_pq      = batch_pq_max_[batch];
-            size_t min_index   = batch_index_min_[batch];
-            size_t max_index   = batch_index_max_[batch];
-            size_t batch_size = max_index - min_index;
-            double *j_block = new double[batch_size];
-
-            char *label = new char[100];
-            sprintf(label, "J Block (Batch %d)", batch);
-            psio_->read_entry(pk_file_, label, (char*) j_block, batch_size * sizeof(double));
-
-            int nvectors = J_.size();
-            for(int N = 0; N < nvectors; ++N){
-                double *D_vector = D_vectors[N];
-                double *J_vector = J_vectors[N];
-                double *j_ptr = j_block;
-                for (size_t pq = min_pq; pq < max_pq; ++pq) {
-                    double D_pq = D_vector[pq];
-                    double *D_rs = D_vector;
-                    double J_pq = 0.0;
-                    double *J_rs = J_vector;
-                    for (size_t rs = 0; rs <= pq; ++rs) {
-                        J_pq  += *j_ptr * (*D_rs);
-                        *J_rs += *j_ptr * D_pq;
-                        ++D_rs;
-                        ++J_rs;
-                        ++j_ptr;
-                    }
-                    J_vector[pq] += J_pq;
-                }
-            }
-            delete[] label;
-            delete[] j_block;
-        }
+    double *block = NULL;
+    if (!incore_) {
+        size_t max_size = 0;
+        for (int batch = 0; batch < nbatches; ++batch)
+            max_size = std::max(max_size, batch_index_max_[batch] - batch_index_min_[batch]);
+        block = new double[max_size];
     }
 
-    for(size_t N = 0; N < J_.size(); ++N){
-        // Copy the results from the vector to the buffer
-        double *J = J_vectors[N];
-        for (int h = 0; h < nirreps; ++h) {
-            for (int p = 0; p < sopi[h]; ++p) {
-                for (int q = 0; q <= p; ++q) {
-                    J_[N]->set(h, p, q, *J++);
-                }
-            }
-        }
-        J_[N]->copy_lower_to_upper();
-        delete [] D_vectors[N];
-        delete [] J_vectors[N];
-    }
-
-    /*
-     * The K terms
-     */
-    D_vectors.clear();
-    for(size_t N = 0; N < K_.size(); ++N){
-        double *K_vector = new double[pk_pairs_];
-        ::memset(K_vector,  0, pk_pairs_ * sizeof(double));
-        K_vectors.push_back(K_vector);
-        double *D_vector = new double[pk_pairs_];
-        ::memset(D_vector,  0, pk_pairs_ * sizeof(double));
-        D_vectors.push_back(D_vector);
-        // The off-diagonal terms need to be doubled here
-        size_t pqval = 0;
-        for (int h = 0; h < nirreps; ++h) {
-            for (int p = 0; p < sopi[h]; ++p) {
-                for (int q = 0; q <= p; ++q) {
-                    if (p != q) {
-                        D_vector[pqval] = 2.0 * D_[N]->get(h, p, q);
-                    }else{
-                        D_vector[pqval] = D_[N]->get(h, p, q);
-                    }
-                    ++pqval;
-                }
-            }
-        }
-    }
-
-    if(K_.size()){
-        for(int batch = 0; batch < nbatches; ++batch){
-            size_t min_pq      = batch_pq_min_[batch];
-            size_t max_pq      = batch_pq_max_[batch];
-            size_t min_index   = batch_index_min_[batch];
-            size_t max_index   = batch_index_max_[batch];
-            size_t batch_size = max_index - min_index;
-            double *k_block = new double[batch_size];
+    for(int batch = 0; batch < nbatches; ++batch){
+        size_t min_pq      = batch_pq_min_[batch];
+        size_t max_pq      = batch_pq_max_[batch];
+        size_t min_index   = batch_index_min_[batch];
+        size_t max_index   = batch_index_max_[batch];
+        size_t batch_size = max_index - min_index;
+        double *jk_block;
 
+        if (incore_) {
+            jk_block = buckets[batch];
+        } else {
             char *label = new char[100];
-            sprintf(label, "K Block (Batch %d)", batch);
-            psio_->read_entry(pk_file_, label, (char*) k_block, batch_size * sizeof(double));
-
-            int nvectors = K_.size();
-            for(int N = 0; N < nvectors; ++N){
-                double *D_vector = D_vectors[N];
-                double *K_vector = K_vectors[N];
-                double *k_ptr = k_block;
-                for (size_t pq = min_pq; pq < max_pq; ++pq) {
-                    double D_pq = D_vector[pq];
-                    double *D_rs = D_vector;
-                    double K_pq = 0.0;
-                    double *K_rs = K_vector;
-                    for (size_t rs = 0; rs <= pq; ++rs) {
-                        K_pq  += *k_ptr * (*D_rs);
-                        *K_rs += *k_ptr * D_pq;
-                        ++D_rs;
-                        ++K_rs;
-                        ++k_ptr;
-                    }
-                    K_vector[pq] += K_pq;
-                }
-            }
+            sprintf(label, "%s Block (Batch %d)", type.c_str(), batch);
+            psio_->read_entry(pk_file_, label, (char*) block, batch_size * sizeof(double));
             delete[] label;
-            delete[] k_block;
+            jk_block = block;
         }
-    }
 
-    for(size_t N = 0; N < K_.size(); ++N){
-        // Copy the results from the vector to the buffer
-        double *K = K_vectors[N];
-        for (int h = 0; h < nirreps; ++h) {
-            for (int p = 0; p < sopi[h]; ++p) {
-                for (int q = 0; q <= p; ++q) {
-                    K_[N]->set(h, p, q, *K++);
+        // Rows get longer with pq, so hand them out dynamically
+        #pragma omp parallel for schedule(dynamic, 16) num_threads(omp_nthread_)
+        for (long int pq = min_pq; pq < (long int) max_pq; ++pq) {
+            int thread = 0;
+            #ifdef _OPENMP
+                thread = omp_get_thread_num();
+            #endif
+            const double *row = jk_block + INDEX2(pq, 0) - min_index;
+            for(int N = 0; N < nvectors; ++N){
+                const double *D_rs = &D_vectors[N][0];
+                double D_pq = D_rs[pq];
+                double *JK_rs = &JK_thread[thread][N][0];
+                double JK_pq = 0.0;
+                for (long int rs = 0; rs <= pq; ++rs) {
+                    JK_pq     += row[rs] * D_rs[rs];
+                    JK_rs[rs] += row[rs] * D_pq;
                 }
+                JK_vectors[N][pq] += JK_pq;
             }
         }
-        K_[N]->copy_lower_to_upper();
-        delete [] D_vectors[N];
-        delete [] K_vectors[N];
     }
+    delete[] block;
 
-    /*
-     * The wK terms
-     */
-    std::vector<double*> wK_vectors;
-    D_vectors.clear();
-    for(size_t N = 0; N < wK_.size(); ++N){
-        double *K_vector = new double[pk_pairs_];
-        ::memset(K_vector,  0, pk_pairs_ * sizeof(double));
-        wK_vectors.push_back(K_vector);
-        double *D_vector = new double[pk_pairs_];
-        ::memset(D_vector,  0, pk_pairs_ * sizeof(double));
-        D_vectors.push_back(D_vector);
-        // The off-diagonal terms need to be doubled here
-        size_t pqval = 0;
+    for(int N = 0; N < nvectors; ++N){
+        // Reduce the thread contributions and copy the result to the matrix
+        double *result = &JK_vectors[N][0];
+        for (int thread = 0; thread < omp_nthread_; ++thread)
+            C_DAXPY(pk_pairs_, 1.0, &JK_thread[thread][N][0], 1, result, 1);
         for (int h = 0; h < nirreps; ++h) {
             for (int p = 0; p < sopi[h]; ++p) {
                 for (int q = 0; q <= p; ++q) {
-                    if (p != q) {
-                        D_vector[pqval] = 2.0 * D_[N]->get(h, p, q);
-                    }else{
-                        D_vector[pqval] = D_[N]->get(h, p, q);
-                    }
-                    ++pqval;
-                }
-            }
-        }
-    }
-
-    if(wK_.size()){
-        for(int batch = 0; batch < nbatches; ++batch){
-            size_t min_pq      = batch_pq_min_[batch];
-            size_t max_pq      = batch_pq_max_[batch];
-            size_t min_index   = batch_index_min_[batch];
-            size_t max_index   = batch_index_max_[batch];
-            size_t batch_size = max_index - min_index;
-            double *k_block = new double[batch_size];
-
-            char *label = new char[100];
-            sprintf(label, "wK Block (Batch %d)", batch);
-            psio_->read_entry(pk_file_, label, (char*) k_block, batch_size * sizeof(double));
-
-            int nvectors = wK_.size();
-            for(int N = 0; N < nvectors; ++N){
-                double *D_vector = D_vectors[N];
-                double *K_vector = wK_vectors[N];
-                double *k_ptr = k_block;
-                for (size_t pq = min_pq; pq < max_pq; ++pq) {
-                    double D_pq = D_vector[pq];
-                    double *D_rs = D_vector;
-                    double K_pq = 0.0;
-                    double *K_rs = K_vector;
-                    for (size_t rs = 0; rs <= pq; ++rs) {
-                        K_pq  += *k_ptr * (*D_rs);
-                        *K_rs += *k_ptr * D_pq;
-                        ++D_rs;
-                        ++K_rs;
-                        ++k_ptr;
-                    }
-                    K_vector[pq] += K_pq;
+                    JK[N]->set(h, p, q, *result++);
                 }
             }
-            delete[] label;
-            delete[] k_block;
         }
+        JK[N]->copy_lower_to_upper();
     }
+}
 
-    for(size_t N = 0; N < wK_.size(); ++N){
-        // Copy the results from the vector to the buffer
-        double *K = wK_vectors[N];
-        for (int h = 0; h < nirreps; ++h) {
-            for (int p = 0; p < sopi[h]; ++p) {
-                for (int q = 0; q <= p; ++q) {
-                    wK_[N]->set(h, p, q, *K++);
-                }
-            }
-        }
-        wK_[N]->copy_lower_to_upper();
+void PKJK::compute_JK()
+{
+    if (!incore_)
+        psio_->open(pk_file_, PSIO_OPEN_OLD);
 
-        delete [] D_vectors[N];
-        delete [] wK_vectors[N];
-    }
+    if (J_.size())
+        contract_buckets("J", J_buckets_, J_);
+    if (K_.size())
+        contract_buckets("K", K_buckets_, K_);
+    if (wK_.size())
+        contract_buckets("wK", wK_buckets_, wK_);
 
-//    if(!file_was_open);
+    if (!incore_)
         psio_->close(pk_file_, 1);
 }
 
 
 void PKJK::postiterations()
 {
-    delete[] so2symblk_;
-    delete[] so2index_;
+    for (size_t batch = 0; batch < J_buckets_.size(); ++batch)
+        delete[] J_buckets_[batch];
+    for (size_t batch = 0; batch < K_buckets_.size(); ++batch)
+        delete[] K_buckets_[batch];
+    for (size_t batch = 0; batch < wK_buckets_.size(); ++batch)
+        delete[] wK_buckets_[batch];
+    J_buckets_.clear();
+    K_buckets_.clear();
+    wK_buckets_.clear();
 }
 }
@@ -99,9 +99,8 @@ void RBase::common_init()
         C_DCOPY(nso*nmo, vectors[0], 1, C->pointer()[0], 1);
         C_DCOPY(nmo, orbital_energies, 1, epsilon->pointer(), 1);
 
-        free(orbital_energies);
-        free(vectors[0]);
-        free(vectors);
+        Chkpt::free(orbital_energies);
+        free_block(vectors);
 
         // Hack on a hack
         psio_->close(32,1);
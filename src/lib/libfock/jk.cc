@@ -141,6 +141,8 @@ boost::shared_ptr<JK> JK::build_JK()
             jk->set_df_bump_R0(options.get_double("DF_BUMP_R0"));
         if (options["DF_BUMP_R1"].has_changed())
             jk->set_df_bump_R1(options.get_double("DF_BUMP_R1"));
+        if (options["DF_OCC_CUTOFF"].has_changed())
+            jk->set_occ_cutoff(options.get_double("DF_OCC_CUTOFF"));
 
         return boost::shared_ptr<JK>(jk);
 
@@ -154,6 +156,8 @@ boost::shared_ptr<JK> JK::build_JK()
             jk->set_print(options.get_int("PRINT"));
         if (options["DEBUG"].has_changed())
             jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed())
+            jk->set_bench(options.get_int("BENCH"));
 
         return boost::shared_ptr<JK>(jk);
 
@@ -190,6 +194,12 @@ boost::shared_ptr<JK> JK::build_JK()
             jk->set_bench(options.get_int("BENCH"));
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options["DIRECT_JK_ACCUMULATION"].has_changed())
+            jk->set_accumulation(options.get_str("DIRECT_JK_ACCUMULATION"));
+        if (options["DIRECT_JK_SCHEDULER"].has_changed())
+            jk->set_scheduler(options.get_str("DIRECT_JK_SCHEDULER"));
+        if (options["INCFOCK_FULL_FOCK_EVERY"].has_changed())
+            jk->set_incfock_full_fock_every(options.get_int("INCFOCK_FULL_FOCK_EVERY"));
 
         return boost::shared_ptr<JK>(jk);
 
@@ -250,6 +260,7 @@ void JK::common_init()
     do_K_ = true;
     do_wK_ = false;
     lr_symmetric_ = false;
+    incfock_ = false;
     omega_ = 0.0;
 
     boost::shared_ptr<IntegralFactory> integral(new IntegralFactory(primary_,primary_,primary_,primary_));
@@ -23,6 +23,7 @@
 #ifndef JK_H
 #define JK_H
 
+#include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
 #include <libmints/typedefs.h>
@@ -248,6 +249,9 @@ protected:
     /// Left-right symmetric? Determined in each call of compute()
     bool lr_symmetric_;
 
+    /// Build J/K incrementally from the change in D? Defaults to false
+    bool incfock_;
+
     // => Architecture-Level State Variables (Spatial Symmetry) <= //
 
     /// Pseudo-occupied C matrices, left side
@@ -411,6 +415,17 @@ public:
     * @param omega range-separation parameter
     */
     void set_omega(double omega) { omega_ = omega; }
+    /**
+    * Set to build J/K incrementally from the change in the
+    * density since the last incremental call of compute(), adding
+    * the result to the previous J/K. Only meaningful for a
+    * sequence of densities (SCF iterations), so it may be toggled
+    * around individual compute() calls. Algorithms that do not
+    * support this ignore the flag (currently only DirectJK uses it)
+    * @param incfock do incremental builds or not,
+    *        defaults to false
+    */
+    void set_incfock(bool incfock) { incfock_ = incfock; }
 
     // => Computers <= //
 
@@ -563,11 +578,6 @@ class PKJK : public JK {
     /// The PSIO instance to use for I/O
     boost::shared_ptr<PSIO> psio_;
 
-    /// Absolute AO index to relative SO index
-    int* so2index_;
-    /// Absolute AO index to irrep
-    int* so2symblk_;
-
     /// The pk file to use for storing the pk batches
     int pk_file_;
 
@@ -585,6 +595,13 @@ class PKJK : public JK {
     /// The index of the last integral in each batch
     std::vector<size_t> batch_index_max_;
 
+    /// Are the PK buckets held in core rather than in pk_file_?
+    bool incore_;
+    /// In-core J, K, and wK buckets, one per batch
+    std::vector<double*> J_buckets_;
+    std::vector<double*> K_buckets_;
+    std::vector<double*> wK_buckets_;
+
     /// Do we need to backtransform to C1 under the hood?
     virtual bool C1() const { return false; }
     /// Setup integrals, files, etc
@@ -596,6 +613,9 @@ class PKJK : public JK {
 
     /// Common initialization
     void common_init();
+    /// Contract the PK buckets named type ("J", "K" or "wK") with D_ into JK
+    void contract_buckets(const std::string& type, const std::vector<double*>& buckets,
+                          std::vector<SharedMatrix>& JK);
 
 public:
     // => Constructors < = //
@@ -638,9 +658,40 @@ protected:
 
     /// Number of threads for DF integrals TODO: DF_INTS_NUM_THREADS
     int df_ints_num_threads_;
+    /// How J/K contributions are accumulated across threads: AUTO, ATOMIC, PRIVATE, or BLOCKED
+    std::string accumulation_;
+    /// How shell quartets are handed out to threads: SORTED or TASK
+    std::string scheduler_;
     /// ERI Sieve
     boost::shared_ptr<ERISieve> sieve_;
 
+    // => Sorted Scheduler <= //
+
+    /// Significant shell pairs (P >= Q), grouped by angular momentum
+    /// class, by decreasing Schwarz bound within each class
+    std::vector<std::pair<int,int> > sorted_pairs_;
+    /// Start of each angular momentum class in sorted_pairs_, and the end
+    std::vector<int> class_starts_;
+
+    // => Incremental Fock Build <= //
+
+    /// Number of builds between full (non-incremental) rebuilds
+    int incfock_full_fock_every_;
+    /// Number of incremental builds since the last full rebuild
+    int incfock_count_;
+    /// Shell quartets computed in the last build
+    size_t computed_shells_;
+    /// AO densities of the last incremental-mode build
+    std::vector<SharedMatrix> D_prev_;
+    /// AO J matrices of the last incremental-mode build
+    std::vector<SharedMatrix> J_prev_;
+    /// AO K matrices of the last incremental-mode build
+    std::vector<SharedMatrix> K_prev_;
+    /// AO wK matrices of the last incremental-mode build
+    std::vector<SharedMatrix> wK_prev_;
+    /// AO density differences D - D_prev for the current build
+    std::vector<SharedMatrix> delta_D_;
+
     // => Required Algorithm-Specific Methods <= //
 
     /// Do we need to backtransform to C1 under the hood?
@@ -657,6 +708,29 @@ protected:
         std::vector<boost::shared_ptr<Matrix> >& D,
         std::vector<boost::shared_ptr<Matrix> >& J,
         std::vector<boost::shared_ptr<Matrix> >& K);
+    /// build_JK over atom-blocked pairs of shell-pair tasks
+    void build_JK_task(std::vector<boost::shared_ptr<TwoBodyAOInt> >& ints,
+        std::vector<boost::shared_ptr<Matrix> >& D,
+        std::vector<boost::shared_ptr<Matrix> >& J,
+        std::vector<boost::shared_ptr<Matrix> >& K);
+    /// build_JK over same-class batches of the sorted shell pairs
+    void build_JK_sorted(std::vector<boost::shared_ptr<TwoBodyAOInt> >& ints,
+        std::vector<boost::shared_ptr<Matrix> >& D,
+        std::vector<boost::shared_ptr<Matrix> >& J,
+        std::vector<boost::shared_ptr<Matrix> >& K);
+    /// Build sorted_pairs_ and class_starts_ from the sieve
+    void sort_shell_pairs();
+    /// max |D_mn| over each shell pair (both orderings, all densities)
+    void shell_max_density(const std::vector<SharedMatrix>& D, std::vector<double>& Dshell) const;
+    /// The accumulation mode to use for nD densities, resolving AUTO
+    std::string accumulation_mode(size_t nD) const;
+
+    /// Decide if this build is incremental, forming delta_D_ if so
+    bool incfock_setup();
+    /// Add the previous J/K to an incremental build and save the current D/J/K
+    void incfock_postiter(bool incremental);
+    /// Discard the saved D/J/K, the next incremental-mode build is a full one
+    void incfock_reset();
 
     /// Common initialization
     void common_init();
@@ -682,6 +756,27 @@ public:
      * @param val a positive integer
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
+    /**
+     * How to accumulate J/K contributions across threads
+     * @param val PRIVATE (per-thread J/K copies, reduced at the end),
+     *        BLOCKED (locked blocks of rows), ATOMIC (per-element
+     *        atomics), or AUTO (PRIVATE if the copies fit in memory,
+     *        else BLOCKED)
+     */
+    void set_accumulation(const std::string& val) { accumulation_ = val; }
+    /**
+     * How to hand out shell quartets to threads
+     * @param val SORTED (same-class batches of shell pairs sorted
+     *        by angular momentum and Schwarz bound, with density
+     *        screening) or TASK (atom-blocked pairs of pairs)
+     */
+    void set_scheduler(const std::string& val) { scheduler_ = val; }
+    /**
+     * How often to do a full J/K rebuild when building incrementally,
+     * to keep screening errors from accumulating
+     * @param val a positive integer, 1 turns incremental builds off
+     */
+    void set_incfock_full_fock_every(int val) { incfock_full_fock_every_ = val; }
 
     // => Accessors <= //
 
@@ -773,6 +868,9 @@ protected:
     int max_nocc_;
     /// Sieve, must be static throughout the life of the object
     boost::shared_ptr<ERISieve> sieve_;
+    /// Disk algorithm: seconds per (Q|mn) row to read and to contract, from the last stream (0.0 before)
+    double disk_read_time_;
+    double disk_compute_time_;
 
     /// Main (Q|mn) Tensor (or chunk for disk-based)
     SharedMatrix Qmn_;
@@ -808,6 +906,8 @@ protected:
     bool is_core() const;
     unsigned long int memory_temp() const;
     int max_rows() const;
+    /// Rows per block when streaming (Q|mn) from disk, at most max_rows
+    int disk_rows(int max_rows) const;
     int max_nocc() const;
     void initialize_temps();
     void free_temps();
@@ -976,6 +1076,8 @@ protected:
     double bump_R0_;
     /// Annihilation radius in MHG bump function
     double bump_R1_;
+    /// Smallest occupied coefficient on an atom for its pairs to enter K
+    double occ_cutoff_;
 
     // => Required Algorithm-Specific Methods <= //
 
@@ -1022,7 +1124,8 @@ protected:
                  const std::vector<boost::shared_ptr<Matrix> >& D,
                  const std::vector<boost::shared_ptr<Matrix> >& J);
     void build_K(boost::shared_ptr<Matrix> Z,
-                 const std::vector<boost::shared_ptr<Matrix> >& D,
+                 const std::vector<boost::shared_ptr<Matrix> >& C_left,
+                 const std::vector<boost::shared_ptr<Matrix> >& C_right,
                  const std::vector<boost::shared_ptr<Matrix> >& K);
     
 public:
@@ -1074,6 +1177,12 @@ public:
      * @param R1 defaults to 0.0
      */
     void set_df_bump_R1(double R1) { bump_R1_ = R1; }
+    /**
+     * Occupied screening in K: the atom pairs of an atom enter the
+     * exchange of orbital i only if some |C_ri| on the atom exceeds this
+     * @param cutoff defaults to 1.0E-8
+     */
+    void set_occ_cutoff(double cutoff) { occ_cutoff_ = cutoff; }
     /**
      * Range-Separation parameter for EWALD metric fitting 
      * @param theta theta ~ 0 is COULOMB, theta ~ INF is OVERLAP,
@@ -1294,5 +1403,13 @@ public:
 
 #endif
 
+/**
+* Perform a thread-scaling benchmark of DirectJK on the current
+* molecule and BASIS, for each of the J/K accumulation modes
+* \param max_threads maximum number of threads to use
+* \param min_time minimum amount of time to run each mode and thread count [s]
+**/
+void benchmark_directjk(int max_threads, double min_time);
+
 }
 #endif
@@ -27,8 +27,108 @@
 #include "cubature.h"
 #include "psiconfig.h"
 #include "libparallel/ParallelPrinter.h"
+#include <libpsio/psio.hpp>
+#include <psi4-dec.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 namespace psi {
 
+BasisFunctionCache::BasisFunctionCache(const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, int deriv, size_t max_doubles, bool mmap) :
+    deriv_(deriv), mmap_(mmap), size_(0L), data_(NULL), nblocks_(blocks.size())
+{
+    if (deriv_ >= 0) {
+        keys_.push_back("PHI");
+    }
+    if (deriv_ >= 1) {
+        keys_.push_back("PHI_X");
+        keys_.push_back("PHI_Y");
+        keys_.push_back("PHI_Z");
+    }
+    if (deriv_ >= 2) {
+        keys_.push_back("PHI_XX");
+        keys_.push_back("PHI_XY");
+        keys_.push_back("PHI_XZ");
+        keys_.push_back("PHI_YY");
+        keys_.push_back("PHI_YZ");
+        keys_.push_back("PHI_ZZ");
+    }
+
+    // => Assign blocks in grid order until the budget is used up <= //
+
+    std::vector<size_t> offsets;
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        size_t block_size = keys_.size() * (size_t) blocks[Q]->npoints() * blocks[Q]->functions_local_to_global().size();
+        if (size_ + block_size > max_doubles) break;
+        index_[blocks[Q].get()] = offsets.size();
+        offsets.push_back(size_);
+        size_ += block_size;
+    }
+    if (!size_) return;
+
+    // => Backing storage <= //
+
+    if (mmap_) {
+        std::stringstream ss;
+        ss << PSIOManager::shared_object()->get_default_path() << "/" << psi_file_prefix << "." << getpid()
+           << "." << PSIO::get_default_namespace() << ".dft_basis." << this << ".dat";
+        std::string filename = ss.str();
+
+        int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (fd < 0)
+            throw PSIEXCEPTION("BasisFunctionCache: Unable to open scratch file " + filename);
+        // The mapping keeps the data alive, so the name can go right away
+        ::unlink(filename.c_str());
+        if (::ftruncate(fd, size_ * sizeof(double))) {
+            ::close(fd);
+            throw PSIEXCEPTION("BasisFunctionCache: Unable to size scratch file " + filename);
+        }
+        void* map = ::mmap(NULL, size_ * sizeof(double), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+            throw PSIEXCEPTION("BasisFunctionCache: Unable to map scratch file " + filename);
+        data_ = static_cast<double*>(map);
+    } else {
+        data_ = new double[size_];
+    }
+
+    for (size_t ind = 0; ind < offsets.size(); ind++) {
+        slots_.push_back(data_ + offsets[ind]);
+    }
+    filled_.resize(offsets.size(), 0);
+}
+BasisFunctionCache::~BasisFunctionCache()
+{
+    if (!data_) return;
+    if (mmap_) {
+        ::munmap(static_cast<void*>(data_), size_ * sizeof(double));
+    } else {
+        delete[] data_;
+    }
+}
+int BasisFunctionCache::index(const BlockOPoints* block) const
+{
+    std::map<const BlockOPoints*, int>::const_iterator it = index_.find(block);
+    return (it == index_.end() ? -1 : (*it).second);
+}
+void BasisFunctionCache::print(std::string out, int /*print*/) const
+{
+    boost::shared_ptr<psi::PsiOutStream> printer=(out=="outfile"?outfile:
+            boost::shared_ptr<OutFile>(new OutFile(out)));
+    printer->Printf("   => Basis Function Cache <=\n\n");
+    printer->Printf("    Storage          = %14s\n", (mmap_ ? "MMAP" : "MEMORY"));
+    printer->Printf("    Derivative       = %14d\n", deriv_);
+    printer->Printf("    Cached Blocks    = %14zu\n", slots_.size());
+    printer->Printf("    Total Blocks     = %14zu\n", nblocks_);
+    printer->Printf("    Size [MiB]       = %14.1f\n", size_ * sizeof(double) / 1048576.0);
+    printer->Printf("\n");
+}
+
 RKSFunctions::RKSFunctions(boost::shared_ptr<BasisSet> primary, int max_points, int max_functions) :
     PointFunctions(primary,max_points,max_functions)
 {
@@ -97,9 +197,14 @@ void RKSFunctions::compute_points(boost::shared_ptr<BlockOPoints> block)
         throw PSIEXCEPTION("RKSFunctions: call set_pointers.");
 
     // => Build basis function values <= //
-    timer_on("Points");
+    // Only the master thread times (the V quadrature calls this from threads)
+    bool master = true;
+    #ifdef _OPENMP
+        master = (omp_get_thread_num() == 0);
+    #endif
+    if (master) timer_on("Points");
     BasisFunctions::compute_functions(block);
-    timer_off("Points");
+    if (master) timer_off("Points");
 
     // => Global information <= //
     int npoints = block->npoints();
@@ -194,10 +299,14 @@ void RKSFunctions::set_Cs(SharedMatrix /*Ca_AO*/, SharedMatrix /*Cb_AO*/)
 void RKSFunctions::compute_orbitals(boost::shared_ptr<BlockOPoints> block)
 {
     // => Build basis function values <= //
-
-    timer_on("Points");
+    // Only the master thread times (cube grids call this from threads)
+    bool master = true;
+    #ifdef _OPENMP
+        master = (omp_get_thread_num() == 0);
+    #endif
+    if (master) timer_on("Points");
     BasisFunctions::compute_functions(block);
-    timer_off("Points");
+    if (master) timer_off("Points");
 
     // => Global information <= //
 
@@ -326,9 +435,14 @@ void UKSFunctions::compute_points(boost::shared_ptr<BlockOPoints> block)
         throw PSIEXCEPTION("UKSFunctions: call set_pointers.");
 
     // => Build basis function values <= //
-    timer_on("Points");
+    // Only the master thread times (the V quadrature calls this from threads)
+    bool master = true;
+    #ifdef _OPENMP
+        master = (omp_get_thread_num() == 0);
+    #endif
+    if (master) timer_on("Points");
     BasisFunctions::compute_functions(block);
-    timer_off("Points");
+    if (master) timer_off("Points");
 
     // => Global information <= //
     int npoints = block->npoints();
@@ -469,10 +583,14 @@ void UKSFunctions::set_Cs(SharedMatrix Ca_AO, SharedMatrix Cb_AO)
 void UKSFunctions::compute_orbitals(boost::shared_ptr<BlockOPoints> block)
 {
     // => Build basis function values <= //
-
-    timer_on("Points");
+    // Only the master thread times (cube grids call this from threads)
+    bool master = true;
+    #ifdef _OPENMP
+        master = (omp_get_thread_num() == 0);
+    #endif
+    if (master) timer_on("Points");
     BasisFunctions::compute_functions(block);
-    timer_off("Points");
+    if (master) timer_off("Points");
 
     // => Global information <= //
 
@@ -640,6 +758,22 @@ void BasisFunctions::compute_functions(boost::shared_ptr<BlockOPoints> block)
     int nso = max_functions_;
 
     int npoints = block->npoints();
+
+    // => Cached from an earlier call? <= //
+    int cache_index = (cache_ && cache_->deriv() == deriv_ ? cache_->index(block.get()) : -1);
+    if (cache_index >= 0 && cache_->filled(cache_index)) {
+        int nlocal = block->functions_local_to_global().size();
+        const std::vector<std::string>& keys = cache_->keys();
+        double* cachep = cache_->data(cache_index);
+        for (size_t K = 0; K < keys.size(); K++) {
+            double** valp = basis_values_[keys[K]]->pointer();
+            for (int P = 0; P < npoints; P++) {
+                ::memcpy(static_cast<void*>(valp[P]),static_cast<void*>(cachep),nlocal*sizeof(double));
+                cachep += nlocal;
+            }
+        }
+        return;
+    }
     double *restrict x = block->x();
     double *restrict y = block->y();
     double *restrict z = block->z();
@@ -1002,6 +1136,20 @@ void BasisFunctions::compute_functions(boost::shared_ptr<BlockOPoints> block)
     delete[] xc_pow;
     delete[] yc_pow;
     delete[] zc_pow;
+
+    // => Stash for the next call <= //
+    if (cache_index >= 0) {
+        const std::vector<std::string>& keys = cache_->keys();
+        double* cachep = cache_->data(cache_index);
+        for (size_t K = 0; K < keys.size(); K++) {
+            double** valp = basis_values_[keys[K]]->pointer();
+            for (int P = 0; P < npoints; P++) {
+                ::memcpy(static_cast<void*>(cachep),static_cast<void*>(valp[P]),nsig_functions*sizeof(double));
+                cachep += nsig_functions;
+            }
+        }
+        cache_->set_filled(cache_index);
+    }
 }
 void BasisFunctions::print(std::string out, int print) const
 {
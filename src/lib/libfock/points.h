@@ -25,6 +25,8 @@
 
 #include <cstdio>
 #include <map>
+#include <string>
+#include <vector>
 
 #include <libmints/typedefs.h>
 #include <boost/tuple/tuple.hpp>
@@ -40,6 +42,57 @@ class Vector3;
 class BlockOPoints;
 
 
+/**
+ * Class BasisFunctionCache
+ *
+ * Per-block basis function values (and derivatives) kept across calls to
+ * BasisFunctions::compute_functions, so that later SCF iterations only redo
+ * the density contraction. Blocks are given storage in grid order until the
+ * budget runs out, the rest are recomputed every time. Storage is core
+ * memory or an (unlinked) memory-mapped scratch file.
+ *
+ * Each block is filled by whichever thread first computes it; the index
+ * is fixed at construction, so lookups need no locking.
+ **/
+class BasisFunctionCache {
+
+protected:
+    /// Derivative level the values were cached at
+    int deriv_;
+    /// Basis value keys stored per block, in order
+    std::vector<std::string> keys_;
+    /// Memory-mapped scratch file instead of core?
+    bool mmap_;
+    /// Backing storage, in doubles
+    size_t size_;
+    /// Backing storage
+    double* data_;
+    /// Block -> cache index, for cached blocks only
+    std::map<const BlockOPoints*, int> index_;
+    /// Start of each cached block in data_
+    std::vector<double*> slots_;
+    /// Has the block been written yet?
+    std::vector<char> filled_;
+    /// Total number of blocks on the grid
+    size_t nblocks_;
+
+public:
+    BasisFunctionCache(const std::vector<boost::shared_ptr<BlockOPoints> >& blocks, int deriv, size_t max_doubles, bool mmap);
+    virtual ~BasisFunctionCache();
+
+    int deriv() const { return deriv_; }
+    const std::vector<std::string>& keys() const { return keys_; }
+
+    /// Cache index of block, or -1 if it is not cached
+    int index(const BlockOPoints* block) const;
+    /// Packed values of cached block index (npoints x nlocal per key)
+    double* data(int index) const { return slots_[index]; }
+    bool filled(int index) const { return filled_[index]; }
+    void set_filled(int index) { filled_[index] = 1; }
+
+    void print(std::string out = "outfile", int print = 1) const;
+};
+
 class BasisFunctions {
 
 protected:
@@ -59,6 +112,8 @@ protected:
     std::map<std::string, SharedMatrix > basis_temps_;
     /// [L]: pure_index, cart_index, coef
     std::vector<std::vector<boost::tuple<int,int,double> > > spherical_transforms_;
+    /// Optional cache of basis values across calls (shared between threads)
+    boost::shared_ptr<BasisFunctionCache> cache_;
 
     /// Setup spherical_transforms_
     void build_spherical();
@@ -91,6 +146,8 @@ public:
     void set_deriv(int deriv) { deriv_ = deriv; allocate(); }
     void set_max_functions(int max_functions) { max_functions_ = max_functions; allocate(); }
     void set_max_points(int max_points) { max_points_ = max_points; allocate(); }
+    /// Use cache for blocks it holds, when deriv() matches the cached level
+    void set_cache(boost::shared_ptr<BasisFunctionCache> cache) { cache_ = cache; }
 };
 
 class PointFunctions : public BasisFunctions {
@@ -30,6 +30,9 @@
 #include "v.h"
 
 #include <sstream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace psi;
 
@@ -49,6 +52,7 @@ void VBase::common_init()
 {
     print_ = options_.get_int("PRINT");
     debug_ = options_.get_int("DEBUG");
+    num_threads_ = 1;
 }
 boost::shared_ptr<VBase> VBase::build_V(Options& options, const std::string& type)
 {
@@ -359,6 +363,38 @@ void VBase::initialize()
     timer_on("V: Grid");
     grid_ = boost::shared_ptr<DFTGrid>(new DFTGrid(primary_->molecule(),primary_,options_));
     timer_off("V: Grid");
+
+    num_threads_ = 1;
+    #ifdef _OPENMP
+        num_threads_ = omp_get_max_threads();
+    #endif
+}
+void VBase::build_functional_workers()
+{
+    functional_workers_.clear();
+    functional_points_.clear();
+    for (int t = 0; t < num_threads_; t++) {
+        functional_workers_.push_back(functional_->allocate_values());
+    }
+    // Slot views, once the register maps have stopped moving
+    for (int t = 0; t < num_threads_; t++) {
+        functional_points_.push_back(FunctionalPoints::from_maps(point_workers_[t]->point_values(), functional_workers_[t]));
+    }
+}
+void VBase::build_basis_cache()
+{
+    basis_cache_.reset();
+    std::string mode = options_.get_str("DFT_BASIS_CACHE");
+    if (mode == "NONE") return;
+
+    size_t max_bytes = (size_t) options_.get_int("DFT_BASIS_CACHE_MEMORY") * 1024L * 1024L;
+    if (!max_bytes) max_bytes = Process::environment.get_memory() / 4L;
+
+    basis_cache_ = boost::shared_ptr<BasisFunctionCache>(new BasisFunctionCache(grid_->blocks(),
+        point_workers_[0]->deriv(), max_bytes / sizeof(double), mode == "MMAP"));
+    for (int t = 0; t < num_threads_; t++) {
+        point_workers_[t]->set_cache(basis_cache_);
+    }
 }
 void VBase::compute()
 {
@@ -384,6 +420,10 @@ SharedMatrix VBase::compute_gradient()
 }
 void VBase::finalize()
 {
+    point_workers_.clear();
+    functional_workers_.clear();
+    functional_points_.clear();
+    basis_cache_.reset();
     grid_.reset();
 }
 void VBase::print_header() const
@@ -391,6 +431,9 @@ void VBase::print_header() const
     outfile->Printf( "  ==> DFT Potential <==\n\n");
     functional_->print("outfile", print_);  
     grid_->print("outfile",print_);
+    outfile->Printf( "   => XC Quadrature <=\n\n");
+    outfile->Printf( "    OpenMP Threads   = %14d\n\n", num_threads_);
+    if (basis_cache_) basis_cache_->print("outfile",print_);
 }
 
 RV::RV(boost::shared_ptr<SuperFunctional> functional,
@@ -406,8 +449,14 @@ void RV::initialize()
     VBase::initialize();
     int max_points = grid_->max_points();
     int max_functions = grid_->max_functions(); 
-    properties_ = boost::shared_ptr<PointFunctions>(new RKSFunctions(primary_,max_points,max_functions));
-    properties_->set_ansatz(functional_->ansatz());
+    point_workers_.clear();
+    for (int t = 0; t < num_threads_; t++) {
+        boost::shared_ptr<PointFunctions> worker(new RKSFunctions(primary_,max_points,max_functions));
+        worker->set_ansatz(functional_->ansatz());
+        point_workers_.push_back(worker);
+    }
+    properties_ = point_workers_[0];
+    build_basis_cache();
 }
 void RV::finalize()
 {
@@ -426,24 +475,27 @@ void RV::compute_V()
     // Setup the pointers
     SharedMatrix D_AO = D_AO_[0];
     SharedMatrix V_AO = V_AO_[0];
-    properties_->set_pointers(D_AO);
+    for (int t = 0; t < num_threads_; t++) {
+        point_workers_[t]->set_pointers(D_AO);
+    }
+    build_functional_workers();
 
     // What local XC ansatz are we in?
     int ansatz = functional_->ansatz();
 
     // How many functions are there (for lda in Vtemp, T)
-    int max_functions = grid_->max_functions(); 
+    int max_functions = grid_->max_functions();
     int max_points = grid_->max_points();
 
-    // Local/global V matrices
-    SharedMatrix V_local(new Matrix("V Temp", max_functions, max_functions));
-    double** V2p = V_local->pointer();
-    double** Vp = V_AO->pointer();
-
-    // Scratch
-    std::vector<SharedMatrix> scratch = properties_->scratch();
-    SharedMatrix T_local = scratch[0];
-    double** Tp = T_local->pointer();
+    // Per-thread global V (thread 0 writes straight into V_AO), local V, and quadrature temps
+    std::vector<SharedMatrix> V_thread;
+    std::vector<SharedMatrix> V_local;
+    std::vector<SharedVector> QT;
+    for (int t = 0; t < num_threads_; t++) {
+        V_thread.push_back(t == 0 ? V_AO : SharedMatrix(new Matrix("V Thread", V_AO->nrow(), V_AO->ncol())));
+        V_local.push_back(SharedMatrix(new Matrix("V Temp", max_functions, max_functions)));
+        QT.push_back(SharedVector(new Vector("Quadrature Temp", max_points)));
+    }
 
     // Traverse the blocks of points
     double functionalq = 0.0;
@@ -452,11 +504,23 @@ void RV::compute_V()
     double rhoayq      = 0.0;
     double rhoazq      = 0.0;
 
-    boost::shared_ptr<Vector> QT(new Vector("Quadrature Temp", max_points));
-    double *restrict QTp = QT->pointer();
     const std::vector<boost::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
-
-    for (size_t Q = 0; Q < blocks.size(); Q++) {
+    int nblocks = blocks.size();
+
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads_) reduction(+:functionalq,rhoaq,rhoaxq,rhoayq,rhoazq)
+    for (int Q = 0; Q < nblocks; Q++) {
+
+        // => Thread-local workers <= //
+        int rank = 0;
+        #ifdef _OPENMP
+            rank = omp_get_thread_num();
+        #endif
+        boost::shared_ptr<PointFunctions> properties = point_workers_[rank];
+        const FunctionalPoints& vals = functional_points_[rank];
+        double** Vp = V_thread[rank]->pointer();
+        double** V2p = V_local[rank]->pointer();
+        double** Tp = properties->scratch()[0]->pointer();
+        double *restrict QTp = QT[rank]->pointer();
 
         boost::shared_ptr<BlockOPoints> block = blocks[Q];
         int npoints = block->npoints();
@@ -467,23 +531,26 @@ void RV::compute_V()
         const std::vector<int>& function_map = block->functions_local_to_global();
         int nlocal = function_map.size();
 
-        timer_on("Properties");
-        properties_->compute_points(block);
-        timer_off("Properties");
-        timer_on("Functional");
-        std::map<std::string, SharedVector>& vals = functional_->compute_functional(properties_->point_values(), npoints); 
-        timer_off("Functional");
+        if (rank == 0) timer_on("Properties");
+        properties->compute_points(block);
+        if (rank == 0) timer_off("Properties");
+        if (rank == 0) timer_on("Functional");
+        functional_->compute_functional(vals, npoints);
+        if (rank == 0) timer_off("Functional");
 
         if (debug_ > 4) {
+            #pragma omp critical
+            {
             block->print("outfile", debug_);
-            properties_->print("outfile", debug_);
+            properties->print("outfile", debug_);
+            }
         }
 
-        timer_on("V_XC");
-        double** phi = properties_->basis_value("PHI")->pointer();
-        double *restrict rho_a = properties_->point_value("RHO_A")->pointer();
-        double *restrict zk = vals["V"]->pointer(); 
-        double *restrict v_rho_a = vals["V_RHO_A"]->pointer();
+        if (rank == 0) timer_on("V_XC");
+        double** phi = properties->basis_value("PHI")->pointer();
+        double *restrict rho_a = properties->point_value("RHO_A")->pointer();
+        double *restrict zk = vals.out[FunctionalPoints::V]; 
+        double *restrict v_rho_a = vals.out[FunctionalPoints::V_RHO_A];
 
         // => Quadrature values <= //
         functionalq += C_DDOT(npoints,w,1,zk,1);
@@ -496,35 +563,35 @@ void RV::compute_V()
         rhoazq      += C_DDOT(npoints,QTp,1,z,1);
 
         // => LSDA contribution (symmetrized) <= //
-        timer_on("LSDA");
+        if (rank == 0) timer_on("LSDA");
         for (int P = 0; P < npoints; P++) {
             ::memset(static_cast<void*>(Tp[P]),'\0',nlocal*sizeof(double));
             C_DAXPY(nlocal,0.5 * v_rho_a[P] * w[P], phi[P], 1, Tp[P], 1); 
         }
-        timer_off("LSDA");
+        if (rank == 0) timer_off("LSDA");
         
         // => GGA contribution (symmetrized) <= // 
         if (ansatz >= 1) {
-            timer_on("GGA");
-            double** phix = properties_->basis_value("PHI_X")->pointer();
-            double** phiy = properties_->basis_value("PHI_Y")->pointer();
-            double** phiz = properties_->basis_value("PHI_Z")->pointer();
-            double *restrict rho_ax = properties_->point_value("RHO_AX")->pointer();
-            double *restrict rho_ay = properties_->point_value("RHO_AY")->pointer();
-            double *restrict rho_az = properties_->point_value("RHO_AZ")->pointer();
-            double *restrict v_sigma_aa = vals["V_GAMMA_AA"]->pointer(); 
-            double *restrict v_sigma_ab = vals["V_GAMMA_AB"]->pointer(); 
+            if (rank == 0) timer_on("GGA");
+            double** phix = properties->basis_value("PHI_X")->pointer();
+            double** phiy = properties->basis_value("PHI_Y")->pointer();
+            double** phiz = properties->basis_value("PHI_Z")->pointer();
+            double *restrict rho_ax = properties->point_value("RHO_AX")->pointer();
+            double *restrict rho_ay = properties->point_value("RHO_AY")->pointer();
+            double *restrict rho_az = properties->point_value("RHO_AZ")->pointer();
+            double *restrict v_sigma_aa = vals.out[FunctionalPoints::V_GAMMA_AA]; 
+            double *restrict v_sigma_ab = vals.out[FunctionalPoints::V_GAMMA_AB]; 
 
             for (int P = 0; P < npoints; P++) {
                 C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_aa[P] * rho_ax[P] + v_sigma_ab[P] * rho_ax[P]), phix[P], 1, Tp[P], 1); 
                 C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_aa[P] * rho_ay[P] + v_sigma_ab[P] * rho_ay[P]), phiy[P], 1, Tp[P], 1); 
                 C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_aa[P] * rho_az[P] + v_sigma_ab[P] * rho_az[P]), phiz[P], 1, Tp[P], 1); 
             }        
-            timer_off("GGA");
+            if (rank == 0) timer_off("GGA");
         }
 
         // Single GEMM slams GGA+LSDA together (man but GEM's hot!)
-        timer_on("LSDA");
+        if (rank == 0) timer_on("LSDA");
         C_DGEMM('T','N',nlocal,nlocal,npoints,1.0,phi[0],max_functions,Tp[0],max_functions,0.0,V2p[0],max_functions);
 
         // Symmetrization (V is Hermitian)
@@ -533,15 +600,15 @@ void RV::compute_V()
                 V2p[m][n] = V2p[n][m] = V2p[m][n] + V2p[n][m]; 
             }
         } 
-        timer_off("LSDA");
+        if (rank == 0) timer_off("LSDA");
 
         // => Meta contribution <= //
         if (ansatz >= 2) {
-            timer_on("Meta");
-            double** phix = properties_->basis_value("PHI_X")->pointer();
-            double** phiy = properties_->basis_value("PHI_Y")->pointer();
-            double** phiz = properties_->basis_value("PHI_Z")->pointer();
-            double *restrict v_tau_a = vals["V_TAU_A"]->pointer(); 
+            if (rank == 0) timer_on("Meta");
+            double** phix = properties->basis_value("PHI_X")->pointer();
+            double** phiy = properties->basis_value("PHI_Y")->pointer();
+            double** phiz = properties->basis_value("PHI_Z")->pointer();
+            double *restrict v_tau_a = vals.out[FunctionalPoints::V_TAU_A]; 
             
             double** phi[3];
             phi[0] = phix;
@@ -556,7 +623,7 @@ void RV::compute_V()
                 }        
                 C_DGEMM('T','N',nlocal,nlocal,npoints,1.0,phiw[0],max_functions,Tp[0],max_functions,1.0,V2p[0],max_functions);
             }            
-            timer_off("Meta");
+            if (rank == 0) timer_off("Meta");
         }       
  
         // => Unpacking <= //
@@ -569,8 +636,13 @@ void RV::compute_V()
             }
             Vp[mg][mg] += V2p[ml][ml];
         }
-        timer_off("V_XC");
+        if (rank == 0) timer_off("V_XC");
     } 
+
+    // => Thread reduction <= //
+    for (int t = 1; t < num_threads_; t++) {
+        V_AO->add(V_thread[t]);
+    }
    
     quad_values_["FUNCTIONAL"] = functionalq;
     quad_values_["RHO_A"]      = rhoaq; 
@@ -602,32 +674,36 @@ SharedMatrix RV::compute_gradient()
     // Build the target gradient Matrix
     int natom = primary_->molecule()->natom();
     SharedMatrix G(new Matrix("XC Gradient", natom,3));
-    double** Gp = G->pointer();
 
     // Set Hessian derivative level in properties
-    int old_deriv = properties_->deriv(); 
-    properties_->set_deriv((functional_->is_gga() || functional_->is_meta() ? 2 : 1));
+    int old_deriv = properties_->deriv();
+    for (int t = 0; t < num_threads_; t++) {
+        point_workers_[t]->set_deriv((functional_->is_gga() || functional_->is_meta() ? 2 : 1));
+    }
 
     // Setup the pointers
     SharedMatrix D_AO = D_AO_[0];
-    properties_->set_pointers(D_AO);
+    for (int t = 0; t < num_threads_; t++) {
+        point_workers_[t]->set_pointers(D_AO);
+    }
+    build_functional_workers();
 
     // What local XC ansatz are we in?
 //    int ansatz = functional_->ansatz();
 
     // How many functions are there (for lda in Vtemp, T)
-    int max_functions = grid_->max_functions(); 
+    int max_functions = grid_->max_functions();
     int max_points = grid_->max_points();
 
-    // Scratch
-    std::vector<SharedMatrix> scratch = properties_->scratch();
-    SharedMatrix T_local = scratch[0];
-    SharedMatrix U_local(T_local->clone());
-    double** Tp = T_local->pointer();
-    double** Up = U_local->pointer();
-    std::vector<SharedMatrix> Dscratch = properties_->D_scratch();
-    SharedMatrix D_local = Dscratch[0];
-    double** Dp = D_local->pointer();
+    // Per-thread gradients (thread 0 writes straight into G), U scratch, and quadrature temps
+    std::vector<SharedMatrix> G_thread;
+    std::vector<SharedMatrix> U_local;
+    std::vector<SharedVector> QT;
+    for (int t = 0; t < num_threads_; t++) {
+        G_thread.push_back(t == 0 ? G : SharedMatrix(G->clone()));
+        U_local.push_back(SharedMatrix(point_workers_[t]->scratch()[0]->clone()));
+        QT.push_back(SharedVector(new Vector("Quadrature Temp", max_points)));
+    }
 
     // Traverse the blocks of points
     double functionalq = 0.0;
@@ -636,11 +712,24 @@ SharedMatrix RV::compute_gradient()
     double rhoayq      = 0.0;
     double rhoazq      = 0.0;
 
-    boost::shared_ptr<Vector> QT(new Vector("Quadrature Temp", max_points));
-    double* QTp = QT->pointer();
     const std::vector<boost::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
-
-    for (size_t Q = 0; Q < blocks.size(); Q++) {
+    int nblocks = blocks.size();
+
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads_) reduction(+:functionalq,rhoaq,rhoaxq,rhoayq,rhoazq)
+    for (int Q = 0; Q < nblocks; Q++) {
+
+        // => Thread-local workers <= //
+        int rank = 0;
+        #ifdef _OPENMP
+            rank = omp_get_thread_num();
+        #endif
+        boost::shared_ptr<PointFunctions> properties = point_workers_[rank];
+        const FunctionalPoints& vals = functional_points_[rank];
+        double** Gp = G_thread[rank]->pointer();
+        double** Tp = properties->scratch()[0]->pointer();
+        double** Up = U_local[rank]->pointer();
+        double** Dp = properties->D_scratch()[0]->pointer();
+        double* QTp = QT[rank]->pointer();
 
         boost::shared_ptr<BlockOPoints> block = blocks[Q];
         int npoints = block->npoints();
@@ -651,20 +740,20 @@ SharedMatrix RV::compute_gradient()
         const std::vector<int>& function_map = block->functions_local_to_global();
         int nlocal = function_map.size();
 
-        timer_on("Properties");
-        properties_->compute_points(block);
-        timer_off("Properties");
-        timer_on("Functional");
-        std::map<std::string, SharedVector>& vals = functional_->compute_functional(properties_->point_values(), npoints); 
-        timer_off("Functional");
-
-        double** phi = properties_->basis_value("PHI")->pointer();
-        double** phi_x = properties_->basis_value("PHI_X")->pointer();
-        double** phi_y = properties_->basis_value("PHI_Y")->pointer();
-        double** phi_z = properties_->basis_value("PHI_Z")->pointer();
-        double* rho_a = properties_->point_value("RHO_A")->pointer();
-        double* zk = vals["V"]->pointer(); 
-        double* v_rho_a = vals["V_RHO_A"]->pointer();
+        if (rank == 0) timer_on("Properties");
+        properties->compute_points(block);
+        if (rank == 0) timer_off("Properties");
+        if (rank == 0) timer_on("Functional");
+        functional_->compute_functional(vals, npoints);
+        if (rank == 0) timer_off("Functional");
+
+        double** phi = properties->basis_value("PHI")->pointer();
+        double** phi_x = properties->basis_value("PHI_X")->pointer();
+        double** phi_y = properties->basis_value("PHI_Y")->pointer();
+        double** phi_z = properties->basis_value("PHI_Z")->pointer();
+        double* rho_a = properties->point_value("RHO_A")->pointer();
+        double* zk = vals.out[FunctionalPoints::V]; 
+        double* v_rho_a = vals.out[FunctionalPoints::V_RHO_A];
 
         // => Quadrature values <= //
         functionalq += C_DDOT(npoints,w,1,zk,1);
@@ -684,11 +773,11 @@ SharedMatrix RV::compute_gradient()
     
         // => GGA Contribution (Term 1) <= //
         if (functional_->is_gga()) {
-            double* rho_ax = properties_->point_value("RHO_AX")->pointer();
-            double* rho_ay = properties_->point_value("RHO_AY")->pointer();
-            double* rho_az = properties_->point_value("RHO_AZ")->pointer();
-            double* v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
-            double* v_gamma_ab = vals["V_GAMMA_AB"]->pointer();
+            double* rho_ax = properties->point_value("RHO_AX")->pointer();
+            double* rho_ay = properties->point_value("RHO_AY")->pointer();
+            double* rho_az = properties->point_value("RHO_AZ")->pointer();
+            double* v_gamma_aa = vals.out[FunctionalPoints::V_GAMMA_AA];
+            double* v_gamma_ab = vals.out[FunctionalPoints::V_GAMMA_AB];
 
             for (int P = 0; P < npoints; P++) {
                 C_DAXPY(nlocal, -2.0 * w[P] * (2.0 * v_gamma_aa[P] * rho_ax[P] + v_gamma_ab[P] * rho_ax[P]), phi_x[P], 1, Tp[P], 1);
@@ -710,17 +799,17 @@ SharedMatrix RV::compute_gradient()
         
         // => GGA Contribution (Term 2) <= //
         if (functional_->is_gga()) {
-            double** phi_xx = properties_->basis_value("PHI_XX")->pointer();
-            double** phi_xy = properties_->basis_value("PHI_XY")->pointer();
-            double** phi_xz = properties_->basis_value("PHI_XZ")->pointer();
-            double** phi_yy = properties_->basis_value("PHI_YY")->pointer();
-            double** phi_yz = properties_->basis_value("PHI_YZ")->pointer();
-            double** phi_zz = properties_->basis_value("PHI_ZZ")->pointer();
-            double* rho_ax = properties_->point_value("RHO_AX")->pointer();
-            double* rho_ay = properties_->point_value("RHO_AY")->pointer();
-            double* rho_az = properties_->point_value("RHO_AZ")->pointer();
-            double* v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
-            double* v_gamma_ab = vals["V_GAMMA_AB"]->pointer();
+            double** phi_xx = properties->basis_value("PHI_XX")->pointer();
+            double** phi_xy = properties->basis_value("PHI_XY")->pointer();
+            double** phi_xz = properties->basis_value("PHI_XZ")->pointer();
+            double** phi_yy = properties->basis_value("PHI_YY")->pointer();
+            double** phi_yz = properties->basis_value("PHI_YZ")->pointer();
+            double** phi_zz = properties->basis_value("PHI_ZZ")->pointer();
+            double* rho_ax = properties->point_value("RHO_AX")->pointer();
+            double* rho_ay = properties->point_value("RHO_AY")->pointer();
+            double* rho_az = properties->point_value("RHO_AZ")->pointer();
+            double* v_gamma_aa = vals.out[FunctionalPoints::V_GAMMA_AA];
+            double* v_gamma_ab = vals.out[FunctionalPoints::V_GAMMA_AB];
 
             C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi[0],max_functions,Dp[0],max_functions,0.0,Up[0],max_functions);
             
@@ -764,13 +853,13 @@ SharedMatrix RV::compute_gradient()
         
         // => Meta Contribution <= //
         if (functional_->is_meta()) {
-            double** phi_xx = properties_->basis_value("PHI_XX")->pointer();
-            double** phi_xy = properties_->basis_value("PHI_XY")->pointer();
-            double** phi_xz = properties_->basis_value("PHI_XZ")->pointer();
-            double** phi_yy = properties_->basis_value("PHI_YY")->pointer();
-            double** phi_yz = properties_->basis_value("PHI_YZ")->pointer();
-            double** phi_zz = properties_->basis_value("PHI_ZZ")->pointer();
-            double* v_tau_a = vals["V_TAU_A"]->pointer();
+            double** phi_xx = properties->basis_value("PHI_XX")->pointer();
+            double** phi_xy = properties->basis_value("PHI_XY")->pointer();
+            double** phi_xz = properties->basis_value("PHI_XZ")->pointer();
+            double** phi_yy = properties->basis_value("PHI_YY")->pointer();
+            double** phi_yz = properties->basis_value("PHI_YZ")->pointer();
+            double** phi_zz = properties->basis_value("PHI_ZZ")->pointer();
+            double* v_tau_a = vals.out[FunctionalPoints::V_TAU_A];
 
             double** phi_i[3];
             phi_i[0] = phi_x;
@@ -804,6 +893,11 @@ SharedMatrix RV::compute_gradient()
             }
         }
     } 
+
+    // => Thread reduction <= //
+    for (int t = 1; t < num_threads_; t++) {
+        G->add(G_thread[t]);
+    }
    
     quad_values_["FUNCTIONAL"] = functionalq;
     quad_values_["RHO_A"]      = rhoaq; 
@@ -824,7 +918,9 @@ SharedMatrix RV::compute_gradient()
         outfile->Printf( "    <\\vec r\\rho_b>  : <%24.16E,%24.16E,%24.16E>\n\n",quad_values_["RHO_BX"],quad_values_["RHO_BY"],quad_values_["RHO_BZ"]);
     }
 
-    properties_->set_deriv(old_deriv);
+    for (int t = 0; t < num_threads_; t++) {
+        point_workers_[t]->set_deriv(old_deriv);
+    }
 
     // RKS
     G->scale(2.0);
@@ -845,8 +941,14 @@ void UV::initialize()
     VBase::initialize();
     int max_points = grid_->max_points();
     int max_functions = grid_->max_functions(); 
-    properties_ = boost::shared_ptr<PointFunctions>(new UKSFunctions(primary_,max_points,max_functions));
-    properties_->set_ansatz(functional_->ansatz());
+    point_workers_.clear();
+    for (int t = 0; t < num_threads_; t++) {
+        boost::shared_ptr<PointFunctions> worker(new UKSFunctions(primary_,max_points,max_functions));
+        worker->set_ansatz(functional_->ansatz());
+        point_workers_.push_back(worker);
+    }
+    properties_ = point_workers_[0];
+    build_basis_cache();
 }
 void UV::finalize()
 {
@@ -867,7 +969,10 @@ void UV::compute_V()
     SharedMatrix Va_AO = V_AO_[0];
     SharedMatrix Db_AO = D_AO_[1];
     SharedMatrix Vb_AO = V_AO_[1];
-    properties_->set_pointers(Da_AO,Db_AO);
+    for (int t = 0; t < num_threads_; t++) {
+        point_workers_[t]->set_pointers(Da_AO,Db_AO);
+    }
+    build_functional_workers();
 
     // What local XC ansatz are we in?
     int ansatz = functional_->ansatz();
@@ -876,20 +981,21 @@ void UV::compute_V()
     int max_functions = grid_->max_functions();
     int max_points = grid_->max_points();
 
-    // Local/global V matrices
-    SharedMatrix Va_local(new Matrix("Va Temp", max_functions, max_functions));
-    double** Va2p = Va_local->pointer();
-    double** Vap = Va_AO->pointer();
-    SharedMatrix Vb_local(new Matrix("Vb Temp", max_functions, max_functions));
-    double** Vb2p = Vb_local->pointer();
-    double** Vbp = Vb_AO->pointer();
-
-    // Scratch
-    std::vector<SharedMatrix> scratch = properties_->scratch();
-    SharedMatrix Ta_local = scratch[0];
-    SharedMatrix Tb_local = scratch[1]; 
-    double** Tap = Ta_local->pointer();
-    double** Tbp = Tb_local->pointer();
+    // Per-thread global V (thread 0 writes straight into V_AO), local V, and quadrature temps
+    std::vector<SharedMatrix> Va_thread;
+    std::vector<SharedMatrix> Vb_thread;
+    std::vector<SharedMatrix> Va_local;
+    std::vector<SharedMatrix> Vb_local;
+    std::vector<SharedVector> QTa;
+    std::vector<SharedVector> QTb;
+    for (int t = 0; t < num_threads_; t++) {
+        Va_thread.push_back(t == 0 ? Va_AO : SharedMatrix(new Matrix("Va Thread", Va_AO->nrow(), Va_AO->ncol())));
+        Vb_thread.push_back(t == 0 ? Vb_AO : SharedMatrix(new Matrix("Vb Thread", Vb_AO->nrow(), Vb_AO->ncol())));
+        Va_local.push_back(SharedMatrix(new Matrix("Va Temp", max_functions, max_functions)));
+        Vb_local.push_back(SharedMatrix(new Matrix("Vb Temp", max_functions, max_functions)));
+        QTa.push_back(SharedVector(new Vector("Quadrature Temp", max_points)));
+        QTb.push_back(SharedVector(new Vector("Quadrature Temp", max_points)));
+    }
 
     // Traverse the blocks of points
     double functionalq = 0.0;
@@ -901,12 +1007,28 @@ void UV::compute_V()
     double rhobxq      = 0.0;
     double rhobyq      = 0.0;
     double rhobzq      = 0.0;
-    boost::shared_ptr<Vector> QTa(new Vector("Quadrature Temp", max_points));
-    double* QTap = QTa->pointer();
-    boost::shared_ptr<Vector> QTb(new Vector("Quadrature Temp", max_points));
-    double* QTbp = QTb->pointer();
     const std::vector<boost::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
-    for (size_t Q = 0; Q < blocks.size(); Q++) {
+    int nblocks = blocks.size();
+
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads_) reduction(+:functionalq,rhoaq,rhoaxq,rhoayq,rhoazq,rhobq,rhobxq,rhobyq,rhobzq)
+    for (int Q = 0; Q < nblocks; Q++) {
+
+        // => Thread-local workers <= //
+        int rank = 0;
+        #ifdef _OPENMP
+            rank = omp_get_thread_num();
+        #endif
+        boost::shared_ptr<PointFunctions> properties = point_workers_[rank];
+        const FunctionalPoints& vals = functional_points_[rank];
+        double** Vap = Va_thread[rank]->pointer();
+        double** Vbp = Vb_thread[rank]->pointer();
+        double** Va2p = Va_local[rank]->pointer();
+        double** Vb2p = Vb_local[rank]->pointer();
+        std::vector<SharedMatrix> scratch = properties->scratch();
+        double** Tap = scratch[0]->pointer();
+        double** Tbp = scratch[1]->pointer();
+        double* QTap = QTa[rank]->pointer();
+        double* QTbp = QTb[rank]->pointer();
 
         boost::shared_ptr<BlockOPoints> block = blocks[Q];
         int npoints = block->npoints();
@@ -917,25 +1039,28 @@ void UV::compute_V()
         const std::vector<int>& function_map = block->functions_local_to_global();
         int nlocal = function_map.size();
 
-        timer_on("Properties");
-        properties_->compute_points(block);
-        timer_off("Properties");
-        timer_on("Functional");
-        std::map<std::string, SharedVector>& vals = functional_->compute_functional(properties_->point_values(), npoints); 
-        timer_off("Functional");
+        if (rank == 0) timer_on("Properties");
+        properties->compute_points(block);
+        if (rank == 0) timer_off("Properties");
+        if (rank == 0) timer_on("Functional");
+        functional_->compute_functional(vals, npoints);
+        if (rank == 0) timer_off("Functional");
 
         if (debug_ > 3) {
+            #pragma omp critical
+            {
             block->print("outfile", debug_);
-            properties_->print("outfile", debug_);
+            properties->print("outfile", debug_);
+            }
         }
 
-        timer_on("V_XC");
-        double** phi = properties_->basis_value("PHI")->pointer();
-        double *restrict rho_a = properties_->point_value("RHO_A")->pointer();
-        double *restrict rho_b = properties_->point_value("RHO_B")->pointer();
-        double *restrict zk = vals["V"]->pointer(); 
-        double *restrict v_rho_a = vals["V_RHO_A"]->pointer(); 
-        double *restrict v_rho_b = vals["V_RHO_B"]->pointer(); 
+        if (rank == 0) timer_on("V_XC");
+        double** phi = properties->basis_value("PHI")->pointer();
+        double *restrict rho_a = properties->point_value("RHO_A")->pointer();
+        double *restrict rho_b = properties->point_value("RHO_B")->pointer();
+        double *restrict zk = vals.out[FunctionalPoints::V]; 
+        double *restrict v_rho_a = vals.out[FunctionalPoints::V_RHO_A]; 
+        double *restrict v_rho_b = vals.out[FunctionalPoints::V_RHO_B]; 
 
         // => Quadrature values <= //
         functionalq += C_DDOT(npoints,w,1,zk,1);
@@ -953,30 +1078,30 @@ void UV::compute_V()
         rhobzq      += C_DDOT(npoints,QTbp,1,z,1);
 
         // => LSDA contribution (symmetrized) <= //
-        timer_on("LSDA");
+        if (rank == 0) timer_on("LSDA");
         for (int P = 0; P < npoints; P++) {
             ::memset(static_cast<void*>(Tap[P]),'\0',nlocal*sizeof(double));
             ::memset(static_cast<void*>(Tbp[P]),'\0',nlocal*sizeof(double));
             C_DAXPY(nlocal,0.5 * v_rho_a[P] * w[P], phi[P], 1, Tap[P], 1); 
             C_DAXPY(nlocal,0.5 * v_rho_b[P] * w[P], phi[P], 1, Tbp[P], 1); 
         }
-        timer_off("LSDA");
+        if (rank == 0) timer_off("LSDA");
         
         // => GGA contribution (symmetrized) <= // 
         if (ansatz >= 1) {
-            timer_on("GGA");
-            double** phix = properties_->basis_value("PHI_X")->pointer();
-            double** phiy = properties_->basis_value("PHI_Y")->pointer();
-            double** phiz = properties_->basis_value("PHI_Z")->pointer();
-            double *restrict rho_ax = properties_->point_value("RHO_AX")->pointer();
-            double *restrict rho_ay = properties_->point_value("RHO_AY")->pointer();
-            double *restrict rho_az = properties_->point_value("RHO_AZ")->pointer();
-            double *restrict rho_bx = properties_->point_value("RHO_BX")->pointer();
-            double *restrict rho_by = properties_->point_value("RHO_BY")->pointer();
-            double *restrict rho_bz = properties_->point_value("RHO_BZ")->pointer();
-            double *restrict v_sigma_aa = vals["V_GAMMA_AA"]->pointer(); 
-            double *restrict v_sigma_ab = vals["V_GAMMA_AB"]->pointer(); 
-            double *restrict v_sigma_bb = vals["V_GAMMA_BB"]->pointer(); 
+            if (rank == 0) timer_on("GGA");
+            double** phix = properties->basis_value("PHI_X")->pointer();
+            double** phiy = properties->basis_value("PHI_Y")->pointer();
+            double** phiz = properties->basis_value("PHI_Z")->pointer();
+            double *restrict rho_ax = properties->point_value("RHO_AX")->pointer();
+            double *restrict rho_ay = properties->point_value("RHO_AY")->pointer();
+            double *restrict rho_az = properties->point_value("RHO_AZ")->pointer();
+            double *restrict rho_bx = properties->point_value("RHO_BX")->pointer();
+            double *restrict rho_by = properties->point_value("RHO_BY")->pointer();
+            double *restrict rho_bz = properties->point_value("RHO_BZ")->pointer();
+            double *restrict v_sigma_aa = vals.out[FunctionalPoints::V_GAMMA_AA]; 
+            double *restrict v_sigma_ab = vals.out[FunctionalPoints::V_GAMMA_AB]; 
+            double *restrict v_sigma_bb = vals.out[FunctionalPoints::V_GAMMA_BB]; 
 
             for (int P = 0; P < npoints; P++) {
                 C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_aa[P] * rho_ax[P] + v_sigma_ab[P] * rho_bx[P]), phix[P], 1, Tap[P], 1); 
@@ -986,10 +1111,10 @@ void UV::compute_V()
                 C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_bb[P] * rho_by[P] + v_sigma_ab[P] * rho_ay[P]), phiy[P], 1, Tbp[P], 1); 
                 C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_bb[P] * rho_bz[P] + v_sigma_ab[P] * rho_az[P]), phiz[P], 1, Tbp[P], 1); 
             }        
-            timer_off("GGA");
+            if (rank == 0) timer_off("GGA");
         }
 
-        timer_on("LSDA");
+        if (rank == 0) timer_on("LSDA");
         // Single GEMM slams GGA+LSDA together (man but GEM's hot!)
         C_DGEMM('T','N',nlocal,nlocal,npoints,1.0,phi[0],max_functions,Tap[0],max_functions,0.0,Va2p[0],max_functions);
         C_DGEMM('T','N',nlocal,nlocal,npoints,1.0,phi[0],max_functions,Tbp[0],max_functions,0.0,Vb2p[0],max_functions);
@@ -1001,16 +1126,16 @@ void UV::compute_V()
                 Vb2p[m][n] = Vb2p[n][m] = Vb2p[m][n] + Vb2p[n][m]; 
             }
         }
-        timer_off("LSDA");
+        if (rank == 0) timer_off("LSDA");
         
         // => Meta contribution <= //
         if (ansatz >= 2) {
-            timer_on("Meta");
-            double** phix = properties_->basis_value("PHI_X")->pointer();
-            double** phiy = properties_->basis_value("PHI_Y")->pointer();
-            double** phiz = properties_->basis_value("PHI_Z")->pointer();
-            double *restrict v_tau_a = vals["V_TAU_A"]->pointer(); 
-            double *restrict v_tau_b = vals["V_TAU_B"]->pointer(); 
+            if (rank == 0) timer_on("Meta");
+            double** phix = properties->basis_value("PHI_X")->pointer();
+            double** phiy = properties->basis_value("PHI_Y")->pointer();
+            double** phiz = properties->basis_value("PHI_Z")->pointer();
+            double *restrict v_tau_a = vals.out[FunctionalPoints::V_TAU_A]; 
+            double *restrict v_tau_b = vals.out[FunctionalPoints::V_TAU_B]; 
 
             double** phi[3];
             phi[0] = phix;
@@ -1038,7 +1163,7 @@ void UV::compute_V()
                 }            
             }
 
-            timer_off("Meta");
+            if (rank == 0) timer_off("Meta");
         }       
  
         // => Unpacking <= //
@@ -1054,8 +1179,14 @@ void UV::compute_V()
             Vap[mg][mg] += Va2p[ml][ml];
             Vbp[mg][mg] += Vb2p[ml][ml];
         }
-        timer_off("V_XC");
+        if (rank == 0) timer_off("V_XC");
     } 
+
+    // => Thread reduction <= //
+    for (int t = 1; t < num_threads_; t++) {
+        Va_AO->add(Va_thread[t]);
+        Vb_AO->add(Vb_thread[t]);
+    }
    
     quad_values_["FUNCTIONAL"] = functionalq;
     quad_values_["RHO_A"]      = rhoaq; 
@@ -1087,50 +1218,75 @@ SharedMatrix UV::compute_gradient()
     // Build the target gradient Matrix
     int natom = primary_->molecule()->natom();
     SharedMatrix G(new Matrix("XC Gradient", natom,3));
-    double** Gp = G->pointer();
 
     // Set Hessian derivative level in properties
-    int old_deriv = properties_->deriv(); 
-    properties_->set_deriv((functional_->is_gga() || functional_->is_meta() ? 2 : 1));
+    int old_deriv = properties_->deriv();
+    for (int t = 0; t < num_threads_; t++) {
+        point_workers_[t]->set_deriv((functional_->is_gga() || functional_->is_meta() ? 2 : 1));
+    }
 
     // Setup the pointers
     SharedMatrix Da_AO = D_AO_[0];
     SharedMatrix Db_AO = D_AO_[1];
-    properties_->set_pointers(Da_AO, Db_AO);
+    for (int t = 0; t < num_threads_; t++) {
+        point_workers_[t]->set_pointers(Da_AO, Db_AO);
+    }
+    build_functional_workers();
 
     // What local XC ansatz are we in?
 //    int ansatz = functional_->ansatz();
 
     // How many functions are there (for lda in Vtemp, T)
-    int max_functions = grid_->max_functions(); 
+    int max_functions = grid_->max_functions();
     int max_points = grid_->max_points();
 
-    // Scratch
-    std::vector<SharedMatrix> scratch = properties_->scratch();
-    SharedMatrix Ta_local = scratch[0];
-    SharedMatrix Ua_local(Ta_local->clone());
-    SharedMatrix Tb_local = scratch[1];
-    SharedMatrix Ub_local(Tb_local->clone());
-    double** Tap = Ta_local->pointer();
-    double** Uap = Ua_local->pointer();
-    double** Tbp = Tb_local->pointer();
-    double** Ubp = Ub_local->pointer();
-    std::vector<SharedMatrix> Dscratch = properties_->D_scratch();
-    SharedMatrix Da_local = Dscratch[0];
-    SharedMatrix Db_local = Dscratch[1];
-    double** Dap = Da_local->pointer();
-    double** Dbp = Db_local->pointer();
+    // Per-thread gradients (thread 0 writes straight into G), U scratch, and quadrature temps
+    std::vector<SharedMatrix> G_thread;
+    std::vector<SharedMatrix> Ua_local;
+    std::vector<SharedMatrix> Ub_local;
+    std::vector<SharedVector> QT;
+    for (int t = 0; t < num_threads_; t++) {
+        std::vector<SharedMatrix> scratch = point_workers_[t]->scratch();
+        G_thread.push_back(t == 0 ? G : SharedMatrix(G->clone()));
+        Ua_local.push_back(SharedMatrix(scratch[0]->clone()));
+        Ub_local.push_back(SharedMatrix(scratch[1]->clone()));
+        QT.push_back(SharedVector(new Vector("Quadrature Temp", max_points)));
+    }
 
     // Traverse the blocks of points
-    boost::shared_ptr<Vector> QT(new Vector("Quadrature Temp", max_points));
-    double* QTp = QT->pointer();
-    const std::vector<boost::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
-
-    for (std::map<std::string, double>::const_iterator it = quad_values_.begin(); it != quad_values_.end(); ++it) {
-        quad_values_[(*it).first] = 0.0;
-    }
+    double functionalq = 0.0;
+    double rhoaq       = 0.0;
+    double rhoaxq      = 0.0;
+    double rhoayq      = 0.0;
+    double rhoazq      = 0.0;
+    double rhobq       = 0.0;
+    double rhobxq      = 0.0;
+    double rhobyq      = 0.0;
+    double rhobzq      = 0.0;
 
-    for (size_t Q = 0; Q < blocks.size(); Q++) {
+    const std::vector<boost::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
+    int nblocks = blocks.size();
+
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads_) reduction(+:functionalq,rhoaq,rhoaxq,rhoayq,rhoazq,rhobq,rhobxq,rhobyq,rhobzq)
+    for (int Q = 0; Q < nblocks; Q++) {
+
+        // => Thread-local workers <= //
+        int rank = 0;
+        #ifdef _OPENMP
+            rank = omp_get_thread_num();
+        #endif
+        boost::shared_ptr<PointFunctions> properties = point_workers_[rank];
+        const FunctionalPoints& vals = functional_points_[rank];
+        double** Gp = G_thread[rank]->pointer();
+        std::vector<SharedMatrix> scratch = properties->scratch();
+        double** Tap = scratch[0]->pointer();
+        double** Tbp = scratch[1]->pointer();
+        double** Uap = Ua_local[rank]->pointer();
+        double** Ubp = Ub_local[rank]->pointer();
+        std::vector<SharedMatrix> Dscratch = properties->D_scratch();
+        double** Dap = Dscratch[0]->pointer();
+        double** Dbp = Dscratch[1]->pointer();
+        double* QTp = QT[rank]->pointer();
 
         boost::shared_ptr<BlockOPoints> block = blocks[Q];
         int npoints = block->npoints();
@@ -1141,39 +1297,39 @@ SharedMatrix UV::compute_gradient()
         const std::vector<int>& function_map = block->functions_local_to_global();
         int nlocal = function_map.size();
 
-        timer_on("Properties");
-        properties_->compute_points(block);
-        timer_off("Properties");
-        timer_on("Functional");
-        std::map<std::string, SharedVector>& vals = functional_->compute_functional(properties_->point_values(), npoints); 
-        timer_off("Functional");
-
-        double** phi = properties_->basis_value("PHI")->pointer();
-        double** phi_x = properties_->basis_value("PHI_X")->pointer();
-        double** phi_y = properties_->basis_value("PHI_Y")->pointer();
-        double** phi_z = properties_->basis_value("PHI_Z")->pointer();
-        double* rho_a = properties_->point_value("RHO_A")->pointer();
-        double* rho_b = properties_->point_value("RHO_B")->pointer();
-        double* zk = vals["V"]->pointer(); 
-        double* v_rho_a = vals["V_RHO_A"]->pointer();
-        double* v_rho_b = vals["V_RHO_B"]->pointer();
+        if (rank == 0) timer_on("Properties");
+        properties->compute_points(block);
+        if (rank == 0) timer_off("Properties");
+        if (rank == 0) timer_on("Functional");
+        functional_->compute_functional(vals, npoints);
+        if (rank == 0) timer_off("Functional");
+
+        double** phi = properties->basis_value("PHI")->pointer();
+        double** phi_x = properties->basis_value("PHI_X")->pointer();
+        double** phi_y = properties->basis_value("PHI_Y")->pointer();
+        double** phi_z = properties->basis_value("PHI_Z")->pointer();
+        double* rho_a = properties->point_value("RHO_A")->pointer();
+        double* rho_b = properties->point_value("RHO_B")->pointer();
+        double* zk = vals.out[FunctionalPoints::V]; 
+        double* v_rho_a = vals.out[FunctionalPoints::V_RHO_A];
+        double* v_rho_b = vals.out[FunctionalPoints::V_RHO_B];
 
         // => Quadrature values <= //
-        quad_values_["FUNCTIONAL"] += C_DDOT(npoints,w,1,zk,1); 
+        functionalq += C_DDOT(npoints,w,1,zk,1); 
         for (int P = 0; P < npoints; P++) {
             QTp[P] = w[P] * rho_a[P];
         }
-        quad_values_["RHO_A"] += C_DDOT(npoints,w,1,rho_a,1);
-        quad_values_["RHO_AX"] += C_DDOT(npoints,QTp,1,x,1);
-        quad_values_["RHO_AY"] += C_DDOT(npoints,QTp,1,y,1);
-        quad_values_["RHO_AZ"] += C_DDOT(npoints,QTp,1,z,1);
+        rhoaq += C_DDOT(npoints,w,1,rho_a,1);
+        rhoaxq += C_DDOT(npoints,QTp,1,x,1);
+        rhoayq += C_DDOT(npoints,QTp,1,y,1);
+        rhoazq += C_DDOT(npoints,QTp,1,z,1);
         for (int P = 0; P < npoints; P++) {
             QTp[P] = w[P] * rho_b[P];
         }
-        quad_values_["RHO_B"] += C_DDOT(npoints,w,1,rho_b,1);
-        quad_values_["RHO_BX"] += C_DDOT(npoints,QTp,1,x,1);
-        quad_values_["RHO_BY"] += C_DDOT(npoints,QTp,1,y,1);
-        quad_values_["RHO_BZ"] += C_DDOT(npoints,QTp,1,z,1);
+        rhobq += C_DDOT(npoints,w,1,rho_b,1);
+        rhobxq += C_DDOT(npoints,QTp,1,x,1);
+        rhobyq += C_DDOT(npoints,QTp,1,y,1);
+        rhobzq += C_DDOT(npoints,QTp,1,z,1);
     
         // => LSDA Contribution <= //
         for (int P = 0; P < npoints; P++) {
@@ -1185,15 +1341,15 @@ SharedMatrix UV::compute_gradient()
     
         // => GGA Contribution (Term 1) <= //
         if (functional_->is_gga()) {
-            double* rho_ax = properties_->point_value("RHO_AX")->pointer();
-            double* rho_ay = properties_->point_value("RHO_AY")->pointer();
-            double* rho_az = properties_->point_value("RHO_AZ")->pointer();
-            double* rho_bx = properties_->point_value("RHO_BX")->pointer();
-            double* rho_by = properties_->point_value("RHO_BY")->pointer();
-            double* rho_bz = properties_->point_value("RHO_BZ")->pointer();
-            double* v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
-            double* v_gamma_ab = vals["V_GAMMA_AB"]->pointer();
-            double* v_gamma_bb = vals["V_GAMMA_BB"]->pointer();
+            double* rho_ax = properties->point_value("RHO_AX")->pointer();
+            double* rho_ay = properties->point_value("RHO_AY")->pointer();
+            double* rho_az = properties->point_value("RHO_AZ")->pointer();
+            double* rho_bx = properties->point_value("RHO_BX")->pointer();
+            double* rho_by = properties->point_value("RHO_BY")->pointer();
+            double* rho_bz = properties->point_value("RHO_BZ")->pointer();
+            double* v_gamma_aa = vals.out[FunctionalPoints::V_GAMMA_AA];
+            double* v_gamma_ab = vals.out[FunctionalPoints::V_GAMMA_AB];
+            double* v_gamma_bb = vals.out[FunctionalPoints::V_GAMMA_BB];
 
             for (int P = 0; P < npoints; P++) {
                 C_DAXPY(nlocal, -2.0 * w[P] * (2.0 * v_gamma_aa[P] * rho_ax[P] + v_gamma_ab[P] * rho_bx[P]), phi_x[P], 1, Tap[P], 1);
@@ -1222,21 +1378,21 @@ SharedMatrix UV::compute_gradient()
         
         // => GGA Contribution (Term 2) <= //
         if (functional_->is_gga()) {
-            double** phi_xx = properties_->basis_value("PHI_XX")->pointer();
-            double** phi_xy = properties_->basis_value("PHI_XY")->pointer();
-            double** phi_xz = properties_->basis_value("PHI_XZ")->pointer();
-            double** phi_yy = properties_->basis_value("PHI_YY")->pointer();
-            double** phi_yz = properties_->basis_value("PHI_YZ")->pointer();
-            double** phi_zz = properties_->basis_value("PHI_ZZ")->pointer();
-            double* rho_ax = properties_->point_value("RHO_AX")->pointer();
-            double* rho_ay = properties_->point_value("RHO_AY")->pointer();
-            double* rho_az = properties_->point_value("RHO_AZ")->pointer();
-            double* rho_bx = properties_->point_value("RHO_BX")->pointer();
-            double* rho_by = properties_->point_value("RHO_BY")->pointer();
-            double* rho_bz = properties_->point_value("RHO_BZ")->pointer();
-            double* v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
-            double* v_gamma_ab = vals["V_GAMMA_AB"]->pointer();
-            double* v_gamma_bb = vals["V_GAMMA_BB"]->pointer();
+            double** phi_xx = properties->basis_value("PHI_XX")->pointer();
+            double** phi_xy = properties->basis_value("PHI_XY")->pointer();
+            double** phi_xz = properties->basis_value("PHI_XZ")->pointer();
+            double** phi_yy = properties->basis_value("PHI_YY")->pointer();
+            double** phi_yz = properties->basis_value("PHI_YZ")->pointer();
+            double** phi_zz = properties->basis_value("PHI_ZZ")->pointer();
+            double* rho_ax = properties->point_value("RHO_AX")->pointer();
+            double* rho_ay = properties->point_value("RHO_AY")->pointer();
+            double* rho_az = properties->point_value("RHO_AZ")->pointer();
+            double* rho_bx = properties->point_value("RHO_BX")->pointer();
+            double* rho_by = properties->point_value("RHO_BY")->pointer();
+            double* rho_bz = properties->point_value("RHO_BZ")->pointer();
+            double* v_gamma_aa = vals.out[FunctionalPoints::V_GAMMA_AA];
+            double* v_gamma_ab = vals.out[FunctionalPoints::V_GAMMA_AB];
+            double* v_gamma_bb = vals.out[FunctionalPoints::V_GAMMA_BB];
 
             C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi[0],max_functions,Dap[0],max_functions,0.0,Uap[0],max_functions);
             C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi[0],max_functions,Dbp[0],max_functions,0.0,Ubp[0],max_functions);
@@ -1296,14 +1452,14 @@ SharedMatrix UV::compute_gradient()
         
         // => Meta Contribution <= //
         if (functional_->is_meta()) {
-            double** phi_xx = properties_->basis_value("PHI_XX")->pointer();
-            double** phi_xy = properties_->basis_value("PHI_XY")->pointer();
-            double** phi_xz = properties_->basis_value("PHI_XZ")->pointer();
-            double** phi_yy = properties_->basis_value("PHI_YY")->pointer();
-            double** phi_yz = properties_->basis_value("PHI_YZ")->pointer();
-            double** phi_zz = properties_->basis_value("PHI_ZZ")->pointer();
-            double* v_tau_a = vals["V_TAU_A"]->pointer();
-            double* v_tau_b = vals["V_TAU_B"]->pointer();
+            double** phi_xx = properties->basis_value("PHI_XX")->pointer();
+            double** phi_xy = properties->basis_value("PHI_XY")->pointer();
+            double** phi_xz = properties->basis_value("PHI_XZ")->pointer();
+            double** phi_yy = properties->basis_value("PHI_YY")->pointer();
+            double** phi_yz = properties->basis_value("PHI_YZ")->pointer();
+            double** phi_zz = properties->basis_value("PHI_ZZ")->pointer();
+            double* v_tau_a = vals.out[FunctionalPoints::V_TAU_A];
+            double* v_tau_b = vals.out[FunctionalPoints::V_TAU_B];
 
             double** phi_i[3];
             phi_i[0] = phi_x;
@@ -1350,6 +1506,21 @@ SharedMatrix UV::compute_gradient()
         }
 
     } 
+
+    // => Thread reduction <= //
+    for (int t = 1; t < num_threads_; t++) {
+        G->add(G_thread[t]);
+    }
+
+    quad_values_["FUNCTIONAL"] = functionalq;
+    quad_values_["RHO_A"]      = rhoaq; 
+    quad_values_["RHO_AX"]     = rhoaxq; 
+    quad_values_["RHO_AY"]     = rhoayq; 
+    quad_values_["RHO_AZ"]     = rhoazq; 
+    quad_values_["RHO_B"]      = rhobq; 
+    quad_values_["RHO_BX"]     = rhobxq; 
+    quad_values_["RHO_BY"]     = rhobyq; 
+    quad_values_["RHO_BZ"]     = rhobzq; 
  
     if (debug_) {
         outfile->Printf( "   => XC Gradient: Numerical Integrals <=\n\n");
@@ -1360,7 +1531,9 @@ SharedMatrix UV::compute_gradient()
         outfile->Printf( "    <\\vec r\\rho_b>  : <%24.16E,%24.16E,%24.16E>\n\n",quad_values_["RHO_BX"],quad_values_["RHO_BY"],quad_values_["RHO_BZ"]);
     }
 
-    properties_->set_deriv(old_deriv);
+    for (int t = 0; t < num_threads_; t++) {
+        point_workers_[t]->set_deriv(old_deriv);
+    }
 
     return G;
 }
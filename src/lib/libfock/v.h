@@ -24,6 +24,7 @@
 #define LIBFOCK_DFT_H
 
 #include <libmints/typedefs.h>
+#include <libfunctional/functional.h>
 #include <vector>
 #include <map>
 
@@ -32,6 +33,7 @@ namespace psi {
 class Options;
 class DFTGrid;
 class PointFunctions;
+class BasisFunctionCache;
 class SuperFunctional;
 
 // => BASE CLASS <= //
@@ -58,6 +60,16 @@ protected:
     boost::shared_ptr<SuperFunctional> functional_;
     /// Point function computer (densities, gammas, basis values)
     boost::shared_ptr<PointFunctions> properties_;
+    /// Number of OpenMP threads in the quadrature
+    int num_threads_;
+    /// Per-thread point function computers (properties_ is the first)
+    std::vector<boost::shared_ptr<PointFunctions> > point_workers_;
+    /// Per-thread functional value registers
+    std::vector<std::map<std::string, SharedVector> > functional_workers_;
+    /// Per-thread slot views of (point_workers_, functional_workers_)
+    std::vector<FunctionalPoints> functional_points_;
+    /// Basis function values kept between calls (DFT_BASIS_CACHE), shared by point_workers_
+    boost::shared_ptr<BasisFunctionCache> basis_cache_;
     /// Integration grid, built by KSPotential
     boost::shared_ptr<DFTGrid> grid_;
     /// Quadrature values obtained during integration 
@@ -97,6 +109,10 @@ protected:
 
     /// Actually build V_AO
     virtual void compute_V() = 0;
+    /// (Re)allocate functional_workers_/functional_points_ to match the current functional and points
+    void build_functional_workers();
+    /// Build basis_cache_ at the workers' derivative level and hand it to point_workers_
+    void build_basis_cache();
     /// Set things up
     void common_init();
 public:
@@ -48,6 +48,10 @@ FT97B_XFunctional::~FT97B_XFunctional()
 {
 }
 void FT97B_XFunctional::compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha)
+{
+    compute_block(FunctionalPoints::from_maps(in, out), npoints, deriv, alpha);
+}
+void FT97B_XFunctional::compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha)
 {
     double c = parameters_["c"];
     double d0 = parameters_["d0"];
@@ -68,17 +72,17 @@ void FT97B_XFunctional::compute_functional(const std::map<std::string,SharedVect
     double* tau_bp = NULL;
 
     if (true) {
-        rho_ap = in.find("RHO_A")->second->pointer();
-        rho_bp = in.find("RHO_B")->second->pointer();
+        rho_ap = points.in[FunctionalPoints::RHO_A];
+        rho_bp = points.in[FunctionalPoints::RHO_B];
     }
     if (gga_) {  
-        gamma_aap = in.find("GAMMA_AA")->second->pointer();
-        gamma_abp = in.find("GAMMA_AB")->second->pointer();
-        gamma_bbp = in.find("GAMMA_BB")->second->pointer();
+        gamma_aap = points.in[FunctionalPoints::GAMMA_AA];
+        gamma_abp = points.in[FunctionalPoints::GAMMA_AB];
+        gamma_bbp = points.in[FunctionalPoints::GAMMA_BB];
     } 
     if (meta_)  {
-        tau_ap = in.find("TAU_A")->second->pointer();
-        tau_bp = in.find("TAU_B")->second->pointer();
+        tau_ap = points.in[FunctionalPoints::TAU_A];
+        tau_bp = points.in[FunctionalPoints::TAU_B];
     }
 
     // => Outut variables <= //
@@ -123,63 +127,63 @@ void FT97B_XFunctional::compute_functional(const std::map<std::string,SharedVect
     double* v_gamma_bb_tau_b = NULL;
 
     if (deriv >= 0) {
-        v = out.find("V")->second->pointer();
+        v = points.out[FunctionalPoints::V];
     } 
     if (deriv >= 1) {
         if (true) {
-            v_rho_a = out.find("V_RHO_A")->second->pointer();
-            v_rho_b = out.find("V_RHO_B")->second->pointer();
+            v_rho_a = points.out[FunctionalPoints::V_RHO_A];
+            v_rho_b = points.out[FunctionalPoints::V_RHO_B];
         }
         if (gga_) {
-            v_gamma_aa = out.find("V_GAMMA_AA")->second->pointer();
-            v_gamma_ab = out.find("V_GAMMA_AB")->second->pointer();
-            v_gamma_bb = out.find("V_GAMMA_BB")->second->pointer();
+            v_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA];
+            v_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB];
+            v_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB];
         }
         if (meta_) {    
-            v_tau_a = out.find("V_TAU_A")->second->pointer();
-            v_tau_b = out.find("V_TAU_B")->second->pointer();
+            v_tau_a = points.out[FunctionalPoints::V_TAU_A];
+            v_tau_b = points.out[FunctionalPoints::V_TAU_B];
         }
     }
     if (deriv >= 2) {
         if (true) {
-            v_rho_a_rho_a = out.find("V_RHO_A_RHO_A")->second->pointer();
-            v_rho_a_rho_b = out.find("V_RHO_A_RHO_B")->second->pointer();
-            v_rho_b_rho_b = out.find("V_RHO_B_RHO_B")->second->pointer();
+            v_rho_a_rho_a = points.out[FunctionalPoints::V_RHO_A_RHO_A];
+            v_rho_a_rho_b = points.out[FunctionalPoints::V_RHO_A_RHO_B];
+            v_rho_b_rho_b = points.out[FunctionalPoints::V_RHO_B_RHO_B];
         }
         if (gga_) {
-            v_gamma_aa_gamma_aa = out.find("V_GAMMA_AA_GAMMA_AA")->second->pointer();
-            v_gamma_aa_gamma_ab = out.find("V_GAMMA_AA_GAMMA_AB")->second->pointer();
-            v_gamma_aa_gamma_bb = out.find("V_GAMMA_AA_GAMMA_BB")->second->pointer();
-            v_gamma_ab_gamma_ab = out.find("V_GAMMA_AB_GAMMA_AB")->second->pointer();
-            v_gamma_ab_gamma_bb = out.find("V_GAMMA_AB_GAMMA_BB")->second->pointer();
-            v_gamma_bb_gamma_bb = out.find("V_GAMMA_BB_GAMMA_BB")->second->pointer();
+            v_gamma_aa_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_AA];
+            v_gamma_aa_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_AB];
+            v_gamma_aa_gamma_bb = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_BB];
+            v_gamma_ab_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB_GAMMA_AB];
+            v_gamma_ab_gamma_bb = points.out[FunctionalPoints::V_GAMMA_AB_GAMMA_BB];
+            v_gamma_bb_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB_GAMMA_BB];
         }
         if (meta_) {
-            v_tau_a_tau_a = out.find("V_TAU_A_TAU_A")->second->pointer();
-            v_tau_a_tau_b = out.find("V_TAU_A_TAU_B")->second->pointer();
-            v_tau_b_tau_b = out.find("V_TAU_B_TAU_B")->second->pointer();
+            v_tau_a_tau_a = points.out[FunctionalPoints::V_TAU_A_TAU_A];
+            v_tau_a_tau_b = points.out[FunctionalPoints::V_TAU_A_TAU_B];
+            v_tau_b_tau_b = points.out[FunctionalPoints::V_TAU_B_TAU_B];
         }
         if (gga_) {
-            v_rho_a_gamma_aa = out.find("V_RHO_A_GAMMA_AA")->second->pointer();
-            v_rho_a_gamma_ab = out.find("V_RHO_A_GAMMA_AB")->second->pointer();
-            v_rho_a_gamma_bb = out.find("V_RHO_A_GAMMA_BB")->second->pointer();
-            v_rho_b_gamma_aa = out.find("V_RHO_B_GAMMA_AA")->second->pointer();
-            v_rho_b_gamma_ab = out.find("V_RHO_B_GAMMA_AB")->second->pointer();
-            v_rho_b_gamma_bb = out.find("V_RHO_B_GAMMA_BB")->second->pointer();
+            v_rho_a_gamma_aa = points.out[FunctionalPoints::V_RHO_A_GAMMA_AA];
+            v_rho_a_gamma_ab = points.out[FunctionalPoints::V_RHO_A_GAMMA_AB];
+            v_rho_a_gamma_bb = points.out[FunctionalPoints::V_RHO_A_GAMMA_BB];
+            v_rho_b_gamma_aa = points.out[FunctionalPoints::V_RHO_B_GAMMA_AA];
+            v_rho_b_gamma_ab = points.out[FunctionalPoints::V_RHO_B_GAMMA_AB];
+            v_rho_b_gamma_bb = points.out[FunctionalPoints::V_RHO_B_GAMMA_BB];
         }
         if (meta_) {
-            v_rho_a_tau_a = out.find("V_RHO_A_TAU_A")->second->pointer();
-            v_rho_a_tau_b = out.find("V_RHO_A_TAU_B")->second->pointer();
-            v_rho_b_tau_a = out.find("V_RHO_B_TAU_A")->second->pointer();
-            v_rho_b_tau_b = out.find("V_RHO_B_TAU_B")->second->pointer();
+            v_rho_a_tau_a = points.out[FunctionalPoints::V_RHO_A_TAU_A];
+            v_rho_a_tau_b = points.out[FunctionalPoints::V_RHO_A_TAU_B];
+            v_rho_b_tau_a = points.out[FunctionalPoints::V_RHO_B_TAU_A];
+            v_rho_b_tau_b = points.out[FunctionalPoints::V_RHO_B_TAU_B];
         }
         if (gga_ && meta_) {
-            v_gamma_aa_tau_a = out.find("V_GAMMA_AA_TAU_A")->second->pointer();
-            v_gamma_aa_tau_b = out.find("V_GAMMA_AA_TAU_B")->second->pointer();
-            v_gamma_ab_tau_a = out.find("V_GAMMA_AB_TAU_A")->second->pointer();
-            v_gamma_ab_tau_b = out.find("V_GAMMA_AB_TAU_B")->second->pointer();
-            v_gamma_bb_tau_a = out.find("V_GAMMA_BB_TAU_A")->second->pointer();
-            v_gamma_bb_tau_b = out.find("V_GAMMA_BB_TAU_B")->second->pointer();
+            v_gamma_aa_tau_a = points.out[FunctionalPoints::V_GAMMA_AA_TAU_A];
+            v_gamma_aa_tau_b = points.out[FunctionalPoints::V_GAMMA_AA_TAU_B];
+            v_gamma_ab_tau_a = points.out[FunctionalPoints::V_GAMMA_AB_TAU_A];
+            v_gamma_ab_tau_b = points.out[FunctionalPoints::V_GAMMA_AB_TAU_B];
+            v_gamma_bb_tau_a = points.out[FunctionalPoints::V_GAMMA_BB_TAU_A];
+            v_gamma_bb_tau_b = points.out[FunctionalPoints::V_GAMMA_BB_TAU_B];
         }
     }
 
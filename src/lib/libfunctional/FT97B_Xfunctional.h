@@ -38,6 +38,7 @@ public:
     FT97B_XFunctional();
     virtual ~FT97B_XFunctional(); 
     virtual void compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha);
+    virtual void compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha);
 
 };
 
@@ -49,6 +49,10 @@ LYP_CFunctional::~LYP_CFunctional()
 {
 }
 void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha)
+{
+    compute_block(FunctionalPoints::from_maps(in, out), npoints, deriv, alpha);
+}
+void LYP_CFunctional::compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha)
 {
     double A = parameters_["A"];
     double B = parameters_["B"];
@@ -70,17 +74,17 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
     double* tau_bp = NULL;
 
     if (true) {
-        rho_ap = in.find("RHO_A")->second->pointer();
-        rho_bp = in.find("RHO_B")->second->pointer();
+        rho_ap = points.in[FunctionalPoints::RHO_A];
+        rho_bp = points.in[FunctionalPoints::RHO_B];
     }
     if (gga_) {  
-        gamma_aap = in.find("GAMMA_AA")->second->pointer();
-        gamma_abp = in.find("GAMMA_AB")->second->pointer();
-        gamma_bbp = in.find("GAMMA_BB")->second->pointer();
+        gamma_aap = points.in[FunctionalPoints::GAMMA_AA];
+        gamma_abp = points.in[FunctionalPoints::GAMMA_AB];
+        gamma_bbp = points.in[FunctionalPoints::GAMMA_BB];
     } 
     if (meta_)  {
-        tau_ap = in.find("TAU_A")->second->pointer();
-        tau_bp = in.find("TAU_B")->second->pointer();
+        tau_ap = points.in[FunctionalPoints::TAU_A];
+        tau_bp = points.in[FunctionalPoints::TAU_B];
     }
 
     // => Outut variables <= //
@@ -125,63 +129,239 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
     double* v_gamma_bb_tau_b = NULL;
 
     if (deriv >= 0) {
-        v = out.find("V")->second->pointer();
+        v = points.out[FunctionalPoints::V];
     } 
     if (deriv >= 1) {
         if (true) {
-            v_rho_a = out.find("V_RHO_A")->second->pointer();
-            v_rho_b = out.find("V_RHO_B")->second->pointer();
+            v_rho_a = points.out[FunctionalPoints::V_RHO_A];
+            v_rho_b = points.out[FunctionalPoints::V_RHO_B];
         }
         if (gga_) {
-            v_gamma_aa = out.find("V_GAMMA_AA")->second->pointer();
-            v_gamma_ab = out.find("V_GAMMA_AB")->second->pointer();
-            v_gamma_bb = out.find("V_GAMMA_BB")->second->pointer();
+            v_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA];
+            v_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB];
+            v_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB];
         }
         if (meta_) {    
-            v_tau_a = out.find("V_TAU_A")->second->pointer();
-            v_tau_b = out.find("V_TAU_B")->second->pointer();
+            v_tau_a = points.out[FunctionalPoints::V_TAU_A];
+            v_tau_b = points.out[FunctionalPoints::V_TAU_B];
         }
     }
     if (deriv >= 2) {
         if (true) {
-            v_rho_a_rho_a = out.find("V_RHO_A_RHO_A")->second->pointer();
-            v_rho_a_rho_b = out.find("V_RHO_A_RHO_B")->second->pointer();
-            v_rho_b_rho_b = out.find("V_RHO_B_RHO_B")->second->pointer();
+            v_rho_a_rho_a = points.out[FunctionalPoints::V_RHO_A_RHO_A];
+            v_rho_a_rho_b = points.out[FunctionalPoints::V_RHO_A_RHO_B];
+            v_rho_b_rho_b = points.out[FunctionalPoints::V_RHO_B_RHO_B];
         }
         if (gga_) {
-            v_gamma_aa_gamma_aa = out.find("V_GAMMA_AA_GAMMA_AA")->second->pointer();
-            v_gamma_aa_gamma_ab = out.find("V_GAMMA_AA_GAMMA_AB")->second->pointer();
-            v_gamma_aa_gamma_bb = out.find("V_GAMMA_AA_GAMMA_BB")->second->pointer();
-            v_gamma_ab_gamma_ab = out.find("V_GAMMA_AB_GAMMA_AB")->second->pointer();
-            v_gamma_ab_gamma_bb = out.find("V_GAMMA_AB_GAMMA_BB")->second->pointer();
-            v_gamma_bb_gamma_bb = out.find("V_GAMMA_BB_GAMMA_BB")->second->pointer();
+            v_gamma_aa_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_AA];
+            v_gamma_aa_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_AB];
+            v_gamma_aa_gamma_bb = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_BB];
+            v_gamma_ab_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB_GAMMA_AB];
+            v_gamma_ab_gamma_bb = points.out[FunctionalPoints::V_GAMMA_AB_GAMMA_BB];
+            v_gamma_bb_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB_GAMMA_BB];
         }
         if (meta_) {
-            v_tau_a_tau_a = out.find("V_TAU_A_TAU_A")->second->pointer();
-            v_tau_a_tau_b = out.find("V_TAU_A_TAU_B")->second->pointer();
-            v_tau_b_tau_b = out.find("V_TAU_B_TAU_B")->second->pointer();
+            v_tau_a_tau_a = points.out[FunctionalPoints::V_TAU_A_TAU_A];
+            v_tau_a_tau_b = points.out[FunctionalPoints::V_TAU_A_TAU_B];
+            v_tau_b_tau_b = points.out[FunctionalPoints::V_TAU_B_TAU_B];
         }
         if (gga_) {
-            v_rho_a_gamma_aa = out.find("V_RHO_A_GAMMA_AA")->second->pointer();
-            v_rho_a_gamma_ab = out.find("V_RHO_A_GAMMA_AB")->second->pointer();
-            v_rho_a_gamma_bb = out.find("V_RHO_A_GAMMA_BB")->second->pointer();
-            v_rho_b_gamma_aa = out.find("V_RHO_B_GAMMA_AA")->second->pointer();
-            v_rho_b_gamma_ab = out.find("V_RHO_B_GAMMA_AB")->second->pointer();
-            v_rho_b_gamma_bb = out.find("V_RHO_B_GAMMA_BB")->second->pointer();
+            v_rho_a_gamma_aa = points.out[FunctionalPoints::V_RHO_A_GAMMA_AA];
+            v_rho_a_gamma_ab = points.out[FunctionalPoints::V_RHO_A_GAMMA_AB];
+            v_rho_a_gamma_bb = points.out[FunctionalPoints::V_RHO_A_GAMMA_BB];
+            v_rho_b_gamma_aa = points.out[FunctionalPoints::V_RHO_B_GAMMA_AA];
+            v_rho_b_gamma_ab = points.out[FunctionalPoints::V_RHO_B_GAMMA_AB];
+            v_rho_b_gamma_bb = points.out[FunctionalPoints::V_RHO_B_GAMMA_BB];
         }
         if (meta_) {
-            v_rho_a_tau_a = out.find("V_RHO_A_TAU_A")->second->pointer();
-            v_rho_a_tau_b = out.find("V_RHO_A_TAU_B")->second->pointer();
-            v_rho_b_tau_a = out.find("V_RHO_B_TAU_A")->second->pointer();
-            v_rho_b_tau_b = out.find("V_RHO_B_TAU_B")->second->pointer();
+            v_rho_a_tau_a = points.out[FunctionalPoints::V_RHO_A_TAU_A];
+            v_rho_a_tau_b = points.out[FunctionalPoints::V_RHO_A_TAU_B];
+            v_rho_b_tau_a = points.out[FunctionalPoints::V_RHO_B_TAU_A];
+            v_rho_b_tau_b = points.out[FunctionalPoints::V_RHO_B_TAU_B];
         }
         if (gga_ && meta_) {
-            v_gamma_aa_tau_a = out.find("V_GAMMA_AA_TAU_A")->second->pointer();
-            v_gamma_aa_tau_b = out.find("V_GAMMA_AA_TAU_B")->second->pointer();
-            v_gamma_ab_tau_a = out.find("V_GAMMA_AB_TAU_A")->second->pointer();
-            v_gamma_ab_tau_b = out.find("V_GAMMA_AB_TAU_B")->second->pointer();
-            v_gamma_bb_tau_a = out.find("V_GAMMA_BB_TAU_A")->second->pointer();
-            v_gamma_bb_tau_b = out.find("V_GAMMA_BB_TAU_B")->second->pointer();
+            v_gamma_aa_tau_a = points.out[FunctionalPoints::V_GAMMA_AA_TAU_A];
+            v_gamma_aa_tau_b = points.out[FunctionalPoints::V_GAMMA_AA_TAU_B];
+            v_gamma_ab_tau_a = points.out[FunctionalPoints::V_GAMMA_AB_TAU_A];
+            v_gamma_ab_tau_b = points.out[FunctionalPoints::V_GAMMA_AB_TAU_B];
+            v_gamma_bb_tau_a = points.out[FunctionalPoints::V_GAMMA_BB_TAU_A];
+            v_gamma_bb_tau_b = points.out[FunctionalPoints::V_GAMMA_BB_TAU_B];
+        }
+    }
+
+    // => Straight-line loop over points with both spins above the cutoff <= //
+
+    // Same expressions as the general branch of the loop below, for the
+    // value and first partials.  Points with either density below the
+    // cutoff are evaluated at a harmless dummy point and masked to zero,
+    // so the body has no switches and the loop can be vectorized.
+
+    double* restrict vp = v;
+    double* restrict v_rho_ap = v_rho_a;
+    double* restrict v_rho_bp = v_rho_b;
+    double* restrict v_gamma_aap = v_gamma_aa;
+    double* restrict v_gamma_abp = v_gamma_ab;
+    double* restrict v_gamma_bbp = v_gamma_bb;
+
+    for (int Q = 0; Q < npoints; Q++) {
+
+        bool on = (rho_ap[Q] >= lsda_cutoff_ && rho_bp[Q] >= lsda_cutoff_);
+        double mask = (on ? 1.0 : 0.0);
+        double rho_a = (on ? rho_ap[Q] : 1.0);
+        double rho_b = (on ? rho_bp[Q] : 1.0);
+        double gamma_aa = (on ? gamma_aap[Q] : 1.0);
+        double gamma_ab = (on ? gamma_abp[Q] : 1.0);
+        double gamma_bb = (on ? gamma_bbp[Q] : 1.0);
+
+        // v
+        if (deriv >= 0) {
+            double t11709 = rho_a+rho_b;
+            double t11710 = 1.0/pow(t11709,1.0/3.0);
+            double t11711 = Dd*t11710;
+            double t11712 = t11711+1.0;
+            double t11713 = 1.0/t11712;
+            double t11714 = t11709*t11709;
+            double t11715 = t11714*(2.0/3.0);
+            double t11716 = gamma_ab*2.0;
+            double t11717 = gamma_aa+gamma_bb+t11716;
+            double t11718 = 1.0/t11709;
+            vp[Q] += mask * scale * (A*rho_a*rho_b*t11713*t11718*-4.0-A*B*t11713*1.0/pow(t11709,1.1E1/3.0)*exp(-C*t11710)*(t11714*t11717*(-2.0/3.0)+gamma_aa*(t11715-rho_b*rho_b)+gamma_bb*(t11715-rho_a*rho_a)+rho_a*rho_b*((gamma_aa+gamma_bb)*(C*t11710*(1.0/1.8E1)+Dd*t11710*t11713*(1.0/1.8E1)-5.0/2.0)+CFext*(pow(rho_a,8.0/3.0)+pow(rho_b,8.0/3.0))-t11717*(C*t11710*(7.0/1.8E1)+Dd*t11710*t11713*(7.0/1.8E1)-4.7E1/1.8E1)-t11718*(gamma_aa*rho_a+gamma_bb*rho_b)*(C*t11710*(1.0/9.0)+Dd*t11710*t11713*(1.0/9.0)-1.1E1/9.0))));
+        }
+
+        // v_rho_a
+        if (deriv >= 1) {
+            double t11720 = rho_a+rho_b;
+            double t11721 = 1.0/pow(t11720,1.0/3.0);
+            double t11722 = Dd*t11721;
+            double t11723 = t11722+1.0;
+            double t11724 = 1.0/t11723;
+            double t11725 = t11720*t11720;
+            double t11726 = t11725*(2.0/3.0);
+            double t11727 = gamma_ab*2.0;
+            double t11728 = gamma_aa+gamma_bb+t11727;
+            double t11729 = 1.0/t11720;
+            double t11756 = C*t11721;
+            double t11730 = exp(-t11756);
+            double t11731 = C*t11721*(7.0/1.8E1);
+            double t11732 = Dd*t11721*t11724*(7.0/1.8E1);
+            double t11733 = t11731+t11732-4.7E1/1.8E1;
+            double t11734 = t11733*t11728;
+            double t11735 = gamma_aa+gamma_bb;
+            double t11736 = C*t11721*(1.0/1.8E1);
+            double t11737 = Dd*t11721*t11724*(1.0/1.8E1);
+            double t11738 = t11736+t11737-5.0/2.0;
+            double t11739 = pow(rho_a,8.0/3.0);
+            double t11740 = pow(rho_b,8.0/3.0);
+            double t11741 = t11740+t11739;
+            double t11742 = gamma_aa*rho_a;
+            double t11743 = gamma_bb*rho_b;
+            double t11744 = t11742+t11743;
+            double t11745 = C*t11721*(1.0/9.0);
+            double t11746 = Dd*t11721*t11724*(1.0/9.0);
+            double t11747 = t11745+t11746-1.1E1/9.0;
+            double t11748 = t11744*t11729*t11747;
+            double t11764 = t11735*t11738;
+            double t11765 = CFext*t11741;
+            double t11749 = t11734-t11764-t11765+t11748;
+            double t11750 = rho_b*(4.0/3.0);
+            double t11751 = 1.0/pow(t11720,4.0/3.0);
+            double t11752 = 1.0/(t11723*t11723);
+            double t11753 = Dd*Dd;
+            double t11754 = 1.0/pow(t11720,5.0/3.0);
+            double t11755 = 1.0/(t11720*t11720);
+            double t11757 = rho_b*rho_b;
+            double t11758 = t11726-t11757;
+            double t11759 = gamma_aa*t11758;
+            double t11760 = rho_a*rho_a;
+            double t11761 = t11760-t11726;
+            double t11762 = gamma_bb*t11761;
+            double t11763 = t11725*t11728*(2.0/3.0);
+            double t11766 = rho_a*rho_b*t11749;
+            double t11767 = 1.0/(t11720*t11720*t11720*t11720*t11720);
+            v_rho_ap[Q] += mask * scale * (A*rho_b*t11724*t11729*-4.0+A*rho_a*rho_b*t11724*t11755*4.0-A*Dd*rho_a*rho_b*1.0/pow(t11720,7.0/3.0)*t11752*(4.0/3.0)-A*B*1.0/pow(t11720,1.4E1/3.0)*t11730*t11724*(t11762+t11763+t11766-t11759)*(1.1E1/3.0)+A*B*1.0/pow(t11720,1.1E1/3.0)*t11730*t11724*(rho_b*t11749-gamma_aa*(rho_a*(4.0/3.0)+t11750)+gamma_bb*(rho_a*(2.0/3.0)-t11750)+t11728*(rho_a*2.0+rho_b*2.0)*(2.0/3.0)-rho_a*rho_b*(CFext*pow(rho_a,5.0/3.0)*(8.0/3.0)-t11735*(C*t11751*(1.0/5.4E1)+Dd*t11724*t11751*(1.0/5.4E1)-t11752*t11753*t11754*(1.0/5.4E1))+t11728*(C*t11751*(7.0/5.4E1)+Dd*t11724*t11751*(7.0/5.4E1)-t11752*t11753*t11754*(7.0/5.4E1))+t11744*t11729*(C*t11751*(1.0/2.7E1)+Dd*t11724*t11751*(1.0/2.7E1)-t11752*t11753*t11754*(1.0/2.7E1))-gamma_aa*t11729*t11747+t11744*t11755*t11747))+A*B*C*t11730*t11724*t11767*(t11762+t11763+t11766-t11759)*(1.0/3.0)+A*B*Dd*t11730*t11752*t11767*(t11762+t11763+t11766-t11759)*(1.0/3.0));
+        }
+
+        // v_rho_b
+        if (deriv >= 1) {
+            double t11769 = rho_a+rho_b;
+            double t11770 = 1.0/pow(t11769,1.0/3.0);
+            double t11771 = Dd*t11770;
+            double t11772 = t11771+1.0;
+            double t11773 = 1.0/t11772;
+            double t11774 = t11769*t11769;
+            double t11775 = t11774*(2.0/3.0);
+            double t11776 = gamma_ab*2.0;
+            double t11777 = gamma_aa+gamma_bb+t11776;
+            double t11778 = 1.0/t11769;
+            double t11805 = C*t11770;
+            double t11779 = exp(-t11805);
+            double t11780 = C*t11770*(7.0/1.8E1);
+            double t11781 = Dd*t11770*t11773*(7.0/1.8E1);
+            double t11782 = t11780+t11781-4.7E1/1.8E1;
+            double t11783 = t11782*t11777;
+            double t11784 = gamma_aa+gamma_bb;
+            double t11785 = C*t11770*(1.0/1.8E1);
+            double t11786 = Dd*t11770*t11773*(1.0/1.8E1);
+            double t11787 = t11785+t11786-5.0/2.0;
+            double t11788 = pow(rho_a,8.0/3.0);
+            double t11789 = pow(rho_b,8.0/3.0);
+            double t11790 = t11788+t11789;
+            double t11791 = gamma_aa*rho_a;
+            double t11792 = gamma_bb*rho_b;
+            double t11793 = t11791+t11792;
+            double t11794 = C*t11770*(1.0/9.0);
+            double t11795 = Dd*t11770*t11773*(1.0/9.0);
+            double t11796 = t11794+t11795-1.1E1/9.0;
+            double t11797 = t11793*t11778*t11796;
+            double t11813 = t11784*t11787;
+            double t11814 = CFext*t11790;
+            double t11798 = -t11813-t11814+t11783+t11797;
+            double t11799 = rho_a*(4.0/3.0);
+            double t11800 = 1.0/pow(t11769,4.0/3.0);
+            double t11801 = 1.0/(t11772*t11772);
+            double t11802 = Dd*Dd;
+            double t11803 = 1.0/pow(t11769,5.0/3.0);
+            double t11804 = 1.0/(t11769*t11769);
+            double t11806 = rho_b*rho_b;
+            double t11807 = t11806-t11775;
+            double t11808 = gamma_aa*t11807;
+            double t11809 = rho_a*rho_a;
+            double t11810 = t11809-t11775;
+            double t11811 = gamma_bb*t11810;
+            double t11812 = t11774*t11777*(2.0/3.0);
+            double t11815 = rho_a*rho_b*t11798;
+            double t11816 = 1.0/(t11769*t11769*t11769*t11769*t11769);
+            v_rho_bp[Q] += mask * scale * (A*rho_a*t11773*t11778*-4.0+A*rho_a*rho_b*t11804*t11773*4.0-A*Dd*rho_a*rho_b*t11801*1.0/pow(t11769,7.0/3.0)*(4.0/3.0)-A*B*t11773*1.0/pow(t11769,1.4E1/3.0)*t11779*(t11811+t11812+t11815+t11808)*(1.1E1/3.0)+A*B*t11773*1.0/pow(t11769,1.1E1/3.0)*t11779*(rho_a*t11798-gamma_bb*(rho_b*(4.0/3.0)+t11799)+gamma_aa*(rho_b*(2.0/3.0)-t11799)+t11777*(rho_a*2.0+rho_b*2.0)*(2.0/3.0)-rho_a*rho_b*(CFext*pow(rho_b,5.0/3.0)*(8.0/3.0)-t11784*(C*t11800*(1.0/5.4E1)+Dd*t11800*t11773*(1.0/5.4E1)-t11801*t11802*t11803*(1.0/5.4E1))+t11777*(C*t11800*(7.0/5.4E1)+Dd*t11800*t11773*(7.0/5.4E1)-t11801*t11802*t11803*(7.0/5.4E1))+t11793*t11778*(C*t11800*(1.0/2.7E1)+Dd*t11800*t11773*(1.0/2.7E1)-t11801*t11802*t11803*(1.0/2.7E1))-gamma_bb*t11778*t11796+t11804*t11793*t11796))+A*B*C*t11816*t11773*t11779*(t11811+t11812+t11815+t11808)*(1.0/3.0)+A*B*Dd*t11801*t11816*t11779*(t11811+t11812+t11815+t11808)*(1.0/3.0));
+        }
+
+        // v_gamma_aa
+        if (deriv >= 1) {
+            double t11818 = rho_a+rho_b;
+            double t11819 = 1.0/pow(t11818,1.0/3.0);
+            double t11820 = Dd*t11819;
+            double t11821 = t11820+1.0;
+            double t11822 = 1.0/t11821;
+            v_gamma_aap[Q] += mask * scale * (A*B*t11822*1.0/pow(t11818,1.1E1/3.0)*exp(-C*t11819)*(rho_b*rho_b+rho_a*rho_b*(C*t11819*(1.0/3.0)+Dd*t11822*t11819*(1.0/3.0)+(rho_a*(C*t11819*(1.0/9.0)+Dd*t11822*t11819*(1.0/9.0)-1.1E1/9.0))/t11818-1.0/9.0)));
+        }
+
+        // v_gamma_ab
+        if (deriv >= 1) {
+            double t11824 = rho_a+rho_b;
+            double t11825 = 1.0/pow(t11824,1.0/3.0);
+            double t11826 = Dd*t11825;
+            double t11827 = t11826+1.0;
+            double t11828 = 1.0/t11827;
+            v_gamma_abp[Q] += mask * scale * (A*B*1.0/pow(t11824,1.1E1/3.0)*t11828*exp(-C*t11825)*((t11824*t11824)*(4.0/3.0)+rho_a*rho_b*(C*t11825*(7.0/9.0)+Dd*t11825*t11828*(7.0/9.0)-4.7E1/9.0)));
+        }
+
+        // v_gamma_bb
+        if (deriv >= 1) {
+            double t11830 = rho_a+rho_b;
+            double t11831 = 1.0/pow(t11830,1.0/3.0);
+            double t11832 = Dd*t11831;
+            double t11833 = t11832+1.0;
+            double t11834 = 1.0/t11833;
+            v_gamma_bbp[Q] += mask * scale * (A*B*1.0/pow(t11830,1.1E1/3.0)*t11834*exp(-C*t11831)*(rho_a*rho_a+rho_a*rho_b*(C*t11831*(1.0/3.0)+Dd*t11831*t11834*(1.0/3.0)+(rho_b*(C*t11831*(1.0/9.0)+Dd*t11831*t11834*(1.0/9.0)-1.1E1/9.0))/t11830-1.0/9.0)));
         }
     }
 
@@ -218,157 +398,8 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
         } else if (rho_a < lsda_cutoff_) {
         } else if (rho_b < lsda_cutoff_) {
         } else {
-            // v
-            if (deriv >= 0) {
-                double t11709 = rho_a+rho_b;
-                double t11710 = 1.0/pow(t11709,1.0/3.0);
-                double t11711 = Dd*t11710;
-                double t11712 = t11711+1.0;
-                double t11713 = 1.0/t11712;
-                double t11714 = t11709*t11709;
-                double t11715 = t11714*(2.0/3.0);
-                double t11716 = gamma_ab*2.0;
-                double t11717 = gamma_aa+gamma_bb+t11716;
-                double t11718 = 1.0/t11709;
-                v[Q] += scale * (A*rho_a*rho_b*t11713*t11718*-4.0-A*B*t11713*1.0/pow(t11709,1.1E1/3.0)*exp(-C*t11710)*(t11714*t11717*(-2.0/3.0)+gamma_aa*(t11715-rho_b*rho_b)+gamma_bb*(t11715-rho_a*rho_a)+rho_a*rho_b*((gamma_aa+gamma_bb)*(C*t11710*(1.0/1.8E1)+Dd*t11710*t11713*(1.0/1.8E1)-5.0/2.0)+CFext*(pow(rho_a,8.0/3.0)+pow(rho_b,8.0/3.0))-t11717*(C*t11710*(7.0/1.8E1)+Dd*t11710*t11713*(7.0/1.8E1)-4.7E1/1.8E1)-t11718*(gamma_aa*rho_a+gamma_bb*rho_b)*(C*t11710*(1.0/9.0)+Dd*t11710*t11713*(1.0/9.0)-1.1E1/9.0))));
-            }
-            
-            // v_rho_a
-            if (deriv >= 1) {
-                double t11720 = rho_a+rho_b;
-                double t11721 = 1.0/pow(t11720,1.0/3.0);
-                double t11722 = Dd*t11721;
-                double t11723 = t11722+1.0;
-                double t11724 = 1.0/t11723;
-                double t11725 = t11720*t11720;
-                double t11726 = t11725*(2.0/3.0);
-                double t11727 = gamma_ab*2.0;
-                double t11728 = gamma_aa+gamma_bb+t11727;
-                double t11729 = 1.0/t11720;
-                double t11756 = C*t11721;
-                double t11730 = exp(-t11756);
-                double t11731 = C*t11721*(7.0/1.8E1);
-                double t11732 = Dd*t11721*t11724*(7.0/1.8E1);
-                double t11733 = t11731+t11732-4.7E1/1.8E1;
-                double t11734 = t11733*t11728;
-                double t11735 = gamma_aa+gamma_bb;
-                double t11736 = C*t11721*(1.0/1.8E1);
-                double t11737 = Dd*t11721*t11724*(1.0/1.8E1);
-                double t11738 = t11736+t11737-5.0/2.0;
-                double t11739 = pow(rho_a,8.0/3.0);
-                double t11740 = pow(rho_b,8.0/3.0);
-                double t11741 = t11740+t11739;
-                double t11742 = gamma_aa*rho_a;
-                double t11743 = gamma_bb*rho_b;
-                double t11744 = t11742+t11743;
-                double t11745 = C*t11721*(1.0/9.0);
-                double t11746 = Dd*t11721*t11724*(1.0/9.0);
-                double t11747 = t11745+t11746-1.1E1/9.0;
-                double t11748 = t11744*t11729*t11747;
-                double t11764 = t11735*t11738;
-                double t11765 = CFext*t11741;
-                double t11749 = t11734-t11764-t11765+t11748;
-                double t11750 = rho_b*(4.0/3.0);
-                double t11751 = 1.0/pow(t11720,4.0/3.0);
-                double t11752 = 1.0/(t11723*t11723);
-                double t11753 = Dd*Dd;
-                double t11754 = 1.0/pow(t11720,5.0/3.0);
-                double t11755 = 1.0/(t11720*t11720);
-                double t11757 = rho_b*rho_b;
-                double t11758 = t11726-t11757;
-                double t11759 = gamma_aa*t11758;
-                double t11760 = rho_a*rho_a;
-                double t11761 = t11760-t11726;
-                double t11762 = gamma_bb*t11761;
-                double t11763 = t11725*t11728*(2.0/3.0);
-                double t11766 = rho_a*rho_b*t11749;
-                double t11767 = 1.0/(t11720*t11720*t11720*t11720*t11720);
-                v_rho_a[Q] += scale * (A*rho_b*t11724*t11729*-4.0+A*rho_a*rho_b*t11724*t11755*4.0-A*Dd*rho_a*rho_b*1.0/pow(t11720,7.0/3.0)*t11752*(4.0/3.0)-A*B*1.0/pow(t11720,1.4E1/3.0)*t11730*t11724*(t11762+t11763+t11766-t11759)*(1.1E1/3.0)+A*B*1.0/pow(t11720,1.1E1/3.0)*t11730*t11724*(rho_b*t11749-gamma_aa*(rho_a*(4.0/3.0)+t11750)+gamma_bb*(rho_a*(2.0/3.0)-t11750)+t11728*(rho_a*2.0+rho_b*2.0)*(2.0/3.0)-rho_a*rho_b*(CFext*pow(rho_a,5.0/3.0)*(8.0/3.0)-t11735*(C*t11751*(1.0/5.4E1)+Dd*t11724*t11751*(1.0/5.4E1)-t11752*t11753*t11754*(1.0/5.4E1))+t11728*(C*t11751*(7.0/5.4E1)+Dd*t11724*t11751*(7.0/5.4E1)-t11752*t11753*t11754*(7.0/5.4E1))+t11744*t11729*(C*t11751*(1.0/2.7E1)+Dd*t11724*t11751*(1.0/2.7E1)-t11752*t11753*t11754*(1.0/2.7E1))-gamma_aa*t11729*t11747+t11744*t11755*t11747))+A*B*C*t11730*t11724*t11767*(t11762+t11763+t11766-t11759)*(1.0/3.0)+A*B*Dd*t11730*t11752*t11767*(t11762+t11763+t11766-t11759)*(1.0/3.0));
-            }
-            
-            // v_rho_b
-            if (deriv >= 1) {
-                double t11769 = rho_a+rho_b;
-                double t11770 = 1.0/pow(t11769,1.0/3.0);
-                double t11771 = Dd*t11770;
-                double t11772 = t11771+1.0;
-                double t11773 = 1.0/t11772;
-                double t11774 = t11769*t11769;
-                double t11775 = t11774*(2.0/3.0);
-                double t11776 = gamma_ab*2.0;
-                double t11777 = gamma_aa+gamma_bb+t11776;
-                double t11778 = 1.0/t11769;
-                double t11805 = C*t11770;
-                double t11779 = exp(-t11805);
-                double t11780 = C*t11770*(7.0/1.8E1);
-                double t11781 = Dd*t11770*t11773*(7.0/1.8E1);
-                double t11782 = t11780+t11781-4.7E1/1.8E1;
-                double t11783 = t11782*t11777;
-                double t11784 = gamma_aa+gamma_bb;
-                double t11785 = C*t11770*(1.0/1.8E1);
-                double t11786 = Dd*t11770*t11773*(1.0/1.8E1);
-                double t11787 = t11785+t11786-5.0/2.0;
-                double t11788 = pow(rho_a,8.0/3.0);
-                double t11789 = pow(rho_b,8.0/3.0);
-                double t11790 = t11788+t11789;
-                double t11791 = gamma_aa*rho_a;
-                double t11792 = gamma_bb*rho_b;
-                double t11793 = t11791+t11792;
-                double t11794 = C*t11770*(1.0/9.0);
-                double t11795 = Dd*t11770*t11773*(1.0/9.0);
-                double t11796 = t11794+t11795-1.1E1/9.0;
-                double t11797 = t11793*t11778*t11796;
-                double t11813 = t11784*t11787;
-                double t11814 = CFext*t11790;
-                double t11798 = -t11813-t11814+t11783+t11797;
-                double t11799 = rho_a*(4.0/3.0);
-                double t11800 = 1.0/pow(t11769,4.0/3.0);
-                double t11801 = 1.0/(t11772*t11772);
-                double t11802 = Dd*Dd;
-                double t11803 = 1.0/pow(t11769,5.0/3.0);
-                double t11804 = 1.0/(t11769*t11769);
-                double t11806 = rho_b*rho_b;
-                double t11807 = t11806-t11775;
-                double t11808 = gamma_aa*t11807;
-                double t11809 = rho_a*rho_a;
-                double t11810 = t11809-t11775;
-                double t11811 = gamma_bb*t11810;
-                double t11812 = t11774*t11777*(2.0/3.0);
-                double t11815 = rho_a*rho_b*t11798;
-                double t11816 = 1.0/(t11769*t11769*t11769*t11769*t11769);
-                v_rho_b[Q] += scale * (A*rho_a*t11773*t11778*-4.0+A*rho_a*rho_b*t11804*t11773*4.0-A*Dd*rho_a*rho_b*t11801*1.0/pow(t11769,7.0/3.0)*(4.0/3.0)-A*B*t11773*1.0/pow(t11769,1.4E1/3.0)*t11779*(t11811+t11812+t11815+t11808)*(1.1E1/3.0)+A*B*t11773*1.0/pow(t11769,1.1E1/3.0)*t11779*(rho_a*t11798-gamma_bb*(rho_b*(4.0/3.0)+t11799)+gamma_aa*(rho_b*(2.0/3.0)-t11799)+t11777*(rho_a*2.0+rho_b*2.0)*(2.0/3.0)-rho_a*rho_b*(CFext*pow(rho_b,5.0/3.0)*(8.0/3.0)-t11784*(C*t11800*(1.0/5.4E1)+Dd*t11800*t11773*(1.0/5.4E1)-t11801*t11802*t11803*(1.0/5.4E1))+t11777*(C*t11800*(7.0/5.4E1)+Dd*t11800*t11773*(7.0/5.4E1)-t11801*t11802*t11803*(7.0/5.4E1))+t11793*t11778*(C*t11800*(1.0/2.7E1)+Dd*t11800*t11773*(1.0/2.7E1)-t11801*t11802*t11803*(1.0/2.7E1))-gamma_bb*t11778*t11796+t11804*t11793*t11796))+A*B*C*t11816*t11773*t11779*(t11811+t11812+t11815+t11808)*(1.0/3.0)+A*B*Dd*t11801*t11816*t11779*(t11811+t11812+t11815+t11808)*(1.0/3.0));
-            }
-            
-            // v_gamma_aa
-            if (deriv >= 1) {
-                double t11818 = rho_a+rho_b;
-                double t11819 = 1.0/pow(t11818,1.0/3.0);
-                double t11820 = Dd*t11819;
-                double t11821 = t11820+1.0;
-                double t11822 = 1.0/t11821;
-                v_gamma_aa[Q] += scale * (A*B*t11822*1.0/pow(t11818,1.1E1/3.0)*exp(-C*t11819)*(rho_b*rho_b+rho_a*rho_b*(C*t11819*(1.0/3.0)+Dd*t11822*t11819*(1.0/3.0)+(rho_a*(C*t11819*(1.0/9.0)+Dd*t11822*t11819*(1.0/9.0)-1.1E1/9.0))/t11818-1.0/9.0)));
-            }
-            
-            // v_gamma_ab
-            if (deriv >= 1) {
-                double t11824 = rho_a+rho_b;
-                double t11825 = 1.0/pow(t11824,1.0/3.0);
-                double t11826 = Dd*t11825;
-                double t11827 = t11826+1.0;
-                double t11828 = 1.0/t11827;
-                v_gamma_ab[Q] += scale * (A*B*1.0/pow(t11824,1.1E1/3.0)*t11828*exp(-C*t11825)*((t11824*t11824)*(4.0/3.0)+rho_a*rho_b*(C*t11825*(7.0/9.0)+Dd*t11825*t11828*(7.0/9.0)-4.7E1/9.0)));
-            }
-            
-            // v_gamma_bb
-            if (deriv >= 1) {
-                double t11830 = rho_a+rho_b;
-                double t11831 = 1.0/pow(t11830,1.0/3.0);
-                double t11832 = Dd*t11831;
-                double t11833 = t11832+1.0;
-                double t11834 = 1.0/t11833;
-                v_gamma_bb[Q] += scale * (A*B*1.0/pow(t11830,1.1E1/3.0)*t11834*exp(-C*t11831)*(rho_a*rho_a+rho_a*rho_b*(C*t11831*(1.0/3.0)+Dd*t11831*t11834*(1.0/3.0)+(rho_b*(C*t11831*(1.0/9.0)+Dd*t11831*t11834*(1.0/9.0)-1.1E1/9.0))/t11830-1.0/9.0)));
-            }
-            
+            // v and the first partials are done in the loop above
+
             // v_rho_a_rho_a
             if (deriv >= 2) {
                 double t11838 = rho_a+rho_b;
@@ -462,7 +493,7 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
                 double t11926 = 1.0/pow(t11838,1.9E1/3.0);
                 v_rho_a_rho_a[Q] += scale * (A*rho_b*t11842*t11873*8.0-A*Dd*rho_b*t11891*t11847*(8.0/3.0)-A*rho_a*rho_b*t11842*t11892*8.0+A*Dd*rho_a*rho_b*1.0/pow(t11838,1.0E1/3.0)*t11847*(4.0E1/9.0)-A*B*t11912*t11842*1.0/pow(t11838,1.4E1/3.0)*t11848*(2.2E1/3.0)-A*B*t11922*t11842*1.0/pow(t11838,1.7E1/3.0)*t11848*(1.54E2/9.0)+A*B*t11842*t11848*t11875*(gamma_ab*(8.0/3.0)+gamma_bb*2.0-rho_b*t11890*2.0-rho_a*rho_b*(CFext*pow(rho_a,2.0/3.0)*(4.0E1/9.0)+t11853*(C*t11891*(2.0/8.1E1)+Dd*t11842*t11891*(2.0/8.1E1)-t11871*t11847*t11894*(1.0/2.7E1)+Dd*t11871*t11892*t11893*(1.0/8.1E1))-t11846*(C*t11891*(1.4E1/8.1E1)+Dd*t11842*t11891*(1.4E1/8.1E1)-t11871*t11847*t11894*(7.0/2.7E1)+Dd*t11871*t11892*t11893*(7.0/8.1E1))-t11860*t11863*(C*t11891*(4.0/8.1E1)+Dd*t11842*t11891*(4.0/8.1E1)-t11871*t11847*t11894*(2.0/2.7E1)+Dd*t11871*t11892*t11893*(2.0/8.1E1))+gamma_aa*t11860*t11887*2.0+gamma_aa*t11873*t11866*2.0-t11863*t11892*t11866*2.0-t11863*t11873*t11887*2.0))-A*rho_a*rho_b*t11871*t11875*t11893*(8.0/9.0)-A*B*t11922*t11871*t11926*t11848*t11893*(2.0/9.0)-A*B*(C*C)*t11922*t11842*t11926*t11848*(1.0/9.0)+A*B*C*t11912*t11913*t11842*t11848*(2.0/3.0)+A*B*C*t11922*t11842*t11923*t11848*(2.6E1/9.0)+A*B*Dd*t11912*t11913*t11847*t11848*(2.0/3.0)+A*B*Dd*t11922*t11923*t11847*t11848*(2.6E1/9.0)-A*B*C*Dd*t11922*t11926*t11847*t11848*(2.0/9.0));
             }
-            
+
             // v_rho_a_rho_b
             if (deriv >= 2) {
                 double t11928 = rho_a+rho_b;
@@ -568,7 +599,7 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
                 double t12028 = 1.0/pow(t11928,1.9E1/3.0);
                 v_rho_a_rho_b[Q] += scale * (A*t11940*t11932*-4.0+A*rho_a*t11932*t11933*4.0+A*rho_b*t11932*t11933*4.0-A*Dd*rho_a*t11934*t11935*(4.0/3.0)-A*Dd*rho_b*t11934*t11935*(4.0/3.0)-A*rho_a*rho_b*t11932*t11974*8.0+A*Dd*rho_a*rho_b*t11935*1.0/pow(t11928,1.0E1/3.0)*(4.0E1/9.0)-A*B*t11932*t11941*1.0/pow(t11928,1.7E1/3.0)*(t12020+t12023-t11936*t11939*(2.0/3.0)-rho_a*rho_b*(t11945+t11978-CFext*t11973-t11970*t11946))*(1.54E2/9.0)-A*B*t11932*t11941*t11997*(gamma_ab*(-8.0/3.0)+t11980-t11945+t11981-t11978+rho_a*t11987+rho_b*(t11962+t11966+t11967+t11996-t11946*t11958-gamma_bb*t11940*t11952)+rho_a*rho_b*(t11946*(C*t11934*(2.0/8.1E1)+Dd*t11932*t11934*(2.0/8.1E1)-t11935*t11948*t11976*(1.0/2.7E1)+Dd*t11974*t11948*t11975*(1.0/8.1E1))-t11939*(C*t11934*(1.4E1/8.1E1)+Dd*t11932*t11934*(1.4E1/8.1E1)-t11935*t11948*t11976*(7.0/2.7E1)+Dd*t11974*t11948*t11975*(7.0/8.1E1))-t11940*t11955*(C*t11934*(4.0/8.1E1)+Dd*t11932*t11934*(4.0/8.1E1)-t11935*t11948*t11976*(2.0/2.7E1)+Dd*t11974*t11948*t11975*(2.0/8.1E1))+gamma_aa*t11933*t11952+gamma_aa*t11940*t11965+gamma_bb*t11933*t11952+gamma_bb*t11940*t11965-t11933*t11955*t11965*2.0-t11952*t11955*t11974*2.0))+A*B*t11932*t11941*t11988*t12006*(1.1E1/3.0)+A*B*t11932*t11941*t11988*(t12011+t12012+t12014+t12015-t11991*t11939*(2.0/3.0))*(1.1E1/3.0)-A*rho_a*rho_b*t11948*t11975*t11997*(8.0/9.0)-A*B*t11941*t11948*t11975*t12026*t12028*(2.0/9.0)-A*B*(C*C)*t11932*t11941*t12026*t12028*(1.0/9.0)-A*B*C*t11932*t11941*t12006*t12007*(1.0/3.0)+A*B*C*t11932*t11941*t12024*t12026*(2.6E1/9.0)-A*B*C*t11932*t11941*t12007*t12017*(1.0/3.0)-A*B*Dd*t11941*t11935*t12006*t12007*(1.0/3.0)+A*B*Dd*t11941*t11935*t12024*t12026*(2.6E1/9.0)-A*B*Dd*t11941*t11935*t12007*t12017*(1.0/3.0)-A*B*C*Dd*t11941*t11935*t12026*t12028*(2.0/9.0));
             }
-            
+
             // v_rho_b_rho_b
             if (deriv >= 2) {
                 double t12030 = rho_a+rho_b;
@@ -662,7 +693,7 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
                 double t12118 = 1.0/pow(t12030,1.9E1/3.0);
                 v_rho_b_rho_b[Q] += scale * (A*rho_a*t12034*t12065*8.0-A*Dd*rho_a*t12083*t12039*(8.0/3.0)-A*rho_a*rho_b*t12034*t12084*8.0+A*Dd*rho_a*rho_b*1.0/pow(t12030,1.0E1/3.0)*t12039*(4.0E1/9.0)+A*B*1.0/pow(t12030,1.4E1/3.0)*t12040*t12034*t12106*(2.2E1/3.0)+A*B*1.0/pow(t12030,1.7E1/3.0)*t12040*t12034*t12116*(1.54E2/9.0)+A*B*t12040*t12034*t12067*(gamma_aa*2.0+gamma_ab*(8.0/3.0)-rho_a*t12082*2.0-rho_a*rho_b*(CFext*pow(rho_b,2.0/3.0)*(4.0E1/9.0)+t12045*(C*t12083*(2.0/8.1E1)+Dd*t12034*t12083*(2.0/8.1E1)-t12063*t12039*t12086*(1.0/2.7E1)+Dd*t12063*t12084*t12085*(1.0/8.1E1))-t12038*(C*t12083*(1.4E1/8.1E1)+Dd*t12034*t12083*(1.4E1/8.1E1)-t12063*t12039*t12086*(7.0/2.7E1)+Dd*t12063*t12084*t12085*(7.0/8.1E1))-t12052*t12055*(C*t12083*(4.0/8.1E1)+Dd*t12034*t12083*(4.0/8.1E1)-t12063*t12039*t12086*(2.0/2.7E1)+Dd*t12063*t12084*t12085*(2.0/8.1E1))+gamma_bb*t12052*t12079*2.0+gamma_bb*t12065*t12058*2.0-t12055*t12084*t12058*2.0-t12055*t12065*t12079*2.0))-A*rho_a*rho_b*t12063*t12067*t12085*(8.0/9.0)+A*B*t12040*t12063*t12118*t12085*(-t12110+t12113+t12114+t12115)*(2.0/9.0)+A*B*(C*C)*t12040*t12034*t12118*(-t12110+t12113+t12114+t12115)*(1.0/9.0)-A*B*C*t12040*t12034*t12106*t12107*(2.0/3.0)-A*B*C*t12040*t12034*t12116*t12117*(2.6E1/9.0)-A*B*Dd*t12040*t12106*t12107*t12039*(2.0/3.0)-A*B*Dd*t12040*t12116*t12117*t12039*(2.6E1/9.0)+A*B*C*Dd*t12040*t12118*t12039*(-t12110+t12113+t12114+t12115)*(2.0/9.0));
             }
-            
+
             // v_rho_a_gamma_aa
             if (deriv >= 2) {
                 double t12120 = rho_a+rho_b;
@@ -690,7 +721,7 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
                 double t12142 = 1.0/(t12120*t12120*t12120*t12120*t12120);
                 v_rho_a_gamma_aa[Q] += scale * (A*B*1.0/pow(t12120,1.4E1/3.0)*t12141*t12124*t12125*(-1.1E1/3.0)+A*B*1.0/pow(t12120,1.1E1/3.0)*t12124*t12125*(rho_b*t12133-rho_a*rho_b*(C*t12134*(1.0/9.0)-t12131*t12128+rho_a*t12128*(C*t12134*(1.0/2.7E1)+Dd*t12124*t12134*(1.0/2.7E1)-t12135*t12136*t12137*(1.0/2.7E1))+rho_a*1.0/(t12120*t12120)*t12131+Dd*t12124*t12134*(1.0/9.0)-t12135*t12136*t12137*(1.0/9.0)))+A*B*C*t12141*t12124*t12142*t12125*(1.0/3.0)+A*B*Dd*t12141*t12142*t12125*t12137*(1.0/3.0));
             }
-            
+
             // v_rho_a_gamma_ab
             if (deriv >= 2) {
                 double t12144 = rho_a+rho_b;
@@ -712,7 +743,7 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
                 double t12160 = 1.0/(t12147*t12147);
                 v_rho_a_gamma_ab[Q] += scale * (A*B*1.0/pow(t12144,1.4E1/3.0)*t12148*t12149*t12158*(-1.1E1/3.0)+A*B*1.0/pow(t12144,1.1E1/3.0)*t12148*t12149*(rho_a*(8.0/3.0)+rho_b*(8.0/3.0)+rho_b*t12152-rho_a*rho_b*(C*t12153*(7.0/2.7E1)-(Dd*Dd)*t12160*1.0/pow(t12144,5.0/3.0)*(7.0/2.7E1)+Dd*t12153*t12148*(7.0/2.7E1)))+A*B*C*t12148*t12149*t12158*t12159*(1.0/3.0)+A*B*Dd*t12160*t12149*t12158*t12159*(1.0/3.0));
             }
-            
+
             // v_rho_a_gamma_bb
             if (deriv >= 2) {
                 double t12162 = rho_a+rho_b;
@@ -740,7 +771,7 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
                 double t12184 = 1.0/(t12162*t12162*t12162*t12162*t12162);
                 v_rho_a_gamma_bb[Q] += scale * (A*B*1.0/pow(t12162,1.4E1/3.0)*t12183*t12166*t12167*(-1.1E1/3.0)+A*B*1.0/pow(t12162,1.1E1/3.0)*t12166*t12167*(rho_a*2.0+rho_b*t12175-rho_a*rho_b*(C*t12176*(1.0/9.0)+rho_b*t12170*(C*t12176*(1.0/2.7E1)+Dd*t12166*t12176*(1.0/2.7E1)-t12177*t12178*t12179*(1.0/2.7E1))+rho_b*1.0/(t12162*t12162)*t12173+Dd*t12166*t12176*(1.0/9.0)-t12177*t12178*t12179*(1.0/9.0)))+A*B*C*t12183*t12166*t12184*t12167*(1.0/3.0)+A*B*Dd*t12183*t12184*t12167*t12179*(1.0/3.0));
             }
-            
+
             // v_rho_b_gamma_aa
             if (deriv >= 2) {
                 double t12186 = rho_a+rho_b;
@@ -768,7 +799,7 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
                 double t12208 = 1.0/(t12186*t12186*t12186*t12186*t12186);
                 v_rho_b_gamma_aa[Q] += scale * (A*B*t12207*t12190*t12191*1.0/pow(t12186,1.4E1/3.0)*(-1.1E1/3.0)+A*B*t12190*t12191*1.0/pow(t12186,1.1E1/3.0)*(rho_b*2.0+rho_a*t12199-rho_a*rho_b*(C*t12200*(1.0/9.0)+rho_a*t12194*(C*t12200*(1.0/2.7E1)+Dd*t12200*t12190*(1.0/2.7E1)-t12201*t12202*t12203*(1.0/2.7E1))+rho_a*1.0/(t12186*t12186)*t12197+Dd*t12200*t12190*(1.0/9.0)-t12201*t12202*t12203*(1.0/9.0)))+A*B*C*t12207*t12190*t12208*t12191*(1.0/3.0)+A*B*Dd*t12203*t12207*t12208*t12191*(1.0/3.0));
             }
-            
+
             // v_rho_b_gamma_ab
             if (deriv >= 2) {
                 double t12210 = rho_a+rho_b;
@@ -790,7 +821,7 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
                 double t12226 = 1.0/(t12213*t12213);
                 v_rho_b_gamma_ab[Q] += scale * (A*B*1.0/pow(t12210,1.4E1/3.0)*t12214*t12215*t12224*(-1.1E1/3.0)+A*B*1.0/pow(t12210,1.1E1/3.0)*t12214*t12215*(rho_a*(8.0/3.0)+rho_b*(8.0/3.0)+rho_a*t12218-rho_a*rho_b*(C*t12219*(7.0/2.7E1)-(Dd*Dd)*1.0/pow(t12210,5.0/3.0)*t12226*(7.0/2.7E1)+Dd*t12214*t12219*(7.0/2.7E1)))+A*B*C*t12214*t12215*t12224*t12225*(1.0/3.0)+A*B*Dd*t12215*t12224*t12225*t12226*(1.0/3.0));
             }
-            
+
             // v_rho_b_gamma_bb
             if (deriv >= 2) {
                 double t12228 = rho_a+rho_b;
@@ -818,7 +849,7 @@ void LYP_CFunctional::compute_functional(const std::map<std::string,SharedVector
                 double t12250 = 1.0/(t12228*t12228*t12228*t12228*t12228);
                 v_rho_b_gamma_bb[Q] += scale * (A*B*t12232*t12233*1.0/pow(t12228,1.4E1/3.0)*t12249*(-1.1E1/3.0)+A*B*t12232*t12233*1.0/pow(t12228,1.1E1/3.0)*(rho_a*t12241-rho_a*rho_b*(C*t12242*(1.0/9.0)-t12236*t12239+rho_b*t12236*(C*t12242*(1.0/2.7E1)+Dd*t12232*t12242*(1.0/2.7E1)-t12243*t12244*t12245*(1.0/2.7E1))+rho_b*1.0/(t12228*t12228)*t12239+Dd*t12232*t12242*(1.0/9.0)-t12243*t12244*t12245*(1.0/9.0)))+A*B*C*t12232*t12250*t12233*t12249*(1.0/3.0)+A*B*Dd*t12250*t12233*t12245*t12249*(1.0/3.0));
             }
-            
+
         }
     }
 }
@@ -38,6 +38,7 @@ public:
     LYP_CFunctional();
     virtual ~LYP_CFunctional(); 
     virtual void compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha);
+    virtual void compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha);
 
 };
 
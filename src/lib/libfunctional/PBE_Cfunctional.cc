@@ -69,6 +69,10 @@ PBE_CFunctional::~PBE_CFunctional()
 {
 }
 void PBE_CFunctional::compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha)
+{
+    compute_block(FunctionalPoints::from_maps(in, out), npoints, deriv, alpha);
+}
+void PBE_CFunctional::compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha)
 {
     double c = parameters_["c"];
     double two_13 = parameters_["two_13"];
@@ -110,17 +114,17 @@ void PBE_CFunctional::compute_functional(const std::map<std::string,SharedVector
     double* tau_bp = NULL;
 
     if (true) {
-        rho_ap = in.find("RHO_A")->second->pointer();
-        rho_bp = in.find("RHO_B")->second->pointer();
+        rho_ap = points.in[FunctionalPoints::RHO_A];
+        rho_bp = points.in[FunctionalPoints::RHO_B];
     }
     if (gga_) {  
-        gamma_aap = in.find("GAMMA_AA")->second->pointer();
-        gamma_abp = in.find("GAMMA_AB")->second->pointer();
-        gamma_bbp = in.find("GAMMA_BB")->second->pointer();
+        gamma_aap = points.in[FunctionalPoints::GAMMA_AA];
+        gamma_abp = points.in[FunctionalPoints::GAMMA_AB];
+        gamma_bbp = points.in[FunctionalPoints::GAMMA_BB];
     } 
     if (meta_)  {
-        tau_ap = in.find("TAU_A")->second->pointer();
-        tau_bp = in.find("TAU_B")->second->pointer();
+        tau_ap = points.in[FunctionalPoints::TAU_A];
+        tau_bp = points.in[FunctionalPoints::TAU_B];
     }
 
     // => Outut variables <= //
@@ -165,63 +169,826 @@ void PBE_CFunctional::compute_functional(const std::map<std::string,SharedVector
     double* v_gamma_bb_tau_b = NULL;
 
     if (deriv >= 0) {
-        v = out.find("V")->second->pointer();
+        v = points.out[FunctionalPoints::V];
     } 
     if (deriv >= 1) {
         if (true) {
-            v_rho_a = out.find("V_RHO_A")->second->pointer();
-            v_rho_b = out.find("V_RHO_B")->second->pointer();
+            v_rho_a = points.out[FunctionalPoints::V_RHO_A];
+            v_rho_b = points.out[FunctionalPoints::V_RHO_B];
         }
         if (gga_) {
-            v_gamma_aa = out.find("V_GAMMA_AA")->second->pointer();
-            v_gamma_ab = out.find("V_GAMMA_AB")->second->pointer();
-            v_gamma_bb = out.find("V_GAMMA_BB")->second->pointer();
+            v_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA];
+            v_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB];
+            v_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB];
         }
         if (meta_) {    
-            v_tau_a = out.find("V_TAU_A")->second->pointer();
-            v_tau_b = out.find("V_TAU_B")->second->pointer();
+            v_tau_a = points.out[FunctionalPoints::V_TAU_A];
+            v_tau_b = points.out[FunctionalPoints::V_TAU_B];
         }
     }
     if (deriv >= 2) {
         if (true) {
-            v_rho_a_rho_a = out.find("V_RHO_A_RHO_A")->second->pointer();
-            v_rho_a_rho_b = out.find("V_RHO_A_RHO_B")->second->pointer();
-            v_rho_b_rho_b = out.find("V_RHO_B_RHO_B")->second->pointer();
+            v_rho_a_rho_a = points.out[FunctionalPoints::V_RHO_A_RHO_A];
+            v_rho_a_rho_b = points.out[FunctionalPoints::V_RHO_A_RHO_B];
+            v_rho_b_rho_b = points.out[FunctionalPoints::V_RHO_B_RHO_B];
         }
         if (gga_) {
-            v_gamma_aa_gamma_aa = out.find("V_GAMMA_AA_GAMMA_AA")->second->pointer();
-            v_gamma_aa_gamma_ab = out.find("V_GAMMA_AA_GAMMA_AB")->second->pointer();
-            v_gamma_aa_gamma_bb = out.find("V_GAMMA_AA_GAMMA_BB")->second->pointer();
-            v_gamma_ab_gamma_ab = out.find("V_GAMMA_AB_GAMMA_AB")->second->pointer();
-            v_gamma_ab_gamma_bb = out.find("V_GAMMA_AB_GAMMA_BB")->second->pointer();
-            v_gamma_bb_gamma_bb = out.find("V_GAMMA_BB_GAMMA_BB")->second->pointer();
+            v_gamma_aa_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_AA];
+            v_gamma_aa_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_AB];
+            v_gamma_aa_gamma_bb = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_BB];
+            v_gamma_ab_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB_GAMMA_AB];
+            v_gamma_ab_gamma_bb = points.out[FunctionalPoints::V_GAMMA_AB_GAMMA_BB];
+            v_gamma_bb_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB_GAMMA_BB];
         }
         if (meta_) {
-            v_tau_a_tau_a = out.find("V_TAU_A_TAU_A")->second->pointer();
-            v_tau_a_tau_b = out.find("V_TAU_A_TAU_B")->second->pointer();
-            v_tau_b_tau_b = out.find("V_TAU_B_TAU_B")->second->pointer();
+            v_tau_a_tau_a = points.out[FunctionalPoints::V_TAU_A_TAU_A];
+            v_tau_a_tau_b = points.out[FunctionalPoints::V_TAU_A_TAU_B];
+            v_tau_b_tau_b = points.out[FunctionalPoints::V_TAU_B_TAU_B];
         }
         if (gga_) {
-            v_rho_a_gamma_aa = out.find("V_RHO_A_GAMMA_AA")->second->pointer();
-            v_rho_a_gamma_ab = out.find("V_RHO_A_GAMMA_AB")->second->pointer();
-            v_rho_a_gamma_bb = out.find("V_RHO_A_GAMMA_BB")->second->pointer();
-            v_rho_b_gamma_aa = out.find("V_RHO_B_GAMMA_AA")->second->pointer();
-            v_rho_b_gamma_ab = out.find("V_RHO_B_GAMMA_AB")->second->pointer();
-            v_rho_b_gamma_bb = out.find("V_RHO_B_GAMMA_BB")->second->pointer();
+            v_rho_a_gamma_aa = points.out[FunctionalPoints::V_RHO_A_GAMMA_AA];
+            v_rho_a_gamma_ab = points.out[FunctionalPoints::V_RHO_A_GAMMA_AB];
+            v_rho_a_gamma_bb = points.out[FunctionalPoints::V_RHO_A_GAMMA_BB];
+            v_rho_b_gamma_aa = points.out[FunctionalPoints::V_RHO_B_GAMMA_AA];
+            v_rho_b_gamma_ab = points.out[FunctionalPoints::V_RHO_B_GAMMA_AB];
+            v_rho_b_gamma_bb = points.out[FunctionalPoints::V_RHO_B_GAMMA_BB];
         }
         if (meta_) {
-            v_rho_a_tau_a = out.find("V_RHO_A_TAU_A")->second->pointer();
-            v_rho_a_tau_b = out.find("V_RHO_A_TAU_B")->second->pointer();
-            v_rho_b_tau_a = out.find("V_RHO_B_TAU_A")->second->pointer();
-            v_rho_b_tau_b = out.find("V_RHO_B_TAU_B")->second->pointer();
+            v_rho_a_tau_a = points.out[FunctionalPoints::V_RHO_A_TAU_A];
+            v_rho_a_tau_b = points.out[FunctionalPoints::V_RHO_A_TAU_B];
+            v_rho_b_tau_a = points.out[FunctionalPoints::V_RHO_B_TAU_A];
+            v_rho_b_tau_b = points.out[FunctionalPoints::V_RHO_B_TAU_B];
         }
         if (gga_ && meta_) {
-            v_gamma_aa_tau_a = out.find("V_GAMMA_AA_TAU_A")->second->pointer();
-            v_gamma_aa_tau_b = out.find("V_GAMMA_AA_TAU_B")->second->pointer();
-            v_gamma_ab_tau_a = out.find("V_GAMMA_AB_TAU_A")->second->pointer();
-            v_gamma_ab_tau_b = out.find("V_GAMMA_AB_TAU_B")->second->pointer();
-            v_gamma_bb_tau_a = out.find("V_GAMMA_BB_TAU_A")->second->pointer();
-            v_gamma_bb_tau_b = out.find("V_GAMMA_BB_TAU_B")->second->pointer();
+            v_gamma_aa_tau_a = points.out[FunctionalPoints::V_GAMMA_AA_TAU_A];
+            v_gamma_aa_tau_b = points.out[FunctionalPoints::V_GAMMA_AA_TAU_B];
+            v_gamma_ab_tau_a = points.out[FunctionalPoints::V_GAMMA_AB_TAU_A];
+            v_gamma_ab_tau_b = points.out[FunctionalPoints::V_GAMMA_AB_TAU_B];
+            v_gamma_bb_tau_a = points.out[FunctionalPoints::V_GAMMA_BB_TAU_A];
+            v_gamma_bb_tau_b = points.out[FunctionalPoints::V_GAMMA_BB_TAU_B];
+        }
+    }
+
+    // => Straight-line loop over points with both spins above the cutoff <= //
+
+    // Same expressions as the general branch of the loop below, for the
+    // value and first partials.  Points with either density below the
+    // cutoff are evaluated at a harmless dummy point and masked to zero,
+    // so the body has no switches and the loop can be vectorized.
+
+    double* restrict vp = v;
+    double* restrict v_rho_ap = v_rho_a;
+    double* restrict v_rho_bp = v_rho_b;
+    double* restrict v_gamma_aap = v_gamma_aa;
+    double* restrict v_gamma_abp = v_gamma_ab;
+    double* restrict v_gamma_bbp = v_gamma_bb;
+
+    for (int Q = 0; Q < npoints; Q++) {
+
+        bool on = (rho_ap[Q] >= lsda_cutoff_ && rho_bp[Q] >= lsda_cutoff_);
+        double mask = (on ? 1.0 : 0.0);
+        double rho_a = (on ? rho_ap[Q] : 1.0);
+        double rho_b = (on ? rho_bp[Q] : 1.0);
+        double gamma_aa = (on ? gamma_aap[Q] : 1.0);
+        double gamma_ab = (on ? gamma_abp[Q] : 1.0);
+        double gamma_bb = (on ? gamma_bbp[Q] : 1.0);
+
+        // v
+        if (deriv >= 0) {
+            double t15623 = rho_a+rho_b;
+            double t15624 = 1.0/pow(t15623,1.0/3.0);
+            double t15625 = c*t15624;
+            double t15626 = 1.0/gammas;
+            double t15627 = 1.0/k;
+            double t15628 = 1.0/(pi_m12*pi_m12);
+            double t15629 = 1.0/pow(t15623,7.0/3.0);
+            double t15630 = 1.0/t15623;
+            double t15631 = rho_a-rho_b;
+            double t15632 = t15630*t15631;
+            double t15633 = 1.0/c0p;
+            double t15634 = sqrt(t15625);
+            double t15635 = b1p*t15634;
+            double t15636 = pow(t15625,3.0/2.0);
+            double t15637 = b3p*t15636;
+            double t15638 = c*c;
+            double t15639 = 1.0/pow(t15623,2.0/3.0);
+            double t15640 = b4p*t15638*t15639;
+            double t15641 = b2p*c*t15624;
+            double t15642 = t15640+t15641+t15635+t15637;
+            double t15643 = 1.0/t15642;
+            double t15644 = t15633*t15643*(1.0/2.0);
+            double t15645 = t15644+1.0;
+            double t15646 = log(t15645);
+            double t15647 = a1p*c*t15624;
+            double t15648 = t15647+1.0;
+            double t15649 = c0p*t15646*t15648*2.0;
+            double t15650 = t15631*t15631;
+            double t15651 = t15632+1.0;
+            double t15652 = -t15632+1.0;
+            double t15653 = two_13*2.0;
+            double t15654 = t15653-2.0;
+            double t15655 = 1.0/t15654;
+            double t15656 = 1.0/(t15623*t15623*t15623*t15623);
+            double t15657 = t15650*t15650;
+            double t15658 = pow(t15651,4.0/3.0);
+            double t15659 = pow(t15652,4.0/3.0);
+            double t15660 = t15658+t15659-2.0;
+            double t15661 = pow(t15651,2.0/3.0);
+            double t15662 = t15661*(1.0/2.0);
+            double t15663 = pow(t15652,2.0/3.0);
+            double t15664 = t15663*(1.0/2.0);
+            double t15665 = t15662+t15664;
+            double t15666 = 1.0/(t15665*t15665);
+            double t15667 = 1.0/(t15665*t15665*t15665);
+            double t15668 = 1.0/c0f;
+            double t15669 = b1f*t15634;
+            double t15670 = b3f*t15636;
+            double t15671 = b4f*t15638*t15639;
+            double t15672 = b2f*c*t15624;
+            double t15673 = t15670+t15671+t15672+t15669;
+            double t15674 = 1.0/t15673;
+            double t15675 = t15674*t15668*(1.0/2.0);
+            double t15676 = t15675+1.0;
+            double t15677 = log(t15676);
+            double t15678 = a1f*c*t15624;
+            double t15679 = t15678+1.0;
+            double t15705 = c0f*t15677*t15679*2.0;
+            double t15680 = -t15705+t15649;
+            double t15681 = 1.0/d2fz0;
+            double t15682 = 1.0/Aa;
+            double t15683 = b1a*t15634;
+            double t15684 = b3a*t15636;
+            double t15685 = b4a*t15638*t15639;
+            double t15686 = b2a*c*t15624;
+            double t15687 = t15683+t15684+t15685+t15686;
+            double t15688 = 1.0/t15687;
+            double t15689 = t15682*t15688*(1.0/2.0);
+            double t15690 = t15689+1.0;
+            double t15691 = log(t15690);
+            double t15692 = a1a*c*t15624;
+            double t15693 = t15692+1.0;
+            double t15694 = t15656*t15657;
+            double t15695 = t15694-1.0;
+            double t15696 = Aa*t15660*t15681*t15655*t15691*t15693*t15695*2.0;
+            double t15697 = t15649+t15696-t15660*t15680*t15655*t15656*t15657;
+            double t15698 = t15626*t15667*t15697;
+            double t15699 = exp(t15698);
+            double t15700 = t15699-1.0;
+            double t15701 = 1.0/t15700;
+            double t15702 = gamma_ab*2.0;
+            double t15703 = gamma_aa+gamma_bb+t15702;
+            double t15704 = bet*t15701*t15703*t15626*t15627*t15628*t15629*t15666*(1.0/1.6E1);
+            double t15706 = t15665*t15665;
+            double t15707 = t15705-t15649;
+            double t15708 = t15660*t15707*t15655*t15656*t15657;
+            vp[Q] += mask * scale * (-t15623*(t15708+t15649+t15696-gammas*t15706*t15665*log((bet*t15703*t15626*t15627*t15628*t15629*t15666*(t15704+1.0)*(1.0/1.6E1))/(t15704+(bet*bet)*1.0/(gammas*gammas)*1.0/(k*k)*1.0/(pi_m12*pi_m12*pi_m12*pi_m12)*(t15703*t15703)*1.0/pow(t15623,1.4E1/3.0)*1.0/(t15665*t15665*t15665*t15665)*1.0/pow(exp(t15626*t15667*(t15708+t15649+t15696))-1.0,2.0)*(1.0/2.56E2)+1.0)+1.0)));
+        }
+
+        // v_rho_a
+        if (deriv >= 1) {
+            double t15710 = rho_a+rho_b;
+            double t15711 = 1.0/gammas;
+            double t15712 = 1.0/k;
+            double t15713 = 1.0/(pi_m12*pi_m12);
+            double t15714 = 1.0/pow(t15710,7.0/3.0);
+            double t15715 = 1.0/t15710;
+            double t15716 = rho_a-rho_b;
+            double t15717 = t15715*t15716;
+            double t15718 = 1.0/pow(t15710,1.0/3.0);
+            double t15719 = c*t15718;
+            double t15720 = sqrt(t15719);
+            double t15721 = pow(t15719,3.0/2.0);
+            double t15722 = c*c;
+            double t15723 = 1.0/pow(t15710,2.0/3.0);
+            double t15724 = 1.0/c0p;
+            double t15725 = b1p*t15720;
+            double t15726 = b3p*t15721;
+            double t15727 = b4p*t15722*t15723;
+            double t15728 = b2p*c*t15718;
+            double t15729 = t15725+t15726+t15727+t15728;
+            double t15730 = 1.0/t15729;
+            double t15731 = t15730*t15724*(1.0/2.0);
+            double t15732 = t15731+1.0;
+            double t15733 = log(t15732);
+            double t15734 = a1p*c*t15718;
+            double t15735 = t15734+1.0;
+            double t15736 = c0p*t15733*t15735*2.0;
+            double t15737 = t15716*t15716;
+            double t15738 = t15717+1.0;
+            double t15739 = -t15717+1.0;
+            double t15740 = two_13*2.0;
+            double t15741 = t15740-2.0;
+            double t15742 = 1.0/t15741;
+            double t15743 = 1.0/(t15710*t15710*t15710*t15710);
+            double t15744 = t15737*t15737;
+            double t15745 = pow(t15738,4.0/3.0);
+            double t15746 = pow(t15739,4.0/3.0);
+            double t15747 = t15745+t15746-2.0;
+            double t15748 = pow(t15738,2.0/3.0);
+            double t15749 = t15748*(1.0/2.0);
+            double t15750 = pow(t15739,2.0/3.0);
+            double t15751 = t15750*(1.0/2.0);
+            double t15752 = t15751+t15749;
+            double t15753 = 1.0/(t15752*t15752);
+            double t15754 = 1.0/(t15752*t15752*t15752);
+            double t15755 = 1.0/c0f;
+            double t15756 = b1f*t15720;
+            double t15757 = b3f*t15721;
+            double t15758 = b4f*t15722*t15723;
+            double t15759 = b2f*c*t15718;
+            double t15760 = t15756+t15757+t15758+t15759;
+            double t15761 = 1.0/t15760;
+            double t15762 = t15761*t15755*(1.0/2.0);
+            double t15763 = t15762+1.0;
+            double t15764 = log(t15763);
+            double t15765 = a1f*c*t15718;
+            double t15766 = t15765+1.0;
+            double t15792 = c0f*t15764*t15766*2.0;
+            double t15767 = t15736-t15792;
+            double t15768 = 1.0/d2fz0;
+            double t15769 = 1.0/Aa;
+            double t15770 = b1a*t15720;
+            double t15771 = b3a*t15721;
+            double t15772 = b4a*t15722*t15723;
+            double t15773 = b2a*c*t15718;
+            double t15774 = t15770+t15771+t15772+t15773;
+            double t15775 = 1.0/t15774;
+            double t15776 = t15775*t15769*(1.0/2.0);
+            double t15777 = t15776+1.0;
+            double t15778 = log(t15777);
+            double t15779 = a1a*c*t15718;
+            double t15780 = t15779+1.0;
+            double t15781 = t15743*t15744;
+            double t15782 = t15781-1.0;
+            double t15783 = Aa*t15742*t15780*t15782*t15747*t15768*t15778*2.0;
+            double t15793 = t15742*t15743*t15744*t15747*t15767;
+            double t15784 = t15736+t15783-t15793;
+            double t15785 = t15711*t15754*t15784;
+            double t15786 = exp(t15785);
+            double t15787 = t15786-1.0;
+            double t15788 = 1.0/t15787;
+            double t15789 = gamma_ab*2.0;
+            double t15790 = gamma_aa+gamma_bb+t15789;
+            double t15791 = bet*t15711*t15712*t15713*t15714*t15753*t15790*t15788*(1.0/1.6E1);
+            double t15794 = 1.0/(t15710*t15710);
+            double t15814 = t15716*t15794;
+            double t15795 = t15715-t15814;
+            double t15796 = 1.0/pow(t15710,4.0/3.0);
+            double t15797 = t15791+1.0;
+            double t15798 = bet*bet;
+            double t15799 = 1.0/(gammas*gammas);
+            double t15800 = 1.0/(k*k);
+            double t15801 = 1.0/(pi_m12*pi_m12*pi_m12*pi_m12);
+            double t15802 = 1.0/pow(t15710,1.4E1/3.0);
+            double t15803 = 1.0/(t15787*t15787);
+            double t15804 = 1.0/(t15752*t15752*t15752*t15752);
+            double t15805 = t15790*t15790;
+            double t15806 = t15800*t15801*t15802*t15803*t15804*t15805*t15798*t15799*(1.0/2.56E2);
+            double t15807 = t15806+t15791+1.0;
+            double t15808 = 1.0/t15807;
+            double t15809 = bet*t15711*t15712*t15713*t15714*t15753*t15790*t15808*t15797*(1.0/1.6E1);
+            double t15810 = t15809+1.0;
+            double t15811 = t15752*t15752;
+            double t15812 = 1.0/pow(t15710,1.0E1/3.0);
+            double t15813 = 1.0/pow(t15738,1.0/3.0);
+            double t15815 = t15813*t15795*(1.0/3.0);
+            double t15816 = 1.0/pow(t15739,1.0/3.0);
+            double t15833 = t15816*t15795*(1.0/3.0);
+            double t15817 = t15815-t15833;
+            double t15818 = 1.0/t15732;
+            double t15819 = 1.0/(t15729*t15729);
+            double t15820 = 1.0/pow(t15710,5.0/3.0);
+            double t15821 = b4p*t15820*t15722*(2.0/3.0);
+            double t15822 = b2p*c*t15796*(1.0/3.0);
+            double t15823 = 1.0/sqrt(t15719);
+            double t15824 = b1p*c*t15823*t15796*(1.0/6.0);
+            double t15825 = b3p*c*t15720*t15796*(1.0/2.0);
+            double t15826 = t15821+t15822+t15824+t15825;
+            double t15827 = t15735*t15826*t15818*t15819;
+            double t15828 = 1.0/(t15710*t15710*t15710*t15710*t15710);
+            double t15829 = pow(t15738,1.0/3.0);
+            double t15830 = t15829*t15795*(4.0/3.0);
+            double t15831 = pow(t15739,1.0/3.0);
+            double t15837 = t15831*t15795*(4.0/3.0);
+            double t15832 = t15830-t15837;
+            double t15834 = bet*t15711*t15712*t15713*t15812*t15753*t15790*t15788*(7.0/4.8E1);
+            double t15835 = bet*t15711*t15712*t15713*t15714*t15754*t15790*t15817*t15788*(1.0/8.0);
+            double t15836 = t15742*t15716*t15743*t15737*t15747*t15767*4.0;
+            double t15838 = t15742*t15832*t15743*t15744*t15767;
+            double t15839 = 1.0/t15763;
+            double t15840 = 1.0/(t15760*t15760);
+            double t15841 = b4f*t15820*t15722*(2.0/3.0);
+            double t15842 = b2f*c*t15796*(1.0/3.0);
+            double t15843 = b1f*c*t15823*t15796*(1.0/6.0);
+            double t15844 = b3f*c*t15720*t15796*(1.0/2.0);
+            double t15845 = t15841+t15842+t15843+t15844;
+            double t15846 = a1f*c*c0f*t15764*t15796*(2.0/3.0);
+            double t15847 = a1p*c*c0p*t15733*t15796*(2.0/3.0);
+            double t15848 = t15744*t15828*4.0;
+            double t15862 = t15716*t15743*t15737*4.0;
+            double t15849 = -t15862+t15848;
+            double t15850 = Aa*t15742*t15780*t15747*t15768*t15849*t15778*2.0;
+            double t15851 = 1.0/t15777;
+            double t15852 = 1.0/(t15774*t15774);
+            double t15853 = b4a*t15820*t15722*(2.0/3.0);
+            double t15854 = b2a*c*t15796*(1.0/3.0);
+            double t15855 = b1a*c*t15823*t15796*(1.0/6.0);
+            double t15856 = b3a*c*t15720*t15796*(1.0/2.0);
+            double t15857 = t15853+t15854+t15855+t15856;
+            double t15858 = Aa*a1a*c*t15742*t15782*t15747*t15768*t15778*t15796*(2.0/3.0);
+            double t15859 = t15711*t15804*t15817*t15784*3.0;
+            double t15863 = t15840*t15845*t15766*t15839;
+            double t15860 = t15827-t15863+t15846-t15847;
+            double t15861 = t15742*t15743*t15860*t15744*t15747;
+            double t15864 = t15862-t15848;
+            double t15865 = log(t15810);
+            v_rho_ap[Q] += mask * scale * (-t15736-t15783+t15710*(t15861-t15827+t15836+t15838+t15847+t15858+gammas*t15811*t15817*t15865*3.0-(gammas*t15811*t15752*(bet*t15711*t15712*t15713*t15714*t15753*t15790*t15808*(t15834+t15835-bet*t15711*t15712*t15713*t15803*t15714*t15753*t15790*t15786*(t15859+t15711*t15754*(t15850-t15827+t15836+t15838+t15847+t15858+t15742*t15743*t15744*t15747*(t15827+t15846-t15840*t15845*t15766*t15839-a1p*c*c0p*t15733*t15796*(2.0/3.0))-t15742*t15744*t15747*t15828*t15767*4.0-Aa*t15742*t15832*t15780*t15782*t15768*t15778*2.0-t15742*t15851*t15780*t15852*t15782*t15747*t15857*t15768))*(1.0/1.6E1))*(1.0/1.6E1)+bet*t15711*t15712*t15713*t15812*t15753*t15790*t15808*t15797*(7.0/4.8E1)-bet*t15711*t15712*t15713*t15714*t15753*1.0/(t15807*t15807)*t15790*t15797*(t15834+t15835+1.0/pow(t15710,1.7E1/3.0)*t15800*t15801*t15803*t15804*t15805*t15798*t15799*(7.0/3.84E2)+t15800*t15801*t15802*t15803*t15805*1.0/(t15752*t15752*t15752*t15752*t15752)*t15817*t15798*t15799*(1.0/6.4E1)-bet*t15711*t15712*t15713*t15803*t15714*t15753*t15790*t15786*(t15859+t15711*t15754*(t15861-t15827+t15836+t15838+t15847+t15858-t15742*t15744*t15747*t15828*t15767*4.0-Aa*t15742*t15832*t15780*t15782*t15768*t15778*2.0-Aa*t15742*t15780*t15747*t15864*t15768*t15778*2.0-t15742*t15851*t15780*t15852*t15782*t15747*t15857*t15768))*(1.0/1.6E1)-t15800*t15801*t15802*t15804*t15805*t15786*1.0/(t15787*t15787*t15787)*t15798*t15799*(t15859+t15711*t15754*(t15850+t15861-t15827+t15836+t15838+t15847+t15858-t15742*t15744*t15747*t15828*t15767*4.0-Aa*t15742*t15832*t15780*t15782*t15768*t15778*2.0-t15742*t15851*t15780*t15852*t15782*t15747*t15857*t15768))*(1.0/1.28E2))*(1.0/1.6E1)+bet*t15711*t15712*t15713*t15714*t15754*t15790*t15808*t15817*t15797*(1.0/8.0)))/t15810-t15742*t15744*t15747*t15828*(t15736-t15792)*4.0-Aa*t15742*t15832*t15780*t15782*t15768*t15778*2.0-Aa*t15742*t15780*t15747*t15864*t15768*t15778*2.0-t15742*t15851*t15780*t15852*t15782*t15747*t15857*t15768)+gammas*t15811*t15752*t15865+t15742*t15743*t15744*t15747*(t15736-t15792));
+        }
+
+        // v_rho_b
+        if (deriv >= 1) {
+            double t15867 = rho_a+rho_b;
+            double t15868 = 1.0/gammas;
+            double t15869 = 1.0/k;
+            double t15870 = 1.0/(pi_m12*pi_m12);
+            double t15871 = 1.0/pow(t15867,7.0/3.0);
+            double t15872 = 1.0/t15867;
+            double t15873 = rho_a-rho_b;
+            double t15874 = t15872*t15873;
+            double t15875 = 1.0/pow(t15867,1.0/3.0);
+            double t15876 = c*t15875;
+            double t15877 = sqrt(t15876);
+            double t15878 = pow(t15876,3.0/2.0);
+            double t15879 = c*c;
+            double t15880 = 1.0/pow(t15867,2.0/3.0);
+            double t15881 = 1.0/c0p;
+            double t15882 = b1p*t15877;
+            double t15883 = b3p*t15878;
+            double t15884 = b4p*t15880*t15879;
+            double t15885 = b2p*c*t15875;
+            double t15886 = t15882+t15883+t15884+t15885;
+            double t15887 = 1.0/t15886;
+            double t15888 = t15881*t15887*(1.0/2.0);
+            double t15889 = t15888+1.0;
+            double t15890 = log(t15889);
+            double t15891 = a1p*c*t15875;
+            double t15892 = t15891+1.0;
+            double t15893 = c0p*t15890*t15892*2.0;
+            double t15894 = t15873*t15873;
+            double t15895 = t15874+1.0;
+            double t15896 = -t15874+1.0;
+            double t15897 = two_13*2.0;
+            double t15898 = t15897-2.0;
+            double t15899 = 1.0/t15898;
+            double t15900 = 1.0/(t15867*t15867*t15867*t15867);
+            double t15901 = t15894*t15894;
+            double t15902 = pow(t15895,4.0/3.0);
+            double t15903 = pow(t15896,4.0/3.0);
+            double t15904 = t15902+t15903-2.0;
+            double t15905 = pow(t15895,2.0/3.0);
+            double t15906 = t15905*(1.0/2.0);
+            double t15907 = pow(t15896,2.0/3.0);
+            double t15908 = t15907*(1.0/2.0);
+            double t15909 = t15906+t15908;
+            double t15910 = 1.0/(t15909*t15909);
+            double t15911 = 1.0/(t15909*t15909*t15909);
+            double t15912 = 1.0/c0f;
+            double t15913 = b1f*t15877;
+            double t15914 = b3f*t15878;
+            double t15915 = b4f*t15880*t15879;
+            double t15916 = b2f*c*t15875;
+            double t15917 = t15913+t15914+t15915+t15916;
+            double t15918 = 1.0/t15917;
+            double t15919 = t15912*t15918*(1.0/2.0);
+            double t15920 = t15919+1.0;
+            double t15921 = log(t15920);
+            double t15922 = a1f*c*t15875;
+            double t15923 = t15922+1.0;
+            double t15949 = c0f*t15921*t15923*2.0;
+            double t15924 = t15893-t15949;
+            double t15925 = 1.0/d2fz0;
+            double t15926 = 1.0/Aa;
+            double t15927 = b1a*t15877;
+            double t15928 = b3a*t15878;
+            double t15929 = b4a*t15880*t15879;
+            double t15930 = b2a*c*t15875;
+            double t15931 = t15930+t15927+t15928+t15929;
+            double t15932 = 1.0/t15931;
+            double t15933 = t15932*t15926*(1.0/2.0);
+            double t15934 = t15933+1.0;
+            double t15935 = log(t15934);
+            double t15936 = a1a*c*t15875;
+            double t15937 = t15936+1.0;
+            double t15938 = t15900*t15901;
+            double t15939 = t15938-1.0;
+            double t15940 = Aa*t15904*t15925*t15935*t15937*t15939*t15899*2.0;
+            double t15950 = t15900*t15901*t15904*t15924*t15899;
+            double t15941 = t15940-t15950+t15893;
+            double t15942 = t15911*t15941*t15868;
+            double t15943 = exp(t15942);
+            double t15944 = t15943-1.0;
+            double t15945 = 1.0/t15944;
+            double t15946 = gamma_ab*2.0;
+            double t15947 = gamma_aa+gamma_bb+t15946;
+            double t15948 = bet*t15910*t15870*t15871*t15945*t15947*t15868*t15869*(1.0/1.6E1);
+            double t15951 = 1.0/(t15867*t15867);
+            double t15952 = t15951*t15873;
+            double t15953 = t15952+t15872;
+            double t15954 = 1.0/pow(t15867,4.0/3.0);
+            double t15955 = t15948+1.0;
+            double t15956 = bet*bet;
+            double t15957 = 1.0/(gammas*gammas);
+            double t15958 = 1.0/(k*k);
+            double t15959 = 1.0/(pi_m12*pi_m12*pi_m12*pi_m12);
+            double t15960 = 1.0/pow(t15867,1.4E1/3.0);
+            double t15961 = 1.0/(t15944*t15944);
+            double t15962 = 1.0/(t15909*t15909*t15909*t15909);
+            double t15963 = t15947*t15947;
+            double t15964 = t15960*t15961*t15962*t15963*t15956*t15957*t15958*t15959*(1.0/2.56E2);
+            double t15965 = t15964+t15948+1.0;
+            double t15966 = 1.0/t15965;
+            double t15967 = bet*t15910*t15870*t15871*t15955*t15947*t15966*t15868*t15869*(1.0/1.6E1);
+            double t15968 = t15967+1.0;
+            double t15969 = t15909*t15909;
+            double t15970 = 1.0/pow(t15867,1.0E1/3.0);
+            double t15971 = 1.0/pow(t15895,1.0/3.0);
+            double t15972 = t15953*t15971*(1.0/3.0);
+            double t15973 = 1.0/pow(t15896,1.0/3.0);
+            double t15990 = t15953*t15973*(1.0/3.0);
+            double t15974 = t15972-t15990;
+            double t15975 = 1.0/t15889;
+            double t15976 = 1.0/(t15886*t15886);
+            double t15977 = 1.0/pow(t15867,5.0/3.0);
+            double t15978 = b4p*t15977*t15879*(2.0/3.0);
+            double t15979 = b2p*c*t15954*(1.0/3.0);
+            double t15980 = 1.0/sqrt(t15876);
+            double t15981 = b1p*c*t15980*t15954*(1.0/6.0);
+            double t15982 = b3p*c*t15954*t15877*(1.0/2.0);
+            double t15983 = t15981+t15982+t15978+t15979;
+            double t15984 = 1.0/(t15867*t15867*t15867*t15867*t15867);
+            double t15985 = pow(t15895,1.0/3.0);
+            double t15986 = t15953*t15985*(4.0/3.0);
+            double t15987 = pow(t15896,1.0/3.0);
+            double t15994 = t15953*t15987*(4.0/3.0);
+            double t15988 = -t15994+t15986;
+            double t15989 = t15892*t15983*t15975*t15976;
+            double t15991 = bet*t15910*t15870*t15970*t15945*t15947*t15868*t15869*(7.0/4.8E1);
+            double t15992 = t15900*t15904*t15924*t15873*t15894*t15899*4.0;
+            double t15993 = t15901*t15904*t15924*t15984*t15899*4.0;
+            double t15995 = t15900*t15901*t15924*t15988*t15899;
+            double t15996 = 1.0/t15920;
+            double t15997 = 1.0/(t15917*t15917);
+            double t15998 = b4f*t15977*t15879*(2.0/3.0);
+            double t15999 = b2f*c*t15954*(1.0/3.0);
+            double t16000 = b1f*c*t15980*t15954*(1.0/6.0);
+            double t16001 = b3f*c*t15954*t15877*(1.0/2.0);
+            double t16002 = t15998+t15999+t16000+t16001;
+            double t16003 = a1f*c*c0f*t15921*t15954*(2.0/3.0);
+            double t16004 = t15900*t15873*t15894*4.0;
+            double t16005 = t15901*t15984*4.0;
+            double t16006 = t16004+t16005;
+            double t16007 = 1.0/t15934;
+            double t16008 = 1.0/(t15931*t15931);
+            double t16009 = b4a*t15977*t15879*(2.0/3.0);
+            double t16010 = b2a*c*t15954*(1.0/3.0);
+            double t16011 = b1a*c*t15980*t15954*(1.0/6.0);
+            double t16012 = b3a*c*t15954*t15877*(1.0/2.0);
+            double t16013 = t16010+t16011+t16012+t16009;
+            double t16014 = t15904*t15925*t15937*t15939*t15899*t16013*t16007*t16008;
+            double t16016 = a1p*c*c0p*t15890*t15954*(2.0/3.0);
+            double t16018 = t15923*t15996*t15997*t16002;
+            double t16015 = t15989+t16003-t16016-t16018;
+            double t16017 = t15941*t15962*t15974*t15868*3.0;
+            double t16022 = t15900*t15901*t15904*t15899*t16015;
+            double t16023 = Aa*t15925*t15935*t15937*t15939*t15988*t15899*2.0;
+            double t16024 = Aa*t15904*t15925*t15935*t15937*t15899*t16006*2.0;
+            double t16025 = Aa*a1a*c*t15904*t15925*t15935*t15954*t15939*t15899*(2.0/3.0);
+            double t16019 = t15992+t15993+t15995+t15989-t16022+t16014-t16023-t16024-t16016-t16025;
+            double t16020 = t15911*t15868*t16019;
+            double t16021 = t16020+t16017;
+            double t16026 = bet*t15910*t15870*t15871*t15943*t15961*t15947*t15868*t15869*t16021*(1.0/1.6E1);
+            double t16027 = log(t15968);
+            v_rho_bp[Q] += mask * scale * (-t15940-t15893-t15867*(t15992+t15993+t15995+t15989-t16022+t16014-t16023-t16024-t16016-t16025+gammas*t15974*t15969*t16027*3.0+(gammas*t15909*t15969*(bet*t15910*t15870*t15970*t15955*t15947*t15966*t15868*t15869*(7.0/4.8E1)+bet*t15910*t15870*t15871*t15947*t15966*t15868*t15869*(t15991+t16026-bet*t15911*t15870*t15871*t15945*t15947*t15974*t15868*t15869*(1.0/8.0))*(1.0/1.6E1)-bet*t15911*t15870*t15871*t15955*t15947*t15974*t15966*t15868*t15869*(1.0/8.0)-bet*t15910*t15870*t15871*t15955*t15947*1.0/(t15965*t15965)*t15868*t15869*(t15991+t16026+t15961*t15962*t15963*t15956*1.0/pow(t15867,1.7E1/3.0)*t15957*t15958*t15959*(7.0/3.84E2)-bet*t15911*t15870*t15871*t15945*t15947*t15974*t15868*t15869*(1.0/8.0)-t15960*t15961*1.0/(t15909*t15909*t15909*t15909*t15909)*t15963*t15956*t15974*t15957*t15958*t15959*(1.0/6.4E1)+t15960*t15943*1.0/(t15944*t15944*t15944)*t15962*t15963*t15956*t15957*t15958*t15959*t16021*(1.0/1.28E2))*(1.0/1.6E1)))/t15968)+gammas*t15909*t15969*t16027+t15900*t15901*t15904*t15899*(t15893-t15949));
+        }
+
+        // v_gamma_aa
+        if (deriv >= 1) {
+            double t16029 = rho_a+rho_b;
+            double t16030 = 1.0/gammas;
+            double t16031 = 1.0/k;
+            double t16032 = 1.0/(pi_m12*pi_m12);
+            double t16033 = 1.0/pow(t16029,7.0/3.0);
+            double t16034 = 1.0/t16029;
+            double t16035 = rho_a-rho_b;
+            double t16036 = t16034*t16035;
+            double t16037 = 1.0/pow(t16029,1.0/3.0);
+            double t16038 = c*t16037;
+            double t16039 = sqrt(t16038);
+            double t16040 = pow(t16038,3.0/2.0);
+            double t16041 = c*c;
+            double t16042 = 1.0/pow(t16029,2.0/3.0);
+            double t16043 = 1.0/c0p;
+            double t16044 = b1p*t16039;
+            double t16045 = b3p*t16040;
+            double t16046 = b4p*t16041*t16042;
+            double t16047 = b2p*c*t16037;
+            double t16048 = t16044+t16045+t16046+t16047;
+            double t16049 = 1.0/t16048;
+            double t16050 = t16043*t16049*(1.0/2.0);
+            double t16051 = t16050+1.0;
+            double t16052 = log(t16051);
+            double t16053 = a1p*c*t16037;
+            double t16054 = t16053+1.0;
+            double t16055 = c0p*t16052*t16054*2.0;
+            double t16056 = t16035*t16035;
+            double t16057 = t16036+1.0;
+            double t16058 = -t16036+1.0;
+            double t16059 = two_13*2.0;
+            double t16060 = t16059-2.0;
+            double t16061 = 1.0/t16060;
+            double t16062 = 1.0/(t16029*t16029*t16029*t16029);
+            double t16063 = t16056*t16056;
+            double t16064 = pow(t16057,4.0/3.0);
+            double t16065 = pow(t16058,4.0/3.0);
+            double t16066 = t16064+t16065-2.0;
+            double t16067 = pow(t16057,2.0/3.0);
+            double t16068 = t16067*(1.0/2.0);
+            double t16069 = pow(t16058,2.0/3.0);
+            double t16070 = t16069*(1.0/2.0);
+            double t16071 = t16070+t16068;
+            double t16072 = 1.0/(t16071*t16071);
+            double t16073 = 1.0/(t16071*t16071*t16071);
+            double t16074 = 1.0/c0f;
+            double t16075 = b1f*t16039;
+            double t16076 = b3f*t16040;
+            double t16077 = b4f*t16041*t16042;
+            double t16078 = b2f*c*t16037;
+            double t16079 = t16075+t16076+t16077+t16078;
+            double t16080 = 1.0/t16079;
+            double t16081 = t16080*t16074*(1.0/2.0);
+            double t16082 = t16081+1.0;
+            double t16083 = log(t16082);
+            double t16084 = a1f*c*t16037;
+            double t16085 = t16084+1.0;
+            double t16111 = c0f*t16083*t16085*2.0;
+            double t16086 = -t16111+t16055;
+            double t16087 = 1.0/d2fz0;
+            double t16088 = 1.0/Aa;
+            double t16089 = b1a*t16039;
+            double t16090 = b3a*t16040;
+            double t16091 = b4a*t16041*t16042;
+            double t16092 = b2a*c*t16037;
+            double t16093 = t16090+t16091+t16092+t16089;
+            double t16094 = 1.0/t16093;
+            double t16095 = t16094*t16088*(1.0/2.0);
+            double t16096 = t16095+1.0;
+            double t16097 = log(t16096);
+            double t16098 = a1a*c*t16037;
+            double t16099 = t16098+1.0;
+            double t16100 = t16062*t16063;
+            double t16101 = t16100-1.0;
+            double t16102 = Aa*t16101*t16061*t16066*t16087*t16097*t16099*2.0;
+            double t16103 = t16102+t16055-t16061*t16062*t16063*t16066*t16086;
+            double t16104 = t16030*t16103*t16073;
+            double t16105 = exp(t16104);
+            double t16106 = t16105-1.0;
+            double t16107 = 1.0/t16106;
+            double t16108 = gamma_ab*2.0;
+            double t16109 = gamma_aa+gamma_bb+t16108;
+            double t16110 = bet*t16030*t16031*t16032*t16033*t16107*t16072*t16109*(1.0/1.6E1);
+            double t16112 = t16071*t16071;
+            double t16113 = t16111-t16055;
+            double t16114 = t16113*t16061*t16062*t16063*t16066;
+            double t16115 = t16102+t16114+t16055;
+            double t16116 = t16030*t16115*t16073;
+            double t16117 = exp(t16116);
+            double t16118 = t16117-1.0;
+            double t16119 = 1.0/t16118;
+            double t16120 = bet*t16030*t16031*t16032*t16033*t16072*t16109*t16119*(1.0/1.6E1);
+            double t16121 = bet*bet;
+            double t16122 = 1.0/(gammas*gammas);
+            double t16123 = 1.0/(k*k);
+            double t16124 = 1.0/(pi_m12*pi_m12*pi_m12*pi_m12);
+            double t16125 = 1.0/pow(t16029,1.4E1/3.0);
+            double t16126 = 1.0/(t16118*t16118);
+            double t16127 = 1.0/(t16071*t16071*t16071*t16071);
+            double t16128 = t16109*t16109;
+            double t16129 = t16121*t16122*t16123*t16124*t16125*t16126*t16127*t16128*(1.0/2.56E2);
+            double t16130 = t16120+t16129+1.0;
+            double t16131 = 1.0/t16130;
+            double t16132 = t16120+1.0;
+            v_gamma_aap[Q] += mask * scale * ((gammas*t16112*t16071*t16029*(bet*t16030*t16031*t16032*t16131*t16033*t16132*t16072*(1.0/1.6E1)+t16121*t16122*t16131*t16123*t16124*t16125*t16109*t16127*t16119*(1.0/2.56E2)-bet*t16030*t16031*1.0/(t16130*t16130)*t16032*t16033*t16132*t16072*t16109*(bet*t16030*t16031*t16032*t16033*t16072*t16119*(1.0/1.6E1)+t16121*t16122*t16123*t16124*t16125*t16126*t16127*(gamma_aa*2.0+gamma_ab*4.0+gamma_bb*2.0)*(1.0/2.56E2))*(1.0/1.6E1)))/((bet*t16030*t16031*t16032*t16033*t16072*t16109*(t16110+1.0)*(1.0/1.6E1))/(t16110+t16129+1.0)+1.0));
+        }
+
+        // v_gamma_ab
+        if (deriv >= 1) {
+            double t16134 = rho_a+rho_b;
+            double t16135 = 1.0/gammas;
+            double t16136 = 1.0/k;
+            double t16137 = 1.0/(pi_m12*pi_m12);
+            double t16138 = 1.0/pow(t16134,7.0/3.0);
+            double t16139 = 1.0/t16134;
+            double t16140 = rho_a-rho_b;
+            double t16141 = t16140*t16139;
+            double t16142 = 1.0/pow(t16134,1.0/3.0);
+            double t16143 = c*t16142;
+            double t16144 = sqrt(t16143);
+            double t16145 = pow(t16143,3.0/2.0);
+            double t16146 = c*c;
+            double t16147 = 1.0/pow(t16134,2.0/3.0);
+            double t16148 = 1.0/c0p;
+            double t16149 = b1p*t16144;
+            double t16150 = b3p*t16145;
+            double t16151 = b4p*t16146*t16147;
+            double t16152 = b2p*c*t16142;
+            double t16153 = t16150+t16151+t16152+t16149;
+            double t16154 = 1.0/t16153;
+            double t16155 = t16154*t16148*(1.0/2.0);
+            double t16156 = t16155+1.0;
+            double t16157 = log(t16156);
+            double t16158 = a1p*c*t16142;
+            double t16159 = t16158+1.0;
+            double t16160 = c0p*t16157*t16159*2.0;
+            double t16161 = t16140*t16140;
+            double t16162 = t16141+1.0;
+            double t16163 = -t16141+1.0;
+            double t16164 = two_13*2.0;
+            double t16165 = t16164-2.0;
+            double t16166 = 1.0/t16165;
+            double t16167 = 1.0/(t16134*t16134*t16134*t16134);
+            double t16168 = t16161*t16161;
+            double t16169 = pow(t16162,4.0/3.0);
+            double t16170 = pow(t16163,4.0/3.0);
+            double t16171 = t16170+t16169-2.0;
+            double t16172 = pow(t16162,2.0/3.0);
+            double t16173 = t16172*(1.0/2.0);
+            double t16174 = pow(t16163,2.0/3.0);
+            double t16175 = t16174*(1.0/2.0);
+            double t16176 = t16173+t16175;
+            double t16177 = 1.0/(t16176*t16176);
+            double t16178 = 1.0/(t16176*t16176*t16176);
+            double t16179 = 1.0/c0f;
+            double t16180 = b1f*t16144;
+            double t16181 = b3f*t16145;
+            double t16182 = b4f*t16146*t16147;
+            double t16183 = b2f*c*t16142;
+            double t16184 = t16180+t16181+t16182+t16183;
+            double t16185 = 1.0/t16184;
+            double t16186 = t16185*t16179*(1.0/2.0);
+            double t16187 = t16186+1.0;
+            double t16188 = log(t16187);
+            double t16189 = a1f*c*t16142;
+            double t16190 = t16189+1.0;
+            double t16216 = c0f*t16190*t16188*2.0;
+            double t16191 = t16160-t16216;
+            double t16192 = 1.0/d2fz0;
+            double t16193 = 1.0/Aa;
+            double t16194 = b1a*t16144;
+            double t16195 = b3a*t16145;
+            double t16196 = b4a*t16146*t16147;
+            double t16197 = b2a*c*t16142;
+            double t16198 = t16194+t16195+t16196+t16197;
+            double t16199 = 1.0/t16198;
+            double t16200 = t16193*t16199*(1.0/2.0);
+            double t16201 = t16200+1.0;
+            double t16202 = log(t16201);
+            double t16203 = a1a*c*t16142;
+            double t16204 = t16203+1.0;
+            double t16205 = t16167*t16168;
+            double t16206 = t16205-1.0;
+            double t16207 = Aa*t16202*t16204*t16206*t16171*t16192*t16166*2.0;
+            double t16217 = t16171*t16191*t16166*t16167*t16168;
+            double t16208 = t16160+t16207-t16217;
+            double t16209 = t16135*t16208*t16178;
+            double t16210 = exp(t16209);
+            double t16211 = t16210-1.0;
+            double t16212 = 1.0/t16211;
+            double t16213 = gamma_ab*2.0;
+            double t16214 = gamma_aa+gamma_bb+t16213;
+            double t16215 = bet*t16212*t16214*t16135*t16136*t16137*t16138*t16177*(1.0/1.6E1);
+            double t16218 = t16176*t16176;
+            double t16219 = t16215+1.0;
+            double t16220 = bet*bet;
+            double t16221 = 1.0/(gammas*gammas);
+            double t16222 = 1.0/(k*k);
+            double t16223 = 1.0/(pi_m12*pi_m12*pi_m12*pi_m12);
+            double t16224 = 1.0/pow(t16134,1.4E1/3.0);
+            double t16225 = 1.0/(t16211*t16211);
+            double t16226 = 1.0/(t16176*t16176*t16176*t16176);
+            double t16227 = t16214*t16214;
+            double t16228 = t16220*t16221*t16222*t16223*t16224*t16225*t16226*t16227*(1.0/2.56E2);
+            double t16229 = t16215+t16228+1.0;
+            double t16230 = 1.0/t16229;
+            v_gamma_abp[Q] += mask * scale * ((gammas*t16134*t16218*t16176*(bet*t16230*t16135*t16136*t16137*t16138*t16219*t16177*(1.0/8.0)+t16220*t16212*t16221*t16230*t16222*t16214*t16223*t16224*t16226*(1.0/1.28E2)-bet*t16214*t16135*t16136*t16137*t16138*t16219*1.0/(t16229*t16229)*t16177*(bet*t16212*t16135*t16136*t16137*t16138*t16177*(1.0/8.0)+t16220*t16221*t16222*t16223*t16224*t16225*t16226*(gamma_aa*4.0+gamma_ab*8.0+gamma_bb*4.0)*(1.0/2.56E2))*(1.0/1.6E1)))/(bet*t16230*t16214*t16135*t16136*t16137*t16138*t16219*t16177*(1.0/1.6E1)+1.0));
+        }
+
+        // v_gamma_bb
+        if (deriv >= 1) {
+            double t16232 = rho_a+rho_b;
+            double t16233 = 1.0/gammas;
+            double t16234 = 1.0/k;
+            double t16235 = 1.0/(pi_m12*pi_m12);
+            double t16236 = 1.0/pow(t16232,7.0/3.0);
+            double t16237 = 1.0/t16232;
+            double t16238 = rho_a-rho_b;
+            double t16239 = t16237*t16238;
+            double t16240 = 1.0/pow(t16232,1.0/3.0);
+            double t16241 = c*t16240;
+            double t16242 = sqrt(t16241);
+            double t16243 = pow(t16241,3.0/2.0);
+            double t16244 = c*c;
+            double t16245 = 1.0/pow(t16232,2.0/3.0);
+            double t16246 = 1.0/c0p;
+            double t16247 = b1p*t16242;
+            double t16248 = b3p*t16243;
+            double t16249 = b4p*t16244*t16245;
+            double t16250 = b2p*c*t16240;
+            double t16251 = t16250+t16247+t16248+t16249;
+            double t16252 = 1.0/t16251;
+            double t16253 = t16252*t16246*(1.0/2.0);
+            double t16254 = t16253+1.0;
+            double t16255 = log(t16254);
+            double t16256 = a1p*c*t16240;
+            double t16257 = t16256+1.0;
+            double t16258 = c0p*t16255*t16257*2.0;
+            double t16259 = t16238*t16238;
+            double t16260 = t16239+1.0;
+            double t16261 = -t16239+1.0;
+            double t16262 = two_13*2.0;
+            double t16263 = t16262-2.0;
+            double t16264 = 1.0/t16263;
+            double t16265 = 1.0/(t16232*t16232*t16232*t16232);
+            double t16266 = t16259*t16259;
+            double t16267 = pow(t16260,4.0/3.0);
+            double t16268 = pow(t16261,4.0/3.0);
+            double t16269 = t16267+t16268-2.0;
+            double t16270 = pow(t16260,2.0/3.0);
+            double t16271 = t16270*(1.0/2.0);
+            double t16272 = pow(t16261,2.0/3.0);
+            double t16273 = t16272*(1.0/2.0);
+            double t16274 = t16271+t16273;
+            double t16275 = 1.0/(t16274*t16274);
+            double t16276 = 1.0/(t16274*t16274*t16274);
+            double t16277 = 1.0/c0f;
+            double t16278 = b1f*t16242;
+            double t16279 = b3f*t16243;
+            double t16280 = b4f*t16244*t16245;
+            double t16281 = b2f*c*t16240;
+            double t16282 = t16280+t16281+t16278+t16279;
+            double t16283 = 1.0/t16282;
+            double t16284 = t16283*t16277*(1.0/2.0);
+            double t16285 = t16284+1.0;
+            double t16286 = log(t16285);
+            double t16287 = a1f*c*t16240;
+            double t16288 = t16287+1.0;
+            double t16314 = c0f*t16286*t16288*2.0;
+            double t16289 = -t16314+t16258;
+            double t16290 = 1.0/d2fz0;
+            double t16291 = 1.0/Aa;
+            double t16292 = b1a*t16242;
+            double t16293 = b3a*t16243;
+            double t16294 = b4a*t16244*t16245;
+            double t16295 = b2a*c*t16240;
+            double t16296 = t16292+t16293+t16294+t16295;
+            double t16297 = 1.0/t16296;
+            double t16298 = t16291*t16297*(1.0/2.0);
+            double t16299 = t16298+1.0;
+            double t16300 = log(t16299);
+            double t16301 = a1a*c*t16240;
+            double t16302 = t16301+1.0;
+            double t16303 = t16265*t16266;
+            double t16304 = t16303-1.0;
+            double t16305 = Aa*t16300*t16302*t16304*t16290*t16264*t16269*2.0;
+            double t16306 = t16305+t16258-t16264*t16265*t16266*t16269*t16289;
+            double t16307 = t16233*t16306*t16276;
+            double t16308 = exp(t16307);
+            double t16309 = t16308-1.0;
+            double t16310 = 1.0/t16309;
+            double t16311 = gamma_ab*2.0;
+            double t16312 = gamma_aa+gamma_bb+t16311;
+            double t16313 = bet*t16310*t16312*t16233*t16234*t16235*t16236*t16275*(1.0/1.6E1);
+            double t16315 = t16274*t16274;
+            double t16316 = t16314-t16258;
+            double t16317 = t16316*t16264*t16265*t16266*t16269;
+            double t16318 = t16305+t16317+t16258;
+            double t16319 = t16233*t16318*t16276;
+            double t16320 = exp(t16319);
+            double t16321 = t16320-1.0;
+            double t16322 = 1.0/t16321;
+            double t16323 = bet*t16312*t16322*t16233*t16234*t16235*t16236*t16275*(1.0/1.6E1);
+            double t16324 = bet*bet;
+            double t16325 = 1.0/(gammas*gammas);
+            double t16326 = 1.0/(k*k);
+            double t16327 = 1.0/(pi_m12*pi_m12*pi_m12*pi_m12);
+            double t16328 = 1.0/pow(t16232,1.4E1/3.0);
+            double t16329 = 1.0/(t16321*t16321);
+            double t16330 = 1.0/(t16274*t16274*t16274*t16274);
+            double t16331 = t16312*t16312;
+            double t16332 = t16330*t16331*t16324*t16325*t16326*t16327*t16328*t16329*(1.0/2.56E2);
+            double t16333 = t16323+t16332+1.0;
+            double t16334 = 1.0/t16333;
+            double t16335 = t16323+1.0;
+            v_gamma_bbp[Q] += mask * scale * ((gammas*t16232*t16315*t16274*(bet*t16233*t16234*t16235*t16334*t16236*t16335*t16275*(1.0/1.6E1)+t16312*t16330*t16322*t16324*t16325*t16334*t16326*t16327*t16328*(1.0/2.56E2)-bet*t16312*t16233*t16234*1.0/(t16333*t16333)*t16235*t16236*t16335*t16275*(bet*t16322*t16233*t16234*t16235*t16236*t16275*(1.0/1.6E1)+t16330*t16324*t16325*t16326*t16327*t16328*t16329*(gamma_aa*2.0+gamma_ab*4.0+gamma_bb*2.0)*(1.0/2.56E2))*(1.0/1.6E1)))/((bet*t16312*t16233*t16234*t16235*t16236*t16275*(t16313+1.0)*(1.0/1.6E1))/(t16313+t16332+1.0)+1.0));
         }
     }
 
@@ -956,744 +1723,8 @@ void PBE_CFunctional::compute_functional(const std::map<std::string,SharedVector
             }
             
         } else {
-            // v
-            if (deriv >= 0) {
-                double t15623 = rho_a+rho_b;
-                double t15624 = 1.0/pow(t15623,1.0/3.0);
-                double t15625 = c*t15624;
-                double t15626 = 1.0/gammas;
-                double t15627 = 1.0/k;
-                double t15628 = 1.0/(pi_m12*pi_m12);
-                double t15629 = 1.0/pow(t15623,7.0/3.0);
-                double t15630 = 1.0/t15623;
-                double t15631 = rho_a-rho_b;
-                double t15632 = t15630*t15631;
-                double t15633 = 1.0/c0p;
-                double t15634 = sqrt(t15625);
-                double t15635 = b1p*t15634;
-                double t15636 = pow(t15625,3.0/2.0);
-                double t15637 = b3p*t15636;
-                double t15638 = c*c;
-                double t15639 = 1.0/pow(t15623,2.0/3.0);
-                double t15640 = b4p*t15638*t15639;
-                double t15641 = b2p*c*t15624;
-                double t15642 = t15640+t15641+t15635+t15637;
-                double t15643 = 1.0/t15642;
-                double t15644 = t15633*t15643*(1.0/2.0);
-                double t15645 = t15644+1.0;
-                double t15646 = log(t15645);
-                double t15647 = a1p*c*t15624;
-                double t15648 = t15647+1.0;
-                double t15649 = c0p*t15646*t15648*2.0;
-                double t15650 = t15631*t15631;
-                double t15651 = t15632+1.0;
-                double t15652 = -t15632+1.0;
-                double t15653 = two_13*2.0;
-                double t15654 = t15653-2.0;
-                double t15655 = 1.0/t15654;
-                double t15656 = 1.0/(t15623*t15623*t15623*t15623);
-                double t15657 = t15650*t15650;
-                double t15658 = pow(t15651,4.0/3.0);
-                double t15659 = pow(t15652,4.0/3.0);
-                double t15660 = t15658+t15659-2.0;
-                double t15661 = pow(t15651,2.0/3.0);
-                double t15662 = t15661*(1.0/2.0);
-                double t15663 = pow(t15652,2.0/3.0);
-                double t15664 = t15663*(1.0/2.0);
-                double t15665 = t15662+t15664;
-                double t15666 = 1.0/(t15665*t15665);
-                double t15667 = 1.0/(t15665*t15665*t15665);
-                double t15668 = 1.0/c0f;
-                double t15669 = b1f*t15634;
-                double t15670 = b3f*t15636;
-                double t15671 = b4f*t15638*t15639;
-                double t15672 = b2f*c*t15624;
-                double t15673 = t15670+t15671+t15672+t15669;
-                double t15674 = 1.0/t15673;
-                double t15675 = t15674*t15668*(1.0/2.0);
-                double t15676 = t15675+1.0;
-                double t15677 = log(t15676);
-                double t15678 = a1f*c*t15624;
-                double t15679 = t15678+1.0;
-                double t15705 = c0f*t15677*t15679*2.0;
-                double t15680 = -t15705+t15649;
-                double t15681 = 1.0/d2fz0;
-                double t15682 = 1.0/Aa;
-                double t15683 = b1a*t15634;
-                double t15684 = b3a*t15636;
-                double t15685 = b4a*t15638*t15639;
-                double t15686 = b2a*c*t15624;
-                double t15687 = t15683+t15684+t15685+t15686;
-                double t15688 = 1.0/t15687;
-                double t15689 = t15682*t15688*(1.0/2.0);
-                double t15690 = t15689+1.0;
-                double t15691 = log(t15690);
-                double t15692 = a1a*c*t15624;
-                double t15693 = t15692+1.0;
-                double t15694 = t15656*t15657;
-                double t15695 = t15694-1.0;
-                double t15696 = Aa*t15660*t15681*t15655*t15691*t15693*t15695*2.0;
-                double t15697 = t15649+t15696-t15660*t15680*t15655*t15656*t15657;
-                double t15698 = t15626*t15667*t15697;
-                double t15699 = exp(t15698);
-                double t15700 = t15699-1.0;
-                double t15701 = 1.0/t15700;
-                double t15702 = gamma_ab*2.0;
-                double t15703 = gamma_aa+gamma_bb+t15702;
-                double t15704 = bet*t15701*t15703*t15626*t15627*t15628*t15629*t15666*(1.0/1.6E1);
-                double t15706 = t15665*t15665;
-                double t15707 = t15705-t15649;
-                double t15708 = t15660*t15707*t15655*t15656*t15657;
-                v[Q] += scale * (-t15623*(t15708+t15649+t15696-gammas*t15706*t15665*log((bet*t15703*t15626*t15627*t15628*t15629*t15666*(t15704+1.0)*(1.0/1.6E1))/(t15704+(bet*bet)*1.0/(gammas*gammas)*1.0/(k*k)*1.0/(pi_m12*pi_m12*pi_m12*pi_m12)*(t15703*t15703)*1.0/pow(t15623,1.4E1/3.0)*1.0/(t15665*t15665*t15665*t15665)*1.0/pow(exp(t15626*t15667*(t15708+t15649+t15696))-1.0,2.0)*(1.0/2.56E2)+1.0)+1.0)));
-            }
-            
-            // v_rho_a
-            if (deriv >= 1) {
-                double t15710 = rho_a+rho_b;
-                double t15711 = 1.0/gammas;
-                double t15712 = 1.0/k;
-                double t15713 = 1.0/(pi_m12*pi_m12);
-                double t15714 = 1.0/pow(t15710,7.0/3.0);
-                double t15715 = 1.0/t15710;
-                double t15716 = rho_a-rho_b;
-                double t15717 = t15715*t15716;
-                double t15718 = 1.0/pow(t15710,1.0/3.0);
-                double t15719 = c*t15718;
-                double t15720 = sqrt(t15719);
-                double t15721 = pow(t15719,3.0/2.0);
-                double t15722 = c*c;
-                double t15723 = 1.0/pow(t15710,2.0/3.0);
-                double t15724 = 1.0/c0p;
-                double t15725 = b1p*t15720;
-                double t15726 = b3p*t15721;
-                double t15727 = b4p*t15722*t15723;
-                double t15728 = b2p*c*t15718;
-                double t15729 = t15725+t15726+t15727+t15728;
-                double t15730 = 1.0/t15729;
-                double t15731 = t15730*t15724*(1.0/2.0);
-                double t15732 = t15731+1.0;
-                double t15733 = log(t15732);
-                double t15734 = a1p*c*t15718;
-                double t15735 = t15734+1.0;
-                double t15736 = c0p*t15733*t15735*2.0;
-                double t15737 = t15716*t15716;
-                double t15738 = t15717+1.0;
-                double t15739 = -t15717+1.0;
-                double t15740 = two_13*2.0;
-                double t15741 = t15740-2.0;
-                double t15742 = 1.0/t15741;
-                double t15743 = 1.0/(t15710*t15710*t15710*t15710);
-                double t15744 = t15737*t15737;
-                double t15745 = pow(t15738,4.0/3.0);
-                double t15746 = pow(t15739,4.0/3.0);
-                double t15747 = t15745+t15746-2.0;
-                double t15748 = pow(t15738,2.0/3.0);
-                double t15749 = t15748*(1.0/2.0);
-                double t15750 = pow(t15739,2.0/3.0);
-                double t15751 = t15750*(1.0/2.0);
-                double t15752 = t15751+t15749;
-                double t15753 = 1.0/(t15752*t15752);
-                double t15754 = 1.0/(t15752*t15752*t15752);
-                double t15755 = 1.0/c0f;
-                double t15756 = b1f*t15720;
-                double t15757 = b3f*t15721;
-                double t15758 = b4f*t15722*t15723;
-                double t15759 = b2f*c*t15718;
-                double t15760 = t15756+t15757+t15758+t15759;
-                double t15761 = 1.0/t15760;
-                double t15762 = t15761*t15755*(1.0/2.0);
-                double t15763 = t15762+1.0;
-                double t15764 = log(t15763);
-                double t15765 = a1f*c*t15718;
-                double t15766 = t15765+1.0;
-                double t15792 = c0f*t15764*t15766*2.0;
-                double t15767 = t15736-t15792;
-                double t15768 = 1.0/d2fz0;
-                double t15769 = 1.0/Aa;
-                double t15770 = b1a*t15720;
-                double t15771 = b3a*t15721;
-                double t15772 = b4a*t15722*t15723;
-                double t15773 = b2a*c*t15718;
-                double t15774 = t15770+t15771+t15772+t15773;
-                double t15775 = 1.0/t15774;
-                double t15776 = t15775*t15769*(1.0/2.0);
-                double t15777 = t15776+1.0;
-                double t15778 = log(t15777);
-                double t15779 = a1a*c*t15718;
-                double t15780 = t15779+1.0;
-                double t15781 = t15743*t15744;
-                double t15782 = t15781-1.0;
-                double t15783 = Aa*t15742*t15780*t15782*t15747*t15768*t15778*2.0;
-                double t15793 = t15742*t15743*t15744*t15747*t15767;
-                double t15784 = t15736+t15783-t15793;
-                double t15785 = t15711*t15754*t15784;
-                double t15786 = exp(t15785);
-                double t15787 = t15786-1.0;
-                double t15788 = 1.0/t15787;
-                double t15789 = gamma_ab*2.0;
-                double t15790 = gamma_aa+gamma_bb+t15789;
-                double t15791 = bet*t15711*t15712*t15713*t15714*t15753*t15790*t15788*(1.0/1.6E1);
-                double t15794 = 1.0/(t15710*t15710);
-                double t15814 = t15716*t15794;
-                double t15795 = t15715-t15814;
-                double t15796 = 1.0/pow(t15710,4.0/3.0);
-                double t15797 = t15791+1.0;
-                double t15798 = bet*bet;
-                double t15799 = 1.0/(gammas*gammas);
-                double t15800 = 1.0/(k*k);
-                double t15801 = 1.0/(pi_m12*pi_m12*pi_m12*pi_m12);
-                double t15802 = 1.0/pow(t15710,1.4E1/3.0);
-                double t15803 = 1.0/(t15787*t15787);
-                double t15804 = 1.0/(t15752*t15752*t15752*t15752);
-                double t15805 = t15790*t15790;
-                double t15806 = t15800*t15801*t15802*t15803*t15804*t15805*t15798*t15799*(1.0/2.56E2);
-                double t15807 = t15806+t15791+1.0;
-                double t15808 = 1.0/t15807;
-                double t15809 = bet*t15711*t15712*t15713*t15714*t15753*t15790*t15808*t15797*(1.0/1.6E1);
-                double t15810 = t15809+1.0;
-                double t15811 = t15752*t15752;
-                double t15812 = 1.0/pow(t15710,1.0E1/3.0);
-                double t15813 = 1.0/pow(t15738,1.0/3.0);
-                double t15815 = t15813*t15795*(1.0/3.0);
-                double t15816 = 1.0/pow(t15739,1.0/3.0);
-                double t15833 = t15816*t15795*(1.0/3.0);
-                double t15817 = t15815-t15833;
-                double t15818 = 1.0/t15732;
-                double t15819 = 1.0/(t15729*t15729);
-                double t15820 = 1.0/pow(t15710,5.0/3.0);
-                double t15821 = b4p*t15820*t15722*(2.0/3.0);
-                double t15822 = b2p*c*t15796*(1.0/3.0);
-                double t15823 = 1.0/sqrt(t15719);
-                double t15824 = b1p*c*t15823*t15796*(1.0/6.0);
-                double t15825 = b3p*c*t15720*t15796*(1.0/2.0);
-                double t15826 = t15821+t15822+t15824+t15825;
-                double t15827 = t15735*t15826*t15818*t15819;
-                double t15828 = 1.0/(t15710*t15710*t15710*t15710*t15710);
-                double t15829 = pow(t15738,1.0/3.0);
-                double t15830 = t15829*t15795*(4.0/3.0);
-                double t15831 = pow(t15739,1.0/3.0);
-                double t15837 = t15831*t15795*(4.0/3.0);
-                double t15832 = t15830-t15837;
-                double t15834 = bet*t15711*t15712*t15713*t15812*t15753*t15790*t15788*(7.0/4.8E1);
-                double t15835 = bet*t15711*t15712*t15713*t15714*t15754*t15790*t15817*t15788*(1.0/8.0);
-                double t15836 = t15742*t15716*t15743*t15737*t15747*t15767*4.0;
-                double t15838 = t15742*t15832*t15743*t15744*t15767;
-                double t15839 = 1.0/t15763;
-                double t15840 = 1.0/(t15760*t15760);
-                double t15841 = b4f*t15820*t15722*(2.0/3.0);
-                double t15842 = b2f*c*t15796*(1.0/3.0);
-                double t15843 = b1f*c*t15823*t15796*(1.0/6.0);
-                double t15844 = b3f*c*t15720*t15796*(1.0/2.0);
-                double t15845 = t15841+t15842+t15843+t15844;
-                double t15846 = a1f*c*c0f*t15764*t15796*(2.0/3.0);
-                double t15847 = a1p*c*c0p*t15733*t15796*(2.0/3.0);
-                double t15848 = t15744*t15828*4.0;
-                double t15862 = t15716*t15743*t15737*4.0;
-                double t15849 = -t15862+t15848;
-                double t15850 = Aa*t15742*t15780*t15747*t15768*t15849*t15778*2.0;
-                double t15851 = 1.0/t15777;
-                double t15852 = 1.0/(t15774*t15774);
-                double t15853 = b4a*t15820*t15722*(2.0/3.0);
-                double t15854 = b2a*c*t15796*(1.0/3.0);
-                double t15855 = b1a*c*t15823*t15796*(1.0/6.0);
-                double t15856 = b3a*c*t15720*t15796*(1.0/2.0);
-                double t15857 = t15853+t15854+t15855+t15856;
-                double t15858 = Aa*a1a*c*t15742*t15782*t15747*t15768*t15778*t15796*(2.0/3.0);
-                double t15859 = t15711*t15804*t15817*t15784*3.0;
-                double t15863 = t15840*t15845*t15766*t15839;
-                double t15860 = t15827-t15863+t15846-t15847;
-                double t15861 = t15742*t15743*t15860*t15744*t15747;
-                double t15864 = t15862-t15848;
-                double t15865 = log(t15810);
-                v_rho_a[Q] += scale * (-t15736-t15783+t15710*(t15861-t15827+t15836+t15838+t15847+t15858+gammas*t15811*t15817*t15865*3.0-(gammas*t15811*t15752*(bet*t15711*t15712*t15713*t15714*t15753*t15790*t15808*(t15834+t15835-bet*t15711*t15712*t15713*t15803*t15714*t15753*t15790*t15786*(t15859+t15711*t15754*(t15850-t15827+t15836+t15838+t15847+t15858+t15742*t15743*t15744*t15747*(t15827+t15846-t15840*t15845*t15766*t15839-a1p*c*c0p*t15733*t15796*(2.0/3.0))-t15742*t15744*t15747*t15828*t15767*4.0-Aa*t15742*t15832*t15780*t15782*t15768*t15778*2.0-t15742*t15851*t15780*t15852*t15782*t15747*t15857*t15768))*(1.0/1.6E1))*(1.0/1.6E1)+bet*t15711*t15712*t15713*t15812*t15753*t15790*t15808*t15797*(7.0/4.8E1)-bet*t15711*t15712*t15713*t15714*t15753*1.0/(t15807*t15807)*t15790*t15797*(t15834+t15835+1.0/pow(t15710,1.7E1/3.0)*t15800*t15801*t15803*t15804*t15805*t15798*t15799*(7.0/3.84E2)+t15800*t15801*t15802*t15803*t15805*1.0/(t15752*t15752*t15752*t15752*t15752)*t15817*t15798*t15799*(1.0/6.4E1)-bet*t15711*t15712*t15713*t15803*t15714*t15753*t15790*t15786*(t15859+t15711*t15754*(t15861-t15827+t15836+t15838+t15847+t15858-t15742*t15744*t15747*t15828*t15767*4.0-Aa*t15742*t15832*t15780*t15782*t15768*t15778*2.0-Aa*t15742*t15780*t15747*t15864*t15768*t15778*2.0-t15742*t15851*t15780*t15852*t15782*t15747*t15857*t15768))*(1.0/1.6E1)-t15800*t15801*t15802*t15804*t15805*t15786*1.0/(t15787*t15787*t15787)*t15798*t15799*(t15859+t15711*t15754*(t15850+t15861-t15827+t15836+t15838+t15847+t15858-t15742*t15744*t15747*t15828*t15767*4.0-Aa*t15742*t15832*t15780*t15782*t15768*t15778*2.0-t15742*t15851*t15780*t15852*t15782*t15747*t15857*t15768))*(1.0/1.28E2))*(1.0/1.6E1)+bet*t15711*t15712*t15713*t15714*t15754*t15790*t15808*t15817*t15797*(1.0/8.0)))/t15810-t15742*t15744*t15747*t15828*(t15736-t15792)*4.0-Aa*t15742*t15832*t15780*t15782*t15768*t15778*2.0-Aa*t15742*t15780*t15747*t15864*t15768*t15778*2.0-t15742*t15851*t15780*t15852*t15782*t15747*t15857*t15768)+gammas*t15811*t15752*t15865+t15742*t15743*t15744*t15747*(t15736-t15792));
-            }
-            
-            // v_rho_b
-            if (deriv >= 1) {
-                double t15867 = rho_a+rho_b;
-                double t15868 = 1.0/gammas;
-                double t15869 = 1.0/k;
-                double t15870 = 1.0/(pi_m12*pi_m12);
-                double t15871 = 1.0/pow(t15867,7.0/3.0);
-                double t15872 = 1.0/t15867;
-                double t15873 = rho_a-rho_b;
-                double t15874 = t15872*t15873;
-                double t15875 = 1.0/pow(t15867,1.0/3.0);
-                double t15876 = c*t15875;
-                double t15877 = sqrt(t15876);
-                double t15878 = pow(t15876,3.0/2.0);
-                double t15879 = c*c;
-                double t15880 = 1.0/pow(t15867,2.0/3.0);
-                double t15881 = 1.0/c0p;
-                double t15882 = b1p*t15877;
-                double t15883 = b3p*t15878;
-                double t15884 = b4p*t15880*t15879;
-                double t15885 = b2p*c*t15875;
-                double t15886 = t15882+t15883+t15884+t15885;
-                double t15887 = 1.0/t15886;
-                double t15888 = t15881*t15887*(1.0/2.0);
-                double t15889 = t15888+1.0;
-                double t15890 = log(t15889);
-                double t15891 = a1p*c*t15875;
-                double t15892 = t15891+1.0;
-                double t15893 = c0p*t15890*t15892*2.0;
-                double t15894 = t15873*t15873;
-                double t15895 = t15874+1.0;
-                double t15896 = -t15874+1.0;
-                double t15897 = two_13*2.0;
-                double t15898 = t15897-2.0;
-                double t15899 = 1.0/t15898;
-                double t15900 = 1.0/(t15867*t15867*t15867*t15867);
-                double t15901 = t15894*t15894;
-                double t15902 = pow(t15895,4.0/3.0);
-                double t15903 = pow(t15896,4.0/3.0);
-                double t15904 = t15902+t15903-2.0;
-                double t15905 = pow(t15895,2.0/3.0);
-                double t15906 = t15905*(1.0/2.0);
-                double t15907 = pow(t15896,2.0/3.0);
-                double t15908 = t15907*(1.0/2.0);
-                double t15909 = t15906+t15908;
-                double t15910 = 1.0/(t15909*t15909);
-                double t15911 = 1.0/(t15909*t15909*t15909);
-                double t15912 = 1.0/c0f;
-                double t15913 = b1f*t15877;
-                double t15914 = b3f*t15878;
-                double t15915 = b4f*t15880*t15879;
-                double t15916 = b2f*c*t15875;
-                double t15917 = t15913+t15914+t15915+t15916;
-                double t15918 = 1.0/t15917;
-                double t15919 = t15912*t15918*(1.0/2.0);
-                double t15920 = t15919+1.0;
-                double t15921 = log(t15920);
-                double t15922 = a1f*c*t15875;
-                double t15923 = t15922+1.0;
-                double t15949 = c0f*t15921*t15923*2.0;
-                double t15924 = t15893-t15949;
-                double t15925 = 1.0/d2fz0;
-                double t15926 = 1.0/Aa;
-                double t15927 = b1a*t15877;
-                double t15928 = b3a*t15878;
-                double t15929 = b4a*t15880*t15879;
-                double t15930 = b2a*c*t15875;
-                double t15931 = t15930+t15927+t15928+t15929;
-                double t15932 = 1.0/t15931;
-                double t15933 = t15932*t15926*(1.0/2.0);
-                double t15934 = t15933+1.0;
-                double t15935 = log(t15934);
-                double t15936 = a1a*c*t15875;
-                double t15937 = t15936+1.0;
-                double t15938 = t15900*t15901;
-                double t15939 = t15938-1.0;
-                double t15940 = Aa*t15904*t15925*t15935*t15937*t15939*t15899*2.0;
-                double t15950 = t15900*t15901*t15904*t15924*t15899;
-                double t15941 = t15940-t15950+t15893;
-                double t15942 = t15911*t15941*t15868;
-                double t15943 = exp(t15942);
-                double t15944 = t15943-1.0;
-                double t15945 = 1.0/t15944;
-                double t15946 = gamma_ab*2.0;
-                double t15947 = gamma_aa+gamma_bb+t15946;
-                double t15948 = bet*t15910*t15870*t15871*t15945*t15947*t15868*t15869*(1.0/1.6E1);
-                double t15951 = 1.0/(t15867*t15867);
-                double t15952 = t15951*t15873;
-                double t15953 = t15952+t15872;
-                double t15954 = 1.0/pow(t15867,4.0/3.0);
-                double t15955 = t15948+1.0;
-                double t15956 = bet*bet;
-                double t15957 = 1.0/(gammas*gammas);
-                double t15958 = 1.0/(k*k);
-                double t15959 = 1.0/(pi_m12*pi_m12*pi_m12*pi_m12);
-                double t15960 = 1.0/pow(t15867,1.4E1/3.0);
-                double t15961 = 1.0/(t15944*t15944);
-                double t15962 = 1.0/(t15909*t15909*t15909*t15909);
-                double t15963 = t15947*t15947;
-                double t15964 = t15960*t15961*t15962*t15963*t15956*t15957*t15958*t15959*(1.0/2.56E2);
-                double t15965 = t15964+t15948+1.0;
-                double t15966 = 1.0/t15965;
-                double t15967 = bet*t15910*t15870*t15871*t15955*t15947*t15966*t15868*t15869*(1.0/1.6E1);
-                double t15968 = t15967+1.0;
-                double t15969 = t15909*t15909;
-                double t15970 = 1.0/pow(t15867,1.0E1/3.0);
-                double t15971 = 1.0/pow(t15895,1.0/3.0);
-                double t15972 = t15953*t15971*(1.0/3.0);
-                double t15973 = 1.0/pow(t15896,1.0/3.0);
-                double t15990 = t15953*t15973*(1.0/3.0);
-                double t15974 = t15972-t15990;
-                double t15975 = 1.0/t15889;
-                double t15976 = 1.0/(t15886*t15886);
-                double t15977 = 1.0/pow(t15867,5.0/3.0);
-                double t15978 = b4p*t15977*t15879*(2.0/3.0);
-                double t15979 = b2p*c*t15954*(1.0/3.0);
-                double t15980 = 1.0/sqrt(t15876);
-                double t15981 = b1p*c*t15980*t15954*(1.0/6.0);
-                double t15982 = b3p*c*t15954*t15877*(1.0/2.0);
-                double t15983 = t15981+t15982+t15978+t15979;
-                double t15984 = 1.0/(t15867*t15867*t15867*t15867*t15867);
-                double t15985 = pow(t15895,1.0/3.0);
-                double t15986 = t15953*t15985*(4.0/3.0);
-                double t15987 = pow(t15896,1.0/3.0);
-                double t15994 = t15953*t15987*(4.0/3.0);
-                double t15988 = -t15994+t15986;
-                double t15989 = t15892*t15983*t15975*t15976;
-                double t15991 = bet*t15910*t15870*t15970*t15945*t15947*t15868*t15869*(7.0/4.8E1);
-                double t15992 = t15900*t15904*t15924*t15873*t15894*t15899*4.0;
-                double t15993 = t15901*t15904*t15924*t15984*t15899*4.0;
-                double t15995 = t15900*t15901*t15924*t15988*t15899;
-                double t15996 = 1.0/t15920;
-                double t15997 = 1.0/(t15917*t15917);
-                double t15998 = b4f*t15977*t15879*(2.0/3.0);
-                double t15999 = b2f*c*t15954*(1.0/3.0);
-                double t16000 = b1f*c*t15980*t15954*(1.0/6.0);
-                double t16001 = b3f*c*t15954*t15877*(1.0/2.0);
-                double t16002 = t15998+t15999+t16000+t16001;
-                double t16003 = a1f*c*c0f*t15921*t15954*(2.0/3.0);
-                double t16004 = t15900*t15873*t15894*4.0;
-                double t16005 = t15901*t15984*4.0;
-                double t16006 = t16004+t16005;
-                double t16007 = 1.0/t15934;
-                double t16008 = 1.0/(t15931*t15931);
-                double t16009 = b4a*t15977*t15879*(2.0/3.0);
-                double t16010 = b2a*c*t15954*(1.0/3.0);
-                double t16011 = b1a*c*t15980*t15954*(1.0/6.0);
-                double t16012 = b3a*c*t15954*t15877*(1.0/2.0);
-                double t16013 = t16010+t16011+t16012+t16009;
-                double t16014 = t15904*t15925*t15937*t15939*t15899*t16013*t16007*t16008;
-                double t16016 = a1p*c*c0p*t15890*t15954*(2.0/3.0);
-                double t16018 = t15923*t15996*t15997*t16002;
-                double t16015 = t15989+t16003-t16016-t16018;
-                double t16017 = t15941*t15962*t15974*t15868*3.0;
-                double t16022 = t15900*t15901*t15904*t15899*t16015;
-                double t16023 = Aa*t15925*t15935*t15937*t15939*t15988*t15899*2.0;
-                double t16024 = Aa*t15904*t15925*t15935*t15937*t15899*t16006*2.0;
-                double t16025 = Aa*a1a*c*t15904*t15925*t15935*t15954*t15939*t15899*(2.0/3.0);
-                double t16019 = t15992+t15993+t15995+t15989-t16022+t16014-t16023-t16024-t16016-t16025;
-                double t16020 = t15911*t15868*t16019;
-                double t16021 = t16020+t16017;
-                double t16026 = bet*t15910*t15870*t15871*t15943*t15961*t15947*t15868*t15869*t16021*(1.0/1.6E1);
-                double t16027 = log(t15968);
-                v_rho_b[Q] += scale * (-t15940-t15893-t15867*(t15992+t15993+t15995+t15989-t16022+t16014-t16023-t16024-t16016-t16025+gammas*t15974*t15969*t16027*3.0+(gammas*t15909*t15969*(bet*t15910*t15870*t15970*t15955*t15947*t15966*t15868*t15869*(7.0/4.8E1)+bet*t15910*t15870*t15871*t15947*t15966*t15868*t15869*(t15991+t16026-bet*t15911*t15870*t15871*t15945*t15947*t15974*t15868*t15869*(1.0/8.0))*(1.0/1.6E1)-bet*t15911*t15870*t15871*t15955*t15947*t15974*t15966*t15868*t15869*(1.0/8.0)-bet*t15910*t15870*t15871*t15955*t15947*1.0/(t15965*t15965)*t15868*t15869*(t15991+t16026+t15961*t15962*t15963*t15956*1.0/pow(t15867,1.7E1/3.0)*t15957*t15958*t15959*(7.0/3.84E2)-bet*t15911*t15870*t15871*t15945*t15947*t15974*t15868*t15869*(1.0/8.0)-t15960*t15961*1.0/(t15909*t15909*t15909*t15909*t15909)*t15963*t15956*t15974*t15957*t15958*t15959*(1.0/6.4E1)+t15960*t15943*1.0/(t15944*t15944*t15944)*t15962*t15963*t15956*t15957*t15958*t15959*t16021*(1.0/1.28E2))*(1.0/1.6E1)))/t15968)+gammas*t15909*t15969*t16027+t15900*t15901*t15904*t15899*(t15893-t15949));
-            }
-            
-            // v_gamma_aa
-            if (deriv >= 1) {
-                double t16029 = rho_a+rho_b;
-                double t16030 = 1.0/gammas;
-                double t16031 = 1.0/k;
-                double t16032 = 1.0/(pi_m12*pi_m12);
-                double t16033 = 1.0/pow(t16029,7.0/3.0);
-                double t16034 = 1.0/t16029;
-                double t16035 = rho_a-rho_b;
-                double t16036 = t16034*t16035;
-                double t16037 = 1.0/pow(t16029,1.0/3.0);
-                double t16038 = c*t16037;
-                double t16039 = sqrt(t16038);
-                double t16040 = pow(t16038,3.0/2.0);
-                double t16041 = c*c;
-                double t16042 = 1.0/pow(t16029,2.0/3.0);
-                double t16043 = 1.0/c0p;
-                double t16044 = b1p*t16039;
-                double t16045 = b3p*t16040;
-                double t16046 = b4p*t16041*t16042;
-                double t16047 = b2p*c*t16037;
-                double t16048 = t16044+t16045+t16046+t16047;
-                double t16049 = 1.0/t16048;
-                double t16050 = t16043*t16049*(1.0/2.0);
-                double t16051 = t16050+1.0;
-                double t16052 = log(t16051);
-                double t16053 = a1p*c*t16037;
-                double t16054 = t16053+1.0;
-                double t16055 = c0p*t16052*t16054*2.0;
-                double t16056 = t16035*t16035;
-                double t16057 = t16036+1.0;
-                double t16058 = -t16036+1.0;
-                double t16059 = two_13*2.0;
-                double t16060 = t16059-2.0;
-                double t16061 = 1.0/t16060;
-                double t16062 = 1.0/(t16029*t16029*t16029*t16029);
-                double t16063 = t16056*t16056;
-                double t16064 = pow(t16057,4.0/3.0);
-                double t16065 = pow(t16058,4.0/3.0);
-                double t16066 = t16064+t16065-2.0;
-                double t16067 = pow(t16057,2.0/3.0);
-                double t16068 = t16067*(1.0/2.0);
-                double t16069 = pow(t16058,2.0/3.0);
-                double t16070 = t16069*(1.0/2.0);
-                double t16071 = t16070+t16068;
-                double t16072 = 1.0/(t16071*t16071);
-                double t16073 = 1.0/(t16071*t16071*t16071);
-                double t16074 = 1.0/c0f;
-                double t16075 = b1f*t16039;
-                double t16076 = b3f*t16040;
-                double t16077 = b4f*t16041*t16042;
-                double t16078 = b2f*c*t16037;
-                double t16079 = t16075+t16076+t16077+t16078;
-                double t16080 = 1.0/t16079;
-                double t16081 = t16080*t16074*(1.0/2.0);
-                double t16082 = t16081+1.0;
-                double t16083 = log(t16082);
-                double t16084 = a1f*c*t16037;
-                double t16085 = t16084+1.0;
-                double t16111 = c0f*t16083*t16085*2.0;
-                double t16086 = -t16111+t16055;
-                double t16087 = 1.0/d2fz0;
-                double t16088 = 1.0/Aa;
-                double t16089 = b1a*t16039;
-                double t16090 = b3a*t16040;
-                double t16091 = b4a*t16041*t16042;
-                double t16092 = b2a*c*t16037;
-                double t16093 = t16090+t16091+t16092+t16089;
-                double t16094 = 1.0/t16093;
-                double t16095 = t16094*t16088*(1.0/2.0);
-                double t16096 = t16095+1.0;
-                double t16097 = log(t16096);
-                double t16098 = a1a*c*t16037;
-                double t16099 = t16098+1.0;
-                double t16100 = t16062*t16063;
-                double t16101 = t16100-1.0;
-                double t16102 = Aa*t16101*t16061*t16066*t16087*t16097*t16099*2.0;
-                double t16103 = t16102+t16055-t16061*t16062*t16063*t16066*t16086;
-                double t16104 = t16030*t16103*t16073;
-                double t16105 = exp(t16104);
-                double t16106 = t16105-1.0;
-                double t16107 = 1.0/t16106;
-                double t16108 = gamma_ab*2.0;
-                double t16109 = gamma_aa+gamma_bb+t16108;
-                double t16110 = bet*t16030*t16031*t16032*t16033*t16107*t16072*t16109*(1.0/1.6E1);
-                double t16112 = t16071*t16071;
-                double t16113 = t16111-t16055;
-                double t16114 = t16113*t16061*t16062*t16063*t16066;
-                double t16115 = t16102+t16114+t16055;
-                double t16116 = t16030*t16115*t16073;
-                double t16117 = exp(t16116);
-                double t16118 = t16117-1.0;
-                double t16119 = 1.0/t16118;
-                double t16120 = bet*t16030*t16031*t16032*t16033*t16072*t16109*t16119*(1.0/1.6E1);
-                double t16121 = bet*bet;
-                double t16122 = 1.0/(gammas*gammas);
-                double t16123 = 1.0/(k*k);
-                double t16124 = 1.0/(pi_m12*pi_m12*pi_m12*pi_m12);
-                double t16125 = 1.0/pow(t16029,1.4E1/3.0);
-                double t16126 = 1.0/(t16118*t16118);
-                double t16127 = 1.0/(t16071*t16071*t16071*t16071);
-                double t16128 = t16109*t16109;
-                double t16129 = t16121*t16122*t16123*t16124*t16125*t16126*t16127*t16128*(1.0/2.56E2);
-                double t16130 = t16120+t16129+1.0;
-                double t16131 = 1.0/t16130;
-                double t16132 = t16120+1.0;
-                v_gamma_aa[Q] += scale * ((gammas*t16112*t16071*t16029*(bet*t16030*t16031*t16032*t16131*t16033*t16132*t16072*(1.0/1.6E1)+t16121*t16122*t16131*t16123*t16124*t16125*t16109*t16127*t16119*(1.0/2.56E2)-bet*t16030*t16031*1.0/(t16130*t16130)*t16032*t16033*t16132*t16072*t16109*(bet*t16030*t16031*t16032*t16033*t16072*t16119*(1.0/1.6E1)+t16121*t16122*t16123*t16124*t16125*t16126*t16127*(gamma_aa*2.0+gamma_ab*4.0+gamma_bb*2.0)*(1.0/2.56E2))*(1.0/1.6E1)))/((bet*t16030*t16031*t16032*t16033*t16072*t16109*(t16110+1.0)*(1.0/1.6E1))/(t16110+t16129+1.0)+1.0));
-            }
-            
-            // v_gamma_ab
-            if (deriv >= 1) {
-                double t16134 = rho_a+rho_b;
-                double t16135 = 1.0/gammas;
-                double t16136 = 1.0/k;
-                double t16137 = 1.0/(pi_m12*pi_m12);
-                double t16138 = 1.0/pow(t16134,7.0/3.0);
-                double t16139 = 1.0/t16134;
-                double t16140 = rho_a-rho_b;
-                double t16141 = t16140*t16139;
-                double t16142 = 1.0/pow(t16134,1.0/3.0);
-                double t16143 = c*t16142;
-                double t16144 = sqrt(t16143);
-                double t16145 = pow(t16143,3.0/2.0);
-                double t16146 = c*c;
-                double t16147 = 1.0/pow(t16134,2.0/3.0);
-                double t16148 = 1.0/c0p;
-                double t16149 = b1p*t16144;
-                double t16150 = b3p*t16145;
-                double t16151 = b4p*t16146*t16147;
-                double t16152 = b2p*c*t16142;
-                double t16153 = t16150+t16151+t16152+t16149;
-                double t16154 = 1.0/t16153;
-                double t16155 = t16154*t16148*(1.0/2.0);
-                double t16156 = t16155+1.0;
-                double t16157 = log(t16156);
-                double t16158 = a1p*c*t16142;
-                double t16159 = t16158+1.0;
-                double t16160 = c0p*t16157*t16159*2.0;
-                double t16161 = t16140*t16140;
-                double t16162 = t16141+1.0;
-                double t16163 = -t16141+1.0;
-                double t16164 = two_13*2.0;
-                double t16165 = t16164-2.0;
-                double t16166 = 1.0/t16165;
-                double t16167 = 1.0/(t16134*t16134*t16134*t16134);
-                double t16168 = t16161*t16161;
-                double t16169 = pow(t16162,4.0/3.0);
-                double t16170 = pow(t16163,4.0/3.0);
-                double t16171 = t16170+t16169-2.0;
-                double t16172 = pow(t16162,2.0/3.0);
-                double t16173 = t16172*(1.0/2.0);
-                double t16174 = pow(t16163,2.0/3.0);
-                double t16175 = t16174*(1.0/2.0);
-                double t16176 = t16173+t16175;
-                double t16177 = 1.0/(t16176*t16176);
-                double t16178 = 1.0/(t16176*t16176*t16176);
-                double t16179 = 1.0/c0f;
-                double t16180 = b1f*t16144;
-                double t16181 = b3f*t16145;
-                double t16182 = b4f*t16146*t16147;
-                double t16183 = b2f*c*t16142;
-                double t16184 = t16180+t16181+t16182+t16183;
-                double t16185 = 1.0/t16184;
-                double t16186 = t16185*t16179*(1.0/2.0);
-                double t16187 = t16186+1.0;
-                double t16188 = log(t16187);
-                double t16189 = a1f*c*t16142;
-                double t16190 = t16189+1.0;
-                double t16216 = c0f*t16190*t16188*2.0;
-                double t16191 = t16160-t16216;
-                double t16192 = 1.0/d2fz0;
-                double t16193 = 1.0/Aa;
-                double t16194 = b1a*t16144;
-                double t16195 = b3a*t16145;
-                double t16196 = b4a*t16146*t16147;
-                double t16197 = b2a*c*t16142;
-                double t16198 = t16194+t16195+t16196+t16197;
-                double t16199 = 1.0/t16198;
-                double t16200 = t16193*t16199*(1.0/2.0);
-                double t16201 = t16200+1.0;
-                double t16202 = log(t16201);
-                double t16203 = a1a*c*t16142;
-                double t16204 = t16203+1.0;
-                double t16205 = t16167*t16168;
-                double t16206 = t16205-1.0;
-                double t16207 = Aa*t16202*t16204*t16206*t16171*t16192*t16166*2.0;
-                double t16217 = t16171*t16191*t16166*t16167*t16168;
-                double t16208 = t16160+t16207-t16217;
-                double t16209 = t16135*t16208*t16178;
-                double t16210 = exp(t16209);
-                double t16211 = t16210-1.0;
-                double t16212 = 1.0/t16211;
-                double t16213 = gamma_ab*2.0;
-                double t16214 = gamma_aa+gamma_bb+t16213;
-                double t16215 = bet*t16212*t16214*t16135*t16136*t16137*t16138*t16177*(1.0/1.6E1);
-                double t16218 = t16176*t16176;
-                double t16219 = t16215+1.0;
-                double t16220 = bet*bet;
-                double t16221 = 1.0/(gammas*gammas);
-                double t16222 = 1.0/(k*k);
-                double t16223 = 1.0/(pi_m12*pi_m12*pi_m12*pi_m12);
-                double t16224 = 1.0/pow(t16134,1.4E1/3.0);
-                double t16225 = 1.0/(t16211*t16211);
-                double t16226 = 1.0/(t16176*t16176*t16176*t16176);
-                double t16227 = t16214*t16214;
-                double t16228 = t16220*t16221*t16222*t16223*t16224*t16225*t16226*t16227*(1.0/2.56E2);
-                double t16229 = t16215+t16228+1.0;
-                double t16230 = 1.0/t16229;
-                v_gamma_ab[Q] += scale * ((gammas*t16134*t16218*t16176*(bet*t16230*t16135*t16136*t16137*t16138*t16219*t16177*(1.0/8.0)+t16220*t16212*t16221*t16230*t16222*t16214*t16223*t16224*t16226*(1.0/1.28E2)-bet*t16214*t16135*t16136*t16137*t16138*t16219*1.0/(t16229*t16229)*t16177*(bet*t16212*t16135*t16136*t16137*t16138*t16177*(1.0/8.0)+t16220*t16221*t16222*t16223*t16224*t16225*t16226*(gamma_aa*4.0+gamma_ab*8.0+gamma_bb*4.0)*(1.0/2.56E2))*(1.0/1.6E1)))/(bet*t16230*t16214*t16135*t16136*t16137*t16138*t16219*t16177*(1.0/1.6E1)+1.0));
-            }
-            
-            // v_gamma_bb
-            if (deriv >= 1) {
-                double t16232 = rho_a+rho_b;
-                double t16233 = 1.0/gammas;
-                double t16234 = 1.0/k;
-                double t16235 = 1.0/(pi_m12*pi_m12);
-                double t16236 = 1.0/pow(t16232,7.0/3.0);
-                double t16237 = 1.0/t16232;
-                double t16238 = rho_a-rho_b;
-                double t16239 = t16237*t16238;
-                double t16240 = 1.0/pow(t16232,1.0/3.0);
-                double t16241 = c*t16240;
-                double t16242 = sqrt(t16241);
-                double t16243 = pow(t16241,3.0/2.0);
-                double t16244 = c*c;
-                double t16245 = 1.0/pow(t16232,2.0/3.0);
-                double t16246 = 1.0/c0p;
-                double t16247 = b1p*t16242;
-                double t16248 = b3p*t16243;
-                double t16249 = b4p*t16244*t16245;
-                double t16250 = b2p*c*t16240;
-                double t16251 = t16250+t16247+t16248+t16249;
-                double t16252 = 1.0/t16251;
-                double t16253 = t16252*t16246*(1.0/2.0);
-                double t16254 = t16253+1.0;
-                double t16255 = log(t16254);
-                double t16256 = a1p*c*t16240;
-                double t16257 = t16256+1.0;
-                double t16258 = c0p*t16255*t16257*2.0;
-                double t16259 = t16238*t16238;
-                double t16260 = t16239+1.0;
-                double t16261 = -t16239+1.0;
-                double t16262 = two_13*2.0;
-                double t16263 = t16262-2.0;
-                double t16264 = 1.0/t16263;
-                double t16265 = 1.0/(t16232*t16232*t16232*t16232);
-                double t16266 = t16259*t16259;
-                double t16267 = pow(t16260,4.0/3.0);
-                double t16268 = pow(t16261,4.0/3.0);
-                double t16269 = t16267+t16268-2.0;
-                double t16270 = pow(t16260,2.0/3.0);
-                double t16271 = t16270*(1.0/2.0);
-                double t16272 = pow(t16261,2.0/3.0);
-                double t16273 = t16272*(1.0/2.0);
-                double t16274 = t16271+t16273;
-                double t16275 = 1.0/(t16274*t16274);
-                double t16276 = 1.0/(t16274*t16274*t16274);
-                double t16277 = 1.0/c0f;
-                double t16278 = b1f*t16242;
-                double t16279 = b3f*t16243;
-                double t16280 = b4f*t16244*t16245;
-                double t16281 = b2f*c*t16240;
-                double t16282 = t16280+t16281+t16278+t16279;
-                double t16283 = 1.0/t16282;
-                double t16284 = t16283*t16277*(1.0/2.0);
-                double t16285 = t16284+1.0;
-                double t16286 = log(t16285);
-                double t16287 = a1f*c*t16240;
-                double t16288 = t16287+1.0;
-                double t16314 = c0f*t16286*t16288*2.0;
-                double t16289 = -t16314+t16258;
-                double t16290 = 1.0/d2fz0;
-                double t16291 = 1.0/Aa;
-                double t16292 = b1a*t16242;
-                double t16293 = b3a*t16243;
-                double t16294 = b4a*t16244*t16245;
-                double t16295 = b2a*c*t16240;
-                double t16296 = t16292+t16293+t16294+t16295;
-                double t16297 = 1.0/t16296;
-                double t16298 = t16291*t16297*(1.0/2.0);
-                double t16299 = t16298+1.0;
-                double t16300 = log(t16299);
-                double t16301 = a1a*c*t16240;
-                double t16302 = t16301+1.0;
-                double t16303 = t16265*t16266;
-                double t16304 = t16303-1.0;
-                double t16305 = Aa*t16300*t16302*t16304*t16290*t16264*t16269*2.0;
-                double t16306 = t16305+t16258-t16264*t16265*t16266*t16269*t16289;
-                double t16307 = t16233*t16306*t16276;
-                double t16308 = exp(t16307);
-                double t16309 = t16308-1.0;
-                double t16310 = 1.0/t16309;
-                double t16311 = gamma_ab*2.0;
-                double t16312 = gamma_aa+gamma_bb+t16311;
-                double t16313 = bet*t16310*t16312*t16233*t16234*t16235*t16236*t16275*(1.0/1.6E1);
-                double t16315 = t16274*t16274;
-                double t16316 = t16314-t16258;
-                double t16317 = t16316*t16264*t16265*t16266*t16269;
-                double t16318 = t16305+t16317+t16258;
-                double t16319 = t16233*t16318*t16276;
-                double t16320 = exp(t16319);
-                double t16321 = t16320-1.0;
-                double t16322 = 1.0/t16321;
-                double t16323 = bet*t16312*t16322*t16233*t16234*t16235*t16236*t16275*(1.0/1.6E1);
-                double t16324 = bet*bet;
-                double t16325 = 1.0/(gammas*gammas);
-                double t16326 = 1.0/(k*k);
-                double t16327 = 1.0/(pi_m12*pi_m12*pi_m12*pi_m12);
-                double t16328 = 1.0/pow(t16232,1.4E1/3.0);
-                double t16329 = 1.0/(t16321*t16321);
-                double t16330 = 1.0/(t16274*t16274*t16274*t16274);
-                double t16331 = t16312*t16312;
-                double t16332 = t16330*t16331*t16324*t16325*t16326*t16327*t16328*t16329*(1.0/2.56E2);
-                double t16333 = t16323+t16332+1.0;
-                double t16334 = 1.0/t16333;
-                double t16335 = t16323+1.0;
-                v_gamma_bb[Q] += scale * ((gammas*t16232*t16315*t16274*(bet*t16233*t16234*t16235*t16334*t16236*t16335*t16275*(1.0/1.6E1)+t16312*t16330*t16322*t16324*t16325*t16334*t16326*t16327*t16328*(1.0/2.56E2)-bet*t16312*t16233*t16234*1.0/(t16333*t16333)*t16235*t16236*t16335*t16275*(bet*t16322*t16233*t16234*t16235*t16236*t16275*(1.0/1.6E1)+t16330*t16324*t16325*t16326*t16327*t16328*t16329*(gamma_aa*2.0+gamma_ab*4.0+gamma_bb*2.0)*(1.0/2.56E2))*(1.0/1.6E1)))/((bet*t16312*t16233*t16234*t16235*t16236*t16275*(t16313+1.0)*(1.0/1.6E1))/(t16313+t16332+1.0)+1.0));
-            }
-            
+            // v and the first partials are done in the loop above
+
         }
     }
 }
@@ -65,6 +65,10 @@ PW92_CFunctional::~PW92_CFunctional()
 {
 }
 void PW92_CFunctional::compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha)
+{
+    compute_block(FunctionalPoints::from_maps(in, out), npoints, deriv, alpha);
+}
+void PW92_CFunctional::compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha)
 {
     double c = parameters_["c"];
     double two_13 = parameters_["two_13"];
@@ -102,17 +106,17 @@ void PW92_CFunctional::compute_functional(const std::map<std::string,SharedVecto
     double* tau_bp = NULL;
 
     if (true) {
-        rho_ap = in.find("RHO_A")->second->pointer();
-        rho_bp = in.find("RHO_B")->second->pointer();
+        rho_ap = points.in[FunctionalPoints::RHO_A];
+        rho_bp = points.in[FunctionalPoints::RHO_B];
     }
     if (gga_) {  
-        gamma_aap = in.find("GAMMA_AA")->second->pointer();
-        gamma_abp = in.find("GAMMA_AB")->second->pointer();
-        gamma_bbp = in.find("GAMMA_BB")->second->pointer();
+        gamma_aap = points.in[FunctionalPoints::GAMMA_AA];
+        gamma_abp = points.in[FunctionalPoints::GAMMA_AB];
+        gamma_bbp = points.in[FunctionalPoints::GAMMA_BB];
     } 
     if (meta_)  {
-        tau_ap = in.find("TAU_A")->second->pointer();
-        tau_bp = in.find("TAU_B")->second->pointer();
+        tau_ap = points.in[FunctionalPoints::TAU_A];
+        tau_bp = points.in[FunctionalPoints::TAU_B];
     }
 
     // => Outut variables <= //
@@ -157,63 +161,294 @@ void PW92_CFunctional::compute_functional(const std::map<std::string,SharedVecto
     double* v_gamma_bb_tau_b = NULL;
 
     if (deriv >= 0) {
-        v = out.find("V")->second->pointer();
+        v = points.out[FunctionalPoints::V];
     } 
     if (deriv >= 1) {
         if (true) {
-            v_rho_a = out.find("V_RHO_A")->second->pointer();
-            v_rho_b = out.find("V_RHO_B")->second->pointer();
+            v_rho_a = points.out[FunctionalPoints::V_RHO_A];
+            v_rho_b = points.out[FunctionalPoints::V_RHO_B];
         }
         if (gga_) {
-            v_gamma_aa = out.find("V_GAMMA_AA")->second->pointer();
-            v_gamma_ab = out.find("V_GAMMA_AB")->second->pointer();
-            v_gamma_bb = out.find("V_GAMMA_BB")->second->pointer();
+            v_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA];
+            v_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB];
+            v_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB];
         }
         if (meta_) {    
-            v_tau_a = out.find("V_TAU_A")->second->pointer();
-            v_tau_b = out.find("V_TAU_B")->second->pointer();
+            v_tau_a = points.out[FunctionalPoints::V_TAU_A];
+            v_tau_b = points.out[FunctionalPoints::V_TAU_B];
         }
     }
     if (deriv >= 2) {
         if (true) {
-            v_rho_a_rho_a = out.find("V_RHO_A_RHO_A")->second->pointer();
-            v_rho_a_rho_b = out.find("V_RHO_A_RHO_B")->second->pointer();
-            v_rho_b_rho_b = out.find("V_RHO_B_RHO_B")->second->pointer();
+            v_rho_a_rho_a = points.out[FunctionalPoints::V_RHO_A_RHO_A];
+            v_rho_a_rho_b = points.out[FunctionalPoints::V_RHO_A_RHO_B];
+            v_rho_b_rho_b = points.out[FunctionalPoints::V_RHO_B_RHO_B];
         }
         if (gga_) {
-            v_gamma_aa_gamma_aa = out.find("V_GAMMA_AA_GAMMA_AA")->second->pointer();
-            v_gamma_aa_gamma_ab = out.find("V_GAMMA_AA_GAMMA_AB")->second->pointer();
-            v_gamma_aa_gamma_bb = out.find("V_GAMMA_AA_GAMMA_BB")->second->pointer();
-            v_gamma_ab_gamma_ab = out.find("V_GAMMA_AB_GAMMA_AB")->second->pointer();
-            v_gamma_ab_gamma_bb = out.find("V_GAMMA_AB_GAMMA_BB")->second->pointer();
-            v_gamma_bb_gamma_bb = out.find("V_GAMMA_BB_GAMMA_BB")->second->pointer();
+            v_gamma_aa_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_AA];
+            v_gamma_aa_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_AB];
+            v_gamma_aa_gamma_bb = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_BB];
+            v_gamma_ab_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB_GAMMA_AB];
+            v_gamma_ab_gamma_bb = points.out[FunctionalPoints::V_GAMMA_AB_GAMMA_BB];
+            v_gamma_bb_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB_GAMMA_BB];
         }
         if (meta_) {
-            v_tau_a_tau_a = out.find("V_TAU_A_TAU_A")->second->pointer();
-            v_tau_a_tau_b = out.find("V_TAU_A_TAU_B")->second->pointer();
-            v_tau_b_tau_b = out.find("V_TAU_B_TAU_B")->second->pointer();
+            v_tau_a_tau_a = points.out[FunctionalPoints::V_TAU_A_TAU_A];
+            v_tau_a_tau_b = points.out[FunctionalPoints::V_TAU_A_TAU_B];
+            v_tau_b_tau_b = points.out[FunctionalPoints::V_TAU_B_TAU_B];
         }
         if (gga_) {
-            v_rho_a_gamma_aa = out.find("V_RHO_A_GAMMA_AA")->second->pointer();
-            v_rho_a_gamma_ab = out.find("V_RHO_A_GAMMA_AB")->second->pointer();
-            v_rho_a_gamma_bb = out.find("V_RHO_A_GAMMA_BB")->second->pointer();
-            v_rho_b_gamma_aa = out.find("V_RHO_B_GAMMA_AA")->second->pointer();
-            v_rho_b_gamma_ab = out.find("V_RHO_B_GAMMA_AB")->second->pointer();
-            v_rho_b_gamma_bb = out.find("V_RHO_B_GAMMA_BB")->second->pointer();
+            v_rho_a_gamma_aa = points.out[FunctionalPoints::V_RHO_A_GAMMA_AA];
+            v_rho_a_gamma_ab = points.out[FunctionalPoints::V_RHO_A_GAMMA_AB];
+            v_rho_a_gamma_bb = points.out[FunctionalPoints::V_RHO_A_GAMMA_BB];
+            v_rho_b_gamma_aa = points.out[FunctionalPoints::V_RHO_B_GAMMA_AA];
+            v_rho_b_gamma_ab = points.out[FunctionalPoints::V_RHO_B_GAMMA_AB];
+            v_rho_b_gamma_bb = points.out[FunctionalPoints::V_RHO_B_GAMMA_BB];
         }
         if (meta_) {
-            v_rho_a_tau_a = out.find("V_RHO_A_TAU_A")->second->pointer();
-            v_rho_a_tau_b = out.find("V_RHO_A_TAU_B")->second->pointer();
-            v_rho_b_tau_a = out.find("V_RHO_B_TAU_A")->second->pointer();
-            v_rho_b_tau_b = out.find("V_RHO_B_TAU_B")->second->pointer();
+            v_rho_a_tau_a = points.out[FunctionalPoints::V_RHO_A_TAU_A];
+            v_rho_a_tau_b = points.out[FunctionalPoints::V_RHO_A_TAU_B];
+            v_rho_b_tau_a = points.out[FunctionalPoints::V_RHO_B_TAU_A];
+            v_rho_b_tau_b = points.out[FunctionalPoints::V_RHO_B_TAU_B];
         }
         if (gga_ && meta_) {
-            v_gamma_aa_tau_a = out.find("V_GAMMA_AA_TAU_A")->second->pointer();
-            v_gamma_aa_tau_b = out.find("V_GAMMA_AA_TAU_B")->second->pointer();
-            v_gamma_ab_tau_a = out.find("V_GAMMA_AB_TAU_A")->second->pointer();
-            v_gamma_ab_tau_b = out.find("V_GAMMA_AB_TAU_B")->second->pointer();
-            v_gamma_bb_tau_a = out.find("V_GAMMA_BB_TAU_A")->second->pointer();
-            v_gamma_bb_tau_b = out.find("V_GAMMA_BB_TAU_B")->second->pointer();
+            v_gamma_aa_tau_a = points.out[FunctionalPoints::V_GAMMA_AA_TAU_A];
+            v_gamma_aa_tau_b = points.out[FunctionalPoints::V_GAMMA_AA_TAU_B];
+            v_gamma_ab_tau_a = points.out[FunctionalPoints::V_GAMMA_AB_TAU_A];
+            v_gamma_ab_tau_b = points.out[FunctionalPoints::V_GAMMA_AB_TAU_B];
+            v_gamma_bb_tau_a = points.out[FunctionalPoints::V_GAMMA_BB_TAU_A];
+            v_gamma_bb_tau_b = points.out[FunctionalPoints::V_GAMMA_BB_TAU_B];
+        }
+    }
+
+    // => Straight-line loop over points with both spins above the cutoff <= //
+
+    // Same expressions as the general branch of the loop below, for the
+    // value and first partials.  Points with either density below the
+    // cutoff are evaluated at a harmless dummy point and masked to zero,
+    // so the body has no switches and the loop can be vectorized.
+
+    double* restrict vp = v;
+    double* restrict v_rho_ap = v_rho_a;
+    double* restrict v_rho_bp = v_rho_b;
+
+    for (int Q = 0; Q < npoints; Q++) {
+
+        bool on = (rho_ap[Q] >= lsda_cutoff_ && rho_bp[Q] >= lsda_cutoff_);
+        double mask = (on ? 1.0 : 0.0);
+        double rho_a = (on ? rho_ap[Q] : 1.0);
+        double rho_b = (on ? rho_bp[Q] : 1.0);
+
+        // v
+        if (deriv >= 0) {
+            double t14259 = rho_a+rho_b;
+            double t14260 = 1.0/pow(t14259,1.0/3.0);
+            double t14261 = c*t14260;
+            double t14262 = sqrt(t14261);
+            double t14263 = pow(t14261,3.0/2.0);
+            double t14264 = c*c;
+            double t14265 = 1.0/pow(t14259,2.0/3.0);
+            double t14266 = 1.0/c0p;
+            double t14267 = b1p*t14262;
+            double t14268 = b3p*t14263;
+            double t14269 = b4p*t14264*t14265;
+            double t14270 = b2p*c*t14260;
+            double t14271 = t14270+t14267+t14268+t14269;
+            double t14272 = 1.0/t14271;
+            double t14273 = t14272*t14266*(1.0/2.0);
+            double t14274 = t14273+1.0;
+            double t14275 = log(t14274);
+            double t14276 = a1p*c*t14260;
+            double t14277 = t14276+1.0;
+            double t14278 = c0p*t14275*t14277*2.0;
+            double t14279 = rho_a-rho_b;
+            double t14280 = t14279*t14279;
+            double t14281 = 1.0/t14259;
+            double t14282 = t14281*t14279;
+            double t14283 = two_13*2.0;
+            double t14284 = t14283-2.0;
+            double t14285 = 1.0/t14284;
+            double t14286 = 1.0/(t14259*t14259*t14259*t14259);
+            double t14287 = t14280*t14280;
+            double t14288 = t14282+1.0;
+            double t14289 = pow(t14288,4.0/3.0);
+            double t14290 = -t14282+1.0;
+            double t14291 = pow(t14290,4.0/3.0);
+            double t14292 = t14291+t14289-2.0;
+            vp[Q] += mask * scale * (-t14259*(t14278-t14292*t14285*t14286*t14287*(t14278-c0f*log((1.0/2.0)/(c0f*(b1f*t14262+b3f*t14263+b2f*c*t14260+b4f*t14264*t14265))+1.0)*(a1f*c*t14260+1.0)*2.0)+(Aa*t14292*t14285*log((1.0/2.0)/(Aa*(b1a*t14262+b3a*t14263+b2a*c*t14260+b4a*t14264*t14265))+1.0)*(t14286*t14287-1.0)*(a1a*c*t14260+1.0)*2.0)/d2fz0));
+        }
+
+        // v_rho_a
+        if (deriv >= 1) {
+            double t14294 = rho_a+rho_b;
+            double t14295 = 1.0/pow(t14294,1.0/3.0);
+            double t14296 = c*t14295;
+            double t14297 = sqrt(t14296);
+            double t14298 = b1p*t14297;
+            double t14299 = pow(t14296,3.0/2.0);
+            double t14300 = b3p*t14299;
+            double t14301 = c*c;
+            double t14302 = 1.0/pow(t14294,2.0/3.0);
+            double t14303 = b4p*t14301*t14302;
+            double t14304 = b2p*c*t14295;
+            double t14305 = t14300+t14303+t14304+t14298;
+            double t14306 = 1.0/pow(t14294,4.0/3.0);
+            double t14307 = 1.0/c0p;
+            double t14308 = 1.0/t14305;
+            double t14309 = t14307*t14308*(1.0/2.0);
+            double t14310 = t14309+1.0;
+            double t14311 = a1p*c*t14295;
+            double t14312 = t14311+1.0;
+            double t14313 = rho_a-rho_b;
+            double t14314 = t14313*t14313;
+            double t14315 = 1.0/t14294;
+            double t14316 = t14313*t14315;
+            double t14317 = two_13*2.0;
+            double t14318 = t14317-2.0;
+            double t14319 = 1.0/t14318;
+            double t14320 = 1.0/c0f;
+            double t14321 = b1f*t14297;
+            double t14322 = b3f*t14299;
+            double t14323 = b4f*t14301*t14302;
+            double t14324 = b2f*c*t14295;
+            double t14325 = t14321+t14322+t14323+t14324;
+            double t14326 = 1.0/t14325;
+            double t14327 = t14320*t14326*(1.0/2.0);
+            double t14328 = t14327+1.0;
+            double t14329 = log(t14328);
+            double t14330 = a1f*c*t14295;
+            double t14331 = t14330+1.0;
+            double t14332 = log(t14310);
+            double t14342 = c0f*t14331*t14329*2.0;
+            double t14343 = c0p*t14312*t14332*2.0;
+            double t14333 = t14342-t14343;
+            double t14334 = t14316+1.0;
+            double t14335 = pow(t14334,4.0/3.0);
+            double t14336 = -t14316+1.0;
+            double t14337 = pow(t14336,4.0/3.0);
+            double t14338 = t14335+t14337-2.0;
+            double t14339 = 1.0/(t14294*t14294);
+            double t14370 = t14313*t14339;
+            double t14340 = t14315-t14370;
+            double t14341 = 1.0/(t14294*t14294*t14294*t14294);
+            double t14344 = t14314*t14314;
+            double t14345 = 1.0/pow(t14294,5.0/3.0);
+            double t14346 = 1.0/sqrt(t14296);
+            double t14347 = 1.0/t14310;
+            double t14348 = 1.0/(t14305*t14305);
+            double t14349 = b4p*t14301*t14345*(2.0/3.0);
+            double t14350 = b2p*c*t14306*(1.0/3.0);
+            double t14351 = b1p*c*t14306*t14346*(1.0/6.0);
+            double t14352 = b3p*c*t14306*t14297*(1.0/2.0);
+            double t14353 = t14350+t14351+t14352+t14349;
+            double t14354 = t14312*t14353*t14347*t14348;
+            double t14355 = 1.0/(t14294*t14294*t14294*t14294*t14294);
+            double t14356 = 1.0/d2fz0;
+            double t14357 = 1.0/Aa;
+            double t14358 = b1a*t14297;
+            double t14359 = b3a*t14299;
+            double t14360 = b4a*t14301*t14302;
+            double t14361 = b2a*c*t14295;
+            double t14362 = t14360+t14361+t14358+t14359;
+            double t14363 = 1.0/t14362;
+            double t14364 = t14363*t14357*(1.0/2.0);
+            double t14365 = t14364+1.0;
+            double t14366 = log(t14365);
+            double t14367 = a1a*c*t14295;
+            double t14368 = t14367+1.0;
+            double t14369 = pow(t14334,1.0/3.0);
+            double t14371 = t14340*t14369*(4.0/3.0);
+            double t14372 = pow(t14336,1.0/3.0);
+            double t14373 = t14371-t14340*t14372*(4.0/3.0);
+            double t14374 = t14341*t14344;
+            double t14375 = t14374-1.0;
+            v_rho_ap[Q] += mask * scale * (-t14343-t14294*(t14354-t14341*t14344*t14319*t14338*(t14354-(t14331*1.0/(t14325*t14325)*(b2f*c*t14306*(1.0/3.0)+b4f*t14301*t14345*(2.0/3.0)+b1f*c*t14306*t14346*(1.0/6.0)+b3f*c*t14306*t14297*(1.0/2.0)))/t14328+a1f*c*c0f*t14306*t14329*(2.0/3.0)-a1p*c*c0p*t14332*t14306*(2.0/3.0))-a1p*c*c0p*t14332*t14306*(2.0/3.0)+t14341*t14333*t14344*t14319*t14373-t14333*t14344*t14319*t14355*t14338*4.0+t14313*t14314*t14341*t14333*t14319*t14338*4.0-Aa*t14319*t14338*t14356*t14366*t14368*(t14344*t14355*4.0-t14313*t14314*t14341*4.0)*2.0+Aa*t14319*t14373*t14356*t14366*t14375*t14368*2.0+(1.0/(t14362*t14362)*t14319*t14338*t14356*t14375*t14368*(b2a*c*t14306*(1.0/3.0)+b4a*t14301*t14345*(2.0/3.0)+b1a*c*t14306*t14346*(1.0/6.0)+b3a*c*t14306*t14297*(1.0/2.0)))/t14365-Aa*a1a*c*t14306*t14319*t14338*t14356*t14366*t14375*(2.0/3.0))-t14341*t14333*t14344*t14319*t14338-Aa*t14319*t14338*t14356*t14366*t14375*t14368*2.0);
+        }
+
+        // v_rho_b
+        if (deriv >= 1) {
+            double t14377 = rho_a+rho_b;
+            double t14378 = 1.0/pow(t14377,1.0/3.0);
+            double t14379 = c*t14378;
+            double t14380 = sqrt(t14379);
+            double t14381 = b1p*t14380;
+            double t14382 = pow(t14379,3.0/2.0);
+            double t14383 = b3p*t14382;
+            double t14384 = c*c;
+            double t14385 = 1.0/pow(t14377,2.0/3.0);
+            double t14386 = b4p*t14384*t14385;
+            double t14387 = b2p*c*t14378;
+            double t14388 = t14381+t14383+t14386+t14387;
+            double t14389 = 1.0/pow(t14377,4.0/3.0);
+            double t14390 = 1.0/c0p;
+            double t14391 = 1.0/t14388;
+            double t14392 = t14390*t14391*(1.0/2.0);
+            double t14393 = t14392+1.0;
+            double t14394 = a1p*c*t14378;
+            double t14395 = t14394+1.0;
+            double t14396 = rho_a-rho_b;
+            double t14397 = t14396*t14396;
+            double t14398 = 1.0/t14377;
+            double t14399 = t14396*t14398;
+            double t14400 = two_13*2.0;
+            double t14401 = t14400-2.0;
+            double t14402 = 1.0/t14401;
+            double t14403 = 1.0/c0f;
+            double t14404 = b1f*t14380;
+            double t14405 = b3f*t14382;
+            double t14406 = b4f*t14384*t14385;
+            double t14407 = b2f*c*t14378;
+            double t14408 = t14404+t14405+t14406+t14407;
+            double t14409 = 1.0/t14408;
+            double t14410 = t14403*t14409*(1.0/2.0);
+            double t14411 = t14410+1.0;
+            double t14412 = log(t14411);
+            double t14413 = a1f*c*t14378;
+            double t14414 = t14413+1.0;
+            double t14415 = log(t14393);
+            double t14426 = c0f*t14412*t14414*2.0;
+            double t14427 = c0p*t14415*t14395*2.0;
+            double t14416 = t14426-t14427;
+            double t14417 = t14399+1.0;
+            double t14418 = pow(t14417,4.0/3.0);
+            double t14419 = -t14399+1.0;
+            double t14420 = pow(t14419,4.0/3.0);
+            double t14421 = t14420+t14418-2.0;
+            double t14422 = 1.0/(t14377*t14377);
+            double t14423 = t14422*t14396;
+            double t14424 = t14423+t14398;
+            double t14425 = 1.0/(t14377*t14377*t14377*t14377);
+            double t14428 = t14397*t14397;
+            double t14429 = 1.0/pow(t14377,5.0/3.0);
+            double t14430 = 1.0/sqrt(t14379);
+            double t14431 = 1.0/t14393;
+            double t14432 = 1.0/(t14388*t14388);
+            double t14433 = b4p*t14384*t14429*(2.0/3.0);
+            double t14434 = b2p*c*t14389*(1.0/3.0);
+            double t14435 = b1p*c*t14430*t14389*(1.0/6.0);
+            double t14436 = b3p*c*t14380*t14389*(1.0/2.0);
+            double t14437 = t14433+t14434+t14435+t14436;
+            double t14438 = 1.0/(t14377*t14377*t14377*t14377*t14377);
+            double t14439 = 1.0/d2fz0;
+            double t14440 = 1.0/Aa;
+            double t14441 = b1a*t14380;
+            double t14442 = b3a*t14382;
+            double t14443 = b4a*t14384*t14385;
+            double t14444 = b2a*c*t14378;
+            double t14445 = t14441+t14442+t14443+t14444;
+            double t14446 = 1.0/t14445;
+            double t14447 = t14440*t14446*(1.0/2.0);
+            double t14448 = t14447+1.0;
+            double t14449 = log(t14448);
+            double t14450 = a1a*c*t14378;
+            double t14451 = t14450+1.0;
+            double t14452 = pow(t14417,1.0/3.0);
+            double t14453 = t14424*t14452*(4.0/3.0);
+            double t14454 = pow(t14419,1.0/3.0);
+            double t14455 = t14453-t14424*t14454*(4.0/3.0);
+            double t14456 = t14425*t14428;
+            double t14457 = t14456-1.0;
+            v_rho_bp[Q] += mask * scale * (-t14427+t14377*(-t14431*t14432*t14437*t14395+a1p*c*c0p*t14415*t14389*(2.0/3.0)+t14402*t14421*t14416*t14428*t14438*4.0+t14402*t14416*t14425*t14428*t14455+t14402*t14421*t14425*t14428*(t14431*t14432*t14437*t14395-(t14414*1.0/(t14408*t14408)*(b2f*c*t14389*(1.0/3.0)+b4f*t14384*t14429*(2.0/3.0)+b1f*c*t14430*t14389*(1.0/6.0)+b3f*c*t14380*t14389*(1.0/2.0)))/t14411+a1f*c*c0f*t14412*t14389*(2.0/3.0)-a1p*c*c0p*t14415*t14389*(2.0/3.0))+t14402*t14421*t14416*t14425*t14396*t14397*4.0+Aa*t14402*t14421*t14451*t14439*t14449*(t14428*t14438*4.0+t14425*t14396*t14397*4.0)*2.0+Aa*t14402*t14451*t14455*t14439*t14457*t14449*2.0-(t14402*t14421*t14451*1.0/(t14445*t14445)*t14439*t14457*(b2a*c*t14389*(1.0/3.0)+b4a*t14384*t14429*(2.0/3.0)+b1a*c*t14430*t14389*(1.0/6.0)+b3a*c*t14380*t14389*(1.0/2.0)))/t14448+Aa*a1a*c*t14402*t14421*t14439*t14457*t14449*t14389*(2.0/3.0))-t14402*t14421*t14416*t14425*t14428-Aa*t14402*t14421*t14451*t14439*t14457*t14449*2.0);
         }
     }
 
@@ -968,218 +1203,8 @@ void PW92_CFunctional::compute_functional(const std::map<std::string,SharedVecto
             }
             
         } else {
-            // v
-            if (deriv >= 0) {
-                double t14259 = rho_a+rho_b;
-                double t14260 = 1.0/pow(t14259,1.0/3.0);
-                double t14261 = c*t14260;
-                double t14262 = sqrt(t14261);
-                double t14263 = pow(t14261,3.0/2.0);
-                double t14264 = c*c;
-                double t14265 = 1.0/pow(t14259,2.0/3.0);
-                double t14266 = 1.0/c0p;
-                double t14267 = b1p*t14262;
-                double t14268 = b3p*t14263;
-                double t14269 = b4p*t14264*t14265;
-                double t14270 = b2p*c*t14260;
-                double t14271 = t14270+t14267+t14268+t14269;
-                double t14272 = 1.0/t14271;
-                double t14273 = t14272*t14266*(1.0/2.0);
-                double t14274 = t14273+1.0;
-                double t14275 = log(t14274);
-                double t14276 = a1p*c*t14260;
-                double t14277 = t14276+1.0;
-                double t14278 = c0p*t14275*t14277*2.0;
-                double t14279 = rho_a-rho_b;
-                double t14280 = t14279*t14279;
-                double t14281 = 1.0/t14259;
-                double t14282 = t14281*t14279;
-                double t14283 = two_13*2.0;
-                double t14284 = t14283-2.0;
-                double t14285 = 1.0/t14284;
-                double t14286 = 1.0/(t14259*t14259*t14259*t14259);
-                double t14287 = t14280*t14280;
-                double t14288 = t14282+1.0;
-                double t14289 = pow(t14288,4.0/3.0);
-                double t14290 = -t14282+1.0;
-                double t14291 = pow(t14290,4.0/3.0);
-                double t14292 = t14291+t14289-2.0;
-                v[Q] += scale * (-t14259*(t14278-t14292*t14285*t14286*t14287*(t14278-c0f*log((1.0/2.0)/(c0f*(b1f*t14262+b3f*t14263+b2f*c*t14260+b4f*t14264*t14265))+1.0)*(a1f*c*t14260+1.0)*2.0)+(Aa*t14292*t14285*log((1.0/2.0)/(Aa*(b1a*t14262+b3a*t14263+b2a*c*t14260+b4a*t14264*t14265))+1.0)*(t14286*t14287-1.0)*(a1a*c*t14260+1.0)*2.0)/d2fz0));
-            }
-            
-            // v_rho_a
-            if (deriv >= 1) {
-                double t14294 = rho_a+rho_b;
-                double t14295 = 1.0/pow(t14294,1.0/3.0);
-                double t14296 = c*t14295;
-                double t14297 = sqrt(t14296);
-                double t14298 = b1p*t14297;
-                double t14299 = pow(t14296,3.0/2.0);
-                double t14300 = b3p*t14299;
-                double t14301 = c*c;
-                double t14302 = 1.0/pow(t14294,2.0/3.0);
-                double t14303 = b4p*t14301*t14302;
-                double t14304 = b2p*c*t14295;
-                double t14305 = t14300+t14303+t14304+t14298;
-                double t14306 = 1.0/pow(t14294,4.0/3.0);
-                double t14307 = 1.0/c0p;
-                double t14308 = 1.0/t14305;
-                double t14309 = t14307*t14308*(1.0/2.0);
-                double t14310 = t14309+1.0;
-                double t14311 = a1p*c*t14295;
-                double t14312 = t14311+1.0;
-                double t14313 = rho_a-rho_b;
-                double t14314 = t14313*t14313;
-                double t14315 = 1.0/t14294;
-                double t14316 = t14313*t14315;
-                double t14317 = two_13*2.0;
-                double t14318 = t14317-2.0;
-                double t14319 = 1.0/t14318;
-                double t14320 = 1.0/c0f;
-                double t14321 = b1f*t14297;
-                double t14322 = b3f*t14299;
-                double t14323 = b4f*t14301*t14302;
-                double t14324 = b2f*c*t14295;
-                double t14325 = t14321+t14322+t14323+t14324;
-                double t14326 = 1.0/t14325;
-                double t14327 = t14320*t14326*(1.0/2.0);
-                double t14328 = t14327+1.0;
-                double t14329 = log(t14328);
-                double t14330 = a1f*c*t14295;
-                double t14331 = t14330+1.0;
-                double t14332 = log(t14310);
-                double t14342 = c0f*t14331*t14329*2.0;
-                double t14343 = c0p*t14312*t14332*2.0;
-                double t14333 = t14342-t14343;
-                double t14334 = t14316+1.0;
-                double t14335 = pow(t14334,4.0/3.0);
-                double t14336 = -t14316+1.0;
-                double t14337 = pow(t14336,4.0/3.0);
-                double t14338 = t14335+t14337-2.0;
-                double t14339 = 1.0/(t14294*t14294);
-                double t14370 = t14313*t14339;
-                double t14340 = t14315-t14370;
-                double t14341 = 1.0/(t14294*t14294*t14294*t14294);
-                double t14344 = t14314*t14314;
-                double t14345 = 1.0/pow(t14294,5.0/3.0);
-                double t14346 = 1.0/sqrt(t14296);
-                double t14347 = 1.0/t14310;
-                double t14348 = 1.0/(t14305*t14305);
-                double t14349 = b4p*t14301*t14345*(2.0/3.0);
-                double t14350 = b2p*c*t14306*(1.0/3.0);
-                double t14351 = b1p*c*t14306*t14346*(1.0/6.0);
-                double t14352 = b3p*c*t14306*t14297*(1.0/2.0);
-                double t14353 = t14350+t14351+t14352+t14349;
-                double t14354 = t14312*t14353*t14347*t14348;
-                double t14355 = 1.0/(t14294*t14294*t14294*t14294*t14294);
-                double t14356 = 1.0/d2fz0;
-                double t14357 = 1.0/Aa;
-                double t14358 = b1a*t14297;
-                double t14359 = b3a*t14299;
-                double t14360 = b4a*t14301*t14302;
-                double t14361 = b2a*c*t14295;
-                double t14362 = t14360+t14361+t14358+t14359;
-                double t14363 = 1.0/t14362;
-                double t14364 = t14363*t14357*(1.0/2.0);
-                double t14365 = t14364+1.0;
-                double t14366 = log(t14365);
-                double t14367 = a1a*c*t14295;
-                double t14368 = t14367+1.0;
-                double t14369 = pow(t14334,1.0/3.0);
-                double t14371 = t14340*t14369*(4.0/3.0);
-                double t14372 = pow(t14336,1.0/3.0);
-                double t14373 = t14371-t14340*t14372*(4.0/3.0);
-                double t14374 = t14341*t14344;
-                double t14375 = t14374-1.0;
-                v_rho_a[Q] += scale * (-t14343-t14294*(t14354-t14341*t14344*t14319*t14338*(t14354-(t14331*1.0/(t14325*t14325)*(b2f*c*t14306*(1.0/3.0)+b4f*t14301*t14345*(2.0/3.0)+b1f*c*t14306*t14346*(1.0/6.0)+b3f*c*t14306*t14297*(1.0/2.0)))/t14328+a1f*c*c0f*t14306*t14329*(2.0/3.0)-a1p*c*c0p*t14332*t14306*(2.0/3.0))-a1p*c*c0p*t14332*t14306*(2.0/3.0)+t14341*t14333*t14344*t14319*t14373-t14333*t14344*t14319*t14355*t14338*4.0+t14313*t14314*t14341*t14333*t14319*t14338*4.0-Aa*t14319*t14338*t14356*t14366*t14368*(t14344*t14355*4.0-t14313*t14314*t14341*4.0)*2.0+Aa*t14319*t14373*t14356*t14366*t14375*t14368*2.0+(1.0/(t14362*t14362)*t14319*t14338*t14356*t14375*t14368*(b2a*c*t14306*(1.0/3.0)+b4a*t14301*t14345*(2.0/3.0)+b1a*c*t14306*t14346*(1.0/6.0)+b3a*c*t14306*t14297*(1.0/2.0)))/t14365-Aa*a1a*c*t14306*t14319*t14338*t14356*t14366*t14375*(2.0/3.0))-t14341*t14333*t14344*t14319*t14338-Aa*t14319*t14338*t14356*t14366*t14375*t14368*2.0);
-            }
-            
-            // v_rho_b
-            if (deriv >= 1) {
-                double t14377 = rho_a+rho_b;
-                double t14378 = 1.0/pow(t14377,1.0/3.0);
-                double t14379 = c*t14378;
-                double t14380 = sqrt(t14379);
-                double t14381 = b1p*t14380;
-                double t14382 = pow(t14379,3.0/2.0);
-                double t14383 = b3p*t14382;
-                double t14384 = c*c;
-                double t14385 = 1.0/pow(t14377,2.0/3.0);
-                double t14386 = b4p*t14384*t14385;
-                double t14387 = b2p*c*t14378;
-                double t14388 = t14381+t14383+t14386+t14387;
-                double t14389 = 1.0/pow(t14377,4.0/3.0);
-                double t14390 = 1.0/c0p;
-                double t14391 = 1.0/t14388;
-                double t14392 = t14390*t14391*(1.0/2.0);
-                double t14393 = t14392+1.0;
-                double t14394 = a1p*c*t14378;
-                double t14395 = t14394+1.0;
-                double t14396 = rho_a-rho_b;
-                double t14397 = t14396*t14396;
-                double t14398 = 1.0/t14377;
-                double t14399 = t14396*t14398;
-                double t14400 = two_13*2.0;
-                double t14401 = t14400-2.0;
-                double t14402 = 1.0/t14401;
-                double t14403 = 1.0/c0f;
-                double t14404 = b1f*t14380;
-                double t14405 = b3f*t14382;
-                double t14406 = b4f*t14384*t14385;
-                double t14407 = b2f*c*t14378;
-                double t14408 = t14404+t14405+t14406+t14407;
-                double t14409 = 1.0/t14408;
-                double t14410 = t14403*t14409*(1.0/2.0);
-                double t14411 = t14410+1.0;
-                double t14412 = log(t14411);
-                double t14413 = a1f*c*t14378;
-                double t14414 = t14413+1.0;
-                double t14415 = log(t14393);
-                double t14426 = c0f*t14412*t14414*2.0;
-                double t14427 = c0p*t14415*t14395*2.0;
-                double t14416 = t14426-t14427;
-                double t14417 = t14399+1.0;
-                double t14418 = pow(t14417,4.0/3.0);
-                double t14419 = -t14399+1.0;
-                double t14420 = pow(t14419,4.0/3.0);
-                double t14421 = t14420+t14418-2.0;
-                double t14422 = 1.0/(t14377*t14377);
-                double t14423 = t14422*t14396;
-                double t14424 = t14423+t14398;
-                double t14425 = 1.0/(t14377*t14377*t14377*t14377);
-                double t14428 = t14397*t14397;
-                double t14429 = 1.0/pow(t14377,5.0/3.0);
-                double t14430 = 1.0/sqrt(t14379);
-                double t14431 = 1.0/t14393;
-                double t14432 = 1.0/(t14388*t14388);
-                double t14433 = b4p*t14384*t14429*(2.0/3.0);
-                double t14434 = b2p*c*t14389*(1.0/3.0);
-                double t14435 = b1p*c*t14430*t14389*(1.0/6.0);
-                double t14436 = b3p*c*t14380*t14389*(1.0/2.0);
-                double t14437 = t14433+t14434+t14435+t14436;
-                double t14438 = 1.0/(t14377*t14377*t14377*t14377*t14377);
-                double t14439 = 1.0/d2fz0;
-                double t14440 = 1.0/Aa;
-                double t14441 = b1a*t14380;
-                double t14442 = b3a*t14382;
-                double t14443 = b4a*t14384*t14385;
-                double t14444 = b2a*c*t14378;
-                double t14445 = t14441+t14442+t14443+t14444;
-                double t14446 = 1.0/t14445;
-                double t14447 = t14440*t14446*(1.0/2.0);
-                double t14448 = t14447+1.0;
-                double t14449 = log(t14448);
-                double t14450 = a1a*c*t14378;
-                double t14451 = t14450+1.0;
-                double t14452 = pow(t14417,1.0/3.0);
-                double t14453 = t14424*t14452*(4.0/3.0);
-                double t14454 = pow(t14419,1.0/3.0);
-                double t14455 = t14453-t14424*t14454*(4.0/3.0);
-                double t14456 = t14425*t14428;
-                double t14457 = t14456-1.0;
-                v_rho_b[Q] += scale * (-t14427+t14377*(-t14431*t14432*t14437*t14395+a1p*c*c0p*t14415*t14389*(2.0/3.0)+t14402*t14421*t14416*t14428*t14438*4.0+t14402*t14416*t14425*t14428*t14455+t14402*t14421*t14425*t14428*(t14431*t14432*t14437*t14395-(t14414*1.0/(t14408*t14408)*(b2f*c*t14389*(1.0/3.0)+b4f*t14384*t14429*(2.0/3.0)+b1f*c*t14430*t14389*(1.0/6.0)+b3f*c*t14380*t14389*(1.0/2.0)))/t14411+a1f*c*c0f*t14412*t14389*(2.0/3.0)-a1p*c*c0p*t14415*t14389*(2.0/3.0))+t14402*t14421*t14416*t14425*t14396*t14397*4.0+Aa*t14402*t14421*t14451*t14439*t14449*(t14428*t14438*4.0+t14425*t14396*t14397*4.0)*2.0+Aa*t14402*t14451*t14455*t14439*t14457*t14449*2.0-(t14402*t14421*t14451*1.0/(t14445*t14445)*t14439*t14457*(b2a*c*t14389*(1.0/3.0)+b4a*t14384*t14429*(2.0/3.0)+b1a*c*t14430*t14389*(1.0/6.0)+b3a*c*t14380*t14389*(1.0/2.0)))/t14448+Aa*a1a*c*t14402*t14421*t14439*t14457*t14449*t14389*(2.0/3.0))-t14402*t14421*t14416*t14425*t14428-Aa*t14402*t14421*t14451*t14439*t14457*t14449*2.0);
-            }
-            
+            // v and the first partials are done in the loop above
+
             // v_rho_a_rho_a
             if (deriv >= 2) {
                 double t14464 = rho_a+rho_b;
@@ -1317,7 +1342,7 @@ void PW92_CFunctional::compute_functional(const std::map<std::string,SharedVecto
                 double t14595 = t14594*t14594;
                 v_rho_a_rho_a[Q] += scale * (-t14464*(t14551+t14562-t14480*t14527*t14485*t14549-t14513*t14525*t14518*t14493*(t14551+t14562-t14480*t14527*t14485*t14549-t14505*t14532*t14552*1.0/(t14499*t14499*t14499)*2.0+t14505*t14532*t14533*(b2f*c*t14476*(4.0/9.0)+b4f*t14471*t14477*(1.0E1/9.0)+b1f*c*t14476*t14478*(2.0/9.0)+b3f*c*t14467*t14476*(2.0/3.0)-b1f*t14471*t14543*t14477*(1.0/3.6E1)+b3f*t14471*t14477*t14478*(1.0/1.2E1))+1.0/(t14502*t14502)*t14505*t14552*t14494*1.0/(t14499*t14499*t14499*t14499)*(1.0/2.0)-a1f*c*c0f*t14503*t14476*(8.0/9.0)-t14542*t14480*t14481*t14553*t14554*(1.0/2.0)+a1f*c*t14532*t14533*t14538*t14486*(2.0/3.0)-a1p*c*t14527*t14485*t14486*t14487*(2.0/3.0))-t14513*t14541*t14524*t14525*t14493*8.0-t14523*t14524*t14507*t14525*t14493*8.0+t14523*t14541*t14525*t14518*t14493*2.0+t14513*t14507*t14525*t14563*t14493*2.0E1-t14542*t14480*t14481*t14553*t14554*(1.0/2.0)+t14513*t14507*t14508*t14518*t14493*1.2E1+t14507*t14525*t14518*t14493*t14583-t14513*t14524*t14507*t14508*t14493*t14488*3.2E1+t14513*t14541*t14508*t14518*t14493*t14488*8.0+t14523*t14507*t14508*t14518*t14493*t14488*8.0-a1p*c*t14527*t14485*t14486*t14487*(2.0/3.0)-Aa*t14523*t14564*t14493*t14574*t14576*t14585*4.0+Aa*t14564*t14493*t14574*t14583*t14576*t14588*2.0+Aa*t14513*t14564*t14493*t14574*t14576*(t14525*t14563*2.0E1+t14508*t14518*1.2E1-t14524*t14508*t14488*3.2E1)*2.0-t14513*t14564*t14493*t14576*t14585*t14594*t14586*t14589*2.0+t14523*t14564*t14493*t14576*t14594*t14586*t14588*t14589*2.0+t14513*1.0/(t14570*t14570*t14570)*t14564*t14493*t14576*t14586*t14595*t14588*2.0-t14513*t14564*t14493*t14576*t14586*t14588*t14589*(b2a*c*t14476*(4.0/9.0)+b4a*t14471*t14477*(1.0E1/9.0)+b1a*c*t14476*t14478*(2.0/9.0)+b3a*c*t14467*t14476*(2.0/3.0)-b1a*t14471*t14543*t14477*(1.0/3.6E1)+b3a*t14471*t14477*t14478*(1.0/1.2E1))+Aa*a1a*c*t14513*t14564*t14493*t14574*t14486*t14585*(4.0/3.0)+Aa*a1a*c*t14513*t14564*t14493*t14574*t14476*t14588*(8.0/9.0)-Aa*a1a*c*t14523*t14564*t14493*t14574*t14486*t14588*(4.0/3.0)-t14513*1.0/(t14570*t14570*t14570*t14570)*t14564*1.0/(t14573*t14573)*t14493*t14565*t14576*t14595*t14588*(1.0/2.0)-a1a*c*t14513*t14564*t14493*t14486*t14594*t14586*t14588*t14589*(2.0/3.0))-t14480*t14527*t14485*t14487*2.0+a1p*c*c0p*t14506*t14486*(4.0/3.0)+t14513*t14524*t14507*t14525*t14493*8.0-t14513*t14541*t14525*t14518*t14493*2.0-t14523*t14507*t14525*t14518*t14493*2.0-t14513*t14507*t14508*t14518*t14493*t14488*8.0-Aa*t14523*t14564*t14493*t14574*t14576*t14588*4.0+Aa*t14513*t14564*t14493*t14574*t14576*(t14584-t14596)*4.0-t14513*t14564*t14493*t14576*t14594*t14586*t14588*t14589*2.0+Aa*a1a*c*t14513*t14564*t14493*t14574*t14486*t14588*(4.0/3.0));
             }
-            
+
             // v_rho_a_rho_b
             if (deriv >= 2) {
                 double t14598 = rho_a+rho_b;
@@ -1457,7 +1482,7 @@ void PW92_CFunctional::compute_functional(const std::map<std::string,SharedVecto
                 double t14732 = t14720-t14713;
                 v_rho_a_rho_b[Q] += scale * (t14598*(t14679+t14689+t14698-t14614*t14619*t14685*t14669*2.0+t14651*t14661*t14627*t14658*(t14691+t14692-t14695-t14696)-a1p*c*c0p*t14610*t14640*(8.0/9.0)-t14651*t14627*t14647*t14658*(t14679+t14689+t14698-t14614*t14619*t14685*t14669*2.0+1.0/(t14633*t14633*t14633)*t14670*t14639*t14686*2.0-t14670*t14671*t14639*(b2f*c*t14610*(4.0/9.0)+b4f*t14611*t14605*(1.0E1/9.0)+b1f*c*t14610*t14612*(2.0/9.0)+b3f*c*t14601*t14610*(2.0/3.0)-b1f*t14611*t14605*t14672*(1.0/3.6E1)+b3f*t14611*t14612*t14605*(1.0/1.2E1))-1.0/(t14633*t14633*t14633*t14633)*1.0/(t14636*t14636)*t14628*t14639*t14686*(1.0/2.0)+a1f*c*c0f*t14610*t14637*(8.0/9.0)-a1p*c*c0p*t14610*t14640*(8.0/9.0)-a1f*c*t14620*t14670*t14671*t14684*(2.0/3.0))+t14641*t14642*t14651*t14627*t14647*1.2E1+t14641*t14661*t14662*t14627*t14658*4.0+t14641*t14651*t14627*t14719*t14658-t14641*t14662*t14627*t14657*t14658*4.0-t14651*t14627*t14657*t14693*t14658-t14662*t14627*t14647*t14693*t14658*8.0-t14641*t14627*t14647*t14658*t14699*2.0E1+t14622*t14641*t14642*t14651*t14661*t14627*4.0+t14622*t14641*t14642*t14651*t14627*t14657*4.0+Aa*t14700*t14710*t14712*t14722*t14661*t14627*2.0+Aa*t14700*t14710*t14712*t14730*t14627*t14719*2.0-Aa*t14700*t14710*t14712*t14627*t14657*(t14713-t14622*t14642*t14651*4.0)*2.0+Aa*t14700*t14710*t14712*t14627*t14647*(t14642*t14651*1.2E1-t14658*t14699*2.0E1)*2.0-t14700*t14712*t14721*t14730*t14723*t14661*t14627*t14728+t14700*t14712*t14721*t14730*t14723*t14627*t14728*t14657+t14700*t14712*t14721*t14722*t14723*t14627*t14647*t14728-t14700*t14712*t14721*t14723*t14732*t14627*t14647*t14728-t14700*t14712*t14721*t14730*t14731*1.0/(t14706*t14706*t14706)*t14627*t14647*2.0+t14700*t14712*t14721*t14730*t14723*t14627*t14647*(b2a*c*t14610*(4.0/9.0)+b4a*t14611*t14605*(1.0E1/9.0)+b1a*c*t14610*t14612*(2.0/9.0)+b3a*c*t14601*t14610*(2.0/3.0)-b1a*t14611*t14605*t14672*(1.0/3.6E1)+b3a*t14611*t14612*t14605*(1.0/1.2E1))+Aa*a1a*c*t14700*t14620*t14710*t14730*t14661*t14627*(2.0/3.0)-Aa*a1a*c*t14610*t14700*t14710*t14730*t14627*t14647*(8.0/9.0)-Aa*a1a*c*t14700*t14620*t14710*t14730*t14627*t14657*(2.0/3.0)-Aa*a1a*c*t14700*t14620*t14710*t14722*t14627*t14647*(2.0/3.0)+Aa*a1a*c*t14700*t14620*t14710*t14732*t14627*t14647*(2.0/3.0)+t14700*t14701*t14712*t14730*t14731*1.0/(t14706*t14706*t14706*t14706)*t14627*1.0/(t14709*t14709)*t14647*(1.0/2.0)+a1a*c*t14700*t14620*t14721*t14730*t14723*t14627*t14647*t14728*(2.0/3.0))-t14621*t14614*t14619*t14664*2.0+t14651*t14627*t14647*t14658*(t14691+t14692-t14695-t14696)*2.0+a1p*c*c0p*t14620*t14640*(4.0/3.0)-t14641*t14651*t14661*t14627*t14658+t14641*t14651*t14627*t14657*t14658+t14641*t14662*t14627*t14647*t14658*8.0-Aa*t14700*t14710*t14712*t14730*t14661*t14627*2.0+Aa*t14700*t14710*t14712*t14730*t14627*t14657*2.0+Aa*t14700*t14710*t14712*t14722*t14627*t14647*2.0-Aa*t14700*t14710*t14712*t14732*t14627*t14647*2.0-t14700*t14712*t14721*t14730*t14723*t14627*t14647*t14728*2.0+Aa*a1a*c*t14700*t14620*t14710*t14730*t14627*t14647*(4.0/3.0));
             }
-            
+
             // v_rho_b_rho_b
             if (deriv >= 2) {
                 double t14734 = rho_a+rho_b;
@@ -1595,7 +1620,7 @@ void PW92_CFunctional::compute_functional(const std::map<std::string,SharedVecto
                 double t14866 = t14865*t14865;
                 v_rho_b_rho_b[Q] += scale * (-t14734*(t14821+t14833-t14750*t14755*t14819*t14797-t14763*t14783*t14795*t14789*(t14821+t14833-t14750*t14755*t14819*t14797-t14802*t14822*t14775*1.0/(t14769*t14769*t14769)*2.0+t14802*t14803*t14775*(b2f*c*t14746*(4.0/9.0)+b4f*t14741*t14747*(1.0E1/9.0)+b1f*c*t14746*t14748*(2.0/9.0)+b3f*c*t14737*t14746*(2.0/3.0)-b1f*t14741*t14813*t14747*(1.0/3.6E1)+b3f*t14741*t14747*t14748*(1.0/1.2E1))+t14822*1.0/(t14772*t14772)*t14764*t14775*1.0/(t14769*t14769*t14769*t14769)*(1.0/2.0)-a1f*c*c0f*t14746*t14773*(8.0/9.0)-t14812*t14750*t14751*t14823*t14824*(1.0/2.0)+a1f*c*t14802*t14803*t14808*t14756*(2.0/3.0)-a1p*c*t14755*t14756*t14757*t14797*(2.0/3.0))-t14812*t14750*t14751*t14823*t14824*(1.0/2.0)-t14811*t14763*t14783*t14794*t14795*8.0-t14811*t14763*t14793*t14795*t14789*2.0+t14834*t14763*t14783*t14777*t14795*2.0E1+t14763*t14793*t14794*t14777*t14795*8.0+t14763*t14853*t14777*t14795*t14789+t14763*t14783*t14777*t14778*t14789*1.2E1-t14811*t14763*t14783*t14758*t14778*t14789*8.0+t14763*t14783*t14758*t14794*t14777*t14778*3.2E1+t14763*t14793*t14758*t14777*t14778*t14789*8.0-a1p*c*t14755*t14756*t14757*t14797*(2.0/3.0)+Aa*t14763*t14835*t14853*t14845*t14847*t14859*2.0+Aa*t14763*t14835*t14845*t14793*t14847*t14856*4.0+Aa*t14763*t14835*t14845*t14783*t14847*(t14834*t14795*2.0E1+t14778*t14789*1.2E1+t14758*t14794*t14778*3.2E1)*2.0-t14860*t14763*t14835*t14783*t14847*t14856*t14865*t14857*2.0-t14860*t14763*t14835*t14793*t14847*t14865*t14857*t14859*2.0+1.0/(t14841*t14841*t14841)*t14763*t14835*t14783*t14847*t14857*t14866*t14859*2.0-t14860*t14763*t14835*t14783*t14847*t14857*t14859*(b2a*c*t14746*(4.0/9.0)+b4a*t14741*t14747*(1.0E1/9.0)+b1a*c*t14746*t14748*(2.0/9.0)+b3a*c*t14737*t14746*(2.0/3.0)-b1a*t14741*t14813*t14747*(1.0/3.6E1)+b3a*t14741*t14747*t14748*(1.0/1.2E1))+Aa*a1a*c*t14763*t14835*t14845*t14756*t14783*t14856*(4.0/3.0)+Aa*a1a*c*t14763*t14835*t14746*t14845*t14783*t14859*(8.0/9.0)+Aa*a1a*c*t14763*t14835*t14845*t14756*t14793*t14859*(4.0/3.0)-1.0/(t14841*t14841*t14841*t14841)*t14763*t14835*1.0/(t14844*t14844)*t14836*t14783*t14847*t14866*t14859*(1.0/2.0)-a1a*c*t14860*t14763*t14835*t14756*t14783*t14865*t14857*t14859*(2.0/3.0))-t14750*t14755*t14757*t14797*2.0+a1p*c*c0p*t14756*t14776*(4.0/3.0)-t14811*t14763*t14783*t14795*t14789*2.0+t14763*t14783*t14794*t14777*t14795*8.0+t14763*t14793*t14777*t14795*t14789*2.0+t14763*t14783*t14758*t14777*t14778*t14789*8.0+Aa*t14763*t14835*t14845*t14783*t14847*t14856*4.0+Aa*t14763*t14835*t14845*t14793*t14847*t14859*4.0-t14860*t14763*t14835*t14783*t14847*t14865*t14857*t14859*2.0+Aa*a1a*c*t14763*t14835*t14845*t14756*t14783*t14859*(4.0/3.0));
             }
-            
+
         }
     }
 }
@@ -59,6 +59,10 @@ VWN5_CFunctional::~VWN5_CFunctional()
 {
 }
 void VWN5_CFunctional::compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha)
+{
+    compute_block(FunctionalPoints::from_maps(in, out), npoints, deriv, alpha);
+}
+void VWN5_CFunctional::compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha)
 {
     double c = parameters_["c"];
     double d2fz0 = parameters_["d2fz0"];
@@ -90,17 +94,17 @@ void VWN5_CFunctional::compute_functional(const std::map<std::string,SharedVecto
     double* tau_bp = NULL;
 
     if (true) {
-        rho_ap = in.find("RHO_A")->second->pointer();
-        rho_bp = in.find("RHO_B")->second->pointer();
+        rho_ap = points.in[FunctionalPoints::RHO_A];
+        rho_bp = points.in[FunctionalPoints::RHO_B];
     }
     if (gga_) {  
-        gamma_aap = in.find("GAMMA_AA")->second->pointer();
-        gamma_abp = in.find("GAMMA_AB")->second->pointer();
-        gamma_bbp = in.find("GAMMA_BB")->second->pointer();
+        gamma_aap = points.in[FunctionalPoints::GAMMA_AA];
+        gamma_abp = points.in[FunctionalPoints::GAMMA_AB];
+        gamma_bbp = points.in[FunctionalPoints::GAMMA_BB];
     } 
     if (meta_)  {
-        tau_ap = in.find("TAU_A")->second->pointer();
-        tau_bp = in.find("TAU_B")->second->pointer();
+        tau_ap = points.in[FunctionalPoints::TAU_A];
+        tau_bp = points.in[FunctionalPoints::TAU_B];
     }
 
     // => Outut variables <= //
@@ -145,63 +149,523 @@ void VWN5_CFunctional::compute_functional(const std::map<std::string,SharedVecto
     double* v_gamma_bb_tau_b = NULL;
 
     if (deriv >= 0) {
-        v = out.find("V")->second->pointer();
+        v = points.out[FunctionalPoints::V];
     } 
     if (deriv >= 1) {
         if (true) {
-            v_rho_a = out.find("V_RHO_A")->second->pointer();
-            v_rho_b = out.find("V_RHO_B")->second->pointer();
+            v_rho_a = points.out[FunctionalPoints::V_RHO_A];
+            v_rho_b = points.out[FunctionalPoints::V_RHO_B];
         }
         if (gga_) {
-            v_gamma_aa = out.find("V_GAMMA_AA")->second->pointer();
-            v_gamma_ab = out.find("V_GAMMA_AB")->second->pointer();
-            v_gamma_bb = out.find("V_GAMMA_BB")->second->pointer();
+            v_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA];
+            v_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB];
+            v_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB];
         }
         if (meta_) {    
-            v_tau_a = out.find("V_TAU_A")->second->pointer();
-            v_tau_b = out.find("V_TAU_B")->second->pointer();
+            v_tau_a = points.out[FunctionalPoints::V_TAU_A];
+            v_tau_b = points.out[FunctionalPoints::V_TAU_B];
         }
     }
     if (deriv >= 2) {
         if (true) {
-            v_rho_a_rho_a = out.find("V_RHO_A_RHO_A")->second->pointer();
-            v_rho_a_rho_b = out.find("V_RHO_A_RHO_B")->second->pointer();
-            v_rho_b_rho_b = out.find("V_RHO_B_RHO_B")->second->pointer();
+            v_rho_a_rho_a = points.out[FunctionalPoints::V_RHO_A_RHO_A];
+            v_rho_a_rho_b = points.out[FunctionalPoints::V_RHO_A_RHO_B];
+            v_rho_b_rho_b = points.out[FunctionalPoints::V_RHO_B_RHO_B];
         }
         if (gga_) {
-            v_gamma_aa_gamma_aa = out.find("V_GAMMA_AA_GAMMA_AA")->second->pointer();
-            v_gamma_aa_gamma_ab = out.find("V_GAMMA_AA_GAMMA_AB")->second->pointer();
-            v_gamma_aa_gamma_bb = out.find("V_GAMMA_AA_GAMMA_BB")->second->pointer();
-            v_gamma_ab_gamma_ab = out.find("V_GAMMA_AB_GAMMA_AB")->second->pointer();
-            v_gamma_ab_gamma_bb = out.find("V_GAMMA_AB_GAMMA_BB")->second->pointer();
-            v_gamma_bb_gamma_bb = out.find("V_GAMMA_BB_GAMMA_BB")->second->pointer();
+            v_gamma_aa_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_AA];
+            v_gamma_aa_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_AB];
+            v_gamma_aa_gamma_bb = points.out[FunctionalPoints::V_GAMMA_AA_GAMMA_BB];
+            v_gamma_ab_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB_GAMMA_AB];
+            v_gamma_ab_gamma_bb = points.out[FunctionalPoints::V_GAMMA_AB_GAMMA_BB];
+            v_gamma_bb_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB_GAMMA_BB];
         }
         if (meta_) {
-            v_tau_a_tau_a = out.find("V_TAU_A_TAU_A")->second->pointer();
-            v_tau_a_tau_b = out.find("V_TAU_A_TAU_B")->second->pointer();
-            v_tau_b_tau_b = out.find("V_TAU_B_TAU_B")->second->pointer();
+            v_tau_a_tau_a = points.out[FunctionalPoints::V_TAU_A_TAU_A];
+            v_tau_a_tau_b = points.out[FunctionalPoints::V_TAU_A_TAU_B];
+            v_tau_b_tau_b = points.out[FunctionalPoints::V_TAU_B_TAU_B];
         }
         if (gga_) {
-            v_rho_a_gamma_aa = out.find("V_RHO_A_GAMMA_AA")->second->pointer();
-            v_rho_a_gamma_ab = out.find("V_RHO_A_GAMMA_AB")->second->pointer();
-            v_rho_a_gamma_bb = out.find("V_RHO_A_GAMMA_BB")->second->pointer();
-            v_rho_b_gamma_aa = out.find("V_RHO_B_GAMMA_AA")->second->pointer();
-            v_rho_b_gamma_ab = out.find("V_RHO_B_GAMMA_AB")->second->pointer();
-            v_rho_b_gamma_bb = out.find("V_RHO_B_GAMMA_BB")->second->pointer();
+            v_rho_a_gamma_aa = points.out[FunctionalPoints::V_RHO_A_GAMMA_AA];
+            v_rho_a_gamma_ab = points.out[FunctionalPoints::V_RHO_A_GAMMA_AB];
+            v_rho_a_gamma_bb = points.out[FunctionalPoints::V_RHO_A_GAMMA_BB];
+            v_rho_b_gamma_aa = points.out[FunctionalPoints::V_RHO_B_GAMMA_AA];
+            v_rho_b_gamma_ab = points.out[FunctionalPoints::V_RHO_B_GAMMA_AB];
+            v_rho_b_gamma_bb = points.out[FunctionalPoints::V_RHO_B_GAMMA_BB];
         }
         if (meta_) {
-            v_rho_a_tau_a = out.find("V_RHO_A_TAU_A")->second->pointer();
-            v_rho_a_tau_b = out.find("V_RHO_A_TAU_B")->second->pointer();
-            v_rho_b_tau_a = out.find("V_RHO_B_TAU_A")->second->pointer();
-            v_rho_b_tau_b = out.find("V_RHO_B_TAU_B")->second->pointer();
+            v_rho_a_tau_a = points.out[FunctionalPoints::V_RHO_A_TAU_A];
+            v_rho_a_tau_b = points.out[FunctionalPoints::V_RHO_A_TAU_B];
+            v_rho_b_tau_a = points.out[FunctionalPoints::V_RHO_B_TAU_A];
+            v_rho_b_tau_b = points.out[FunctionalPoints::V_RHO_B_TAU_B];
         }
         if (gga_ && meta_) {
-            v_gamma_aa_tau_a = out.find("V_GAMMA_AA_TAU_A")->second->pointer();
-            v_gamma_aa_tau_b = out.find("V_GAMMA_AA_TAU_B")->second->pointer();
-            v_gamma_ab_tau_a = out.find("V_GAMMA_AB_TAU_A")->second->pointer();
-            v_gamma_ab_tau_b = out.find("V_GAMMA_AB_TAU_B")->second->pointer();
-            v_gamma_bb_tau_a = out.find("V_GAMMA_BB_TAU_A")->second->pointer();
-            v_gamma_bb_tau_b = out.find("V_GAMMA_BB_TAU_B")->second->pointer();
+            v_gamma_aa_tau_a = points.out[FunctionalPoints::V_GAMMA_AA_TAU_A];
+            v_gamma_aa_tau_b = points.out[FunctionalPoints::V_GAMMA_AA_TAU_B];
+            v_gamma_ab_tau_a = points.out[FunctionalPoints::V_GAMMA_AB_TAU_A];
+            v_gamma_ab_tau_b = points.out[FunctionalPoints::V_GAMMA_AB_TAU_B];
+            v_gamma_bb_tau_a = points.out[FunctionalPoints::V_GAMMA_BB_TAU_A];
+            v_gamma_bb_tau_b = points.out[FunctionalPoints::V_GAMMA_BB_TAU_B];
+        }
+    }
+
+    // => Straight-line loop over points with both spins above the cutoff <= //
+
+    // Same expressions as the general branch of the loop below, for the
+    // value and first partials.  Points with either density below the
+    // cutoff are evaluated at a harmless dummy point and masked to zero,
+    // so the body has no switches and the loop can be vectorized.
+
+    double* restrict vp = v;
+    double* restrict v_rho_ap = v_rho_a;
+    double* restrict v_rho_bp = v_rho_b;
+
+    for (int Q = 0; Q < npoints; Q++) {
+
+        bool on = (rho_ap[Q] >= lsda_cutoff_ && rho_bp[Q] >= lsda_cutoff_);
+        double mask = (on ? 1.0 : 0.0);
+        double rho_a = (on ? rho_ap[Q] : 1.0);
+        double rho_b = (on ? rho_bp[Q] : 1.0);
+
+        // v
+        if (deriv >= 0) {
+            double t9113 = rho_a+rho_b;
+            double t9114 = 1.0/pow(t9113,1.0/3.0);
+            double t9115 = c*t9114;
+            double t9116 = sqrt(t9115);
+            double t9117 = EcP_4*4.0;
+            double t9118 = EcP_3*EcP_3;
+            double t9119 = t9117-t9118;
+            double t9120 = EcP_2-t9116;
+            double t9121 = EcP_3*t9116;
+            double t9122 = EcP_4+t9121+t9115;
+            double t9123 = 1.0/t9122;
+            double t9124 = sqrt(t9119);
+            double t9125 = t9116*2.0;
+            double t9126 = EcP_3+t9125;
+            double t9127 = 1.0/t9126;
+            double t9128 = t9124*t9127;
+            double t9129 = atan(t9128);
+            double t9130 = 1.0/sqrt(t9119);
+            double t9131 = rho_a-rho_b;
+            double t9132 = t9131*t9131;
+            double t9133 = EcF_4*4.0;
+            double t9134 = EcF_3*EcF_3;
+            double t9135 = t9133-t9134;
+            double t9136 = EcF_2-t9116;
+            double t9137 = EcF_3*t9116;
+            double t9138 = EcF_4+t9115+t9137;
+            double t9139 = 1.0/t9138;
+            double t9140 = sqrt(t9135);
+            double t9141 = EcF_3+t9125;
+            double t9142 = 1.0/t9141;
+            double t9143 = t9140*t9142;
+            double t9144 = atan(t9143);
+            double t9145 = 1.0/sqrt(t9135);
+            double t9146 = c*t9114*t9123;
+            double t9147 = log(t9146);
+            double t9148 = EcP_3*t9130*t9129*2.0;
+            double t9149 = t9120*t9120;
+            double t9150 = t9123*t9149;
+            double t9151 = log(t9150);
+            double t9152 = EcP_2*4.0;
+            double t9153 = EcP_3*2.0;
+            double t9154 = t9152+t9153;
+            double t9155 = t9130*t9154*t9129;
+            double t9156 = t9151+t9155;
+            double t9157 = EcP_2*EcP_2;
+            double t9158 = EcP_2*EcP_3;
+            double t9159 = EcP_4+t9157+t9158;
+            double t9160 = 1.0/t9159;
+            double t9161 = t9147+t9148-EcP_2*EcP_3*t9160*t9156;
+            double t9162 = EcP_1*t9161;
+            double t9163 = Ac_4*4.0;
+            double t9164 = Ac_3*Ac_3;
+            double t9165 = t9163-t9164;
+            double t9166 = Ac_2-t9116;
+            double t9167 = Ac_3*t9116;
+            double t9168 = Ac_4+t9115+t9167;
+            double t9169 = 1.0/t9168;
+            double t9170 = sqrt(t9165);
+            double t9171 = Ac_3+t9125;
+            double t9172 = 1.0/t9171;
+            double t9173 = t9170*t9172;
+            double t9174 = atan(t9173);
+            double t9175 = 1.0/sqrt(t9165);
+            double t9176 = 1.0/t9113;
+            double t9177 = t9131*t9176;
+            double t9178 = c*t9114*t9169;
+            double t9179 = log(t9178);
+            double t9180 = Ac_3*t9174*t9175*2.0;
+            double t9181 = t9166*t9166;
+            double t9182 = t9181*t9169;
+            double t9183 = log(t9182);
+            double t9184 = Ac_2*4.0;
+            double t9185 = Ac_3*2.0;
+            double t9186 = t9184+t9185;
+            double t9187 = t9174*t9175*t9186;
+            double t9188 = t9183+t9187;
+            double t9189 = Ac_2*Ac_2;
+            double t9190 = Ac_2*Ac_3;
+            double t9191 = Ac_4+t9190+t9189;
+            double t9192 = 1.0/t9191;
+            double t9193 = t9180+t9179-Ac_2*Ac_3*t9192*t9188;
+            vp[Q] += mask * scale * (t9113*(t9162-(Ac_1*t9193*(1.0/(t9113*t9113*t9113*t9113)*(t9132*t9132)*((d2fz0*(t9162-EcF_1*(log(c*t9114*t9139)+EcF_3*t9144*t9145*2.0-(EcF_2*EcF_3*(log((t9136*t9136)*t9139)+t9144*t9145*(EcF_2*4.0+EcF_3*2.0)))/(EcF_4+EcF_2*EcF_2+EcF_2*EcF_3))))/(Ac_1*t9193)+1.0)-1.0)*(pow(t9177+1.0,4.0/3.0)+pow(-t9177+1.0,4.0/3.0)-2.0))/(d2fz0*(two_13*2.0-2.0))));
+        }
+
+        // v_rho_a
+        if (deriv >= 1) {
+            double t9195 = rho_a+rho_b;
+            double t9196 = 1.0/pow(t9195,1.0/3.0);
+            double t9197 = c*t9196;
+            double t9198 = sqrt(t9197);
+            double t9199 = EcP_4*4.0;
+            double t9200 = EcP_3*EcP_3;
+            double t9201 = t9199-t9200;
+            double t9202 = EcP_2-t9198;
+            double t9203 = EcP_3*t9198;
+            double t9204 = EcP_4+t9197+t9203;
+            double t9205 = 1.0/t9204;
+            double t9206 = sqrt(t9201);
+            double t9207 = t9198*2.0;
+            double t9208 = EcP_3+t9207;
+            double t9209 = 1.0/t9208;
+            double t9210 = t9206*t9209;
+            double t9211 = atan(t9210);
+            double t9212 = 1.0/sqrt(t9201);
+            double t9213 = 1.0/pow(t9195,4.0/3.0);
+            double t9214 = c*t9213*(1.0/3.0);
+            double t9215 = 1.0/sqrt(t9197);
+            double t9216 = EcP_3*c*t9213*t9215*(1.0/6.0);
+            double t9217 = t9214+t9216;
+            double t9218 = t9202*t9202;
+            double t9219 = 1.0/(t9204*t9204);
+            double t9220 = EcP_2*4.0;
+            double t9221 = EcP_3*2.0;
+            double t9222 = t9220+t9221;
+            double t9223 = 1.0/(t9208*t9208);
+            double t9224 = EcP_2*EcP_2;
+            double t9225 = EcP_2*EcP_3;
+            double t9226 = EcP_4+t9224+t9225;
+            double t9227 = 1.0/t9226;
+            double t9228 = t9201*t9223;
+            double t9229 = t9228+1.0;
+            double t9230 = 1.0/t9229;
+            double t9231 = 1.0/t9195;
+            double t9232 = rho_a-rho_b;
+            double t9233 = t9231*t9232;
+            double t9234 = Ac_4*4.0;
+            double t9235 = Ac_3*Ac_3;
+            double t9236 = t9234-t9235;
+            double t9237 = Ac_2-t9198;
+            double t9238 = Ac_3*t9198;
+            double t9239 = Ac_4+t9197+t9238;
+            double t9240 = 1.0/t9239;
+            double t9241 = sqrt(t9236);
+            double t9242 = Ac_3+t9207;
+            double t9243 = 1.0/t9242;
+            double t9244 = t9241*t9243;
+            double t9245 = atan(t9244);
+            double t9246 = 1.0/sqrt(t9236);
+            double t9247 = 1.0/c;
+            double t9248 = EcF_3*t9198;
+            double t9249 = EcF_4+t9197+t9248;
+            double t9250 = pow(t9195,1.0/3.0);
+            double t9251 = EcF_3*c*t9213*t9215*(1.0/6.0);
+            double t9252 = t9214+t9251;
+            double t9253 = EcF_2-t9198;
+            double t9254 = 1.0/(t9249*t9249);
+            double t9255 = 1.0/t9249;
+            double t9256 = EcF_3+t9207;
+            double t9257 = 1.0/(t9256*t9256);
+            double t9258 = EcF_4*4.0;
+            double t9259 = EcF_3*EcF_3;
+            double t9260 = t9258-t9259;
+            double t9261 = t9260*t9257;
+            double t9262 = t9261+1.0;
+            double t9263 = 1.0/t9262;
+            double t9264 = c*t9213*t9205*(1.0/3.0);
+            double t9265 = t9264-c*t9196*t9217*t9219;
+            double t9266 = t9204*t9250*t9247*t9265;
+            double t9267 = t9217*t9218*t9219;
+            double t9268 = c*t9202*t9213*t9205*t9215*(1.0/3.0);
+            double t9269 = t9267+t9268;
+            double t9270 = 1.0/(t9202*t9202);
+            double t9271 = t9204*t9270*t9269;
+            double t9272 = c*t9230*t9213*t9222*t9223*t9215*(1.0/3.0);
+            double t9273 = t9271+t9272;
+            double t9274 = EcP_2*EcP_3*t9227*t9273;
+            double t9275 = t9274+t9266-EcP_3*c*t9230*t9213*t9223*t9215*(2.0/3.0);
+            double t9276 = EcP_1*t9275;
+            double t9277 = c*t9196*t9240;
+            double t9278 = log(t9277);
+            double t9279 = Ac_3*t9245*t9246*2.0;
+            double t9280 = t9237*t9237;
+            double t9281 = t9240*t9280;
+            double t9282 = log(t9281);
+            double t9283 = Ac_2*4.0;
+            double t9284 = Ac_3*2.0;
+            double t9285 = t9283+t9284;
+            double t9286 = t9245*t9246*t9285;
+            double t9287 = t9282+t9286;
+            double t9288 = Ac_2*Ac_2;
+            double t9289 = Ac_2*Ac_3;
+            double t9290 = Ac_4+t9288+t9289;
+            double t9291 = 1.0/t9290;
+            double t9316 = Ac_2*Ac_3*t9291*t9287;
+            double t9292 = t9278+t9279-t9316;
+            double t9293 = 1.0/Ac_1;
+            double t9294 = t9253*t9253;
+            double t9295 = sqrt(t9260);
+            double t9296 = 1.0/t9256;
+            double t9297 = t9295*t9296;
+            double t9298 = atan(t9297);
+            double t9299 = 1.0/sqrt(t9260);
+            double t9300 = EcF_2*4.0;
+            double t9301 = EcF_3*2.0;
+            double t9302 = t9300+t9301;
+            double t9303 = EcF_2*EcF_2;
+            double t9304 = EcF_2*EcF_3;
+            double t9305 = EcF_4+t9303+t9304;
+            double t9306 = 1.0/t9305;
+            double t9307 = c*t9196*t9205;
+            double t9308 = log(t9307);
+            double t9309 = EcP_3*t9211*t9212*2.0;
+            double t9310 = t9205*t9218;
+            double t9311 = log(t9310);
+            double t9312 = t9211*t9212*t9222;
+            double t9313 = t9311+t9312;
+            double t9334 = EcP_2*EcP_3*t9227*t9313;
+            double t9314 = -t9334+t9308+t9309;
+            double t9315 = EcP_1*t9314;
+            double t9317 = Ac_3*c*t9213*t9215*(1.0/6.0);
+            double t9318 = t9214+t9317;
+            double t9319 = 1.0/(t9239*t9239);
+            double t9320 = 1.0/(t9242*t9242);
+            double t9321 = t9236*t9320;
+            double t9322 = t9321+1.0;
+            double t9323 = 1.0/t9322;
+            double t9324 = t9232*t9232;
+            double t9325 = 1.0/(t9195*t9195*t9195*t9195);
+            double t9326 = c*t9196*t9255;
+            double t9327 = log(t9326);
+            double t9328 = EcF_3*t9298*t9299*2.0;
+            double t9329 = t9255*t9294;
+            double t9330 = log(t9329);
+            double t9331 = t9298*t9299*t9302;
+            double t9332 = t9330+t9331;
+            double t9338 = EcF_2*EcF_3*t9332*t9306;
+            double t9333 = t9327+t9328-t9338;
+            double t9335 = 1.0/t9292;
+            double t9339 = EcF_1*t9333;
+            double t9336 = t9315-t9339;
+            double t9337 = t9324*t9324;
+            double t9340 = d2fz0*t9293*t9335*t9336;
+            double t9341 = t9340+1.0;
+            double t9342 = 1.0/d2fz0;
+            double t9343 = two_13*2.0;
+            double t9344 = t9343-2.0;
+            double t9345 = 1.0/t9344;
+            double t9346 = t9233+1.0;
+            double t9347 = pow(t9346,4.0/3.0);
+            double t9348 = -t9233+1.0;
+            double t9349 = pow(t9348,4.0/3.0);
+            double t9350 = t9347+t9349-2.0;
+            double t9351 = c*t9213*t9240*(1.0/3.0);
+            double t9352 = t9351-c*t9196*t9318*t9319;
+            double t9353 = t9250*t9247*t9239*t9352;
+            double t9354 = t9280*t9318*t9319;
+            double t9355 = c*t9213*t9240*t9215*t9237*(1.0/3.0);
+            double t9356 = t9354+t9355;
+            double t9357 = 1.0/(t9237*t9237);
+            double t9358 = t9239*t9356*t9357;
+            double t9359 = c*t9213*t9215*t9285*t9320*t9323*(1.0/3.0);
+            double t9360 = t9358+t9359;
+            double t9361 = Ac_2*Ac_3*t9291*t9360;
+            double t9362 = t9361+t9353-Ac_3*c*t9213*t9215*t9320*t9323*(2.0/3.0);
+            double t9363 = 1.0/(t9195*t9195);
+            double t9364 = t9231-t9232*t9363;
+            double t9365 = t9341*t9325*t9337;
+            double t9366 = t9365-1.0;
+            v_rho_ap[Q] += mask * scale * (t9315-t9195*(t9276-Ac_1*t9292*t9350*t9342*t9345*(1.0/(t9195*t9195*t9195*t9195*t9195)*t9341*t9337*4.0+t9325*t9337*(d2fz0*t9293*t9335*(t9276-EcF_1*(EcF_2*EcF_3*t9306*(1.0/(t9253*t9253)*t9249*(t9252*t9254*t9294+c*t9213*t9215*t9253*t9255*(1.0/3.0))+c*t9213*t9215*t9263*t9257*t9302*(1.0/3.0))+t9250*t9247*t9249*(c*t9213*t9255*(1.0/3.0)-c*t9196*t9252*t9254)-EcF_3*c*t9213*t9215*t9263*t9257*(2.0/3.0)))-d2fz0*1.0/(t9292*t9292)*t9293*t9362*t9336)-t9232*t9341*t9324*t9325*4.0)+Ac_1*t9292*t9342*t9345*t9366*(pow(t9346,1.0/3.0)*t9364*(4.0/3.0)-t9364*pow(t9348,1.0/3.0)*(4.0/3.0))-Ac_1*t9350*t9342*t9362*t9345*t9366)-Ac_1*t9292*t9350*t9342*t9345*t9366);
+        }
+
+        // v_rho_b
+        if (deriv >= 1) {
+            double t9368 = rho_a+rho_b;
+            double t9369 = 1.0/pow(t9368,1.0/3.0);
+            double t9370 = c*t9369;
+            double t9371 = sqrt(t9370);
+            double t9372 = EcP_4*4.0;
+            double t9373 = EcP_3*EcP_3;
+            double t9374 = t9372-t9373;
+            double t9375 = EcP_2-t9371;
+            double t9376 = EcP_3*t9371;
+            double t9377 = EcP_4+t9370+t9376;
+            double t9378 = 1.0/t9377;
+            double t9379 = sqrt(t9374);
+            double t9380 = t9371*2.0;
+            double t9381 = EcP_3+t9380;
+            double t9382 = 1.0/t9381;
+            double t9383 = t9382*t9379;
+            double t9384 = atan(t9383);
+            double t9385 = 1.0/sqrt(t9374);
+            double t9386 = 1.0/pow(t9368,4.0/3.0);
+            double t9387 = c*t9386*(1.0/3.0);
+            double t9388 = 1.0/sqrt(t9370);
+            double t9389 = EcP_3*c*t9386*t9388*(1.0/6.0);
+            double t9390 = t9387+t9389;
+            double t9391 = t9375*t9375;
+            double t9392 = 1.0/(t9377*t9377);
+            double t9393 = EcP_2*4.0;
+            double t9394 = EcP_3*2.0;
+            double t9395 = t9393+t9394;
+            double t9396 = 1.0/(t9381*t9381);
+            double t9397 = EcP_2*EcP_2;
+            double t9398 = EcP_2*EcP_3;
+            double t9399 = EcP_4+t9397+t9398;
+            double t9400 = 1.0/t9399;
+            double t9401 = t9374*t9396;
+            double t9402 = t9401+1.0;
+            double t9403 = 1.0/t9402;
+            double t9404 = 1.0/t9368;
+            double t9405 = rho_a-rho_b;
+            double t9406 = t9404*t9405;
+            double t9407 = Ac_4*4.0;
+            double t9408 = Ac_3*Ac_3;
+            double t9409 = t9407-t9408;
+            double t9410 = Ac_2-t9371;
+            double t9411 = Ac_3*t9371;
+            double t9412 = Ac_4+t9370+t9411;
+            double t9413 = 1.0/t9412;
+            double t9414 = sqrt(t9409);
+            double t9415 = Ac_3+t9380;
+            double t9416 = 1.0/t9415;
+            double t9417 = t9414*t9416;
+            double t9418 = atan(t9417);
+            double t9419 = 1.0/sqrt(t9409);
+            double t9420 = 1.0/c;
+            double t9421 = EcF_3*t9371;
+            double t9422 = EcF_4+t9370+t9421;
+            double t9423 = pow(t9368,1.0/3.0);
+            double t9424 = EcF_3*c*t9386*t9388*(1.0/6.0);
+            double t9425 = t9387+t9424;
+            double t9426 = EcF_2-t9371;
+            double t9427 = 1.0/(t9422*t9422);
+            double t9428 = 1.0/t9422;
+            double t9429 = EcF_3+t9380;
+            double t9430 = 1.0/(t9429*t9429);
+            double t9431 = EcF_4*4.0;
+            double t9432 = EcF_3*EcF_3;
+            double t9433 = t9431-t9432;
+            double t9434 = t9430*t9433;
+            double t9435 = t9434+1.0;
+            double t9436 = 1.0/t9435;
+            double t9437 = c*t9386*t9378*(1.0/3.0);
+            double t9438 = t9437-c*t9390*t9392*t9369;
+            double t9439 = t9377*t9420*t9423*t9438;
+            double t9440 = t9390*t9391*t9392;
+            double t9441 = c*t9375*t9386*t9378*t9388*(1.0/3.0);
+            double t9442 = t9440+t9441;
+            double t9443 = 1.0/(t9375*t9375);
+            double t9444 = t9377*t9442*t9443;
+            double t9445 = c*t9386*t9395*t9396*t9388*t9403*(1.0/3.0);
+            double t9446 = t9444+t9445;
+            double t9447 = EcP_2*EcP_3*t9400*t9446;
+            double t9448 = t9447+t9439-EcP_3*c*t9386*t9396*t9388*t9403*(2.0/3.0);
+            double t9449 = EcP_1*t9448;
+            double t9450 = c*t9369*t9413;
+            double t9451 = log(t9450);
+            double t9452 = Ac_3*t9418*t9419*2.0;
+            double t9453 = t9410*t9410;
+            double t9454 = t9413*t9453;
+            double t9455 = log(t9454);
+            double t9456 = Ac_2*4.0;
+            double t9457 = Ac_3*2.0;
+            double t9458 = t9456+t9457;
+            double t9459 = t9418*t9419*t9458;
+            double t9460 = t9455+t9459;
+            double t9461 = Ac_2*Ac_2;
+            double t9462 = Ac_2*Ac_3;
+            double t9463 = Ac_4+t9461+t9462;
+            double t9464 = 1.0/t9463;
+            double t9489 = Ac_2*Ac_3*t9460*t9464;
+            double t9465 = t9451+t9452-t9489;
+            double t9466 = 1.0/Ac_1;
+            double t9467 = t9426*t9426;
+            double t9468 = sqrt(t9433);
+            double t9469 = 1.0/t9429;
+            double t9470 = t9468*t9469;
+            double t9471 = atan(t9470);
+            double t9472 = 1.0/sqrt(t9433);
+            double t9473 = EcF_2*4.0;
+            double t9474 = EcF_3*2.0;
+            double t9475 = t9473+t9474;
+            double t9476 = EcF_2*EcF_2;
+            double t9477 = EcF_2*EcF_3;
+            double t9478 = EcF_4+t9476+t9477;
+            double t9479 = 1.0/t9478;
+            double t9480 = c*t9369*t9378;
+            double t9481 = log(t9480);
+            double t9482 = EcP_3*t9384*t9385*2.0;
+            double t9483 = t9391*t9378;
+            double t9484 = log(t9483);
+            double t9485 = t9384*t9385*t9395;
+            double t9486 = t9484+t9485;
+            double t9507 = EcP_2*EcP_3*t9400*t9486;
+            double t9487 = t9481+t9482-t9507;
+            double t9488 = EcP_1*t9487;
+            double t9490 = Ac_3*c*t9386*t9388*(1.0/6.0);
+            double t9491 = t9387+t9490;
+            double t9492 = 1.0/(t9412*t9412);
+            double t9493 = 1.0/(t9415*t9415);
+            double t9494 = t9409*t9493;
+            double t9495 = t9494+1.0;
+            double t9496 = 1.0/t9495;
+            double t9497 = t9405*t9405;
+            double t9498 = 1.0/(t9368*t9368*t9368*t9368);
+            double t9499 = c*t9369*t9428;
+            double t9500 = log(t9499);
+            double t9501 = EcF_3*t9471*t9472*2.0;
+            double t9502 = t9428*t9467;
+            double t9503 = log(t9502);
+            double t9504 = t9471*t9472*t9475;
+            double t9505 = t9503+t9504;
+            double t9511 = EcF_2*EcF_3*t9479*t9505;
+            double t9506 = t9500+t9501-t9511;
+            double t9508 = 1.0/t9465;
+            double t9512 = EcF_1*t9506;
+            double t9509 = t9488-t9512;
+            double t9510 = t9497*t9497;
+            double t9513 = d2fz0*t9466*t9508*t9509;
+            double t9514 = t9513+1.0;
+            double t9515 = 1.0/d2fz0;
+            double t9516 = two_13*2.0;
+            double t9517 = t9516-2.0;
+            double t9518 = 1.0/t9517;
+            double t9519 = t9406+1.0;
+            double t9520 = pow(t9519,4.0/3.0);
+            double t9521 = -t9406+1.0;
+            double t9522 = pow(t9521,4.0/3.0);
+            double t9523 = t9520+t9522-2.0;
+            double t9524 = c*t9386*t9413*(1.0/3.0);
+            double t9525 = t9524-c*t9369*t9491*t9492;
+            double t9526 = t9420*t9412*t9423*t9525;
+            double t9527 = t9453*t9491*t9492;
+            double t9528 = c*t9386*t9388*t9410*t9413*(1.0/3.0);
+            double t9529 = t9527+t9528;
+            double t9530 = 1.0/(t9410*t9410);
+            double t9531 = t9412*t9530*t9529;
+            double t9532 = c*t9386*t9388*t9493*t9458*t9496*(1.0/3.0);
+            double t9533 = t9531+t9532;
+            double t9534 = Ac_2*Ac_3*t9464*t9533;
+            double t9535 = t9534+t9526-Ac_3*c*t9386*t9388*t9493*t9496*(2.0/3.0);
+            double t9536 = 1.0/(t9368*t9368);
+            double t9537 = t9405*t9536;
+            double t9538 = t9404+t9537;
+            double t9539 = t9498*t9510*t9514;
+            double t9540 = t9539-1.0;
+            v_rho_bp[Q] += mask * scale * (t9488-t9368*(t9449-Ac_1*t9465*t9523*t9515*t9518*(1.0/(t9368*t9368*t9368*t9368*t9368)*t9510*t9514*4.0+t9498*t9510*(d2fz0*t9466*t9508*(t9449-EcF_1*(EcF_2*EcF_3*t9479*(t9422*1.0/(t9426*t9426)*(t9425*t9427*t9467+c*t9386*t9388*t9426*t9428*(1.0/3.0))+c*t9386*t9388*t9430*t9436*t9475*(1.0/3.0))+t9420*t9422*t9423*(c*t9386*t9428*(1.0/3.0)-c*t9369*t9425*t9427)-EcF_3*c*t9386*t9388*t9430*t9436*(2.0/3.0)))-d2fz0*1.0/(t9465*t9465)*t9466*t9535*t9509)+t9405*t9497*t9498*t9514*4.0)+Ac_1*t9465*t9540*t9515*t9518*(pow(t9521,1.0/3.0)*t9538*(4.0/3.0)-pow(t9519,1.0/3.0)*t9538*(4.0/3.0))-Ac_1*t9540*t9523*t9515*t9535*t9518)-Ac_1*t9465*t9540*t9523*t9515*t9518);
         }
     }
 
@@ -1514,447 +1978,8 @@ void VWN5_CFunctional::compute_functional(const std::map<std::string,SharedVecto
             }
             
         } else {
-            // v
-            if (deriv >= 0) {
-                double t9113 = rho_a+rho_b;
-                double t9114 = 1.0/pow(t9113,1.0/3.0);
-                double t9115 = c*t9114;
-                double t9116 = sqrt(t9115);
-                double t9117 = EcP_4*4.0;
-                double t9118 = EcP_3*EcP_3;
-                double t9119 = t9117-t9118;
-                double t9120 = EcP_2-t9116;
-                double t9121 = EcP_3*t9116;
-                double t9122 = EcP_4+t9121+t9115;
-                double t9123 = 1.0/t9122;
-                double t9124 = sqrt(t9119);
-                double t9125 = t9116*2.0;
-                double t9126 = EcP_3+t9125;
-                double t9127 = 1.0/t9126;
-                double t9128 = t9124*t9127;
-                double t9129 = atan(t9128);
-                double t9130 = 1.0/sqrt(t9119);
-                double t9131 = rho_a-rho_b;
-                double t9132 = t9131*t9131;
-                double t9133 = EcF_4*4.0;
-                double t9134 = EcF_3*EcF_3;
-                double t9135 = t9133-t9134;
-                double t9136 = EcF_2-t9116;
-                double t9137 = EcF_3*t9116;
-                double t9138 = EcF_4+t9115+t9137;
-                double t9139 = 1.0/t9138;
-                double t9140 = sqrt(t9135);
-                double t9141 = EcF_3+t9125;
-                double t9142 = 1.0/t9141;
-                double t9143 = t9140*t9142;
-                double t9144 = atan(t9143);
-                double t9145 = 1.0/sqrt(t9135);
-                double t9146 = c*t9114*t9123;
-                double t9147 = log(t9146);
-                double t9148 = EcP_3*t9130*t9129*2.0;
-                double t9149 = t9120*t9120;
-                double t9150 = t9123*t9149;
-                double t9151 = log(t9150);
-                double t9152 = EcP_2*4.0;
-                double t9153 = EcP_3*2.0;
-                double t9154 = t9152+t9153;
-                double t9155 = t9130*t9154*t9129;
-                double t9156 = t9151+t9155;
-                double t9157 = EcP_2*EcP_2;
-                double t9158 = EcP_2*EcP_3;
-                double t9159 = EcP_4+t9157+t9158;
-                double t9160 = 1.0/t9159;
-                double t9161 = t9147+t9148-EcP_2*EcP_3*t9160*t9156;
-                double t9162 = EcP_1*t9161;
-                double t9163 = Ac_4*4.0;
-                double t9164 = Ac_3*Ac_3;
-                double t9165 = t9163-t9164;
-                double t9166 = Ac_2-t9116;
-                double t9167 = Ac_3*t9116;
-                double t9168 = Ac_4+t9115+t9167;
-                double t9169 = 1.0/t9168;
-                double t9170 = sqrt(t9165);
-                double t9171 = Ac_3+t9125;
-                double t9172 = 1.0/t9171;
-                double t9173 = t9170*t9172;
-                double t9174 = atan(t9173);
-                double t9175 = 1.0/sqrt(t9165);
-                double t9176 = 1.0/t9113;
-                double t9177 = t9131*t9176;
-                double t9178 = c*t9114*t9169;
-                double t9179 = log(t9178);
-                double t9180 = Ac_3*t9174*t9175*2.0;
-                double t9181 = t9166*t9166;
-                double t9182 = t9181*t9169;
-                double t9183 = log(t9182);
-                double t9184 = Ac_2*4.0;
-                double t9185 = Ac_3*2.0;
-                double t9186 = t9184+t9185;
-                double t9187 = t9174*t9175*t9186;
-                double t9188 = t9183+t9187;
-                double t9189 = Ac_2*Ac_2;
-                double t9190 = Ac_2*Ac_3;
-                double t9191 = Ac_4+t9190+t9189;
-                double t9192 = 1.0/t9191;
-                double t9193 = t9180+t9179-Ac_2*Ac_3*t9192*t9188;
-                v[Q] += scale * (t9113*(t9162-(Ac_1*t9193*(1.0/(t9113*t9113*t9113*t9113)*(t9132*t9132)*((d2fz0*(t9162-EcF_1*(log(c*t9114*t9139)+EcF_3*t9144*t9145*2.0-(EcF_2*EcF_3*(log((t9136*t9136)*t9139)+t9144*t9145*(EcF_2*4.0+EcF_3*2.0)))/(EcF_4+EcF_2*EcF_2+EcF_2*EcF_3))))/(Ac_1*t9193)+1.0)-1.0)*(pow(t9177+1.0,4.0/3.0)+pow(-t9177+1.0,4.0/3.0)-2.0))/(d2fz0*(two_13*2.0-2.0))));
-            }
-            
-            // v_rho_a
-            if (deriv >= 1) {
-                double t9195 = rho_a+rho_b;
-                double t9196 = 1.0/pow(t9195,1.0/3.0);
-                double t9197 = c*t9196;
-                double t9198 = sqrt(t9197);
-                double t9199 = EcP_4*4.0;
-                double t9200 = EcP_3*EcP_3;
-                double t9201 = t9199-t9200;
-                double t9202 = EcP_2-t9198;
-                double t9203 = EcP_3*t9198;
-                double t9204 = EcP_4+t9197+t9203;
-                double t9205 = 1.0/t9204;
-                double t9206 = sqrt(t9201);
-                double t9207 = t9198*2.0;
-                double t9208 = EcP_3+t9207;
-                double t9209 = 1.0/t9208;
-                double t9210 = t9206*t9209;
-                double t9211 = atan(t9210);
-                double t9212 = 1.0/sqrt(t9201);
-                double t9213 = 1.0/pow(t9195,4.0/3.0);
-                double t9214 = c*t9213*(1.0/3.0);
-                double t9215 = 1.0/sqrt(t9197);
-                double t9216 = EcP_3*c*t9213*t9215*(1.0/6.0);
-                double t9217 = t9214+t9216;
-                double t9218 = t9202*t9202;
-                double t9219 = 1.0/(t9204*t9204);
-                double t9220 = EcP_2*4.0;
-                double t9221 = EcP_3*2.0;
-                double t9222 = t9220+t9221;
-                double t9223 = 1.0/(t9208*t9208);
-                double t9224 = EcP_2*EcP_2;
-                double t9225 = EcP_2*EcP_3;
-                double t9226 = EcP_4+t9224+t9225;
-                double t9227 = 1.0/t9226;
-                double t9228 = t9201*t9223;
-                double t9229 = t9228+1.0;
-                double t9230 = 1.0/t9229;
-                double t9231 = 1.0/t9195;
-                double t9232 = rho_a-rho_b;
-                double t9233 = t9231*t9232;
-                double t9234 = Ac_4*4.0;
-                double t9235 = Ac_3*Ac_3;
-                double t9236 = t9234-t9235;
-                double t9237 = Ac_2-t9198;
-                double t9238 = Ac_3*t9198;
-                double t9239 = Ac_4+t9197+t9238;
-                double t9240 = 1.0/t9239;
-                double t9241 = sqrt(t9236);
-                double t9242 = Ac_3+t9207;
-                double t9243 = 1.0/t9242;
-                double t9244 = t9241*t9243;
-                double t9245 = atan(t9244);
-                double t9246 = 1.0/sqrt(t9236);
-                double t9247 = 1.0/c;
-                double t9248 = EcF_3*t9198;
-                double t9249 = EcF_4+t9197+t9248;
-                double t9250 = pow(t9195,1.0/3.0);
-                double t9251 = EcF_3*c*t9213*t9215*(1.0/6.0);
-                double t9252 = t9214+t9251;
-                double t9253 = EcF_2-t9198;
-                double t9254 = 1.0/(t9249*t9249);
-                double t9255 = 1.0/t9249;
-                double t9256 = EcF_3+t9207;
-                double t9257 = 1.0/(t9256*t9256);
-                double t9258 = EcF_4*4.0;
-                double t9259 = EcF_3*EcF_3;
-                double t9260 = t9258-t9259;
-                double t9261 = t9260*t9257;
-                double t9262 = t9261+1.0;
-                double t9263 = 1.0/t9262;
-                double t9264 = c*t9213*t9205*(1.0/3.0);
-                double t9265 = t9264-c*t9196*t9217*t9219;
-                double t9266 = t9204*t9250*t9247*t9265;
-                double t9267 = t9217*t9218*t9219;
-                double t9268 = c*t9202*t9213*t9205*t9215*(1.0/3.0);
-                double t9269 = t9267+t9268;
-                double t9270 = 1.0/(t9202*t9202);
-                double t9271 = t9204*t9270*t9269;
-                double t9272 = c*t9230*t9213*t9222*t9223*t9215*(1.0/3.0);
-                double t9273 = t9271+t9272;
-                double t9274 = EcP_2*EcP_3*t9227*t9273;
-                double t9275 = t9274+t9266-EcP_3*c*t9230*t9213*t9223*t9215*(2.0/3.0);
-                double t9276 = EcP_1*t9275;
-                double t9277 = c*t9196*t9240;
-                double t9278 = log(t9277);
-                double t9279 = Ac_3*t9245*t9246*2.0;
-                double t9280 = t9237*t9237;
-                double t9281 = t9240*t9280;
-                double t9282 = log(t9281);
-                double t9283 = Ac_2*4.0;
-                double t9284 = Ac_3*2.0;
-                double t9285 = t9283+t9284;
-                double t9286 = t9245*t9246*t9285;
-                double t9287 = t9282+t9286;
-                double t9288 = Ac_2*Ac_2;
-                double t9289 = Ac_2*Ac_3;
-                double t9290 = Ac_4+t9288+t9289;
-                double t9291 = 1.0/t9290;
-                double t9316 = Ac_2*Ac_3*t9291*t9287;
-                double t9292 = t9278+t9279-t9316;
-                double t9293 = 1.0/Ac_1;
-                double t9294 = t9253*t9253;
-                double t9295 = sqrt(t9260);
-                double t9296 = 1.0/t9256;
-                double t9297 = t9295*t9296;
-                double t9298 = atan(t9297);
-                double t9299 = 1.0/sqrt(t9260);
-                double t9300 = EcF_2*4.0;
-                double t9301 = EcF_3*2.0;
-                double t9302 = t9300+t9301;
-                double t9303 = EcF_2*EcF_2;
-                double t9304 = EcF_2*EcF_3;
-                double t9305 = EcF_4+t9303+t9304;
-                double t9306 = 1.0/t9305;
-                double t9307 = c*t9196*t9205;
-                double t9308 = log(t9307);
-                double t9309 = EcP_3*t9211*t9212*2.0;
-                double t9310 = t9205*t9218;
-                double t9311 = log(t9310);
-                double t9312 = t9211*t9212*t9222;
-                double t9313 = t9311+t9312;
-                double t9334 = EcP_2*EcP_3*t9227*t9313;
-                double t9314 = -t9334+t9308+t9309;
-                double t9315 = EcP_1*t9314;
-                double t9317 = Ac_3*c*t9213*t9215*(1.0/6.0);
-                double t9318 = t9214+t9317;
-                double t9319 = 1.0/(t9239*t9239);
-                double t9320 = 1.0/(t9242*t9242);
-                double t9321 = t9236*t9320;
-                double t9322 = t9321+1.0;
-                double t9323 = 1.0/t9322;
-                double t9324 = t9232*t9232;
-                double t9325 = 1.0/(t9195*t9195*t9195*t9195);
-                double t9326 = c*t9196*t9255;
-                double t9327 = log(t9326);
-                double t9328 = EcF_3*t9298*t9299*2.0;
-                double t9329 = t9255*t9294;
-                double t9330 = log(t9329);
-                double t9331 = t9298*t9299*t9302;
-                double t9332 = t9330+t9331;
-                double t9338 = EcF_2*EcF_3*t9332*t9306;
-                double t9333 = t9327+t9328-t9338;
-                double t9335 = 1.0/t9292;
-                double t9339 = EcF_1*t9333;
-                double t9336 = t9315-t9339;
-                double t9337 = t9324*t9324;
-                double t9340 = d2fz0*t9293*t9335*t9336;
-                double t9341 = t9340+1.0;
-                double t9342 = 1.0/d2fz0;
-                double t9343 = two_13*2.0;
-                double t9344 = t9343-2.0;
-                double t9345 = 1.0/t9344;
-                double t9346 = t9233+1.0;
-                double t9347 = pow(t9346,4.0/3.0);
-                double t9348 = -t9233+1.0;
-                double t9349 = pow(t9348,4.0/3.0);
-                double t9350 = t9347+t9349-2.0;
-                double t9351 = c*t9213*t9240*(1.0/3.0);
-                double t9352 = t9351-c*t9196*t9318*t9319;
-                double t9353 = t9250*t9247*t9239*t9352;
-                double t9354 = t9280*t9318*t9319;
-                double t9355 = c*t9213*t9240*t9215*t9237*(1.0/3.0);
-                double t9356 = t9354+t9355;
-                double t9357 = 1.0/(t9237*t9237);
-                double t9358 = t9239*t9356*t9357;
-                double t9359 = c*t9213*t9215*t9285*t9320*t9323*(1.0/3.0);
-                double t9360 = t9358+t9359;
-                double t9361 = Ac_2*Ac_3*t9291*t9360;
-                double t9362 = t9361+t9353-Ac_3*c*t9213*t9215*t9320*t9323*(2.0/3.0);
-                double t9363 = 1.0/(t9195*t9195);
-                double t9364 = t9231-t9232*t9363;
-                double t9365 = t9341*t9325*t9337;
-                double t9366 = t9365-1.0;
-                v_rho_a[Q] += scale * (t9315-t9195*(t9276-Ac_1*t9292*t9350*t9342*t9345*(1.0/(t9195*t9195*t9195*t9195*t9195)*t9341*t9337*4.0+t9325*t9337*(d2fz0*t9293*t9335*(t9276-EcF_1*(EcF_2*EcF_3*t9306*(1.0/(t9253*t9253)*t9249*(t9252*t9254*t9294+c*t9213*t9215*t9253*t9255*(1.0/3.0))+c*t9213*t9215*t9263*t9257*t9302*(1.0/3.0))+t9250*t9247*t9249*(c*t9213*t9255*(1.0/3.0)-c*t9196*t9252*t9254)-EcF_3*c*t9213*t9215*t9263*t9257*(2.0/3.0)))-d2fz0*1.0/(t9292*t9292)*t9293*t9362*t9336)-t9232*t9341*t9324*t9325*4.0)+Ac_1*t9292*t9342*t9345*t9366*(pow(t9346,1.0/3.0)*t9364*(4.0/3.0)-t9364*pow(t9348,1.0/3.0)*(4.0/3.0))-Ac_1*t9350*t9342*t9362*t9345*t9366)-Ac_1*t9292*t9350*t9342*t9345*t9366);
-            }
-            
-            // v_rho_b
-            if (deriv >= 1) {
-                double t9368 = rho_a+rho_b;
-                double t9369 = 1.0/pow(t9368,1.0/3.0);
-                double t9370 = c*t9369;
-                double t9371 = sqrt(t9370);
-                double t9372 = EcP_4*4.0;
-                double t9373 = EcP_3*EcP_3;
-                double t9374 = t9372-t9373;
-                double t9375 = EcP_2-t9371;
-                double t9376 = EcP_3*t9371;
-                double t9377 = EcP_4+t9370+t9376;
-                double t9378 = 1.0/t9377;
-                double t9379 = sqrt(t9374);
-                double t9380 = t9371*2.0;
-                double t9381 = EcP_3+t9380;
-                double t9382 = 1.0/t9381;
-                double t9383 = t9382*t9379;
-                double t9384 = atan(t9383);
-                double t9385 = 1.0/sqrt(t9374);
-                double t9386 = 1.0/pow(t9368,4.0/3.0);
-                double t9387 = c*t9386*(1.0/3.0);
-                double t9388 = 1.0/sqrt(t9370);
-                double t9389 = EcP_3*c*t9386*t9388*(1.0/6.0);
-                double t9390 = t9387+t9389;
-                double t9391 = t9375*t9375;
-                double t9392 = 1.0/(t9377*t9377);
-                double t9393 = EcP_2*4.0;
-                double t9394 = EcP_3*2.0;
-                double t9395 = t9393+t9394;
-                double t9396 = 1.0/(t9381*t9381);
-                double t9397 = EcP_2*EcP_2;
-                double t9398 = EcP_2*EcP_3;
-                double t9399 = EcP_4+t9397+t9398;
-                double t9400 = 1.0/t9399;
-                double t9401 = t9374*t9396;
-                double t9402 = t9401+1.0;
-                double t9403 = 1.0/t9402;
-                double t9404 = 1.0/t9368;
-                double t9405 = rho_a-rho_b;
-                double t9406 = t9404*t9405;
-                double t9407 = Ac_4*4.0;
-                double t9408 = Ac_3*Ac_3;
-                double t9409 = t9407-t9408;
-                double t9410 = Ac_2-t9371;
-                double t9411 = Ac_3*t9371;
-                double t9412 = Ac_4+t9370+t9411;
-                double t9413 = 1.0/t9412;
-                double t9414 = sqrt(t9409);
-                double t9415 = Ac_3+t9380;
-                double t9416 = 1.0/t9415;
-                double t9417 = t9414*t9416;
-                double t9418 = atan(t9417);
-                double t9419 = 1.0/sqrt(t9409);
-                double t9420 = 1.0/c;
-                double t9421 = EcF_3*t9371;
-                double t9422 = EcF_4+t9370+t9421;
-                double t9423 = pow(t9368,1.0/3.0);
-                double t9424 = EcF_3*c*t9386*t9388*(1.0/6.0);
-                double t9425 = t9387+t9424;
-                double t9426 = EcF_2-t9371;
-                double t9427 = 1.0/(t9422*t9422);
-                double t9428 = 1.0/t9422;
-                double t9429 = EcF_3+t9380;
-                double t9430 = 1.0/(t9429*t9429);
-                double t9431 = EcF_4*4.0;
-                double t9432 = EcF_3*EcF_3;
-                double t9433 = t9431-t9432;
-                double t9434 = t9430*t9433;
-                double t9435 = t9434+1.0;
-                double t9436 = 1.0/t9435;
-                double t9437 = c*t9386*t9378*(1.0/3.0);
-                double t9438 = t9437-c*t9390*t9392*t9369;
-                double t9439 = t9377*t9420*t9423*t9438;
-                double t9440 = t9390*t9391*t9392;
-                double t9441 = c*t9375*t9386*t9378*t9388*(1.0/3.0);
-                double t9442 = t9440+t9441;
-                double t9443 = 1.0/(t9375*t9375);
-                double t9444 = t9377*t9442*t9443;
-                double t9445 = c*t9386*t9395*t9396*t9388*t9403*(1.0/3.0);
-                double t9446 = t9444+t9445;
-                double t9447 = EcP_2*EcP_3*t9400*t9446;
-                double t9448 = t9447+t9439-EcP_3*c*t9386*t9396*t9388*t9403*(2.0/3.0);
-                double t9449 = EcP_1*t9448;
-                double t9450 = c*t9369*t9413;
-                double t9451 = log(t9450);
-                double t9452 = Ac_3*t9418*t9419*2.0;
-                double t9453 = t9410*t9410;
-                double t9454 = t9413*t9453;
-                double t9455 = log(t9454);
-                double t9456 = Ac_2*4.0;
-                double t9457 = Ac_3*2.0;
-                double t9458 = t9456+t9457;
-                double t9459 = t9418*t9419*t9458;
-                double t9460 = t9455+t9459;
-                double t9461 = Ac_2*Ac_2;
-                double t9462 = Ac_2*Ac_3;
-                double t9463 = Ac_4+t9461+t9462;
-                double t9464 = 1.0/t9463;
-                double t9489 = Ac_2*Ac_3*t9460*t9464;
-                double t9465 = t9451+t9452-t9489;
-                double t9466 = 1.0/Ac_1;
-                double t9467 = t9426*t9426;
-                double t9468 = sqrt(t9433);
-                double t9469 = 1.0/t9429;
-                double t9470 = t9468*t9469;
-                double t9471 = atan(t9470);
-                double t9472 = 1.0/sqrt(t9433);
-                double t9473 = EcF_2*4.0;
-                double t9474 = EcF_3*2.0;
-                double t9475 = t9473+t9474;
-                double t9476 = EcF_2*EcF_2;
-                double t9477 = EcF_2*EcF_3;
-                double t9478 = EcF_4+t9476+t9477;
-                double t9479 = 1.0/t9478;
-                double t9480 = c*t9369*t9378;
-                double t9481 = log(t9480);
-                double t9482 = EcP_3*t9384*t9385*2.0;
-                double t9483 = t9391*t9378;
-                double t9484 = log(t9483);
-                double t9485 = t9384*t9385*t9395;
-                double t9486 = t9484+t9485;
-                double t9507 = EcP_2*EcP_3*t9400*t9486;
-                double t9487 = t9481+t9482-t9507;
-                double t9488 = EcP_1*t9487;
-                double t9490 = Ac_3*c*t9386*t9388*(1.0/6.0);
-                double t9491 = t9387+t9490;
-                double t9492 = 1.0/(t9412*t9412);
-                double t9493 = 1.0/(t9415*t9415);
-                double t9494 = t9409*t9493;
-                double t9495 = t9494+1.0;
-                double t9496 = 1.0/t9495;
-                double t9497 = t9405*t9405;
-                double t9498 = 1.0/(t9368*t9368*t9368*t9368);
-                double t9499 = c*t9369*t9428;
-                double t9500 = log(t9499);
-                double t9501 = EcF_3*t9471*t9472*2.0;
-                double t9502 = t9428*t9467;
-                double t9503 = log(t9502);
-                double t9504 = t9471*t9472*t9475;
-                double t9505 = t9503+t9504;
-                double t9511 = EcF_2*EcF_3*t9479*t9505;
-                double t9506 = t9500+t9501-t9511;
-                double t9508 = 1.0/t9465;
-                double t9512 = EcF_1*t9506;
-                double t9509 = t9488-t9512;
-                double t9510 = t9497*t9497;
-                double t9513 = d2fz0*t9466*t9508*t9509;
-                double t9514 = t9513+1.0;
-                double t9515 = 1.0/d2fz0;
-                double t9516 = two_13*2.0;
-                double t9517 = t9516-2.0;
-                double t9518 = 1.0/t9517;
-                double t9519 = t9406+1.0;
-                double t9520 = pow(t9519,4.0/3.0);
-                double t9521 = -t9406+1.0;
-                double t9522 = pow(t9521,4.0/3.0);
-                double t9523 = t9520+t9522-2.0;
-                double t9524 = c*t9386*t9413*(1.0/3.0);
-                double t9525 = t9524-c*t9369*t9491*t9492;
-                double t9526 = t9420*t9412*t9423*t9525;
-                double t9527 = t9453*t9491*t9492;
-                double t9528 = c*t9386*t9388*t9410*t9413*(1.0/3.0);
-                double t9529 = t9527+t9528;
-                double t9530 = 1.0/(t9410*t9410);
-                double t9531 = t9412*t9530*t9529;
-                double t9532 = c*t9386*t9388*t9493*t9458*t9496*(1.0/3.0);
-                double t9533 = t9531+t9532;
-                double t9534 = Ac_2*Ac_3*t9464*t9533;
-                double t9535 = t9534+t9526-Ac_3*c*t9386*t9388*t9493*t9496*(2.0/3.0);
-                double t9536 = 1.0/(t9368*t9368);
-                double t9537 = t9405*t9536;
-                double t9538 = t9404+t9537;
-                double t9539 = t9498*t9510*t9514;
-                double t9540 = t9539-1.0;
-                v_rho_b[Q] += scale * (t9488-t9368*(t9449-Ac_1*t9465*t9523*t9515*t9518*(1.0/(t9368*t9368*t9368*t9368*t9368)*t9510*t9514*4.0+t9498*t9510*(d2fz0*t9466*t9508*(t9449-EcF_1*(EcF_2*EcF_3*t9479*(t9422*1.0/(t9426*t9426)*(t9425*t9427*t9467+c*t9386*t9388*t9426*t9428*(1.0/3.0))+c*t9386*t9388*t9430*t9436*t9475*(1.0/3.0))+t9420*t9422*t9423*(c*t9386*t9428*(1.0/3.0)-c*t9369*t9425*t9427)-EcF_3*c*t9386*t9388*t9430*t9436*(2.0/3.0)))-d2fz0*1.0/(t9465*t9465)*t9466*t9535*t9509)+t9405*t9497*t9498*t9514*4.0)+Ac_1*t9465*t9540*t9515*t9518*(pow(t9521,1.0/3.0)*t9538*(4.0/3.0)-pow(t9519,1.0/3.0)*t9538*(4.0/3.0))-Ac_1*t9540*t9523*t9515*t9535*t9518)-Ac_1*t9465*t9540*t9523*t9515*t9518);
-            }
-            
+            // v and the first partials are done in the loop above
+
             // v_rho_a_rho_a
             if (deriv >= 2) {
                 double t9547 = rho_a+rho_b;
@@ -2240,7 +2265,7 @@ void VWN5_CFunctional::compute_functional(const std::map<std::string,SharedVecto
                 double t9825 = t9821+t9822+t9823+t9824+t9809-t9558*t9623*t9671*t9746*(1.0/3.0)-Ac_3*c*t9555*t9564*t9723*t9726*(8.0/9.0)-Ac_3*c*t9564*t9620*t9767*t9768*(4.0/9.0);
                 v_rho_a_rho_a[Q] += scale * (EcP_1*t9781*-2.0+t9547*(t9717+Ac_1*t9661*t9646*t9658*t9801*(1.0/(t9547*t9547*t9547*t9547*t9547*t9547)*t9664*t9790*2.0E1+t9595*t9663*t9790*1.2E1+t9664*t9791*t9788*8.0-t9663*t9664*(d2fz0*t9665*t9718*(t9717-EcF_1*(t9563*t9558*t9601*(c*t9564*t9602*(4.0/9.0)+c*t9548*t9680*t9681*2.0-c*t9550*t9667*t9669*(2.0/3.0)-c*t9548*t9669*t9679)+t9563*t9558*t9670*t9667-t9558*t9601*t9670*t9671*(1.0/3.0)+EcF_2*EcF_3*t9675*(-t9601*t9677*(c*t9564*t9602*(1.0/1.8E1)+t9680*t9681*t9676*2.0-t9676*t9669*t9679-c*t9555*t9564*t9599*t9602*(4.0/9.0)+t9570*t9571*t9572*t9599*t9602*(1.0/1.8E1)+c*t9550*t9555*t9599*t9667*t9669*(2.0/3.0))+t9691*t9667*t9677-c*t9564*t9692*t9684*t9688*(2.0/9.0)+c*t9555*t9564*t9684*t9685*t9688*(4.0/9.0)+c*t9564*t9598*t9684*t9693*t9694*(2.0/9.0)-t9570*t9571*t9572*t9684*t9685*t9688*(1.0/1.8E1)+c*t9550*t9555*1.0/(t9599*t9599*t9599)*t9601*t9691*(1.0/3.0))+EcF_3*c*t9564*t9692*t9688*(4.0/9.0)-EcF_3*c*t9555*t9564*t9685*t9688*(8.0/9.0)-EcF_3*c*t9564*t9598*t9693*t9694*(4.0/9.0)+EcF_3*t9570*t9571*t9572*t9685*t9688*(1.0/9.0)))-d2fz0*1.0/(t9646*t9646*t9646)*t9665*t9744*(t9756*t9756)*2.0+d2fz0*t9665*t9760*t9782*t9756*2.0+d2fz0*t9665*t9760*t9744*t9825)-t9594*t9595*t9663*t9788*8.0-t9594*t9595*t9790*t9791*3.2E1)+Ac_1*t9661*t9646*t9658*t9798*(t9652*t9792*(-4.0/3.0)+t9652*t9793*(4.0/3.0)+1.0/pow(t9653,2.0/3.0)*t9657*(4.0/9.0)+1.0/pow(t9655,2.0/3.0)*t9657*(4.0/9.0))-Ac_1*t9661*t9646*t9658*t9796*t9804*2.0-Ac_1*t9661*t9658*t9756*t9796*t9798*2.0+Ac_1*t9661*t9658*t9756*t9801*t9804*2.0+Ac_1*t9661*t9658*t9798*t9801*t9825)+Ac_1*t9661*t9646*t9658*t9796*t9798*2.0-Ac_1*t9661*t9646*t9658*t9801*t9804*2.0-Ac_1*t9661*t9658*t9756*t9798*t9801*2.0);
             }
-            
+
             // v_rho_a_rho_b
             if (deriv >= 2) {
                 double t9829 = rho_a+rho_b;
@@ -2528,7 +2553,7 @@ void VWN5_CFunctional::compute_functional(const std::map<std::string,SharedVecto
                 double t10109 = t10031+t10033-t10046;
                 v_rho_a_rho_b[Q] += scale * (EcP_1*t9968*-2.0+t9829*(t10080+Ac_1*t10049*t9942*t9929*t9939*(t10000*1.0/(t9829*t9829*t9829*t9829*t9829*t9829)*t9995*2.0E1+t10030*t10032*t9995*8.0-t10000*t9882*t9946*1.2E1-t9946*t9995*(d2fz0*t9947*t9969*(t10080-EcF_1*(t9852*t9855*t9888*(c*t9857*t9889*(4.0/9.0)+c*t10054*t10055*t9830*2.0-c*t10053*t9830*t9951-c*t9832*t9951*t9949*(2.0/3.0))-t10002*t10051*t9852*t9888*(1.0/3.0)+t10002*t9852*t9855*t9949+EcF_2*EcF_3*t9959*(-t10007*t9888*(c*t9857*t9889*(1.0/1.8E1)+t10054*t10055*t9950*2.0-t10053*t9950*t9951-c*t9837*t9857*t9886*t9889*(4.0/9.0)+t9870*t9871*t9886*t9869*t9889*(1.0/1.8E1)+c*t9832*t9837*t9886*t9951*t9949*(2.0/3.0))+t10006*t10007*t9949-c*t10056*t9857*t9962*t9954*(2.0/9.0)+c*t10057*t10058*t9857*t9885*t9954*(2.0/9.0)+c*t9837*t9857*t9962*t9954*t9955*(4.0/9.0)-t9870*t9871*t9869*t9962*t9954*t9955*(1.0/1.8E1)+c*t10006*t9832*t9837*1.0/(t9886*t9886*t9886)*t9888*(1.0/3.0))+EcF_3*c*t10056*t9857*t9962*(4.0/9.0)-EcF_3*c*t10057*t10058*t9857*t9885*(4.0/9.0)-EcF_3*c*t9837*t9857*t9962*t9955*(8.0/9.0)+EcF_3*t9870*t9871*t9869*t9962*t9955*(1.0/9.0)))-d2fz0*(t10029*t10029)*1.0/(t9929*t9929*t9929)*t9947*t9987*2.0+d2fz0*t10015*t10017*t10029*t9947*2.0+d2fz0*t10017*t10108*t9947*t9987))-Ac_1*t10037*t9942*t9929*t9939*(1.0/pow(t9933,2.0/3.0)*t9937*t9938*(4.0/9.0)+1.0/pow(t9936,2.0/3.0)*t9937*t9938*(4.0/9.0)-t9881*t9932*t9943*(8.0/3.0)+t9881*t9932*t9944*(8.0/3.0))-Ac_1*t10041*t10037*t10029*t9942*t9939+Ac_1*t10050*t10029*t10049*t9942*t9939+Ac_1*t10035*t10037*t10029*t9942*t9939+Ac_1*t10108*t10037*t10049*t9942*t9939+Ac_1*t10109*t10029*t10049*t9942*t9939-Ac_1*t10041*t10050*t9942*t9929*t9939+Ac_1*t10035*t9942*t9929*t9939*(t10031+t10033-t10000*t9881*t9882*t9946*4.0))-Ac_1*t10037*t10029*t10049*t9942*t9939*2.0+Ac_1*t10041*t10037*t9942*t9929*t9939-Ac_1*t10050*t10049*t9942*t9929*t9939-Ac_1*t10035*t10037*t9942*t9929*t9939-Ac_1*t10109*t10049*t9942*t9929*t9939);
             }
-            
+
             // v_rho_b_rho_b
             if (deriv >= 2) {
                 double t10113 = rho_a+rho_b;
@@ -2815,7 +2840,7 @@ void VWN5_CFunctional::compute_functional(const std::map<std::string,SharedVecto
                 double t10393 = t10390+t10391+t10392+t10377+t10389-t10124*t10313*t10238*t10189*(1.0/3.0)-Ac_3*c*t10121*t10130*t10290*t10293*(8.0/9.0)-Ac_3*c*t10130*t10334*t10335*t10186*(4.0/9.0);
                 v_rho_b_rho_b[Q] += scale * (EcP_1*t10348*-2.0+t10113*(t10284+Ac_1*t10212*t10225*t10228*t10368*(1.0/(t10113*t10113*t10113*t10113*t10113*t10113)*t10231*t10357*2.0E1+t10230*t10161*t10357*1.2E1+t10231*t10355*t10358*8.0-t10230*t10231*(d2fz0*t10232*t10285*(t10284-EcF_1*(t10124*t10129*t10167*(c*t10130*t10168*(4.0/9.0)-c*t10116*t10234*t10236*(2.0/3.0)-c*t10114*t10236*t10246+c*t10114*t10247*t10248*2.0)+t10124*t10234*t10129*t10237-t10124*t10237*t10238*t10167*(1.0/3.0)+EcF_2*EcF_3*t10242*(-t10244*t10167*(c*t10130*t10168*(1.0/1.8E1)-t10243*t10236*t10246+t10243*t10247*t10248*2.0-c*t10121*t10130*t10165*t10168*(4.0/9.0)+t10136*t10137*t10138*t10165*t10168*(1.0/1.8E1)+c*t10121*t10116*t10234*t10236*t10165*(2.0/3.0))+t10234*t10244*t10258-c*t10130*t10251*t10255*t10259*(2.0/9.0)+c*t10121*t10130*t10251*t10252*t10255*(4.0/9.0)+c*t10130*t10251*t10260*t10261*t10164*(2.0/9.0)-t10251*t10252*t10136*t10137*t10138*t10255*(1.0/1.8E1)+c*t10121*t10116*1.0/(t10165*t10165*t10165)*t10167*t10258*(1.0/3.0))+EcF_3*c*t10130*t10255*t10259*(4.0/9.0)-EcF_3*c*t10121*t10130*t10252*t10255*(8.0/9.0)-EcF_3*c*t10130*t10260*t10261*t10164*(4.0/9.0)+EcF_3*t10252*t10136*t10137*t10138*t10255*(1.0/9.0)))-d2fz0*1.0/(t10212*t10212*t10212)*t10311*t10232*(t10323*t10323)*2.0+d2fz0*t10311*t10232*t10327*t10393+d2fz0*t10232*t10323*t10327*t10349*2.0)+t10230*t10160*t10161*t10355*8.0+t10160*t10161*t10357*t10358*3.2E1)+Ac_1*t10212*t10225*t10228*t10364*(t10360*t10219*(-4.0/3.0)+t10219*t10359*(4.0/3.0)+1.0/pow(t10220,2.0/3.0)*t10224*(4.0/9.0)+1.0/pow(t10222,2.0/3.0)*t10224*(4.0/9.0))-Ac_1*t10212*t10225*t10228*t10372*t10365*2.0-Ac_1*t10323*t10225*t10228*t10364*t10365*2.0+Ac_1*t10323*t10225*t10228*t10372*t10368*2.0+Ac_1*t10225*t10228*t10364*t10393*t10368)+Ac_1*t10212*t10225*t10228*t10364*(t10362-t10394)*2.0-Ac_1*t10212*t10225*t10228*t10372*t10368*2.0-Ac_1*t10323*t10225*t10228*t10364*t10368*2.0);
             }
-            
+
         }
     }
 }
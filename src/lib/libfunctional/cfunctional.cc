@@ -104,11 +104,15 @@ void CFunctional::set_parameter(const std::string& key, double val)
 }
 void CFunctional::compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha)
 {
-    compute_ss_functional(in,out,npoints,deriv,alpha,true);
-    compute_ss_functional(in,out,npoints,deriv,alpha,false);
-    compute_os_functional(in,out,npoints,deriv,alpha);
+    compute_block(FunctionalPoints::from_maps(in, out), npoints, deriv, alpha);
 }
-void CFunctional::compute_ss_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha, bool spin)
+void CFunctional::compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha)
+{
+    compute_ss_functional(points,npoints,deriv,alpha,true);
+    compute_ss_functional(points,npoints,deriv,alpha,false);
+    compute_os_functional(points,npoints,deriv,alpha);
+}
+void CFunctional::compute_ss_functional(const FunctionalPoints& points, int npoints, int deriv, double alpha, bool spin)
 {
     if (deriv > 1) {
         throw PSIEXCEPTION("CFunctional: 2nd and higher partials not implemented yet.");
@@ -122,12 +126,12 @@ void CFunctional::compute_ss_functional(const std::map<std::string,SharedVector>
     double* rho_s = NULL;
     double* gamma_s = NULL;
     double* tau_s = NULL;
-    rho_s = in.find(spin ? "RHO_A" : "RHO_B")->second->pointer();
+    rho_s = points.in[spin ? FunctionalPoints::RHO_A : FunctionalPoints::RHO_B];
     if (gga_) {
-        gamma_s = in.find(spin ? "GAMMA_AA" : "GAMMA_BB")->second->pointer();
+        gamma_s = points.in[spin ? FunctionalPoints::GAMMA_AA : FunctionalPoints::GAMMA_BB];
     }
     if (meta_) {
-        tau_s = in.find(spin ? "TAU_A" : "TAU_B")->second->pointer();
+        tau_s = points.in[spin ? FunctionalPoints::TAU_A : FunctionalPoints::TAU_B];
     }
 
     // => Output variables <= //
@@ -137,14 +141,14 @@ void CFunctional::compute_ss_functional(const std::map<std::string,SharedVector>
     double* v_gamma = NULL;
     double* v_tau = NULL;
     
-    v = out.find(spin ? "V" : "V")->second->pointer();
+    v = points.out[FunctionalPoints::V];
     if (deriv >= 1) {
-        v_rho = out.find(spin ? "V_RHO_A" : "V_RHO_B")->second->pointer();
+        v_rho = points.out[spin ? FunctionalPoints::V_RHO_A : FunctionalPoints::V_RHO_B];
         if (gga_) {
-            v_gamma = out.find(spin ? "V_GAMMA_AA" : "V_GAMMA_BB")->second->pointer();
+            v_gamma = points.out[spin ? FunctionalPoints::V_GAMMA_AA : FunctionalPoints::V_GAMMA_BB];
         }
         if (meta_) {
-            v_tau = out.find(spin ? "V_TAU_A" : "V_TAU_B")->second->pointer();
+            v_tau = points.out[spin ? FunctionalPoints::V_TAU_A : FunctionalPoints::V_TAU_B];
         }
     }
      
@@ -251,7 +255,7 @@ void CFunctional::compute_ss_functional(const std::map<std::string,SharedVector>
         }
     }
 }
-void CFunctional::compute_os_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha)
+void CFunctional::compute_os_functional(const FunctionalPoints& points, int npoints, int deriv, double alpha)
 {
     if (deriv > 1) {
         throw PSIEXCEPTION("CFunctional: 2nd and higher partials not implemented yet.");
@@ -267,11 +271,11 @@ void CFunctional::compute_os_functional(const std::map<std::string,SharedVector>
     double* gamma_aap = NULL;
     double* gamma_bbp = NULL;
 
-    rho_ap = in.find("RHO_A")->second->pointer();
-    rho_bp = in.find("RHO_B")->second->pointer();
+    rho_ap = points.in[FunctionalPoints::RHO_A];
+    rho_bp = points.in[FunctionalPoints::RHO_B];
     if (gga_) {
-        gamma_aap = in.find("GAMMA_AA")->second->pointer();
-        gamma_bbp = in.find("GAMMA_BB")->second->pointer();
+        gamma_aap = points.in[FunctionalPoints::GAMMA_AA];
+        gamma_bbp = points.in[FunctionalPoints::GAMMA_BB];
     }
 
     // => Output variables <= //
@@ -282,13 +286,13 @@ void CFunctional::compute_os_functional(const std::map<std::string,SharedVector>
     double* v_gamma_aa = NULL;
     double* v_gamma_bb = NULL;
     
-    v = out.find("V")->second->pointer();
+    v = points.out[FunctionalPoints::V];
     if (deriv >= 1) {
-        v_rho_a = out.find("V_RHO_A")->second->pointer();
-        v_rho_b = out.find("V_RHO_B")->second->pointer();
+        v_rho_a = points.out[FunctionalPoints::V_RHO_A];
+        v_rho_b = points.out[FunctionalPoints::V_RHO_B];
         if (gga_) {
-            v_gamma_aa = out.find("V_GAMMA_AA")->second->pointer();
-            v_gamma_bb = out.find("V_GAMMA_BB")->second->pointer();
+            v_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA];
+            v_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB];
         }
     }
      
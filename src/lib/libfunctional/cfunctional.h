@@ -107,9 +107,10 @@ public:
     // => Computers <= //
 
     virtual void compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha);
+    virtual void compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha);
 
-    void compute_ss_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha, bool spin);
-    void compute_os_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha);
+    void compute_ss_functional(const FunctionalPoints& points, int npoints, int deriv, double alpha, bool spin);
+    void compute_os_functional(const FunctionalPoints& points, int npoints, int deriv, double alpha);
     
 
 };
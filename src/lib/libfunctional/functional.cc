@@ -20,11 +20,66 @@
  *@END LICENSE
  */
 
+#include <libmints/vector.h>
 #include "functional.h"
 #include <psi4-dec.h>
+#include <libpsi4util/libpsi4util.h>
 #include "libparallel/ParallelPrinter.h"
+#include <cmath>
 namespace psi {
 
+static const char* functional_input_names[FunctionalPoints::NINPUT] = {
+    "RHO_A", "RHO_B",
+    "GAMMA_AA", "GAMMA_AB", "GAMMA_BB",
+    "TAU_A", "TAU_B"
+};
+
+static const char* functional_output_names[FunctionalPoints::NOUTPUT] = {
+    "V",
+    "V_RHO_A", "V_RHO_B",
+    "V_GAMMA_AA", "V_GAMMA_AB", "V_GAMMA_BB",
+    "V_TAU_A", "V_TAU_B",
+    "V_RHO_A_RHO_A", "V_RHO_A_RHO_B", "V_RHO_B_RHO_B",
+    "V_GAMMA_AA_GAMMA_AA", "V_GAMMA_AA_GAMMA_AB", "V_GAMMA_AA_GAMMA_BB",
+    "V_GAMMA_AB_GAMMA_AB", "V_GAMMA_AB_GAMMA_BB", "V_GAMMA_BB_GAMMA_BB",
+    "V_TAU_A_TAU_A", "V_TAU_A_TAU_B", "V_TAU_B_TAU_B",
+    "V_RHO_A_GAMMA_AA", "V_RHO_A_GAMMA_AB", "V_RHO_A_GAMMA_BB",
+    "V_RHO_B_GAMMA_AA", "V_RHO_B_GAMMA_AB", "V_RHO_B_GAMMA_BB",
+    "V_RHO_A_TAU_A", "V_RHO_A_TAU_B", "V_RHO_B_TAU_A", "V_RHO_B_TAU_B",
+    "V_GAMMA_AA_TAU_A", "V_GAMMA_AA_TAU_B", "V_GAMMA_AB_TAU_A",
+    "V_GAMMA_AB_TAU_B", "V_GAMMA_BB_TAU_A", "V_GAMMA_BB_TAU_B"
+};
+
+FunctionalPoints::FunctionalPoints() :
+    in_map(NULL), out_map(NULL)
+{
+    for (int i = 0; i < NINPUT; i++) in[i] = NULL;
+    for (int i = 0; i < NOUTPUT; i++) out[i] = NULL;
+}
+const char* FunctionalPoints::input_name(int slot)
+{
+    return functional_input_names[slot];
+}
+const char* FunctionalPoints::output_name(int slot)
+{
+    return functional_output_names[slot];
+}
+FunctionalPoints FunctionalPoints::from_maps(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out)
+{
+    FunctionalPoints points;
+    points.in_map = &in;
+    points.out_map = &out;
+    for (int i = 0; i < NINPUT; i++) {
+        std::map<std::string,SharedVector>::const_iterator it = in.find(functional_input_names[i]);
+        if (it != in.end()) points.in[i] = (*it).second->pointer();
+    }
+    for (int i = 0; i < NOUTPUT; i++) {
+        std::map<std::string,SharedVector>::const_iterator it = out.find(functional_output_names[i]);
+        if (it != out.end()) points.out[i] = (*it).second->pointer();
+    }
+    return points;
+}
+
 Functional::Functional()
 {
     common_init();
@@ -83,5 +138,93 @@ void Functional::compute_functional(const std::map<std::string,SharedVector>& in
 {
     throw PSIEXCEPTION("Functional: pseudo-abstract class.");
 }
+void Functional::compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha)
+{
+    if (!points.in_map || !points.out_map)
+        throw PSIEXCEPTION("Functional: " + name_ + " has no map-free kernel, and points carry no maps.");
+    compute_functional(*points.in_map, *points.out_map, npoints, deriv, alpha);
+}
+
+
+void benchmark_functionals(int npoints, double min_time)
+{
+    outfile->Printf( "\n");
+    outfile->Printf( "                              ---------------------------------- \n");
+    outfile->Printf( "                              =====> FUNCTIONAL BENCHMARKS <==== \n");
+    outfile->Printf( "                              ---------------------------------- \n");
+    outfile->Printf( "\n");
+
+    outfile->Printf( "  Parameters:\n");
+    outfile->Printf( "   -Minimum runtime (per functional, per interface): %14.10f [s].\n", min_time);
+    outfile->Printf( "   -Points per call: %d.\n", npoints);
+    outfile->Printf( "\n");
+
+    outfile->Printf( "  Notes:\n");
+    outfile->Printf( "   -Rates are first-partial evaluations, in [points/s].\n");
+    outfile->Printf( "   -MAP is compute_functional (string-keyed maps), SLOT is compute_block.\n");
+    outfile->Printf( "\n");
+
+    // => Synthetic spin-polarized densities spanning the usual grid range <= //
+
+    std::map<std::string, SharedVector> in;
+    for (int i = 0; i < FunctionalPoints::NINPUT; i++) {
+        in[FunctionalPoints::input_name(i)] = SharedVector(new Vector(FunctionalPoints::input_name(i), npoints));
+    }
+    double* rho_a = in["RHO_A"]->pointer();
+    double* rho_b = in["RHO_B"]->pointer();
+    double* gamma_aa = in["GAMMA_AA"]->pointer();
+    double* gamma_ab = in["GAMMA_AB"]->pointer();
+    double* gamma_bb = in["GAMMA_BB"]->pointer();
+    double* tau_a = in["TAU_A"]->pointer();
+    double* tau_b = in["TAU_B"]->pointer();
+    for (int P = 0; P < npoints; P++) {
+        double t = (P + 0.5) / (double) npoints;
+        rho_a[P] = pow(10.0, -6.0 + 7.0 * t);
+        rho_b[P] = 0.8 * rho_a[P];
+        gamma_aa[P] = (0.1 + 2.0 * t) * pow(rho_a[P], 8.0/3.0);
+        gamma_bb[P] = (0.1 + 2.0 * t) * pow(rho_b[P], 8.0/3.0);
+        gamma_ab[P] = 0.9 * sqrt(gamma_aa[P] * gamma_bb[P]);
+        tau_a[P] = (1.0 + t) * pow(rho_a[P], 5.0/3.0);
+        tau_b[P] = (1.0 + t) * pow(rho_b[P], 5.0/3.0);
+    }
+
+    std::map<std::string, SharedVector> out;
+    for (int i = 0; i <= FunctionalPoints::V_TAU_B; i++) {
+        out[FunctionalPoints::output_name(i)] = SharedVector(new Vector(FunctionalPoints::output_name(i), npoints));
+    }
+    FunctionalPoints points = FunctionalPoints::from_maps(in, out);
+
+    std::vector<std::string> aliases;
+    aliases.push_back("B88_X");
+    aliases.push_back("PBE_X");
+    aliases.push_back("LYP_C");
+    aliases.push_back("PBE_C");
+    aliases.push_back("VWN5_C");
+    aliases.push_back("PW92_C");
+
+    outfile->Printf( "  %-8s %14s %14s %8s\n", "Name", "MAP", "SLOT", "Speedup");
+    for (size_t ind = 0; ind < aliases.size(); ind++) {
+        boost::shared_ptr<Functional> fun = Functional::build_base(aliases[ind]);
+
+        double rates[2];
+        for (int slot = 0; slot < 2; slot++) {
+            double T = 0.0;
+            unsigned long int rounds = 0L;
+            Timer qq;
+            while (T < min_time || rounds == 0L) {
+                if (slot) {
+                    fun->compute_block(points, npoints, 1, 1.0);
+                } else {
+                    fun->compute_functional(in, out, npoints, 1, 1.0);
+                }
+                T = qq.get();
+                rounds++;
+            }
+            rates[slot] = rounds * (double) npoints / T;
+        }
+        outfile->Printf( "  %-8s %14.3E %14.3E %8.2f\n", aliases[ind].c_str(), rates[0], rates[1], rates[1] / rates[0]);
+    }
+    outfile->Printf( "\n");
+}
 
 }
@@ -29,6 +29,62 @@
 
 namespace psi {
 
+/**
+ * FunctionalPoints: struct-of-arrays view of a block of points
+ *
+ * Raw per-point arrays (length >= npoints) in fixed, enum-indexed slots,
+ * so the functional kernels never touch a string-keyed map inside the
+ * grid loop. Slots that are not needed are NULL. The input slots are the
+ * PointFunctions values, the output slots mirror SuperFunctional::values().
+ *
+ * The maps the pointers were taken from (if any) are kept so functionals
+ * without a compute_block kernel can fall back to compute_functional.
+ **/
+struct FunctionalPoints {
+
+    enum Input {
+        RHO_A, RHO_B,
+        GAMMA_AA, GAMMA_AB, GAMMA_BB,
+        TAU_A, TAU_B,
+        NINPUT
+    };
+
+    enum Output {
+        V,
+        V_RHO_A, V_RHO_B,
+        V_GAMMA_AA, V_GAMMA_AB, V_GAMMA_BB,
+        V_TAU_A, V_TAU_B,
+        V_RHO_A_RHO_A, V_RHO_A_RHO_B, V_RHO_B_RHO_B,
+        V_GAMMA_AA_GAMMA_AA, V_GAMMA_AA_GAMMA_AB, V_GAMMA_AA_GAMMA_BB,
+        V_GAMMA_AB_GAMMA_AB, V_GAMMA_AB_GAMMA_BB, V_GAMMA_BB_GAMMA_BB,
+        V_TAU_A_TAU_A, V_TAU_A_TAU_B, V_TAU_B_TAU_B,
+        V_RHO_A_GAMMA_AA, V_RHO_A_GAMMA_AB, V_RHO_A_GAMMA_BB,
+        V_RHO_B_GAMMA_AA, V_RHO_B_GAMMA_AB, V_RHO_B_GAMMA_BB,
+        V_RHO_A_TAU_A, V_RHO_A_TAU_B, V_RHO_B_TAU_A, V_RHO_B_TAU_B,
+        V_GAMMA_AA_TAU_A, V_GAMMA_AA_TAU_B, V_GAMMA_AB_TAU_A,
+        V_GAMMA_AB_TAU_B, V_GAMMA_BB_TAU_A, V_GAMMA_BB_TAU_B,
+        NOUTPUT
+    };
+
+    /// Input arrays (densities, gammas, taus)
+    double* in[NINPUT];
+    /// Output arrays (functional value and partials)
+    double* out[NOUTPUT];
+
+    /// Source maps, used only by the compute_functional fallback
+    const std::map<std::string,SharedVector>* in_map;
+    const std::map<std::string,SharedVector>* out_map;
+
+    FunctionalPoints();
+
+    /// Key names of the slots, as used in the map interface
+    static const char* input_name(int slot);
+    static const char* output_name(int slot);
+
+    /// Pull the slot pointers out of map-based registers (once per block layout, not per block)
+    static FunctionalPoints from_maps(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out);
+};
+
 /** 
  * Functional: Generic Semilocal Exchange or Correlation DFA functional
  * 
@@ -88,6 +144,8 @@ public:
     // => Computers <= //
     
     virtual void compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha) = 0;
+    // Map-free entry point, accumulates into points.out. Defaults to compute_functional on points' maps.
+    virtual void compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha);
 
     // => Parameters <= //
     
@@ -130,6 +188,9 @@ public:
 
 };
 
+/// Time each hot DFA kernel through the map and the slot interfaces, and print points/s
+void benchmark_functionals(int npoints, double min_time);
+
 }
 
 #endif
@@ -291,20 +291,34 @@ void SuperFunctional::allocate()
 std::map<std::string, SharedVector>& SuperFunctional::compute_functional(const std::map<std::string, SharedVector>& vals, int npoints)
 {
     npoints = (npoints == -1 ? vals.find("RHO_A")->second->dimpi()[0] : npoints);
-    
-    for (std::map<std::string, SharedVector>::const_iterator it = values_.begin();
-        it != values_.end(); ++it) {
-        ::memset((void*)((*it).second->pointer()),'\0',sizeof(double) * npoints);
+    compute_functional(vals, values_, npoints);
+    return values_;
+}
+void SuperFunctional::compute_functional(const std::map<std::string, SharedVector>& vals, const std::map<std::string, SharedVector>& out, int npoints)
+{
+    compute_functional(FunctionalPoints::from_maps(vals, out), npoints);
+}
+void SuperFunctional::compute_functional(const FunctionalPoints& points, int npoints)
+{
+    for (int i = 0; i < FunctionalPoints::NOUTPUT; i++) {
+        if (points.out[i]) ::memset((void*)points.out[i],'\0',sizeof(double) * npoints);
     }
 
     for (int i = 0; i < x_functionals_.size(); i++) {
-        x_functionals_[i]->compute_functional(vals, values_, npoints, deriv_, (1.0 - x_alpha_));
+        x_functionals_[i]->compute_block(points, npoints, deriv_, (1.0 - x_alpha_));
     }
     for (int i = 0; i < c_functionals_.size(); i++) {
-        c_functionals_[i]->compute_functional(vals, values_, npoints, deriv_, (1.0 - c_alpha_));
+        c_functionals_[i]->compute_block(points, npoints, deriv_, (1.0 - c_alpha_));
     }
-    
-    return values_;
+}
+std::map<std::string, SharedVector> SuperFunctional::allocate_values() const
+{
+    std::map<std::string, SharedVector> vals;
+    for (std::map<std::string, SharedVector>::const_iterator it = values_.begin();
+        it != values_.end(); ++it) {
+        vals[(*it).first] = SharedVector(new Vector((*it).first,max_points_));
+    }
+    return vals;
 }
 void SuperFunctional::test_functional(SharedVector rho_a, 
                                       SharedVector rho_b,
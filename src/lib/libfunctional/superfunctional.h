@@ -31,6 +31,7 @@ namespace psi {
 
 class Options;
 class Functional;
+struct FunctionalPoints;
 class Dispersion;
 
 /** 
@@ -118,6 +119,12 @@ public:
     // => Computers <= //
     
     std::map<std::string, SharedVector>& compute_functional(const std::map<std::string, SharedVector>& vals, int npoints = -1);
+    // Compute into caller-owned registers (from allocate_values), safe to call from several threads at once
+    void compute_functional(const std::map<std::string, SharedVector>& vals, const std::map<std::string, SharedVector>& out, int npoints);
+    // Map-free version of the above: fixed slots, no string lookups (see FunctionalPoints)
+    void compute_functional(const FunctionalPoints& points, int npoints);
+    // Allocate a private set of registers shaped like values()
+    std::map<std::string, SharedVector> allocate_values() const;
     void test_functional(SharedVector rho_a, 
                          SharedVector rho_b,
                          SharedVector gamma_aa,
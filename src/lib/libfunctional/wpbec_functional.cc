@@ -77,6 +77,10 @@ void wPBECFunctional::common_init()
     }
 }
 void wPBECFunctional::compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha)
+{
+    compute_block(FunctionalPoints::from_maps(in, out), npoints, deriv, alpha);
+}
+void wPBECFunctional::compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha)
 {
     if (deriv > 1) {
         throw PSIEXCEPTION("wPBECFunctional: 2nd and higher partials not implemented yet.");
@@ -87,11 +91,11 @@ void wPBECFunctional::compute_functional(const std::map<std::string,SharedVector
 
     // => Input variables (spin-polarized) <= //
 
-    double* rho_ap = in.find("RHO_A")->second->pointer();    
-    double* rho_bp = in.find("RHO_B")->second->pointer();    
-    double* gamma_aap = in.find("GAMMA_AA")->second->pointer();    
-    double* gamma_abp = in.find("GAMMA_AB")->second->pointer();    
-    double* gamma_bbp = in.find("GAMMA_BB")->second->pointer();    
+    double* rho_ap = points.in[FunctionalPoints::RHO_A];    
+    double* rho_bp = points.in[FunctionalPoints::RHO_B];    
+    double* gamma_aap = points.in[FunctionalPoints::GAMMA_AA];    
+    double* gamma_abp = points.in[FunctionalPoints::GAMMA_AB];    
+    double* gamma_bbp = points.in[FunctionalPoints::GAMMA_BB];    
 
     // => Output variables <= //
 
@@ -102,13 +106,13 @@ void wPBECFunctional::compute_functional(const std::map<std::string,SharedVector
     double* v_gamma_ab = NULL;
     double* v_gamma_bb = NULL;
     
-    v = out.find("V")->second->pointer();
+    v = points.out[FunctionalPoints::V];
     if (deriv >=1) {
-        v_rho_a = out.find("V_RHO_A")->second->pointer();
-        v_rho_b = out.find("V_RHO_B")->second->pointer();
-        v_gamma_aa = out.find("V_GAMMA_AA")->second->pointer();
-        v_gamma_ab = out.find("V_GAMMA_AB")->second->pointer();
-        v_gamma_bb = out.find("V_GAMMA_BB")->second->pointer();
+        v_rho_a = points.out[FunctionalPoints::V_RHO_A];
+        v_rho_b = points.out[FunctionalPoints::V_RHO_B];
+        v_gamma_aa = points.out[FunctionalPoints::V_GAMMA_AA];
+        v_gamma_ab = points.out[FunctionalPoints::V_GAMMA_AB];
+        v_gamma_bb = points.out[FunctionalPoints::V_GAMMA_BB];
     }
      
     // => Main Loop over points <= //
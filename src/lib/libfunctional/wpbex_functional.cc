@@ -90,10 +90,14 @@ void wPBEXFunctional::set_parameter(const std::string& key, double val)
 }
 void wPBEXFunctional::compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha)
 {
-    compute_sigma_functional(in,out,npoints,deriv,alpha,true);
-    compute_sigma_functional(in,out,npoints,deriv,alpha,false);
+    compute_block(FunctionalPoints::from_maps(in, out), npoints, deriv, alpha);
 }
-void wPBEXFunctional::compute_sigma_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha, bool spin)
+void wPBEXFunctional::compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha)
+{
+    compute_sigma_functional(points,npoints,deriv,alpha,true);
+    compute_sigma_functional(points,npoints,deriv,alpha,false);
+}
+void wPBEXFunctional::compute_sigma_functional(const FunctionalPoints& points, int npoints, int deriv, double alpha, bool spin)
 {
     if (deriv > 1) {
         throw PSIEXCEPTION("wPBEXFunctional: 2nd and higher partials not implemented yet.");
@@ -107,8 +111,8 @@ void wPBEXFunctional::compute_sigma_functional(const std::map<std::string,Shared
     double* rho_s = NULL;
     double* gamma_s = NULL;
     double* tau_s = NULL;
-    rho_s = in.find(spin ? "RHO_A" : "RHO_B")->second->pointer();
-    gamma_s = in.find(spin ? "GAMMA_AA" : "GAMMA_BB")->second->pointer();
+    rho_s = points.in[spin ? FunctionalPoints::RHO_A : FunctionalPoints::RHO_B];
+    gamma_s = points.in[spin ? FunctionalPoints::GAMMA_AA : FunctionalPoints::GAMMA_BB];
 
     // => Output variables <= //
 
@@ -116,10 +120,10 @@ void wPBEXFunctional::compute_sigma_functional(const std::map<std::string,Shared
     double* v_rho = NULL;
     double* v_gamma = NULL;
     
-    v = out.find(spin ? "V" : "V")->second->pointer();
+    v = points.out[FunctionalPoints::V];
     if (deriv >=1) {
-        v_rho = out.find(spin ? "V_RHO_A" : "V_RHO_B")->second->pointer();
-        v_gamma = out.find(spin ? "V_GAMMA_AA" : "V_GAMMA_BB")->second->pointer();
+        v_rho = points.out[spin ? FunctionalPoints::V_RHO_A : FunctionalPoints::V_RHO_B];
+        v_gamma = points.out[spin ? FunctionalPoints::V_GAMMA_AA : FunctionalPoints::V_GAMMA_BB];
     }
      
     // => Main Loop over points <= //
@@ -83,7 +83,8 @@ public:
     // => Computers <= //
 
     virtual void compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha);
-    void compute_sigma_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha, bool spin);
+    virtual void compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha);
+    void compute_sigma_functional(const FunctionalPoints& points, int npoints, int deriv, double alpha, bool spin);
 
     void set_B88(bool B88) { B88_ = B88; }
     bool B88() const { return B88_; }
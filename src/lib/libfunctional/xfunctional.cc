@@ -24,6 +24,7 @@
 #include "xfunctional.h"
 #include "utility.h"
 #include <psi4-dec.h>
+#include <psiconfig.h>
 #include <cmath>
 
 using namespace psi;
@@ -109,10 +110,14 @@ void XFunctional::set_parameter(const std::string& key, double val)
 }
 void XFunctional::compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha)
 {
-    compute_sigma_functional(in,out,npoints,deriv,alpha,true);
-    compute_sigma_functional(in,out,npoints,deriv,alpha,false);
+    compute_block(FunctionalPoints::from_maps(in, out), npoints, deriv, alpha);
 }
-void XFunctional::compute_sigma_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha, bool spin)
+void XFunctional::compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha)
+{
+    compute_sigma_functional(points,npoints,deriv,alpha,true);
+    compute_sigma_functional(points,npoints,deriv,alpha,false);
+}
+void XFunctional::compute_sigma_functional(const FunctionalPoints& points, int npoints, int deriv, double alpha, bool spin)
 {
     if (deriv > 1) {
         throw PSIEXCEPTION("XFunctional: 2nd and higher partials not implemented yet.");
@@ -126,12 +131,12 @@ void XFunctional::compute_sigma_functional(const std::map<std::string,SharedVect
     double* rho_s = NULL;
     double* gamma_s = NULL;
     double* tau_s = NULL;
-    rho_s = in.find(spin ? "RHO_A" : "RHO_B")->second->pointer();
+    rho_s = points.in[spin ? FunctionalPoints::RHO_A : FunctionalPoints::RHO_B];
     if (gga_) {
-        gamma_s = in.find(spin ? "GAMMA_AA" : "GAMMA_BB")->second->pointer();
+        gamma_s = points.in[spin ? FunctionalPoints::GAMMA_AA : FunctionalPoints::GAMMA_BB];
     }
     if (meta_) {
-        tau_s = in.find(spin ? "TAU_A" : "TAU_B")->second->pointer();
+        tau_s = points.in[spin ? FunctionalPoints::TAU_A : FunctionalPoints::TAU_B];
     }
 
     // => Output variables <= //
@@ -141,17 +146,23 @@ void XFunctional::compute_sigma_functional(const std::map<std::string,SharedVect
     double* v_gamma = NULL;
     double* v_tau = NULL;
 
-    v = out.find(spin ? "V" : "V")->second->pointer();
+    v = points.out[FunctionalPoints::V];
     if (deriv >= 1) {
-        v_rho = out.find(spin ? "V_RHO_A" : "V_RHO_B")->second->pointer();
+        v_rho = points.out[spin ? FunctionalPoints::V_RHO_A : FunctionalPoints::V_RHO_B];
         if (gga_) {
-            v_gamma = out.find(spin ? "V_GAMMA_AA" : "V_GAMMA_BB")->second->pointer();
+            v_gamma = points.out[spin ? FunctionalPoints::V_GAMMA_AA : FunctionalPoints::V_GAMMA_BB];
         }
         if (meta_) {
-            v_tau = out.find(spin ? "V_TAU_A" : "V_TAU_B")->second->pointer();
+            v_tau = points.out[spin ? FunctionalPoints::V_TAU_A : FunctionalPoints::V_TAU_B];
         }
     }
 
+    // => Plain B88/PBE exchange goes through the straight-line kernel <= //
+    if (gga_ && !meta_ && meta_type_ == Meta_None && sr_type_ == SR_None && (gga_type_ == B88 || gga_type_ == PBE)) {
+        compute_sigma_gga(rho_s, gamma_s, v, v_rho, v_gamma, npoints, deriv, A);
+        return;
+    }
+
     // => Main Loop over points <= //
     for (int Q = 0; Q < npoints; Q++) {
 
@@ -465,4 +476,91 @@ void XFunctional::compute_sigma_functional(const std::map<std::string,SharedVect
     }
 }
 
+void XFunctional::compute_sigma_gga(const double* rho_s, const double* gamma_s, double* v, double* v_rho, double* v_gamma, int npoints, int deriv, double A)
+{
+    // Same algebra as the general loop with Fw = Fk = 1, but with no switches
+    // or early exits in the body: points below the density cutoff are
+    // evaluated at a harmless dummy point and masked to zero, so the loop
+    // can be if-converted and vectorized.
+
+    const double K0 = _K0_;
+    const double cut = lsda_cutoff_;
+    const bool b88 = (gga_type_ == B88);
+
+    const double* restrict rhop = rho_s;
+    const double* restrict gammap = gamma_s;
+    double* restrict vp = v;
+    double* restrict v_rhop = v_rho;
+    double* restrict v_gammap = v_gamma;
+
+    if (b88) {
+        const double d = _B88_d_;
+        const double a = _B88_a_;
+        for (int Q = 0; Q < npoints; Q++) {
+            double mask = (rhop[Q] < cut ? 0.0 : 1.0);
+            double rho = (rhop[Q] < cut ? 1.0 : rhop[Q]);
+            double gamma = (rhop[Q] < cut ? 1.0 : gammap[Q]);
+
+            double rho13 = pow(rho,1.0/3.0);
+            double rho43 = rho * rho13;
+            double rho73 = rho * rho * rho13;
+            double gamma12 = sqrt(gamma);
+
+            double E = - 0.5 * K0 * rho43;
+            double E_rho = -4.0/6.0 * K0 * rho13;
+
+            double s = gamma12 / rho43;
+            double s_rho = - 4.0 / 3.0 * gamma12 / rho73;
+            double s_gamma = 1.0 / 2.0 * pow(gamma,-1.0/2.0) / rho43;
+
+            double s2p1 = s * s + 1.0;
+            double s2p1_12 = sqrt(s2p1);
+            double asinhs = log(s + s2p1_12);
+            double N = 2.0 / K0 * a * d * s * s;
+            double D = 1.0 + 6.0 * d * s * asinhs;
+            double N_s = 4.0 / K0 * a * d * s;
+            double D_s = 6.0 * d * asinhs + 6.0 * d * s / s2p1_12;
+            double Fs = 1.0 + N / D;
+            double Fs_s = (N_s * D - D_s * N) / (D * D);
+
+            vp[Q] += mask * A * E * Fs;
+            if (deriv >= 1) {
+                v_rhop[Q] += mask * A * (Fs * E_rho + E * (Fs_s * s_rho));
+                v_gammap[Q] += mask * A * (E * (Fs_s * s_gamma));
+            }
+        }
+    } else {
+        const double kp = _PBE_kp_;
+        const double mu = _PBE_mu_;
+        const double kk0 = (4 * _k0_ * _k0_);
+        for (int Q = 0; Q < npoints; Q++) {
+            double mask = (rhop[Q] < cut ? 0.0 : 1.0);
+            double rho = (rhop[Q] < cut ? 1.0 : rhop[Q]);
+            double gamma = (rhop[Q] < cut ? 1.0 : gammap[Q]);
+
+            double rho13 = pow(rho,1.0/3.0);
+            double rho43 = rho * rho13;
+            double rho73 = rho * rho * rho13;
+            double gamma12 = sqrt(gamma);
+
+            double E = - 0.5 * K0 * rho43;
+            double E_rho = -4.0/6.0 * K0 * rho13;
+
+            double s = gamma12 / rho43;
+            double s_rho = - 4.0 / 3.0 * gamma12 / rho73;
+            double s_gamma = 1.0 / 2.0 * pow(gamma,-1.0/2.0) / rho43;
+
+            double mus2 = 1.0 + mu * s * s / (kk0 * kp);
+            double Fs = 1.0 + kp * (1.0 - 1.0 / mus2);
+            double Fs_s = 2.0 / (mus2 * mus2) * mu * s / kk0;
+
+            vp[Q] += mask * A * E * Fs;
+            if (deriv >= 1) {
+                v_rhop[Q] += mask * A * (Fs * E_rho + E * (Fs_s * s_rho));
+                v_gammap[Q] += mask * A * (E * (Fs_s * s_gamma));
+            }
+        }
+    }
+}
+
 }
@@ -105,8 +105,11 @@ public:
     // => Computers <= //
 
     virtual void compute_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha);
+    virtual void compute_block(const FunctionalPoints& points, int npoints, int deriv, double alpha);
 
-    void compute_sigma_functional(const std::map<std::string,SharedVector>& in, const std::map<std::string,SharedVector>& out, int npoints, int deriv, double alpha, bool spin);
+    void compute_sigma_functional(const FunctionalPoints& points, int npoints, int deriv, double alpha, bool spin);
+    // Branch-free kernel for plain B88/PBE exchange (no meta, no range separation)
+    void compute_sigma_gga(const double* rho_s, const double* gamma_s, double* v, double* v_rho, double* v_gamma, int npoints, int deriv, double A);
 };
 
 }
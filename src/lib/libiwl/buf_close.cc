@@ -47,8 +47,11 @@ void IWL::close()
         delete[](labels_);
     if (values_)
         delete[](values_);
+    if (packed_)
+        delete[](packed_);
     labels_ = NULL;
     values_ = NULL;
+    packed_ = NULL;
 }
 
 /*!
@@ -66,6 +69,7 @@ void iwl_buf_close(struct iwlbuf *Buf, int keep)
    psio_close(Buf->itap, keep ? 1 : 0);
    free(Buf->labels);
    free(Buf->values);
+   free(Buf->packed);
 }
 
 }
@@ -37,6 +37,17 @@ void IWL::fetch()
   	    bufpos_, &bufpos_);
     psio_->read(itap_, IWL_KEY_BUF, (char *) &(inbuf_), sizeof(int),
   	    bufpos_, &bufpos_);
+    if (format_ != IWL_FORMAT_PLAIN) {
+        int nbytes;
+        psio_->read(itap_, IWL_KEY_BUF, (char *) &nbytes, sizeof(int),
+            bufpos_, &bufpos_);
+        psio_->read(itap_, IWL_KEY_BUF, (char *) packed_, nbytes,
+            bufpos_, &bufpos_);
+        iwl_buf_unpack(format_, precision_, packed_, nbytes, inbuf_,
+            labels_, values_);
+        idx_ = 0;
+        return;
+    }
     psio_->read(itap_, IWL_KEY_BUF, (char *) labels_, ints_per_buf_ * 
   	    4 * sizeof(Label), bufpos_, &bufpos_);
     psio_->read(itap_, IWL_KEY_BUF, (char *) values_, ints_per_buf_ *
@@ -57,6 +68,17 @@ void iwl_buf_fetch(struct iwlbuf *Buf)
 	    Buf->bufpos, &Buf->bufpos);
   psio_read(Buf->itap, IWL_KEY_BUF, (char *) &(Buf->inbuf), sizeof(int),
 	    Buf->bufpos, &Buf->bufpos);
+  if (Buf->format != IWL_FORMAT_PLAIN) {
+    int nbytes;
+    psio_read(Buf->itap, IWL_KEY_BUF, (char *) &nbytes, sizeof(int),
+	      Buf->bufpos, &Buf->bufpos);
+    psio_read(Buf->itap, IWL_KEY_BUF, (char *) Buf->packed, nbytes,
+	      Buf->bufpos, &Buf->bufpos);
+    iwl_buf_unpack(Buf->format, Buf->precision, Buf->packed, nbytes,
+                   Buf->inbuf, Buf->labels, Buf->values);
+    Buf->idx = 0;
+    return;
+  }
   psio_read(Buf->itap, IWL_KEY_BUF, (char *) Buf->labels, Buf->ints_per_buf * 
 	    4 * sizeof(Label), Buf->bufpos, &Buf->bufpos);
   psio_read(Buf->itap, IWL_KEY_BUF, (char *) Buf->values, Buf->ints_per_buf *
@@ -45,6 +45,9 @@ IWL::IWL()
     lastbuf_ = 0;
     inbuf_ = 0;
     idx_ = 0;    
+    format_ = IWL_FORMAT_PLAIN;
+    precision_ = 0.0;
+    packed_ = NULL;
 }
 
 IWL::IWL(PSIO *psio, int it, double coff, int oldfile, int readflag):
@@ -73,6 +76,7 @@ void IWL::init(PSIO *psio, int it, double coff, int oldfile, int readflag)
     // values_ = (Value *) malloc (ints_per_buf_ * sizeof(Value));
     labels_ = new Label[4 * ints_per_buf_];
     values_ = new Value[ints_per_buf_];
+    packed_ = NULL;
 
     /*! open the output file */
     /*! Note that we assume that if oldfile isn't set, we O_CREAT the file */
@@ -83,6 +87,35 @@ void IWL::init(PSIO *psio, int it, double coff, int oldfile, int readflag)
         return;
     } 
 
+    /*! existing files keep their encoding; new ones take the default */
+    if (oldfile) {
+        format_ = IWL_FORMAT_PLAIN;
+        precision_ = 0.0;
+        if (psio_->tocscan(itap_, IWL_KEY_FMT) != NULL) {
+            psio_address next = PSIO_ZERO;
+            psio_->read(itap_, IWL_KEY_FMT, (char *) &format_, sizeof(int),
+                next, &next);
+            psio_->read(itap_, IWL_KEY_FMT, (char *) &precision_, sizeof(double),
+                next, &next);
+        }
+    }
+    else {
+        iwl_get_default_format(&format_, &precision_);
+        if (format_ == IWL_FORMAT_QUANTIZED && precision_ <= 0.0)
+            precision_ = cutoff_;
+        if (format_ == IWL_FORMAT_QUANTIZED && precision_ <= 0.0)
+            format_ = IWL_FORMAT_PACKED;
+        if (format_ != IWL_FORMAT_PLAIN) {
+            psio_address next = PSIO_ZERO;
+            psio_->write(itap_, IWL_KEY_FMT, (char *) &format_, sizeof(int),
+                next, &next);
+            psio_->write(itap_, IWL_KEY_FMT, (char *) &precision_, sizeof(double),
+                next, &next);
+        }
+    }
+    if (format_ != IWL_FORMAT_PLAIN)
+        packed_ = new unsigned char[IWL_PACKED_BYTES_PER_INT * ints_per_buf_];
+
     /*! go ahead and read a buffer */
     if (readflag) fetch();
 }
@@ -119,6 +152,9 @@ void iwl_buf_init(struct iwlbuf *Buf, int itape, double cutoff,
   Buf->lastbuf = 0;
   Buf->inbuf = 0;
   Buf->idx = 0;
+  Buf->packed = NULL;
+  Buf->format = IWL_FORMAT_PLAIN;
+  Buf->precision = 0.0;
 
   /*! make room in the buffer */
   Buf->labels = (Label *) malloc (4 * Buf->ints_per_buf * sizeof(Label));
@@ -133,6 +169,34 @@ void iwl_buf_init(struct iwlbuf *Buf, int itape, double cutoff,
     return;
   } 
 
+  /*! existing files keep their encoding; new ones take the default */
+  if (oldfile) {
+    if (psio_tocscan(Buf->itap, IWL_KEY_FMT) != NULL) {
+      psio_address next = PSIO_ZERO;
+      psio_read(Buf->itap, IWL_KEY_FMT, (char *) &(Buf->format), sizeof(int),
+		next, &next);
+      psio_read(Buf->itap, IWL_KEY_FMT, (char *) &(Buf->precision),
+		sizeof(double), next, &next);
+    }
+  }
+  else {
+    iwl_get_default_format(&(Buf->format), &(Buf->precision));
+    if (Buf->format == IWL_FORMAT_QUANTIZED && Buf->precision <= 0.0)
+      Buf->precision = Buf->cutoff;
+    if (Buf->format == IWL_FORMAT_QUANTIZED && Buf->precision <= 0.0)
+      Buf->format = IWL_FORMAT_PACKED;
+    if (Buf->format != IWL_FORMAT_PLAIN) {
+      psio_address next = PSIO_ZERO;
+      psio_write(Buf->itap, IWL_KEY_FMT, (char *) &(Buf->format), sizeof(int),
+		 next, &next);
+      psio_write(Buf->itap, IWL_KEY_FMT, (char *) &(Buf->precision),
+		 sizeof(double), next, &next);
+    }
+  }
+  if (Buf->format != IWL_FORMAT_PLAIN)
+    Buf->packed = (unsigned char *) malloc(IWL_PACKED_BYTES_PER_INT *
+                                           Buf->ints_per_buf);
+
   /*! go ahead and read a buffer */
   if (readflag) iwl_buf_fetch(Buf);
   
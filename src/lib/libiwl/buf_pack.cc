@@ -0,0 +1,217 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+/*!
+  \file
+  \ingroup IWL
+*/
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <stdint.h>
+#include <libpsio/psio.h>
+#include "iwl.h"
+#include "iwl.hpp"
+
+namespace psi {
+
+/* Encoding for newly created IWL files */
+static int default_format = IWL_FORMAT_PLAIN;
+static double default_precision = 0.0;
+
+/* Tag values in the low nibble of each integral's leading byte */
+#define IWL_TAG_QUANTIZED 14
+
+void IWL::set_default_format(int format, double precision)
+{
+    iwl_set_default_format(format, precision);
+}
+
+/*!
+** iwl_set_default_format()
+**
+**	\param format    IWL_FORMAT_PLAIN, IWL_FORMAT_PACKED or IWL_FORMAT_QUANTIZED
+**	\param precision Absolute value step for IWL_FORMAT_QUANTIZED;
+**	                 zero uses each file's cutoff
+**
+** Select the buffer encoding for IWL files created from now on.
+** Existing files are always read back in the format they were written.
+** \ingroup IWL
+*/
+void iwl_set_default_format(int format, double precision)
+{
+  default_format = format;
+  default_precision = precision;
+}
+
+void iwl_get_default_format(int *format, double *precision)
+{
+  *format = default_format;
+  *precision = default_precision;
+}
+
+static inline unsigned char *put_varint(unsigned char *p, uint64_t v)
+{
+  while (v >= 0x80) {
+    *p++ = (unsigned char) (v | 0x80);
+    v >>= 7;
+  }
+  *p++ = (unsigned char) v;
+  return p;
+}
+
+static inline const unsigned char *get_varint(const unsigned char *p, uint64_t *v)
+{
+  uint64_t result = 0;
+  int shift = 0;
+  while (*p & 0x80) {
+    result |= (uint64_t) (*p++ & 0x7f) << shift;
+    shift += 7;
+  }
+  result |= (uint64_t) (*p++) << shift;
+  *v = result;
+  return p;
+}
+
+static inline uint64_t zigzag(int64_t v)
+{
+  return ((uint64_t) v << 1) ^ (uint64_t) (v >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t v)
+{
+  return (int64_t) (v >> 1) ^ -(int64_t) (v & 1);
+}
+
+/*!
+** iwl_buf_pack()
+**
+** Encode n integrals for the PACKED or QUANTIZED formats and return the
+** number of bytes written to packed, which must hold at least
+** n*IWL_PACKED_BYTES_PER_INT bytes.
+**
+** Each integral starts with a tag byte.  Its high nibble flags which of
+** p, q, r, s differ from the previous integral; each changed label
+** follows as a zigzag varint delta, so streams written in sorted order
+** cost little more than the tag.  The low nibble describes the value:
+** 0-8 is the number of leading zero bytes in the XOR of its bit pattern
+** with the previous value, followed by the remaining bytes (lossless);
+** IWL_TAG_QUANTIZED is a zigzag varint count of precision steps.
+** Integral order is preserved; every buffer decodes on its own.
+** \ingroup IWL
+*/
+int iwl_buf_pack(int format, double precision, const Label *labels,
+      const Value *values, int n, unsigned char *packed)
+{
+  unsigned char *p = packed;
+  int prev[4] = {0, 0, 0, 0};
+  uint64_t prevbits = 0;
+  bool quantize = (format == IWL_FORMAT_QUANTIZED) && (precision > 0.0);
+
+  for (int i=0; i<n; i++) {
+    const Label *lbl = &labels[4*i];
+    unsigned char *tag = p++;
+    int mask = 0;
+
+    for (int k=0; k<4; k++) {
+      if (lbl[k] != prev[k]) {
+        mask |= (1 << k);
+        p = put_varint(p, zigzag((int64_t) lbl[k] - prev[k]));
+        prev[k] = lbl[k];
+      }
+    }
+
+    double value = values[i];
+    double steps = value / precision;
+    uint64_t bits;
+
+    if (quantize && std::fabs(steps) < 4.0e18) {
+      int64_t q = (int64_t) llround(steps);
+      p = put_varint(p, zigzag(q));
+      value = q * precision;
+      *tag = (unsigned char) ((mask << 4) | IWL_TAG_QUANTIZED);
+      memcpy(&bits, &value, sizeof(double));
+    }
+    else {
+      memcpy(&bits, &value, sizeof(double));
+      uint64_t x = bits ^ prevbits;
+      int nzero = 0;
+      while (nzero < 8 && !(x >> (56 - 8*nzero) & 0xff)) nzero++;
+      for (int b=nzero; b<8; b++)
+        *p++ = (unsigned char) (x >> (56 - 8*b));
+      *tag = (unsigned char) ((mask << 4) | nzero);
+    }
+    prevbits = bits;
+  }
+
+  return (int) (p - packed);
+}
+
+/*!
+** iwl_buf_unpack()
+**
+** Decode n integrals written by iwl_buf_pack() from nbytes of packed.
+** Quantized value tags are only honoured in IWL_FORMAT_QUANTIZED files;
+** in PACKED files every value is an XOR-encoded bit pattern.
+** \ingroup IWL
+*/
+void iwl_buf_unpack(int format, double precision, const unsigned char *packed,
+      int nbytes, int n, Label *labels, Value *values)
+{
+  const unsigned char *p = packed;
+  const unsigned char *end = packed + nbytes;
+  int prev[4] = {0, 0, 0, 0};
+  uint64_t prevbits = 0;
+  bool quantized = (format == IWL_FORMAT_QUANTIZED);
+
+  for (int i=0; i<n && p<end; i++) {
+    int tag = *p++;
+    int mask = tag >> 4;
+    int kind = tag & 0xf;
+    Label *lbl = &labels[4*i];
+    uint64_t v;
+
+    for (int k=0; k<4; k++) {
+      if (mask & (1 << k)) {
+        p = get_varint(p, &v);
+        prev[k] += (int) unzigzag(v);
+      }
+      lbl[k] = (Label) prev[k];
+    }
+
+    double value;
+    if (quantized && kind == IWL_TAG_QUANTIZED) {
+      p = get_varint(p, &v);
+      value = unzigzag(v) * precision;
+      memcpy(&prevbits, &value, sizeof(double));
+    }
+    else {
+      uint64_t x = 0;
+      for (int b=kind; b<8; b++)
+        x |= (uint64_t) (*p++) << (56 - 8*b);
+      prevbits ^= x;
+      memcpy(&value, &prevbits, sizeof(double));
+    }
+    values[i] = value;
+  }
+}
+
+}
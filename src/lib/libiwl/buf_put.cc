@@ -37,6 +37,15 @@ void IWL::put()
         bufpos_, &(bufpos_));
     psio_->write(itap_, IWL_KEY_BUF, (char *) &(inbuf_), sizeof(int),
         bufpos_, &(bufpos_));
+    if (format_ != IWL_FORMAT_PLAIN) {
+        int nbytes = iwl_buf_pack(format_, precision_, labels_, values_,
+            inbuf_, packed_);
+        psio_->write(itap_, IWL_KEY_BUF, (char *) &nbytes, sizeof(int),
+            bufpos_, &(bufpos_));
+        psio_->write(itap_, IWL_KEY_BUF, (char *) packed_, nbytes,
+            bufpos_, &(bufpos_));
+        return;
+    }
     psio_->write(itap_, IWL_KEY_BUF, (char *) labels_, ints_per_buf_ * 
         4 * sizeof(Label), bufpos_, &(bufpos_));
     psio_->write(itap_, IWL_KEY_BUF, (char *) values_, ints_per_buf_ *
@@ -56,6 +65,15 @@ void iwl_buf_put(struct iwlbuf *Buf)
 	     Buf->bufpos, &(Buf->bufpos));
   psio_write(Buf->itap, IWL_KEY_BUF, (char *) &(Buf->inbuf), sizeof(int),
 	     Buf->bufpos, &(Buf->bufpos));
+  if (Buf->format != IWL_FORMAT_PLAIN) {
+    int nbytes = iwl_buf_pack(Buf->format, Buf->precision, Buf->labels,
+                              Buf->values, Buf->inbuf, Buf->packed);
+    psio_write(Buf->itap, IWL_KEY_BUF, (char *) &nbytes, sizeof(int),
+	       Buf->bufpos, &(Buf->bufpos));
+    psio_write(Buf->itap, IWL_KEY_BUF, (char *) Buf->packed, nbytes,
+	       Buf->bufpos, &(Buf->bufpos));
+    return;
+  }
   psio_write(Buf->itap, IWL_KEY_BUF, (char *) Buf->labels, Buf->ints_per_buf * 
 	     4 * sizeof(Label), Buf->bufpos, &(Buf->bufpos));
   psio_write(Buf->itap, IWL_KEY_BUF, (char *) Buf->values, Buf->ints_per_buf *
@@ -30,9 +30,23 @@ typedef double Value;
 
 #define IWL_KEY_BUF "IWL Buffers"
 #define IWL_KEY_ONEL "IWL One-electron matrix elements"
+#define IWL_KEY_FMT "IWL Buffer Format"
 
 #define IWL_INTS_PER_BUF 2980
 
+/* Buffer encodings.  PLAIN is the fixed-size record of labels and
+   doubles.  PACKED delta-encodes the labels and XOR-compresses the
+   values losslessly; QUANTIZED stores the values as integer multiples
+   of a fixed absolute precision.  Non-PLAIN files record their format
+   under IWL_KEY_FMT. */
+#define IWL_FORMAT_PLAIN 0
+#define IWL_FORMAT_PACKED 1
+#define IWL_FORMAT_QUANTIZED 2
+
+/* Upper bound on the encoded size of one integral: a tag byte, four
+   label deltas of at most three bytes and a ten-byte varint value */
+#define IWL_PACKED_BYTES_PER_INT 23
+
 }
 
 #endif
@@ -49,8 +49,18 @@ struct iwlbuf {
   int idx;                    /* index of integral in current buffer */
   Label *labels;              /* pointer to where integral values begin */
   Value *values;              /* integral values */
+  int format;                 /* buffer encoding, IWL_FORMAT_* */
+  double precision;           /* value step for IWL_FORMAT_QUANTIZED */
+  unsigned char *packed;      /* scratch for encoded buffers */
 };
 
+void iwl_set_default_format(int format, double precision);
+void iwl_get_default_format(int *format, double *precision);
+int iwl_buf_pack(int format, double precision, const Label *labels,
+      const Value *values, int n, unsigned char *packed);
+void iwl_buf_unpack(int format, double precision, const unsigned char *packed,
+      int nbytes, int n, Label *labels, Value *values);
+
 
 void iwl_buf_fetch(struct iwlbuf *Buf);
 void iwl_buf_put(struct iwlbuf *Buf);
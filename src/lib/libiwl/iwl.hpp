@@ -18,6 +18,9 @@ namespace psi {
         int idx_;                    /* index of integral in current buffer */
         Label *labels_;              /* pointer to where integral values begin */
         Value *values_;              /* integral values */
+        int format_;                 /* buffer encoding, IWL_FORMAT_* */
+        double precision_;           /* value step for IWL_FORMAT_QUANTIZED */
+        unsigned char *packed_;      /* scratch for encoded buffers */
         /*! Instance of libpsio to use */
         PSIO *psio_;
         /*! Flag indicating whether to keep the IWL file or not */
@@ -41,6 +44,12 @@ namespace psi {
         Label* labels()                     { return labels_; }
         Value* values()                     { return values_; }
         bool& keep()                        { return keep_; }
+        int format() const                  { return format_; }
+        double precision() const            { return precision_; }
+
+        /*! Encoding used for IWL files created from now on; a precision
+            of zero quantizes to each file's cutoff */
+        static void set_default_format(int format, double precision);
         
         void init(PSIO *psio, int itap, double cutoff, int oldfile, int readflag);
         
@@ -25,6 +25,7 @@
 #include <libpsi4util/libpsi4util.h>
 #include <libpsio/psio.hpp>
 #include <libpsio/psio.h>
+#include <libpsio/aiohandler.h>
 #include "mints.h"
 #include <cmath>
 #include <cstdlib>
@@ -1315,34 +1316,8 @@ void benchmark_blas3(int N, double min_time, int max_threads)
 
 
 }
-void benchmark_disk(int N, double min_time)
+static std::map<std::string, std::vector<double> > benchmark_disk_path(int N, double min_time)
 {
-    outfile->Printf( "\n");
-    outfile->Printf( "                              ------------------------------ \n");
-    outfile->Printf( "                              ======> PSIO BENCHMARKS <===== \n");
-    outfile->Printf( "                              ------------------------------ \n");
-    outfile->Printf( "\n");
-
-    outfile->Printf( "  Parameters:\n");
-    outfile->Printf( "   -Minimum runtime (per operation, per size): %14.10f [s].\n", min_time);
-    outfile->Printf( "   -Maximum dimension exponent N: %d. Arrays are D x D = 2^N x 2^N doubles in size. The D\n", N);
-    outfile->Printf( "        value is reported below\n");
-    outfile->Printf( "\n");
-
-    outfile->Printf( "  Operations:\n");
-    outfile->Printf( "   -OPEN/CLOSE: Open and close a file repeatedly witout discard (Data rates are meaningless).\n");
-    outfile->Printf( "   -ZERO: Write the first pass of data, expanding the file. Performed in one op. Timing may\n");
-    outfile->Printf( "        be inaccurate, as only one pass is performed.\n");
-    outfile->Printf( "   -READ (Continuous): Repeatedly read the entire array in one operation of dimension N x N.\n");
-    outfile->Printf( "   -READ (Blocked): Repeatedly read the entire array in N operations of dimension N.\n");
-    outfile->Printf( "   -READ (Transposed): Repeatedly read the entire array in N operations of dimension N. Arrays\n");
-    outfile->Printf( "        are staggered to simulate reading the N/2 blocked transpose of the array.\n");
-    outfile->Printf( "   -WRITE (Continuous): Repeatedly write the entire array in one operation of dimension N x N.\n");
-    outfile->Printf( "   -WRITE (Blocked): Repeatedly write the entire array in N operations of dimension N.\n");
-    outfile->Printf( "   -WRITE (Transposed): Repeatedly write the entire array in N operations of dimension N. Arrays\n");
-    outfile->Printf( "        are staggered to simulate writing the N/2 blocked transpose of the array.\n");
-    outfile->Printf( "\n");
-
     double T;
     unsigned long int rounds;
     double t;
@@ -1555,8 +1530,272 @@ void benchmark_disk(int N, double min_time)
     }
     outfile->Printf( "\n");
 
+    return timings;
+}
+/*
+ * Write two entries in one transfer path and read them back in another.
+ * The first entry is small, so the second starts inside a block, and the
+ * second is PSIO_DIRECT_MIN plus an odd number of bytes, so it is sent
+ * through O_DIRECT under PSIO_RW_DIRECT and the file ends inside a block:
+ * reads of its last block come up short and writes must keep the bytes
+ * around it. The second entry is rewritten in the read path and checked
+ * once more. Returns the number of bytes that did not round-trip.
+ */
+static unsigned long int benchmark_disk_roundtrip(int write_mode, int read_mode)
+{
+    boost::shared_ptr<PSIO> psio_ = PSIO::shared_object();
+    const ULI head_size = 1000;
+    const ULI tail_size = PSIO_DIRECT_MIN + 1234;
+    std::vector<char> head(head_size), tail(tail_size), buf(tail_size);
+    for (ULI i = 0; i < head_size; i++) head[i] = (char) (i * 7 + 1);
+    for (ULI i = 0; i < tail_size; i++) tail[i] = (char) (i * 131 + 5);
+
+    unsigned long int bad = 0;
+    PSIO::set_rw_mode(write_mode);
+    psio_->open(0, PSIO_OPEN_NEW);
+    psio_->write_entry(0, "BENCH_HEAD", &head[0], head_size);
+    psio_->write_entry(0, "BENCH_TAIL", &tail[0], tail_size);
+    psio_->close(0, 1);
+
+    PSIO::set_rw_mode(read_mode);
+    psio_->open(0, PSIO_OPEN_OLD);
+    psio_->read_entry(0, "BENCH_TAIL", &buf[0], tail_size);
+    for (ULI i = 0; i < tail_size; i++) bad += (buf[i] != tail[i]);
+    for (ULI i = 0; i < tail_size; i++) tail[i] = (char) (i * 17 + 3);
+    psio_->write_entry(0, "BENCH_TAIL", &tail[0], tail_size);
+    psio_->close(0, 1);
+
+    PSIO::set_rw_mode(write_mode);
+    psio_->open(0, PSIO_OPEN_OLD);
+    psio_->read_entry(0, "BENCH_HEAD", &buf[0], head_size);
+    for (ULI i = 0; i < head_size; i++) bad += (buf[i] != head[i]);
+    psio_->read_entry(0, "BENCH_TAIL", &buf[0], tail_size);
+    for (ULI i = 0; i < tail_size; i++) bad += (buf[i] != tail[i]);
+    psio_->close(0, 0);
+
+    return bad;
+}
+
+unsigned long int benchmark_disk(int N, double min_time)
+{
+    outfile->Printf( "\n");
+    outfile->Printf( "                              ------------------------------ \n");
+    outfile->Printf( "                              ======> PSIO BENCHMARKS <===== \n");
+    outfile->Printf( "                              ------------------------------ \n");
+    outfile->Printf( "\n");
+
+    outfile->Printf( "  Parameters:\n");
+    outfile->Printf( "   -Minimum runtime (per operation, per size): %14.10f [s].\n", min_time);
+    outfile->Printf( "   -Maximum dimension exponent N: %d. Arrays are D x D = 2^N x 2^N doubles in size. The D\n", N);
+    outfile->Printf( "        value is reported below\n");
+    outfile->Printf( "\n");
+
+    outfile->Printf( "  Operations:\n");
+    outfile->Printf( "   -OPEN/CLOSE: Open and close a file repeatedly witout discard (Data rates are meaningless).\n");
+    outfile->Printf( "   -ZERO: Write the first pass of data, expanding the file. Performed in one op. Timing may\n");
+    outfile->Printf( "        be inaccurate, as only one pass is performed.\n");
+    outfile->Printf( "   -READ (Continuous): Repeatedly read the entire array in one operation of dimension N x N.\n");
+    outfile->Printf( "   -READ (Blocked): Repeatedly read the entire array in N operations of dimension N.\n");
+    outfile->Printf( "   -READ (Transposed): Repeatedly read the entire array in N operations of dimension N. Arrays\n");
+    outfile->Printf( "        are staggered to simulate reading the N/2 blocked transpose of the array.\n");
+    outfile->Printf( "   -WRITE (Continuous): Repeatedly write the entire array in one operation of dimension N x N.\n");
+    outfile->Printf( "   -WRITE (Blocked): Repeatedly write the entire array in N operations of dimension N.\n");
+    outfile->Printf( "   -WRITE (Transposed): Repeatedly write the entire array in N operations of dimension N. Arrays\n");
+    outfile->Printf( "        are staggered to simulate writing the N/2 blocked transpose of the array.\n");
+    outfile->Printf( "\n");
+
+    outfile->Printf( "  Transfer Paths (PSIO::rw):\n");
+    outfile->Printf( "   -SEEK: lseek, then one read/write per %d byte page (the original path).\n", PSIO_PAGELEN);
+    outfile->Printf( "   -POSITIONAL: one pread/pwrite (vectored across pages) per volume.\n");
+    outfile->Printf( "   -DIRECT: as POSITIONAL, requests of %d bytes or more through O_DIRECT.\n", PSIO_DIRECT_MIN);
+    outfile->Printf( "\n");
+
+    const int modes[] = {PSIO_RW_SEEK, PSIO_RW_POSITIONAL, PSIO_RW_DIRECT};
+    const char* mode_names[] = {"SEEK", "POSITIONAL", "DIRECT"};
+    int nmodes = 3;
+    int old_mode = PSIO::get_rw_mode();
+
+    std::vector<std::map<std::string, std::vector<double> > > mode_timings;
+    for (int m = 0; m < nmodes; m++) {
+        PSIO::set_rw_mode(modes[m]);
+        outfile->Printf( "  ==> Transfer Path: %s <==\n\n", mode_names[m]);
+        mode_timings.push_back(benchmark_disk_path(N, min_time));
+    }
+    PSIO::set_rw_mode(old_mode);
+
+    std::vector<std::string> ops;
+    ops.push_back("READ (Continuous)");
+    ops.push_back("READ (Blocked)");
+    ops.push_back("WRITE (Continuous)");
+    ops.push_back("WRITE (Blocked)");
+
+    outfile->Printf( "PSIO Transfer Path Comparison [GiB/s]\n\n");
+    int dim = 1;
+    outfile->Printf( "Operation           Path        ");
+    for (int k = 0; k < N; k++) {
+        dim *= 2;
+        outfile->Printf( "  %9d", dim);
+    }
+    outfile->Printf( "\n");
+    for (size_t s = 0; s < ops.size(); s++) {
+        for (int m = 0; m < nmodes; m++) {
+            outfile->Printf( "%-20s%-12s", ops[s].c_str(), mode_names[m]);
+            dim = 1;
+            for (int k = 0; k < N; k++) {
+                dim *= 2;
+                unsigned long int full_dim = dim * (unsigned long int) dim;
+                outfile->Printf( "  %9.3E", 8.0E-9 *full_dim / mode_timings[m][ops[s]][k]);
+            }
+            outfile->Printf( "\n");
+        }
+    }
+    outfile->Printf( "\n");
+
+    outfile->Printf( "PSIO Transfer Path Round Trip [bytes wrong]\n\n");
+    outfile->Printf( "Write Path  ");
+    for (int r = 0; r < nmodes; r++)
+        outfile->Printf( "  %10s", mode_names[r]);
+    outfile->Printf( "\n");
+    unsigned long int bad = 0;
+    for (int w = 0; w < nmodes; w++) {
+        outfile->Printf( "%-12s", mode_names[w]);
+        for (int r = 0; r < nmodes; r++) {
+            unsigned long int wrong = benchmark_disk_roundtrip(modes[w], modes[r]);
+            outfile->Printf( "  %10lu", wrong);
+            bad += wrong;
+        }
+        outfile->Printf( "\n");
+    }
+    PSIO::set_rw_mode(old_mode);
+    outfile->Printf( "\n");
+
+    return bad;
+}
+
+unsigned long int benchmark_aio(int N, int nblocks)
+{
+    outfile->Printf( "\n");
+    outfile->Printf( "                              ------------------------------ \n");
+    outfile->Printf( "                              ======> AIO BENCHMARKS <====== \n");
+    outfile->Printf( "                              ------------------------------ \n");
+    outfile->Printf( "\n");
+
+    outfile->Printf( "  Parameters:\n");
+    outfile->Printf( "   -Two entries of %d blocks of 2^%d x 2^%d doubles each.\n", nblocks, N, N);
+    outfile->Printf( "\n");
+
+    outfile->Printf( "  Operations:\n");
+    outfile->Printf( "   -SERIAL: one worker, one block of each entry in flight, synchronize() after each pair.\n");
+    outfile->Printf( "   -POOL: four workers, every block in flight, wait() on each block as it is used.\n");
+    outfile->Printf( "   -ORDER: a write queued before a read of the same entry must land first.\n");
+    outfile->Printf( "   -ERRORS: a read of a missing entry must fail in wait() and in synchronize(), once.\n");
+    outfile->Printf( "\n");
+
+    boost::shared_ptr<PSIO> psio_ = PSIO::shared_object();
+    unsigned long int dim = 1UL << N;
+    unsigned long int block = dim * dim;
+    ULI block_size = block * sizeof(double);
+    const char* keys[] = {"AIO A Data", "AIO B Data"};
+
+    std::vector<double> ref(2 * nblocks * block);
+    for (size_t i = 0; i < ref.size(); i++) ref[i] = (double) i;
+
+    psio_->open(0, PSIO_OPEN_NEW);
+    for (int e = 0; e < 2; e++) {
+        psio_address next = PSIO_ZERO;
+        for (int b = 0; b < nblocks; b++)
+            psio_->write(0, keys[e], (char*) &ref[(e * nblocks + b) * block], block_size, next, &next);
+    }
+
+    unsigned long int bad = 0;
+    std::vector<double> buf(2 * nblocks * block);
+    Timer* qq;
+
+    // SERIAL
+    std::fill(buf.begin(), buf.end(), 0.0);
+    qq = new Timer();
+    {
+        AIOHandler aio(psio_, 1);
+        psio_address next[2] = {PSIO_ZERO, PSIO_ZERO};
+        for (int b = 0; b < nblocks; b++) {
+            for (int e = 0; e < 2; e++)
+                aio.read(0, keys[e], (char*) &buf[(e * nblocks + b) * block], block_size, next[e], &next[e]);
+            aio.synchronize();
+        }
+    }
+    double t_serial = qq->get();
+    delete qq;
+    for (size_t i = 0; i < buf.size(); i++) bad += (buf[i] != ref[i]);
+
+    // POOL
+    std::fill(buf.begin(), buf.end(), 0.0);
+    qq = new Timer();
+    {
+        AIOHandler aio(psio_, 4, 2 * nblocks);
+        std::vector<SharedAIORequest> reqs;
+        for (int e = 0; e < 2; e++) {
+            for (int b = 0; b < nblocks; b++) {
+                psio_address start = psio_get_address(PSIO_ZERO, b * block_size);
+                psio_address end;
+                reqs.push_back(aio.read(0, keys[e], (char*) &buf[(e * nblocks + b) * block], block_size, start, &end));
+            }
+        }
+        for (size_t r = 0; r < reqs.size(); r++)
+            reqs[r]->wait();
+    }
+    double t_pool = qq->get();
+    delete qq;
+    for (size_t i = 0; i < buf.size(); i++) bad += (buf[i] != ref[i]);
+
+    // ORDER
+    {
+        AIOHandler aio(psio_, 4);
+        std::vector<double> data(block, -1.0);
+        std::vector<double> back(block, 0.0);
+        psio_address end;
+        aio.write(0, keys[1], (char*) &data[0], block_size, PSIO_ZERO, &end);
+        SharedAIORequest req = aio.read(0, keys[1], (char*) &back[0], block_size, PSIO_ZERO, &end);
+        req->wait();
+        for (unsigned long int i = 0; i < block; i++) bad += (back[i] != data[i]);
+    }
+
+    // ERRORS
+    int errors_ok = 0;
+    {
+        AIOHandler aio(psio_, 2);
+        psio_address end;
+        SharedAIORequest req = aio.read(0, "AIO Missing Data", (char*) &buf[0], block_size, PSIO_ZERO, &end);
+        try {
+            req->wait();
+        } catch (PsiException& e) {
+            errors_ok++;
+        }
+        try {
+            aio.synchronize();
+        } catch (PsiException& e) {
+            errors_ok++;
+        }
+        // The error is reported once
+        try {
+            aio.synchronize();
+            errors_ok++;
+        } catch (PsiException& e) {
+        }
+    }
+
+    psio_->close(0, 0);
 
+    outfile->Printf( "  Operation        Time [s]\n");
+    outfile->Printf( "  SERIAL     %14.6f\n", t_serial);
+    outfile->Printf( "  POOL       %14.6f\n", t_pool);
+    outfile->Printf( "\n");
+    outfile->Printf( "  Values wrong: %lu\n", bad);
+    outfile->Printf( "  Error checks passed: %d of 3\n", errors_ok);
+    outfile->Printf( "\n");
+
+    return bad + (3 - errors_ok);
 }
+
 void benchmark_math(double min_time)
 {
     double T;
@@ -2259,6 +2498,152 @@ void benchmark_math(double min_time)
     outfile->Printf( "\n");
 
 }
+double benchmark_boys(int max_J, double min_time)
+{
+    double T;
+    unsigned long int rounds;
+    double t;
+    Timer* qq;
+
+    // T spread evenly (golden-ratio sequence) over the table and the asymptotic tail
+    const int nT = 1024;
+    std::vector<double> Ts(nT);
+    for (int i = 0; i < nT; i++) {
+        double x = i * 0.6180339887498949;
+        Ts[i] = 80.0 * (x - floor(x));
+    }
+    std::vector<double> F(nT * (max_J + 1L));
+    std::vector<double> R(max_J + 1);
+
+    Taylor_Fjt taylor(max_J, 1e-15);
+    FJT fjt(max_J);
+    const Tabulated_Fjt& table = Tabulated_Fjt::shared();
+
+    std::vector<std::string> methods;
+    methods.push_back("Taylor_Fjt");
+    methods.push_back("FJT");
+    methods.push_back("Tabulated");
+    methods.push_back("Tabulated Batch");
+
+    std::map<std::string, std::vector<double> > timings;
+    std::map<std::string, std::vector<double> > errors;
+    for (size_t m = 0; m < methods.size(); m++) {
+        timings[methods[m]].resize(max_J + 1);
+        errors[methods[m]].resize(max_J + 1);
+    }
+
+    for (int J = 0; J <= max_J; J++) {
+        for (size_t m = 0; m < methods.size(); m++) {
+            std::string method = methods[m];
+            T = 0.0;
+            rounds = 0L;
+            qq = new Timer();
+            while (T < min_time) {
+                if (method == "Taylor_Fjt") {
+                    for (int i = 0; i < nT; i++)
+                        C_DCOPY(J + 1, taylor.values(J, Ts[i]), 1, &F[i * (J + 1L)], 1);
+                } else if (method == "FJT") {
+                    for (int i = 0; i < nT; i++)
+                        C_DCOPY(J + 1, fjt.values(J, Ts[i]), 1, &F[i * (J + 1L)], 1);
+                } else if (method == "Tabulated") {
+                    for (int i = 0; i < nT; i++)
+                        table.evaluate(J, 1, &Ts[i], &F[i * (J + 1L)]);
+                } else {
+                    table.evaluate(J, nT, &Ts[0], &F[0]);
+                }
+                T = qq->get();
+                rounds++;
+            }
+            delete qq;
+            t = T / (double) (rounds * nT);
+            timings[method][J] = t;
+
+            // Largest relative error against the series
+            double err = 0.0;
+            for (int i = 0; i < nT; i++) {
+                Tabulated_Fjt::series(J, Ts[i], &R[0]);
+                for (int j = 0; j <= J; j++) {
+                    double e = fabs(F[i * (J + 1L) + j] - R[j]) / R[j];
+                    err = (err > e ? err : e);
+                }
+            }
+            errors[method][J] = err;
+        }
+    }
+
+    outfile->Printf( "\n");
+    outfile->Printf( "                              ----------------------------------- \n");
+    outfile->Printf( "                              ======> BOYS FUNCTION BENCHMARKS <= \n");
+    outfile->Printf( "                              ----------------------------------- \n");
+    outfile->Printf( "\n");
+
+    outfile->Printf( "  Parameters:\n");
+    outfile->Printf( "   -Maximum J %d\n", max_J);
+    outfile->Printf( "   -Minimum runtime (per method, per J): %14.10f [s].\n", min_time);
+    outfile->Printf( "\n");
+
+    outfile->Printf( "  Notes:\n");
+    outfile->Printf( "    -Each call forms F_0(T) ... F_J(T), for %d values of T in [0, 80).\n", nT);
+    outfile->Printf( "    -Timings are reported per value of T.\n");
+    outfile->Printf( "    -Tabulated Batch evaluates all T in one call, Tabulated one T per call.\n");
+    outfile->Printf( "    -Errors are the largest relative deviation from the series expansion.\n");
+    outfile->Printf( "\n");
+
+    for (size_t m = 0; m < methods.size(); m++) {
+        std::string method = methods[m];
+        outfile->Printf( "  Method: %s\n\n", method.c_str());
+
+        outfile->Printf( "%-4s%15s  %11s    %11s\n", "J", "T [s]", "1/T [Hz]", "Max Error");
+        for (int J = 0; J <= max_J; J++) {
+            t = timings[method][J];
+            outfile->Printf( "%-4d    %9.3E    %9.3E    %9.3E\n", J, t, 1.0 / t, errors[method][J]);
+        }
+        outfile->Printf("\n");
+    }
+
+    // Batched evaluation must reproduce one T per call, for the table and
+    // for the erf-attenuated fundamentals built on it
+    ErfFundamental erf(0.4, max_J);
+    ErfComplementFundamental erfc(0.4, max_J);
+    erf.set_rho(1.3);
+    erfc.set_rho(1.3);
+    std::vector<Fjt*> fundamentals;
+    std::vector<std::string> names;
+    fundamentals.push_back(const_cast<Tabulated_Fjt*>(&table));
+    names.push_back("Tabulated");
+    fundamentals.push_back(&erf);
+    names.push_back("Erf");
+    fundamentals.push_back(&erfc);
+    names.push_back("Erf Complement");
+
+    outfile->Printf( "  Batched vs. one T per call (largest absolute difference):\n\n");
+    outfile->Printf( "%-4s", "J");
+    for (size_t m = 0; m < names.size(); m++)
+        outfile->Printf( "  %14s", names[m].c_str());
+    outfile->Printf( "\n");
+
+    double max_diff = 0.0;
+    for (int J = 0; J <= max_J; J++) {
+        outfile->Printf( "%-4d", J);
+        for (size_t m = 0; m < fundamentals.size(); m++) {
+            fundamentals[m]->values_batch(J, nT, &Ts[0], &F[0]);
+            double diff = 0.0;
+            for (int i = 0; i < nT; i++) {
+                double* V = fundamentals[m]->values(J, Ts[i]);
+                for (int j = 0; j <= J; j++) {
+                    double d = fabs(F[i * (J + 1L) + j] - V[j]);
+                    diff = (diff > d ? diff : d);
+                }
+            }
+            max_diff = (max_diff > diff ? max_diff : diff);
+            outfile->Printf( "  %14.3E", diff);
+        }
+        outfile->Printf( "\n");
+    }
+    outfile->Printf("\n");
+
+    return max_diff;
+}
 void benchmark_integrals(int max_am, double min_time)
 {
     double T;
@@ -58,8 +58,20 @@ void benchmark_blas3(int N, double min_time, int nthread = 1);
 * \param N maximum dimension exponent (requires 1 (2^N x 2^N) 
 * double matrices
 * \param min_time minimum amount of time to run each routine [s]
+* \return the number of bytes that did not survive a write and read
+*         back across the transfer paths (entries with unaligned ends)
 **/
-void benchmark_disk(int N, double min_time);
+unsigned long int benchmark_disk(int N, double min_time);
+/**
+* Perform a benchmark of AIOHandler reads, one request at a time
+* against a pool with every request in flight, and check request
+* ordering and error reporting
+* \param N dimension exponent, blocks are 2^N x 2^N doubles
+* \param nblocks number of blocks in each of the two entries read
+* \return the number of values read back wrong plus the number of
+*         errors not reported exactly as expected
+**/
+unsigned long int benchmark_aio(int N, int nblocks);
 /**
 * Perform a benchmark of psi integrals (of libmints type)
 * on the current hardware
@@ -70,6 +82,16 @@ void benchmark_disk(int N, double min_time);
 **/
 void benchmark_integrals(int max_am, double min_time);
 /**
+* Perform a benchmark of the Boys function implementations
+* (Taylor_Fjt, FJT, and Tabulated_Fjt one T at a time and batched)
+* on the current hardware, with their accuracy against the series
+* \param max_J maximum order J to consider
+* \param min_time minimum time to run each method for each J
+* \return the largest difference between batched and one-T-per-call
+*         values of the table and the erf/erfc fundamentals
+**/
+double benchmark_boys(int max_J, double min_time);
+/**
 * Perform a benchmark of common double floating
 * point operations, including most of cmath
 * \param min_time minimum amount of time to run each routine [s]
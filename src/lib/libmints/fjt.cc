@@ -48,6 +48,7 @@
 //
 
 #include <cmath>
+#include <algorithm>
 #include "integral.h"
 #include "fjt.h"
 #include "wavefunction.h"
@@ -73,6 +74,15 @@ const double oon[] = {0.0, 1.0, 1.0/2.0, 1.0/3.0, 1.0/4.0, 1.0/5.0, 1.0/6.0, 1.0
 Fjt::Fjt() {}
 Fjt::~Fjt() {}
 
+void Fjt::values_batch(int J, int n, const double* T, double* F)
+{
+    for (int i=0; i<n; ++i) {
+        double* Fi = values(J, T[i]);
+        for (int j=0; j<=J; ++j)
+            F[i*(J+1L) + j] = Fi[j];
+    }
+}
+
 double Taylor_Fjt::relative_zero_(1e-6);
 
 /*------------------------------------------------------
@@ -324,6 +334,155 @@ Taylor_Fjt::values(int l, double T)
 
 /////////////////////////////////////////////////////////////////////////////
 
+/*------------------------------------------------------
+  Tabulated_Fjt: F_m(T) for m <= TABULATED_FJT_MAXJ +
+  TABULATED_FJT_ORDER on T_k = k*delT, k*delT < Tmax,
+  from the series for the top m and downward recursion.
+  With delT = 0.1 the 7th-order Taylor interpolation
+  error is below (delT/2)^8/8! ~ 1e-15 relative to F_J.
+  Beyond Tmax = MAXJ + 36, F_0 comes from erf and the
+  upward recursion is stable (T > J) without cancellation.
+ ------------------------------------------------------*/
+Tabulated_Fjt::Tabulated_Fjt() :
+    delT_(0.1), oodelT_(10.0), Tmax_(TABULATED_FJT_MAXJ + 36.0)
+{
+    ncol_ = TABULATED_FJT_MAXJ + TABULATED_FJT_ORDER + 1;
+    ncol_ = 4 * ((ncol_ + 3) / 4);
+    nrow_ = (int) (Tmax_ * oodelT_) + 2;
+
+    grid_ = new double[nrow_ * (size_t) ncol_];
+    for (int k=0; k<nrow_; ++k)
+        series(ncol_ - 1, k * delT_, &grid_[k * (size_t) ncol_]);
+
+    F_.resize(TABULATED_FJT_MAXJ + 1);
+}
+
+Tabulated_Fjt::~Tabulated_Fjt()
+{
+    delete[] grid_;
+}
+
+const Tabulated_Fjt& Tabulated_Fjt::shared()
+{
+    static Tabulated_Fjt* table = 0;
+#pragma omp critical(Tabulated_Fjt_shared)
+    {
+        if (table == 0)
+            table = new Tabulated_Fjt();
+    }
+    return *table;
+}
+
+void Tabulated_Fjt::series(int J, double T, double *F)
+{
+    const double et = std::exp(-T);
+
+    if (T > J + 36.0) {
+        // Asymptotic regime: upward from F_0, the e^-T term is all but gone
+        const double ooT2 = 0.5 / T;
+        F[0] = 0.5 * std::sqrt(M_PI / T) * erf(std::sqrt(T));
+        for (int j=0; j<J; ++j)
+            F[j+1] = ((2*j + 1) * F[j] - et) * ooT2;
+        return;
+    }
+
+    // F_J(T) = e^-T sum_i (2T)^i / [(2J+1)(2J+3)...(2J+2i+1)], all terms positive
+    const double two_T = 2.0 * T;
+    double denom = 2*J + 1;
+    double term = 1.0 / denom;
+    double sum = term;
+    do {
+        denom += 2.0;
+        term *= two_T / denom;
+        sum += term;
+    } while (term > 1.0e-17 * sum);
+    F[J] = sum * et;
+
+    for (int j=J-1; j>=0; --j)
+        F[j] = (two_T * F[j+1] + et) / (2*j + 1);
+}
+
+void Tabulated_Fjt::evaluate(int J, int n, const double* T, double* F) const
+{
+    if (J > TABULATED_FJT_MAXJ) {
+        for (int i=0; i<n; ++i)
+            series(J, T[i], &F[i*(J+1L)]);
+        return;
+    }
+
+    const int B = TABULATED_FJT_BATCH;
+    double Fb[(TABULATED_FJT_MAXJ + 1) * TABULATED_FJT_BATCH];   // F_j of the batch, j-major
+    double Tb[TABULATED_FJT_BATCH];
+    double Eb[TABULATED_FJT_BATCH];
+    int near[TABULATED_FJT_BATCH];
+    int far[TABULATED_FJT_BATCH];
+
+    for (int start=0; start<n; start+=B) {
+        const int nb = std::min(B, n - start);
+        const double* Ti = T + start;
+        double* Fi = F + start * (J+1L);
+
+        int nnear = 0, nfar = 0;
+        for (int i=0; i<nb; ++i) {
+            if (Ti[i] < Tmax_) near[nnear++] = i;
+            else far[nfar++] = i;
+        }
+
+        /*--- Taylor interpolation of F_J about the nearest grid point ---*/
+        for (int p=0; p<nnear; ++p) {
+            const double t = Ti[near[p]];
+            const int k = (int) (t * oodelT_ + 0.5);
+            const double h = k * delT_ - t;
+            const double* row = &grid_[k * (size_t) ncol_ + J];
+            double f = row[TABULATED_FJT_ORDER];
+            for (int o=TABULATED_FJT_ORDER-1; o>=0; --o)
+                f = row[o] + h * f * oon[o+1];
+            Fb[J*B + p] = f;
+            Tb[p] = 2.0 * t;
+            Eb[p] = std::exp(-t);
+        }
+        /*--- and downward recursion ---*/
+        for (int j=J-1; j>=0; --j) {
+            const double oo2jp1 = 1.0 / (2*j + 1);
+            double* Fj = &Fb[j*B];
+            const double* Fjp1 = &Fb[(j+1)*B];
+            for (int p=0; p<nnear; ++p)
+                Fj[p] = (Tb[p] * Fjp1[p] + Eb[p]) * oo2jp1;
+        }
+        for (int p=0; p<nnear; ++p)
+            for (int j=0; j<=J; ++j)
+                Fi[near[p]*(J+1L) + j] = Fb[j*B + p];
+
+        /*--- Beyond the table: F_0 from erf and upward recursion ---*/
+        for (int p=0; p<nfar; ++p) {
+            const double t = Ti[far[p]];
+            Fb[p] = 0.5 * std::sqrt(M_PI / t) * erf(std::sqrt(t));
+            Tb[p] = 0.5 / t;
+            Eb[p] = std::exp(-t);
+        }
+        for (int j=0; j<J; ++j) {
+            const double* Fj = &Fb[j*B];
+            double* Fjp1 = &Fb[(j+1)*B];
+            for (int p=0; p<nfar; ++p)
+                Fjp1[p] = ((2*j + 1) * Fj[p] - Eb[p]) * Tb[p];
+        }
+        for (int p=0; p<nfar; ++p)
+            for (int j=0; j<=J; ++j)
+                Fi[far[p]*(J+1L) + j] = Fb[j*B + p];
+    }
+}
+
+double *
+Tabulated_Fjt::values(int J, double T)
+{
+    if (J + 1 > (int) F_.size())
+        F_.resize(J + 1);
+    evaluate(J, 1, &T, &F_[0]);
+    return &F_[0];
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 /* Tablesize should always be at least 121. */
 #define TABLESIZE 121
 
@@ -685,9 +844,9 @@ double* F12SquaredFundamental::values(int J, double T)
 ////////
 
 F12G12Fundamental::F12G12Fundamental(boost::shared_ptr<CorrelationFactor> cf, int max)
-    : GaussianFundamental(cf, max)
+    : GaussianFundamental(cf, max), Fvals_(max + 1)
 {
-    Fm_ = boost::shared_ptr<FJT>(new FJT(max));
+    Fm_ = &Tabulated_Fjt::shared();
 }
 
 F12G12Fundamental::~F12G12Fundamental()
@@ -697,7 +856,7 @@ F12G12Fundamental::~F12G12Fundamental()
 
 double* F12G12Fundamental::values(int J, double T)
 {
-    double *Fvals;
+    double *Fvals = &Fvals_[0];
 
     double* exps = cf_->exponent();
     double* coeffs = cf_->coeff();
@@ -718,7 +877,8 @@ double* F12G12Fundamental::values(int J, double T)
         rhohat = rho_ / (rho_ + omega);
         expterm = exp(-rhotilde * T);
         pfac = 2*M_PI / (rho_ + omega) * coeffs[i] * expterm * eri_correct;
-        Fvals = Fm_->values(J, rhohat * T);
+        double rhohat_T = rhohat * T;
+        Fm_->evaluate(J, 1, &rhohat_T, Fvals);
         for (int n=0; n<=J; ++n) {
             boysterm = 0.0;
             rhotilde_term = pow(rhotilde, n);
@@ -790,11 +950,12 @@ double* F12DoubleCommutatorFundamental::values(int J, double T)
 ////////
 
 ErfFundamental::ErfFundamental(double omega, int max)
-    : GaussianFundamental(boost::shared_ptr<CorrelationFactor>(), max)
+    : GaussianFundamental(boost::shared_ptr<CorrelationFactor>(), max),
+      erf_T_(TABULATED_FJT_BATCH)
 {
     omega_ = omega;
     rho_ = 0;
-    boys_ = boost::shared_ptr<FJT>(new FJT(max));
+    boys_ = &Tabulated_Fjt::shared();
 }
 
 ErfFundamental::~ErfFundamental()
@@ -803,24 +964,32 @@ ErfFundamental::~ErfFundamental()
 
 double* ErfFundamental::values(int J, double T)
 {
-    double *Fvals = boys_->values(J, T);
-
-    for (int n=0; n<=J; ++n)
-        value_[n] = 0.0;
+    values_batch(J, 1, &T, value_);
+    return value_;
+}
 
+void ErfFundamental::values_batch(int J, int n, const double* T, double* F)
+{
     // build the erf constants
     double omegasq = omega_ * omega_;
     double T_prefac = omegasq / (omegasq + rho_);
-    double F_prefac = sqrt(T_prefac);
-    double erf_T = T_prefac * T;
 
-    Fvals = boys_->values(J, erf_T);
-    for (int n=0; n<=J; ++n) {
-        value_[n] += Fvals[n] * F_prefac;
-        F_prefac *= T_prefac;
+    // erf_T_ holds one table batch, so long inputs are taken in chunks
+    for (int i0=0; i0<n; i0+=TABULATED_FJT_BATCH) {
+        int nb = (n - i0 < TABULATED_FJT_BATCH ? n - i0 : TABULATED_FJT_BATCH);
+        double* Fb = F + i0*(J+1L);
+        for (int i=0; i<nb; ++i)
+            erf_T_[i] = T_prefac * T[i0 + i];
+
+        boys_->evaluate(J, nb, &erf_T_[0], Fb);
+        for (int i=0; i<nb; ++i) {
+            double F_prefac = sqrt(T_prefac);
+            for (int j=0; j<=J; ++j) {
+                Fb[i*(J+1L) + j] *= F_prefac;
+                F_prefac *= T_prefac;
+            }
+        }
     }
-
-    return value_;
 }
 
 ////////
@@ -828,11 +997,12 @@ double* ErfFundamental::values(int J, double T)
 ////////
 
 ErfComplementFundamental::ErfComplementFundamental(double omega, int max)
-    : GaussianFundamental(boost::shared_ptr<CorrelationFactor>(), max)
+    : GaussianFundamental(boost::shared_ptr<CorrelationFactor>(), max),
+      erf_T_(TABULATED_FJT_BATCH), erf_F_(TABULATED_FJT_BATCH * (max + 1L))
 {
     omega_ = omega;
     rho_ = 0;
-    boys_ = boost::shared_ptr<FJT>(new FJT(max));
+    boys_ = &Tabulated_Fjt::shared();
 }
 
 ErfComplementFundamental::~ErfComplementFundamental()
@@ -841,24 +1011,33 @@ ErfComplementFundamental::~ErfComplementFundamental()
 
 double* ErfComplementFundamental::values(int J, double T)
 {
-    double *Fvals = boys_->values(J, T);
-
-    for (int n=0; n<=J; ++n)
-        value_[n] = Fvals[n];
+    values_batch(J, 1, &T, value_);
+    return value_;
+}
 
+void ErfComplementFundamental::values_batch(int J, int n, const double* T, double* F)
+{
     // build the erf constants
     double omegasq = omega_ * omega_;
     double T_prefac = omegasq / (omegasq + rho_);
-    double F_prefac = sqrt(T_prefac);
-    double erf_T = T_prefac * T;
 
-    Fvals = boys_->values(J, erf_T);
-    for (int n=0; n<=J; ++n) {
-        value_[n] -= Fvals[n] * F_prefac;
-        F_prefac *= T_prefac;
+    // erf_T_ and erf_F_ hold one table batch, so long inputs are taken in chunks
+    for (int i0=0; i0<n; i0+=TABULATED_FJT_BATCH) {
+        int nb = (n - i0 < TABULATED_FJT_BATCH ? n - i0 : TABULATED_FJT_BATCH);
+        double* Fb = F + i0*(J+1L);
+        for (int i=0; i<nb; ++i)
+            erf_T_[i] = T_prefac * T[i0 + i];
+
+        boys_->evaluate(J, nb, T + i0, Fb);
+        boys_->evaluate(J, nb, &erf_T_[0], &erf_F_[0]);
+        for (int i=0; i<nb; ++i) {
+            double F_prefac = sqrt(T_prefac);
+            for (int j=0; j<=J; ++j) {
+                Fb[i*(J+1L) + j] -= erf_F_[i*(J+1L) + j] * F_prefac;
+                F_prefac *= T_prefac;
+            }
+        }
     }
-
-    return value_;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -50,6 +50,8 @@
 #ifndef _chemistry_qc_basis_fjt_h
 #define _chemistry_qc_basis_fjt_h
 
+#include <vector>
+
 namespace boost {
 template<class T> class shared_ptr;
 }
@@ -68,9 +70,49 @@ public:
         The values will be overwritten with the next call to this functions.
         The pointer will be invalidated after the call to ~Fjt. */
     virtual double *values(int J, double T) =0;
+    /** Computes F_j(T[i]) for every 0 <= j <= J and 0 <= i < n into
+        F[i*(J+1) + j]. The default calls values() once per T. */
+    virtual void values_batch(int J, int n, const double* T, double* F);
     virtual void set_rho(double /*rho*/) { }
 };
 
+#define TABULATED_FJT_MAXJ 32   // largest J served from the table, larger J use the series
+#define TABULATED_FJT_ORDER 7   // order of the Taylor interpolation
+#define TABULATED_FJT_BATCH 64  // T values evaluated together
+/** Boys function from a table of F_m(T) on a uniform T grid, evaluated
+    a batch of T at a time. Each batch is interpolated to F_J, then filled
+    in by downward recursion (or, beyond the table, by upward recursion
+    from erf) with loops over the T of the batch, so the compiler can
+    vectorize them. evaluate() writes only to the caller's array; one
+    table, normally shared(), serves any number of threads. */
+class Tabulated_Fjt : public Fjt {
+public:
+    Tabulated_Fjt();
+    virtual ~Tabulated_Fjt();
+
+    /// The process-wide table, built on first use
+    static const Tabulated_Fjt& shared();
+    /// F_j(T) for 0 <= j <= J by the series expansion and recursion (any J)
+    static void series(int J, double T, double* F);
+
+    /// F_j(T[i]) for 0 <= j <= J and 0 <= i < n into F[i*(J+1) + j]; thread-safe
+    void evaluate(int J, int n, const double* T, double* F) const;
+
+    /// Implements Fjt::values()
+    double *values(int J, double T);
+    /// Implements Fjt::values_batch()
+    void values_batch(int J, int n, const double* T, double* F) { evaluate(J, n, T, F); }
+private:
+    double *grid_;             /* F_m(T_k) for T_k = k * delT_, row k holds m = 0..ncol_-1
+                                  (padded to a multiple of 4 doubles) */
+    int nrow_;
+    int ncol_;
+    double delT_;              /* Grid spacing */
+    double oodelT_;            /* 1.0 / delT_ */
+    double Tmax_;              /* T at and beyond which upward recursion is used */
+    std::vector<double> F_;    /* Scratch for values() only */
+};
+
 #define TAYLOR_INTERPOLATION_ORDER 6
 #define TAYLOR_INTERPOLATION_AND_RECURSION 0  // compute F_lmax(T) and then iterate down to F_0(T)? Else use interpolation only
 /// Uses Taylor interpolation of up to 8-th order to compute the Boys function
@@ -165,7 +207,8 @@ public:
 
 class F12G12Fundamental : public GaussianFundamental {
 private:
-    boost::shared_ptr<FJT> Fm_;
+    const Tabulated_Fjt* Fm_;
+    std::vector<double> Fvals_;
 public:
     F12G12Fundamental(boost::shared_ptr<CorrelationFactor> cf, int max);
     virtual ~F12G12Fundamental();
@@ -182,22 +225,27 @@ public:
 class ErfFundamental : public GaussianFundamental {
 private:
     double omega_;
-    boost::shared_ptr<FJT> boys_;
+    const Tabulated_Fjt* boys_;
+    std::vector<double> erf_T_;   /* Scaled T of one batch, sized at construction */
 public:
     ErfFundamental(double omega, int max);
     virtual ~ErfFundamental();
     double* values(int J, double T);
+    void values_batch(int J, int n, const double* T, double* F);
     void setOmega(double omega) { omega_ = omega; }
 };
 
 class ErfComplementFundamental : public GaussianFundamental {
 private:
     double omega_;
-    boost::shared_ptr<FJT> boys_;
+    const Tabulated_Fjt* boys_;
+    std::vector<double> erf_T_;   /* Scaled T of one batch, sized at construction */
+    std::vector<double> erf_F_;   /* Attenuated F_j of one batch, up to the max J */
 public:
     ErfComplementFundamental(double omega, int max);
     virtual ~ErfComplementFundamental();
     double* values(int J, double T);
+    void values_batch(int J, int n, const double* T, double* F);
     void setOmega(double omega) { omega_ = omega; }
 };
 
@@ -287,15 +287,14 @@ double** Matrix::matrix(int nrow, int ncol)
 {
     double** mat = (double**) malloc(sizeof(double*)*nrow);
     const size_t size = sizeof(double)*nrow*ncol;
-    mat[0] = (double*) malloc(size);
-    ::memset((void *)mat[0], 0, size);
+    mat[0] = (double*) arena_malloc(size);
     for(int r=1; r<nrow; ++r) mat[r] = mat[r-1] + ncol;
     return mat;
 }
 /// free a (block) matrix -- analogous to libciomr's free_block
 void Matrix::free(double** Block)
 {
-    ::free(Block[0]);  ::free(Block);
+    arena_free(Block[0]);  ::free(Block);
 }
 
 void Matrix::init(int l_nirreps, const int *l_rowspi, const int *l_colspi, const string& name, int symmetry)
@@ -3001,7 +3000,7 @@ void Matrix::save(const string& filename, bool append, bool saveLowerTriangle, b
                 }
             }
         }
-        Matrix::free(fullblock);
+        free_block(fullblock);
     } else {
         if (saveLowerTriangle) {
             // Count the number of non-zero elements
@@ -3094,7 +3093,7 @@ void Matrix::save(psi::PSIO* const psio, unsigned int fileno, SaveType st)
             psio->write_entry(fileno, const_cast<char*>(name_.c_str()), (char*)fullblock[0],
                               sizeof(double) * sizer * sizec);
 
-        Matrix::free(fullblock);
+        free_block(fullblock);
     }
     else if (st == LowerTriangle) {
         double *lower = to_lower_triangle();
@@ -3176,7 +3175,7 @@ void Matrix::load(psi::PSIO* const psio, unsigned int fileno, SaveType st)
             psio->read_entry(fileno, name_.c_str(), (char*)fullblock[0], sizeof(double) * sizer * sizec);
 
         set(fullblock);
-        Matrix::free(fullblock);
+        free_block(fullblock);
     }
     else if (st == LowerTriangle) {
         double *lower = to_lower_triangle();
@@ -42,6 +42,12 @@
 #include <boost/foreach.hpp>
 #include "x2cint.h"
 
+#include <sys/time.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace boost;
 
 #ifdef HAVE_DKH
@@ -102,6 +108,127 @@ public:
     size_t count() const { return count_; }
 };
 
+/**
+* Per-thread staging functor for the SO TEIs.  Integrals are collected
+* locally and handed to the shared IWLWriter one full IWL buffer at a
+* time, so the writer is only locked once per buffer.
+**/
+class IWLThreadBuffer {
+    IWLWriter& writer_;
+    size_t max_;
+    size_t count_;
+    std::vector<int> labels_;
+    std::vector<double> values_;
+public:
+
+    IWLThreadBuffer(IWLWriter& writer, size_t max) : writer_(writer), max_(max), count_(0)
+    {
+        labels_.reserve(4*max_);
+        values_.reserve(max_);
+    }
+
+    void operator()(int i, int j, int k, int l, int , int , int , int , int , int , int , int , double value)
+    {
+        labels_.push_back(i);
+        labels_.push_back(j);
+        labels_.push_back(k);
+        labels_.push_back(l);
+        values_.push_back(value);
+        count_++;
+
+        if (values_.size() == max_)
+            flush();
+    }
+
+    void flush()
+    {
+#pragma omp critical(IWLThreadBuffer_flush)
+        {
+            for (size_t n=0; n<values_.size(); ++n)
+                writer_(labels_[4*n], labels_[4*n+1], labels_[4*n+2], labels_[4*n+3],
+                        0, 0, 0, 0, 0, 0, 0, 0, values_[n]);
+        }
+        labels_.clear();
+        values_.clear();
+    }
+
+    size_t count() const { return count_; }
+};
+
+static double wall_time()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + 1.0E-6 * tv.tv_usec;
+}
+
+/**
+* Computes all unique SO shell quartets with eri and writes them through
+* writer.  The quartets are dealt out dynamically to the threads, one
+* per AO integral object held by eri; each thread stages its integrals
+* in its own IWL-sized buffer.  Prints the thread timings.
+**/
+static void compute_so_tei(boost::shared_ptr<TwoBodySOInt> eri,
+                           boost::shared_ptr<SOBasisSet> sobasis,
+                           IWL& iwl, IWLWriter& writer, int nthread)
+{
+    std::vector<int> P, Q, R, S;
+    SOShellCombinationsIterator shellIter(sobasis, sobasis, sobasis, sobasis);
+    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) {
+        P.push_back(shellIter.p());
+        Q.push_back(shellIter.q());
+        R.push_back(shellIter.r());
+        S.push_back(shellIter.s());
+    }
+    long int nquartet = P.size();
+
+#ifndef _OPENMP
+    nthread = 1;
+#endif
+
+    std::vector<double> busy(nthread, 0.0);
+    std::vector<size_t> nints(nthread, 0);
+
+    double start = wall_time();
+
+#pragma omp parallel num_threads(nthread)
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double tstart = wall_time();
+        IWLThreadBuffer buffer(writer, iwl.ints_per_buffer());
+
+#pragma omp for schedule(dynamic)
+        for (long int n=0; n<nquartet; ++n)
+            eri->compute_shell(P[n], Q[n], R[n], S[n], buffer);
+
+        buffer.flush();
+        nints[thread] = buffer.count();
+        busy[thread] = wall_time() - tstart;
+    }
+
+    double wall = wall_time() - start;
+
+    outfile->Printf( "done\n");
+    if (nthread > 1) {
+        double total = 0.0;
+        size_t minints = nints[0], maxints = nints[0];
+        for (int t=0; t<nthread; ++t) {
+            total += busy[t];
+            minints = std::min(minints, nints[t]);
+            maxints = std::max(maxints, nints[t]);
+        }
+        outfile->Printf( "      Wall time %.2f s on %d threads, %.2fx thread speedup.\n",
+                         wall, nthread, (wall > 0.0 ? total / wall : 1.0));
+        outfile->Printf( "      Integrals per thread: min %lu, max %lu.\n", minints, maxints);
+    }
+    else {
+        outfile->Printf( "      Wall time %.2f s on 1 thread.\n", wall);
+    }
+}
+
 
 MintsHelper::MintsHelper(Options & options, int print)
     : options_(options), print_(print)
@@ -272,10 +399,7 @@ void MintsHelper::integrals()
     // Let the user know what we're doing.
     outfile->Printf( "      Computing two-electron integrals...");
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) {
-        eri->compute_shell(shellIter, writer);
-    }
+    compute_so_tei(eri, sobasis_, ERIOUT, writer, tb.size());
 
     // Flush out buffers.
     ERIOUT.flush(1);
@@ -284,7 +408,6 @@ void MintsHelper::integrals()
     ERIOUT.set_keep_flag(true);
     ERIOUT.close();
 
-    outfile->Printf( "done\n");
     outfile->Printf( "      Computed %lu non-zero two-electron integrals.\n"
                      "        Stored in file %d.\n\n", writer.count(), PSIF_SO_TEI);
 }
@@ -305,9 +428,7 @@ void MintsHelper::integrals_erf(double w)
     // Let the user know what we're doing.
     outfile->Printf( "      Computing non-zero ERF integrals (omega = %.3f)...", omega);
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next())
-        erf->compute_shell(shellIter, writer);
+    compute_so_tei(erf, sobasis_, ERIOUT, writer, tb.size());
 
     // Flush the buffers
     ERIOUT.flush(1);
@@ -316,7 +437,6 @@ void MintsHelper::integrals_erf(double w)
     ERIOUT.set_keep_flag(true);
     ERIOUT.close();
 
-    outfile->Printf( "done\n");
     outfile->Printf( "      Computed %lu non-zero ERF integrals.\n"
                      "        Stored in file %d.\n\n", writer.count(), PSIF_SO_ERF_TEI);
 }
@@ -337,9 +457,7 @@ void MintsHelper::integrals_erfc(double w)
     // Let the user know what we're doing.
     outfile->Printf( "      Computing non-zero ERFComplement integrals...");
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next())
-        erf->compute_shell(shellIter, writer);
+    compute_so_tei(erf, sobasis_, ERIOUT, writer, tb.size());
 
     // Flush the buffers
     ERIOUT.flush(1);
@@ -348,7 +466,6 @@ void MintsHelper::integrals_erfc(double w)
     ERIOUT.set_keep_flag(true);
     ERIOUT.close();
 
-    outfile->Printf( "done\n");
     outfile->Printf( "      Computed %lu non-zero ERFComplement integrals.\n"
                      "        Stored in file %d.\n\n", writer.count(), PSIF_SO_ERFC_TEI);
 }
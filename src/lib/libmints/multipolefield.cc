@@ -0,0 +1,739 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+
+#include <boost/shared_ptr.hpp>
+#include <exception.h>
+#include "multipolefield.h"
+#include "gshell.h"
+#include "vector3.h"
+#include "fjt.h"
+
+using namespace psi;
+
+namespace {
+
+/// Number of Cartesian (or Hermite) components through order N
+inline int ntuv(int N)
+{
+    return (N + 1) * (N + 2) * (N + 3) / 6;
+}
+
+/// Number of Hermite integrals formed by the recursion through order N
+inline int nrecur(int N)
+{
+    return (N + 1) * (N + 2) * (N + 3) * (N + 4) / 24;
+}
+
+/// Position of (t,u,v) among all components, in Cartesian order by total order
+inline int hindex(int t, int u, int v)
+{
+    const int n = t + u + v;
+    const int i = u + v;
+    return n * (n + 1) * (n + 2) / 6 + i * (i + 1) / 2 + v;
+}
+
+}
+
+MultipoleField::MultipoleField(int order) :
+    order_(order), nmoment_(ntuv(order)), cell_order_(MULTIPOLE_FIELD_CELL_ORDER), cell_K_(0),
+    tolerance_(MULTIPOLE_FIELD_TOLERANCE), built_(false)
+{
+    if (order < 0)
+        throw PSIEXCEPTION("MultipoleField: order must be nonnegative.");
+}
+
+void MultipoleField::clear()
+{
+    site_m_.clear();
+    x_.clear();
+    y_.clear();
+    z_.clear();
+    m_.clear();
+    index_.clear();
+    built_ = false;
+}
+
+void MultipoleField::add_site(double x, double y, double z, const double* m)
+{
+    index_.push_back(nsite());
+    x_.push_back(x);
+    y_.push_back(y);
+    z_.push_back(z);
+    site_m_.insert(site_m_.end(), m, m + nmoment_);
+    built_ = false;
+}
+
+void MultipoleField::add_charge(double m0, double x, double y, double z)
+{
+    std::vector<double> m(nmoment_, 0.0);
+    m[0] = m0;
+    add_site(x, y, z, &m[0]);
+}
+
+void MultipoleField::build()
+{
+    const int n = nsite();
+
+    cell_first_.clear();
+    cell_last_.clear();
+    cx_.clear();
+    cy_.clear();
+    cz_.clear();
+    cr_.clear();
+    cm_.clear();
+    cs_.clear();
+    cell_K_ = std::max(cell_order_, order_);
+
+    if (cell_order_ >= 0 && n >= MULTIPOLE_FIELD_MIN_SITES) {
+        // => Sort the sites by cell, with cells holding about MULTIPOLE_FIELD_CELL_SITES each <= //
+        double lo[3], hi[3];
+        lo[0] = hi[0] = x_[0];
+        lo[1] = hi[1] = y_[0];
+        lo[2] = hi[2] = z_[0];
+        for (int i = 1; i < n; i++) {
+            lo[0] = std::min(lo[0], x_[i]); hi[0] = std::max(hi[0], x_[i]);
+            lo[1] = std::min(lo[1], y_[i]); hi[1] = std::max(hi[1], y_[i]);
+            lo[2] = std::min(lo[2], z_[i]); hi[2] = std::max(hi[2], z_[i]);
+        }
+        double volume = (hi[0] - lo[0] + 1.0) * (hi[1] - lo[1] + 1.0) * (hi[2] - lo[2] + 1.0);
+        double edge = std::pow(volume * MULTIPOLE_FIELD_CELL_SITES / n, 1.0 / 3.0);
+        long int ny = (long int) ((hi[1] - lo[1]) / edge) + 1;
+        long int nz = (long int) ((hi[2] - lo[2]) / edge) + 1;
+
+        std::vector<std::pair<long int, int> > key(n);
+        for (int i = 0; i < n; i++) {
+            long int ix = (long int) ((x_[i] - lo[0]) / edge);
+            long int iy = (long int) ((y_[i] - lo[1]) / edge);
+            long int iz = (long int) ((z_[i] - lo[2]) / edge);
+            key[i] = std::make_pair((ix * ny + iy) * nz + iz, i);
+        }
+        std::sort(key.begin(), key.end());
+
+        std::vector<double> x(n), y(n), z(n);
+        std::vector<int> index(n);
+        for (int i = 0; i < n; i++) {
+            int j = key[i].second;
+            x[i] = x_[j];
+            y[i] = y_[j];
+            z[i] = z_[j];
+            index[i] = index_[j];
+        }
+        x_.swap(x);
+        y_.swap(y);
+        z_.swap(z);
+        index_.swap(index);
+
+        for (int i = 0; i < n; i++) {
+            if (i == 0 || key[i].first != key[i-1].first) {
+                if (i) cell_last_.push_back(i);
+                cell_first_.push_back(i);
+            }
+        }
+        cell_last_.push_back(n);
+    }
+
+    // => Site moments, moment-major with the derivative sign folded in <= //
+    m_.resize((size_t) nmoment_ * n);
+    for (int s = 0, k = 0; s <= order_; s++) {
+        double sign = (s % 2 ? -1.0 : 1.0);
+        for (int c = 0; c < ntuv(s) - ntuv(s - 1); c++, k++)
+            for (int i = 0; i < n; i++)
+                m_[(size_t) k * n + i] = sign * site_m_[(size_t) index_[i] * nmoment_ + k];
+    }
+
+    // => Cell centers, radii, multipoles and strengths <= //
+    const int ncell = cell_first_.size();
+    const int K = cell_K_;
+    const int ncm = ntuv(K);
+    cx_.resize(ncell);
+    cy_.resize(ncell);
+    cz_.resize(ncell);
+    cr_.resize(ncell);
+    cm_.assign((size_t) ncm * ncell, 0.0);
+    cs_.assign((size_t) (order_ + 1) * ncell, 0.0);
+
+    std::vector<double> px(K + 1), py(K + 1), pz(K + 1);
+    for (int c = 0; c < ncell; c++) {
+        double lo[3], hi[3];
+        lo[0] = hi[0] = x_[cell_first_[c]];
+        lo[1] = hi[1] = y_[cell_first_[c]];
+        lo[2] = hi[2] = z_[cell_first_[c]];
+        for (int i = cell_first_[c] + 1; i < cell_last_[c]; i++) {
+            lo[0] = std::min(lo[0], x_[i]); hi[0] = std::max(hi[0], x_[i]);
+            lo[1] = std::min(lo[1], y_[i]); hi[1] = std::max(hi[1], y_[i]);
+            lo[2] = std::min(lo[2], z_[i]); hi[2] = std::max(hi[2], z_[i]);
+        }
+        cx_[c] = 0.5 * (lo[0] + hi[0]);
+        cy_[c] = 0.5 * (lo[1] + hi[1]);
+        cz_[c] = 0.5 * (lo[2] + hi[2]);
+
+        double r2 = 0.0;
+        for (int i = cell_first_[c]; i < cell_last_[c]; i++) {
+            // Translation of the site moments to the cell center:
+            //   M_{j+k} += m_j (-d)^k / k!,  d = C - Q
+            double dx = x_[i] - cx_[c];
+            double dy = y_[i] - cy_[c];
+            double dz = z_[i] - cz_[c];
+            r2 = std::max(r2, dx * dx + dy * dy + dz * dz);
+            px[0] = py[0] = pz[0] = 1.0;
+            for (int k = 1; k <= K; k++) {
+                px[k] = -px[k-1] * dx / k;
+                py[k] = -py[k-1] * dy / k;
+                pz[k] = -pz[k-1] * dz / k;
+            }
+
+            for (int s = 0, j = 0; s <= order_; s++) {
+                for (int jt = s; jt >= 0; jt--) {
+                    for (int ju = s - jt; ju >= 0; ju--, j++) {
+                        int jv = s - jt - ju;
+                        double mj = m_[(size_t) j * n + i];
+                        if (mj == 0.0) continue;
+                        cs_[(size_t) s * ncell + c] += std::fabs(mj);
+                        for (int o = 0; o <= K - s; o++) {
+                            for (int kt = o; kt >= 0; kt--) {
+                                for (int ku = o - kt; ku >= 0; ku--) {
+                                    int kv = o - kt - ku;
+                                    cm_[(size_t) hindex(jt + kt, ju + ku, jv + kv) * ncell + c] += mj * px[kt] * py[ku] * pz[kv];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        cr_[c] = std::sqrt(r2);
+    }
+
+    built_ = true;
+}
+
+MultipoleFieldEngine::MultipoleFieldEngine() :
+    nsite_direct_(0), ncell_multipole_(0)
+{
+    boys_ = &Tabulated_Fjt::shared();
+    T_.resize(MULTIPOLE_FIELD_BATCH);
+    U_.resize(MULTIPOLE_FIELD_BATCH);
+    near_.resize(MULTIPOLE_FIELD_BATCH);
+    X_.resize(MULTIPOLE_FIELD_BATCH);
+    Y_.resize(MULTIPOLE_FIELD_BATCH);
+    Z_.resize(MULTIPOLE_FIELD_BATCH);
+}
+
+// E^{ij}_t of one Cartesian direction, E^{00}_0 = 1, at E[(i*(am2+1) + j)*(am1+am2+1) + t]
+void MultipoleFieldEngine::form_E(double* E, int am1, int am2, double PA, double PB, double oo2p)
+{
+    const int L1 = am1 + am2 + 1;
+    ::memset(E, 0, sizeof(double) * (am1 + 1) * (am2 + 1) * L1);
+    E[0] = 1.0;
+    for (int i = 0; i <= am1; i++) {
+        for (int j = 0; j <= am2; j++) {
+            if (i == 0 && j == 0) continue;
+            double* e = &E[(i * (am2 + 1) + j) * L1];
+            const double* f;
+            double PX;
+            int n;
+            if (i) {
+                f = &E[((i - 1) * (am2 + 1) + j) * L1];
+                PX = PA;
+            }
+            else {
+                f = &E[(i * (am2 + 1) + j - 1) * L1];
+                PX = PB;
+            }
+            n = i + j - 1;
+            for (int t = 0; t <= n + 1; t++) {
+                double v = 0.0;
+                if (t > 0) v += oo2p * f[t-1];
+                if (t <= n) v += PX * f[t];
+                if (t + 1 <= n) v += (t + 1) * f[t+1];
+                e[t] = v;
+            }
+        }
+    }
+}
+
+// Smallest T beyond which F_m(T), m <= N, equals its asymptotic form
+// Gamma(m+1/2) / (2 T^(m+1/2)) to a relative 1.0E-15; the remainder is
+// about exp(-T) / (2 (T - m + 1/2)).
+double MultipoleFieldEngine::asymptotic_T(int N)
+{
+    if (N < (int) Tasym_.size() && Tasym_[N] > 0.0)
+        return Tasym_[N];
+    if (N >= (int) Tasym_.size())
+        Tasym_.resize(N + 1, 0.0);
+
+    const double lg = lgamma(N + 0.5);
+    const double lmax = std::log(1.0E-15);
+    double T = N + 1.0;
+    while (-T + (N + 0.5) * std::log(T) - std::log(T - N + 0.5) - lg > lmax)
+        T += 1.0;
+    Tasym_[N] = T;
+    return T;
+}
+
+// Hermite integrals R^0_tuv, t+u+v <= N, of n <= MULTIPOLE_FIELD_BATCH sites
+// about P, at [hindex(t,u,v) * MULTIPOLE_FIELD_BATCH + site].  With point
+// set, and for any site beyond asymptotic_T(N), the asymptotic Boys function
+// is used, i.e. the sites are treated as point sources:
+//   R_tuv = 1/2 (pi/p)^1/2 d^tuv/dP^tuv 1/|P - C|.
+const double* MultipoleFieldEngine::hermite(int N, double p, const double* P, int n,
+                                            const double* x, const double* y, const double* z, bool point)
+{
+    const int B = MULTIPOLE_FIELD_BATCH;
+    const size_t nh = (size_t) ntuv(N) * B;
+    if (R0_.size() < nh) {
+        R0_.resize(nh);
+        R1_.resize(nh);
+    }
+    if (S_.size() < (size_t) (N + 1) * B) {
+        S_.resize((N + 1) * B);
+        F_.resize((N + 1) * B);
+    }
+
+    double* X = &X_[0];
+    double* Y = &Y_[0];
+    double* Z = &Z_[0];
+    double* T = &T_[0];
+    double* S = &S_[0];
+    for (int c = 0; c < n; c++) {
+        X[c] = P[0] - x[c];
+        Y[c] = P[1] - y[c];
+        Z[c] = P[2] - z[c];
+    }
+
+    // => Seeds R^j_000, asymptotic unless a site is near <= //
+    const double pf = 0.5 * std::sqrt(M_PI / p);
+    double* U = &U_[0];
+    for (int c = 0; c < n; c++) {
+        double r2 = X[c] * X[c] + Y[c] * Y[c] + Z[c] * Z[c];
+        T[c] = p * r2;
+        U[c] = 1.0 / std::max(r2, 1.0E-300);
+        S[c] = pf * std::sqrt(U[c]);
+    }
+    for (int j = 1; j <= N; j++) {
+        const double f = -(2.0 * j - 1.0);
+        double* Sj = &S[j * B];
+        const double* Sm = &S[(j - 1) * B];
+        for (int c = 0; c < n; c++)
+            Sj[c] = f * U[c] * Sm[c];
+    }
+    if (!point) {
+        const double Tasym = asymptotic_T(N);
+        int nnear = 0;
+        for (int c = 0; c < n; c++) {
+            if (T[c] < Tasym) {
+                near_[nnear] = c;
+                U[nnear++] = T[c];
+            }
+        }
+        if (nnear) {
+            double* F = &F_[0];
+            boys_->evaluate(N, nnear, U, F);
+            double f = 1.0;
+            for (int j = 0; j <= N; j++, f *= -2.0 * p) {
+                double* Sj = &S[j * B];
+                for (int i = 0; i < nnear; i++)
+                    Sj[near_[i]] = f * F[i * (N + 1) + j];
+            }
+        }
+    }
+
+    // => Downward in j, upward in tuv <= //
+    //   R^j_{t+1,u,v} = t R^{j+1}_{t-1,u,v} + X R^{j+1}_{t,u,v}
+    double* cur = &R0_[0];
+    double* prev = &R1_[0];
+    ::memcpy(cur, &S[N * B], sizeof(double) * n);
+    for (int j = N - 1; j >= 0; j--) {
+        std::swap(cur, prev);
+        ::memcpy(cur, &S[j * B], sizeof(double) * n);
+        int h = 1;
+        for (int s = 1; s <= N - j; s++) {
+            for (int t = s; t >= 0; t--) {
+                for (int u = s - t; u >= 0; u--, h++) {
+                    int v = s - t - u;
+                    double* out = cur + h * B;
+                    const double* D;
+                    const double* a;
+                    const double* b = 0;
+                    int f;
+                    if (t) {
+                        D = X; f = t - 1;
+                        a = prev + hindex(t - 1, u, v) * B;
+                        if (f) b = prev + hindex(t - 2, u, v) * B;
+                    }
+                    else if (u) {
+                        D = Y; f = u - 1;
+                        a = prev + hindex(t, u - 1, v) * B;
+                        if (f) b = prev + hindex(t, u - 2, v) * B;
+                    }
+                    else {
+                        D = Z; f = v - 1;
+                        a = prev + hindex(t, u, v - 1) * B;
+                        if (f) b = prev + hindex(t, u, v - 2) * B;
+                    }
+                    if (b) {
+                        for (int c = 0; c < n; c++)
+                            out[c] = D[c] * a[c] + f * b[c];
+                    }
+                    else {
+                        for (int c = 0; c < n; c++)
+                            out[c] = D[c] * a[c];
+                    }
+                }
+            }
+        }
+    }
+
+    return cur;
+}
+
+// W_h += sum_sites sum_k m_k R_{h+k}, |h| <= L, |k| <= K
+void MultipoleFieldEngine::add_sites(int L, int K, double p, const double* P, int n,
+                                     const double* x, const double* y, const double* z,
+                                     const double* m, size_t mstride, bool point)
+{
+    const int B = MULTIPOLE_FIELD_BATCH;
+    double* W = &W_[0];
+
+    for (int start = 0; start < n; start += B) {
+        const int nb = std::min(B, n - start);
+        const double* R = hermite(L + K, p, P, nb, x + start, y + start, z + start, point);
+
+        for (int o = 0, k = 0; o <= K; o++) {
+            for (int kt = o; kt >= 0; kt--) {
+                for (int ku = o - kt; ku >= 0; ku--, k++) {
+                    int kv = o - kt - ku;
+                    const double* mk = m + k * mstride + start;
+                    for (int s = 0, h = 0; s <= L; s++) {
+                        for (int t = s; t >= 0; t--) {
+                            for (int u = s - t; u >= 0; u--, h++) {
+                                int v = s - t - u;
+                                const double* r = R + hindex(t + kt, u + ku, v + kv) * B;
+                                double sum = 0.0;
+                                for (int c = 0; c < nb; c++)
+                                    sum += mk[c] * r[c];
+                                W[h] += sum;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (point)
+        ncell_multipole_ += n;
+    else
+        nsite_direct_ += n;
+}
+
+// values[index[site]] += sum_h W_h sum_k m_k R_{h+k}, with the Hermite density in W
+void MultipoleFieldEngine::contract_sites(int L, int K, double p, const double* P, int n,
+                                          const double* x, const double* y, const double* z,
+                                          const double* m, size_t mstride, const int* index, double* values)
+{
+    const int B = MULTIPOLE_FIELD_BATCH;
+    const double* W = &W_[0];
+    double acc[MULTIPOLE_FIELD_BATCH];
+
+    for (int start = 0; start < n; start += B) {
+        const int nb = std::min(B, n - start);
+        const double* R = hermite(L + K, p, P, nb, x + start, y + start, z + start, false);
+
+        for (int c = 0; c < nb; c++)
+            acc[c] = 0.0;
+        for (int o = 0, k = 0; o <= K; o++) {
+            for (int kt = o; kt >= 0; kt--) {
+                for (int ku = o - kt; ku >= 0; ku--, k++) {
+                    int kv = o - kt - ku;
+                    const double* mk = m + k * mstride + start;
+                    for (int s = 0, h = 0; s <= L; s++) {
+                        for (int t = s; t >= 0; t--) {
+                            for (int u = s - t; u >= 0; u--, h++) {
+                                int v = s - t - u;
+                                if (W[h] == 0.0) continue;
+                                const double* r = R + hindex(t + kt, u + ku, v + kv) * B;
+                                for (int c = 0; c < nb; c++)
+                                    acc[c] += W[h] * mk[c] * r[c];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        for (int c = 0; c < nb; c++)
+            values[index[start + c]] += acc[c];
+    }
+
+    nsite_direct_ += n;
+}
+
+// The engine only supports segmented basis sets
+void MultipoleFieldEngine::compute_pair(const MultipoleField& field, const GaussianShell& s1,
+                                        const GaussianShell& s2, double* buffer)
+{
+    if (!field.built())
+        throw PSIEXCEPTION("MultipoleFieldEngine: the field must be built first.");
+
+    const int am1 = s1.am();
+    const int am2 = s2.am();
+    const int L = am1 + am2;
+    const int L1 = L + 1;
+    const int K = field.order_;
+    const int Kc = field.cell_K_;
+    const int nsite = field.nsite();
+    const int ncell = field.ncell();
+    const int nprim1 = s1.nprimitive();
+    const int nprim2 = s2.nprimitive();
+    const double tolerance = field.tolerance_;
+
+    ::memset(buffer, 0, sizeof(double) * s1.ncartesian() * s2.ncartesian());
+    if (nsite == 0) return;
+
+    const size_t nE = (size_t) (am1 + 1) * (am2 + 1) * L1;
+    if (Ex_.size() < nE) {
+        Ex_.resize(nE);
+        Ey_.resize(nE);
+        Ez_.resize(nE);
+    }
+    W_.resize(ntuv(L));
+    if (ncell && gx_.size() < (size_t) ncell) {
+        gx_.resize(ncell);
+        gy_.resize(ncell);
+        gz_.resize(ncell);
+        gm_.resize((size_t) ntuv(Kc) * ncell);
+    }
+    const double Tcell = ncell ? asymptotic_T(L + Kc) : 0.0;
+    // Rough operation counts of a site and of a cell: the Hermite recursion,
+    // the sum over the moments and the per-site setup
+    const double site_cost = nrecur(L + K) + (double) ntuv(L) * ntuv(K) + 20.0;
+    const double cell_cost = nrecur(L + Kc) + (double) ntuv(L) * ntuv(Kc) + 20.0;
+
+    const Vector3& A = s1.center();
+    const Vector3& B = s2.center();
+    double AB2 = (A[0] - B[0]) * (A[0] - B[0]) + (A[1] - B[1]) * (A[1] - B[1]) + (A[2] - B[2]) * (A[2] - B[2]);
+
+    for (int p1 = 0; p1 < nprim1; ++p1) {
+        double a1 = s1.exp(p1);
+        double c1 = s1.coef(p1);
+        for (int p2 = 0; p2 < nprim2; ++p2) {
+            double a2 = s2.exp(p2);
+            double c2 = s2.coef(p2);
+            double p = a1 + a2;
+            double oop = 1.0 / p;
+
+            double P[3];
+            P[0] = (a1 * A[0] + a2 * B[0]) * oop;
+            P[1] = (a1 * A[1] + a2 * B[1]) * oop;
+            P[2] = (a1 * A[2] + a2 * B[2]) * oop;
+
+            double Kab = std::exp(-a1 * a2 * AB2 * oop);
+            double pref = 2.0 * M_PI * oop * c1 * c2 * Kab;
+
+            form_E(&Ex_[0], am1, am2, P[0] - A[0], P[0] - B[0], 0.5 * oop);
+            form_E(&Ey_[0], am1, am2, P[1] - A[1], P[1] - B[1], 0.5 * oop);
+            form_E(&Ez_[0], am1, am2, P[2] - A[2], P[2] - B[2], 0.5 * oop);
+
+            std::fill(W_.begin(), W_.end(), 0.0);
+
+            if (ncell == 0) {
+                add_sites(L, K, p, P, nsite, &field.x_[0], &field.y_[0], &field.z_[0],
+                          &field.m_[0], nsite, false);
+            }
+            else {
+                // => Cells: far ones as point multipoles, the sites of the rest directly <= //
+                const double scale = std::pow(M_PI * oop, 1.5) * std::fabs(c1 * c2) * Kab;
+                const int ncm = ntuv(Kc);
+                int nacc = 0;
+                int run = -1;
+                for (int c = 0; c <= ncell; c++) {
+                    bool far = false;
+                    if (c < ncell) {
+                        double dx = P[0] - field.cx_[c];
+                        double dy = P[1] - field.cy_[c];
+                        double dz = P[2] - field.cz_[c];
+                        double r = field.cr_[c];
+                        double d = std::sqrt(dx * dx + dy * dy + dz * dz) - r;
+                        if (d > 0.0 && p * d * d >= Tcell && (field.cell_last_[c] - field.cell_first_[c]) * site_cost >= cell_cost) {
+                            // Remainder of the expansion of the order-j site moments,
+                            // S_j (r/d)^(Kc+1-j) / d^(j+1)
+                            double err = 0.0;
+                            if (r > 0.0) {
+                                double term = 1.0 / d;
+                                for (int k = 0; k <= Kc; k++)
+                                    term *= r / d;
+                                for (int j = 0; j <= K; j++, term /= r)
+                                    err += field.cs_[(size_t) j * ncell + c] * term;
+                            }
+                            far = (scale * err <= tolerance);
+                        }
+                    }
+                    if (far || c == ncell) {
+                        if (run >= 0) {
+                            int first = field.cell_first_[run];
+                            int n = field.cell_last_[c - 1] - first;
+                            add_sites(L, K, p, P, n, &field.x_[first], &field.y_[first], &field.z_[first],
+                                      &field.m_[first], nsite, false);
+                            run = -1;
+                        }
+                        if (far) {
+                            gx_[nacc] = field.cx_[c];
+                            gy_[nacc] = field.cy_[c];
+                            gz_[nacc] = field.cz_[c];
+                            for (int k = 0; k < ncm; k++)
+                                gm_[(size_t) k * ncell + nacc] = field.cm_[(size_t) k * ncell + c];
+                            nacc++;
+                        }
+                    }
+                    else if (run < 0) {
+                        run = c;
+                    }
+                }
+                if (nacc)
+                    add_sites(L, Kc, p, P, nacc, &gx_[0], &gy_[0], &gz_[0], &gm_[0], ncell, true);
+            }
+
+            // => Contraction with the Hermite expansion of the pair <= //
+            const double* W = &W_[0];
+            int ao12 = 0;
+            for (int ii = 0; ii <= am1; ii++) {
+                int l1 = am1 - ii;
+                for (int jj = 0; jj <= ii; jj++) {
+                    int m1 = ii - jj;
+                    int n1 = jj;
+                    for (int kk = 0; kk <= am2; kk++) {
+                        int l2 = am2 - kk;
+                        for (int ll = 0; ll <= kk; ll++) {
+                            int m2 = kk - ll;
+                            int n2 = ll;
+                            const double* ex = &Ex_[(l1 * (am2 + 1) + l2) * L1];
+                            const double* ey = &Ey_[(m1 * (am2 + 1) + m2) * L1];
+                            const double* ez = &Ez_[(n1 * (am2 + 1) + n2) * L1];
+                            double v = 0.0;
+                            for (int t = 0; t <= l1 + l2; t++) {
+                                for (int u = 0; u <= m1 + m2; u++) {
+                                    double exy = ex[t] * ey[u];
+                                    for (int w = 0; w <= n1 + n2; w++)
+                                        v += exy * ez[w] * W[hindex(t, u, w)];
+                                }
+                            }
+                            buffer[ao12++] += pref * v;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// The engine only supports segmented basis sets
+void MultipoleFieldEngine::contract_pair(const MultipoleField& field, const GaussianShell& s1,
+                                         const GaussianShell& s2, const double* D, double* values)
+{
+    if (!field.built())
+        throw PSIEXCEPTION("MultipoleFieldEngine: the field must be built first.");
+
+    const int am1 = s1.am();
+    const int am2 = s2.am();
+    const int L = am1 + am2;
+    const int L1 = L + 1;
+    const int K = field.order_;
+    const int nsite = field.nsite();
+    const int nprim1 = s1.nprimitive();
+    const int nprim2 = s2.nprimitive();
+
+    if (nsite == 0) return;
+
+    const size_t nE = (size_t) (am1 + 1) * (am2 + 1) * L1;
+    if (Ex_.size() < nE) {
+        Ex_.resize(nE);
+        Ey_.resize(nE);
+        Ez_.resize(nE);
+    }
+    W_.resize(ntuv(L));
+
+    const Vector3& A = s1.center();
+    const Vector3& B = s2.center();
+    double AB2 = (A[0] - B[0]) * (A[0] - B[0]) + (A[1] - B[1]) * (A[1] - B[1]) + (A[2] - B[2]) * (A[2] - B[2]);
+
+    for (int p1 = 0; p1 < nprim1; ++p1) {
+        double a1 = s1.exp(p1);
+        double c1 = s1.coef(p1);
+        for (int p2 = 0; p2 < nprim2; ++p2) {
+            double a2 = s2.exp(p2);
+            double c2 = s2.coef(p2);
+            double p = a1 + a2;
+            double oop = 1.0 / p;
+
+            double P[3];
+            P[0] = (a1 * A[0] + a2 * B[0]) * oop;
+            P[1] = (a1 * A[1] + a2 * B[1]) * oop;
+            P[2] = (a1 * A[2] + a2 * B[2]) * oop;
+
+            double Kab = std::exp(-a1 * a2 * AB2 * oop);
+            double pref = 2.0 * M_PI * oop * c1 * c2 * Kab;
+
+            form_E(&Ex_[0], am1, am2, P[0] - A[0], P[0] - B[0], 0.5 * oop);
+            form_E(&Ey_[0], am1, am2, P[1] - A[1], P[1] - B[1], 0.5 * oop);
+            form_E(&Ez_[0], am1, am2, P[2] - A[2], P[2] - B[2], 0.5 * oop);
+
+            // => Hermite density of the pair <= //
+            std::fill(W_.begin(), W_.end(), 0.0);
+            double* W = &W_[0];
+            int ao12 = 0;
+            for (int ii = 0; ii <= am1; ii++) {
+                int l1 = am1 - ii;
+                for (int jj = 0; jj <= ii; jj++) {
+                    int m1 = ii - jj;
+                    int n1 = jj;
+                    for (int kk = 0; kk <= am2; kk++) {
+                        int l2 = am2 - kk;
+                        for (int ll = 0; ll <= kk; ll++) {
+                            int m2 = kk - ll;
+                            int n2 = ll;
+                            double d = pref * D[ao12++];
+                            if (d == 0.0) continue;
+                            const double* ex = &Ex_[(l1 * (am2 + 1) + l2) * L1];
+                            const double* ey = &Ey_[(m1 * (am2 + 1) + m2) * L1];
+                            const double* ez = &Ez_[(n1 * (am2 + 1) + n2) * L1];
+                            for (int t = 0; t <= l1 + l2; t++) {
+                                for (int u = 0; u <= m1 + m2; u++) {
+                                    double exy = d * ex[t] * ey[u];
+                                    for (int w = 0; w <= n1 + n2; w++)
+                                        W[hindex(t, u, w)] += exy * ez[w];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            contract_sites(L, K, p, P, nsite, &field.x_[0], &field.y_[0], &field.z_[0],
+                           &field.m_[0], nsite, &field.index_[0], values);
+        }
+    }
+}
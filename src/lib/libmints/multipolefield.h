@@ -0,0 +1,180 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_multipolefield_h_
+#define _psi_src_lib_libmints_multipolefield_h_
+
+#include <vector>
+#include <cstddef>
+
+namespace psi {
+
+class GaussianShell;
+class Tabulated_Fjt;
+
+/// Sites per vectorized batch of the field kernels
+#define MULTIPOLE_FIELD_BATCH 32
+/// Fewest sites for which the field is divided into screening cells
+#define MULTIPOLE_FIELD_MIN_SITES 256
+/// Average number of sites per screening cell
+#define MULTIPOLE_FIELD_CELL_SITES 64
+/// Default order of the cell multipoles
+#define MULTIPOLE_FIELD_CELL_ORDER 8
+/// Default bound on the error of a cell multipole expansion
+#define MULTIPOLE_FIELD_TOLERANCE 1.0E-12
+
+/*! \ingroup MINTS
+ *  \class MultipoleField
+ *  \brief A field of point multipoles for one-electron potential integrals.
+ *
+ * Each site at C carries Cartesian moments m_k, |k| <= order, given in the
+ * usual Cartesian ordering (1; x y z; xx xy xz yy yz zz; ...).  The field
+ * stands for the operator
+ *
+ *      sum_C sum_k m_k d^|k| / dC^k  1 / |r - C|
+ *
+ * so a point charge Z acting on an electron has m_0 = -Z.
+ *
+ * build() bins the sites into cubic cells and forms the multipoles of each
+ * cell about its center.  A cell whose sites are all far from a primitive
+ * pair, both in the sense that the Boys function has reached its
+ * asymptotic form and that the cell expansion is converged to the
+ * tolerance, is then handled as one point multipole.
+ */
+class MultipoleField
+{
+    friend class MultipoleFieldEngine;
+
+    int order_;
+    int nmoment_;
+    int cell_order_;
+    /// Order of the cell expansions, at least order_
+    int cell_K_;
+    double tolerance_;
+
+    /// Site moments as added, site-major
+    std::vector<double> site_m_;
+    /// Sites in build order: coordinates, then moments moment-major with
+    /// stride nsite, with the sign (-1)^|k| of the derivative folded in
+    std::vector<double> x_, y_, z_, m_;
+    /// Original index of each site
+    std::vector<int> index_;
+
+    /// Cells: [first, last) sites, center, radius, moments (order
+    /// cell_order_, moment-major with stride ncell) and the strength of the
+    /// site moments of each order, sum |m_k| for |k| = j
+    std::vector<int> cell_first_, cell_last_;
+    std::vector<double> cx_, cy_, cz_, cr_, cm_, cs_;
+
+    bool built_;
+
+public:
+    /// A field of sites carrying moments through order
+    MultipoleField(int order = 0);
+
+    /// Removes all sites
+    void clear();
+    /// Adds a site at (x,y,z) with nmoment() moments m
+    void add_site(double x, double y, double z, const double* m);
+    /// Adds a site carrying only the moment m0 (any order)
+    void add_charge(double m0, double x, double y, double z);
+
+    /// Order of the cell multipoles, < 0 turns the cells off
+    void set_cell_order(int order) { cell_order_ = order; built_ = false; }
+    /// Bound on the error of a cell expansion for a unit pair
+    void set_tolerance(double tolerance) { tolerance_ = tolerance; }
+
+    /// Sorts the sites into cells; called by the engines when needed
+    void build();
+
+    int order() const { return order_; }
+    int nmoment() const { return nmoment_; }
+    int nsite() const { return (int) x_.size(); }
+    int ncell() const { return (int) cell_first_.size(); }
+    int cell_order() const { return cell_order_; }
+    double tolerance() const { return tolerance_; }
+    bool built() const { return built_; }
+};
+
+/*! \ingroup MINTS
+ *  \class MultipoleFieldEngine
+ *  \brief McMurchie-Davidson integrals of a MultipoleField over shell pairs.
+ *
+ * For each primitive pair the Hermite integrals R_tuv of all sites are
+ * generated together, a batch of MULTIPOLE_FIELD_BATCH sites per vectorized
+ * loop, and summed into W_tuv before the single contraction with the
+ * Hermite expansion coefficients of the pair.  The engine holds only
+ * scratch space; use one per thread on a shared (built) field.
+ */
+class MultipoleFieldEngine
+{
+    const Tabulated_Fjt* boys_;
+
+    /// Hermite expansion coefficients E^{ij}_t in x, y and z
+    std::vector<double> Ex_, Ey_, Ez_;
+    /// Sum of the site Hermite integrals of the current pair, and the
+    /// Hermite density of contract_pair
+    std::vector<double> W_;
+    /// Hermite integrals of a batch: two levels of the recursion
+    std::vector<double> R0_, R1_;
+    /// Boys values and seeds of a batch
+    std::vector<double> T_, U_, F_, S_;
+    std::vector<int> near_;
+    std::vector<double> X_, Y_, Z_;
+    /// Accepted cells of the current pair, gathered like sites
+    std::vector<double> gx_, gy_, gz_, gm_;
+    /// Largest T for each order below which the Boys function is not yet asymptotic
+    std::vector<double> Tasym_;
+
+    size_t nsite_direct_;
+    size_t ncell_multipole_;
+
+    void form_E(double* E, int am1, int am2, double PA, double PB, double oo2p);
+    double asymptotic_T(int N);
+    const double* hermite(int N, double p, const double* P, int n,
+                          const double* x, const double* y, const double* z, bool point);
+    void add_sites(int L, int K, double p, const double* P, int n,
+                   const double* x, const double* y, const double* z,
+                   const double* m, size_t mstride, bool point);
+    void contract_sites(int L, int K, double p, const double* P, int n,
+                        const double* x, const double* y, const double* z,
+                        const double* m, size_t mstride, const int* index, double* values);
+
+public:
+    MultipoleFieldEngine();
+
+    /// Cartesian integrals of the field over (s1|s2) into buffer (ncart1 x ncart2)
+    void compute_pair(const MultipoleField& field, const GaussianShell& s1, const GaussianShell& s2, double* buffer);
+    /// values[site] += sum_ab D_ab (a|site|b) for the Cartesian block D (ncart1 x ncart2),
+    /// with the sites in the order they were added
+    void contract_pair(const MultipoleField& field, const GaussianShell& s1, const GaussianShell& s2,
+                       const double* D, double* values);
+
+    /// Site-primitive pair interactions evaluated directly so far
+    size_t nsite_direct() const { return nsite_direct_; }
+    /// Cell-primitive pair interactions evaluated as multipoles so far
+    size_t ncell_multipole() const { return ncell_multipole_; }
+};
+
+}
+
+#endif
@@ -1031,8 +1031,6 @@ void OEProp::compute_esp_over_grid()
 {
     boost::shared_ptr<Molecule> mol = basisset_->molecule();
 
-    boost::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
     outfile->Printf( "\n Electrostatic potential computed on the grid and written to grid_esp.dat\n");
 
     SharedMatrix Dtot = wfn_->Da_subset("CartAO");
@@ -1042,29 +1040,44 @@ void OEProp::compute_esp_over_grid()
         Dtot->add(wfn_->Db_subset("CartAO"));
     }
 
-    int nao = basisset_->nao();
-    SharedMatrix ints(new Matrix("Ex integrals", nao, nao));
-
-    FILE *gridout = fopen("grid_esp.dat", "w");
-    if(!gridout)
-        throw PSIEXCEPTION("Unable to write to grid_esp.dat");
+    // Gather the grid, then get the electronic potential at all points in one pass
+    std::vector<Vector3> points;
     GridIterator griditer("grid.dat");
     for(griditer.first(); !griditer.last(); griditer.next()){
         Vector3 origin(griditer.gridpoints());
         if(mol->units() == Molecule::Angstrom)
             origin /= pc_bohr2angstroms;
-        ints->zero();
-        epot->compute(ints, origin);
-        double Velec = Dtot->vector_dot(ints);
+        points.push_back(origin);
+    }
+    int npoint = points.size();
+
+    SharedMatrix Zxyz(new Matrix("Grid points (Z,x,y,z)", npoint, 4));
+    double** Zxyzp = Zxyz->pointer();
+    for(int n=0; n < npoint; n++) {
+        Zxyzp[n][0] = 1.0;
+        Zxyzp[n][1] = points[n][0];
+        Zxyzp[n][2] = points[n][1];
+        Zxyzp[n][3] = points[n][2];
+    }
+
+    boost::shared_ptr<PotentialInt> pot(static_cast<PotentialInt*>(integral_->ao_potential()));
+    pot->set_charge_field(Zxyz);
+    std::vector<double> Velec(npoint, 0.0);
+    pot->compute_potentials(Dtot, npoint ? &Velec[0] : 0);
+
+    FILE *gridout = fopen("grid_esp.dat", "w");
+    if(!gridout)
+        throw PSIEXCEPTION("Unable to write to grid_esp.dat");
+    int natom = mol->natom();
+    for(int n=0; n < npoint; n++) {
         double Vnuc = 0.0;
-        int natom = mol->natom();
         for(int i=0; i < natom; i++) {
-            Vector3 dR = origin - mol->xyz(i);
+            Vector3 dR = points[n] - mol->xyz(i);
             double r = dR.norm();
             if(r > 1.0E-8)
                 Vnuc += mol->Z(i)/r;
         }
-        fprintf(gridout, "%16.10f\n", Velec+Vnuc);
+        fprintf(gridout, "%16.10f\n", Velec[n]+Vnuc);
     }
     fclose(gridout);
 }
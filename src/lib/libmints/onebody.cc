@@ -155,6 +155,13 @@ void OneBodyAOInt::normalize_am(const GaussianShell& /*s1*/, const GaussianShell
 
 void OneBodyAOInt::pure_transform(const GaussianShell& s1,
                                   const GaussianShell& s2, int chunks)
+{
+    pure_transform(s1, s2, chunks, buffer_, target_, tformbuf_);
+}
+
+void OneBodyAOInt::pure_transform(const GaussianShell& s1,
+                                  const GaussianShell& s2, int chunks,
+                                  double* buffer, double* target_buf, double* tformbuf) const
 {
     for (int chunk=0; chunk<chunks; ++chunk) {
         const int am1 = s1.am();
@@ -173,9 +180,9 @@ void OneBodyAOInt::pure_transform(const GaussianShell& s1,
         // Memory pointers that aid in transform
         double *source1, *target1;
         double *source2, *target2;
-        double *source = buffer_ + (chunk*ncart12);
-        double *target = target_;
-        double *tmpbuf = tformbuf_;
+        double *source = buffer + (chunk*ncart12);
+        double *target = target_buf;
+        double *tmpbuf = tformbuf;
 
         int transform_index = 2*is_pure1 + is_pure2;
         switch(transform_index) {
@@ -207,7 +214,7 @@ void OneBodyAOInt::pure_transform(const GaussianShell& s1,
         }
 
         if (transform_index) {
-            memcpy(buffer_+(chunk*nbf12), target_, sizeof(double) * nbf12);
+            memcpy(buffer+(chunk*nbf12), target_buf, sizeof(double) * nbf12);
         }
     }
 }
@@ -81,6 +81,9 @@ protected:
 
     void set_chunks(int nchunk) { nchunk_ = nchunk; }
     void pure_transform(const GaussianShell&, const GaussianShell&, int=1);
+    /// Pure transform of chunks in buffer, using target and tformbuf as scratch (for threaded drivers)
+    void pure_transform(const GaussianShell&, const GaussianShell&, int chunks,
+                        double* buffer, double* target, double* tformbuf) const;
 
     /// Normalize Cartesian functions based on angular momentum
     void normalize_am(const GaussianShell&, const GaussianShell&, int nchunk=1);
@@ -131,7 +134,7 @@ public:
      * Computes all integrals and stores them in result
      * @param result Shared matrix object that will hold the results.
      */
-    void compute(SharedMatrix& result);
+    virtual void compute(SharedMatrix& result);
     /*! @} */
 
     /// Computes all integrals and stores them in result by default this method throws
@@ -26,6 +26,7 @@
 #include <libmints/integral.h>
 #include <libmints/wavefunction.h>   // for df
 #include <libmints/osrecur.h>
+#include <libmints/fjt.h>
 #include <exception.h>
 
 using namespace psi;
@@ -194,6 +195,8 @@ ObaraSaikaTwoCenterEFPRecursion::ObaraSaikaTwoCenterEFPRecursion(int max_am1, in
     xzz_ = init_box(size_, size_, max_am1_ + max_am2_ + 1);
     yzz_ = init_box(size_, size_, max_am1_ + max_am2_ + 1);
     xyz_ = init_box(size_, size_, max_am1_ + max_am2_ + 1);
+
+    boys_ = &Tabulated_Fjt::shared();
 }
 
 ObaraSaikaTwoCenterEFPRecursion::~ObaraSaikaTwoCenterEFPRecursion()
@@ -220,47 +223,9 @@ ObaraSaikaTwoCenterEFPRecursion::~ObaraSaikaTwoCenterEFPRecursion()
     free_box(xyz_, size_, size_);
 }
 
-#define EPS 1.0e-17
-
 void ObaraSaikaTwoCenterEFPRecursion::calculate_f(double *F, int n, double t)
 {
-    int i, m;
-    int m2;
-    double t2;
-    double num;
-    double sum;
-    double term1;
-    static double K = 1.0/M_2_SQRTPI;
-    double et;
-
-
-    if (t>20.0){
-        t2 = 2*t;
-        et = exp(-t);
-        t = sqrt(t);
-        F[0] = K*erf(t)/t;
-        for(m=0; m<=n-1; m++){
-            F[m+1] = ((2*m + 1)*F[m] - et)/(t2);
-        }
-    }
-    else {
-        et = exp(-t);
-        t2 = 2*t;
-        m2 = 2*n;
-        num = df[m2];
-        i=0;
-        sum = 1.0/(m2+1);
-        do{
-            i++;
-            num = num*t2;
-            term1 = num/df[m2+2*i+2];
-            sum += term1;
-        } while (fabs(term1) > EPS && i < MAX_FAC);
-        F[n] = sum*et;
-        for(m=n-1;m>=0;m--){
-            F[m] = (t2*F[m+1] + et)/(2*m+1);
-        }
-    }
+    boys_->evaluate(n, 1, &t, F);
 }
 
 void ObaraSaikaTwoCenterEFPRecursion::compute(double PA[3], double PB[3], double PC[3], double zeta, int am1, int am2)
@@ -922,54 +887,20 @@ ObaraSaikaTwoCenterVIRecursion::ObaraSaikaTwoCenterVIRecursion(int max_am1, int
     size_ += 1;
     size_ = (size_-1)*size_*(size_+1)+1;
     vi_ = init_box(size_, size_, max_am1_ + max_am2_ + 1);
+
+    boys_ = &Tabulated_Fjt::shared();
+    F_ = new double[max_am1_ + max_am2_ + 1];
 }
 
 ObaraSaikaTwoCenterVIRecursion::~ObaraSaikaTwoCenterVIRecursion()
 {
     free_box(vi_, size_, size_);
+    delete[] F_;
 }
 
-#define EPS 1.0e-17
-
 void ObaraSaikaTwoCenterVIRecursion::calculate_f(double *F, int n, double t)
 {
-    int i, m;
-    int m2;
-    double t2;
-    double num;
-    double sum;
-    double term1;
-    static double K = 1.0/M_2_SQRTPI;
-    double et;
-
-
-    if (t>20.0){
-        t2 = 2*t;
-        et = exp(-t);
-        t = sqrt(t);
-        F[0] = K*erf(t)/t;
-        for(m=0; m<=n-1; m++){
-            F[m+1] = ((2*m + 1)*F[m] - et)/(t2);
-        }
-    }
-    else {
-        et = exp(-t);
-        t2 = 2*t;
-        m2 = 2*n;
-        num = df[m2];
-        i=0;
-        sum = 1.0/(m2+1);
-        do{
-            i++;
-            num = num*t2;
-            term1 = num/df[m2+2*i+2];
-            sum += term1;
-        } while (fabs(term1) > EPS && i < MAX_FAC);
-        F[n] = sum*et;
-        for(m=n-1;m>=0;m--){
-            F[m] = (t2*F[m+1] + et)/(2*m+1);
-        }
-    }
+    boys_->evaluate(n, 1, &t, F);
 }
 
 void ObaraSaikaTwoCenterVIRecursion::compute(double PA[3], double PB[3], double PC[3], double zeta, int am1, int am2)
@@ -990,7 +921,7 @@ void ObaraSaikaTwoCenterVIRecursion::compute(double PA[3], double PB[3], double
     double tmp = sqrt(zeta) * M_2_SQRTPI;
     // U from A21
     double u = zeta * (PC[0] * PC[0] + PC[1] * PC[1] + PC[2] * PC[2]);
-    double *F = new double[mmax+1];
+    double *F = F_;
 
     // Form Fm(U) from A20
     calculate_f(F, mmax, u);
@@ -1118,8 +1049,6 @@ void ObaraSaikaTwoCenterVIRecursion::compute(double PA[3], double PB[3], double
         }
     }
 
-    delete[] F;
-
 }
 
 void ObaraSaikaTwoCenterVIRecursion::compute_erf(double PA[3], double PB[3], double PC[3], double zeta, int am1, int am2, double zetam)
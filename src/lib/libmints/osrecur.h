@@ -25,6 +25,8 @@
 
 namespace psi {
 
+class Tabulated_Fjt;
+
 /*! \ingroup MINTS
  *  \class ObaraSaikaTwoCenterRecursion
  *  \brief Generic Obara and Saika recursion object.
@@ -103,6 +105,11 @@ protected:
 
     double ***vi_;
 
+    /// Shared Boys function table
+    const Tabulated_Fjt* boys_;
+    /// F_m(U) for compute()
+    double *F_;
+
     // Forms Fm(U) from A20 (OS 1986)
     void calculate_f(double *F, int n, double t);
 
@@ -294,6 +301,9 @@ protected:
     double*** yzz_;
     double*** zzz_;
 
+    /// Shared Boys function table
+    const Tabulated_Fjt* boys_;
+
     // Forms Fm(U) from A20 (OS 1986)
     void calculate_f(double *F, int n, double t);
 
@@ -25,8 +25,14 @@
 #include "mints.h"
 #include "cdsalclist.h"
 #include "potential.h"
+#include "multipolefield.h"
 
 #include <physconst.h>
+#include <psi4-dec.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 
@@ -37,8 +43,13 @@ using namespace psi;
 
 // Initialize potential_recur_ to +1 basis set angular momentum
 PotentialInt::PotentialInt(std::vector<SphericalTransform>& st, boost::shared_ptr<BasisSet> bs1, boost::shared_ptr<BasisSet> bs2, int deriv) :
-    OneBodyAOInt(st, bs1, bs2, deriv)
+    OneBodyAOInt(st, bs1, bs2, deriv), field_external_(false), field_current_(false),
+    screening_order_(MULTIPOLE_FIELD_CELL_ORDER), screening_tolerance_(MULTIPOLE_FIELD_TOLERANCE),
+    engine_(new MultipoleFieldEngine)
 {
+    if (!Process::environment.options.get_global("POTENTIAL_INTS_SCREENING").to_integer())
+        screening_order_ = -1;
+
     if (deriv == 0)
         potential_recur_ = new ObaraSaikaTwoCenterVIRecursion(bs1->max_am()+1, bs2->max_am()+1);
     else if (deriv == 1)
@@ -86,110 +97,202 @@ PotentialInt::~PotentialInt()
 {
     delete[] buffer_;
     delete potential_recur_;
+    delete engine_;
 }
 
-// The engine only supports segmented basis sets
-void PotentialInt::compute_pair(const GaussianShell& s1,
-                                const GaussianShell& s2)
+void PotentialInt::set_multipole_field(boost::shared_ptr<MultipoleField> field)
 {
-    int ao12;
-    int am1 = s1.am();
-    int am2 = s2.am();
-    int nprim1 = s1.nprimitive();
-    int nprim2 = s2.nprimitive();
-    double A[3], B[3];
-    A[0] = s1.center()[0];
-    A[1] = s1.center()[1];
-    A[2] = s1.center()[2];
-    B[0] = s2.center()[0];
-    B[1] = s2.center()[1];
-    B[2] = s2.center()[2];
+    field_ = field;
+    field_external_ = true;
+    field_current_ = false;
+    field_->set_cell_order(screening_order_);
+    field_->set_tolerance(screening_tolerance_);
+}
 
-    int izm = 1;
-    int iym = am1 + 1;
-    int ixm = iym * iym;
-    int jzm = 1;
-    int jym = am2 + 1;
-    int jxm = jym * jym;
+void PotentialInt::set_screening(int order, double tolerance)
+{
+    screening_order_ = order;
+    screening_tolerance_ = tolerance;
+    if (field_external_) {
+        if (field_->cell_order() != order)
+            field_->set_cell_order(order);
+        field_->set_tolerance(tolerance);
+    }
+    else {
+        field_.reset();
+    }
+    field_current_ = false;
+}
 
-    // compute intermediates
-    double AB2 = 0.0;
-    AB2 += (A[0] - B[0]) * (A[0] - B[0]);
-    AB2 += (A[1] - B[1]) * (A[1] - B[1]);
-    AB2 += (A[2] - B[2]) * (A[2] - B[2]);
+void PotentialInt::update_field()
+{
+    field_current_ = true;
+    if (field_external_) {
+        if (!field_->built())
+            field_->build();
+        return;
+    }
 
-    memset(buffer_, 0, s1.ncartesian() * s2.ncartesian() * sizeof(double));
+    int ncharge = Zxyz_->rowspi()[0];
+    size_t n = 4 * (size_t) ncharge;
+    const double* Zxyzp = ncharge ? Zxyz_->pointer()[0] : 0;
+
+    if (field_ && field_Zxyz_.size() == n &&
+        (n == 0 || ::memcmp(&field_Zxyz_[0], Zxyzp, n * sizeof(double)) == 0))
+        return;
+
+    field_Zxyz_.assign(Zxyzp, Zxyzp + n);
+    field_ = boost::shared_ptr<MultipoleField>(new MultipoleField(0));
+    field_->set_cell_order(screening_order_);
+    field_->set_tolerance(screening_tolerance_);
+    // A charge Z attracts the electron: the moment is -Z
+    for (int atom = 0; atom < ncharge; ++atom)
+        field_->add_charge(-Zxyzp[4*atom], Zxyzp[4*atom+1], Zxyzp[4*atom+2], Zxyzp[4*atom+3]);
+    field_->build();
+}
 
-    double ***vi = potential_recur_->vi();
+void PotentialInt::compute_pair(const GaussianShell& s1,
+                                const GaussianShell& s2)
+{
+    // Only the first pair after set_charge_field(), charge_field() or
+    // compute() compares the charges, not every pair
+    if (!field_current_)
+        update_field();
+    engine_->compute_pair(*field_, s1, s2, buffer_);
+}
 
-    double** Zxyzp = Zxyz_->pointer();
-    int ncharge = Zxyz_->rowspi()[0];
+void PotentialInt::compute(SharedMatrix& result)
+{
+    update_field();
 
-    for (int p1=0; p1<nprim1; ++p1) {
-        double a1 = s1.exp(p1);
-        double c1 = s1.coef(p1);
-        for (int p2=0; p2<nprim2; ++p2) {
-            double a2 = s2.exp(p2);
-            double c2 = s2.coef(p2);
-            double gamma = a1 + a2;
-            double oog = 1.0/gamma;
+    // Same basis on both sides: the integrals are symmetric, do i >= j only
+    const bool symmetric = (bs1_ == bs2_);
+    const int ns1 = bs1_->nshell();
+    const int ns2 = bs2_->nshell();
 
-            double PA[3], PB[3];
-            double P[3];
+    std::vector<int> offset1(ns1), offset2(ns2);
+    for (int i = 0, off = 0; i < ns1; ++i) {
+        offset1[i] = off;
+        off += force_cartesian_ ? bs1_->shell(i).ncartesian() : bs1_->shell(i).nfunction();
+    }
+    for (int j = 0, off = 0; j < ns2; ++j) {
+        offset2[j] = off;
+        off += force_cartesian_ ? bs2_->shell(j).ncartesian() : bs2_->shell(j).nfunction();
+    }
 
-            P[0] = (a1*A[0] + a2*B[0])*oog;
-            P[1] = (a1*A[1] + a2*B[1])*oog;
-            P[2] = (a1*A[2] + a2*B[2])*oog;
-            PA[0] = P[0] - A[0];
-            PA[1] = P[1] - A[1];
-            PA[2] = P[2] - A[2];
-            PB[0] = P[0] - B[0];
-            PB[1] = P[1] - B[1];
-            PB[2] = P[2] - B[2];
+    std::vector<std::pair<int, int> > pairs;
+    for (int i = 0; i < ns1; ++i)
+        for (int j = 0; j < (symmetric ? i + 1 : ns2); ++j)
+            pairs.push_back(std::make_pair(i, j));
+    const long int npair = pairs.size();
 
-            double over_pf = exp(-a1*a2*AB2*oog) * sqrt(M_PI*oog) * M_PI * oog * c1 * c2;
+    const size_t maxsize = INT_NCART(bs1_->max_am()) * INT_NCART(bs2_->max_am());
+    double** Rp = result->pointer();
 
-            // Loop over atoms of basis set 1 (only works if bs1_ and bs2_ are on the same
-            // molecule)
-            for (int atom=0; atom<ncharge; ++atom) {
-                double PC[3];
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
 
-                double Z = Zxyzp[atom][0];
+#pragma omp parallel num_threads(nthread)
+    {
+        MultipoleFieldEngine engine;
+        std::vector<double> buffer(maxsize), target(maxsize), tformbuf(maxsize);
+
+#pragma omp for schedule(dynamic)
+        for (long int ij = 0; ij < npair; ++ij) {
+            const int i = pairs[ij].first;
+            const int j = pairs[ij].second;
+            const GaussianShell& s1 = bs1_->shell(i);
+            const GaussianShell& s2 = bs2_->shell(j);
+
+            engine.compute_pair(*field_, s1, s2, &buffer[0]);
+            if (!force_cartesian_)
+                pure_transform(s1, s2, 1, &buffer[0], &target[0], &tformbuf[0]);
+
+            const int ni = force_cartesian_ ? s1.ncartesian() : s1.nfunction();
+            const int nj = force_cartesian_ ? s2.ncartesian() : s2.nfunction();
+            const int io = offset1[i];
+            const int jo = offset2[j];
+            const double* location = &buffer[0];
+            for (int p = 0; p < ni; ++p) {
+                for (int q = 0; q < nj; ++q, ++location) {
+                    Rp[io+p][jo+q] += *location;
+                    if (symmetric && i != j)
+                        Rp[jo+q][io+p] += *location;
+                }
+            }
+        }
+    }
 
-                PC[0] = P[0] - Zxyzp[atom][1];
-                PC[1] = P[1] - Zxyzp[atom][2];
-                PC[2] = P[2] - Zxyzp[atom][3];
+    // The caller may edit Zxyz_ in place before the next pass
+    field_current_ = false;
+}
 
-                // Do recursion
-                potential_recur_->compute(PA, PB, PC, gamma, am1, am2);
+void PotentialInt::compute_potentials(SharedMatrix D, double* values)
+{
+    update_field();
 
-                ao12 = 0;
-                for(int ii = 0; ii <= am1; ii++) {
-                    int l1 = am1 - ii;
-                    for(int jj = 0; jj <= ii; jj++) {
-                        int m1 = ii - jj;
-                        int n1 = jj;
-                        /*--- create all am components of sj ---*/
-                        for(int kk = 0; kk <= am2; kk++) {
-                            int l2 = am2 - kk;
-                            for(int ll = 0; ll <= kk; ll++) {
-                                int m2 = kk - ll;
-                                int n2 = ll;
+    const bool symmetric = (bs1_ == bs2_);
+    const int ns1 = bs1_->nshell();
+    const int ns2 = bs2_->nshell();
+    const int nsite = field_->nsite();
 
-                                // Compute location in the recursion
-                                int iind = l1 * ixm + m1 * iym + n1 * izm;
-                                int jind = l2 * jxm + m2 * jym + n2 * jzm;
+    std::vector<int> offset1(ns1), offset2(ns2);
+    for (int i = 0, off = 0; i < ns1; ++i) {
+        offset1[i] = off;
+        off += bs1_->shell(i).ncartesian();
+    }
+    for (int j = 0, off = 0; j < ns2; ++j) {
+        offset2[j] = off;
+        off += bs2_->shell(j).ncartesian();
+    }
 
-                                buffer_[ao12++] += -vi[iind][jind][0] * over_pf * Z;
+    std::vector<std::pair<int, int> > pairs;
+    for (int i = 0; i < ns1; ++i)
+        for (int j = 0; j < (symmetric ? i + 1 : ns2); ++j)
+            pairs.push_back(std::make_pair(i, j));
+    const long int npair = pairs.size();
 
-//                                outfile->Printf( "ao12=%d, vi[%d][%d][0] = %20.14f, over_pf = %20.14f, Z = %f\n", ao12-1, iind, jind, vi[iind][jind][0], over_pf, Z);
-                            }
-                        }
-                    }
-                }
-            }
+    const size_t maxsize = INT_NCART(bs1_->max_am()) * INT_NCART(bs2_->max_am());
+    double** Dp = D->pointer();
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+
+#pragma omp parallel num_threads(nthread)
+    {
+        MultipoleFieldEngine engine;
+        std::vector<double> Dblock(maxsize);
+        std::vector<double> local(nsite, 0.0);
+
+#pragma omp for schedule(dynamic)
+        for (long int ij = 0; ij < npair; ++ij) {
+            const int i = pairs[ij].first;
+            const int j = pairs[ij].second;
+            const GaussianShell& s1 = bs1_->shell(i);
+            const GaussianShell& s2 = bs2_->shell(j);
+            const int ni = s1.ncartesian();
+            const int nj = s2.ncartesian();
+            const int io = offset1[i];
+            const int jo = offset2[j];
+
+            // The (j,i) block enters through D_ba
+            for (int p = 0, pq = 0; p < ni; ++p)
+                for (int q = 0; q < nj; ++q, ++pq)
+                    Dblock[pq] = Dp[io+p][jo+q] + (symmetric && i != j ? Dp[jo+q][io+p] : 0.0);
+
+            engine.contract_pair(*field_, s1, s2, &Dblock[0], nsite ? &local[0] : 0);
         }
+
+#pragma omp critical
+        for (int site = 0; site < nsite; ++site)
+            values[site] += local[site];
     }
+
+    field_current_ = false;
 }
 
 void PotentialInt::compute_pair_deriv1(const GaussianShell& s1, const GaussianShell& s2)
@@ -39,11 +39,18 @@ namespace psi {
     class SphericalTransform;
     class OneBodySOInt;
     class CdSalcList;
+    class MultipoleField;
+    class MultipoleFieldEngine;
 
 /*! \ingroup MINTS
  *  \class PotentialInt
  *  \brief Computes potential integrals.
  * Use an IntegralFactory to create this object.
+ *
+ * The integrals over the charge field (or a MultipoleField set with
+ * set_multipole_field) are formed by MultipoleFieldEngine, all sites of a
+ * shell pair at once; the derivative integrals use the Obara-Saika
+ * recursion, one charge at a time.
  */
 class PotentialInt : public OneBodyAOInt
 {
@@ -60,6 +67,22 @@ protected:
     /// Matrix of coordinates/charges of partial charges
     SharedMatrix Zxyz_;
 
+    /// The field seen by the engine, built from Zxyz_ unless set externally
+    boost::shared_ptr<MultipoleField> field_;
+    /// Copy of Zxyz_ at the last field build; the callers edit Zxyz_ in place
+    std::vector<double> field_Zxyz_;
+    bool field_external_;
+    /// Has field_ been checked against Zxyz_ in the current pass over the shell pairs?
+    bool field_current_;
+    /// Cell screening of the field (order < 0 for none)
+    int screening_order_;
+    double screening_tolerance_;
+    /// Batched integral engine
+    MultipoleFieldEngine* engine_;
+
+    /// Rebuilds field_ if Zxyz_ changed since the last build, and marks it current
+    void update_field();
+
 public:
     /// Constructor. Assumes nuclear centers/charges as the potential
     PotentialInt(std::vector<SphericalTransform>&, boost::shared_ptr<BasisSet>, boost::shared_ptr<BasisSet>, int deriv=0);
@@ -71,11 +94,27 @@ public:
     /// Computes the second derivatives and store them in result
     virtual void compute_deriv2(std::vector<SharedMatrix>& result);
 
+    using OneBodyAOInt::compute;
+    /// Computes all integrals and adds them to result, threaded over shell pairs
+    virtual void compute(SharedMatrix& result);
+
+    /// values[i] += sum_ab D_ab V(i)_ab, the potential integrals of charge (or site) i
+    /// alone contracted with the Cartesian AO density D, threaded over shell pairs
+    void compute_potentials(SharedMatrix D, double* values);
+
     /// Set the field of charges
-    void set_charge_field(SharedMatrix Zxyz) { Zxyz_ = Zxyz; }
+    void set_charge_field(SharedMatrix Zxyz) { Zxyz_ = Zxyz; field_external_ = false; field_current_ = false; }
+
+    /// Use a field of point multipoles in place of the charge field
+    void set_multipole_field(boost::shared_ptr<MultipoleField> field);
+
+    /// Cell multipole screening of large fields: order < 0 turns it off; the
+    /// tolerance bounds the error of each primitive pair-cell interaction
+    void set_screening(int order, double tolerance);
 
-    /// Get the field of charges
-    SharedMatrix charge_field() const { return Zxyz_; }
+    /// Get the field of charges. Edits made in place are seen by the next
+    /// compute(), or by the first compute_shell() after this call
+    SharedMatrix charge_field() { field_current_ = false; return Zxyz_; }
 
     /// Does the method provide first derivatives?
     bool has_deriv1() { return true; }
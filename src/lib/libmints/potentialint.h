@@ -33,6 +33,7 @@ class PCMPotentialInt : public PotentialInt
 {
 public:
     PCMPotentialInt(std::vector<SphericalTransform>&, boost::shared_ptr<BasisSet>, boost::shared_ptr<BasisSet>, int deriv=0);
+    using PotentialInt::compute;
     /// Drives the loops over all shell pairs, to compute integrals
     template<typename PCMPotentialIntFunctor>
     void compute(PCMPotentialIntFunctor &functor);
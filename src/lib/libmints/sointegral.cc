@@ -381,7 +381,8 @@ TwoBodySOInt::TwoBodySOInt(const std::vector<boost::shared_ptr<TwoBodyAOInt> >&
 void TwoBodySOInt::common_init()
 {
     // MPI runtime settings (defaults provided for all communicators)
-    nthread_ = Process::environment.get_n_threads();
+    // One thread per AO integral object handed to us
+    nthread_ = tb_.size();
     //comm_    = WorldComm->communicator();
     boost::shared_ptr<const LibParallel::Communicator> Comm=WorldComm->GetComm();
     nproc_   = Comm->NProc();
@@ -479,6 +480,19 @@ TwoBodySOInt::~TwoBodySOInt()
     }
 }
 
+int TwoBodySOInt::thread_index() const
+{
+#ifdef _OPENMP
+    if (nthread_ > 1) {
+        int thread = omp_get_thread_num();
+        if (thread >= nthread_)
+            throw PSIEXCEPTION("TwoBodySOInt: more OpenMP threads than AO integral objects.");
+        return thread;
+    }
+#endif
+    return 0;
+}
+
 boost::shared_ptr<SOBasisSet> TwoBodySOInt::basis() const
 {
     return b1_;
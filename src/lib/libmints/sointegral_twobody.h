@@ -42,6 +42,10 @@
 #include <libqt/qt.h>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //#define DebugPrint 1
 
 #ifndef DebugPrint
@@ -108,7 +112,10 @@ protected:
     const CdSalcList* cdsalcs_;
 
     template<typename TwoBodySOIntFunctor>
-    void provide_IJKL(int, int, int, int, TwoBodySOIntFunctor& body);
+    void provide_IJKL(int, int, int, int, TwoBodySOIntFunctor& body, int thread);
+
+    /// Index of the calling OpenMP thread's AO object and SO buffer
+    int thread_index() const;
 
     template<typename TwoBodySOIntFunctor>
     void provide_IJKL_deriv1(int ish, int jsh, int ksh, int lsh, TwoBodySOIntFunctor& body);
@@ -221,8 +228,9 @@ void TwoBodySOInt::compute_shell(int uish, int ujsh, int uksh, int ulsh, TwoBody
 {
     dprintf("uish %d, ujsh %d, uksh %d, ulsh %d\n", uish, ujsh, uksh, ulsh);
 
-    int thread = 0;
-    //Old call WorldComm->thread_id(pthread_self());
+    // Each OpenMP thread uses its own AO object and SO buffer, so
+    // compute_shell may be called concurrently for different quartets
+    int thread = thread_index();
 
     mints_timer_on("TwoBodySOInt::compute_shell overall");
     mints_timer_on("TwoBodySOInt::compute_shell setup");
@@ -430,17 +438,14 @@ void TwoBodySOInt::compute_shell(int uish, int ujsh, int uksh, int ulsh, TwoBody
 
     mints_timer_off("TwoBodySOInt::compute_shell full shell transform");
 
-    provide_IJKL(uish, ujsh, uksh, ulsh, body);
+    provide_IJKL(uish, ujsh, uksh, ulsh, body, thread);
 
     mints_timer_off("TwoBodySOInt::compute_shell overall");
 }
 
 template<typename TwoBodySOIntFunctor>
-void TwoBodySOInt::provide_IJKL(int ish, int jsh, int ksh, int lsh, TwoBodySOIntFunctor& body)
+void TwoBodySOInt::provide_IJKL(int ish, int jsh, int ksh, int lsh, TwoBodySOIntFunctor& body, int thread)
 {
-    int thread = 0;
-    //Old call WorldComm->thread_id(pthread_self());
-
     mints_timer_on("TwoBodySOInt::provide_IJKL overall");
 
     int nso2 = b2_->nfunction(jsh);
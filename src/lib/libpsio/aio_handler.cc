@@ -26,8 +26,10 @@
  */
 
 #include <cstdio>
+#include <cstring>
 #include <unistd.h>
 #include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
 #include <boost/thread/thread.hpp>
 #include <libpsio/psio.h>
 #include <libpsio/psio.hpp>
@@ -39,330 +41,287 @@ using namespace boost;
 
 namespace psi {
 
-AIOHandler::AIOHandler(boost::shared_ptr<PSIO> psio)
-    : psio_(psio)
+AIORequest::AIORequest()
+    : done_(false)
 {
+}
+void AIORequest::complete(const std::string& error)
+{
+  boost::unique_lock<boost::mutex> lock(lock_);
+  error_ = error;
+  done_ = true;
+  cond_.notify_all();
+}
+bool AIORequest::done()
+{
+  boost::unique_lock<boost::mutex> lock(lock_);
+  return done_;
+}
+void AIORequest::wait()
+{
+  boost::unique_lock<boost::mutex> lock(lock_);
+  while (!done_) cond_.wait(lock);
+  if (error_.size())
+    throw PsiException("Error in AIO: " + error_, __FILE__, __LINE__);
+}
+
+AIOHandler::AIOHandler(boost::shared_ptr<PSIO> psio, int nworkers, size_t max_queue)
+    : active_(0), max_queue_(max_queue), nworkers_(nworkers), shutdown_(false), psio_(psio)
+{
+    if (nworkers_ < 1) nworkers_ = 1;
+    if (max_queue_ < 1) max_queue_ = 1;
     locked_ = new boost::mutex();
 }
 AIOHandler::~AIOHandler()
 {
+    {
+        boost::unique_lock<boost::mutex> lock(*locked_);
+        shutdown_ = true;
+        work_cond_.notify_all();
+    }
+    for (size_t i = 0; i < workers_.size(); i++) {
+        workers_[i]->join();
+    }
     delete locked_;
 }
 boost::shared_ptr<boost::thread> AIOHandler::get_thread()
 {
-    return thread_;
+    boost::unique_lock<boost::mutex> lock(*locked_);
+    return (workers_.size() ? workers_[0] : boost::shared_ptr<boost::thread>());
 }
 void AIOHandler::synchronize()
 {
     boost::unique_lock<boost::mutex> lock(*locked_);
-    lock.unlock();
-    thread_->join();
+    while (jobs_.size() || active_) idle_cond_.wait(lock);
+
+    if (error_.size()) {
+        std::string error = error_;
+        error_.clear();
+        throw PsiException("Error in AIO: " + error, __FILE__, __LINE__);
+    }
 }
-void AIOHandler::read(unsigned int unit, const char *key, char *buffer, ULI size, psio_address start, psio_address *end)
+SharedAIORequest AIOHandler::enqueue(AIOJob& job)
 {
   boost::unique_lock<boost::mutex> lock(*locked_);
 
-  job_.push(1);
-  unit_.push(unit);
-  key_.push(key);
-  buffer_.push(buffer);
-  size_.push(size);
-  start_.push(start);
-  end_.push(end);
+  //thread pool start, on first use
+  if (workers_.empty()) {
+    for (int i = 0; i < nworkers_; i++) {
+      workers_.push_back(boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&AIOHandler::call_aio,this))));
+    }
+  }
+
+  while (jobs_.size() >= max_queue_) space_cond_.wait(lock);
 
-  if (job_.size() > 1) return;
+  job.request = SharedAIORequest(new AIORequest());
+  jobs_.push_back(job);
+  work_cond_.notify_one();
 
-  //thread start
-  thread_ = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&AIOHandler::call_aio,this)));
+  return job.request;
 }
-void AIOHandler::write(unsigned int unit, const char *key, char *buffer, ULI size, psio_address start, psio_address *end)
+SharedAIORequest AIOHandler::read(unsigned int unit, const char *key, char *buffer, ULI size, psio_address start, psio_address *end)
 {
-  boost::unique_lock<boost::mutex> lock(*locked_);
-
-  job_.push(2);
-  unit_.push(unit);
-  key_.push(key);
-  buffer_.push(buffer);
-  size_.push(size);
-  start_.push(start);
-  end_.push(end);
-
-  if (job_.size() > 1) return;
-
-  //thread start
-  thread_ = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&AIOHandler::call_aio,this)));
+  AIOJob job;
+  job.job = 1;
+  job.unit = unit;
+  job.key = key;
+  job.buffer = buffer;
+  job.size = size;
+  job.start = start;
+  job.end = end;
+  return enqueue(job);
 }
-void AIOHandler::read_entry(unsigned int unit, const char *key, char *buffer, ULI size)
+SharedAIORequest AIOHandler::write(unsigned int unit, const char *key, char *buffer, ULI size, psio_address start, psio_address *end)
 {
-  boost::unique_lock<boost::mutex> lock(*locked_);
-
-  job_.push(3);
-  unit_.push(unit);
-  key_.push(key);
-  buffer_.push(buffer);
-  size_.push(size);
-
-  if (job_.size() > 1) return;
-
-  //thread start
-  thread_ = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&AIOHandler::call_aio,this)));
+  AIOJob job;
+  job.job = 2;
+  job.unit = unit;
+  job.key = key;
+  job.buffer = buffer;
+  job.size = size;
+  job.start = start;
+  job.end = end;
+  return enqueue(job);
 }
-void AIOHandler::write_entry(unsigned int unit, const char *key, char *buffer, ULI size)
+SharedAIORequest AIOHandler::read_entry(unsigned int unit, const char *key, char *buffer, ULI size)
 {
-  boost::unique_lock<boost::mutex> lock(*locked_);
-
-  job_.push(4);
-  unit_.push(unit);
-  key_.push(key);
-  buffer_.push(buffer);
-  size_.push(size);
-
-  if (job_.size() > 1) return;
-
-  //thread start
-  thread_ = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&AIOHandler::call_aio,this)));
+  AIOJob job;
+  job.job = 3;
+  job.unit = unit;
+  job.key = key;
+  job.buffer = buffer;
+  job.size = size;
+  return enqueue(job);
+}
+SharedAIORequest AIOHandler::write_entry(unsigned int unit, const char *key, char *buffer, ULI size)
+{
+  AIOJob job;
+  job.job = 4;
+  job.unit = unit;
+  job.key = key;
+  job.buffer = buffer;
+  job.size = size;
+  return enqueue(job);
 }
-void AIOHandler::read_discont(unsigned int unit, const char *key,
+SharedAIORequest AIOHandler::read_discont(unsigned int unit, const char *key,
   double **matrix, ULI row_length, ULI col_length, ULI col_skip,
   psio_address start)
 {
-  boost::unique_lock<boost::mutex> lock(*locked_);
-
-  job_.push(5);
-  unit_.push(unit);
-  key_.push(key);
-  matrix_.push(matrix);
-  row_length_.push(row_length);
-  col_length_.push(col_length);
-  col_skip_.push(col_skip);
-  start_.push(start);
-
-  if (job_.size() > 1) return;
-
-  //thread start
-  thread_ = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&AIOHandler::call_aio,this)));
+  AIOJob job;
+  job.job = 5;
+  job.unit = unit;
+  job.key = key;
+  job.matrix = matrix;
+  job.row_length = row_length;
+  job.col_length = col_length;
+  job.col_skip = col_skip;
+  job.start = start;
+  return enqueue(job);
 }
-void AIOHandler::write_discont(unsigned int unit, const char *key,
+SharedAIORequest AIOHandler::write_discont(unsigned int unit, const char *key,
   double **matrix, ULI row_length, ULI col_length, ULI col_skip,
   psio_address start)
 {
-  boost::unique_lock<boost::mutex> lock(*locked_);
-
-  job_.push(6);
-  unit_.push(unit);
-  key_.push(key);
-  matrix_.push(matrix);
-  row_length_.push(row_length);
-  col_length_.push(col_length);
-  col_skip_.push(col_skip);
-  start_.push(start);
-
-  if (job_.size() > 1) return;
-
-  //thread start
-  thread_ = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&AIOHandler::call_aio,this)));
+  AIOJob job;
+  job.job = 6;
+  job.unit = unit;
+  job.key = key;
+  job.matrix = matrix;
+  job.row_length = row_length;
+  job.col_length = col_length;
+  job.col_skip = col_skip;
+  job.start = start;
+  return enqueue(job);
 }
-void AIOHandler::zero_disk(unsigned int unit, const char *key,
+SharedAIORequest AIOHandler::zero_disk(unsigned int unit, const char *key,
     ULI rows, ULI cols)
 {
-  boost::unique_lock<boost::mutex> lock(*locked_);
-
-  job_.push(7);
-  unit_.push(unit);
-  key_.push(key);
-  row_length_.push(rows);
-  col_length_.push(cols);
-
-  if (job_.size() > 1) return;
-
-  //thread start
-  thread_ = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&AIOHandler::call_aio,this)));
+  AIOJob job;
+  job.job = 7;
+  job.unit = unit;
+  job.key = key;
+  job.row_length = rows;
+  job.col_length = cols;
+  return enqueue(job);
+}
+static bool aio_job_reads(unsigned int job)
+{
+  return (job == 1 || job == 3 || job == 5);
+}
+std::deque<AIOHandler::AIOJob>::iterator AIOHandler::next_job()
+{
+  // Units whose later requests must wait for an earlier queued one
+  std::set<unsigned int> hold_all;
+  // Units whose later writes must wait for an earlier queued read
+  std::set<unsigned int> hold_writes;
+
+  std::deque<AIOJob>::iterator it = jobs_.begin();
+  for (; it != jobs_.end(); ++it) {
+    unsigned int unit = (*it).unit;
+    bool reads = aio_job_reads((*it).job);
+    bool shared = reads && psio_->parallel_reads(unit);
+
+    bool ready = !hold_all.count(unit) && !(!reads && hold_writes.count(unit)) &&
+                 !unit_writers_.count(unit) && !(unit_readers_[unit] && !shared);
+    if (ready) break;
+
+    if (shared) hold_writes.insert(unit);
+    else hold_all.insert(unit);
+  }
+  return it;
 }
 void AIOHandler::call_aio()
 {
   boost::unique_lock<boost::mutex> lock(*locked_);
 
-  while (job_.size() > 0) {
-    int jobtype = job_.front();
-    lock.unlock();
-
-    if (jobtype == 1) {
-
-      lock.lock();
-
-      unsigned int unit = unit_.front();
-      const char* key = key_.front();
-      char* buffer = buffer_.front();
-      ULI size = size_.front();
-      psio_address start = start_.front();
-      psio_address* end = end_.front();
-
-      job_.pop();
-      unit_.pop();
-      key_.pop();
-      buffer_.pop();
-      size_.pop();
-      start_.pop();
-      end_.pop();
-
-      lock.unlock();
-
-      psio_->read(unit,key,buffer,size,start,end);
-    }
-    else if (jobtype == 2) {
-
-      lock.lock();
-
-      unsigned int unit = unit_.front();
-      const char* key = key_.front();
-      char* buffer = buffer_.front();
-      ULI size = size_.front();
-      psio_address start = start_.front();
-      psio_address* end = end_.front();
-
-      job_.pop();
-      unit_.pop();
-      key_.pop();
-      buffer_.pop();
-      size_.pop();
-      start_.pop();
-      end_.pop();
-
-      lock.unlock();
-
-      psio_->write(unit,key,buffer,size,start,end);
-    }
-    else if (jobtype == 3) {
-
-      lock.lock();
-
-      unsigned int unit = unit_.front();
-      const char* key = key_.front();
-      char* buffer = buffer_.front();
-      ULI size = size_.front();
-
-      job_.pop();
-      unit_.pop();
-      key_.pop();
-      buffer_.pop();
-      size_.pop();
-
-      lock.unlock();
-
-      psio_->read_entry(unit,key,buffer,size);
-    }
-    else if (jobtype == 4) {
-
-      lock.lock();
-
-      unsigned int unit = unit_.front();
-      const char* key = key_.front();
-      char* buffer = buffer_.front();
-      ULI size = size_.front();
-
-      job_.pop();
-      unit_.pop();
-      key_.pop();
-      buffer_.pop();
-      size_.pop();
-
-      lock.unlock();
+  while (true) {
 
-      psio_->write_entry(unit,key,buffer,size);
+    // Oldest request that does not conflict with one running or queued before it
+    std::deque<AIOJob>::iterator it = next_job();
+    if (it == jobs_.end()) {
+      if (shutdown_ && jobs_.empty()) return;
+      work_cond_.wait(lock);
+      continue;
     }
-    else if (jobtype == 5) {
 
-      lock.lock();
+    AIOJob job = *it;
+    jobs_.erase(it);
+    bool reads = aio_job_reads(job.job);
+    if (reads) unit_readers_[job.unit]++;
+    else unit_writers_.insert(job.unit);
+    active_++;
+    space_cond_.notify_one();
 
-      unsigned int unit = unit_.front();
-      const char* key = key_.front();
-      double** matrix = matrix_.front();
-      ULI row_length = row_length_.front();
-      ULI col_length = col_length_.front();
-      ULI col_skip = col_skip_.front();
-      psio_address start = start_.front();
-
-      job_.pop();
-      unit_.pop();
-      key_.pop();
-      matrix_.pop();
-      row_length_.pop();
-      col_length_.pop();
-      col_skip_.pop();
-      start_.pop();
-
-      lock.unlock();
+    lock.unlock();
 
-      for (int i=0; i<row_length; i++) {
-        psio_->read(unit,key,(char *) &(matrix[i][0]),
-          sizeof(double)*col_length,start,&start);
-        start = psio_get_address(start,sizeof(double)*col_skip);
-      }
+    std::string error;
+    try {
+      run_job(job);
+    } catch (std::exception& e) {
+      error = e.what();
     }
-    else if (jobtype == 6) {
 
-      lock.lock();
-
-      unsigned int unit = unit_.front();
-      const char* key = key_.front();
-      double** matrix = matrix_.front();
-      ULI row_length = row_length_.front();
-      ULI col_length = col_length_.front();
-      ULI col_skip = col_skip_.front();
-      psio_address start = start_.front();
+    lock.lock();
 
-      job_.pop();
-      unit_.pop();
-      key_.pop();
-      matrix_.pop();
-      row_length_.pop();
-      col_length_.pop();
-      col_skip_.pop();
-      start_.pop();
+    if (reads) unit_readers_[job.unit]--;
+    else unit_writers_.erase(job.unit);
+    active_--;
+    if (error.size() && error_.empty()) error_ = error;
+    job.request->complete(error);
 
-      lock.unlock();
+    // The unit is free again (or less busy), its next requests may now run
+    work_cond_.notify_all();
+    if (jobs_.empty() && !active_) idle_cond_.notify_all();
+  }
+}
+void AIOHandler::run_job(const AIOJob& job)
+{
+  unsigned int unit = job.unit;
+  const char* key = job.key.c_str();
 
-      for (int i=0; i<row_length; i++) {
-        psio_->write(unit,key,(char *) &(matrix[i][0]),
-          sizeof(double)*col_length,start,&start);
-        start = psio_get_address(start,sizeof(double)*col_skip);
-      }
+  if (job.job == 1) {
+    psio_->read(unit,key,job.buffer,job.size,job.start,job.end);
+  }
+  else if (job.job == 2) {
+    psio_->write(unit,key,job.buffer,job.size,job.start,job.end);
+  }
+  else if (job.job == 3) {
+    psio_->read_entry(unit,key,job.buffer,job.size);
+  }
+  else if (job.job == 4) {
+    psio_->write_entry(unit,key,job.buffer,job.size);
+  }
+  else if (job.job == 5) {
+    psio_address start = job.start;
+    for (int i=0; i<job.row_length; i++) {
+      psio_->read(unit,key,(char *) &(job.matrix[i][0]),
+        sizeof(double)*job.col_length,start,&start);
+      start = psio_get_address(start,sizeof(double)*job.col_skip);
     }
-    else if (jobtype == 7) {
-
-      lock.lock();
-
-      unsigned int unit = unit_.front();
-      const char* key = key_.front();
-      ULI row_length = row_length_.front();
-      ULI col_length = col_length_.front();
-
-      job_.pop();
-      unit_.pop();
-      key_.pop();
-      row_length_.pop();
-      col_length_.pop();
-
-      lock.unlock();
-
-      double* buf = new double[col_length];
-      memset(static_cast<void*>(buf),'\0',col_length*sizeof(double));
-
-      psio_address next_psio = PSIO_ZERO;
-      for (int i=0; i<row_length; i++) {
-        psio_->write(unit,key,(char *) (buf),sizeof(double)*col_length,
-          next_psio,&next_psio);
-      }
-
-      delete[] buf;
+  }
+  else if (job.job == 6) {
+    psio_address start = job.start;
+    for (int i=0; i<job.row_length; i++) {
+      psio_->write(unit,key,(char *) &(job.matrix[i][0]),
+        sizeof(double)*job.col_length,start,&start);
+      start = psio_get_address(start,sizeof(double)*job.col_skip);
     }
-    else {
-      throw PsiException("Error in AIO: Unknown job type", __FILE__,__LINE__);
+  }
+  else if (job.job == 7) {
+    double* buf = new double[job.col_length];
+    memset(static_cast<void*>(buf),'\0',job.col_length*sizeof(double));
+
+    psio_address next_psio = PSIO_ZERO;
+    for (int i=0; i<job.row_length; i++) {
+      psio_->write(unit,key,(char *) (buf),sizeof(double)*job.col_length,
+        next_psio,&next_psio);
     }
 
-    lock.lock();
+    delete[] buf;
+  }
+  else {
+    throw PsiException("Error in AIO: Unknown job type", __FILE__,__LINE__);
   }
 }
 
 } //Namespace psi
-
@@ -23,59 +23,148 @@
 #ifndef AIOHANDLER_H
 #define AIOHANDLER_H
 
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 namespace psi {
 
+/**
+ * Completion handle for one AIOHandler request. wait() blocks until the
+ * request has been carried out, and rethrows any error it raised.
+ **/
+class AIORequest {
+private:
+    boost::mutex lock_;
+    boost::condition_variable cond_;
+    /// Has the request been carried out?
+    bool done_;
+    /// Error raised by the request, if any
+    std::string error_;
+
+    friend class AIOHandler;
+    /// Mark the request done (called by the worker)
+    void complete(const std::string& error);
+public:
+    AIORequest();
+    /// Has the request been carried out? (nonblocking)
+    bool done();
+    /// Block until the request has been carried out
+    void wait();
+};
+
+typedef boost::shared_ptr<AIORequest> SharedAIORequest;
+
+/**
+ * Asynchronous front end to a PSIO object.
+ *
+ * Requests go on a bounded queue served by a pool of long-lived worker
+ * threads. Requests on different units may run concurrently. On one unit,
+ * reads may overlap each other where PSIO allows it (positional transfers,
+ * no in-core pages; see PSIO::parallel_reads), while writes, which may
+ * extend the TOC, run alone; either way no request passes an earlier
+ * conflicting one on the same unit. Each request
+ * returns a completion handle, so callers can keep several reads in flight
+ * and wait on exactly the buffer they need next; synchronize() waits for
+ * everything.
+ *
+ * Addresses are taken by value when a request is queued. The end pointer
+ * is written by the worker, so a caller chaining requests on one entry
+ * without waiting must compute the next start itself (psio_get_address).
+ * Units should be open before requests on them are queued.
+ **/
 class AIOHandler {
 private:
-    /// What is the job type?
-    std::queue<unsigned int> job_;
-    /// Unit number argument
-    std::queue<unsigned int> unit_;
-    /// Entry Key (80-char) argument
-    std::queue<const char*> key_;
-    /// Memory buffer argument
-    std::queue<char*> buffer_;
-    /// Size argument
-    std::queue<ULI> size_;
-    /// Start address argument
-    std::queue<psio_address> start_;
-    /// End address pointer argument
-    std::queue<psio_address*> end_;
-    /// Matrix pointer for discontinuous I/O
-    std::queue<double**> matrix_;
-    /// Size argument for discontinuous I/O
-    std::queue<ULI> row_length_;
-    /// Size argument for discontinuous I/O
-    std::queue<ULI> col_length_;
-    /// Size argument for discontinuous I/O
-    std::queue<ULI> col_skip_;
+    /// One queued request
+    struct AIOJob {
+        /// What is the job type?
+        unsigned int job;
+        /// Unit number argument
+        unsigned int unit;
+        /// Entry Key (80-char) argument, copied
+        std::string key;
+        /// Memory buffer argument
+        char* buffer;
+        /// Size argument
+        ULI size;
+        /// Start address argument
+        psio_address start;
+        /// End address pointer argument
+        psio_address* end;
+        /// Matrix pointer for discontinuous I/O
+        double** matrix;
+        /// Size argument for discontinuous I/O
+        ULI row_length;
+        /// Size argument for discontinuous I/O
+        ULI col_length;
+        /// Size argument for discontinuous I/O
+        ULI col_skip;
+        /// Completion handle given to the caller
+        SharedAIORequest request;
+        AIOJob() : job(0), unit(0), buffer(0), size(0), start(PSIO_ZERO), end(0),
+            matrix(0), row_length(0), col_length(0), col_skip(0) {}
+    };
+
+    /// Queued requests, oldest first
+    std::deque<AIOJob> jobs_;
+    /// Reads currently being carried out, per unit
+    std::map<unsigned int, int> unit_readers_;
+    /// Units with a write currently being carried out
+    std::set<unsigned int> unit_writers_;
+    /// Number of requests currently being carried out
+    size_t active_;
+    /// Most requests allowed on the queue before callers block
+    size_t max_queue_;
+    /// Number of worker threads (started on the first request)
+    int nworkers_;
+    /// Set by the destructor to let the workers exit
+    bool shutdown_;
+    /// First error raised since the last synchronize()
+    std::string error_;
+
     /// PSIO object this AIO_Handler is built on
     boost::shared_ptr<PSIO> psio_;
-    /// Thread this AIO_Handler is currently running on
-    boost::shared_ptr<boost::thread> thread_;
+    /// Worker threads
+    std::vector<boost::shared_ptr<boost::thread> > workers_;
     /// Lock variable
     boost::mutex *locked_;
+    /// Signalled when a request may have become runnable
+    boost::condition_variable work_cond_;
+    /// Signalled when the queue shrinks
+    boost::condition_variable space_cond_;
+    /// Signalled when the queue drains and no request is running
+    boost::condition_variable idle_cond_;
+
+    /// Put job on the queue (blocks while the queue is full)
+    SharedAIORequest enqueue(AIOJob& job);
+    /// Oldest queued request that may start now (jobs_.end() if none)
+    std::deque<AIOJob>::iterator next_job();
+    /// Carry out one request (called by the workers without the lock)
+    void run_job(const AIOJob& job);
 public:
     /// AIO_Handlers are constructed around a synchronous PSIO object
-    AIOHandler(boost::shared_ptr<PSIO> psio);
-    /// Destructor
+    AIOHandler(boost::shared_ptr<PSIO> psio, int nworkers = 2, size_t max_queue = 16);
+    /// Destructor, carries out any requests still queued
     ~AIOHandler();
-    /// Thread object this AIO_Handler is currently running on
+    /// First worker thread (NULL before the first request)
     boost::shared_ptr<boost::thread> get_thread();
     /// When called, synchronize will not return until all requested data has been read or written
     void synchronize();
     /// Asynchronous read, same as PSIO::read, but nonblocking
-    void read(unsigned int unit, const char *key, char *buffer, ULI size,
+    SharedAIORequest read(unsigned int unit, const char *key, char *buffer, ULI size,
               psio_address start, psio_address *end);
     /// Asynchronous write, same as PSIO::write, but nonblocking
-    void write(unsigned int unit, const char *key, char *buffer, ULI size,
+    SharedAIORequest write(unsigned int unit, const char *key, char *buffer, ULI size,
                psio_address start, psio_address *end);
     /// Asynchronous read_entry, same as PSIO::read_entry, but nonblocking
-    void read_entry(unsigned int unit, const char *key, char *buffer, ULI size);
+    SharedAIORequest read_entry(unsigned int unit, const char *key, char *buffer, ULI size);
     /// Asynchronous read_entry, same as PSIO::write_entry, but nonblocking
-    void write_entry(unsigned int unit, const char *key, char *buffer, ULI size);
+    SharedAIORequest write_entry(unsigned int unit, const char *key, char *buffer, ULI size);
     /// Asynchronous read for reading discontinuous disk space
     /// into a continuous chunk of memory, i.e.
     ///
@@ -92,19 +181,19 @@ public:
     ///
     /// These functions are not necessary for psio, but for aio they are.
     ///
-    void read_discont(unsigned int unit, const char *key, double **matrix,
+    SharedAIORequest read_discont(unsigned int unit, const char *key, double **matrix,
       ULI row_length, ULI col_length, ULI col_skip, psio_address start);
     /// Same as read_discont, but for writing
-    void write_discont(unsigned int unit, const char *key, double **matrix,
+    SharedAIORequest write_discont(unsigned int unit, const char *key, double **matrix,
       ULI row_length, ULI col_length, ULI col_skip, psio_address start);
 
     /// Zero disk
     /// Fills a double precision disk entry with zeros
     /// Total fill size is rows*cols*sizeof(double)
     /// Buffer memory of cols*sizeof(double) is used
-    void zero_disk(unsigned int unit, const char* key, ULI rows, ULI cols);
+    SharedAIORequest zero_disk(unsigned int unit, const char* key, ULI rows, ULI cols);
 
-    /// Generic function bound to thread internally
+    /// Worker loop bound to each pool thread internally
     void call_aio();
 };
 
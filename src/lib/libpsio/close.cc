@@ -32,6 +32,7 @@
 #include <cstdlib>
 #include <libpsio/psio.h>
 #include <libpsio/psio.hpp>
+#include "pagecache.h"
 #include "psi4-dec.h"
 #include "../libparallel2/Communicator.h"
 #include "../libparallel2/ParallelEnvironment.h"
@@ -51,6 +52,13 @@ void PSIO::close(unsigned int unit, int keep) {
   /* Dump the current TOC back out to disk */
   tocwrite(unit);
 
+  /* In-core pages go to the volume files only if the unit is kept */
+  if (pagecache_[unit]) {
+    if (keep) pagecache_[unit]->flush();
+    pagecache_spills_ += pagecache_[unit]->spills();
+    pagecache_[unit].reset();
+  }
+
   /* Free the TOC */
   this_entry = this_unit->toc;
   for (i=0; i < this_unit->toclen; i++) {
@@ -66,6 +74,8 @@ void PSIO::close(unsigned int unit, int keep) {
           WorldComm->GetComm();
     if (Comm->Me() == 0) {
       errcod = ::close(this_unit->vol[i].stream);
+      if (this_unit->vol[i].dstream != -1)
+        ::close(this_unit->vol[i].dstream);
     }
     Comm->Bcast(&errcod, 1, 0);
     if (errcod == -1)
@@ -77,12 +87,14 @@ void PSIO::close(unsigned int unit, int keep) {
     free(this_unit->vol[i].path);
     this_unit->vol[i].path = NULL;
     this_unit->vol[i].stream = -1;
+    this_unit->vol[i].dstream = -1;
   }
 
   /* Reset the global page stats to zero */
   this_unit->numvols = 0;
   this_unit->toclen = 0;
   this_unit->toc = NULL;
+  tocindex_rebuild(unit);
 }
 
 int psio_close(unsigned int unit, int keep) {
@@ -33,6 +33,15 @@ namespace psi {
 #define PSIO_MAXUNIT 500
 #define PSIO_PAGELEN 65536
 
+/* PSIO::rw transfer paths */
+#define PSIO_RW_SEEK       0 /* lseek, then page-by-page read/write (original path) */
+#define PSIO_RW_POSITIONAL 1 /* pread/pwrite, one vectored request per volume */
+#define PSIO_RW_DIRECT     2 /* as POSITIONAL, large requests through O_DIRECT */
+
+/* O_DIRECT block alignment and the smallest request worth sending that way */
+#define PSIO_DIRECT_ALIGN 4096
+#define PSIO_DIRECT_MIN   (16*PSIO_PAGELEN)
+
 #define PSIO_ERROR_INIT       1
 #define PSIO_ERROR_DONE       2
 #define PSIO_ERROR_MAXVOL     3
@@ -64,6 +73,7 @@ typedef struct {
 typedef struct {
     char *path;
     int stream;
+    int dstream; /* O_DIRECT descriptor for PSIO_RW_DIRECT, or -1 */
 } psio_vol;
 
 typedef struct psio_entry {
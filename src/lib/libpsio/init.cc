@@ -42,6 +42,7 @@ namespace psi {
 boost::shared_ptr<PSIO> _default_psio_lib_;
 boost::shared_ptr<PSIOManager> _default_psio_manager_;
 std::string PSIO::default_namespace_;
+int PSIO::rw_mode_ = PSIO_RW_POSITIONAL;
 
 int PSIO::_error_exit_code_ = 1;
 psio_address PSIO_ZERO = { 0, 0 };
@@ -57,6 +58,13 @@ PSIO::PSIO()
 #endif
     state_ = 1;
 
+    tocindex_.resize(PSIO_MAXUNIT);
+    toctail_.resize(PSIO_MAXUNIT, NULL);
+    pagecache_.resize(PSIO_MAXUNIT);
+    pagecache_spills_ = 0;
+    toc_lookups_.resize(PSIO_MAXUNIT, 0);
+    toc_lookup_time_.resize(PSIO_MAXUNIT, 0.0);
+
     if (psio_unit == NULL) {
         ::fprintf(stderr, "Error in PSIO_INIT()!\n");
         exit(_error_exit_code_);
@@ -70,6 +78,7 @@ PSIO::PSIO()
         for (j=0; j < PSIO_MAXVOL; j++) {
             psio_unit[i].vol[j].path = NULL;
             psio_unit[i].vol[j].stream = -1;
+            psio_unit[i].vol[j].dstream = -1;
         }
         psio_unit[i].toclen = 0;
         psio_unit[i].toc = NULL;
@@ -37,6 +37,7 @@
 #include <sstream>
 #include <libpsio/psio.h>
 #include <libpsio/psio.hpp>
+#include "pagecache.h"
 #include "psi4-dec.h"
 #include "../libparallel2/Communicator.h"
 #include "../libparallel2/ParallelEnvironment.h"
@@ -124,14 +125,28 @@ void PSIO::open(unsigned int unit, int status) {
     if(this_unit->vol[i].stream == -1)
       psio_error(unit,PSIO_ERROR_OPEN);
 
+    /* Second, unbuffered descriptor for large transfers. Filesystems that
+       refuse O_DIRECT (tmpfs, some network mounts) just keep the buffered one. */
+    this_unit->vol[i].dstream = -1;
+#ifdef O_DIRECT
+    if (rw_mode_ == PSIO_RW_DIRECT && Comm->Me() == 0)
+      this_unit->vol[i].dstream = ::open(this_unit->vol[i].path,O_RDWR|O_DIRECT);
+#endif
+
     free(path);
   }
 
+  /* In-core pages, if the unit has a memory budget */
+  ULI budget = get_memory_budget(unit);
+  if (budget)
+    pagecache_[unit] = boost::shared_ptr<PSIOPageCache>(new PSIOPageCache(this, unit, &PSIO::rw_page, budget));
+
   if (status == PSIO_OPEN_OLD) tocread(unit);
   else if (status == PSIO_OPEN_NEW) {
     /* Init the TOC stats and write them to disk */
     this_unit->toclen = 0;
     this_unit->toc = NULL;
+    tocindex_rebuild(unit);
     wt_toclen(unit, 0);
   }
   else psio_error(unit,PSIO_ERROR_OSTAT);
@@ -0,0 +1,141 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include <boost/shared_ptr.hpp>
+#include <libpsio/psio.h>
+#include <libpsio/psio.hpp>
+#include "pagecache.h"
+
+namespace psi {
+
+PSIOPageCache::PSIOPageCache(PSIO *psio, unsigned int unit, PageIO pageio, ULI budget) :
+    psio_(psio), unit_(unit), pageio_(pageio), hits_(0), misses_(0), spills_(0)
+{
+  max_pages_ = std::max(budget / PSIO_PAGELEN, (ULI) 1);
+}
+
+PSIOPageCache::~PSIOPageCache() {
+  for (boost::unordered_map<ULI, Page>::iterator it = pages_.begin(); it != pages_.end(); ++it)
+    free(it->second.data);
+}
+
+PSIOPageCache::Page& PSIOPageCache::fetch(ULI page, bool overwrite) {
+  boost::unordered_map<ULI, Page>::iterator it = pages_.find(page);
+  if (it != pages_.end()) {
+    hits_++;
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return it->second;
+  }
+  misses_++;
+
+  /* Make room first: spill the least recently used page */
+  while (pages_.size() >= max_pages_) {
+    ULI victim = lru_.back();
+    Page& old = pages_[victim];
+    if (old.dirty) {
+      (psio_->*pageio_)(unit_, victim, old.data, 1);
+      spills_++;
+    }
+    free(old.data);
+    lru_.pop_back();
+    pages_.erase(victim);
+  }
+
+  Page entry;
+  entry.data = (char *) malloc(PSIO_PAGELEN);
+  entry.dirty = false;
+  if (!overwrite)
+    (psio_->*pageio_)(unit_, page, entry.data, 0);
+  lru_.push_front(page);
+  entry.lru = lru_.begin();
+  return (pages_[page] = entry);
+}
+
+void PSIOPageCache::rw(char *buffer, psio_address address, ULI size, int wrt) {
+  ULI page = address.page;
+  ULI offset = address.offset;
+  ULI buf_offset = 0;
+
+  while (buf_offset < size) {
+    ULI len = std::min(size - buf_offset, (ULI) PSIO_PAGELEN - offset);
+    Page& entry = fetch(page, wrt && len == PSIO_PAGELEN);
+    if (wrt) {
+      ::memcpy(entry.data + offset, buffer + buf_offset, len);
+      entry.dirty = true;
+    } else {
+      ::memcpy(buffer + buf_offset, entry.data + offset, len);
+    }
+    buf_offset += len;
+    page++;
+    offset = 0;
+  }
+}
+
+void PSIOPageCache::flush() {
+  /* In page order, so the volume files are written front to back */
+  std::vector<ULI> dirty;
+  for (boost::unordered_map<ULI, Page>::iterator it = pages_.begin(); it != pages_.end(); ++it)
+    if (it->second.dirty) dirty.push_back(it->first);
+  std::sort(dirty.begin(), dirty.end());
+
+  for (size_t i = 0; i < dirty.size(); i++) {
+    Page& entry = pages_[dirty[i]];
+    (psio_->*pageio_)(unit_, dirty[i], entry.data, 1);
+    entry.dirty = false;
+  }
+}
+
+void PSIO::set_memory_budget(int unit, ULI bytes) {
+  std::stringstream ss;
+  ss << bytes;
+  filecfg_kwd("DEFAULT", "MEMORY", unit, ss.str().c_str());
+}
+
+ULI PSIO::get_memory_budget(unsigned int unit) {
+  std::string charnum;
+  charnum = filecfg_kwd("PSI", "MEMORY", unit);
+  if (!charnum.empty())
+    return (strtoul(charnum.c_str(), NULL, 10));
+  charnum = filecfg_kwd("PSI", "MEMORY", -1);
+  if (!charnum.empty())
+    return (strtoul(charnum.c_str(), NULL, 10));
+  charnum = filecfg_kwd("DEFAULT", "MEMORY", unit);
+  if (!charnum.empty())
+    return (strtoul(charnum.c_str(), NULL, 10));
+  charnum = filecfg_kwd("DEFAULT", "MEMORY", -1);
+  if (!charnum.empty())
+    return (strtoul(charnum.c_str(), NULL, 10));
+
+  return 0;
+}
+
+}
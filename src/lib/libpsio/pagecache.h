@@ -0,0 +1,92 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsio_pagecache_h_
+#define _psi_src_lib_libpsio_pagecache_h_
+
+#include <list>
+#include <boost/unordered_map.hpp>
+#include <libpsio/config.h>
+
+namespace psi {
+
+class PSIO;
+
+/**
+ * In-core store for the pages of one memory-resident PSIO unit.
+ *
+ * Pages are PSIO_PAGELEN bytes, numbered like the unit's global
+ * addresses. A page is read from the volume files the first time it is
+ * touched (zero-filled past their end) and kept here until the byte budget
+ * is exceeded; then the least recently used pages are written back
+ * (if dirty) and dropped. PSIO::close() flushes or discards the rest.
+ **/
+class PSIOPageCache {
+
+public:
+    /// Moves one whole page between core and the volume files
+    typedef void (PSIO::*PageIO)(unsigned int unit, ULI page, char *data, int wrt);
+
+private:
+    struct Page {
+        char *data;
+        bool dirty;
+        std::list<ULI>::iterator lru;
+    };
+
+    /// Owning PSIO object and unit, for spills and fills
+    PSIO *psio_;
+    unsigned int unit_;
+    PageIO pageio_;
+    /// Most pages kept in core
+    ULI max_pages_;
+    /// Resident pages
+    boost::unordered_map<ULI, Page> pages_;
+    /// Resident page numbers, most recently used first
+    std::list<ULI> lru_;
+
+    /// Counters
+    ULI hits_;
+    ULI misses_;
+    ULI spills_;
+
+    /// Page number page, brought into core if need be (without a read if it will be overwritten whole)
+    Page& fetch(ULI page, bool overwrite);
+
+public:
+    PSIOPageCache(PSIO *psio, unsigned int unit, PageIO pageio, ULI budget);
+    ~PSIOPageCache();
+
+    /// Same contract as PSIO::rw, against the in-core pages
+    void rw(char *buffer, psio_address address, ULI size, int wrt);
+    /// Write every dirty page back to the volume files
+    void flush();
+
+    ULI max_pages() const { return max_pages_; }
+    ULI hits() const { return hits_; }
+    ULI misses() const { return misses_; }
+    ULI spills() const { return spills_; }
+};
+
+}
+
+#endif /* header guard */
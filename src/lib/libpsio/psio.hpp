@@ -6,6 +6,8 @@
 #include <map>
 #include <set>
 #include <queue>
+#include <vector>
+#include <boost/unordered_map.hpp>
 
 #include <libpsio/config.h>
 
@@ -21,6 +23,7 @@ namespace psi {
 
 class PSIO;
 class PSIOManager;
+class PSIOPageCache;
 extern boost::shared_ptr<PSIO> _default_psio_lib_;
 extern boost::shared_ptr<PSIOManager> _default_psio_manager_;
 
@@ -288,6 +291,26 @@ public:
     /// Set the current namespace (for PREFIX.NAMESPACE.UNIT file numbering)
     static void set_default_namespace(const std::string &_ns) { default_namespace_ = _ns; }
 
+    /// Set the PSIO::rw transfer path (PSIO_RW_SEEK, PSIO_RW_POSITIONAL or PSIO_RW_DIRECT). PSIO_RW_DIRECT applies to units opened afterwards.
+    static void set_rw_mode(int mode) { rw_mode_ = mode; }
+    /// Get the PSIO::rw transfer path
+    static int get_rw_mode() { return rw_mode_; }
+    /// May reads of existing entries of unit run concurrently? (open, positional transfers, no in-core pages)
+    bool parallel_reads(unsigned int unit);
+
+    /**
+       Keep unit in core, with at most bytes of pages resident; least recently
+       used pages beyond that spill to the volume files. unit = -1 sets the
+       default for all units, bytes = 0 turns it off. Stored as the "MEMORY"
+       file keyword (so "PSI"/"DEFAULT" groups work as for NVOLUME) and applied
+       when a unit is next opened.
+       */
+    void set_memory_budget(int unit, ULI bytes);
+    /// In-core byte budget unit will be opened with (0 for disk-only)
+    ULI get_memory_budget(unsigned int unit);
+    /// Dirty pages written back to the volume files to stay within a memory budget so far
+    ULI pagecache_spills() const { return pagecache_spills_; }
+
     /// Get the default namespace (for PREFIX.NAMESPACE.UNIT file numbering)
     static std::string get_default_namespace() { return default_namespace_; }
 
@@ -315,6 +338,15 @@ public:
     /// delete a specific TOC entry (only deletes entry, not data)
     bool tocdel(unsigned int unit, const char *key);
 
+    /// Number of keyed TOC lookups (tocscan/tocentry_exists) so far
+    ULI toc_lookups() const;
+    /// Wall time spent in keyed TOC lookups so far [s]
+    double toc_lookup_time() const;
+    /// Zero the TOC lookup counters
+    void reset_toc_stats();
+    /// Print the TOC lookup counters to outfile
+    void print_toc_stats();
+
 private:
     /// vector of units
     psio_ud *psio_unit;
@@ -325,11 +357,26 @@ private:
 
     /// Current default namespace (for PREFIX.NAMESPACE.UNIT numbering)
     static std::string default_namespace_;
+    /// Current PSIO::rw transfer path
+    static int rw_mode_;
 
     typedef std::map<std::string,std::string> KWDMap;
     /// library configuration is described by a set of keywords
     KWDMap files_keywords_;
 
+    /// Per-unit key -> entry index over the psio_unit[].toc list
+    std::vector<boost::unordered_map<std::string, psio_tocentry*> > tocindex_;
+    /// Per-unit last entry of the psio_unit[].toc list
+    std::vector<psio_tocentry*> toctail_;
+    /// Per-unit in-core pages, for units opened with a memory budget
+    std::vector<boost::shared_ptr<PSIOPageCache> > pagecache_;
+    /// Spills of the in-core units closed so far
+    ULI pagecache_spills_;
+    /// Per-unit keyed TOC lookups so far (per unit, so AIO workers on different units do not share)
+    std::vector<ULI> toc_lookups_;
+    /// Per-unit wall time in keyed TOC lookups so far [s]
+    std::vector<double> toc_lookup_time_;
+
 #ifdef PSIO_STATS
     ULI *psio_readlen;
     ULI *psio_writlen;
@@ -354,6 +401,20 @@ private:
     void wt_toclen(unsigned int unit, ULI toclen);
     /// Read the table of contents for file number 'unit'.
     void tocread(unsigned int unit);
+    /// rw() by lseek and page-by-page read/write on each volume
+    void rw_seek(unsigned int unit, char *buffer, psio_address address, ULI size, int wrt);
+    /// rw() by one pread/pwrite(v) per volume, O_DIRECT where the unit has it
+    void rw_positional(unsigned int unit, char *buffer, psio_address address, ULI size, int wrt);
+    /// Move one whole page between core and the volume files (zero-filled past their end), for PSIOPageCache
+    void rw_page(unsigned int unit, ULI page, char *data, int wrt);
+    /// Find key in the TOC index of unit (NULL if absent), counting the lookup
+    psio_tocentry* tocindex_find(unsigned int unit, const char *key);
+    /// Rebuild the TOC index of unit from the in-core TOC list
+    void tocindex_rebuild(unsigned int unit);
+    /// Add a new last entry to the TOC index of unit
+    void tocindex_append(unsigned int unit, psio_tocentry *entry);
+    /// Drop entry from the TOC index of unit (call before the entry is freed)
+    void tocindex_erase(unsigned int unit, psio_tocentry *entry);
 
     friend class AIO_Handler;
 
@@ -26,16 +26,263 @@
  */
 
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <vector>
+#include <algorithm>
 #include <unistd.h>
+#include <sys/types.h>
+#include <sys/uio.h>
 #include <libpsio/psio.h>
 #include <libpsio/psio.hpp>
+#include "pagecache.h"
 #include "psi4-dec.h"
 #include "../libparallel2/Communicator.h"
 #include "../libparallel2/ParallelEnvironment.h"
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
 namespace psi {
 
+namespace {
+
+/// Contiguous file region of one volume, and where its bytes live in the caller's buffer
+struct psio_volreq {
+  off_t start;
+  ULI size;
+  std::vector<struct iovec> iov;
+  psio_volreq() : start(0), size(0) {}
+};
+
+/*
+ * Split a unit-global transfer into one request per volume. Pages are
+ * striped round-robin over the volumes, so the pages of one volume are
+ * contiguous in its file; only their places in the buffer are interleaved.
+ * Buffer pieces that happen to be adjacent are merged (always the case for
+ * a single volume), so a one-volume transfer is a single iovec.
+ */
+void psio_split_volumes(unsigned int numvols, char *buffer, psio_address address,
+                        ULI size, std::vector<psio_volreq>& reqs) {
+  reqs.assign(numvols, psio_volreq());
+
+  ULI page = address.page;
+  ULI offset = address.offset;
+  ULI buf_offset = 0;
+  while (buf_offset < size) {
+    ULI len = std::min(size - buf_offset, (ULI) PSIO_PAGELEN - offset);
+    psio_volreq& req = reqs[page % numvols];
+    if (!req.size)
+      req.start = (off_t) (page / numvols) * PSIO_PAGELEN + offset;
+    req.size += len;
+
+    char *base = buffer + buf_offset;
+    if (req.iov.size() && (char *) req.iov.back().iov_base + req.iov.back().iov_len == base) {
+      req.iov.back().iov_len += len;
+    } else {
+      struct iovec piece;
+      piece.iov_base = base;
+      piece.iov_len = len;
+      req.iov.push_back(piece);
+    }
+
+    buf_offset += len;
+    page++;
+    offset = 0;
+  }
+}
+
+/// Move all of iov to/from fd at position start, riding out short transfers. Returns 0 or -1.
+int psio_xferv(int fd, std::vector<struct iovec>& iov, off_t start, int wrt) {
+  size_t next = 0;
+  while (next < iov.size()) {
+    int niov = (int) std::min(iov.size() - next, (size_t) IOV_MAX);
+    ssize_t done = (wrt ? ::pwritev(fd, &iov[next], niov, start)
+                        : ::preadv(fd, &iov[next], niov, start));
+    if (done < 0) {
+      if (errno == EINTR) continue;
+      return -1;
+    }
+    if (done == 0) return -1; /* read past the end of the file */
+    start += done;
+    while (done > 0) {
+      if ((size_t) done >= iov[next].iov_len) {
+        done -= iov[next].iov_len;
+        next++;
+      } else {
+        iov[next].iov_base = (char *) iov[next].iov_base + done;
+        iov[next].iov_len -= done;
+        done = 0;
+      }
+    }
+  }
+  return 0;
+}
+
+/// Move size bytes of buf to/from fd at position start, short reads at the end of the file are zero-filled
+int psio_xfer_padded(int fd, char *buf, ULI size, off_t start, int wrt) {
+  ULI done = 0;
+  while (done < size) {
+    ssize_t got = (wrt ? ::pwrite(fd, buf + done, size - done, start + done)
+                       : ::pread(fd, buf + done, size - done, start + done));
+    if (got < 0) {
+      if (errno == EINTR) continue;
+      return -1;
+    }
+    if (got == 0) {
+      if (wrt) return -1;
+      ::memset(buf + done, '\0', size - done);
+      break;
+    }
+    done += got;
+  }
+  return 0;
+}
+
+/*
+ * Aligned transfer on the O_DIRECT descriptor dfd. O_DIRECT only accepts
+ * block-aligned offsets, so once a short transfer (typically a read that
+ * hits the end of the file) leaves the position unaligned, the remainder
+ * goes through the buffered descriptor fd of the same file instead.
+ */
+int psio_xfer_aligned(int dfd, int fd, char *buf, ULI size, off_t start, int wrt) {
+  ULI done = 0;
+  while (done < size && done % PSIO_DIRECT_ALIGN == 0) {
+    ssize_t got = (wrt ? ::pwrite(dfd, buf + done, size - done, start + done)
+                       : ::pread(dfd, buf + done, size - done, start + done));
+    if (got < 0) {
+      if (errno == EINTR) continue;
+      return -1;
+    }
+    if (got == 0) {
+      if (wrt) return -1;
+      ::memset(buf + done, '\0', size - done);
+      return 0;
+    }
+    done += got;
+  }
+  if (done < size)
+    return psio_xfer_padded(fd, buf + done, size - done, start + done, wrt);
+  return 0;
+}
+
+/*
+ * O_DIRECT transfer of one volume request through an aligned bounce
+ * buffer. The file region is widened to PSIO_DIRECT_ALIGN boundaries;
+ * for writes the partial blocks at either end are read first so the
+ * bytes around the entry are preserved. fd is the buffered descriptor
+ * of the same volume, used for unaligned tails.
+ */
+int psio_xfer_direct(int dfd, int fd, psio_volreq& req, int wrt) {
+  off_t astart = req.start - (req.start % PSIO_DIRECT_ALIGN);
+  off_t aend = req.start + (off_t) req.size;
+  if (aend % PSIO_DIRECT_ALIGN) aend += PSIO_DIRECT_ALIGN - (aend % PSIO_DIRECT_ALIGN);
+  ULI asize = aend - astart;
+
+  void *mem;
+  if (::posix_memalign(&mem, PSIO_DIRECT_ALIGN, asize)) return -1;
+  char *bounce = (char *) mem;
+  char *data = bounce + (req.start - astart);
+
+  int errcod = 0;
+  if (!wrt) {
+    errcod = psio_xfer_aligned(dfd, fd, bounce, asize, astart, 0);
+    for (size_t i = 0; !errcod && i < req.iov.size(); i++) {
+      ::memcpy(req.iov[i].iov_base, data, req.iov[i].iov_len);
+      data += req.iov[i].iov_len;
+    }
+  } else {
+    if (astart != req.start)
+      errcod = psio_xfer_aligned(dfd, fd, bounce, PSIO_DIRECT_ALIGN, astart, 0);
+    if (!errcod && (req.start + (off_t) req.size) != aend)
+      errcod = psio_xfer_aligned(dfd, fd, bounce + asize - PSIO_DIRECT_ALIGN, PSIO_DIRECT_ALIGN,
+                                 aend - PSIO_DIRECT_ALIGN, 0);
+    for (size_t i = 0; !errcod && i < req.iov.size(); i++) {
+      ::memcpy(data, req.iov[i].iov_base, req.iov[i].iov_len);
+      data += req.iov[i].iov_len;
+    }
+    if (!errcod)
+      errcod = psio_xfer_aligned(dfd, fd, bounce, asize, astart, 1);
+  }
+
+  ::free(mem);
+  return errcod;
+}
+
+}
+
 void PSIO::rw(unsigned int unit, char *buffer, psio_address address, ULI size,
               int wrt) {
+  if (pagecache_[unit])
+    pagecache_[unit]->rw(buffer, address, size, wrt);
+  else if (rw_mode_ == PSIO_RW_SEEK)
+    rw_seek(unit, buffer, address, size, wrt);
+  else
+    rw_positional(unit, buffer, address, size, wrt);
+}
+
+bool PSIO::parallel_reads(unsigned int unit) {
+  /* rw_seek moves the shared file position and the page cache is not
+     locked; the positional path keeps no state between calls. A closed
+     unit would be opened and closed again by each read (tocscan). */
+  return (rw_mode_ != PSIO_RW_SEEK && !pagecache_[unit] && open_check(unit));
+}
+
+void PSIO::rw_positional(unsigned int unit, char *buffer, psio_address address, ULI size,
+                         int wrt) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+  unsigned int numvols = this_unit->numvols;
+
+  std::vector<psio_volreq> reqs;
+  psio_split_volumes(numvols, buffer, address, size, reqs);
+
+  boost::shared_ptr<const LibParallel::Communicator> Comm=
+        WorldComm->GetComm();
+  int errcod = 0;
+  if (Comm->Me() == 0) {
+    for (unsigned int i = 0; !errcod && i < numvols; i++) {
+      if (!reqs[i].size) continue;
+      int dstream = this_unit->vol[i].dstream;
+      if (dstream != -1 && reqs[i].size >= PSIO_DIRECT_MIN)
+        errcod = psio_xfer_direct(dstream, this_unit->vol[i].stream, reqs[i], wrt);
+      else
+        errcod = psio_xferv(this_unit->vol[i].stream, reqs[i].iov, reqs[i].start, wrt);
+    }
+  }
+  Comm->Bcast(&errcod, 1, 0);
+  if (errcod)
+    psio_error(unit, (wrt ? PSIO_ERROR_WRITE : PSIO_ERROR_READ));
+
+  if (!wrt) {
+    /* Broadcast counts are ints, so go in page-multiple chunks */
+    ULI chunk = 16384UL * PSIO_PAGELEN;
+    for (ULI done = 0; done < size; done += chunk)
+      Comm->Bcast(&(buffer[done]), (int) std::min(chunk, size - done), 0);
+  }
+}
+
+void PSIO::rw_page(unsigned int unit, ULI page, char *data, int wrt) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+  unsigned int numvols = this_unit->numvols;
+  off_t start = (off_t) (page / numvols) * PSIO_PAGELEN;
+
+  boost::shared_ptr<const LibParallel::Communicator> Comm=
+        WorldComm->GetComm();
+  int errcod = 0;
+  if (Comm->Me() == 0)
+    errcod = psio_xfer_padded(this_unit->vol[page % numvols].stream, data, PSIO_PAGELEN, start, wrt);
+  Comm->Bcast(&errcod, 1, 0);
+  if (errcod)
+    psio_error(unit, (wrt ? PSIO_ERROR_WRITE : PSIO_ERROR_READ));
+  if (!wrt)
+    Comm->Bcast(data, PSIO_PAGELEN, 0);
+}
+
+void PSIO::rw_seek(unsigned int unit, char *buffer, psio_address address, ULI size,
+                   int wrt) {
   int errcod;
   unsigned int i;
   ULI errcod_uli;
@@ -55,10 +55,12 @@ void PSIO::tocclean(unsigned int unit, const char *key) {
   while ((last_entry != this_entry) && (last_entry != NULL)) {
     /* Now free all the remaining members */
     prev_entry = last_entry->last;
+    tocindex_erase(unit, last_entry);
     free(last_entry);
     last_entry = prev_entry;
     this_unit->toclen--;
   }
+  if (last_entry != NULL) last_entry->next = NULL;
 
   /* Update on disk */
   wt_toclen(unit, this_unit->toclen);
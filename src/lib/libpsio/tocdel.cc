@@ -49,6 +49,7 @@ bool PSIO::tocdel(unsigned int unit, const char *key) {
     next_entry->last = last_entry;
   }
 
+  tocindex_erase(unit, this_entry);
   free(this_entry);
   psio_ud *this_unit = &(psio_unit[unit]);
   this_unit->toclen--;
@@ -0,0 +1,119 @@
+/*
+ *@BEGIN LICENSE
+ *
+ * PSI4: an ab initio quantum chemistry software package
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *@END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <sys/time.h>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include <libpsio/psio.h>
+#include <libpsio/psio.hpp>
+#include <psi4-dec.h>
+
+namespace psi {
+
+/*
+ * The TOC of each open unit is kept twice: the doubly linked list in
+ * psio_unit[unit].toc, which fixes the on-disk order, and a hash of
+ * key -> entry (plus the tail entry), which the keyed lookups use. Every
+ * routine that links or frees list entries must keep the two in step.
+ */
+
+static double tocindex_wall()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1.0E-6 * tv.tv_usec;
+}
+
+psio_tocentry* PSIO::tocindex_find(unsigned int unit, const char *key) {
+  double start = tocindex_wall();
+
+  boost::unordered_map<std::string, psio_tocentry*>::const_iterator it =
+      tocindex_[unit].find(std::string(key));
+  psio_tocentry *entry = (it == tocindex_[unit].end() ? NULL : it->second);
+
+  /* Concurrent AIO reads of one unit count here too */
+  double elapsed = tocindex_wall() - start;
+#pragma omp atomic
+  toc_lookups_[unit]++;
+#pragma omp atomic
+  toc_lookup_time_[unit] += elapsed;
+  return entry;
+}
+
+void PSIO::tocindex_rebuild(unsigned int unit) {
+  tocindex_[unit].clear();
+  toctail_[unit] = NULL;
+
+  psio_tocentry *this_entry = psio_unit[unit].toc;
+  while (this_entry != NULL) {
+    tocindex_[unit][std::string(this_entry->key)] = this_entry;
+    toctail_[unit] = this_entry;
+    this_entry = this_entry->next;
+  }
+}
+
+void PSIO::tocindex_append(unsigned int unit, psio_tocentry *entry) {
+  tocindex_[unit][std::string(entry->key)] = entry;
+  toctail_[unit] = entry;
+}
+
+void PSIO::tocindex_erase(unsigned int unit, psio_tocentry *entry) {
+  tocindex_[unit].erase(std::string(entry->key));
+  if (toctail_[unit] == entry)
+    toctail_[unit] = entry->last;
+}
+
+ULI PSIO::toc_lookups() const {
+  ULI total = 0;
+  for (unsigned int unit = 0; unit < toc_lookups_.size(); unit++)
+    total += toc_lookups_[unit];
+  return total;
+}
+
+double PSIO::toc_lookup_time() const {
+  double total = 0.0;
+  for (unsigned int unit = 0; unit < toc_lookup_time_.size(); unit++)
+    total += toc_lookup_time_[unit];
+  return total;
+}
+
+void PSIO::reset_toc_stats() {
+  std::fill(toc_lookups_.begin(), toc_lookups_.end(), 0);
+  std::fill(toc_lookup_time_.begin(), toc_lookup_time_.end(), 0.0);
+}
+
+void PSIO::print_toc_stats() {
+  ULI lookups = toc_lookups();
+  double time = toc_lookup_time();
+  outfile->Printf("  ==> LIBPSIO TOC Lookups <==\n\n");
+  outfile->Printf("    Lookups          = %14lu\n", lookups);
+  outfile->Printf("    Lookup Time [s]  = %14.3f\n", time);
+  outfile->Printf("    Per Lookup [us]  = %14.3f\n\n",
+      (lookups ? 1.0E6 * time / lookups : 0.0));
+}
+
+}
@@ -31,12 +31,7 @@
 namespace psi {
 
 psio_tocentry*PSIO::toclast(unsigned int unit) {
-  psio_tocentry *this_entry = psio_unit[unit].toc;
-  
-  while (this_entry->next != NULL)
-    this_entry = this_entry->next;
-  
-  return (this_entry);
+  return (toctail_[unit]);
 }
 
 }
@@ -31,6 +31,7 @@
 #include <exception.h>
 #include <libpsio/psio.h>
 #include <libpsio/psio.hpp>
+#include "pagecache.h"
 #include "psi4-dec.h"
 #include "../libparallel2/Communicator.h"
 #include "../libparallel2/ParallelEnvironment.h"
@@ -57,20 +58,19 @@ ULI PSIO::rd_toclen(unsigned int unit) {
   
   this_unit = &(psio_unit[unit]);
   
-  /* Seek vol[0] to its beginning */
+  /* In-core units keep the length on their first page */
+  if (pagecache_[unit]) {
+    len = 0;
+    rw(unit, (char *) &len, PSIO_ZERO, sizeof(ULI), 0);
+    return(len);
+  }
+
+  /* Read the value from the beginning of vol[0] */
   stream = this_unit->vol[0].stream;
   boost::shared_ptr<const LibParallel::Communicator> Comm=
         WorldComm->GetComm();
   if (Comm->Me() == 0) {
-    errcod = ::lseek(stream, 0L, SEEK_SET);
-  }
-  Comm->Bcast(&(errcod), 1, 0);
-  if (errcod == -1)
-    psio_error(unit, PSIO_ERROR_LSEEK);
-  
-  /* Read the value */
-  if (Comm->Me() == 0) {
-    errcod = ::read(stream, (char *) &len, sizeof(ULI));
+    errcod = ::pread(stream, (char *) &len, sizeof(ULI), 0);
   }
 
   Comm->Bcast(&(errcod), 1, 0);
@@ -87,22 +87,18 @@ void PSIO::wt_toclen(unsigned int unit, ULI len) {
   
   this_unit = &(psio_unit[unit]);
   
-  /* Seek vol[0] to its beginning */
+  /* In-core units keep the length on their first page */
+  if (pagecache_[unit]) {
+    rw(unit, (char *) &len, PSIO_ZERO, sizeof(ULI), 1);
+    return;
+  }
+
+  /* Write the value to the beginning of vol[0] */
   stream = this_unit->vol[0].stream;
   boost::shared_ptr<const LibParallel::Communicator> Comm=
         WorldComm->GetComm();
   if (Comm->Me() == 0) {
-    errcod = ::lseek(stream, 0L, SEEK_SET);
-  }
-  Comm->Bcast(&(errcod), 1, 0);
-  if (errcod == -1) {
-    ::fprintf(stderr, "Error in PSIO_WT_TOCLEN()!\n");
-    exit(_error_exit_code_);
-  }
-  
-  /* Write the value */
-  if (Comm->Me() == 0) {
-    errcod = ::write(stream, (char *) &len, sizeof(ULI));
+    errcod = ::pwrite(stream, (char *) &len, sizeof(ULI), 0);
   }
   Comm->Bcast(&(errcod), 1, 0);
   if(errcod != sizeof(ULI)) {
@@ -44,18 +44,10 @@ psio_tocentry*PSIO::tocscan(unsigned int unit, const char *key) {
   bool already_open = open_check(unit); 
   if(!already_open) open(unit, PSIO_OPEN_OLD);
 
-  this_entry = psio_unit[unit].toc;
-
-  while (this_entry != NULL) {
-    if (!strcmp(this_entry->key, key)) {
-      if(!already_open) close(unit, 1); // keep
-      return (this_entry);
-    }
-    this_entry = this_entry->next;
-  }
+  this_entry = tocindex_find(unit, key);
 
   if(!already_open) close(unit, 1); // keep
-  return (NULL);
+  return (this_entry);
 }
 
   /*!
@@ -81,18 +73,10 @@ bool PSIO::tocentry_exists(unsigned int unit, const char *key) {
   bool already_open = open_check(unit); 
   if(!already_open) open(unit, PSIO_OPEN_OLD);
 
-  this_entry = psio_unit[unit].toc;
-
-  while (this_entry != NULL) {
-    if (!strcmp(this_entry->key, key)) {
-      if(!already_open) close(unit, 1); // keep
-      return (true);
-    }
-    this_entry = this_entry->next;
-  }
+  this_entry = tocindex_find(unit, key);
 
   if(!already_open) close(unit, 1); // keep
-  return (false);
+  return (this_entry != NULL);
 }
 
   /*!
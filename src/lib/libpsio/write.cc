@@ -71,6 +71,7 @@ void PSIO::write(unsigned int unit, const char *key, char *buffer, ULI size,
       last_entry->next = this_entry;
       this_entry->last = last_entry;
     }
+    tocindex_append(unit, this_entry);
 
     /* compute important global addresses for the entry */
     start_toc = this_entry->sadd;
@@ -45,6 +45,8 @@ PCM::PCM(Options &options, boost::shared_ptr<PSIO> psio, int nirrep, boost::shar
   my_aotoso_ = petite.aotoso();
 
   potential_int_ = static_cast<PCMPotentialInt*>(integrals->pcm_potentialint());
+  // Potentials and V_pcm are formed in the Cartesian AO basis
+  potential_int_->set_force_cartesian(true);
 
   boost::shared_ptr<Molecule> molecule = Process::environment.molecule();
 
@@ -170,9 +172,8 @@ double PCM::compute_E_total(SharedMatrix &D)
   }
   else D_carts = D;
 
-  ContractOverDensityFunctor contract_density_functor(ntess_, tess_pot_e_, D_carts);
   // Add in the electronic contribution to the potential at each tessera
-  potential_int_->compute(contract_density_functor);
+  potential_int_->compute_potentials(D_carts, tess_pot_e_);
 
   // A little debug info
   if(pcm_print_ > 2) {
@@ -227,9 +228,8 @@ double PCM::compute_E_separate(SharedMatrix &D)
   }
   else D_carts = D;
 
-  ContractOverDensityFunctor contract_density_functor(ntess_, tess_pot_e_, D_carts);
   // Add in the electronic contribution to the potential at each tessera
-  potential_int_->compute(contract_density_functor);
+  potential_int_->compute_potentials(D_carts, tess_pot_e_);
 
   // A little debug info
   if(pcm_print_ > 2) {
@@ -287,9 +287,8 @@ double PCM::compute_E_electronic(SharedMatrix &D)
   }
   else D_carts = D;
 
-  ContractOverDensityFunctor contract_density_functor(ntess_, tess_pot_e_, D_carts);
   // Add in the electronic contribution to the potential at each tessera
-  potential_int_->compute(contract_density_functor);
+  potential_int_->compute_potentials(D_carts, tess_pot_e_);
 
   // A little debug info
   if(pcm_print_ > 2) {
@@ -327,8 +326,11 @@ double PCM::compute_E_electronic(SharedMatrix &D)
 SharedMatrix PCM::compute_V()
 {
   SharedMatrix V_pcm_cart = SharedMatrix(new Matrix("PCM potential cart", basisset_->nao(), basisset_->nao()));
-  ContractOverChargesFunctor contract_charges_functor(tess_charges_, V_pcm_cart);
-  potential_int_->compute(contract_charges_functor);
+  // The apparent surface charges are the field of the potential integrals
+  double **ptess_Zxyz = tess_Zxyz_->pointer();
+  for(int tess = 0; tess < ntess_; ++tess) ptess_Zxyz[tess][0] = tess_charges_[tess];
+  potential_int_->set_charge_field(tess_Zxyz_);
+  potential_int_->compute(V_pcm_cart);
   // The potential might need to be transformed to the spherical harmonic basis
   SharedMatrix V_pcm_pure;
   if(basisset_->has_puream()){
@@ -342,8 +344,11 @@ SharedMatrix PCM::compute_V()
 SharedMatrix PCM::compute_V_electronic()
 {
   SharedMatrix V_pcm_cart = SharedMatrix(new Matrix("PCM potential cart", basisset_->nao(), basisset_->nao()));
-  ContractOverChargesFunctor contract_charges_functor(tess_charges_e_, V_pcm_cart);
-  potential_int_->compute(contract_charges_functor);
+  // The apparent surface charges are the field of the potential integrals
+  double **ptess_Zxyz = tess_Zxyz_->pointer();
+  for(int tess = 0; tess < ntess_; ++tess) ptess_Zxyz[tess][0] = tess_charges_e_[tess];
+  potential_int_->set_charge_field(tess_Zxyz_);
+  potential_int_->compute(V_pcm_cart);
   // The potential might need to be transformed to the spherical harmonic basis
   SharedMatrix V_pcm_pure;
   if(basisset_->has_puream()){
@@ -551,6 +551,8 @@ void SAPT0::ind20rA_B_aio()
 
   psio_address next_C_p_AA;
   psio_address next_C_p_RR;
+  SharedAIORequest read_AA;
+  SharedAIORequest read_RR;
 
   do {
 
@@ -608,10 +610,10 @@ void SAPT0::ind20rA_B_aio()
         int read_length = block_length;
         if (i == num_blocks-2 && ndf_ % block_length)
           read_length = ndf_ % block_length;
-          aio->read(PSIF_SAPT_AA_DF_INTS,"AA RI Integrals",(char *)
+          read_AA = aio->read(PSIF_SAPT_AA_DF_INTS,"AA RI Integrals",(char *)
             &(C_p_AA[(i+1)%2][0][0]),sizeof(double)*read_length*noccA_*noccA_,
             next_C_p_AA,&next_C_p_AA);
-          aio->read(PSIF_SAPT_AA_DF_INTS,"RR RI Integrals",(char *)
+          read_RR = aio->read(PSIF_SAPT_AA_DF_INTS,"RR RI Integrals",(char *)
             &(C_p_RR[(i+1)%2][0][0]),sizeof(double)*read_length*nvirA_*
             (nvirA_+1)/2,next_C_p_RR,&next_C_p_RR);
       }
@@ -642,8 +644,10 @@ void SAPT0::ind20rA_B_aio()
       }
 }
 
-      if (i < num_blocks-1)
-        aio->synchronize();
+      if (i < num_blocks-1) {
+        read_AA->wait();
+        read_RR->wait();
+      }
     }
 
     free_block(C_p_AA[0]);
@@ -790,6 +794,8 @@ void SAPT0::ind20rB_A_aio()
 
   psio_address next_C_p_BB;
   psio_address next_C_p_SS;
+  SharedAIORequest read_BB;
+  SharedAIORequest read_SS;
 
   do {
 
@@ -847,10 +853,10 @@ void SAPT0::ind20rB_A_aio()
         int read_length = block_length;
         if (i == num_blocks-2 && ndf_ % block_length)
           read_length = ndf_ % block_length;
-          aio->read(PSIF_SAPT_BB_DF_INTS,"BB RI Integrals",(char *)
+          read_BB = aio->read(PSIF_SAPT_BB_DF_INTS,"BB RI Integrals",(char *)
             &(C_p_BB[(i+1)%2][0][0]),sizeof(double)*read_length*noccB_*noccB_,
             next_C_p_BB,&next_C_p_BB);
-          aio->read(PSIF_SAPT_BB_DF_INTS,"SS RI Integrals",(char *)
+          read_SS = aio->read(PSIF_SAPT_BB_DF_INTS,"SS RI Integrals",(char *)
             &(C_p_SS[(i+1)%2][0][0]),sizeof(double)*read_length*nvirB_*
             (nvirB_+1)/2,next_C_p_SS,&next_C_p_SS);
       }
@@ -881,8 +887,10 @@ void SAPT0::ind20rB_A_aio()
       }
 }
 
-      if (i < num_blocks-1)
-        aio->synchronize();
+      if (i < num_blocks-1) {
+        read_BB->wait();
+        read_SS->wait();
+      }
     }
 
     free_block(C_p_BB[0]);
@@ -359,6 +359,9 @@ void HF::common_init()
 
     initialized_diis_manager_ = false;
 
+    // Incremental Fock builds
+    incfock_ = options_.get_bool("INCFOCK");
+
     // Second-order convergence acceleration
     soscf_enabled_ = options_.get_bool("SOSCF");
     soscf_e_start_ = options_.get_double("SOSCF_E_START");
@@ -428,8 +431,9 @@ void HF::integrals()
 
     // Tell the JK to print
     jk_->set_print(print_);
-    // Give the JK 75% of the memory
-    jk_->set_memory((ULI)(options_.get_double("SCF_MEM_SAFETY_FACTOR")*(Process::environment.get_memory() / 8L)));
+    // Give the JK 75% of the memory not already held by tracked matrices
+    ULI available = (arena_budget() ? arena_remaining() : Process::environment.get_memory());
+    jk_->set_memory((ULI)(options_.get_double("SCF_MEM_SAFETY_FACTOR")*(available / 8L)));
 
     // DFT sometimes needs custom stuff
     if ((options_.get_str("REFERENCE") == "UKS" || options_.get_str("REFERENCE") == "RKS")) {
@@ -480,6 +484,10 @@ void HF::finalize()
     diag_F_temp_.reset();
     diag_C_temp_.reset();
 
+    // Temporaries recycled across iterations are not needed downstream
+    arena_trim();
+    if (print_ > 1) arena_print_report();
+
     // Close the chkpt
     if(psio_->open_check(PSIF_CHKPT))
         psio_->close(PSIF_CHKPT, 1);
@@ -1568,12 +1576,10 @@ void HF::dump_to_checkpoint()
         delete[] values;
         double** vectors = Ca_->to_block_matrix();
         chkpt_->wt_alpha_scf(vectors);
-        delete[] vectors[0];
-        delete[] vectors;
+        free_block(vectors);
         vectors = Cb_->to_block_matrix();
         chkpt_->wt_beta_scf(vectors);
-        delete[] vectors[0];
-        delete[] vectors;
+        free_block(vectors);
     }else{
         // All other reference type yield restricted orbitals
         double* values = epsilon_a_->to_block_vector();
@@ -1581,8 +1587,7 @@ void HF::dump_to_checkpoint()
         delete[] values;
         double** vectors = Ca_->to_block_matrix();
         chkpt_->wt_scf(vectors);
-        delete[] vectors[0];
-        delete[] vectors;
+        free_block(vectors);
         double *ftmp = Fa_->to_lower_triangle();
         chkpt_->wt_fock(ftmp);
         delete[] ftmp;
@@ -1683,9 +1688,13 @@ double HF::compute_energy()
 
         E_ = 0.0;
 
+        // Only the SCF's own sequence of densities may be built incrementally,
+        // other users of jk_ (e.g. SOSCF) get full builds
+        jk_->set_incfock(incfock_);
         timer_on("Form G");
         form_G();
         timer_off("Form G");
+        jk_->set_incfock(false);
 
         // Reset fractional SAD occupation
         if (iteration_ == 0 && options_.get_str("GUESS") == "SAD")
@@ -2183,6 +2192,15 @@ SharedMatrix HF::form_FDSmSDF(SharedMatrix Fso, SharedMatrix Dso)
     return XPX;
 }
 
+void HF::write_so_tei_for_stability()
+{
+    // PK builds its supermatrix straight from shell quartets, and DIRECT
+    // never stores integrals, so only OUT_OF_CORE leaves the file behind
+    if (scf_type_ == "OUT_OF_CORE") return;
+    MintsHelper mints(options_, 0);
+    mints.integrals();
+}
+
 void HF::print_stability_analysis(std::vector<std::pair<double, int> > &vec)
 {
     std::sort(vec.begin(), vec.end());
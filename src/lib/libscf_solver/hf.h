@@ -180,6 +180,9 @@ protected:
     /// Whether damping was actually performed this iteration
     bool damping_performed_;
 
+    /// Build the Fock matrix incrementally from the density change (DirectJK only)
+    bool incfock_;
+
     // parameters for hard-sphere potentials
     double radius_; // radius of spherical potential
     double thickness_; // thickness of spherical barrier
@@ -247,6 +250,9 @@ protected:
     /// Check the stability of the wavefunction, and correct (if requested)
     virtual void stability_analysis();
     void print_stability_analysis(std::vector<std::pair<double, int> > &vec);
+    /// Write PSIF_SO_TEI for the integral transforms of stability analysis,
+    /// unless the JK object (OUT_OF_CORE) already left it on disk
+    void write_so_tei_for_stability();
 
 
     /// Determine how many core and virtual orbitals to freeze
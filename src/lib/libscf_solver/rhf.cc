@@ -634,6 +634,7 @@ void RHF::stability_analysis()
         spaces.push_back(MOSpace::occ);
         spaces.push_back(MOSpace::vir);
         // Ref wfn is really "this"
+        write_so_tei_for_stability();
         boost::shared_ptr<Wavefunction> wfn = Process::environment.wavefunction();
         IntegralTransform ints(wfn, spaces, IntegralTransform::Restricted, IntegralTransform::DPDOnly,
                                IntegralTransform::QTOrder, IntegralTransform::None);
@@ -521,6 +521,7 @@ void ROHF::stability_analysis()
         spaces.push_back(MOSpace::occ);
         spaces.push_back(MOSpace::vir);
         // Ref wfn is really "this"
+        write_so_tei_for_stability();
         boost::shared_ptr<Wavefunction> wfn = Process::environment.wavefunction();
 #define ID(x) ints.DPD_ID(x)
         IntegralTransform ints(wfn, spaces, IntegralTransform::Restricted, IntegralTransform::DPDOnly,
@@ -314,6 +314,7 @@ void UHF::stability_analysis_pk()
     spaces.push_back(MOSpace::occ);
     spaces.push_back(MOSpace::vir);
     // Ref wfn is really "this"
+    write_so_tei_for_stability();
     boost::shared_ptr<Wavefunction> wfn = Process::environment.wavefunction();
 #define ID(x) ints->DPD_ID(x)
     IntegralTransform* ints = new IntegralTransform(wfn, spaces, IntegralTransform::Unrestricted, IntegralTransform::DPDOnly,